@@ -5,12 +5,15 @@
 #define _NN_H
 
 
+#include <OS.h>
+#include <StorageDefs.h>
+
 #include <util/DoublyLinkedList.h>
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-const char* NN_PORT = "neural listener";
+static const char* const NN_PORT = "neural listener";
 
 typedef struct {
 	area_id areaID;
@@ -21,8 +24,79 @@ typedef struct {
 typedef enum{
 
 	NN_INIT = 0,
+
+	NN_LOAD_MODEL,		// nn_model_request, replies with the new model id
+	NN_UNLOAD_MODEL,	// nn_model_request
+	NN_SAVE_MODEL,		// nn_model_request
+	NN_INFER,			// nn_infer_request
+	NN_TRAIN,			// nn_train_request
+	NN_RELEASE_AREA,	// nn_area_request, no reply
 } nn_msg;
 
+// Requests carrying data do not copy it into the message: the client puts
+// its matrices in an area created with B_CLONEABLE_AREA, and the server
+// reads the inputs from and writes the outputs to that area. Matrices are
+// stored by rows, as doubles, at the given byte offsets in the area.
+// The area must belong to the team which sends the request; requests naming
+// the area of another team fail with B_NOT_ALLOWED.
+// The server answers each request with an nn_reply written to replyPort
+// with the code of the request; token is returned as is, so that a client
+// can match replies to concurrent requests.
+
+typedef struct {
+	port_id		replyPort;
+	int32		token;
+	int32		model;
+	char		path[B_PATH_NAME_LENGTH];
+} nn_model_request;
+
+typedef struct {
+	port_id		replyPort;
+	int32		token;
+	int32		model;
+	area_id		area;
+	uint32		inputOffset;
+	uint32		outputOffset;
+	uint32		rows;
+	uint32		inputColumns;
+	uint32		outputColumns;
+} nn_infer_request;
+
+// The data matrix of a training request has the inputs in its first
+// columns and the targets in the remaining ones.
+typedef struct {
+	port_id		replyPort;
+	int32		token;
+	int32		model;
+	area_id		area;
+	uint32		dataOffset;
+	uint32		rows;
+	uint32		inputColumns;
+	uint32		targetColumns;
+} nn_train_request;
+
+// Tells the server that the client does not use an area anymore, so that
+// its clone can be deleted.
+typedef struct {
+	area_id		area;
+} nn_area_request;
+
+typedef struct {
+	int32		token;
+	status_t	status;
+	int32		model;
+	uint32		rows;
+	double		performance;
+} nn_reply;
+
+typedef union {
+	kile				init;
+	nn_model_request	model;
+	nn_infer_request	infer;
+	nn_train_request	train;
+	nn_area_request		area;
+} nn_request;
+
 class Msg : public DoublyLinkedListLinkImpl<Msg> {
 public:
 	Msg(){}
@@ -52,12 +126,25 @@ public:
 	}
 	
 	kile &Data(){
+		return fData.init;
+	}
+
+	nn_request &Request(){
 		return fData;
 	}
+
+	void SetSenderTeam(team_id team){
+		fSenderTeam = team;
+	}
+
+	team_id SenderTeam() const{
+		return fSenderTeam;
+	}
 	
 private:
-	kile fData;
+	nn_request fData;
 	nn_msg fCode;
+	team_id fSenderTeam;
 
 };
 
@@ -68,6 +68,17 @@ typedef GenericCompressionAlgorithmOwner<BDecompressionParameters>
 class PackageFileHeapAccessorBase : public BAbstractBufferedDataReader {
 public:
 			class OffsetArray;
+			class ChunkCache;
+
+			struct ChunkCacheStatistics {
+				uint64		hits;
+				uint64		misses;
+				uint64		readAheadChunks;
+				bigtime_t	decompressionTime;
+					// reading and decompressing, on demand and ahead
+			};
+
+			friend class ChunkCache;
 
 public:
 								PackageFileHeapAccessorBase(
@@ -92,6 +103,15 @@ public:
 			void				SetFile(BPositionIO* file)
 									{ fFile = file; }
 
+			// Caches decompressed chunks and decompresses the following
+			// chunks ahead when reading sequentially. Only for heaps that
+			// don't change anymore. Not available in the kernel, where
+			// packagefs has its own cache.
+			status_t			InitChunkCache();
+			void				UninitChunkCache();
+			bool				GetChunkCacheStatistics(
+									ChunkCacheStatistics& _statistics) const;
+
 	// BAbstractBufferedDataReader
 	virtual	status_t			ReadDataToOutput(off_t offset,
 									size_t size, BDataIO* output);
@@ -119,6 +139,9 @@ protected:
 			status_t			ReadFileData(uint64 offset, void* buffer,
 									size_t size);
 
+			void				SetChunkCache(ChunkCache* cache);
+									// shares the cache, NULL to detach
+
 protected:
 			BErrorOutput*		fErrorOutput;
 			BPositionIO*		fFile;
@@ -126,6 +149,9 @@ protected:
 			uint64				fCompressedHeapSize;
 			uint64				fUncompressedHeapSize;
 			DecompressionAlgorithmOwner* fDecompressionAlgorithm;
+			ChunkCache*			fChunkCache;
+			size_t				fLastReadChunkIndex;
+			uint32				fSequentialReadCount;
 };
 
 
@@ -6,6 +6,8 @@
 #define _PACKAGE__HPKG__PRIVATE__PACKAGE_FILE_HEAP_WRITER_H_
 
 
+#include <pthread.h>
+
 #include <Array.h>
 #include <package/hpkg/PackageFileHeapAccessorBase.h>
 
@@ -42,7 +44,8 @@ public:
 										decompressionAlgorithm);
 								~PackageFileHeapWriter();
 
-			void				Init();
+			void				Init(int32 compressionThreadCount = -1);
+									// -1: one thread per CPU
 			void				Reinit(PackageFileHeapReader* heapReader);
 
 			status_t			AddData(BDataReader& dataReader, off_t size,
@@ -63,17 +66,30 @@ private:
 			struct Chunk;
 			struct ChunkSegment;
 			struct ChunkBuffer;
+			struct CompressionJob;
 
 			friend struct ChunkBuffer;
 
 private:
 			void				_Uninit();
 
+			void				_StartCompressionThreads(int32 threadCount);
+			void				_StopCompressionThreads();
+	static	void*				_CompressionThreadEntry(void* data);
+			void				_CompressionThread();
+
 			status_t			_FlushPendingData();
+			status_t			_QueuePendingData();
+			status_t			_WriteCompressedChunks(int32 waitCount);
 			status_t			_WriteChunk(const void* data, size_t size,
 									bool mayCompress);
-			status_t			_WriteDataCompressed(const void* data,
-									size_t size);
+			status_t			_WriteChunk(const void* data, size_t size,
+									const void* compressedData,
+									size_t compressedSize,
+									status_t compressionStatus);
+			status_t			_CompressChunk(const void* data, size_t size,
+									void* compressedData,
+									size_t& _compressedSize) const;
 			status_t			_WriteDataUncompressed(const void* data,
 									size_t size);
 
@@ -87,6 +103,21 @@ private:
 			size_t				fPendingDataSize;
 			Array<uint64>		fOffsets;
 			CompressionAlgorithmOwner* fCompressionAlgorithm;
+
+			// Full chunks are compressed by the compression threads and
+			// written in order by the thread adding the data. The jobs form a
+			// ring, starting with the oldest one not written yet.
+			Array<pthread_t>	fCompressionThreads;
+			pthread_mutex_t		fJobLock;
+			pthread_cond_t		fJobQueuedCondition;
+			pthread_cond_t		fJobDoneCondition;
+			CompressionJob*		fJobs;
+			int32				fJobCount;
+			int32				fFirstJob;
+			int32				fQueuedJobCount;
+			int32				fUnstartedJobCount;
+			bool				fQueueChunks;
+			bool				fTerminating;
 };
 
 
@@ -0,0 +1,7 @@
+#include <stdio.h>
+#include "wren.h"
+static void w(WrenVM*, const char* t){ fputs(t, stdout); }
+static void e(WrenVM*, WrenErrorType, const char*, int l, const char* m){ printf("err %d %s\n", l, m); }
+int main(){ WrenConfiguration c; wrenInitConfiguration(&c); c.writeFn=w; c.errorFn=e; WrenVM* vm=wrenNewVM(&c);
+ WrenInterpretResult r=wrenInterpret(vm,"main","class A { construct new(x) { _x = x } x { _x } }\nvar l = []\nfor (i in 0...200) l.add(A.new(i))\nvar s = 0\nfor (a in l) s = s + a.x\nSystem.print(s)\nvar m = {}\nfor (i in 0...100) m[i.toString] = [i]\nSystem.print(m.count)\n");
+ printf("result %d\n", r); wrenFreeVM(vm); }
@@ -13,6 +13,8 @@
 #include <new>
 #ifdef _KERNEL_MODE
 #include <slab/Slab.h>
+#else
+#include <pthread.h>
 #endif
 
 #include <ByteOrder.h>
@@ -21,6 +23,10 @@
 
 #include <AutoDeleter.h>
 #include <CompressionAlgorithm.h>
+#ifndef _KERNEL_MODE
+#include <OS.h>
+#include <util/DoublyLinkedList.h>
+#endif
 
 
 namespace BPackageKit {
@@ -35,6 +41,509 @@ void* PackageFileHeapAccessorBase::sChunkCache = NULL;
 #endif
 
 
+#if !defined(_KERNEL_MODE)
+
+
+// number of decompressed chunks a chunk cache keeps
+static const size_t kChunkCacheSize = 32;
+
+// number of chunks decompressed ahead of a sequential read
+static const size_t kReadAheadChunkCount = 4;
+
+// number of chunks that can be queued for reading ahead
+static const int32 kMaxReadAheadRequests = 2 * kReadAheadChunkCount;
+
+// number of reads, each starting in the chunk where the previous one ended or
+// in the next one, after which a reader is considered to read sequentially
+static const uint32 kSequentialReadThreshold = 2;
+
+
+// #pragma mark - ChunkCache
+
+
+/*!	Keeps the most recently used decompressed chunks of a heap, for all the
+	accessors reading it. A thread decompresses the chunks following a
+	sequential read ahead of time.
+*/
+class PackageFileHeapAccessorBase::ChunkCache : public BReferenceable {
+public:
+								ChunkCache();
+	virtual						~ChunkCache();
+
+			status_t			Init();
+
+			status_t			ReadDataToOutput(
+									PackageFileHeapAccessorBase* accessor,
+									off_t offset, size_t size,
+									BDataIO* output);
+
+			void				ReadAhead(
+									PackageFileHeapAccessorBase* accessor,
+									size_t chunkIndex, size_t chunkCount);
+			void				CancelReadAhead(
+									PackageFileHeapAccessorBase* accessor);
+
+			void				GetStatistics(
+									ChunkCacheStatistics& _statistics);
+
+private:
+			struct Chunk : DoublyLinkedListLinkImpl<Chunk> {
+				size_t			index;
+				void*			data;
+				int32			referenceCount;
+				bool			loaded;
+					// false while being read and decompressed
+			};
+
+			typedef DoublyLinkedList<Chunk> ChunkList;
+
+			struct ReadAheadRequest {
+				PackageFileHeapAccessorBase* accessor;
+				size_t			chunkIndex;
+			};
+
+private:
+			Chunk*				_Lookup(size_t chunkIndex) const;
+			Chunk*				_Allocate(size_t chunkIndex);
+			void				_Remove(Chunk* chunk);
+			status_t			_GetChunk(PackageFileHeapAccessorBase* accessor,
+									size_t chunkIndex,
+									void*& compressedDataBuffer,
+									Chunk*& _chunk);
+			void				_PutChunk(Chunk* chunk);
+			void				_RemoveReadAheadRequest(int32 index);
+
+	static	void*				_ReadAheadThreadEntry(void* data);
+			void				_ReadAheadThread();
+
+private:
+			pthread_mutex_t		fLock;
+			pthread_cond_t		fChunkLoadedCondition;
+			pthread_cond_t		fReadAheadCondition;
+			ChunkList			fChunks;
+									// most recently used first
+			size_t				fChunkCount;
+			ReadAheadRequest	fReadAheadRequests[kMaxReadAheadRequests];
+			int32				fReadAheadRequestCount;
+			PackageFileHeapAccessorBase* fReadingAheadFor;
+			void*				fReadAheadBuffer;
+			pthread_t			fReadAheadThread;
+			bool				fReadAheadThreadStarted;
+			bool				fTerminating;
+			ChunkCacheStatistics fStatistics;
+};
+
+
+PackageFileHeapAccessorBase::ChunkCache::ChunkCache()
+	:
+	fChunks(),
+	fChunkCount(0),
+	fReadAheadRequestCount(0),
+	fReadingAheadFor(NULL),
+	fReadAheadBuffer(NULL),
+	fReadAheadThreadStarted(false),
+	fTerminating(false)
+{
+	pthread_mutex_init(&fLock, NULL);
+	pthread_cond_init(&fChunkLoadedCondition, NULL);
+	pthread_cond_init(&fReadAheadCondition, NULL);
+
+	memset(&fStatistics, 0, sizeof(fStatistics));
+}
+
+
+PackageFileHeapAccessorBase::ChunkCache::~ChunkCache()
+{
+	if (fReadAheadThreadStarted) {
+		pthread_mutex_lock(&fLock);
+		fTerminating = true;
+		pthread_cond_signal(&fReadAheadCondition);
+		pthread_mutex_unlock(&fLock);
+
+		pthread_join(fReadAheadThread, NULL);
+	}
+
+	while (Chunk* chunk = fChunks.RemoveHead()) {
+		free(chunk->data);
+		delete chunk;
+	}
+
+	free(fReadAheadBuffer);
+
+	pthread_cond_destroy(&fReadAheadCondition);
+	pthread_cond_destroy(&fChunkLoadedCondition);
+	pthread_mutex_destroy(&fLock);
+}
+
+
+status_t
+PackageFileHeapAccessorBase::ChunkCache::Init()
+{
+	fReadAheadBuffer = malloc(kChunkSize);
+	if (fReadAheadBuffer == NULL)
+		return B_NO_MEMORY;
+
+	return B_OK;
+}
+
+
+status_t
+PackageFileHeapAccessorBase::ChunkCache::ReadDataToOutput(
+	PackageFileHeapAccessorBase* accessor, off_t offset, size_t size,
+	BDataIO* output)
+{
+	// allocated only when needed
+	void* compressedDataBuffer = NULL;
+	void* uncompressedDataBuffer = NULL;
+	MemoryDeleter compressedMemoryDeleter, uncompressedMemoryDeleter;
+
+	size_t chunkIndex = size_t(offset / kChunkSize);
+	size_t inChunkOffset = (uint64)offset - (uint64)chunkIndex * kChunkSize;
+	size_t remainingBytes = size;
+
+	while (remainingBytes > 0) {
+		Chunk* chunk;
+		status_t error = _GetChunk(accessor, chunkIndex, compressedDataBuffer,
+			chunk);
+		compressedMemoryDeleter.SetTo(compressedDataBuffer);
+		if (error != B_OK)
+			return error;
+
+		const void* data;
+		if (chunk != NULL) {
+			data = chunk->data;
+		} else {
+			// All cached chunks are in use, decompress the chunk uncached.
+			if (uncompressedDataBuffer == NULL) {
+				uncompressedDataBuffer = malloc(kChunkSize);
+				if (uncompressedDataBuffer == NULL)
+					return B_NO_MEMORY;
+				uncompressedMemoryDeleter.SetTo(uncompressedDataBuffer);
+			}
+
+			error = accessor->ReadAndDecompressChunk(chunkIndex,
+				compressedDataBuffer, uncompressedDataBuffer);
+			if (error != B_OK)
+				return error;
+			data = uncompressedDataBuffer;
+		}
+
+		size_t toWrite = std::min((size_t)kChunkSize - inChunkOffset,
+			remainingBytes);
+		error = output->WriteExactly((const char*)data + inChunkOffset,
+			toWrite);
+
+		if (chunk != NULL)
+			_PutChunk(chunk);
+
+		if (error != B_OK)
+			return error;
+
+		remainingBytes -= toWrite;
+		chunkIndex++;
+		inChunkOffset = 0;
+	}
+
+	return B_OK;
+}
+
+
+/*!	Queues the given chunks to be decompressed by the read ahead thread,
+	unless they are cached already.
+*/
+void
+PackageFileHeapAccessorBase::ChunkCache::ReadAhead(
+	PackageFileHeapAccessorBase* accessor, size_t chunkIndex,
+	size_t chunkCount)
+{
+	pthread_mutex_lock(&fLock);
+
+	bool queued = false;
+	for (size_t i = chunkIndex; i < chunkIndex + chunkCount; i++) {
+		if (fReadAheadRequestCount == kMaxReadAheadRequests)
+			break;
+
+		bool known = _Lookup(i) != NULL;
+		for (int32 k = 0; !known && k < fReadAheadRequestCount; k++)
+			known = fReadAheadRequests[k].chunkIndex == i;
+		if (known)
+			continue;
+
+		ReadAheadRequest& request
+			= fReadAheadRequests[fReadAheadRequestCount++];
+		request.accessor = accessor;
+		request.chunkIndex = i;
+		queued = true;
+	}
+
+	if (queued && !fReadAheadThreadStarted) {
+		if (pthread_create(&fReadAheadThread, NULL, &_ReadAheadThreadEntry,
+				this) == 0) {
+			fReadAheadThreadStarted = true;
+		} else
+			fReadAheadRequestCount = 0;
+	}
+
+	if (queued)
+		pthread_cond_signal(&fReadAheadCondition);
+
+	pthread_mutex_unlock(&fLock);
+}
+
+
+/*!	Drops the read ahead requests of the given accessor and waits until the
+	read ahead thread no longer uses it.
+*/
+void
+PackageFileHeapAccessorBase::ChunkCache::CancelReadAhead(
+	PackageFileHeapAccessorBase* accessor)
+{
+	pthread_mutex_lock(&fLock);
+
+	for (int32 i = fReadAheadRequestCount - 1; i >= 0; i--) {
+		if (fReadAheadRequests[i].accessor == accessor)
+			_RemoveReadAheadRequest(i);
+	}
+
+	while (fReadingAheadFor == accessor)
+		pthread_cond_wait(&fChunkLoadedCondition, &fLock);
+
+	pthread_mutex_unlock(&fLock);
+}
+
+
+void
+PackageFileHeapAccessorBase::ChunkCache::GetStatistics(
+	ChunkCacheStatistics& _statistics)
+{
+	pthread_mutex_lock(&fLock);
+	_statistics = fStatistics;
+	pthread_mutex_unlock(&fLock);
+}
+
+
+PackageFileHeapAccessorBase::ChunkCache::Chunk*
+PackageFileHeapAccessorBase::ChunkCache::_Lookup(size_t chunkIndex) const
+{
+	for (ChunkList::ConstIterator it = fChunks.GetIterator();
+			Chunk* chunk = it.Next();) {
+		if (chunk->index == chunkIndex)
+			return chunk;
+	}
+
+	return NULL;
+}
+
+
+/*!	Returns a new chunk, or the least recently used one which nobody uses,
+	referenced and not loaded. Returns \c NULL, if the cache is full and all
+	chunks are in use.
+*/
+PackageFileHeapAccessorBase::ChunkCache::Chunk*
+PackageFileHeapAccessorBase::ChunkCache::_Allocate(size_t chunkIndex)
+{
+	Chunk* chunk = NULL;
+
+	if (fChunkCount < kChunkCacheSize) {
+		chunk = new(std::nothrow) Chunk;
+		if (chunk != NULL) {
+			chunk->data = malloc(kChunkSize);
+			if (chunk->data == NULL) {
+				delete chunk;
+				chunk = NULL;
+			} else
+				fChunkCount++;
+		}
+	}
+
+	if (chunk == NULL) {
+		// Loaded chunks nobody uses have no references, the others have.
+		for (chunk = fChunks.Tail(); chunk != NULL;
+				chunk = fChunks.GetPrevious(chunk)) {
+			if (chunk->referenceCount == 0)
+				break;
+		}
+
+		if (chunk == NULL)
+			return NULL;
+
+		fChunks.Remove(chunk);
+	}
+
+	chunk->index = chunkIndex;
+	chunk->referenceCount = 1;
+	chunk->loaded = false;
+	fChunks.Add(chunk, false);
+
+	return chunk;
+}
+
+
+void
+PackageFileHeapAccessorBase::ChunkCache::_Remove(Chunk* chunk)
+{
+	fChunks.Remove(chunk);
+	fChunkCount--;
+
+	free(chunk->data);
+	delete chunk;
+}
+
+
+/*!	Returns the given chunk referenced, decompressing it first, if it isn't
+	cached yet. \a _chunk is \c NULL, if it can't be cached. The compressed
+	data buffer is allocated, if needed and still \c NULL.
+*/
+status_t
+PackageFileHeapAccessorBase::ChunkCache::_GetChunk(
+	PackageFileHeapAccessorBase* accessor, size_t chunkIndex,
+	void*& compressedDataBuffer, Chunk*& _chunk)
+{
+	pthread_mutex_lock(&fLock);
+
+	Chunk* chunk;
+	while ((chunk = _Lookup(chunkIndex)) != NULL && !chunk->loaded) {
+		// someone else is decompressing it
+		pthread_cond_wait(&fChunkLoadedCondition, &fLock);
+	}
+
+	if (chunk != NULL) {
+		chunk->referenceCount++;
+		fChunks.Remove(chunk);
+		fChunks.Add(chunk, false);
+		fStatistics.hits++;
+
+		pthread_mutex_unlock(&fLock);
+
+		_chunk = chunk;
+		return B_OK;
+	}
+
+	chunk = _Allocate(chunkIndex);
+	fStatistics.misses++;
+
+	pthread_mutex_unlock(&fLock);
+
+	if (compressedDataBuffer == NULL) {
+		compressedDataBuffer = malloc(kChunkSize);
+		if (compressedDataBuffer == NULL) {
+			if (chunk != NULL)
+				_PutChunk(chunk);
+			return B_NO_MEMORY;
+		}
+	}
+
+	_chunk = chunk;
+	if (chunk == NULL)
+		return B_OK;
+
+	bigtime_t startTime = system_time();
+	status_t error = accessor->ReadAndDecompressChunk(chunkIndex,
+		compressedDataBuffer, chunk->data);
+	bigtime_t decompressionTime = system_time() - startTime;
+
+	pthread_mutex_lock(&fLock);
+
+	fStatistics.decompressionTime += decompressionTime;
+	if (error == B_OK)
+		chunk->loaded = true;
+	else
+		_Remove(chunk);
+	pthread_cond_broadcast(&fChunkLoadedCondition);
+
+	pthread_mutex_unlock(&fLock);
+
+	return error;
+}
+
+
+void
+PackageFileHeapAccessorBase::ChunkCache::_PutChunk(Chunk* chunk)
+{
+	pthread_mutex_lock(&fLock);
+
+	if (chunk->loaded) {
+		chunk->referenceCount--;
+	} else {
+		// never loaded
+		_Remove(chunk);
+		pthread_cond_broadcast(&fChunkLoadedCondition);
+	}
+
+	pthread_mutex_unlock(&fLock);
+}
+
+
+void
+PackageFileHeapAccessorBase::ChunkCache::_RemoveReadAheadRequest(int32 index)
+{
+	fReadAheadRequestCount--;
+	memmove(fReadAheadRequests + index, fReadAheadRequests + index + 1,
+		(fReadAheadRequestCount - index) * sizeof(ReadAheadRequest));
+}
+
+
+/*static*/ void*
+PackageFileHeapAccessorBase::ChunkCache::_ReadAheadThreadEntry(void* data)
+{
+	((ChunkCache*)data)->_ReadAheadThread();
+	return NULL;
+}
+
+
+void
+PackageFileHeapAccessorBase::ChunkCache::_ReadAheadThread()
+{
+	pthread_mutex_lock(&fLock);
+
+	while (true) {
+		while (!fTerminating && fReadAheadRequestCount == 0)
+			pthread_cond_wait(&fReadAheadCondition, &fLock);
+
+		if (fTerminating)
+			break;
+
+		ReadAheadRequest request = fReadAheadRequests[0];
+		_RemoveReadAheadRequest(0);
+
+		if (_Lookup(request.chunkIndex) != NULL)
+			continue;
+
+		Chunk* chunk = _Allocate(request.chunkIndex);
+		if (chunk == NULL)
+			continue;
+
+		fReadingAheadFor = request.accessor;
+
+		pthread_mutex_unlock(&fLock);
+
+		bigtime_t startTime = system_time();
+		status_t error = request.accessor->ReadAndDecompressChunk(
+			request.chunkIndex, fReadAheadBuffer, chunk->data);
+		bigtime_t decompressionTime = system_time() - startTime;
+
+		pthread_mutex_lock(&fLock);
+
+		fReadingAheadFor = NULL;
+		fStatistics.decompressionTime += decompressionTime;
+		if (error == B_OK) {
+			chunk->loaded = true;
+			chunk->referenceCount--;
+			fStatistics.readAheadChunks++;
+		} else
+			_Remove(chunk);
+
+		// also wakes up CancelReadAhead()
+		pthread_cond_broadcast(&fChunkLoadedCondition);
+	}
+
+	pthread_mutex_unlock(&fLock);
+}
+
+
+#endif	// !_KERNEL_MODE
+
+
 // #pragma mark - OffsetArray
 
 
@@ -190,7 +699,10 @@ PackageFileHeapAccessorBase::PackageFileHeapAccessorBase(
 	fHeapOffset(heapOffset),
 	fCompressedHeapSize(0),
 	fUncompressedHeapSize(0),
-	fDecompressionAlgorithm(decompressionAlgorithm)
+	fDecompressionAlgorithm(decompressionAlgorithm),
+	fChunkCache(NULL),
+	fLastReadChunkIndex(0),
+	fSequentialReadCount(0)
 {
 	if (fDecompressionAlgorithm != NULL)
 		fDecompressionAlgorithm->AcquireReference();
@@ -199,11 +711,56 @@ PackageFileHeapAccessorBase::PackageFileHeapAccessorBase(
 
 PackageFileHeapAccessorBase::~PackageFileHeapAccessorBase()
 {
+	SetChunkCache(NULL);
+
 	if (fDecompressionAlgorithm != NULL)
 		fDecompressionAlgorithm->ReleaseReference();
 }
 
 
+status_t
+PackageFileHeapAccessorBase::InitChunkCache()
+{
+#if !defined(_KERNEL_MODE)
+	ChunkCache* cache = new(std::nothrow) ChunkCache;
+	if (cache == NULL)
+		return B_NO_MEMORY;
+	BReference<ChunkCache> cacheReference(cache, true);
+
+	status_t error = cache->Init();
+	if (error != B_OK)
+		return error;
+
+	SetChunkCache(cache);
+	return B_OK;
+#else
+	return B_NOT_SUPPORTED;
+#endif
+}
+
+
+void
+PackageFileHeapAccessorBase::UninitChunkCache()
+{
+	SetChunkCache(NULL);
+}
+
+
+bool
+PackageFileHeapAccessorBase::GetChunkCacheStatistics(
+	ChunkCacheStatistics& _statistics) const
+{
+#if !defined(_KERNEL_MODE)
+	if (fChunkCache != NULL) {
+		fChunkCache->GetStatistics(_statistics);
+		return true;
+	}
+#endif
+
+	return false;
+}
+
+
 status_t
 PackageFileHeapAccessorBase::ReadDataToOutput(off_t offset, size_t size,
 	BDataIO* output)
@@ -216,6 +773,35 @@ PackageFileHeapAccessorBase::ReadDataToOutput(off_t offset, size_t size,
 		return B_BAD_VALUE;
 	}
 
+#if !defined(_KERNEL_MODE)
+	if (fChunkCache != NULL) {
+		size_t firstChunkIndex = size_t(offset / kChunkSize);
+		size_t lastChunkIndex = size_t((offset + size - 1) / kChunkSize);
+
+		// Continuing where the previous read ended makes a sequential read.
+		if (firstChunkIndex == fLastReadChunkIndex
+			|| firstChunkIndex == fLastReadChunkIndex + 1) {
+			if (fSequentialReadCount < kSequentialReadThreshold)
+				fSequentialReadCount++;
+		} else
+			fSequentialReadCount = 0;
+		fLastReadChunkIndex = lastChunkIndex;
+
+		if (fSequentialReadCount >= kSequentialReadThreshold) {
+			size_t chunkCount = (fUncompressedHeapSize + kChunkSize - 1)
+				/ kChunkSize;
+			size_t readAheadCount = std::min(kReadAheadChunkCount,
+				chunkCount - lastChunkIndex - 1);
+			if (readAheadCount > 0) {
+				fChunkCache->ReadAhead(this, lastChunkIndex + 1,
+					readAheadCount);
+			}
+		}
+
+		return fChunkCache->ReadDataToOutput(this, offset, size, output);
+	}
+#endif
+
 	// allocate buffers for compressed and uncompressed data
 	uint16* compressedDataBuffer, *uncompressedDataBuffer;
 	MemoryDeleter compressedMemoryDeleter, uncompressedMemoryDeleter;
@@ -331,6 +917,27 @@ PackageFileHeapAccessorBase::DecompressChunkData(void* compressedDataBuffer,
 }
 
 
+void
+PackageFileHeapAccessorBase::SetChunkCache(ChunkCache* cache)
+{
+#if !defined(_KERNEL_MODE)
+	if (cache == fChunkCache)
+		return;
+
+	if (fChunkCache != NULL) {
+		fChunkCache->CancelReadAhead(this);
+		fChunkCache->ReleaseReference();
+	}
+
+	fChunkCache = cache;
+	fSequentialReadCount = 0;
+
+	if (fChunkCache != NULL)
+		fChunkCache->AcquireReference();
+#endif
+}
+
+
 status_t
 PackageFileHeapAccessorBase::ReadFileData(uint64 offset, void* buffer,
 	size_t size)
@@ -39,6 +39,8 @@ PackageFileHeapReader::PackageFileHeapReader(BErrorOutput* errorOutput,
 
 PackageFileHeapReader::~PackageFileHeapReader()
 {
+	// stop reading ahead before the offsets go away
+	SetChunkCache(NULL);
 }
 
 
@@ -128,6 +130,9 @@ PackageFileHeapReader::Init()
 		return B_BAD_DATA;
 	}
 
+	// Not caching is fine, just slower.
+	InitChunkCache();
+
 	return B_OK;
 }
 
@@ -147,6 +152,8 @@ PackageFileHeapReader::Clone() const
 		return NULL;
 	}
 
+	clone->SetChunkCache(fChunkCache);
+
 	return clone;
 }
 
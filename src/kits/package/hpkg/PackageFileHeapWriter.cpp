@@ -9,6 +9,8 @@
 #include <algorithm>
 #include <new>
 
+#include <unistd.h>
+
 #include <ByteOrder.h>
 #include <List.h>
 #include <package/hpkg/ErrorOutput.h>
@@ -47,6 +49,17 @@ struct PackageFileHeapWriter::ChunkSegment {
 };
 
 
+struct PackageFileHeapWriter::CompressionJob {
+	void*		uncompressedData;
+	void*		compressedData;
+	size_t		uncompressedSize;
+	size_t		compressedSize;
+	status_t	status;
+		// of _CompressChunk()
+	bool		done;
+};
+
+
 struct PackageFileHeapWriter::ChunkBuffer {
 	ChunkBuffer(PackageFileHeapWriter* writer, size_t bufferSize)
 		:
@@ -205,10 +218,22 @@ PackageFileHeapWriter::PackageFileHeapWriter(BErrorOutput* errorOutput,
 	fCompressedDataBuffer(NULL),
 	fPendingDataSize(0),
 	fOffsets(),
-	fCompressionAlgorithm(compressionAlgorithm)
+	fCompressionAlgorithm(compressionAlgorithm),
+	fCompressionThreads(),
+	fJobs(NULL),
+	fJobCount(0),
+	fFirstJob(0),
+	fQueuedJobCount(0),
+	fUnstartedJobCount(0),
+	fQueueChunks(true),
+	fTerminating(false)
 {
 	if (fCompressionAlgorithm != NULL)
 		fCompressionAlgorithm->AcquireReference();
+
+	pthread_mutex_init(&fJobLock, NULL);
+	pthread_cond_init(&fJobQueuedCondition, NULL);
+	pthread_cond_init(&fJobDoneCondition, NULL);
 }
 
 
@@ -216,19 +241,31 @@ PackageFileHeapWriter::~PackageFileHeapWriter()
 {
 	_Uninit();
 
+	pthread_cond_destroy(&fJobDoneCondition);
+	pthread_cond_destroy(&fJobQueuedCondition);
+	pthread_mutex_destroy(&fJobLock);
+
 	if (fCompressionAlgorithm != NULL)
 		fCompressionAlgorithm->ReleaseReference();
 }
 
 
 void
-PackageFileHeapWriter::Init()
+PackageFileHeapWriter::Init(int32 compressionThreadCount)
 {
 	// allocate data buffers
 	fPendingDataBuffer = malloc(kChunkSize);
 	fCompressedDataBuffer = malloc(kChunkSize);
 	if (fPendingDataBuffer == NULL || fCompressedDataBuffer == NULL)
 		throw std::bad_alloc();
+
+	if (compressionThreadCount < 0)
+		compressionThreadCount = sysconf(_SC_NPROCESSORS_ONLN);
+
+	// A single compression thread wouldn't gain anything over compressing in
+	// the calling thread.
+	if (fCompressionAlgorithm != NULL && compressionThreadCount > 1)
+		_StartCompressionThreads(compressionThreadCount);
 }
 
 
@@ -318,9 +355,16 @@ PackageFileHeapWriter::RemoveDataRanges(
 	// Before we begin flush any pending data, so we don't need any special
 	// handling and also can use the pending data buffer.
 	status_t status = _FlushPendingData();
+	if (status == B_OK)
+		status = _WriteCompressedChunks(fQueuedJobCount);
 	if (status != B_OK)
 		throw status_t(status);
 
+	// The chunks we read must not be overwritten before we have read them,
+	// which we can only ensure when the chunks are written as soon as they are
+	// added.
+	fQueueChunks = false;
+
 	// We potentially have to recompress all data from the first affected chunk
 	// to the end (minus the removed ranges, of course). As a basic algorithm we
 	// can use our usual data writing strategy, i.e. read a chunk, decompress it
@@ -432,14 +476,18 @@ PackageFileHeapWriter::RemoveDataRanges(
 	// buffer.
 	if (chunkBuffer.IsEmpty())
 		_UnwriteLastPartialChunk();
+
+	fQueueChunks = true;
 }
 
 
 status_t
 PackageFileHeapWriter::Finish()
 {
-	// flush pending data, if any
+	// flush pending data, if any, and write all compressed chunks
 	status_t error = _FlushPendingData();
+	if (error == B_OK)
+		error = _WriteCompressedChunks(fQueuedJobCount);
 	if (error != B_OK)
 		return error;
 
@@ -490,6 +538,13 @@ PackageFileHeapWriter::ReadAndDecompressChunk(size_t chunkIndex,
 		return B_OK;
 	}
 
+	if (chunkIndex >= (size_t)fOffsets.Count()) {
+		// The chunk is still being compressed.
+		status_t error = _WriteCompressedChunks(fQueuedJobCount);
+		if (error != B_OK)
+			return error;
+	}
+
 	uint64 offset = fOffsets[chunkIndex];
 	size_t compressedSize = chunkIndex + 1 == (size_t)fOffsets.Count()
 		? fCompressedHeapSize - offset
@@ -503,6 +558,8 @@ PackageFileHeapWriter::ReadAndDecompressChunk(size_t chunkIndex,
 void
 PackageFileHeapWriter::_Uninit()
 {
+	_StopCompressionThreads();
+
 	free(fPendingDataBuffer);
 	free(fCompressedDataBuffer);
 	fPendingDataBuffer = NULL;
@@ -510,13 +567,133 @@ PackageFileHeapWriter::_Uninit()
 }
 
 
+void
+PackageFileHeapWriter::_StartCompressionThreads(int32 threadCount)
+{
+	// Two jobs per thread, so that the threads can go on compressing while
+	// the oldest chunks are written.
+	fJobCount = threadCount * 2;
+	fJobs = new CompressionJob[fJobCount];
+	for (int32 i = 0; i < fJobCount; i++) {
+		fJobs[i].uncompressedData = NULL;
+		fJobs[i].compressedData = NULL;
+	}
+
+	for (int32 i = 0; i < fJobCount; i++) {
+		fJobs[i].uncompressedData = malloc(kChunkSize);
+		fJobs[i].compressedData = malloc(kChunkSize);
+		if (fJobs[i].uncompressedData == NULL
+			|| fJobs[i].compressedData == NULL) {
+			throw std::bad_alloc();
+		}
+	}
+
+	if (!fCompressionThreads.AddUninitialized(threadCount))
+		throw std::bad_alloc();
+
+	for (int32 i = 0; i < threadCount; i++) {
+		if (pthread_create(&fCompressionThreads[i], NULL,
+				&_CompressionThreadEntry, this) != 0) {
+			fCompressionThreads.Remove(i, threadCount - i);
+			break;
+		}
+	}
+
+	// If no thread could be started at all, compress in the calling thread.
+	if (fCompressionThreads.Count() == 0)
+		_StopCompressionThreads();
+}
+
+
+void
+PackageFileHeapWriter::_StopCompressionThreads()
+{
+	if (fCompressionThreads.Count() > 0) {
+		pthread_mutex_lock(&fJobLock);
+		fTerminating = true;
+		pthread_cond_broadcast(&fJobQueuedCondition);
+		pthread_mutex_unlock(&fJobLock);
+
+		for (int32 i = 0; i < fCompressionThreads.Count(); i++)
+			pthread_join(fCompressionThreads[i], NULL);
+
+		fCompressionThreads.Clear();
+	}
+
+	if (fJobs != NULL) {
+		for (int32 i = 0; i < fJobCount; i++) {
+			free(fJobs[i].uncompressedData);
+			free(fJobs[i].compressedData);
+		}
+
+		delete[] fJobs;
+		fJobs = NULL;
+	}
+
+	fJobCount = 0;
+	fFirstJob = 0;
+	fQueuedJobCount = 0;
+	fUnstartedJobCount = 0;
+	fTerminating = false;
+}
+
+
+/*static*/ void*
+PackageFileHeapWriter::_CompressionThreadEntry(void* data)
+{
+	((PackageFileHeapWriter*)data)->_CompressionThread();
+	return NULL;
+}
+
+
+void
+PackageFileHeapWriter::_CompressionThread()
+{
+	pthread_mutex_lock(&fJobLock);
+
+	while (true) {
+		while (!fTerminating && fUnstartedJobCount == 0)
+			pthread_cond_wait(&fJobQueuedCondition, &fJobLock);
+
+		if (fTerminating)
+			break;
+
+		// The unstarted jobs are the last queued ones.
+		CompressionJob& job = fJobs[(fFirstJob + fQueuedJobCount
+			- fUnstartedJobCount) % fJobCount];
+		fUnstartedJobCount--;
+
+		pthread_mutex_unlock(&fJobLock);
+
+		job.status = _CompressChunk(job.uncompressedData, job.uncompressedSize,
+			job.compressedData, job.compressedSize);
+
+		pthread_mutex_lock(&fJobLock);
+
+		job.done = true;
+		pthread_cond_signal(&fJobDoneCondition);
+	}
+
+	pthread_mutex_unlock(&fJobLock);
+}
+
+
 status_t
 PackageFileHeapWriter::_FlushPendingData()
 {
 	if (fPendingDataSize == 0)
 		return B_OK;
 
-	status_t error = _WriteChunk(fPendingDataBuffer, fPendingDataSize, true);
+	status_t error;
+	if (fPendingDataSize == kChunkSize && fJobs != NULL && fQueueChunks) {
+		error = _QueuePendingData();
+	} else {
+		// write the queued chunks first, so that the chunks stay in order
+		error = _WriteCompressedChunks(fQueuedJobCount);
+		if (error == B_OK)
+			error = _WriteChunk(fPendingDataBuffer, fPendingDataSize, true);
+	}
+
 	if (error == B_OK)
 		fPendingDataSize = 0;
 
@@ -524,9 +701,94 @@ PackageFileHeapWriter::_FlushPendingData()
 }
 
 
+/*!	Hands the pending data over to the compression threads. If all jobs are
+	in use, the oldest chunk is waited for and written first.
+*/
+status_t
+PackageFileHeapWriter::_QueuePendingData()
+{
+	status_t error = _WriteCompressedChunks(
+		fQueuedJobCount == fJobCount ? 1 : 0);
+	if (error != B_OK)
+		return error;
+
+	pthread_mutex_lock(&fJobLock);
+
+	// swap the buffers, so that the data don't need to be copied
+	CompressionJob& job = fJobs[(fFirstJob + fQueuedJobCount) % fJobCount];
+	std::swap(job.uncompressedData, fPendingDataBuffer);
+	job.uncompressedSize = fPendingDataSize;
+	job.done = false;
+
+	fQueuedJobCount++;
+	fUnstartedJobCount++;
+	pthread_cond_signal(&fJobQueuedCondition);
+
+	pthread_mutex_unlock(&fJobLock);
+
+	return B_OK;
+}
+
+
+/*!	Writes the queued chunks in order, as long as their compression is done.
+	The first \a waitCount ones are waited for, if necessary.
+*/
+status_t
+PackageFileHeapWriter::_WriteCompressedChunks(int32 waitCount)
+{
+	while (fQueuedJobCount > 0) {
+		CompressionJob& job = fJobs[fFirstJob];
+
+		pthread_mutex_lock(&fJobLock);
+		if (!job.done && waitCount <= 0) {
+			pthread_mutex_unlock(&fJobLock);
+			break;
+		}
+
+		while (!job.done)
+			pthread_cond_wait(&fJobDoneCondition, &fJobLock);
+		pthread_mutex_unlock(&fJobLock);
+
+		status_t error = _WriteChunk(job.uncompressedData, job.uncompressedSize,
+			job.compressedData, job.compressedSize, job.status);
+
+		pthread_mutex_lock(&fJobLock);
+		fFirstJob = (fFirstJob + 1) % fJobCount;
+		fQueuedJobCount--;
+		pthread_mutex_unlock(&fJobLock);
+
+		if (error != B_OK)
+			return error;
+
+		waitCount--;
+	}
+
+	return B_OK;
+}
+
+
 status_t
 PackageFileHeapWriter::_WriteChunk(const void* data, size_t size,
 	bool mayCompress)
+{
+	size_t compressedSize = 0;
+	status_t compressionStatus = mayCompress
+		? _CompressChunk(data, size, fCompressedDataBuffer, compressedSize)
+		: B_BUFFER_OVERFLOW;
+
+	return _WriteChunk(data, size, fCompressedDataBuffer, compressedSize,
+		compressionStatus);
+}
+
+
+/*!	Writes a chunk, given the result of _CompressChunk() for it: \c B_OK, if
+	\a compressedData contains the compressed chunk, \c B_BUFFER_OVERFLOW, if
+	it shall be written uncompressed.
+*/
+status_t
+PackageFileHeapWriter::_WriteChunk(const void* data, size_t size,
+	const void* compressedData, size_t compressedSize,
+	status_t compressionStatus)
 {
 	// add offset
 	if (!fOffsets.Add(fCompressedHeapSize)) {
@@ -534,51 +796,43 @@ PackageFileHeapWriter::_WriteChunk(const void* data, size_t size,
 		return B_NO_MEMORY;
 	}
 
-	// Try to use compression only for data large enough.
-	bool compress = mayCompress && size >= (off_t)kCompressionSizeThreshold;
-	if (compress) {
-		status_t error = _WriteDataCompressed(data, size);
-		if (error != B_OK) {
-			if (error != B_BUFFER_OVERFLOW)
-				return error;
-			compress = false;
-		}
-	}
+	if (compressionStatus == B_OK)
+		return _WriteDataUncompressed(compressedData, compressedSize);
 
-	// Write uncompressed, if necessary.
-	if (!compress) {
-		status_t error = _WriteDataUncompressed(data, size);
-		if (error != B_OK)
-			return error;
+	if (compressionStatus != B_BUFFER_OVERFLOW) {
+		fErrorOutput->PrintError("Failed to compress chunk data: %s\n",
+			strerror(compressionStatus));
+		return compressionStatus;
 	}
 
-	return B_OK;
+	return _WriteDataUncompressed(data, size);
 }
 
 
+/*!	Compresses a chunk into \a compressedData, which must be as large as the
+	chunk. Returns \c B_BUFFER_OVERFLOW, if the chunk shall be written
+	uncompressed. Doesn't access anything but the compression algorithm, so
+	that the compression threads can call it.
+*/
 status_t
-PackageFileHeapWriter::_WriteDataCompressed(const void* data, size_t size)
+PackageFileHeapWriter::_CompressChunk(const void* data, size_t size,
+	void* compressedData, size_t& _compressedSize) const
 {
-	if (fCompressionAlgorithm == NULL)
+	// Try to use compression only for data large enough.
+	if (fCompressionAlgorithm == NULL || size < kCompressionSizeThreshold)
 		return B_BUFFER_OVERFLOW;
 
-	size_t compressedSize;
 	status_t error = fCompressionAlgorithm->algorithm->CompressBuffer(data,
-		size, fCompressedDataBuffer, size, compressedSize,
+		size, compressedData, size, _compressedSize,
 		fCompressionAlgorithm->parameters);
-	if (error != B_OK) {
-		if (error != B_BUFFER_OVERFLOW) {
-			fErrorOutput->PrintError("Failed to compress chunk data: %s\n",
-				strerror(error));
-		}
+	if (error != B_OK)
 		return error;
-	}
 
 	// only use compressed data when we've actually saved space
-	if (compressedSize == size)
+	if (_compressedSize == size)
 		return B_BUFFER_OVERFLOW;
 
-	return _WriteDataUncompressed(fCompressedDataBuffer, compressedSize);
+	return B_OK;
 }
 
 
@@ -1,10 +1,16 @@
 #ifndef _LAYER_HPP_
 #define _LAYER_HPP_
 
+#define TANH 1
+#define RELU 2
+#define SIGM 3
+
 #include <iostream>
-#include "Neuron.hpp"
+#include <math.h>
 #include "Matrix.hpp"
 
+// The values of the neurons of a layer are kept as 1 x size matrices, so the
+// network can multiply them with its weight matrices without copying them.
 class Layer
 {
 public:
@@ -12,17 +18,23 @@ public:
   Layer(int size, int activationType);
   void setVal(int i, double v);
 
-  Matrix *matrixifyVals();
-  Matrix *matrixifyActivatedVals();
-  Matrix *matrixifyDerivedVals();
+  void activate();
+
+  Matrix &matrixifyVals() { return this->vals; }
+  const Matrix &matrixifyVals() const { return this->vals; }
+  const Matrix &matrixifyActivatedVals() const { return this->activatedVals; }
+  const Matrix &matrixifyDerivedVals() const { return this->derivedVals; }
 
   vector<double> getActivatedVals();
 
-  vector<Neuron *> getNeurons() { return this->neurons; };
-  void setNeuron(vector<Neuron *> neurons) { this->neurons = neurons; }
+  int getSize() { return this->size; }
 private:
   int size;
-  vector<Neuron *> neurons;
+  int activationType;
+
+  Matrix vals;
+  Matrix activatedVals;
+  Matrix derivedVals;
 };
 
 #endif
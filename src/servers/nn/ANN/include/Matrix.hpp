@@ -8,31 +8,45 @@
 
 using namespace std;
 
+// The values are stored row-major in a single buffer aligned to a cache line,
+// so whole rows can be handed to the kernels in utils::Math as plain arrays.
 class Matrix
 {
 public:
-  Matrix(int numRows, int numCols, bool isRandom); 
+  static const int ALIGNMENT = 64;
 
-  Matrix *transpose();
-  Matrix *copy();
+  Matrix();
+  Matrix(int numRows, int numCols, bool isRandom);
+  Matrix(const Matrix &m);
+  ~Matrix();
 
-  void setValue(int r, int c, double v) { this->values.at(r).at(c) = v; }
-  double getValue(int r, int c) { return this->values.at(r).at(c); }
+  Matrix &operator=(const Matrix &m);
 
-  vector< vector<double> > getValues() { return this->values; }
+  Matrix transpose() const;
+  Matrix copy() const { return *this; }
 
-  void printToConsole();
+  void fill(double v);
 
-  int getNumRows() { return this->numRows; }
-  int getNumCols() { return this->numCols; }
+  void setValue(int r, int c, double v) { this->values[r * this->numCols + c] = v; }
+  double getValue(int r, int c) const { return this->values[r * this->numCols + c]; }
+
+  double *getRow(int r) { return this->values + r * this->numCols; }
+  const double *getRow(int r) const { return this->values + r * this->numCols; }
+
+  vector< vector<double> > getValues() const;
+
+  void printToConsole() const;
+
+  int getNumRows() const { return this->numRows; }
+  int getNumCols() const { return this->numCols; }
 
 private:
-  double generateRandomNumber();
+  void allocate(int numRows, int numCols);
 
   int numRows;
   int numCols;
 
-  vector< vector<double> > values;
+  double *values;
 };
 
 #endif
@@ -44,28 +44,28 @@ public:
   NeuralNetwork(ANNConfig config);
 
   void train(
-        vector<double> input, 
-        vector<double> target, 
+        const vector<double> &input, 
+        const vector<double> &target, 
         double bias, 
         double learningRate, 
         double momentum
       );
 
-  void setCurrentInput(vector<double> input);
-  void setCurrentTarget(vector<double> target) { this->target = target; };
+  void setCurrentInput(const vector<double> &input);
+  void setCurrentTarget(const vector<double> &target) { this->target = target; };
 
   void feedForward();
   void backPropagation();
   void setErrors();
 
-  vector<double> getActivatedVals(int index) { return this->layers.at(index)->getActivatedVals(); }
+  vector<double> getActivatedVals(int index) { return this->layers.at(index).getActivatedVals(); }
 
-  Matrix *getNeuronMatrix(int index) { return this->layers.at(index)->matrixifyVals(); }
-  Matrix *getActivatedNeuronMatrix(int index) { return this->layers.at(index)->matrixifyActivatedVals(); }
-  Matrix *getDerivedNeuronMatrix(int index) { return this->layers.at(index)->matrixifyDerivedVals(); }
-  Matrix *getWeightMatrix(int index) { return new Matrix(*this->weightMatrices.at(index)); };
+  const Matrix &getNeuronMatrix(int index) { return this->layers.at(index).matrixifyVals(); }
+  const Matrix &getActivatedNeuronMatrix(int index) { return this->layers.at(index).matrixifyActivatedVals(); }
+  const Matrix &getDerivedNeuronMatrix(int index) { return this->layers.at(index).matrixifyDerivedVals(); }
+  const Matrix &getWeightMatrix(int index) { return this->weightMatrices.at(index); };
 
-  void setNeuronValue(int indexLayer, int indexNeuron, double val) { this->layers.at(indexLayer)->setVal(indexNeuron, val); }
+  void setNeuronValue(int indexLayer, int indexNeuron, double val) { this->layers.at(indexLayer).setVal(indexNeuron, val); }
 
   void saveWeights(string file);
   void loadWeights(string file);
@@ -76,9 +76,9 @@ public:
   int costFunctionType      = COST_MSE;
 
   vector<int> topology;
-  vector<Layer *> layers;
-  vector<Matrix *> weightMatrices;
-  vector<Matrix *> gradientMatrices;
+  vector<Layer> layers;
+  vector<Matrix> weightMatrices;
+  vector<Matrix> gradientMatrices;
 
   vector<double> input;
   vector<double> target;
@@ -15,7 +15,11 @@ namespace utils
   class Math
   {
   public:
-    static void multiplyMatrix(Matrix *a, Matrix *b, Matrix *c);
+    // c = a * b
+    static void multiplyMatrix(const Matrix &a, const Matrix &b, Matrix &c);
+
+    // c = a * transpose(b), without building the transpose
+    static void multiplyMatrixTransposed(const Matrix &a, const Matrix &b, Matrix &c);
   };
 }
 
@@ -1,65 +1,64 @@
 #include "../include/Layer.hpp"
 
 vector<double> Layer::getActivatedVals() {
-  vector<double> ret;
+  const double *a = this->activatedVals.getRow(0);
 
-  for(unsigned int i = 0; i < this->neurons.size(); i++) {
-    double v = this->neurons.at(i)->getActivatedVal();
-
-    ret.push_back(v);
-  }
-
-  return ret;
+  return vector<double>(a, a + this->size);
 }
 
 void Layer::setVal(int i, double v) {
-  this->neurons.at(i)->setVal(v);
-}
-
-Layer::Layer(int size) {
-  this->size = size;
-
-  for(int i = 0; i < size; i++) {
-    Neuron *n = new Neuron(0.000000000);
-    this->neurons.push_back(n);
+  this->vals.setValue(0, i, v);
+
+  // Same as activate() for a single value.
+  double a;
+  double d;
+
+  if(this->activationType == TANH) {
+    a = tanh(v);
+    d = (1.0 - (a * a));
+  } else {
+    a = (1 / (1 + exp(-v)));
+    d = (a * (1 - a));
   }
-}
-
-Layer::Layer(int size, int activationType) {
-  this->size = size;
 
-  for(int i = 0; i < size; i++) {
-    Neuron *n = new Neuron(0.000000000, activationType);
-    this->neurons.push_back(n);
-  }
+  this->activatedVals.setValue(0, i, a);
+  this->derivedVals.setValue(0, i, d);
 }
 
-Matrix *Layer::matrixifyVals() {
-  Matrix *m = new Matrix(1, this->neurons.size(), false);
-
-  for(unsigned int i = 0; i < this->neurons.size(); i++) {
-    m->setValue(0, i, this->neurons.at(i)->getVal());
+// The former per-neuron code only tested the activation type against TANH;
+// its RELU and SIGM branches compared the activated value instead, so every
+// other type has always been the logistic function. The layer keeps that
+// behavior.
+void Layer::activate() {
+  const double *v = this->vals.getRow(0);
+  double *a       = this->activatedVals.getRow(0);
+  double *d       = this->derivedVals.getRow(0);
+
+  if(this->activationType == TANH) {
+    for(int i = 0; i < this->size; i++) {
+      a[i] = tanh(v[i]);
+      d[i] = (1.0 - (a[i] * a[i]));
+    }
+  } else {
+    for(int i = 0; i < this->size; i++) {
+      a[i] = (1 / (1 + exp(-v[i])));
+      d[i] = (a[i] * (1 - a[i]));
+    }
   }
-
-  return m;
 }
 
-Matrix *Layer::matrixifyActivatedVals() {
-  Matrix *m = new Matrix(1, this->neurons.size(), false);
+Layer::Layer(int size)
+  : vals(1, size, false), activatedVals(1, size, false), derivedVals(1, size, false) {
+  this->size            = size;
+  this->activationType  = SIGM;
 
-  for(unsigned int i = 0; i < this->neurons.size(); i++) {
-    m->setValue(0, i, this->neurons.at(i)->getActivatedVal());
-  }
-
-  return m;
+  this->activate();
 }
 
-Matrix *Layer::matrixifyDerivedVals() {
-  Matrix *m = new Matrix(1, this->neurons.size(), false);
-
-  for(unsigned int i = 0; i < this->neurons.size(); i++) {
-    m->setValue(0, i, this->neurons.at(i)->getDerivedVal());
-  }
+Layer::Layer(int size, int activationType)
+  : vals(1, size, false), activatedVals(1, size, false), derivedVals(1, size, false) {
+  this->size            = size;
+  this->activationType  = activationType;
 
-  return m;
+  this->activate();
 }
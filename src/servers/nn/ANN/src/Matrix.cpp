@@ -1,59 +1,109 @@
 #include "../include/Matrix.hpp"
 
-Matrix *Matrix::transpose() {
-  Matrix *m = new Matrix(this->numCols, this->numRows, false);
+#include <stdlib.h>
+#include <string.h>
+
+Matrix Matrix::transpose() const {
+  Matrix m(this->numCols, this->numRows, false);
 
   for(int i = 0; i < this->numRows; i++) {
+    const double *row = this->getRow(i);
+
     for(int j = 0; j < this->numCols; j++) {
-      m->setValue(j, i, this->getValue(i, j));
+      m.setValue(j, i, row[j]);
     }
   }
 
   return m;
 }
 
-Matrix *Matrix::copy() {
-  Matrix *m = new Matrix(this->numRows, this->numCols, false);
+Matrix::Matrix() {
+  this->numRows = 0;
+  this->numCols = 0;
+  this->values  = NULL;
+}
 
-  for(int i = 0; i < this->numRows; i++) {
-    for(int j = 0; j < this->numCols; j++) {
-      m->setValue(i, j, this->getValue(i, j));
+Matrix::Matrix(int numRows, int numCols, bool isRandom) {
+  this->allocate(numRows, numCols);
+
+  if(isRandom == true) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<> dis(-.0001, .0001);
+
+    for(int i = 0; i < numRows * numCols; i++) {
+      this->values[i] = dis(gen);
     }
+  } else {
+    this->fill(0.00);
   }
+}
 
-  return m;
+Matrix::Matrix(const Matrix &m) {
+  this->allocate(m.numRows, m.numCols);
+
+  if(this->values != NULL) {
+    memcpy(this->values, m.values, sizeof(double) * this->numRows * this->numCols);
+  }
 }
 
-Matrix::Matrix(int numRows, int numCols, bool isRandom) {
+Matrix::~Matrix() {
+  free(this->values);
+}
+
+Matrix &Matrix::operator=(const Matrix &m) {
+  if(this == &m) {
+    return *this;
+  }
+
+  if(this->numRows * this->numCols != m.numRows * m.numCols) {
+    free(this->values);
+    this->allocate(m.numRows, m.numCols);
+  } else {
+    this->numRows = m.numRows;
+    this->numCols = m.numCols;
+  }
+
+  if(this->values != NULL) {
+    memcpy(this->values, m.values, sizeof(double) * this->numRows * this->numCols);
+  }
+
+  return *this;
+}
+
+void Matrix::allocate(int numRows, int numCols) {
   this->numRows = numRows;
   this->numCols = numCols;
+  this->values  = NULL;
 
-  for(int i = 0; i < numRows; i++) {
-    vector<double> colValues;
-
-    for(int j = 0; j < numCols; j++) {
-      double r = isRandom == true ? this->generateRandomNumber() : 0.00;
-      colValues.push_back(r);
-    }
+  if(numRows * numCols > 0
+    && posix_memalign((void **)&this->values, ALIGNMENT,
+      sizeof(double) * numRows * numCols) != 0) {
+    throw std::bad_alloc();
+  }
+}
 
-    this->values.push_back(colValues);
+void Matrix::fill(double v) {
+  for(int i = 0; i < this->numRows * this->numCols; i++) {
+    this->values[i] = v;
   }
 }
 
-double Matrix::generateRandomNumber() {
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_real_distribution<> dis(-.0001, .0001);
+vector< vector<double> > Matrix::getValues() const {
+  vector< vector<double> > rows;
 
-  return dis(gen);
+  for(int i = 0; i < this->numRows; i++) {
+    rows.push_back(vector<double>(this->getRow(i), this->getRow(i) + this->numCols));
+  }
+
+  return rows;
 }
 
-void Matrix::printToConsole() {
+void Matrix::printToConsole() const {
   for(int i = 0; i < this->numRows; i++) {
     for(int j = 0; j < this->numCols; j++) {
-      cout << this->values.at(i).at(j) << "\t\t";
+      cout << this->getValue(i, j) << "\t\t";
     }
     cout << endl;
   }
 }
-
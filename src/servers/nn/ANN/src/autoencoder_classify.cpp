@@ -41,18 +41,29 @@ int main(int argc, char **argv) {
   }
   cout << endl;
 
-  NeuralNetwork *n  = new NeuralNetwork(topology, 2, 3, 1);
-  n->loadWeights(weightsFile);
+  ANNConfig annConfig;
+  annConfig.topology      = topology;
+  annConfig.bias          = bias;
+  annConfig.learningRate  = 0.00;
+  annConfig.momentum      = 1.00;
+  annConfig.epoch         = 0;
+  annConfig.hActivation   = A_SIGM;
+  annConfig.oActivation   = A_SIGM;
+  annConfig.cost          = COST_MSE;
+  annConfig.weightsFile   = weightsFile;
+
+  NeuralNetwork n(annConfig);
+  n.loadWeights(weightsFile);
 
   vector< vector<double> > testData = utils::Misc::fetchData(testFile);
 
   for(unsigned int i = 0; i < testData.size(); i++) {
-    n->setCurrentInput(testData.at(i));
-    n->setCurrentTarget(testData.at(i));
-    n->feedForward();
-    n->setErrors();
+    n.setCurrentInput(testData.at(i));
+    n.setCurrentTarget(testData.at(i));
+    n.feedForward();
+    n.setErrors();
 
-    double error = n->error;
+    double error = n.error;
     //cout << "Error for datapoint " << i << ": " << error << endl;
     cout << error << endl;
   }
@@ -6,7 +6,7 @@ void NeuralNetwork::saveWeights(string filename) {
   vector< vector< vector<double> > > weightSet;
 
   for(unsigned int i = 0; i < this->weightMatrices.size(); i++) {
-    weightSet.push_back(this->weightMatrices.at(i)->getValues());
+    weightSet.push_back(this->weightMatrices.at(i).getValues());
   }
 
   j["weights"]      = weightSet;
@@ -19,10 +19,15 @@ void NeuralNetwork::saveWeights(string filename) {
   o << std::setw(4) << j << endl;
 }
 
-void NeuralNetwork::setCurrentInput(vector<double> input) {
+void NeuralNetwork::setCurrentInput(const vector<double> &input) {
   this->input = input;
 
+  Layer &inputLayer = this->layers.at(0);
+  double *values    = inputLayer.matrixifyVals().getRow(0);
+
   for(unsigned int i = 0; i < input.size(); i++) {
-    this->layers.at(0)->setVal(i, input.at(i));
+    values[i] = input.at(i);
   }
+
+  inputLayer.activate();
 }
@@ -2,162 +2,62 @@
 #include "../../include/utils/Math.hpp"
 
 void NeuralNetwork::backPropagation() {
-  vector<Matrix *> newWeights;
-  Matrix *deltaWeights;
-  Matrix *gradients;
-  Matrix *derivedValues;
-  Matrix *gradientsTransposed;
-  Matrix *zActivatedVals;
-  Matrix *tempNewWeights;
-  Matrix *pGradients;
-  Matrix *transposedPWeights;
-  Matrix *hiddenDerived;
-  Matrix *transposedHidden;
+  int indexOutputLayer  = this->topology.size() - 1;
 
   /**
-   *  PART 1: OUTPUT TO LAST HIDDEN LAYER
+   *  OUTPUT LAYER GRADIENTS
    */
-  int indexOutputLayer  = this->topology.size() - 1;
-
-  gradients = new Matrix(
-                1,
-                this->topology.at(indexOutputLayer),
-                false
-              );
-
-  derivedValues = this->layers.at(indexOutputLayer)->matrixifyDerivedVals();
+  Matrix &outputGradients       = this->gradientMatrices.at(indexOutputLayer);
+  const Matrix &derivedValues   = this->layers.at(indexOutputLayer).matrixifyDerivedVals();
 
   for(int i = 0; i < this->topology.at(indexOutputLayer); i++) {
     double e  = this->derivedErrors.at(i);
-    double y  = derivedValues->getValue(0, i);
+    double y  = derivedValues.getValue(0, i);
     double g  = e * y;
-    gradients->setValue(0, i, g);
-  }
-
-  // Gt * Z
-  gradientsTransposed = gradients->transpose();
-  zActivatedVals      = this->layers.at(indexOutputLayer - 1)->matrixifyActivatedVals();
-
-  deltaWeights  = new Matrix(
-                    gradientsTransposed->getNumRows(),
-                    zActivatedVals->getNumCols(),
-                    false
-                  );
-
-  ::utils::Math::multiplyMatrix(gradientsTransposed, zActivatedVals, deltaWeights);
-
-  /**
-   * COMPUTE FOR NEW WEIGHTS (LAST HIDDEN <-> OUTPUT)
-   */
-  tempNewWeights  = new Matrix(
-                      this->topology.at(indexOutputLayer - 1),
-                      this->topology.at(indexOutputLayer),
-                      false
-                    );
-
-  for(int r = 0; r < this->topology.at(indexOutputLayer - 1); r++) {
-    for(int c = 0; c < this->topology.at(indexOutputLayer); c++) {
-
-      double originalValue  = this->weightMatrices.at(indexOutputLayer - 1)->getValue(r, c);
-      double deltaValue     = deltaWeights->getValue(c, r);
-
-      originalValue = this->momentum * originalValue;
-      deltaValue    = this->learningRate * deltaValue;
-      
-      tempNewWeights->setValue(r, c, (originalValue - deltaValue));
-    }
+    outputGradients.setValue(0, i, g);
   }
 
-  newWeights.push_back(new Matrix(*tempNewWeights));
-
-  delete gradientsTransposed;
-  delete zActivatedVals;
-  delete tempNewWeights;
-  delete deltaWeights;
-  delete derivedValues;
-
-  ///////////////////////////
-
   /**
-   *  PART 2: LAST HIDDEN LAYER TO INPUT LAYER
+   *  FROM THE OUTPUT LAYER DOWN TO THE INPUT LAYER
    */
-  for(int i = (indexOutputLayer - 1); i > 0; i--) {
-    pGradients  = new Matrix(*gradients);
-    delete gradients;
-
-    transposedPWeights  = this->weightMatrices.at(i)->transpose();
-
-    gradients   = new Matrix(
-                    pGradients->getNumRows(),
-                    transposedPWeights->getNumCols(),
-                    false
-                  );
+  for(int i = indexOutputLayer; i > 0; i--) {
+    Matrix &weights         = this->weightMatrices.at(i - 1);
+    const Matrix &gradients = this->gradientMatrices.at(i);
 
-    ::utils::Math::multiplyMatrix(pGradients, transposedPWeights, gradients);
+    // The gradients of the layer below go through the weights before these
+    // are updated.
+    if(i > 1) {
+      Matrix &hiddenGradients     = this->gradientMatrices.at(i - 1);
+      const Matrix &hiddenDerived = this->layers.at(i - 1).matrixifyDerivedVals();
 
-    hiddenDerived       = this->layers.at(i)->matrixifyDerivedVals();
+      ::utils::Math::multiplyMatrixTransposed(gradients, weights, hiddenGradients);
 
-    for(int colCounter = 0; colCounter < hiddenDerived->getNumCols(); colCounter++) {
-      double  g = gradients->getValue(0, colCounter) * hiddenDerived->getValue(0, colCounter);
-      gradients->setValue(0, colCounter, g);
-    }
+      double *g       = hiddenGradients.getRow(0);
+      const double *d = hiddenDerived.getRow(0);
 
-    if(i == 1) {
-      zActivatedVals  = this->layers.at(0)->matrixifyVals();
-    } else {
-      zActivatedVals  = this->layers.at(i-1)->matrixifyActivatedVals();
+      for(int colCounter = 0; colCounter < hiddenGradients.getNumCols(); colCounter++) {
+        g[colCounter] = g[colCounter] * d[colCounter];
+      }
     }
 
-    transposedHidden  = zActivatedVals->transpose();
-
-    deltaWeights      = new Matrix(
-                          transposedHidden->getNumRows(),
-                          gradients->getNumCols(),
-                          false
-                        );
-
-    ::utils::Math::multiplyMatrix(transposedHidden, gradients, deltaWeights);
+    // The weights into the output layer always take the activated values,
+    // the ones out of the input layer take its input values.
+    const Matrix &zVals = (i == 1 && i != indexOutputLayer)
+      ? this->layers.at(0).matrixifyVals()
+      : this->layers.at(i - 1).matrixifyActivatedVals();
 
-    // update weights
-    tempNewWeights  = new Matrix(
-                        this->weightMatrices.at(i - 1)->getNumRows(),
-                        this->weightMatrices.at(i - 1)->getNumCols(),
-                        false
-                      );
+    // W = momentum * W - learningRate * (Zt * G), one row at a time
+    const double *z                 = zVals.getRow(0);
+    const double *__restrict g      = gradients.getRow(0);
+    const int cols                  = weights.getNumCols();
 
-    for(int r = 0; r < tempNewWeights->getNumRows(); r++) {
-      for(int c = 0; c < tempNewWeights->getNumCols(); c++) {
-        double originalValue  = this->weightMatrices.at(i - 1)->getValue(r, c);
-        double deltaValue     = deltaWeights->getValue(r, c);
+    for(int r = 0; r < weights.getNumRows(); r++) {
+      const double zr         = z[r];
+      double *__restrict w    = weights.getRow(r);
 
-        originalValue = this->momentum * originalValue;
-        deltaValue    = this->learningRate * deltaValue;
-        
-        tempNewWeights->setValue(r, c, (originalValue - deltaValue));
+      for(int c = 0; c < cols; c++) {
+        w[c] = (this->momentum * w[c]) - (this->learningRate * (zr * g[c]));
       }
     }
-
-    newWeights.push_back(new Matrix(*tempNewWeights));
-
-    delete pGradients;
-    delete transposedPWeights;
-    delete hiddenDerived;
-    delete zActivatedVals;
-    delete transposedHidden;
-    delete tempNewWeights;
-    delete deltaWeights;
-  }
-
-  for(unsigned int i = 0; i < this->weightMatrices.size(); i++) {
-    delete this->weightMatrices[i];
-  }
-
-  this->weightMatrices.clear();
-
-  reverse(newWeights.begin(), newWeights.end());
-
-  for(unsigned int i = 0; i < newWeights.size(); i++) {
-    this->weightMatrices.push_back(new Matrix(*newWeights[i]));
-    delete newWeights[i];
   }
 }
@@ -15,21 +15,21 @@ NeuralNetwork::NeuralNetwork(ANNConfig config) {
 
   for(int i = 0; i < topologySize; i++) {
     if(i > 0 && i < (topologySize - 1)) {
-      Layer *l  = new Layer(topology.at(i), this->hiddenActivationType);
-      this->layers.push_back(l);
+      this->layers.push_back(Layer(topology.at(i), this->hiddenActivationType));
     } else if(i == (topologySize - 1)) {
-      Layer *l  = new Layer(topology.at(i), this->outputActivationType);
-      this->layers.push_back(l);
+      this->layers.push_back(Layer(topology.at(i), this->outputActivationType));
     } else {
-      Layer *l  = new Layer(topology.at(i));
-      this->layers.push_back(l);
+      this->layers.push_back(Layer(topology.at(i)));
     }
   }
 
   for(int i = 0; i < (topologySize - 1); i++) {
-    Matrix *m = new Matrix(topology.at(i), topology.at(i + 1), true);
+    this->weightMatrices.push_back(Matrix(topology.at(i), topology.at(i + 1), true));
+  }
 
-    this->weightMatrices.push_back(m);
+  // Gradients of each layer, reused by every backpropagation
+  for(int i = 0; i < topologySize; i++) {
+    this->gradientMatrices.push_back(Matrix(1, topology.at(i), false));
   }
 
   // Initialize empty errors
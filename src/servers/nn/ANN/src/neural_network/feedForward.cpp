@@ -2,31 +2,27 @@
 #include "../../include/utils/Math.hpp"
 
 void NeuralNetwork::feedForward() {
-  Matrix *a;  // Matrix of neurons to the left
-  Matrix *b;  // Matrix of weights to the right of layer
-  Matrix *c;  // Matrix of neurons to the next layer
-
   for(int i = 0; i < (this->topologySize - 1); i++) {
-    a = this->getNeuronMatrix(i);
-    b = this->getWeightMatrix(i);
-    c = new Matrix(
-          a->getNumRows(),
-          b->getNumCols(),
-          false
-        );
+    // Neurons to the left, the input values for the input layer
+    const Matrix &a = (i == 0)
+      ? this->getNeuronMatrix(i)
+      : this->getActivatedNeuronMatrix(i);
 
-    if(i != 0) {
-      a = this->getActivatedNeuronMatrix(i);
-    }
+    // Weights to the right of the layer
+    const Matrix &b = this->getWeightMatrix(i);
+
+    // Neurons of the next layer, computed in place
+    Layer &next = this->layers.at(i + 1);
+    Matrix &c   = next.matrixifyVals();
 
     utils::Math::multiplyMatrix(a, b, c);
 
-    for(int c_index = 0; c_index < c->getNumCols(); c_index++) {
-      this->setNeuronValue(i + 1, c_index, c->getValue(0, c_index) + this->bias);
+    double *values = c.getRow(0);
+
+    for(int c_index = 0; c_index < c.getNumCols(); c_index++) {
+      values[c_index] += this->bias;
     }
 
-    delete a;
-    delete b;
-    delete c;
+    next.activate();
   }
 }
@@ -8,14 +8,14 @@ void NeuralNetwork::setErrors() {
 }
 
 void NeuralNetwork::setErrorMSE() {
-  int outputLayerIndex            = this->layers.size() - 1;
-  vector<Neuron *> outputNeurons  = this->layers.at(outputLayerIndex)->getNeurons();
+  int outputLayerIndex          = this->layers.size() - 1;
+  const Matrix &outputValues    = this->layers.at(outputLayerIndex).matrixifyActivatedVals();
 
   this->error = 0.00;
 
   for(unsigned int i = 0; i < target.size(); i++) {
     double t  = target.at(i);
-    double y  = outputNeurons.at(i)->getActivatedVal();
+    double y  = outputValues.getValue(0, i);
 
     errors.at(i)        = 0.5 * pow(abs((t - y)), 2);
     derivedErrors.at(i) = (y - t);
@@ -1,8 +1,8 @@
 #include "../../include/NeuralNetwork.hpp"
 
 void NeuralNetwork::train(
-  vector<double> input, 
-  vector<double> target, 
+  const vector<double> &input, 
+  const vector<double> &target, 
   double bias, 
   double learningRate, 
   double momentum
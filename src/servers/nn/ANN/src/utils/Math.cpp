@@ -1,15 +1,96 @@
 #include "../../include/utils/Math.hpp"
 
-void utils::Math::multiplyMatrix(Matrix *a, Matrix *b, Matrix *c) {
-  for(int i = 0; i < a->getNumRows(); i++) {
-    for(int j = 0; j < b->getNumCols(); j++) {
-      for(int k = 0; k < b->getNumRows(); k++) {
-        double p      = a->getValue(i, k) * b->getValue(k, j);
-        double newVal = c->getValue(i, j) + p;
-        c->setValue(i, j, newVal);
+#include <algorithm>
+
+// Rows of b are streamed from memory once per block of rows of a, and each
+// block of rows of b is sized to stay in the L2 cache meanwhile.
+static const int BLOCK_ROWS   = 32;
+static const int BLOCK_DEPTH  = 256;
+
+void utils::Math::multiplyMatrix(const Matrix &a, const Matrix &b, Matrix &c) {
+  const int rows  = a.getNumRows();
+  const int depth = b.getNumRows();
+  const int cols  = b.getNumCols();
+
+  assert(a.getNumCols() == depth);
+  assert(c.getNumRows() == rows && c.getNumCols() == cols);
+
+  c.fill(0.00);
+
+  // The products are added to each value of c in the order of k, as in the
+  // plain triple loop, so the results do not depend on the block sizes.
+  for(int ii = 0; ii < rows; ii += BLOCK_ROWS) {
+    const int iEnd = min(ii + BLOCK_ROWS, rows);
+
+    for(int kk = 0; kk < depth; kk += BLOCK_DEPTH) {
+      const int kEnd = min(kk + BLOCK_DEPTH, depth);
+
+      for(int i = ii; i < iEnd; i++) {
+        const double *aRow      = a.getRow(i);
+        double *__restrict cRow = c.getRow(i);
+
+        for(int k = kk; k < kEnd; k++) {
+          const double aik                = aRow[k];
+          const double *__restrict bRow   = b.getRow(k);
+
+          for(int j = 0; j < cols; j++) {
+            cRow[j] += aik * bRow[j];
+          }
+        }
+      }
+    }
+  }
+}
+
+void utils::Math::multiplyMatrixTransposed(const Matrix &a, const Matrix &b, Matrix &c) {
+  const int rows  = a.getNumRows();
+  const int depth = a.getNumCols();
+  const int cols  = b.getNumRows();
+
+  assert(b.getNumCols() == depth);
+  assert(c.getNumRows() == rows && c.getNumCols() == cols);
+
+  for(int i = 0; i < rows; i++) {
+    const double *__restrict aRow = a.getRow(i);
+    double *cRow                  = c.getRow(i);
+
+    // Four rows of b at a time keep four independent sums in flight while
+    // each of them is still added up in the order of k.
+    int j = 0;
+
+    for(; j + 4 <= cols; j += 4) {
+      const double *__restrict b0 = b.getRow(j);
+      const double *__restrict b1 = b.getRow(j + 1);
+      const double *__restrict b2 = b.getRow(j + 2);
+      const double *__restrict b3 = b.getRow(j + 3);
+
+      double s0 = 0.00;
+      double s1 = 0.00;
+      double s2 = 0.00;
+      double s3 = 0.00;
+
+      for(int k = 0; k < depth; k++) {
+        s0 += aRow[k] * b0[k];
+        s1 += aRow[k] * b1[k];
+        s2 += aRow[k] * b2[k];
+        s3 += aRow[k] * b3[k];
+      }
+
+      cRow[j]     = s0;
+      cRow[j + 1] = s1;
+      cRow[j + 2] = s2;
+      cRow[j + 3] = s3;
+    }
+
+    for(; j < cols; j++) {
+      const double *__restrict bRow = b.getRow(j);
+      double s = 0.00;
+
+      for(int k = 0; k < depth; k++) {
+        s += aRow[k] * bRow[k];
       }
 
-      c->setValue(i, j, c->getValue(i, j));
-    } 
+      cRow[j] = s;
+    }
   }
 }
@@ -12,6 +12,25 @@ typedef double Scalar;
 typedef MDNN_SCALAR Scalar;
 #endif
 
+// Storage precision of the parameters of hidden layers.
+// Reduced precisions are meant for inference after training, see Layer::quantize()
+enum Precision
+{
+    FULL_PRECISION = 0,  // Scalar
+    INT8_PRECISION,      // 8-bit integers with a scale for each output unit or channel
+    FLOAT16_PRECISION    // Half precision floating-point numbers
+};
+
+// Algorithm of the convolutions of convolutional layers, see Utils/Convolution.h.
+// They all give the same results up to rounding
+enum ConvAlgorithm
+{
+    CONV_AUTO = 0,  // The fastest one for each shape, measured at first use
+    CONV_MEC,       // Memory efficient convolution
+    CONV_IM2COL,    // One matrix product per image over all the patches of the image
+    CONV_WINOGRAD   // Winograd's minimal filtering F(2x2, 3x3), only for 3x3 filters
+};
+
 
 } // namespace MiniDNN
 
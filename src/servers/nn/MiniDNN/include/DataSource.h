@@ -0,0 +1,56 @@
+#ifndef DATASOURCE_H_
+#define DATASOURCE_H_
+
+#include "../Eigen/Core"
+#include "Config.h"
+
+namespace MiniDNN
+{
+
+
+///
+/// \defgroup DataSources Data Sources
+///
+
+///
+/// \ingroup DataSources
+///
+/// The interface of data sources that deliver the training data in chunks,
+/// so that a network can be fitted on data sets that do not fit in memory.
+/// See Network::fit() for how the chunks are consumed.
+///
+class DataSource
+{
+    protected:
+        typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+
+    public:
+        virtual ~DataSource() {}
+
+        ///
+        /// Start a new pass over the data
+        ///
+        /// Implementations should visit the chunks in a new random order
+        /// in every pass, since mini-batches are only shuffled within a chunk.
+        ///
+        virtual void rewind() = 0;
+
+        ///
+        /// Read the next chunk of the current pass
+        ///
+        /// This method is called on a background thread, but never concurrently
+        /// with itself or with rewind().
+        ///
+        /// \param x On exit, the predictors of the chunk. Each column is an observation.
+        /// \param y On exit, the response variables of the chunk. Each column is an observation.
+        ///
+        /// \return `false` if the pass is finished, `true` otherwise.
+        ///
+        virtual bool read_chunk(Matrix& x, Matrix& y) = 0;
+};
+
+
+} // namespace MiniDNN
+
+
+#endif /* DATASOURCE_H_ */
@@ -4,6 +4,7 @@
 #include "../Eigen/Core"
 #include <vector>
 #include <map>
+#include <stdexcept>
 #include "Config.h"
 #include "RNG.h"
 #include "Optimizer.h"
@@ -162,6 +163,62 @@ class Layer
         ///
         virtual std::vector<Scalar> get_derivatives() const = 0;
 
+        ///
+        /// Copy the parameters of another layer of the same type and dimensions
+        ///
+        /// This is used to keep the replicas of a network in sync in data-parallel
+        /// training. The default implementation goes through the serialized parameters.
+        ///
+        /// \param other The layer to copy the parameters from.
+        ///
+        virtual void copy_parameters(const Layer& other)
+        {
+            set_parameters(other.get_parameters());
+        }
+
+        ///
+        /// Combine the gradient of parameters with the one computed by another layer
+        /// of the same type and dimensions, so that the gradient of this layer becomes
+        /// `weight * gradient + other_weight * other_gradient`
+        ///
+        /// This is used to reduce the gradients computed on parts of a mini-batch in
+        /// data-parallel training. Layers with parameters must override this function.
+        ///
+        /// \param weight       Weight of the gradient of this layer.
+        /// \param other        The layer that computed the other gradient.
+        /// \param other_weight Weight of the gradient of `other`.
+        ///
+        virtual void combine_derivatives(const Scalar& weight, const Layer& other,
+                                         const Scalar& other_weight)
+        {
+            if (!get_derivatives().empty())
+            {
+                throw std::logic_error("[class Layer]: This layer cannot combine its gradients");
+            }
+        }
+
+        ///
+        /// Change the storage precision of the layer parameters
+        ///
+        /// Storing the parameters in INT8_PRECISION or FLOAT16_PRECISION is meant for
+        /// inference after training: it makes the layer smaller and its forward
+        /// propagation faster, at the cost of some accuracy. A layer with reduced
+        /// precision cannot be trained; quantizing it back to FULL_PRECISION, or
+        /// setting its parameters, restores full precision parameters.
+        /// Layers without parameters ignore this function.
+        ///
+        /// \param precision The new precision of the parameters.
+        ///
+        virtual void quantize(Precision precision) {}
+
+        ///
+        /// Get the storage precision of the layer parameters
+        ///
+        virtual Precision precision() const
+        {
+            return FULL_PRECISION;
+        }
+
         ///
         /// Return the layer type. It is used to export the NN model.
         ///
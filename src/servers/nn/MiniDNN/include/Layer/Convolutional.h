@@ -10,6 +10,7 @@
 #include "../Utils/Random.h"
 #include "../Utils/IO.h"
 #include "../Utils/Enum.h"
+#include "../Utils/Quantization.h"
 
 
 namespace MiniDNN
@@ -51,6 +52,152 @@ class Convolutional: public Layer
         Matrix m_din;          // Derivative of the input of this layer
                                // Note that input of this layer is also the output of previous layer
 
+        internal::QuantizedMatrix m_quantized; // Filters in reduced precision, with one row per output channel.
+                                               // m_filter_data is empty when they are set
+        std::vector<int8_t> m_int8_image;  // Quantized input of one observation
+        std::vector<int8_t> m_int8_patch;  // Quantized input covered by the filters at one position
+        std::vector<float> m_float_image;  // Single precision input of one observation
+        std::vector<float> m_float_patch;  // Single precision input covered by the filters at one position
+        Vector m_patch_z;      // Linear term of all the output channels at one position
+
+        internal::ConvTuner m_forward_tuner; // Algorithms of the convolutions of the forward pass,
+        internal::ConvTuner m_filter_tuner;  // of the derivative of the filters
+        internal::ConvTuner m_input_tuner;   // and of the derivative of the input
+
+        void check_full_precision() const
+        {
+            if (m_quantized.precision() != FULL_PRECISION)
+            {
+                throw std::logic_error("[class Convolutional]: Layers with reduced precision cannot be trained");
+            }
+        }
+
+        // Layer of the same type, with the same dimensions, as this one
+        const Convolutional& same_layer(const Layer& other) const
+        {
+            const Convolutional* layer = dynamic_cast<const Convolutional*>(&other);
+
+            if (layer == NULL || layer->m_in_size != this->m_in_size ||
+                    layer->m_out_size != this->m_out_size ||
+                    layer->m_dim.in_channels != m_dim.in_channels ||
+                    layer->m_dim.out_channels != m_dim.out_channels)
+            {
+                throw std::invalid_argument("[class Convolutional]: Layers do not match");
+            }
+
+            return *layer;
+        }
+
+        // Arrange the filters as rows of a matrix, one row per output channel.
+        // In m_filter_data, the filters are grouped by input channel instead
+        void pack_filters(const Scalar* filter_data, std::vector<Scalar>& rows) const
+        {
+            const int filter_size = m_dim.filter_rows * m_dim.filter_cols;
+            const int row_size = m_dim.in_channels * filter_size;
+            rows.resize(m_dim.out_channels * row_size);
+
+            for (int i = 0; i < m_dim.in_channels; i++)
+            {
+                for (int l = 0; l < m_dim.out_channels; l++)
+                {
+                    std::copy(filter_data + (i * m_dim.out_channels + l) * filter_size,
+                              filter_data + (i * m_dim.out_channels + l + 1) * filter_size,
+                              rows.begin() + l * row_size + i * filter_size);
+                }
+            }
+        }
+
+        void unpack_filters(const std::vector<Scalar>& rows, Scalar* filter_data) const
+        {
+            const int filter_size = m_dim.filter_rows * m_dim.filter_cols;
+            const int row_size = m_dim.in_channels * filter_size;
+
+            for (int i = 0; i < m_dim.in_channels; i++)
+            {
+                for (int l = 0; l < m_dim.out_channels; l++)
+                {
+                    std::copy(rows.begin() + l * row_size + i * filter_size,
+                              rows.begin() + l * row_size + (i + 1) * filter_size,
+                              filter_data + (i * m_dim.out_channels + l) * filter_size);
+                }
+            }
+        }
+
+        // Gather the input covered by the filters at one position, in the order of the
+        // filter data: by input channel, then column, then row. Channels are stored by columns
+        template <typename T>
+        void gather_patch(const T* image, const int j, const int r, T* patch) const
+        {
+            const int channel_size = m_dim.channel_rows * m_dim.channel_cols;
+
+            for (int i = 0; i < m_dim.in_channels; i++)
+            {
+                const T* reader = image + i * channel_size + j * m_dim.channel_rows + r;
+
+                for (int c = 0; c < m_dim.filter_cols;
+                        c++, reader += m_dim.channel_rows, patch += m_dim.filter_rows)
+                {
+                    std::copy(reader, reader + m_dim.filter_rows, patch);
+                }
+            }
+        }
+
+        // Convolution with the filters in reduced precision. Each observation is converted
+        // once, then at each position the patch covered by the filters is multiplied by the
+        // filters of all the output channels at once
+        void convolve_quantized(const Scalar* src, const int nobs)
+        {
+            const int conv_size = m_dim.conv_rows * m_dim.conv_cols;
+            const bool int8 = (m_quantized.precision() == INT8_PRECISION);
+
+            if (int8)
+            {
+                m_int8_image.resize(this->m_in_size);
+                m_int8_patch.assign(m_quantized.stride(), 0);
+            } else {
+                m_float_image.resize(this->m_in_size);
+                m_float_patch.assign(m_quantized.stride(), 0.0f);
+            }
+
+            m_patch_z.resize(m_dim.out_channels);
+            Scalar* dest = m_z.data();
+
+            for (int n = 0; n < nobs; n++, src += this->m_in_size, dest += this->m_out_size)
+            {
+                float x_scale = 0.0f;
+
+                if (int8)
+                {
+                    x_scale = internal::quantize_int8(src, this->m_in_size, &m_int8_image[0]);
+                } else {
+                    std::copy(src, src + this->m_in_size, m_float_image.begin());
+                }
+
+                for (int j = 0; j < m_dim.conv_cols; j++)
+                {
+                    for (int r = 0; r < m_dim.conv_rows; r++)
+                    {
+                        if (int8)
+                        {
+                            gather_patch(&m_int8_image[0], j, r, &m_int8_patch[0]);
+                            m_quantized.multiply_int8(&m_int8_patch[0], x_scale, m_patch_z.data());
+                        } else {
+                            gather_patch(&m_float_image[0], j, r, &m_float_patch[0]);
+                            m_quantized.multiply_float(&m_float_patch[0], m_patch_z.data());
+                        }
+
+                        // Each output channel has conv_rows x conv_cols elements, stored by columns
+                        Scalar* z = dest + j * m_dim.conv_rows + r;
+
+                        for (int l = 0; l < m_dim.out_channels; l++, z += conv_size)
+                        {
+                            *z = m_patch_z[l];
+                        }
+                    }
+                }
+            }
+        }
+
     public:
         ///
         /// Constructor
@@ -84,8 +231,22 @@ class Convolutional: public Layer
             internal::set_normal_random(m_bias.data(), m_dim.out_channels, rng, mu, sigma);
         }
 
+        ///
+        /// Set the algorithm of the convolutions in full precision. With CONV_AUTO, the
+        /// default, each convolution of the layer uses the algorithm that was the fastest
+        /// the first time it was made with the same number of observations. An algorithm
+        /// that does not apply to one of the convolutions is replaced by the fastest one.
+        ///
+        void set_conv_algorithm(ConvAlgorithm algorithm)
+        {
+            m_forward_tuner.set_algorithm(algorithm);
+            m_filter_tuner.set_algorithm(algorithm);
+            m_input_tuner.set_algorithm(algorithm);
+        }
+
         void init()
         {
+            m_quantized.clear();
             // Set parameter dimension
             const int filter_data_size = m_dim.in_channels * m_dim.out_channels *
                                          m_dim.filter_rows * m_dim.filter_cols;
@@ -104,10 +265,21 @@ class Convolutional: public Layer
             const int nobs = prev_layer_data.cols();
             // Linear term, z = conv(in, w) + b
             m_z.resize(this->m_out_size, nobs);
+
             // Convolution
-            internal::convolve_valid(m_dim, prev_layer_data.data(), true, nobs,
-                                     m_filter_data.data(), m_z.data()
-                                    );
+            if (m_quantized.precision() != FULL_PRECISION)
+            {
+                convolve_quantized(prev_layer_data.data(), nobs);
+            } else {
+                const Scalar* src = prev_layer_data.data();
+                m_forward_tuner.run(m_dim, nobs, [this, src, nobs](ConvAlgorithm algorithm)
+                {
+                    internal::convolve_valid(m_dim, algorithm, src, true, nobs,
+                                             m_filter_data.data(), m_z.data()
+                                            );
+                });
+            }
+
             // Add bias terms
             // Each column of m_z contains m_dim.out_channels channels, and each channel has
             // m_dim.conv_rows * m_dim.conv_cols elements
@@ -134,6 +306,7 @@ class Convolutional: public Layer
         // https://grzegorzgwardys.wordpress.com/2016/04/22/8/
         void backprop(const Matrix& prev_layer_data, const Matrix& next_layer_data)
         {
+            check_full_precision();
             const int nobs = prev_layer_data.cols();
             // After forward stage, m_z contains z = conv(in, w) + b
             // Now we need to calculate d(L) / d(z) = [d(a) / d(z)] * [d(L) / d(a)]
@@ -157,10 +330,15 @@ class Convolutional: public Layer
             internal::ConvDims back_conv_dim(nobs, m_dim.out_channels, m_dim.channel_rows,
                                              m_dim.channel_cols,
                                              m_dim.conv_rows, m_dim.conv_cols);
-            internal::convolve_valid(back_conv_dim, prev_layer_data.data(), false,
-                                     m_dim.in_channels,
-                                     dLz.data(), m_df_data.data()
-                                    );
+            const Scalar* src = prev_layer_data.data();
+            m_filter_tuner.run(back_conv_dim, m_dim.in_channels,
+                               [this, &back_conv_dim, src, &dLz](ConvAlgorithm algorithm)
+            {
+                internal::convolve_valid(back_conv_dim, algorithm, src, false,
+                                         m_dim.in_channels,
+                                         dLz.data(), m_df_data.data()
+                                        );
+            });
             m_df_data /= nobs;
             // Derivative for bias
             // Aggregate d(L) / d(z) in each output channel
@@ -174,9 +352,13 @@ class Convolutional: public Layer
             m_din.resize(this->m_in_size, nobs);
             internal::ConvDims conv_full_dim(m_dim.out_channels, m_dim.in_channels,
                                              m_dim.conv_rows, m_dim.conv_cols, m_dim.filter_rows, m_dim.filter_cols);
-            internal::convolve_full(conv_full_dim, dLz.data(), nobs,
-                                    m_filter_data.data(), m_din.data()
-                                   );
+            m_input_tuner.run(conv_full_dim, nobs,
+                              [this, &conv_full_dim, &dLz, nobs](ConvAlgorithm algorithm)
+            {
+                internal::convolve_full(conv_full_dim, algorithm, dLz.data(), nobs,
+                                        m_filter_data.data(), m_din.data()
+                                       );
+            });
         }
 
         const Matrix& backprop_data() const
@@ -186,6 +368,7 @@ class Convolutional: public Layer
 
         void update(Optimizer& opt)
         {
+            check_full_precision();
             ConstAlignedMapVec dw(m_df_data.data(), m_df_data.size());
             ConstAlignedMapVec db(m_db.data(), m_db.size());
             AlignedMapVec      w(m_filter_data.data(), m_filter_data.size());
@@ -196,27 +379,60 @@ class Convolutional: public Layer
 
         std::vector<Scalar> get_parameters() const
         {
-            std::vector<Scalar> res(m_filter_data.size() + m_bias.size());
+            const int filter_data_size = m_dim.in_channels * m_dim.out_channels *
+                                         m_dim.filter_rows * m_dim.filter_cols;
+            std::vector<Scalar> res(filter_data_size + m_bias.size());
+
             // Copy the data of filters and bias to a long vector
-            std::copy(m_filter_data.data(), m_filter_data.data() + m_filter_data.size(),
-                      res.begin());
+            if (m_quantized.precision() != FULL_PRECISION)
+            {
+                std::vector<Scalar> rows(filter_data_size);
+                m_quantized.decompress(&rows[0]);
+                unpack_filters(rows, &res[0]);
+            } else {
+                std::copy(m_filter_data.data(), m_filter_data.data() + m_filter_data.size(),
+                          res.begin());
+            }
+
             std::copy(m_bias.data(), m_bias.data() + m_bias.size(),
-                      res.begin() + m_filter_data.size());
+                      res.begin() + filter_data_size);
             return res;
         }
 
         void set_parameters(const std::vector<Scalar>& param)
         {
-            if (static_cast<int>(param.size()) != m_filter_data.size() + m_bias.size())
+            const int filter_data_size = m_dim.in_channels * m_dim.out_channels *
+                                         m_dim.filter_rows * m_dim.filter_cols;
+
+            if (static_cast<int>(param.size()) != filter_data_size + m_bias.size())
             {
                 throw std::invalid_argument("[class Convolutional]: Parameter size does not match");
             }
 
+            quantize(FULL_PRECISION);
+
             std::copy(param.begin(), param.begin() + m_filter_data.size(),
                       m_filter_data.data());
             std::copy(param.begin() + m_filter_data.size(), param.end(), m_bias.data());
         }
 
+        void copy_parameters(const Layer& other)
+        {
+            const Convolutional& layer = same_layer(other);
+            layer.check_full_precision();
+            check_full_precision();
+            m_filter_data = layer.m_filter_data;
+            m_bias = layer.m_bias;
+        }
+
+        void combine_derivatives(const Scalar& weight, const Layer& other,
+                                 const Scalar& other_weight)
+        {
+            const Convolutional& layer = same_layer(other);
+            m_df_data = weight * m_df_data + other_weight * layer.m_df_data;
+            m_db = weight * m_db + other_weight * layer.m_db;
+        }
+
         std::vector<Scalar> get_derivatives() const
         {
             std::vector<Scalar> res(m_df_data.size() + m_db.size());
@@ -227,6 +443,44 @@ class Convolutional: public Layer
             return res;
         }
 
+        void quantize(Precision precision)
+        {
+            if (precision == m_quantized.precision())
+            {
+                return;
+            }
+
+            const int filter_data_size = m_dim.in_channels * m_dim.out_channels *
+                                         m_dim.filter_rows * m_dim.filter_cols;
+            std::vector<Scalar> rows;
+
+            // Changes between reduced precisions go through full precision
+            if (m_quantized.precision() != FULL_PRECISION)
+            {
+                rows.resize(filter_data_size);
+                m_quantized.decompress(&rows[0]);
+                m_quantized.clear();
+                m_filter_data.resize(filter_data_size);
+                m_df_data.resize(filter_data_size);
+                unpack_filters(rows, m_filter_data.data());
+            }
+
+            if (precision != FULL_PRECISION)
+            {
+                pack_filters(m_filter_data.data(), rows);
+                m_quantized.compress(precision, &rows[0], m_dim.out_channels,
+                                     filter_data_size / m_dim.out_channels);
+                // Only keep the reduced precision filters
+                m_filter_data.resize(0);
+                m_df_data.resize(0);
+            }
+        }
+
+        Precision precision() const
+        {
+            return m_quantized.precision();
+        }
+
         std::string layer_type() const
         {
             return "Convolutional";
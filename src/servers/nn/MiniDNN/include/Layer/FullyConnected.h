@@ -9,6 +9,7 @@
 #include "../Utils/Random.h"
 #include "../Utils/IO.h"
 #include "../Utils/Enum.h"
+#include "../Utils/Quantization.h"
 
 namespace MiniDNN
 {
@@ -37,6 +38,30 @@ class FullyConnected: public Layer
         Matrix m_a;       // Output of this layer, a = act(z)
         Matrix m_din;     // Derivative of the input of this layer.
                           // Note that input of this layer is also the output of previous layer
+        internal::QuantizedMatrix m_quantized; // Weights in reduced precision, with one row per output unit.
+                                               // m_weight is empty when they are set
+
+        void check_full_precision() const
+        {
+            if (m_quantized.precision() != FULL_PRECISION)
+            {
+                throw std::logic_error("[class FullyConnected]: Layers with reduced precision cannot be trained");
+            }
+        }
+
+        // Layer of the same type, with the same dimensions, as this one
+        const FullyConnected& same_layer(const Layer& other) const
+        {
+            const FullyConnected* layer = dynamic_cast<const FullyConnected*>(&other);
+
+            if (layer == NULL || layer->m_in_size != this->m_in_size ||
+                    layer->m_out_size != this->m_out_size)
+            {
+                throw std::invalid_argument("[class FullyConnected]: Layers do not match");
+            }
+
+            return *layer;
+        }
 
     public:
         ///
@@ -60,6 +85,7 @@ class FullyConnected: public Layer
 
         void init()
         {
+            m_quantized.clear();
             // Set parameter dimension
             m_weight.resize(this->m_in_size, this->m_out_size);
             m_bias.resize(this->m_out_size);
@@ -73,7 +99,18 @@ class FullyConnected: public Layer
             const int nobs = prev_layer_data.cols();
             // Linear term z = W' * in + b
             m_z.resize(this->m_out_size, nobs);
-            m_z.noalias() = m_weight.transpose() * prev_layer_data;
+
+            if (m_quantized.precision() != FULL_PRECISION)
+            {
+                for (int i = 0; i < nobs; i++)
+                {
+                    m_quantized.multiply(prev_layer_data.data() + i * this->m_in_size,
+                                         m_z.data() + i * this->m_out_size);
+                }
+            } else {
+                m_z.noalias() = m_weight.transpose() * prev_layer_data;
+            }
+
             m_z.colwise() += m_bias;
             // Apply activation function
             m_a.resize(this->m_out_size, nobs);
@@ -89,6 +126,7 @@ class FullyConnected: public Layer
         // next_layer_data: out_size x nobs
         void backprop(const Matrix& prev_layer_data, const Matrix& next_layer_data)
         {
+            check_full_precision();
             const int nobs = prev_layer_data.cols();
             // After forward stage, m_z contains z = W' * in + b
             // Now we need to calculate d(L) / d(z) = [d(a) / d(z)] * [d(L) / d(a)]
@@ -113,6 +151,7 @@ class FullyConnected: public Layer
 
         void update(Optimizer& opt)
         {
+            check_full_precision();
             ConstAlignedMapVec dw(m_dw.data(), m_dw.size());
             ConstAlignedMapVec db(m_db.data(), m_db.size());
             AlignedMapVec      w(m_weight.data(), m_weight.size());
@@ -123,25 +162,53 @@ class FullyConnected: public Layer
 
         std::vector<Scalar> get_parameters() const
         {
-            std::vector<Scalar> res(m_weight.size() + m_bias.size());
+            const int weight_size = this->m_in_size * this->m_out_size;
+            std::vector<Scalar> res(weight_size + m_bias.size());
+
             // Copy the data of weights and bias to a long vector
-            std::copy(m_weight.data(), m_weight.data() + m_weight.size(), res.begin());
+            if (m_quantized.precision() != FULL_PRECISION)
+            {
+                m_quantized.decompress(&res[0]);
+            } else {
+                std::copy(m_weight.data(), m_weight.data() + m_weight.size(), res.begin());
+            }
+
             std::copy(m_bias.data(), m_bias.data() + m_bias.size(),
-                      res.begin() + m_weight.size());
+                      res.begin() + weight_size);
             return res;
         }
 
         void set_parameters(const std::vector<Scalar>& param)
         {
-            if (static_cast<int>(param.size()) != m_weight.size() + m_bias.size())
+            const int weight_size = this->m_in_size * this->m_out_size;
+
+            if (static_cast<int>(param.size()) != weight_size + m_bias.size())
             {
                 throw std::invalid_argument("[class FullyConnected]: Parameter size does not match");
             }
 
+            quantize(FULL_PRECISION);
             std::copy(param.begin(), param.begin() + m_weight.size(), m_weight.data());
             std::copy(param.begin() + m_weight.size(), param.end(), m_bias.data());
         }
 
+        void copy_parameters(const Layer& other)
+        {
+            const FullyConnected& layer = same_layer(other);
+            layer.check_full_precision();
+            check_full_precision();
+            m_weight = layer.m_weight;
+            m_bias = layer.m_bias;
+        }
+
+        void combine_derivatives(const Scalar& weight, const Layer& other,
+                                 const Scalar& other_weight)
+        {
+            const FullyConnected& layer = same_layer(other);
+            m_dw = weight * m_dw + other_weight * layer.m_dw;
+            m_db = weight * m_db + other_weight * layer.m_db;
+        }
+
         std::vector<Scalar> get_derivatives() const
         {
             std::vector<Scalar> res(m_dw.size() + m_db.size());
@@ -151,6 +218,39 @@ class FullyConnected: public Layer
             return res;
         }
 
+        void quantize(Precision precision)
+        {
+            if (precision == m_quantized.precision())
+            {
+                return;
+            }
+
+            // Changes between reduced precisions go through full precision
+            if (m_quantized.precision() != FULL_PRECISION)
+            {
+                m_weight.resize(this->m_in_size, this->m_out_size);
+                m_dw.resize(this->m_in_size, this->m_out_size);
+                m_quantized.decompress(m_weight.data());
+                m_quantized.clear();
+            }
+
+            if (precision != FULL_PRECISION)
+            {
+                // Column j of m_weight holds the weights of output unit j, which
+                // makes it row j of the quantized matrix
+                m_quantized.compress(precision, m_weight.data(), this->m_out_size,
+                                     this->m_in_size);
+                // Only keep the reduced precision weights
+                m_weight.resize(0, 0);
+                m_dw.resize(0, 0);
+            }
+        }
+
+        Precision precision() const
+        {
+            return m_quantized.precision();
+        }
+
         std::string layer_type() const
         {
             return "FullyConnected";
@@ -33,6 +33,8 @@
 #include "Callback.h"
 #include "Callback/VerboseCallback.h"
 
+#include "DataSource.h"
+
 #include "Network.h"
 
 
@@ -4,15 +4,19 @@
 #include "../Eigen/Core"
 #include <vector>
 #include <map>
+#include <memory>
+#include <future>
 #include <stdexcept>
 #include "Config.h"
 #include "RNG.h"
 #include "Layer.h"
 #include "Output.h"
 #include "Callback.h"
+#include "DataSource.h"
 #include "Utils/Random.h"
 #include "Utils/IO.h"
 #include "Utils/Factory.h"
+#include "Utils/WorkerGroup.h"
 
 namespace MiniDNN
 {
@@ -35,6 +39,7 @@ class Network
         typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
         typedef Eigen::RowVectorXi IntegerVector;
         typedef std::map<std::string, int> MetaInfo;
+        typedef std::vector< std::unique_ptr<Network> > ReplicaList;
 
         RNG                 m_default_rng;      // Built-in RNG
         RNG&                m_rng;              // Reference to the RNG provided by the user,
@@ -146,6 +151,144 @@ class Network
             }
         }
 
+        // Create the networks that train on parts of each mini-batch in the other threads
+        // of data-parallel fitting. They are built from the meta information of this
+        // network, so all the layers must be of the types known to internal::create_layer()
+        void create_replicas(const int nreplica, ReplicaList& replicas) const
+        {
+            const MetaInfo map = this->get_meta_info();
+            const int nlayer = num_layers();
+            replicas.clear();
+
+            for (int t = 0; t < nreplica; t++)
+            {
+                replicas.push_back(std::unique_ptr<Network>(new Network()));
+                Network* replica = replicas.back().get();
+
+                for (int i = 0; i < nlayer; i++)
+                {
+                    replica->add_layer(internal::create_layer(map, i));
+                }
+
+                replica->set_output(internal::create_output(map));
+            }
+        }
+
+        // Train on the parts of a mini-batch, the first one in this thread and the others in
+        // the replicas, then update the parameters with the mean of their gradients.
+        // The worker of each replica copies its own part of the mini-batch into x_parts and y_parts
+        template <typename XType, typename YType>
+        void train_parts(Optimizer& opt, ReplicaList& replicas, internal::WorkerGroup& workers,
+                         const XType& x, const YType& y,
+                         std::vector<XType>& x_parts, std::vector<YType>& y_parts)
+        {
+            const int nlayer = num_layers();
+            const int nobs = x.cols();
+            const int npart = std::min(int(replicas.size()) + 1, nobs);
+
+            // Split the observations into npart parts of nearly equal sizes
+            std::vector<int> starts(npart + 1, 0);
+
+            for (int t = 0; t < npart; t++)
+            {
+                starts[t + 1] = starts[t] + nobs / npart + (t < nobs % npart ? 1 : 0);
+            }
+
+            const std::function<void(int)> task = [&](int worker)
+            {
+                const int t = worker + 1;
+
+                if (t >= npart)
+                {
+                    return;
+                }
+
+                Network* replica = replicas[worker].get();
+
+                for (int i = 0; i < nlayer; i++)
+                {
+                    replica->m_layers[i]->copy_parameters(*m_layers[i]);
+                }
+
+                x_parts[t] = x.middleCols(starts[t], starts[t + 1] - starts[t]);
+                y_parts[t] = y.middleCols(starts[t], starts[t + 1] - starts[t]);
+                replica->forward(x_parts[t]);
+                replica->backprop(x_parts[t], y_parts[t]);
+            };
+
+            workers.start(task);
+
+            try
+            {
+                x_parts[0] = x.middleCols(0, starts[1]);
+                y_parts[0] = y.middleCols(0, starts[1]);
+                this->forward(x_parts[0]);
+                this->backprop(x_parts[0], y_parts[0]);
+            } catch (...) {
+                // The workers still use the task and the parts
+                try
+                {
+                    workers.wait();
+                } catch (...) {
+                }
+
+                throw;
+            }
+
+            workers.wait();
+
+            // Each part contributes to the gradient in proportion to its number of observations
+            for (int i = 0; i < nlayer; i++)
+            {
+                Scalar weight = Scalar(starts[1]) / nobs;
+
+                for (int t = 1; t < npart; t++)
+                {
+                    m_layers[i]->combine_derivatives(weight, *replicas[t - 1]->m_layers[i],
+                                                     Scalar(starts[t + 1] - starts[t]) / nobs);
+                    weight = Scalar(1);
+                }
+            }
+
+            this->update(opt);
+        }
+
+        // Train on each mini-batch. With replicas, each mini-batch is split into parts that are
+        // trained on in parallel, one by this thread and one by the worker of each replica
+        template <typename XType, typename YType>
+        void train_batches(Optimizer& opt, ReplicaList& replicas, internal::WorkerGroup& workers,
+                           const std::vector<XType>& x_batches, const std::vector<YType>& y_batches)
+        {
+            const int nbatch = x_batches.size();
+
+            if (replicas.empty())
+            {
+                for (int i = 0; i < nbatch; i++)
+                {
+                    m_callback->m_batch_id = i;
+                    m_callback->pre_training_batch(this, x_batches[i], y_batches[i]);
+                    this->forward(x_batches[i]);
+                    this->backprop(x_batches[i], y_batches[i]);
+                    this->update(opt);
+                    m_callback->post_training_batch(this, x_batches[i], y_batches[i]);
+                }
+
+                return;
+            }
+
+            // Reused from one mini-batch to the next, so that parts of the same size are not reallocated
+            std::vector<XType> x_parts(replicas.size() + 1);
+            std::vector<YType> y_parts(replicas.size() + 1);
+
+            for (int i = 0; i < nbatch; i++)
+            {
+                m_callback->m_batch_id = i;
+                m_callback->pre_training_batch(this, x_batches[i], y_batches[i]);
+                train_parts(opt, replicas, workers, x_batches[i], y_batches[i], x_parts, y_parts);
+                m_callback->post_training_batch(this, x_batches[i], y_batches[i]);
+            }
+        }
+
         // Get the meta information of the network, used to export the NN model
         MetaInfo get_meta_info() const
         {
@@ -345,6 +488,27 @@ class Network
             }
         }
 
+        ///
+        /// Change the storage precision of the parameters of all the hidden layers
+        ///
+        /// This is meant for inference with a trained network. INT8_PRECISION stores each
+        /// weight in 8 bits, with a scale for each output unit or channel, and computes the
+        /// products in integers. FLOAT16_PRECISION stores each weight in 16 bits. A network
+        /// with reduced precision cannot be fitted until it is quantized back to FULL_PRECISION,
+        /// which does not recover the precision lost.
+        ///
+        /// \param precision The new precision of the parameters.
+        ///
+        void quantize(Precision precision)
+        {
+            const int nlayer = num_layers();
+
+            for (int i = 0; i < nlayer; i++)
+            {
+                m_layers[i]->quantize(precision);
+            }
+        }
+
         ///
         /// Get the serialized derivatives of layer parameters
         ///
@@ -427,11 +591,17 @@ class Network
         /// \param epoch      Number of epochs of training.
         /// \param seed       Set the random seed of the %RNG if `seed > 0`, otherwise
         ///                   use the current random state.
+        /// \param nthread    Number of threads that train on parts of each mini-batch.
+        ///                   The gradients of the parts are averaged before each update.
+        ///                   With more than one thread, all the layers must be of the
+        ///                   types that can be read from files, and the output layer
+        ///                   only sees the part of the mini-batch trained on in the
+        ///                   calling thread, as does its loss.
         ///
         template <typename DerivedX, typename DerivedY>
         bool fit(Optimizer& opt, const Eigen::MatrixBase<DerivedX>& x,
                  const Eigen::MatrixBase<DerivedY>& y,
-                 int batch_size, int epoch, int seed = -1)
+                 int batch_size, int epoch, int seed = -1, int nthread = 1)
         {
             // We do not directly use PlainObjectX since it may be row-majored if x is passed as mat.transpose()
             // We want to force XType and YType to be column-majored
@@ -465,20 +635,93 @@ class Network
             m_callback->m_nbatch = nbatch;
             m_callback->m_nepoch = epoch;
 
+            ReplicaList replicas;
+            create_replicas(std::min(nthread, batch_size) - 1, replicas);
+            internal::WorkerGroup workers(replicas.size());
+
             // Iterations on the whole data set
             for (int k = 0; k < epoch; k++)
             {
                 m_callback->m_epoch_id = k;
+                train_batches(opt, replicas, workers, x_batches, y_batches);
+            }
 
-                // Train on each mini-batch
-                for (int i = 0; i < nbatch; i++)
+            return true;
+        }
+
+        ///
+        /// Fit the model on data that are read in chunks from a data source
+        ///
+        /// Only one chunk and the one being read are held in memory, so the data
+        /// set can be larger than the available memory. The next chunk is read on
+        /// a background thread while the network is trained on the current one.
+        /// The callback sees the number of mini-batches of the current chunk in
+        /// `m_nbatch`.
+        ///
+        /// \param opt        An object that inherits from the Optimizer class, indicating the optimization algorithm to use.
+        /// \param source     An object that inherits from the DataSource class, which delivers the data.
+        /// \param batch_size Mini-batch size. Mini-batches are drawn from a single chunk.
+        /// \param epoch      Number of passes over the data source.
+        /// \param seed       Set the random seed of the %RNG if `seed > 0`, otherwise
+        ///                   use the current random state.
+        /// \param nthread    Number of threads that train on parts of each mini-batch,
+        ///                   as in the other fit() function.
+        ///
+        bool fit(Optimizer& opt, DataSource& source, int batch_size, int epoch, int seed = -1,
+                 int nthread = 1)
+        {
+            const int nlayer = num_layers();
+
+            if (nlayer <= 0)
+            {
+                return false;
+            }
+
+            // Reset optimizer
+            opt.reset();
+
+            if (seed > 0)
+            {
+                m_rng.seed(seed);
+            }
+
+            m_callback->m_nepoch = epoch;
+
+            ReplicaList replicas;
+            create_replicas(std::min(nthread, batch_size) - 1, replicas);
+            internal::WorkerGroup workers(replicas.size());
+
+            Matrix x_chunk, y_chunk, x_next, y_next;
+            std::vector<Matrix> x_batches;
+            std::vector<Matrix> y_batches;
+
+            // Passes over the data source
+            for (int k = 0; k < epoch; k++)
+            {
+                m_callback->m_epoch_id = k;
+                source.rewind();
+                bool has_chunk = source.read_chunk(x_chunk, y_chunk);
+
+                while (has_chunk)
                 {
-                    m_callback->m_batch_id = i;
-                    m_callback->pre_training_batch(this, x_batches[i], y_batches[i]);
-                    this->forward(x_batches[i]);
-                    this->backprop(x_batches[i], y_batches[i]);
-                    this->update(opt);
-                    m_callback->post_training_batch(this, x_batches[i], y_batches[i]);
+                    // Read the next chunk while this one is trained on
+                    std::future<bool> next_chunk = std::async(std::launch::async,
+                                                              [&source, &x_next, &y_next]()
+                    {
+                        return source.read_chunk(x_next, y_next);
+                    });
+
+                    if (x_chunk.cols() > 0)
+                    {
+                        const int nbatch = internal::create_shuffled_batches(x_chunk, y_chunk, batch_size, m_rng,
+                                           x_batches, y_batches);
+                        m_callback->m_nbatch = nbatch;
+                        train_batches(opt, replicas, workers, x_batches, y_batches);
+                    }
+
+                    has_chunk = next_chunk.get();
+                    x_chunk.swap(x_next);
+                    y_chunk.swap(y_next);
                 }
             }
 
@@ -2,6 +2,12 @@
 #define UTILS_CONVOLUTION_H_
 
 #include "../../Eigen/Core"
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
 #include "../Config.h"
 
 namespace MiniDNN
@@ -375,6 +381,400 @@ inline void convolve_full(
     }
 }
 
+// Convolution by im2col
+//
+// The patches of an image covered by the filters at all the positions are copied to the
+// rows of a matrix, in the order of the filter data, so the convolution of the image is a
+// single matrix product with the filters of all the input channels stacked
+inline void convolve_valid_im2col(
+    const ConvDims& dim,
+    const Scalar* src, const bool image_outer_loop, const int n_obs,
+    const Scalar* filter_data,
+    Scalar* dest)
+{
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Map<const Matrix> ConstMapMat;
+    typedef Eigen::Map<Matrix> MapMat;
+    const int channel_size = dim.channel_rows * dim.channel_cols;
+    const int img_stride = image_outer_loop ? (dim.img_rows * dim.img_cols) :
+                           channel_size;
+    const int channel_stride = image_outer_loop ? channel_size :
+                               (channel_size * n_obs);
+    const int filter_size = dim.filter_rows * dim.filter_cols;
+    const int patch_size = filter_size * dim.in_channels;
+    const int conv_size = dim.conv_rows * dim.conv_cols;
+    // One column per output channel
+    Matrix filters(patch_size, dim.out_channels);
+
+    for (int i = 0; i < dim.in_channels; i++)
+    {
+        filters.middleRows(i * filter_size, filter_size) =
+            ConstMapMat(filter_data + i * filter_size * dim.out_channels, filter_size,
+                        dim.out_channels);
+    }
+
+    // One row per position of the filters, in the order of the results
+    Matrix patches(conv_size, patch_size);
+    const std::size_t copy_bytes = sizeof(Scalar) * dim.conv_rows;
+
+    for (int k = 0; k < n_obs; k++, src += img_stride)
+    {
+        Scalar* writer = patches.data();
+
+        for (int i = 0; i < dim.in_channels; i++)
+        {
+            const Scalar* channel = src + i * channel_stride;
+
+            for (int c = 0; c < dim.filter_cols; c++)
+            {
+                for (int r = 0; r < dim.filter_rows; r++)
+                {
+                    const Scalar* reader = channel + c * dim.channel_rows + r;
+
+                    for (int j = 0; j < dim.conv_cols;
+                            j++, reader += dim.channel_rows, writer += dim.conv_rows)
+                    {
+                        std::memcpy(writer, reader, copy_bytes);
+                    }
+                }
+            }
+        }
+
+        // The results of the output channels of an image are its columns
+        MapMat res(dest + k * conv_size * dim.out_channels, conv_size, dim.out_channels);
+        res.noalias() = patches * filters;
+    }
+}
+
+// Convolution by Winograd's minimal filtering algorithm F(2x2, 3x3)
+// Algorithm is based on https://arxiv.org/abs/1509.09308
+//
+// The results are computed by 2x2 tiles from 4x4 tiles of the input. The filters and the
+// input tiles are transformed so that each of the 16 elements of a transformed tile is a
+// matrix product over the input channels, which takes 16 multiplications per tile instead
+// of 36. Only applies to 3x3 filters
+inline void convolve_valid_winograd(
+    const ConvDims& dim,
+    const Scalar* src, const bool image_outer_loop, const int n_obs,
+    const Scalar* filter_data,
+    Scalar* dest)
+{
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    const int channel_size = dim.channel_rows * dim.channel_cols;
+    const int img_stride = image_outer_loop ? (dim.img_rows * dim.img_cols) :
+                           channel_size;
+    const int channel_stride = image_outer_loop ? channel_size :
+                               (channel_size * n_obs);
+    const int conv_size = dim.conv_rows * dim.conv_cols;
+    // Tiles of the results, the last ones may be cut by the borders
+    const int tile_rows = (dim.conv_rows + 1) / 2;
+    const int tile_cols = (dim.conv_cols + 1) / 2;
+    const int img_tiles = tile_rows * tile_cols;
+    // Transformed filters G g G^T, element e of the output channel l and
+    // input channel i at u[e](l, i)
+    std::vector<Matrix> u(16, Matrix(dim.out_channels, dim.in_channels));
+
+    for (int i = 0; i < dim.in_channels; i++)
+    {
+        for (int l = 0; l < dim.out_channels; l++)
+        {
+            // Filters are stored by columns, g[c * 3 + r]
+            const Scalar* g = filter_data + (i * dim.out_channels + l) * 9;
+            Scalar t[4][3];
+
+            for (int c = 0; c < 3; c++)
+            {
+                t[0][c] = g[c * 3];
+                t[1][c] = (g[c * 3] + g[c * 3 + 1] + g[c * 3 + 2]) / 2;
+                t[2][c] = (g[c * 3] - g[c * 3 + 1] + g[c * 3 + 2]) / 2;
+                t[3][c] = g[c * 3 + 2];
+            }
+
+            for (int r = 0; r < 4; r++)
+            {
+                u[r * 4](l, i) = t[r][0];
+                u[r * 4 + 1](l, i) = (t[r][0] + t[r][1] + t[r][2]) / 2;
+                u[r * 4 + 2](l, i) = (t[r][0] - t[r][1] + t[r][2]) / 2;
+                u[r * 4 + 3](l, i) = t[r][2];
+            }
+        }
+    }
+
+    // Tiles are transformed by blocks, so the transformed tiles of a block stay in the cache.
+    // Tile t is the tile (t % tile_rows, t / tile_rows % tile_cols) of image t / img_tiles
+    const int ntile = n_obs * img_tiles;
+    const int block_size = std::min(ntile, 128);
+    std::vector<Matrix> v(16, Matrix(dim.in_channels, block_size));
+    std::vector<Matrix> m(16, Matrix(dim.out_channels, block_size));
+
+    for (int start = 0; start < ntile; start += block_size)
+    {
+        const int nblock = std::min(block_size, ntile - start);
+
+        // Transformed input tiles B^T d B, element e of the input channel i and
+        // tile start + b at v[e](i, b)
+        for (int b = 0; b < nblock; b++)
+        {
+            const int tile = start + b;
+            const int tr = tile % tile_rows;
+            const int tc = tile / tile_rows % tile_cols;
+            const Scalar* channel = src + (tile / img_tiles) * img_stride;
+            // Number of rows and columns of the input tile inside the channel
+            const int nrow = std::min(4, dim.channel_rows - tr * 2);
+            const int ncol = std::min(4, dim.channel_cols - tc * 2);
+
+            for (int i = 0; i < dim.in_channels; i++, channel += channel_stride)
+            {
+                // Input tile, with zeros beyond the borders
+                Scalar d[4][4] = { { 0 } };
+                const Scalar* reader = channel + tc * 2 * dim.channel_rows + tr * 2;
+
+                for (int c = 0; c < ncol; c++, reader += dim.channel_rows)
+                {
+                    for (int r = 0; r < nrow; r++)
+                    {
+                        d[r][c] = reader[r];
+                    }
+                }
+
+                Scalar t[4][4];
+
+                for (int c = 0; c < 4; c++)
+                {
+                    t[0][c] = d[0][c] - d[2][c];
+                    t[1][c] = d[1][c] + d[2][c];
+                    t[2][c] = d[2][c] - d[1][c];
+                    t[3][c] = d[1][c] - d[3][c];
+                }
+
+                for (int r = 0; r < 4; r++)
+                {
+                    v[r * 4](i, b) = t[r][0] - t[r][2];
+                    v[r * 4 + 1](i, b) = t[r][1] + t[r][2];
+                    v[r * 4 + 2](i, b) = t[r][2] - t[r][1];
+                    v[r * 4 + 3](i, b) = t[r][1] - t[r][3];
+                }
+            }
+        }
+
+        // Sum over the input channels
+        for (int e = 0; e < 16; e++)
+        {
+            m[e].leftCols(nblock).noalias() = u[e] * v[e].leftCols(nblock);
+        }
+
+        // Inverse transform A^T m A of the tiles of each output channel
+        for (int b = 0; b < nblock; b++)
+        {
+            const int tile = start + b;
+            const int tr = tile % tile_rows;
+            const int tc = tile / tile_rows % tile_cols;
+            Scalar* res = dest + (tile / img_tiles) * dim.out_channels * conv_size +
+                          tc * 2 * dim.conv_rows + tr * 2;
+            // Number of rows and columns of the result tile inside the result
+            const int nrow = std::min(2, dim.conv_rows - tr * 2);
+            const int ncol = std::min(2, dim.conv_cols - tc * 2);
+
+            for (int l = 0; l < dim.out_channels; l++, res += conv_size)
+            {
+                Scalar t[2][4];
+
+                for (int c = 0; c < 4; c++)
+                {
+                    t[0][c] = m[c](l, b) + m[4 + c](l, b) + m[8 + c](l, b);
+                    t[1][c] = m[4 + c](l, b) - m[8 + c](l, b) - m[12 + c](l, b);
+                }
+
+                for (int r = 0; r < nrow; r++)
+                {
+                    res[r] = t[r][0] + t[r][1] + t[r][2];
+
+                    if (ncol > 1)
+                    {
+                        res[dim.conv_rows + r] = t[r][1] - t[r][2] - t[r][3];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Whether an algorithm can compute the convolutions of the given dimensions
+inline bool conv_algorithm_applies(const ConvAlgorithm algorithm, const ConvDims& dim)
+{
+    switch (algorithm)
+    {
+        case CONV_MEC:
+        case CONV_IM2COL:
+            return true;
+        case CONV_WINOGRAD:
+            return dim.filter_rows == 3 && dim.filter_cols == 3;
+        default:
+            return false;
+    }
+}
+
+// Convolution using the "valid" rule with the given algorithm, which must apply
+inline void convolve_valid(
+    const ConvDims& dim, const ConvAlgorithm algorithm,
+    const Scalar* src, const bool image_outer_loop, const int n_obs,
+    const Scalar* filter_data,
+    Scalar* dest)
+{
+    switch (algorithm)
+    {
+        case CONV_IM2COL:
+            convolve_valid_im2col(dim, src, image_outer_loop, n_obs, filter_data, dest);
+            break;
+        case CONV_WINOGRAD:
+            convolve_valid_winograd(dim, src, image_outer_loop, n_obs, filter_data, dest);
+            break;
+        default:
+            convolve_valid(dim, src, image_outer_loop, n_obs, filter_data, dest);
+            break;
+    }
+}
+
+// Convolution using the "full" rule with the given algorithm, which must apply.
+// Except for MEC, the images are padded with zeros on all sides, and the convolution
+// of the padded images with the rotated filters uses the "valid" rule
+inline void convolve_full(
+    const ConvDims& dim, const ConvAlgorithm algorithm,
+    const Scalar* src, const int n_obs, const Scalar* filter_data,
+    Scalar* dest)
+{
+    typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+    typedef Eigen::Map<const Matrix> ConstMapMat;
+
+    if (algorithm != CONV_IM2COL && algorithm != CONV_WINOGRAD)
+    {
+        convolve_full(dim, src, n_obs, filter_data, dest);
+        return;
+    }
+
+    const int padding_top = dim.filter_rows - 1;
+    const int padding_left = dim.filter_cols - 1;
+    const int pad_rows = dim.channel_rows + padding_top * 2;
+    const int pad_cols = dim.channel_cols + padding_left * 2;
+    const int nchannel = dim.in_channels * n_obs;
+    const int channel_size = dim.channel_rows * dim.channel_cols;
+    Matrix pad_mat = Matrix::Zero(pad_rows, pad_cols * nchannel);
+
+    for (int i = 0; i < nchannel; i++, src += channel_size)
+    {
+        pad_mat.block(padding_top, i * pad_cols + padding_left, dim.channel_rows,
+                      dim.channel_cols) = ConstMapMat(src, dim.channel_rows, dim.channel_cols);
+    }
+
+    // As in the MEC version, the layout of input channels and output channels are
+    // switched, and each filter is reversed
+    const int filter_size = dim.filter_rows * dim.filter_cols;
+    std::vector<Scalar> filters(filter_size * dim.in_channels * dim.out_channels);
+
+    for (int i = 0; i < dim.in_channels; i++)
+    {
+        for (int l = 0; l < dim.out_channels; l++)
+        {
+            const Scalar* reader = filter_data + (l * dim.in_channels + i) * filter_size;
+            std::reverse_copy(reader, reader + filter_size,
+                              filters.begin() + (i * dim.out_channels + l) * filter_size);
+        }
+    }
+
+    ConvDims pad_dim(dim.in_channels, dim.out_channels, pad_rows, pad_cols,
+                     dim.filter_rows, dim.filter_cols);
+    convolve_valid(pad_dim, algorithm, pad_mat.data(), true, n_obs, &filters[0], dest);
+}
+
+// Chooses the algorithm of the convolutions made at one place of a layer. The first
+// convolution of each shape runs every algorithm that applies, on the actual data, and
+// the fastest one is kept for the later convolutions of that shape
+class ConvTuner
+{
+    private:
+        typedef std::vector<int> Shape;  // Dimensions and number of observations
+
+        ConvAlgorithm m_requested;                 // Algorithm set by the user, or CONV_AUTO
+        std::map<Shape, ConvAlgorithm> m_fastest;  // Fastest algorithm of each shape
+
+        static Shape shape(const ConvDims& dim, const int n_obs)
+        {
+            const int values[] = { dim.in_channels, dim.out_channels, dim.channel_rows,
+                                   dim.channel_cols, dim.filter_rows, dim.filter_cols, n_obs
+                                 };
+            return Shape(values, values + sizeof(values) / sizeof(values[0]));
+        }
+
+    public:
+        ConvTuner() :
+            m_requested(CONV_AUTO)
+        {}
+
+        void set_algorithm(const ConvAlgorithm algorithm)
+        {
+            m_requested = algorithm;
+            m_fastest.clear();
+        }
+
+        // Algorithm used for the given shape, CONV_AUTO before it is measured
+        ConvAlgorithm algorithm(const ConvDims& dim, const int n_obs) const
+        {
+            if (m_requested != CONV_AUTO && conv_algorithm_applies(m_requested, dim))
+            {
+                return m_requested;
+            }
+
+            std::map<Shape, ConvAlgorithm>::const_iterator it = m_fastest.find(shape(dim, n_obs));
+            return it == m_fastest.end() ? CONV_AUTO : it->second;
+        }
+
+        // Make the convolution by calling 'convolve' with an algorithm. A requested
+        // algorithm that does not apply to 'dim' is replaced by the fastest one
+        template <typename Convolve>
+        void run(const ConvDims& dim, const int n_obs, Convolve convolve)
+        {
+            const ConvAlgorithm chosen = algorithm(dim, n_obs);
+
+            if (chosen != CONV_AUTO)
+            {
+                convolve(chosen);
+                return;
+            }
+
+            // Twice, since the first run of each algorithm also warms the caches up.
+            // Every run writes the same results
+            ConvAlgorithm fastest = CONV_MEC;
+            double fastest_time = std::numeric_limits<double>::max();
+
+            for (int run = 0; run < 2; run++)
+            {
+                for (int a = CONV_MEC; a <= CONV_WINOGRAD; a++)
+                {
+                    const ConvAlgorithm candidate = static_cast<ConvAlgorithm>(a);
+
+                    if (!conv_algorithm_applies(candidate, dim))
+                    {
+                        continue;
+                    }
+
+                    const std::chrono::steady_clock::time_point start =
+                        std::chrono::steady_clock::now();
+                    convolve(candidate);
+                    const double time = std::chrono::duration<double>(
+                                            std::chrono::steady_clock::now() - start).count();
+
+                    if (time < fastest_time)
+                    {
+                        fastest = candidate;
+                        fastest_time = time;
+                    }
+                }
+            }
+
+            m_fastest[shape(dim, n_obs)] = fastest;
+        }
+};
+
 
 } // namespace internal
 
@@ -78,9 +78,9 @@ inline int output_id(const std::string& type)
 {
     if (type == "RegressionMSE")
         return REGRESSION_MSE;
-    if (type == "MultiClassEntropy")
-        return BINARY_CLASS_ENTROPY;
     if (type == "BinaryClassEntropy")
+        return BINARY_CLASS_ENTROPY;
+    if (type == "MultiClassEntropy")
         return MULTI_CLASS_ENTROPY;
 
     throw std::invalid_argument("[function output_id]: Output is not of a known type");
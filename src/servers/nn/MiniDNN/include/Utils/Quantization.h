@@ -0,0 +1,644 @@
+#ifndef UTILS_QUANTIZATION_H_
+#define UTILS_QUANTIZATION_H_
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+#include "../Config.h"
+
+// The SIMD kernels are compiled with target attributes and picked at run time,
+// so that they are used without building the whole server with -mavx2 or -mf16c.
+// Other targets and compilers get the portable kernels only.
+#if defined(__GNUC__) && (__GNUC__ >= 5) && (defined(__x86_64__) || defined(__i386__))
+#define MINIDNN_QUANTIZATION_X86
+#include <immintrin.h>
+#endif
+
+namespace MiniDNN
+{
+
+namespace internal
+{
+
+
+// Quantized rows are padded with zeros to a multiple of these numbers of
+// elements, so that the kernels below never need a remainder loop
+const int INT8_ALIGNMENT = 32;
+const int HALF_ALIGNMENT = 8;
+
+inline int padded_size(const int n, const int alignment)
+{
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+// Round a single precision number to the nearest half precision number
+inline uint16_t float_to_half(const float x)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    const uint16_t sign = (bits >> 16) & 0x8000;
+    const uint32_t abs = bits & 0x7fffffff;
+
+    // Infinity and NaN
+    if (abs >= 0x7f800000)
+        return sign | 0x7c00 | (abs > 0x7f800000 ? 0x200 : 0);
+
+    // Rounds to infinity, 65520 and above
+    if (abs >= 0x477ff000)
+        return sign | 0x7c00;
+
+    // Subnormal half precision numbers, below 2^-14
+    if (abs < 0x38800000)
+    {
+        // Below 2^-25, which rounds to zero
+        if (abs < 0x33000000)
+            return sign;
+
+        const uint32_t exponent = abs >> 23;
+        const uint32_t mantissa = (abs & 0x7fffff) | 0x800000;
+        const uint32_t shift = 126 - exponent;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t half = 1u << (shift - 1);
+        uint32_t res = mantissa >> shift;
+
+        if (remainder > half || (remainder == half && (res & 1)))
+            res++;
+
+        return sign | res;
+    }
+
+    // Normal numbers: rebias the exponent and round the mantissa to nearest even
+    const uint32_t remainder = abs & 0x1fff;
+    uint32_t res = (abs - 0x38000000) >> 13;
+
+    if (remainder > 0x1000 || (remainder == 0x1000 && (res & 1)))
+        res++;
+
+    return sign | res;
+}
+
+// Exact conversion of a half precision number to single precision
+inline float half_to_float(const uint16_t h)
+{
+    const uint32_t sign = uint32_t(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1f;
+    uint32_t mantissa = h & 0x3ff;
+    uint32_t bits;
+
+    if (exponent == 0x1f)
+    {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else if (exponent == 0) {
+        if (mantissa == 0)
+        {
+            bits = sign;
+        } else {
+            // Normalize the subnormal number
+            exponent = 113;
+
+            while (!(mantissa & 0x400))
+            {
+                mantissa <<= 1;
+                exponent--;
+            }
+
+            bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+        }
+    } else {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+
+    float res;
+    std::memcpy(&res, &bits, sizeof(res));
+    return res;
+}
+
+// Symmetric linear quantization of 'n' values to [-127, 127], so that
+// src[i] ~= scale * dest[i]. Returns the scale, which is zero if all the values are zero
+inline float quantize_int8(const Scalar* src, const int n, int8_t* dest)
+{
+    Scalar max_abs = Scalar(0);
+
+    for (int i = 0; i < n; i++)
+    {
+        max_abs = std::max(max_abs, std::abs(src[i]));
+    }
+
+    if (max_abs == Scalar(0))
+    {
+        std::memset(dest, 0, n);
+        return 0.0f;
+    }
+
+    const Scalar inv_scale = Scalar(127) / max_abs;
+
+    for (int i = 0; i < n; i++)
+    {
+        // Rounded to nearest, and never outside [-127, 127] since |src[i]| <= max_abs
+        const Scalar value = src[i] * inv_scale;
+        dest[i] = static_cast<int8_t>(value + (value < Scalar(0) ? Scalar(-0.5) : Scalar(0.5)));
+    }
+
+    return static_cast<float>(max_abs / Scalar(127));
+}
+
+// Portable version of gemv_int8()
+inline void gemv_int8_portable(const int8_t* w, const int rows, const int stride, const int8_t* x,
+                               int32_t* y)
+{
+    for (int i = 0; i < rows; i++)
+    {
+        const int8_t* wi = w + i * stride;
+        int32_t acc = 0;
+
+        for (int k = 0; k < stride; k++)
+        {
+            acc += int32_t(wi[k]) * int32_t(x[k]);
+        }
+
+        y[i] = acc;
+    }
+}
+
+#ifdef MINIDNN_QUANTIZATION_X86
+__attribute__((target("avx2")))
+inline int32_t horizontal_sum_avx2(const __m256i v)
+{
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+// Product of |x| and sign(x) * w, which is x * w, accumulated in 32 bits.
+// _mm256_maddubs_epi16() cannot saturate since both factors are within [-127, 127]
+__attribute__((target("avx2")))
+inline __m256i dot_int8_step_avx2(const __m256i acc, const __m256i abs_x, const __m256i x,
+                                  const int8_t* w)
+{
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i signed_w = _mm256_sign_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(w)), x);
+    return _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(abs_x, signed_w), ones));
+}
+
+// AVX2 version of gemv_int8()
+__attribute__((target("avx2")))
+inline void gemv_int8_avx2(const int8_t* w, const int rows, const int stride, const int8_t* x,
+                           int32_t* y)
+{
+    int i = 0;
+
+    // Four rows at a time share the loads and absolute values of x
+    for (; i + 4 <= rows; i += 4)
+    {
+        const int8_t* w0 = w + i * stride;
+        const int8_t* w1 = w0 + stride;
+        const int8_t* w2 = w1 + stride;
+        const int8_t* w3 = w2 + stride;
+        __m256i acc0 = _mm256_setzero_si256();
+        __m256i acc1 = _mm256_setzero_si256();
+        __m256i acc2 = _mm256_setzero_si256();
+        __m256i acc3 = _mm256_setzero_si256();
+
+        for (int k = 0; k < stride; k += 32)
+        {
+            const __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + k));
+            const __m256i abs_x = _mm256_sign_epi8(xv, xv);
+            acc0 = dot_int8_step_avx2(acc0, abs_x, xv, w0 + k);
+            acc1 = dot_int8_step_avx2(acc1, abs_x, xv, w1 + k);
+            acc2 = dot_int8_step_avx2(acc2, abs_x, xv, w2 + k);
+            acc3 = dot_int8_step_avx2(acc3, abs_x, xv, w3 + k);
+        }
+
+        y[i] = horizontal_sum_avx2(acc0);
+        y[i + 1] = horizontal_sum_avx2(acc1);
+        y[i + 2] = horizontal_sum_avx2(acc2);
+        y[i + 3] = horizontal_sum_avx2(acc3);
+    }
+
+    for (; i < rows; i++)
+    {
+        const int8_t* wi = w + i * stride;
+        __m256i acc = _mm256_setzero_si256();
+
+        for (int k = 0; k < stride; k += 32)
+        {
+            const __m256i xv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + k));
+            acc = dot_int8_step_avx2(acc, _mm256_sign_epi8(xv, xv), xv, wi + k);
+        }
+
+        y[i] = horizontal_sum_avx2(acc);
+    }
+}
+
+__attribute__((target("ssse3")))
+inline int32_t horizontal_sum_ssse3(const __m128i v)
+{
+    __m128i sum = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+__attribute__((target("ssse3")))
+inline __m128i dot_int8_step_ssse3(const __m128i acc, const __m128i abs_x, const __m128i x,
+                                   const int8_t* w)
+{
+    const __m128i ones = _mm_set1_epi16(1);
+    const __m128i signed_w = _mm_sign_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w)), x);
+    return _mm_add_epi32(acc, _mm_madd_epi16(_mm_maddubs_epi16(abs_x, signed_w), ones));
+}
+
+// SSSE3 version of gemv_int8()
+__attribute__((target("ssse3")))
+inline void gemv_int8_ssse3(const int8_t* w, const int rows, const int stride, const int8_t* x,
+                            int32_t* y)
+{
+    int i = 0;
+
+    for (; i + 4 <= rows; i += 4)
+    {
+        const int8_t* w0 = w + i * stride;
+        const int8_t* w1 = w0 + stride;
+        const int8_t* w2 = w1 + stride;
+        const int8_t* w3 = w2 + stride;
+        __m128i acc0 = _mm_setzero_si128();
+        __m128i acc1 = _mm_setzero_si128();
+        __m128i acc2 = _mm_setzero_si128();
+        __m128i acc3 = _mm_setzero_si128();
+
+        for (int k = 0; k < stride; k += 16)
+        {
+            const __m128i xv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + k));
+            const __m128i abs_x = _mm_sign_epi8(xv, xv);
+            acc0 = dot_int8_step_ssse3(acc0, abs_x, xv, w0 + k);
+            acc1 = dot_int8_step_ssse3(acc1, abs_x, xv, w1 + k);
+            acc2 = dot_int8_step_ssse3(acc2, abs_x, xv, w2 + k);
+            acc3 = dot_int8_step_ssse3(acc3, abs_x, xv, w3 + k);
+        }
+
+        y[i] = horizontal_sum_ssse3(acc0);
+        y[i + 1] = horizontal_sum_ssse3(acc1);
+        y[i + 2] = horizontal_sum_ssse3(acc2);
+        y[i + 3] = horizontal_sum_ssse3(acc3);
+    }
+
+    for (; i < rows; i++)
+    {
+        const int8_t* wi = w + i * stride;
+        __m128i acc = _mm_setzero_si128();
+
+        for (int k = 0; k < stride; k += 16)
+        {
+            const __m128i xv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + k));
+            acc = dot_int8_step_ssse3(acc, _mm_sign_epi8(xv, xv), xv, wi + k);
+        }
+
+        y[i] = horizontal_sum_ssse3(acc);
+    }
+}
+#endif
+
+typedef void (*GemvInt8Kernel)(const int8_t*, const int, const int, const int8_t*, int32_t*);
+
+// Fastest version of gemv_int8() for this processor
+inline GemvInt8Kernel select_gemv_int8()
+{
+#ifdef MINIDNN_QUANTIZATION_X86
+    if (__builtin_cpu_supports("avx2"))
+        return gemv_int8_avx2;
+
+    if (__builtin_cpu_supports("ssse3"))
+        return gemv_int8_ssse3;
+#endif
+
+    return gemv_int8_portable;
+}
+
+// y = W * x, where W has 'rows' rows of 'stride' int8 values, 'stride' being a multiple of INT8_ALIGNMENT
+inline void gemv_int8(const int8_t* w, const int rows, const int stride, const int8_t* x,
+                      int32_t* y)
+{
+    // The processor is queried only once
+    static const GemvInt8Kernel kernel = select_gemv_int8();
+    kernel(w, rows, stride, x, y);
+}
+
+// Single precision value of each of the 65536 half precision numbers
+inline std::vector<float> make_half_table()
+{
+    std::vector<float> table(0x10000);
+
+    for (int h = 0; h < 0x10000; h++)
+    {
+        table[h] = half_to_float(static_cast<uint16_t>(h));
+    }
+
+    return table;
+}
+
+inline const float* half_table()
+{
+    static const std::vector<float> table = make_half_table();
+    return &table[0];
+}
+
+// Portable version of gemv_half(). The conversions are looked up in a table of all the half precision values
+inline void gemv_half_portable(const uint16_t* w, const int rows, const int stride, const float* x,
+                               float* y)
+{
+    const float* table = half_table();
+
+    for (int i = 0; i < rows; i++)
+    {
+        const uint16_t* wi = w + i * stride;
+        float acc = 0.0f;
+
+        for (int k = 0; k < stride; k++)
+        {
+            acc += table[wi[k]] * x[k];
+        }
+
+        y[i] = acc;
+    }
+}
+
+#ifdef MINIDNN_QUANTIZATION_X86
+__attribute__((target("avx,f16c,fma")))
+inline float horizontal_sum_f16c(const __m256 v)
+{
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+}
+
+__attribute__((target("avx,f16c,fma")))
+inline __m256 dot_half_step_f16c(const __m256 acc, const __m256 x, const uint16_t* w)
+{
+    const __m256 wv = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w)));
+    return _mm256_fmadd_ps(wv, x, acc);
+}
+
+// F16C/FMA version of gemv_half()
+__attribute__((target("avx,f16c,fma")))
+inline void gemv_half_f16c(const uint16_t* w, const int rows, const int stride, const float* x,
+                           float* y)
+{
+    int i = 0;
+
+    for (; i + 4 <= rows; i += 4)
+    {
+        const uint16_t* w0 = w + i * stride;
+        const uint16_t* w1 = w0 + stride;
+        const uint16_t* w2 = w1 + stride;
+        const uint16_t* w3 = w2 + stride;
+        __m256 acc0 = _mm256_setzero_ps();
+        __m256 acc1 = _mm256_setzero_ps();
+        __m256 acc2 = _mm256_setzero_ps();
+        __m256 acc3 = _mm256_setzero_ps();
+
+        for (int k = 0; k < stride; k += 8)
+        {
+            const __m256 xv = _mm256_loadu_ps(x + k);
+            acc0 = dot_half_step_f16c(acc0, xv, w0 + k);
+            acc1 = dot_half_step_f16c(acc1, xv, w1 + k);
+            acc2 = dot_half_step_f16c(acc2, xv, w2 + k);
+            acc3 = dot_half_step_f16c(acc3, xv, w3 + k);
+        }
+
+        y[i] = horizontal_sum_f16c(acc0);
+        y[i + 1] = horizontal_sum_f16c(acc1);
+        y[i + 2] = horizontal_sum_f16c(acc2);
+        y[i + 3] = horizontal_sum_f16c(acc3);
+    }
+
+    for (; i < rows; i++)
+    {
+        const uint16_t* wi = w + i * stride;
+        __m256 acc = _mm256_setzero_ps();
+
+        for (int k = 0; k < stride; k += 8)
+        {
+            acc = dot_half_step_f16c(acc, _mm256_loadu_ps(x + k), wi + k);
+        }
+
+        y[i] = horizontal_sum_f16c(acc);
+    }
+}
+#endif
+
+typedef void (*GemvHalfKernel)(const uint16_t*, const int, const int, const float*, float*);
+
+// Fastest version of gemv_half() for this processor
+inline GemvHalfKernel select_gemv_half()
+{
+#ifdef MINIDNN_QUANTIZATION_X86
+    if (__builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c") && __builtin_cpu_supports("fma"))
+        return gemv_half_f16c;
+#endif
+
+    return gemv_half_portable;
+}
+
+// y = W * x, where W has 'rows' rows of 'stride' half precision values, 'stride' being a multiple of HALF_ALIGNMENT
+inline void gemv_half(const uint16_t* w, const int rows, const int stride, const float* x,
+                      float* y)
+{
+    // The processor is queried only once
+    static const GemvHalfKernel kernel = select_gemv_half();
+    kernel(w, rows, stride, x, y);
+}
+
+
+///
+/// A matrix stored in reduced precision, used by the hidden layers after post-training quantization.
+/// Each row holds the weights of one output unit, or of one output channel, and is padded with zeros.
+///
+/// With INT8_PRECISION, each row is quantized with its own scale, and the vectors multiplied
+/// by the matrix are quantized on the fly, so that products are computed in integers.
+/// With FLOAT16_PRECISION, rows are stored as half precision numbers and products are computed
+/// in single precision.
+///
+class QuantizedMatrix
+{
+    private:
+        Precision m_precision;
+        int m_rows;
+        int m_cols;
+        int m_stride;
+
+        std::vector<int8_t>   m_int8;    // INT8_PRECISION rows
+        std::vector<float>    m_scales;  // Scale of each INT8_PRECISION row
+        std::vector<uint16_t> m_half;    // FLOAT16_PRECISION rows
+
+        // Workspace of multiply()
+        std::vector<int8_t>   m_int8_x;
+        std::vector<int32_t>  m_int32_y;
+        std::vector<float>    m_float_x;
+        std::vector<float>    m_float_y;
+
+    public:
+        QuantizedMatrix() :
+            m_precision(FULL_PRECISION), m_rows(0), m_cols(0), m_stride(0)
+        {}
+
+        Precision precision() const
+        {
+            return m_precision;
+        }
+
+        int rows() const
+        {
+            return m_rows;
+        }
+
+        int cols() const
+        {
+            return m_cols;
+        }
+
+        ///
+        /// Number of values the vectors given to multiply_int8() and multiply_float() are padded to.
+        ///
+        int stride() const
+        {
+            return m_stride;
+        }
+
+        ///
+        /// Number of bytes taken by the stored rows and scales.
+        ///
+        std::size_t memory_size() const
+        {
+            return m_int8.size() * sizeof(int8_t) + m_scales.size() * sizeof(float) +
+                   m_half.size() * sizeof(uint16_t);
+        }
+
+        void clear()
+        {
+            m_precision = FULL_PRECISION;
+            m_rows = m_cols = m_stride = 0;
+            std::vector<int8_t>().swap(m_int8);
+            std::vector<float>().swap(m_scales);
+            std::vector<uint16_t>().swap(m_half);
+        }
+
+        ///
+        /// Store a matrix in reduced precision.
+        ///
+        /// \param precision INT8_PRECISION or FLOAT16_PRECISION.
+        /// \param data      The matrix, with `rows` rows of `cols` values stored one after the other.
+        ///
+        void compress(Precision precision, const Scalar* data, const int rows, const int cols)
+        {
+            clear();
+            m_precision = precision;
+            m_rows = rows;
+            m_cols = cols;
+
+            if (precision == INT8_PRECISION)
+            {
+                m_stride = padded_size(cols, INT8_ALIGNMENT);
+                m_int8.assign(std::size_t(rows) * m_stride, 0);
+                m_scales.resize(rows);
+
+                for (int i = 0; i < rows; i++)
+                {
+                    m_scales[i] = quantize_int8(data + std::size_t(i) * cols, cols,
+                                                &m_int8[std::size_t(i) * m_stride]);
+                }
+
+                m_int8_x.assign(m_stride, 0);
+                m_int32_y.resize(rows);
+            } else {
+                m_stride = padded_size(cols, HALF_ALIGNMENT);
+                m_half.assign(std::size_t(rows) * m_stride, 0);
+
+                for (int i = 0; i < rows; i++)
+                {
+                    for (int j = 0; j < cols; j++)
+                    {
+                        m_half[std::size_t(i) * m_stride + j] =
+                            float_to_half(static_cast<float>(data[std::size_t(i) * cols + j]));
+                    }
+                }
+
+                m_float_x.assign(m_stride, 0.0f);
+                m_float_y.resize(rows);
+            }
+        }
+
+        ///
+        /// Recover the matrix, with `rows()` rows of `cols()` values stored one after the other.
+        ///
+        void decompress(Scalar* data) const
+        {
+            for (int i = 0; i < m_rows; i++)
+            {
+                for (int j = 0; j < m_cols; j++)
+                {
+                    const std::size_t k = std::size_t(i) * m_stride + j;
+                    data[std::size_t(i) * m_cols + j] = (m_precision == INT8_PRECISION) ?
+                                                        Scalar(m_scales[i]) * Scalar(m_int8[k]) :
+                                                        Scalar(half_to_float(m_half[k]));
+                }
+            }
+        }
+
+        ///
+        /// Compute y = W * x, where x has `cols()` values and y has `rows()` values.
+        ///
+        void multiply(const Scalar* x, Scalar* y)
+        {
+            if (m_precision == INT8_PRECISION)
+            {
+                const float x_scale = quantize_int8(x, m_cols, &m_int8_x[0]);
+                multiply_int8(&m_int8_x[0], x_scale, y);
+            } else {
+                for (int j = 0; j < m_cols; j++)
+                {
+                    m_float_x[j] = static_cast<float>(x[j]);
+                }
+
+                multiply_float(&m_float_x[0], y);
+            }
+        }
+
+        ///
+        /// Compute y = W * (x_scale * x) for an INT8_PRECISION matrix, where x has `stride()` values,
+        /// the ones after `cols()` being zero.
+        ///
+        void multiply_int8(const int8_t* x, const float x_scale, Scalar* y)
+        {
+            gemv_int8(&m_int8[0], m_rows, m_stride, x, &m_int32_y[0]);
+
+            for (int i = 0; i < m_rows; i++)
+            {
+                y[i] = Scalar(m_int32_y[i]) * Scalar(x_scale * m_scales[i]);
+            }
+        }
+
+        ///
+        /// Compute y = W * x for a FLOAT16_PRECISION matrix, where x has `stride()` values,
+        /// the ones after `cols()` being zero.
+        ///
+        void multiply_float(const float* x, Scalar* y)
+        {
+            gemv_half(&m_half[0], m_rows, m_stride, x, &m_float_y[0]);
+
+            for (int i = 0; i < m_rows; i++)
+            {
+                y[i] = Scalar(m_float_y[i]);
+            }
+        }
+};
+
+
+} // namespace internal
+
+} // namespace MiniDNN
+
+
+#endif /* UTILS_QUANTIZATION_H_ */
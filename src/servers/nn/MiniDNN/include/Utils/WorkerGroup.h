@@ -0,0 +1,155 @@
+#ifndef UTILS_WORKERGROUP_H_
+#define UTILS_WORKERGROUP_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+namespace MiniDNN
+{
+
+namespace internal
+{
+
+
+///
+/// A fixed number of threads that run the same task, each with its own index,
+/// every time they are started. The threads live as long as the group, so that
+/// tasks as short as a part of a mini-batch do not pay for creating threads.
+///
+class WorkerGroup
+{
+    private:
+        typedef std::function<void(int)> Task;
+
+        std::vector<std::thread> m_threads;
+        std::mutex               m_lock;
+        std::condition_variable  m_started;    // Signaled when a task is started, or on destruction
+        std::condition_variable  m_finished;   // Signaled when the last worker is done with the task
+        const Task*              m_task;       // The task of the current round
+        unsigned long            m_round;      // Number of rounds started
+        int                      m_pending;    // Workers not done with the current round
+        bool                     m_quit;
+        std::exception_ptr       m_error;      // First exception thrown by the task in this round
+
+        void work(const int id)
+        {
+            unsigned long round = 0;
+
+            for (;;)
+            {
+                const Task* task;
+
+                {
+                    std::unique_lock<std::mutex> lock(m_lock);
+                    m_started.wait(lock, [this, round]() { return m_quit || m_round != round; });
+
+                    if (m_quit)
+                    {
+                        return;
+                    }
+
+                    round = m_round;
+                    task = m_task;
+                }
+
+                std::exception_ptr error;
+
+                try
+                {
+                    (*task)(id);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(m_lock);
+
+                if (error && !m_error)
+                {
+                    m_error = error;
+                }
+
+                if (--m_pending == 0)
+                {
+                    m_finished.notify_one();
+                }
+            }
+        }
+
+    public:
+        ///
+        /// Start `nworker` threads, which wait for tasks.
+        ///
+        explicit WorkerGroup(const int nworker) :
+            m_task(NULL), m_round(0), m_pending(0), m_quit(false)
+        {
+            for (int i = 0; i < nworker; i++)
+            {
+                m_threads.push_back(std::thread(&WorkerGroup::work, this, i));
+            }
+        }
+
+        ~WorkerGroup()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_quit = true;
+            }
+
+            m_started.notify_all();
+
+            for (std::size_t i = 0; i < m_threads.size(); i++)
+            {
+                m_threads[i].join();
+            }
+        }
+
+        int size() const
+        {
+            return m_threads.size();
+        }
+
+        ///
+        /// Run `task(i)` in the i-th worker, for all the workers, and return without
+        /// waiting for them. `task` must stay valid until wait() returns.
+        ///
+        void start(const Task& task)
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                m_task = &task;
+                m_pending = m_threads.size();
+                m_round++;
+            }
+
+            m_started.notify_all();
+        }
+
+        ///
+        /// Wait until all the workers are done with the task given to start().
+        /// If the task threw an exception in any of them, it is thrown again here.
+        ///
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_finished.wait(lock, [this]() { return m_pending == 0; });
+
+            if (m_error)
+            {
+                std::exception_ptr error = m_error;
+                m_error = std::exception_ptr();
+                std::rethrow_exception(error);
+            }
+        }
+};
+
+
+} // namespace internal
+
+} // namespace MiniDNN
+
+
+#endif /* UTILS_WORKERGROUP_H_ */
@@ -0,0 +1,944 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+#include "RequestScheduler.h"
+
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <Autolock.h>
+
+#include "data_set/data_set.h"
+#include "neural_network/compiled_neural_network.h"
+#include "neural_network/neural_network.h"
+#include "performance_functional/performance_functional.h"
+#include "training_strategy/training_strategy.h"
+
+
+//#define TRACE_REQUEST_SCHEDULER
+#ifdef TRACE_REQUEST_SCHEDULER
+#	define TRACE(x) debug_printf x
+#else
+#	define TRACE(x) ;
+#endif
+
+
+// A client which does not read its reply port must not stall the server.
+static const bigtime_t kReplyTimeout = 100000;
+
+
+struct RequestScheduler::ClonedArea : public BReferenceable {
+	ClonedArea(area_id area, uint8* address, size_t size)
+		:
+		area(area),
+		address(address),
+		size(size)
+	{
+	}
+
+	virtual ~ClonedArea()
+	{
+		delete_area(area);
+	}
+
+	area_id					area;
+	uint8*					address;
+	size_t					size;
+};
+
+
+struct RequestScheduler::InferenceJob
+	: public DoublyLinkedListLinkImpl<InferenceJob> {
+	nn_infer_request		request;
+	BReference<ClonedArea>	area;
+	const double*			inputs;
+	double*					outputs;
+	bigtime_t				time;
+};
+
+
+struct RequestScheduler::Model : public BReferenceable {
+	Model()
+		:
+		id(-1),
+		inputsNumber(0),
+		outputsNumber(0),
+		lock("nn model"),
+		compiled(NULL),
+		busy(false),
+		pendingRows(0)
+	{
+	}
+
+	virtual ~Model()
+	{
+		delete compiled;
+	}
+
+	int32							id;
+	uint32							inputsNumber;
+	uint32							outputsNumber;
+
+	OpenNN::NeuralNetwork			network;
+
+	// Guards compiled, which a training thread replaces when it is done.
+	BLocker							lock;
+	OpenNN::CompiledNeuralNetwork*	compiled;
+
+	// Guarded by the scheduler lock. The network is busy while it is being
+	// trained or saved.
+	bool							busy;
+	InferenceJobList				pending;
+	uint32							pendingRows;
+};
+
+
+// A request executed by a worker thread: NN_LOAD_MODEL, NN_SAVE_MODEL or
+// NN_TRAIN.
+struct RequestScheduler::WorkerJob {
+	RequestScheduler*		scheduler;
+	int32					code;
+	nn_request				request;
+	BReference<Model>		model;
+	BReference<ClonedArea>	area;
+	double*					data;
+};
+
+
+RequestScheduler::RequestScheduler()
+	:
+	fLock("nn request scheduler"),
+	fNextModelID(1),
+	fMaxBatchRows(1),
+	fMaxLatency(0),
+	fRequestSem(-1),
+	fScheduler(-1),
+	fTerminating(false)
+{
+}
+
+
+RequestScheduler::~RequestScheduler()
+{
+	Shutdown();
+
+	for (ModelMap::iterator it = fModels.begin(); it != fModels.end(); it++) {
+		Model* model = it->second;
+		while (InferenceJob* job = model->pending.RemoveHead())
+			delete job;
+		model->ReleaseReference();
+	}
+
+	for (AreaMap::iterator it = fAreas.begin(); it != fAreas.end(); it++)
+		it->second->ReleaseReference();
+}
+
+
+status_t
+RequestScheduler::Init(uint32 maxBatchRows, bigtime_t maxLatency)
+{
+	fMaxBatchRows = maxBatchRows > 0 ? maxBatchRows : 1;
+	fMaxLatency = maxLatency > 0 ? maxLatency : 0;
+
+	fRequestSem = create_sem(0, "nn requests");
+	if (fRequestSem < 0)
+		return fRequestSem;
+
+	fScheduler = spawn_thread(_SchedulerEntry, "nn request scheduler",
+		B_NORMAL_PRIORITY, this);
+	if (fScheduler < 0)
+		return fScheduler;
+
+	resume_thread(fScheduler);
+	return B_OK;
+}
+
+
+void
+RequestScheduler::Shutdown()
+{
+	if (fScheduler < 0)
+		return;
+
+	fLock.Lock();
+	fTerminating = true;
+	std::vector<thread_id> workers;
+	workers.swap(fWorkers);
+	fFinishedWorkers.clear();
+	fLock.Unlock();
+
+	delete_sem(fRequestSem);
+	fRequestSem = -1;
+
+	status_t result;
+	wait_for_thread(fScheduler, &result);
+	fScheduler = -1;
+
+	// The workers use the models and the scheduler lock until they are done,
+	// so a training still running delays the shutdown until it is over.
+	for (size_t i = 0; i < workers.size(); i++)
+		wait_for_thread(workers[i], &result);
+}
+
+
+void
+RequestScheduler::HandleRequest(int32 code, const nn_request& request,
+	ssize_t size, team_id sender)
+{
+	ssize_t expectedSize;
+	switch (code) {
+		case NN_LOAD_MODEL:
+		case NN_UNLOAD_MODEL:
+		case NN_SAVE_MODEL:
+			expectedSize = sizeof(nn_model_request);
+			break;
+		case NN_INFER:
+			expectedSize = sizeof(nn_infer_request);
+			break;
+		case NN_TRAIN:
+			expectedSize = sizeof(nn_train_request);
+			break;
+		case NN_RELEASE_AREA:
+			expectedSize = sizeof(nn_area_request);
+			break;
+		default:
+			debug_printf("nn: unknown request %" B_PRId32 "\n", code);
+			return;
+	}
+
+	if (size != expectedSize) {
+		debug_printf("nn: request %" B_PRId32 " has size %" B_PRIdSSIZE
+			" instead of %" B_PRIdSSIZE "\n", code, size, expectedSize);
+		return;
+	}
+
+	switch (code) {
+		case NN_LOAD_MODEL:
+			_LoadModel(request.model);
+			break;
+		case NN_UNLOAD_MODEL:
+			_UnloadModel(request.model);
+			break;
+		case NN_SAVE_MODEL:
+			_SaveModel(request.model);
+			break;
+		case NN_INFER:
+			_SubmitInference(request.infer, sender);
+			break;
+		case NN_TRAIN:
+			_SubmitTraining(request.train, sender);
+			break;
+		case NN_RELEASE_AREA:
+			_ReleaseArea(request.area.area, sender);
+			break;
+	}
+}
+
+
+/*!	Starts a worker thread for a job, and collects the threads of the jobs
+	that are done. The scheduler lock must not be held. The job is deleted
+	by the worker, and must be deleted by the caller on failure.
+*/
+status_t
+RequestScheduler::_StartWorker(WorkerJob* job, const char* name,
+	int32 priority)
+{
+	BAutolock locker(fLock);
+
+	if (fTerminating)
+		return B_CANCELED;
+
+	// These threads are done with the scheduler, and only have to exit.
+	std::vector<thread_id> finished;
+	finished.swap(fFinishedWorkers);
+	for (size_t i = 0; i < finished.size(); i++) {
+		fWorkers.erase(std::find(fWorkers.begin(), fWorkers.end(),
+			finished[i]));
+	}
+
+	thread_id worker = spawn_thread(_WorkerEntry, name, priority, job);
+	if (worker >= 0)
+		fWorkers.push_back(worker);
+
+	locker.Unlock();
+
+	status_t result;
+	for (size_t i = 0; i < finished.size(); i++)
+		wait_for_thread(finished[i], &result);
+
+	if (worker < 0)
+		return worker;
+
+	resume_thread(worker);
+	return B_OK;
+}
+
+
+void
+RequestScheduler::_LoadModel(const nn_model_request& request)
+{
+	WorkerJob* job = new(std::nothrow) WorkerJob;
+	if (job == NULL) {
+		_Reply(request.replyPort, NN_LOAD_MODEL, request.token, B_NO_MEMORY);
+		return;
+	}
+
+	job->scheduler = this;
+	job->code = NN_LOAD_MODEL;
+	job->request.model = request;
+
+	status_t status = _StartWorker(job, "nn model loader", B_NORMAL_PRIORITY);
+	if (status != B_OK) {
+		delete job;
+		_Reply(request.replyPort, NN_LOAD_MODEL, request.token, status);
+	}
+}
+
+
+void
+RequestScheduler::_UnloadModel(const nn_model_request& request)
+{
+	BAutolock locker(fLock);
+
+	ModelMap::iterator found = fModels.find(request.model);
+	if (found == fModels.end()) {
+		locker.Unlock();
+		_Reply(request.replyPort, NN_UNLOAD_MODEL, request.token,
+			B_BAD_VALUE, request.model);
+		return;
+	}
+
+	Model* model = found->second;
+	fModels.erase(found);
+
+	InferenceJobList canceled;
+	canceled.MoveFrom(&model->pending);
+	model->pendingRows = 0;
+
+	locker.Unlock();
+
+	while (InferenceJob* job = canceled.RemoveHead()) {
+		_Reply(job->request.replyPort, NN_INFER, job->request.token,
+			B_CANCELED, model->id);
+		delete job;
+	}
+
+	// A batch or a training still running keeps its own reference.
+	model->ReleaseReference();
+
+	_Reply(request.replyPort, NN_UNLOAD_MODEL, request.token, B_OK,
+		request.model);
+}
+
+
+void
+RequestScheduler::_SaveModel(const nn_model_request& request)
+{
+	WorkerJob* job = new(std::nothrow) WorkerJob;
+	if (job == NULL) {
+		_Reply(request.replyPort, NN_SAVE_MODEL, request.token, B_NO_MEMORY,
+			request.model);
+		return;
+	}
+
+	job->scheduler = this;
+	job->code = NN_SAVE_MODEL;
+	job->request.model = request;
+
+	BAutolock locker(fLock);
+
+	ModelMap::iterator found = fModels.find(request.model);
+	status_t status = B_OK;
+	if (found == fModels.end())
+		status = B_BAD_VALUE;
+	else if (found->second->busy)
+		status = B_BUSY;
+
+	if (status == B_OK) {
+		job->model.SetTo(found->second);
+		job->model->busy = true;
+	}
+
+	locker.Unlock();
+
+	if (status == B_OK) {
+		status = _StartWorker(job, "nn model saver", B_NORMAL_PRIORITY);
+		if (status != B_OK) {
+			locker.Lock();
+			job->model->busy = false;
+			locker.Unlock();
+		}
+	}
+
+	if (status != B_OK) {
+		delete job;
+		_Reply(request.replyPort, NN_SAVE_MODEL, request.token, status,
+			request.model);
+	}
+}
+
+
+void
+RequestScheduler::_SubmitInference(const nn_infer_request& request,
+	team_id sender)
+{
+	InferenceJob* job = new(std::nothrow) InferenceJob;
+	if (job == NULL) {
+		_Reply(request.replyPort, NN_INFER, request.token, B_NO_MEMORY,
+			request.model);
+		return;
+	}
+
+	job->request = request;
+
+	BAutolock locker(fLock);
+
+	ModelMap::iterator found = fModels.find(request.model);
+	Model* model = found != fModels.end() ? found->second : NULL;
+
+	status_t status = B_OK;
+	if (model == NULL || request.rows == 0
+		|| request.inputColumns != model->inputsNumber
+		|| request.outputColumns != model->outputsNumber) {
+		status = B_BAD_VALUE;
+	}
+
+	double* inputs = NULL;
+	double* outputs = NULL;
+	if (status == B_OK) {
+		status = _MapMatrix(sender, request.area, request.inputOffset,
+			request.rows, request.inputColumns, job->area, &inputs);
+	}
+	if (status == B_OK) {
+		status = _MapMatrix(sender, request.area, request.outputOffset,
+			request.rows, request.outputColumns, job->area, &outputs);
+	}
+
+	if (status != B_OK) {
+		locker.Unlock();
+		delete job;
+		_Reply(request.replyPort, NN_INFER, request.token, status,
+			request.model);
+		return;
+	}
+
+	job->inputs = inputs;
+	job->outputs = outputs;
+	job->time = system_time();
+
+	model->pending.Add(job);
+	model->pendingRows += request.rows;
+
+	locker.Unlock();
+
+	release_sem_etc(fRequestSem, 1, B_DO_NOT_RESCHEDULE);
+}
+
+
+void
+RequestScheduler::_SubmitTraining(const nn_train_request& request,
+	team_id sender)
+{
+	WorkerJob* job = new(std::nothrow) WorkerJob;
+	if (job == NULL) {
+		_Reply(request.replyPort, NN_TRAIN, request.token, B_NO_MEMORY,
+			request.model);
+		return;
+	}
+
+	job->scheduler = this;
+	job->code = NN_TRAIN;
+	job->request.train = request;
+
+	BAutolock locker(fLock);
+
+	ModelMap::iterator found = fModels.find(request.model);
+	Model* model = found != fModels.end() ? found->second : NULL;
+
+	status_t status = B_OK;
+	if (model == NULL || request.rows == 0
+		|| request.inputColumns != model->inputsNumber
+		|| request.targetColumns != model->outputsNumber) {
+		status = B_BAD_VALUE;
+	} else if (model->busy)
+		status = B_BUSY;
+
+	if (status == B_OK) {
+		status = _MapMatrix(sender, request.area, request.dataOffset,
+			request.rows, request.inputColumns + request.targetColumns,
+			job->area, &job->data);
+	}
+
+	if (status == B_OK) {
+		job->model.SetTo(model);
+		model->busy = true;
+	}
+
+	locker.Unlock();
+
+	if (status == B_OK) {
+		status = _StartWorker(job, "nn trainer", B_LOW_PRIORITY);
+		if (status != B_OK) {
+			locker.Lock();
+			model->busy = false;
+			locker.Unlock();
+		}
+	}
+
+	if (status != B_OK) {
+		delete job;
+		_Reply(request.replyPort, NN_TRAIN, request.token, status,
+			request.model);
+	}
+}
+
+
+void
+RequestScheduler::_ReleaseArea(area_id area, team_id sender)
+{
+	BAutolock locker(fLock);
+
+	AreaMap::iterator found = fAreas.find(area);
+	if (found == fAreas.end())
+		return;
+
+	// Only the owner may release the clone while the area exists.
+	area_info info;
+	if (get_area_info(area, &info) == B_OK && info.team != sender)
+		return;
+
+	// Jobs still using the clone keep it until they are done.
+	ClonedArea* clone = found->second;
+	fAreas.erase(found);
+	clone->ReleaseReference();
+}
+
+
+/*!	Returns the address of a matrix in the clone of a client area, cloning
+	the area the first time it is used. The area must belong to the team
+	which sent the request, so that a client can't read or write the areas
+	of other teams through the server. The scheduler lock must be held.
+*/
+status_t
+RequestScheduler::_MapMatrix(team_id sender, area_id area, uint32 offset,
+	uint32 rows, uint32 columns, BReference<ClonedArea>& _clone,
+	double** _address)
+{
+	AreaMap::iterator found = fAreas.find(area);
+
+	area_info info;
+	if (get_area_info(area, &info) != B_OK) {
+		// The client deleted the area, so that its clone is stale.
+		if (found != fAreas.end()) {
+			found->second->ReleaseReference();
+			fAreas.erase(found);
+		}
+		return B_BAD_VALUE;
+	}
+
+	if (info.team != sender)
+		return B_NOT_ALLOWED;
+
+	ClonedArea* clone;
+	if (found == fAreas.end()) {
+		void* address;
+		area_id cloneID = clone_area("nn client area", &address,
+			B_ANY_ADDRESS, B_READ_AREA | B_WRITE_AREA, area);
+		if (cloneID < 0)
+			return cloneID;
+
+		clone = new(std::nothrow) ClonedArea(cloneID, (uint8*)address,
+			info.size);
+		if (clone == NULL) {
+			delete_area(cloneID);
+			return B_NO_MEMORY;
+		}
+
+		fAreas[area] = clone;
+	} else
+		clone = found->second;
+
+	if (offset % sizeof(double) != 0 || offset > clone->size)
+		return B_BAD_VALUE;
+
+	const uint64 elements = (uint64)rows * columns;
+	if (elements > (clone->size - offset) / sizeof(double))
+		return B_BAD_VALUE;
+
+	_clone.SetTo(clone);
+	*_address = (double*)(clone->address + offset);
+	return B_OK;
+}
+
+
+status_t
+RequestScheduler::_SchedulerEntry(void* data)
+{
+	return ((RequestScheduler*)data)->_Scheduler();
+}
+
+
+status_t
+RequestScheduler::_Scheduler()
+{
+	while (true) {
+		BReference<Model> model;
+		InferenceJobList batch;
+		bigtime_t timeout = B_INFINITE_TIMEOUT;
+
+		fLock.Lock();
+
+		if (fTerminating) {
+			fLock.Unlock();
+			break;
+		}
+
+		// Among the models whose requests are ready, take the one which has
+		// waited the longest, and otherwise find out when the next one will
+		// be ready.
+		const bigtime_t now = system_time();
+		Model* ready = NULL;
+		for (ModelMap::iterator it = fModels.begin(); it != fModels.end();
+				it++) {
+			Model* candidate = it->second;
+			InferenceJob* oldest = candidate->pending.Head();
+			if (oldest == NULL)
+				continue;
+
+			const bigtime_t deadline = oldest->time + fMaxLatency;
+			if (candidate->pendingRows >= fMaxBatchRows || deadline <= now) {
+				if (ready == NULL
+					|| oldest->time < ready->pending.Head()->time) {
+					ready = candidate;
+				}
+			} else if (deadline - now < timeout)
+				timeout = deadline - now;
+		}
+
+		if (ready != NULL) {
+			model.SetTo(ready);
+			_TakeBatch(ready, batch);
+		}
+
+		fLock.Unlock();
+
+		if (model.IsSet()) {
+			_RunBatch(model.Get(), batch);
+			continue;
+		}
+
+		status_t status;
+		do {
+			if (timeout == B_INFINITE_TIMEOUT)
+				status = acquire_sem(fRequestSem);
+			else {
+				status = acquire_sem_etc(fRequestSem, 1, B_RELATIVE_TIMEOUT,
+					timeout);
+			}
+		} while (status == B_INTERRUPTED);
+
+		if (status == B_BAD_SEM_ID)
+			break;
+
+		// Every request released the semaphore once, but a single pass
+		// looks at all of them.
+		int32 count;
+		if (status == B_OK && get_sem_count(fRequestSem, &count) == B_OK
+			&& count > 0) {
+			acquire_sem_etc(fRequestSem, count, B_RELATIVE_TIMEOUT, 0);
+		}
+	}
+
+	return B_OK;
+}
+
+
+/*!	Moves the oldest requests of a model to a batch, as long as the batch does
+	not get larger than the maximal number of rows. A larger request makes a
+	batch on its own. The scheduler lock must be held.
+*/
+void
+RequestScheduler::_TakeBatch(Model* model, InferenceJobList& batch)
+{
+	uint32 rows = 0;
+	while (InferenceJob* job = model->pending.Head()) {
+		if (rows > 0 && rows + job->request.rows > fMaxBatchRows)
+			break;
+
+		model->pending.Remove(job);
+		batch.Add(job);
+		rows += job->request.rows;
+	}
+
+	model->pendingRows -= rows;
+}
+
+
+void
+RequestScheduler::_RunBatch(Model* model, InferenceJobList& batch)
+{
+	unsigned int rows = 0;
+	int32 count = 0;
+	for (InferenceJobList::Iterator it = batch.GetIterator();
+			InferenceJob* job = it.Next();) {
+		rows += job->request.rows;
+		count++;
+	}
+
+	TRACE(("nn: model %" B_PRId32 " batch of %" B_PRId32 " requests, %u "
+		"rows\n", model->id, count, rows));
+
+	status_t status = B_OK;
+
+	model->lock.Lock();
+
+	const OpenNN::CompiledNeuralNetwork& network = *model->compiled;
+
+	try {
+		if (count == 1 || network.is_jit_compiled()) {
+			// The generated code evaluates one instance after the other, so
+			// that there is nothing to gain from gathering the requests.
+			for (InferenceJobList::Iterator it = batch.GetIterator();
+					InferenceJob* job = it.Next();) {
+				const unsigned int jobRows = job->request.rows;
+				network.calculate_output_data(job->inputs, jobRows,
+					job->outputs);
+			}
+		} else {
+			// Gather the small requests so that the matrix products work on
+			// whole blocks of instances.
+			const size_t inputsNumber = model->inputsNumber;
+			const size_t outputsNumber = model->outputsNumber;
+
+			fBatchInputs.resize(rows * inputsNumber);
+			fBatchOutputs.resize(rows * outputsNumber);
+
+			double* inputs = &fBatchInputs[0];
+			for (InferenceJobList::Iterator it = batch.GetIterator();
+					InferenceJob* job = it.Next();) {
+				const size_t size = job->request.rows * inputsNumber;
+				memcpy(inputs, job->inputs, size * sizeof(double));
+				inputs += size;
+			}
+
+			network.calculate_output_data(&fBatchInputs[0], rows,
+				&fBatchOutputs[0]);
+
+			const double* outputs = &fBatchOutputs[0];
+			for (InferenceJobList::Iterator it = batch.GetIterator();
+					InferenceJob* job = it.Next();) {
+				const size_t size = job->request.rows * outputsNumber;
+				memcpy(job->outputs, outputs, size * sizeof(double));
+				outputs += size;
+			}
+		}
+	} catch (std::bad_alloc&) {
+		status = B_NO_MEMORY;
+	} catch (std::exception& exception) {
+		debug_printf("nn: could not evaluate model %" B_PRId32 ": %s\n",
+			model->id, exception.what());
+		status = B_ERROR;
+	}
+
+	model->lock.Unlock();
+
+	while (InferenceJob* job = batch.RemoveHead()) {
+		_Reply(job->request.replyPort, NN_INFER, job->request.token, status,
+			model->id, job->request.rows);
+		delete job;
+	}
+}
+
+
+status_t
+RequestScheduler::_WorkerEntry(void* data)
+{
+	WorkerJob* job = (WorkerJob*)data;
+	RequestScheduler* scheduler = job->scheduler;
+
+	switch (job->code) {
+		case NN_LOAD_MODEL:
+			scheduler->_Load(job);
+			break;
+		case NN_SAVE_MODEL:
+			scheduler->_Save(job);
+			break;
+		case NN_TRAIN:
+			scheduler->_Train(job);
+			break;
+	}
+
+	delete job;
+
+	scheduler->fLock.Lock();
+	scheduler->fFinishedWorkers.push_back(find_thread(NULL));
+	scheduler->fLock.Unlock();
+	return B_OK;
+}
+
+
+void
+RequestScheduler::_Load(WorkerJob* job)
+{
+	const nn_model_request& request = job->request.model;
+	const std::string path(request.path,
+		strnlen(request.path, sizeof(request.path)));
+
+	Model* model = NULL;
+	status_t status = B_OK;
+
+	try {
+		model = new Model;
+		model->network.load(path);
+		model->compiled = new OpenNN::CompiledNeuralNetwork(model->network);
+	} catch (std::bad_alloc&) {
+		status = B_NO_MEMORY;
+	} catch (std::exception& exception) {
+		debug_printf("nn: could not load model %s: %s\n", path.c_str(),
+			exception.what());
+		status = B_BAD_DATA;
+	}
+
+	if (status != B_OK) {
+		if (model != NULL)
+			model->ReleaseReference();
+		_Reply(request.replyPort, NN_LOAD_MODEL, request.token, status);
+		return;
+	}
+
+	model->inputsNumber = model->compiled->get_inputs_number();
+	model->outputsNumber = model->compiled->get_outputs_number();
+
+	BAutolock locker(fLock);
+	model->id = fNextModelID++;
+	fModels[model->id] = model;
+	locker.Unlock();
+
+	TRACE(("nn: loaded model %" B_PRId32 " from %s\n", model->id,
+		path.c_str()));
+
+	_Reply(request.replyPort, NN_LOAD_MODEL, request.token, B_OK, model->id);
+}
+
+
+void
+RequestScheduler::_Save(WorkerJob* job)
+{
+	Model* model = job->model.Get();
+	const nn_model_request& request = job->request.model;
+	const std::string path(request.path,
+		strnlen(request.path, sizeof(request.path)));
+
+	status_t status = B_OK;
+
+	try {
+		model->network.save(path);
+	} catch (std::exception& exception) {
+		debug_printf("nn: could not save model %" B_PRId32 " to %s: %s\n",
+			request.model, path.c_str(), exception.what());
+		status = B_ERROR;
+	}
+
+	fLock.Lock();
+	model->busy = false;
+	fLock.Unlock();
+
+	_Reply(request.replyPort, NN_SAVE_MODEL, request.token, status,
+		request.model);
+}
+
+
+void
+RequestScheduler::_Train(WorkerJob* job)
+{
+	Model* model = job->model.Get();
+	const nn_train_request& request = job->request.train;
+
+	status_t status = B_OK;
+	double performance = 0.0;
+
+	try {
+		// The data set keeps a copy of the data, so that the client may
+		// reuse its area as soon as the training has started.
+		OpenNN::Matrix<double> data;
+		data.set_external_data(request.rows,
+			request.inputColumns + request.targetColumns, job->data);
+
+		OpenNN::DataSet dataSet(request.rows, request.inputColumns,
+			request.targetColumns);
+		dataSet.set_data(data);
+
+		job->area.Unset();
+
+		OpenNN::PerformanceFunctional performanceFunctional(&model->network,
+			&dataSet);
+
+		OpenNN::TrainingStrategy trainingStrategy(&performanceFunctional);
+		trainingStrategy.set_display(false);
+		trainingStrategy.get_main_training_algorithm_pointer()
+			->set_display(false);
+
+		OpenNN::TrainingStrategy::Results results
+			= trainingStrategy.perform_training();
+		delete results.initialization_training_algorithm_results_pointer;
+		delete results.main_training_algorithm_results_pointer;
+		delete results.refinement_training_algorithm_results_pointer;
+
+		performance = performanceFunctional.calculate_evaluation();
+
+		// Requests keep being evaluated with the previous network until the
+		// trained one is compiled.
+		OpenNN::CompiledNeuralNetwork* compiled
+			= new OpenNN::CompiledNeuralNetwork(model->network);
+
+		model->lock.Lock();
+		std::swap(model->compiled, compiled);
+		model->lock.Unlock();
+
+		delete compiled;
+	} catch (std::bad_alloc&) {
+		status = B_NO_MEMORY;
+	} catch (std::exception& exception) {
+		debug_printf("nn: could not train model %" B_PRId32 ": %s\n",
+			model->id, exception.what());
+		status = B_ERROR;
+	}
+
+	fLock.Lock();
+	model->busy = false;
+	fLock.Unlock();
+
+	_Reply(request.replyPort, NN_TRAIN, request.token, status, model->id,
+		request.rows, performance);
+}
+
+
+void
+RequestScheduler::_Reply(port_id port, int32 code, int32 token,
+	status_t status, int32 model, uint32 rows, double performance)
+{
+	if (port < 0)
+		return;
+
+	nn_reply reply;
+	reply.token = token;
+	reply.status = status;
+	reply.model = model;
+	reply.rows = rows;
+	reply.performance = performance;
+
+	status_t result = write_port_etc(port, code, &reply, sizeof(reply),
+		B_RELATIVE_TIMEOUT, kReplyTimeout);
+	if (result != B_OK) {
+		TRACE(("nn: could not reply to port %" B_PRId32 ": %s\n", port,
+			strerror(result)));
+	}
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+#ifndef REQUEST_SCHEDULER_H
+#define REQUEST_SCHEDULER_H
+
+
+#include <map>
+#include <vector>
+
+#include <Locker.h>
+#include <OS.h>
+#include <Referenceable.h>
+
+#include <util/DoublyLinkedList.h>
+
+#include <NN.h>
+
+
+// Executes the model, inference and training requests of the clients of the
+// nn server. Inference requests for the same model are batched: they wait
+// until either the requested rows reach the maximal batch size, or the
+// oldest of them has waited for the maximal latency, and are then evaluated
+// together by a single scheduler thread. Inputs are read from and outputs
+// written to the clones of the clients' areas, so that no data goes through
+// the ports. Loading, saving and training a model each run in a worker
+// thread of their own, so that they never hold up inference requests, and a
+// trained network replaces the one used for inference only when done.
+// Shutdown() waits for the workers still running.
+class RequestScheduler {
+public:
+								RequestScheduler();
+								~RequestScheduler();
+
+			status_t			Init(uint32 maxBatchRows,
+									bigtime_t maxLatency);
+			void				Shutdown();
+
+			void				HandleRequest(int32 code,
+									const nn_request& request,
+									ssize_t size, team_id sender);
+
+private:
+			struct ClonedArea;
+			struct Model;
+			struct InferenceJob;
+			struct WorkerJob;
+
+			typedef DoublyLinkedList<InferenceJob> InferenceJobList;
+			typedef std::map<int32, Model*> ModelMap;
+			typedef std::map<area_id, ClonedArea*> AreaMap;
+
+			status_t			_StartWorker(WorkerJob* job,
+									const char* name, int32 priority);
+
+			void				_LoadModel(const nn_model_request& request);
+			void				_UnloadModel(const nn_model_request& request);
+			void				_SaveModel(const nn_model_request& request);
+			void				_SubmitInference(
+									const nn_infer_request& request,
+									team_id sender);
+			void				_SubmitTraining(
+									const nn_train_request& request,
+									team_id sender);
+			void				_ReleaseArea(area_id area, team_id sender);
+
+			status_t			_MapMatrix(team_id sender, area_id area,
+									uint32 offset,
+									uint32 rows, uint32 columns,
+									BReference<ClonedArea>& _clone,
+									double** _address);
+
+	static	status_t			_SchedulerEntry(void* data);
+			status_t			_Scheduler();
+			void				_TakeBatch(Model* model,
+									InferenceJobList& batch);
+			void				_RunBatch(Model* model,
+									InferenceJobList& batch);
+
+	static	status_t			_WorkerEntry(void* data);
+			void				_Load(WorkerJob* job);
+			void				_Save(WorkerJob* job);
+			void				_Train(WorkerJob* job);
+
+	static	void				_Reply(port_id port, int32 code, int32 token,
+									status_t status, int32 model = -1,
+									uint32 rows = 0,
+									double performance = 0.0);
+
+private:
+			BLocker				fLock;
+			ModelMap			fModels;
+			AreaMap				fAreas;
+			int32				fNextModelID;
+
+			uint32				fMaxBatchRows;
+			bigtime_t			fMaxLatency;
+
+			sem_id				fRequestSem;
+			thread_id			fScheduler;
+			bool				fTerminating;
+
+			std::vector<thread_id>	fWorkers;
+			std::vector<thread_id>	fFinishedWorkers;
+
+			// only used by the scheduler thread
+			std::vector<double>	fBatchInputs;
+			std::vector<double>	fBatchOutputs;
+};
+
+
+#endif	// REQUEST_SCHEDULER_H
@@ -0,0 +1,610 @@
+#include <stdarg.h>
+#include <stdio.h>
+#include "mzcc.h"
+
+/*
+ * Instruction selection for the register allocated IR.
+ *
+ * Values held in spill slots are brought into the scratch registers %rax,
+ * %rcx and %rdx around each instruction. The frame keeps the same size
+ * for the whole function, so calls need no stack alignment of their own.
+ */
+
+static const int ARG_REGS[] = {X86_RDI, X86_RSI, X86_RDX,
+                               X86_RCX, X86_R8,  X86_R9};
+static const int SAVED_REGS[] = {X86_RBX, X86_R12, X86_R13, X86_R14, X86_R15};
+
+#define NSAVED (int) (sizeof(SAVED_REGS) / sizeof(SAVED_REGS[0]))
+
+/* FIXME: main program should take extern variables from codegen. */
+extern FILE *outfp;
+
+static IRFunc *fn;
+static X86Code *code;
+static int saved_slots[NSAVED];
+
+static X86Operand reg_opnd(int reg)
+{
+    return (X86Operand){OPND_REG, reg, 0, NULL, -1, 0};
+}
+
+static X86Operand mem_opnd(int base, long disp)
+{
+    return (X86Operand){OPND_MEM, base, disp, NULL, -1, 0};
+}
+
+static X86Operand imm_opnd(long val)
+{
+    return (X86Operand){OPND_IMM, 0, val, NULL, -1, 0};
+}
+
+static X86Operand label_opnd(int label)
+{
+    return (X86Operand){OPND_LABEL, 0, label, NULL, -1, 0};
+}
+
+static X86Operand sym_opnd(char *sym)
+{
+    return (X86Operand){OPND_SYM, 0, 0, sym, -1, 0};
+}
+
+static X86Operand none_opnd(void)
+{
+    return (X86Operand){OPND_NONE, 0, 0, NULL, -1, 0};
+}
+
+static void emit_x86(int op, int size, X86Operand src, X86Operand dst)
+{
+    if (code->ninsts == code->nalloc) {
+        code->nalloc = code->nalloc ? code->nalloc * 2 : 64;
+        code->insts = realloc(code->insts, code->nalloc * sizeof(X86Inst));
+    }
+    code->insts[code->ninsts++] = (X86Inst){op, size, 0, src, dst};
+}
+
+static void emit_x86_cc(int op, int cc, X86Operand opnd)
+{
+    emit_x86(op, 1, none_opnd(), opnd);
+    code->insts[code->ninsts - 1].cc = cc;
+}
+
+static bool is_unused(int v)
+{
+    return fn->reg[v] < 0 && fn->slot[v] == 0;
+}
+
+/* Location of a virtual register: its register or its spill slot */
+static X86Operand loc(int v)
+{
+    if (fn->reg[v] >= 0)
+        return reg_opnd(fn->reg[v]);
+    return mem_opnd(X86_RBP, fn->slot[v]);
+}
+
+static bool same_opnd(X86Operand a, X86Operand b)
+{
+    return a.kind == b.kind && a.reg == b.reg && a.val == b.val &&
+           a.index == b.index;
+}
+
+static bool fits_imm32(long val)
+{
+    return val == (int) val;
+}
+
+static void emit_move(X86Operand src, X86Operand dst)
+{
+    if (same_opnd(src, dst))
+        return;
+    if (src.kind == OPND_MEM && dst.kind == OPND_MEM) {
+        emit_x86(X86_MOV, 8, src, reg_opnd(X86_RAX));
+        src = reg_opnd(X86_RAX);
+    } else if (src.kind == OPND_IMM && !fits_imm32(src.val) &&
+               dst.kind == OPND_MEM) {
+        emit_x86(X86_MOV, 8, src, reg_opnd(X86_RAX));
+        src = reg_opnd(X86_RAX);
+    }
+    emit_x86(X86_MOV, 8, src, dst);
+}
+
+/* Returns the register holding v, loading it into scratch when spilled. */
+static int use_reg(int v, int scratch)
+{
+    if (fn->reg[v] >= 0)
+        return fn->reg[v];
+    emit_x86(X86_MOV, 8, loc(v), reg_opnd(scratch));
+    return scratch;
+}
+
+/* Second operand of an instruction: a location or an immediate */
+static X86Operand src1_opnd(IRInst *inst)
+{
+    if (inst->src[1] < 0)
+        return imm_opnd(inst->imm);
+    return loc(inst->src[1]);
+}
+
+/* Register into which the result of inst is computed */
+static int work_reg(IRInst *inst)
+{
+    if (fn->reg[inst->dst] >= 0)
+        return fn->reg[inst->dst];
+    return X86_RAX;
+}
+
+static void store_result(IRInst *inst, int reg)
+{
+    emit_move(reg_opnd(reg), loc(inst->dst));
+}
+
+/*
+ * Moves all of srcs into dsts at once, where the destinations are registers
+ * or slots and the sources are registers or slots other than those. Cycles
+ * between registers are broken with %rax, which no memory to memory move
+ * needs here.
+ */
+static void emit_parallel_move(X86Operand *srcs, X86Operand *dsts, int n)
+{
+    bool *done = calloc(n, sizeof(bool));
+    int left = n;
+    for (int i = 0; i < n; i++) {
+        if (same_opnd(srcs[i], dsts[i])) {
+            done[i] = true;
+            left--;
+        }
+    }
+    while (left > 0) {
+        int next = -1;
+        for (int i = 0; i < n && next < 0; i++) {
+            if (done[i])
+                continue;
+            bool blocked = false;
+            for (int j = 0; j < n && !blocked; j++)
+                blocked = !done[j] && j != i && same_opnd(srcs[j], dsts[i]);
+            if (!blocked)
+                next = i;
+        }
+        if (next < 0) {
+            /* Every destination is still to be read: save one of them. */
+            for (int i = 0; i < n && next < 0; i++)
+                if (!done[i])
+                    next = i;
+            X86Operand saved = dsts[next];
+            emit_move(saved, reg_opnd(X86_RAX));
+            for (int j = 0; j < n; j++)
+                if (!done[j] && same_opnd(srcs[j], saved))
+                    srcs[j] = reg_opnd(X86_RAX);
+            continue;
+        }
+        emit_move(srcs[next], dsts[next]);
+        done[next] = true;
+        left--;
+    }
+    free(done);
+}
+
+static void emit_prologue(void)
+{
+    emit_x86(X86_PUSH, 8, none_opnd(), reg_opnd(X86_RBP));
+    emit_x86(X86_MOV, 8, reg_opnd(X86_RSP), reg_opnd(X86_RBP));
+    for (int i = 0; i < NSAVED; i++) {
+        saved_slots[i] = 0;
+        if (fn->used_regs & (1u << SAVED_REGS[i])) {
+            fn->frame_size += 8;
+            saved_slots[i] = -fn->frame_size;
+        }
+    }
+    fn->frame_size = (fn->frame_size + 15) & ~15;
+    if (fn->frame_size)
+        emit_x86(X86_SUB, 8, imm_opnd(fn->frame_size), reg_opnd(X86_RSP));
+    for (int i = 0; i < NSAVED; i++)
+        if (saved_slots[i])
+            emit_x86(X86_MOV, 8, reg_opnd(SAVED_REGS[i]),
+                     mem_opnd(X86_RBP, saved_slots[i]));
+}
+
+static void emit_epilogue(void)
+{
+    for (int i = 0; i < NSAVED; i++)
+        if (saved_slots[i])
+            emit_x86(X86_MOV, 8, mem_opnd(X86_RBP, saved_slots[i]),
+                     reg_opnd(SAVED_REGS[i]));
+    emit_x86(X86_LEAVE, 8, none_opnd(), none_opnd());
+    emit_x86(X86_RET, 8, none_opnd(), none_opnd());
+}
+
+static int select_params(int i)
+{
+    X86Operand srcs[6], dsts[6];
+    int n = 0;
+    for (; i < fn->ninsts && fn->insts[i].op == IR_PARAM; i++) {
+        IRInst *inst = &fn->insts[i];
+        if (is_unused(inst->dst))
+            continue;
+        srcs[n] = reg_opnd(ARG_REGS[inst->imm]);
+        dsts[n++] = loc(inst->dst);
+    }
+    emit_parallel_move(srcs, dsts, n);
+    return i;
+}
+
+static void select_call(IRInst *inst)
+{
+    X86Operand srcs[6], dsts[6];
+    for (int i = 0; i < inst->nargs; i++) {
+        srcs[i] = loc(inst->args[i]);
+        dsts[i] = reg_opnd(ARG_REGS[i]);
+    }
+    emit_parallel_move(srcs, dsts, inst->nargs);
+    /* No vector registers hold arguments of variadic functions. */
+    emit_x86(X86_MOV, 4, imm_opnd(0), reg_opnd(X86_RAX));
+    emit_x86(X86_CALL, 8, none_opnd(), sym_opnd(inst->sym));
+    if (!is_unused(inst->dst))
+        store_result(inst, X86_RAX);
+}
+
+static int alu_op(int op)
+{
+    switch (op) {
+    case IR_ADD:
+        return X86_ADD;
+    case IR_SUB:
+        return X86_SUB;
+    case IR_MUL:
+        return X86_IMUL;
+    case IR_AND:
+        return X86_AND;
+    default:
+        return X86_OR;
+    }
+}
+
+static void select_alu(IRInst *inst)
+{
+    int a = inst->src[0];
+    int b = inst->src[1];
+    bool commutative = inst->op != IR_SUB;
+    if (commutative && b >= 0 && fn->reg[inst->dst] >= 0 &&
+        fn->reg[b] == fn->reg[inst->dst]) {
+        a = inst->src[1];
+        b = inst->src[0];
+    }
+    int w = work_reg(inst);
+    if (b >= 0 && fn->reg[b] == w)
+        w = X86_RAX;
+    X86Operand src = (b >= 0) ? loc(b) : imm_opnd(inst->imm);
+    emit_move(loc(a), reg_opnd(w));
+    emit_x86(alu_op(inst->op), inst->size, src, reg_opnd(w));
+    store_result(inst, w);
+}
+
+static void select_shift(IRInst *inst)
+{
+    X86Operand count = imm_opnd(inst->imm);
+    if (inst->src[1] >= 0) {
+        emit_move(loc(inst->src[1]), reg_opnd(X86_RCX));
+        count = reg_opnd(X86_RCX);
+    }
+    int w = work_reg(inst);
+    emit_move(loc(inst->src[0]), reg_opnd(w));
+    emit_x86(inst->op == IR_SHL ? X86_SHL : X86_SAR, inst->size, count,
+             reg_opnd(w));
+    store_result(inst, w);
+}
+
+static void select_div(IRInst *inst)
+{
+    emit_move(loc(inst->src[0]), reg_opnd(X86_RAX));
+    emit_x86(X86_CQO, inst->size, none_opnd(), none_opnd());
+    emit_x86(X86_IDIV, inst->size, none_opnd(), loc(inst->src[1]));
+    store_result(inst, X86_RAX);
+}
+
+/* Compares src[0] with the second operand, as cmp src1, src0 */
+static void select_cmp(IRInst *inst)
+{
+    X86Operand b = src1_opnd(inst);
+    X86Operand a = loc(inst->src[0]);
+    if (a.kind == OPND_MEM && b.kind == OPND_MEM)
+        a = reg_opnd(use_reg(inst->src[0], X86_RAX));
+    if (b.kind == OPND_IMM && !fits_imm32(b.val)) {
+        emit_x86(X86_MOV, 8, b, reg_opnd(X86_RCX));
+        b = reg_opnd(X86_RCX);
+    }
+    emit_x86(X86_CMP, inst->size, b, a);
+}
+
+static int cond_code(int op)
+{
+    switch (op) {
+    case IR_EQ:
+    case IR_JEQ:
+    case IR_NOT:
+        return CC_E;
+    case IR_JNE:
+        return CC_NE;
+    case IR_LT:
+    case IR_JLT:
+        return CC_L;
+    case IR_JGE:
+        return CC_GE;
+    case IR_GT:
+    case IR_JGT:
+        return CC_G;
+    default:
+        return CC_LE;
+    }
+}
+
+static void select_set(IRInst *inst)
+{
+    if (inst->op == IR_NOT) {
+        inst->src[1] = -1;
+        inst->imm = 0;
+    }
+    select_cmp(inst);
+    emit_x86_cc(X86_SETCC, cond_code(inst->op), reg_opnd(X86_RAX));
+    emit_x86(X86_MOVZB, 4, reg_opnd(X86_RAX), reg_opnd(X86_RAX));
+    store_result(inst, X86_RAX);
+}
+
+/* Memory operand of IR_LOAD and IR_STORE */
+static X86Operand addr_opnd(IRInst *inst)
+{
+    if (inst->src[0] < 0)
+        return mem_opnd(X86_RBP, inst->imm);
+    X86Operand o = mem_opnd(use_reg(inst->src[0], X86_RAX), inst->imm);
+    if (inst->index >= 0) {
+        o.index = use_reg(inst->index, X86_RDX);
+        o.scale = inst->scale;
+    }
+    return o;
+}
+
+static void select_load(IRInst *inst)
+{
+    X86Operand src = addr_opnd(inst);
+    int w = work_reg(inst);
+    if (inst->size == 1)
+        emit_x86(X86_MOVSX, 1, src, reg_opnd(w));
+    else
+        emit_x86(X86_MOV, inst->size, src, reg_opnd(w));
+    store_result(inst, w);
+}
+
+static void select_store(IRInst *inst)
+{
+    X86Operand dst = addr_opnd(inst);
+    X86Operand val = (inst->src[1] < 0)
+                         ? imm_opnd(inst->imm2)
+                         : reg_opnd(use_reg(inst->src[1], X86_RCX));
+    emit_x86(X86_MOV, inst->size, val, dst);
+}
+
+static void select_inst(IRInst *inst)
+{
+    if (inst->dst >= 0 && is_unused(inst->dst) && inst->op != IR_CALL)
+        return;
+    switch (inst->op) {
+    case IR_IMM:
+        emit_move(imm_opnd(inst->imm), loc(inst->dst));
+        break;
+    case IR_MOV:
+        emit_move(loc(inst->src[0]), loc(inst->dst));
+        break;
+    case IR_SEXT: {
+        int w = work_reg(inst);
+        emit_x86(X86_MOVSX, inst->size, loc(inst->src[0]), reg_opnd(w));
+        store_result(inst, w);
+        break;
+    }
+    case IR_ADD:
+    case IR_SUB:
+    case IR_MUL:
+    case IR_AND:
+    case IR_OR:
+        select_alu(inst);
+        break;
+    case IR_DIV:
+        select_div(inst);
+        break;
+    case IR_SHL:
+    case IR_SAR:
+        select_shift(inst);
+        break;
+    case IR_EQ:
+    case IR_LT:
+    case IR_GT:
+    case IR_NOT:
+        select_set(inst);
+        break;
+    case IR_LOAD:
+        select_load(inst);
+        break;
+    case IR_STORE:
+        select_store(inst);
+        break;
+    case IR_LADDR: {
+        int w = work_reg(inst);
+        emit_x86(X86_LEA, 8, mem_opnd(X86_RBP, inst->imm), reg_opnd(w));
+        store_result(inst, w);
+        break;
+    }
+    case IR_GADDR: {
+        int w = work_reg(inst);
+        emit_x86(X86_LEA, 8, sym_opnd(inst->sym), reg_opnd(w));
+        store_result(inst, w);
+        break;
+    }
+    case IR_CALL:
+        select_call(inst);
+        break;
+    case IR_LABEL:
+        emit_x86(X86_LABEL, 0, none_opnd(), label_opnd(inst->label));
+        break;
+    case IR_JMP:
+        emit_x86(X86_JMP, 0, none_opnd(), label_opnd(inst->label));
+        break;
+    case IR_JEQ:
+    case IR_JNE:
+    case IR_JLT:
+    case IR_JGE:
+    case IR_JGT:
+    case IR_JLE:
+        select_cmp(inst);
+        emit_x86_cc(X86_JCC, cond_code(inst->op), label_opnd(inst->label));
+        break;
+    case IR_RET:
+        emit_move(loc(inst->src[0]), reg_opnd(X86_RAX));
+        emit_epilogue();
+        break;
+    default:
+        error("internal error: IR op %d", inst->op);
+    }
+}
+
+void select_instructions(IRFunc *f)
+{
+    fn = f;
+    code = calloc(1, sizeof(X86Code));
+    fn->code = code;
+    emit_prologue();
+    int i = select_params(0);
+    for (; i < fn->ninsts; i++)
+        select_inst(&fn->insts[i]);
+    if (!fn->ninsts || fn->insts[fn->ninsts - 1].op != IR_RET)
+        emit_epilogue();
+    fn = NULL;
+    code = NULL;
+}
+
+/* GAS printing */
+
+static const char *REG_NAMES[][4] = {
+    {"al", "eax", "rax"},    {"cl", "ecx", "rcx"},    {"dl", "edx", "rdx"},
+    {"bl", "ebx", "rbx"},    {"spl", "esp", "rsp"},   {"bpl", "ebp", "rbp"},
+    {"sil", "esi", "rsi"},   {"dil", "edi", "rdi"},   {"r8b", "r8d", "r8"},
+    {"r9b", "r9d", "r9"},    {"r10b", "r10d", "r10"}, {"r11b", "r11d", "r11"},
+    {"r12b", "r12d", "r12"}, {"r13b", "r13d", "r13"}, {"r14b", "r14d", "r14"},
+    {"r15b", "r15d", "r15"},
+};
+
+static const char *CC_NAMES[] = {"e", "ne", "l", "ge", "g", "le"};
+
+static const char *reg_name(int reg, int size)
+{
+    return REG_NAMES[reg][size == 1 ? 0 : size == 4 ? 1 : 2];
+}
+
+static char suffix(int size)
+{
+    return size == 1 ? 'b' : size == 4 ? 'l' : 'q';
+}
+
+static void print_opnd(X86Operand o, int size, char *fname)
+{
+    switch (o.kind) {
+    case OPND_REG:
+        fprintf(outfp, "%%%s", reg_name(o.reg, size));
+        break;
+    case OPND_MEM:
+        if (o.val)
+            fprintf(outfp, "%ld", o.val);
+        if (o.index >= 0)
+            fprintf(outfp, "(%%%s,%%%s,%d)", reg_name(o.reg, 8),
+                    reg_name(o.index, 8), o.scale);
+        else
+            fprintf(outfp, "(%%%s)", reg_name(o.reg, 8));
+        break;
+    case OPND_IMM:
+        fprintf(outfp, "$%ld", o.val);
+        break;
+    case OPND_LABEL:
+        fprintf(outfp, ".L%s_%ld", fname, o.val);
+        break;
+    case OPND_SYM:
+        fprintf(outfp, "%s(%%rip)", o.sym);
+        break;
+    }
+}
+
+static void print_inst(X86Inst *x, char *fname)
+{
+    static const char *NAMES[] = {
+        [X86_MOV] = "mov", [X86_LEA] = "lea", [X86_ADD] = "add",
+        [X86_SUB] = "sub", [X86_IMUL] = "imul", [X86_AND] = "and",
+        [X86_OR] = "or",   [X86_SHL] = "shl",  [X86_SAR] = "sar",
+        [X86_IDIV] = "idiv", [X86_CMP] = "cmp", [X86_PUSH] = "push",
+    };
+    switch (x->op) {
+    case X86_LABEL:
+        fprintf(outfp, ".L%s_%ld:\n", fname, x->dst.val);
+        return;
+    case X86_MOVSX:
+        fprintf(outfp, "\tmovs%cq\t", suffix(x->size));
+        print_opnd(x->src, x->size, fname);
+        fprintf(outfp, ", ");
+        print_opnd(x->dst, 8, fname);
+        break;
+    case X86_MOVZB:
+        fprintf(outfp, "\tmovzbl\t%%al, %%eax");
+        break;
+    case X86_SHL:
+    case X86_SAR:
+        fprintf(outfp, "\t%s%c\t", NAMES[x->op], suffix(x->size));
+        print_opnd(x->src, 1, fname);
+        fprintf(outfp, ", ");
+        print_opnd(x->dst, x->size, fname);
+        break;
+    case X86_CQO:
+        fprintf(outfp, x->size == 8 ? "\tcqto" : "\tcltd");
+        break;
+    case X86_SETCC:
+        fprintf(outfp, "\tset%s\t%%al", CC_NAMES[x->cc]);
+        break;
+    case X86_JMP:
+        fprintf(outfp, "\tjmp\t");
+        print_opnd(x->dst, 8, fname);
+        break;
+    case X86_JCC:
+        fprintf(outfp, "\tj%s\t", CC_NAMES[x->cc]);
+        print_opnd(x->dst, 8, fname);
+        break;
+    case X86_CALL:
+#ifdef __APPLE__
+        fprintf(outfp, "\tcall\t_%s", x->dst.sym);
+#else
+        fprintf(outfp, "\tcall\t%s", x->dst.sym);
+#endif
+        break;
+    case X86_LEAVE:
+        fprintf(outfp, "\tleave");
+        break;
+    case X86_RET:
+        fprintf(outfp, "\tret");
+        break;
+    case X86_IDIV:
+    case X86_PUSH:
+        fprintf(outfp, "\t%s%c\t", NAMES[x->op], suffix(x->size));
+        print_opnd(x->dst, x->size, fname);
+        break;
+    default:
+        fprintf(outfp, "\t%s%c\t", NAMES[x->op], suffix(x->size));
+        print_opnd(x->src, x->size, fname);
+        fprintf(outfp, ", ");
+        print_opnd(x->dst, x->size, fname);
+    }
+    fprintf(outfp, "\n");
+}
+
+void emit_ir_func(IRFunc *f)
+{
+    fprintf(outfp, "\t.text\n");
+#ifdef __APPLE__
+    fprintf(outfp, ".global _%s\n_%s:\n", f->name, f->name);
+#else
+    fprintf(outfp, ".global %s\n%s:\n", f->name, f->name);
+#endif
+    for (int i = 0; i < f->code->ninsts; i++)
+        print_inst(&f->code->insts[i], f->name);
+}
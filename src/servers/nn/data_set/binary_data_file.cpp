@@ -0,0 +1,593 @@
+/****************************************************************************************************************/
+/*                                                                                                              */
+/*   OpenNN: Open Neural Networks Library                                                                       */
+/*   www.opennn.cimne.com                                                                                       */
+/*                                                                                                              */
+/*   B I N A R Y   D A T A   F I L E   C L A S S                                                                */
+/*                                                                                                              */
+/*   Roberto Lopez                                                                                              */
+/*   International Center for Numerical Methods in Engineering (CIMNE)                                          */
+/*   Technical University of Catalonia (UPC)                                                                    */
+/*   Barcelona, Spain                                                                                           */
+/*   E-mail: rlopez@cimne.upc.edu                                                                               */
+/*                                                                                                              */
+/****************************************************************************************************************/
+
+// System includes
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <stdint.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// OpenNN includes
+
+#include "binary_data_file.h"
+
+namespace OpenNN
+{
+
+// Layout of the header: magic (8 bytes), version (4 bytes), byte order mark (4 bytes),
+// rows number (8 bytes) and columns number (8 bytes), padded with zeros up to header_size bytes.
+
+static const char binary_data_file_magic[8] = {'O', 'P', 'E', 'N', 'N', 'N', 'D', 'B'};
+
+static const uint32_t binary_data_file_version = 1;
+
+static const uint32_t binary_data_file_byte_order_mark = 0x01020304;
+
+
+// DEFAULT CONSTRUCTOR
+
+/// Default constructor. It creates a binary data file object which is not mapped to any file.
+
+BinaryDataFile::BinaryDataFile(void)
+{
+   rows_number = 0;
+   columns_number = 0;
+
+   mapping_pointer = NULL;
+   mapping_size = 0;
+}
+
+
+// FILE CONSTRUCTOR
+
+/// File constructor. It creates a binary data file object and maps a file into memory.
+/// @param new_filename Name of binary data file.
+
+BinaryDataFile::BinaryDataFile(const std::string& new_filename)
+{
+   rows_number = 0;
+   columns_number = 0;
+
+   mapping_pointer = NULL;
+   mapping_size = 0;
+
+   open(new_filename);
+}
+
+
+// DESTRUCTOR
+
+/// Destructor. It unmaps the file, if any.
+
+BinaryDataFile::~BinaryDataFile(void)
+{
+   close();
+}
+
+
+// METHODS
+
+// void open(const std::string&) method
+
+/// This method maps a binary data file into memory, closing the previous one.
+/// Pages of the file are read by the operating system when they are first accessed.
+/// @param new_filename Name of binary data file.
+
+void BinaryDataFile::open(const std::string& new_filename)
+{
+   close();
+
+   unsigned int new_rows_number;
+   unsigned int new_columns_number;
+
+   load_header(new_filename, new_rows_number, new_columns_number);
+
+   // load_header() has checked that the file size is the size of the data, and that it fits in memory.
+
+   const size_t new_mapping_size = header_size + (size_t)new_rows_number*new_columns_number*sizeof(double);
+
+   const int file_descriptor = ::open(new_filename.c_str(), O_RDONLY);
+
+   void* new_mapping_pointer = MAP_FAILED;
+
+   struct stat file_status;
+
+   // A file truncated after its header was read would fault when its last pages are accessed.
+
+   if(file_descriptor >= 0
+   && (fstat(file_descriptor, &file_status) != 0 || (uint64_t)file_status.st_size != new_mapping_size))
+   {
+      ::close(file_descriptor);
+
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "void open(const std::string&) method.\n"
+             << "Binary data file changed while being opened: " << new_filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   if(file_descriptor >= 0)
+   {
+      new_mapping_pointer = mmap(NULL, new_mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file_descriptor, 0);
+
+      // The mapping stays valid after the descriptor is closed.
+
+      ::close(file_descriptor);
+   }
+
+   if(new_mapping_pointer == MAP_FAILED)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "void open(const std::string&) method.\n"
+             << "Cannot map binary data file: " << new_filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   filename = new_filename;
+
+   rows_number = new_rows_number;
+   columns_number = new_columns_number;
+
+   mapping_pointer = new_mapping_pointer;
+   mapping_size = new_mapping_size;
+}
+
+
+// void close(void) method
+
+/// This method unmaps the file, if any.
+/// Pointers obtained from this object are not valid afterwards.
+
+void BinaryDataFile::close(void)
+{
+   if(mapping_pointer != NULL)
+   {
+      munmap(mapping_pointer, mapping_size);
+   }
+
+   filename.clear();
+
+   rows_number = 0;
+   columns_number = 0;
+
+   mapping_pointer = NULL;
+   mapping_size = 0;
+}
+
+
+// bool is_open(void) const method
+
+/// This method returns true if a file is mapped into memory, and false otherwise.
+
+bool BinaryDataFile::is_open(void) const
+{
+   return(mapping_pointer != NULL);
+}
+
+
+// const std::string& get_filename(void) const method
+
+/// This method returns the name of the mapped file, or an empty string if no file is open.
+
+const std::string& BinaryDataFile::get_filename(void) const
+{
+   return(filename);
+}
+
+
+// const unsigned int& get_rows_number(void) const method
+
+/// This method returns the number of rows in the data matrix of the mapped file.
+
+const unsigned int& BinaryDataFile::get_rows_number(void) const
+{
+   return(rows_number);
+}
+
+
+// const unsigned int& get_columns_number(void) const method
+
+/// This method returns the number of columns in the data matrix of the mapped file.
+
+const unsigned int& BinaryDataFile::get_columns_number(void) const
+{
+   return(columns_number);
+}
+
+
+// double* get_data_pointer(void) const method
+
+/// This method returns a pointer to the first data value of the mapped file, or NULL if no file is open.
+
+double* BinaryDataFile::get_data_pointer(void) const
+{
+   if(mapping_pointer == NULL)
+   {
+      return(NULL);
+   }
+
+   return((double*)((char*)mapping_pointer + header_size));
+}
+
+
+// double* get_row_pointer(const unsigned int&) const method
+
+/// This method returns a pointer to the first value of a row of the mapped data matrix.
+/// @param row_index Index of row.
+
+double* BinaryDataFile::get_row_pointer(const unsigned int& row_index) const
+{
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG
+
+   if(row_index >= rows_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "double* get_row_pointer(const unsigned int&) const method.\n"
+             << "Index of row (" << row_index << ") must be less than number of rows (" << rows_number << ").\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   return(get_data_pointer() + (size_t)row_index*columns_number);
+}
+
+
+// bool is_binary_data_file(const std::string&) method
+
+/// This method returns true if a file starts with the binary data file magic, and false otherwise.
+/// @param filename Name of file.
+
+bool BinaryDataFile::is_binary_data_file(const std::string& filename)
+{
+   std::ifstream file(filename.c_str(), std::ios::binary);
+
+   char magic[sizeof(binary_data_file_magic)];
+
+   if(!file.read(magic, sizeof(magic)))
+   {
+      return(false);
+   }
+
+   return(memcmp(magic, binary_data_file_magic, sizeof(magic)) == 0);
+}
+
+
+// void load_header(const std::string&, unsigned int&, unsigned int&) method
+
+/// This method reads and checks the header of a binary data file.
+/// It throws an exception if the file is not a binary data file written by this version on a machine with the same byte order,
+/// or if its size does not match the header.
+/// @param filename Name of binary data file.
+/// @param rows_number Number of rows in the data matrix (output).
+/// @param columns_number Number of columns in the data matrix (output).
+
+void BinaryDataFile::load_header(const std::string& filename, unsigned int& rows_number, unsigned int& columns_number)
+{
+   std::ifstream file(filename.c_str(), std::ios::binary);
+
+   if(!file.is_open())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "void load_header(const std::string&, unsigned int&, unsigned int&) method.\n"
+             << "Cannot open binary data file: " << filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   char header[header_size];
+
+   if(!file.read(header, header_size) || memcmp(header, binary_data_file_magic, sizeof(binary_data_file_magic)) != 0)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "void load_header(const std::string&, unsigned int&, unsigned int&) method.\n"
+             << "File is not a binary data file: " << filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   file.seekg(0, std::ios::end);
+
+   const uint64_t file_size = (uint64_t)file.tellg();
+
+   uint32_t version;
+   uint32_t byte_order_mark;
+   uint64_t header_rows_number;
+   uint64_t header_columns_number;
+
+   memcpy(&version, header + 8, sizeof(version));
+   memcpy(&byte_order_mark, header + 12, sizeof(byte_order_mark));
+   memcpy(&header_rows_number, header + 16, sizeof(header_rows_number));
+   memcpy(&header_columns_number, header + 24, sizeof(header_columns_number));
+
+   // The number of values is compared with a division, so that a corrupt header cannot overflow the product of its sizes.
+
+   const uint64_t data_size = file_size - header_size;
+   const uint64_t values_number = data_size/sizeof(double);
+
+   const bool size_matches = data_size%sizeof(double) == 0
+                          && (header_columns_number == 0
+                              ? values_number == 0
+                              : values_number%header_columns_number == 0 && values_number/header_columns_number == header_rows_number);
+
+   if(version != binary_data_file_version
+   || byte_order_mark != binary_data_file_byte_order_mark
+   || header_rows_number > 0xFFFFFFFFu || header_columns_number > 0xFFFFFFFFu
+   || !size_matches
+   || file_size > (uint64_t)(size_t)-1)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "void load_header(const std::string&, unsigned int&, unsigned int&) method.\n"
+             << "Unsupported version, byte order or size of binary data file: " << filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   rows_number = (unsigned int)header_rows_number;
+   columns_number = (unsigned int)header_columns_number;
+}
+
+
+// void save(const std::string&, const Matrix<double>&) method
+
+/// This method saves a data matrix to a binary data file.
+/// @param filename Name of binary data file.
+/// @param data Data matrix.
+
+void BinaryDataFile::save(const std::string& filename, const Matrix<double>& data)
+{
+   std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+
+   if(!file.is_open())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "void save(const std::string&, const Matrix<double>&) method.\n"
+             << "Cannot open binary data file: " << filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   const unsigned int rows_number = data.get_rows_number();
+   const unsigned int columns_number = data.get_columns_number();
+
+   write_header(file, rows_number, columns_number);
+
+   for(unsigned int i = 0; i < rows_number; i++)
+   {
+      file.write((const char*)data[i], (std::streamsize)(columns_number*sizeof(double)));
+   }
+
+   if(!file.good())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "void save(const std::string&, const Matrix<double>&) method.\n"
+             << "Cannot write binary data file: " << filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+}
+
+
+// void save(const std::string&, const Vector<double>&) method
+
+/// This method saves a vector to a binary data file, as a data matrix with a single row.
+/// @param filename Name of binary data file.
+/// @param data Data vector.
+
+void BinaryDataFile::save(const std::string& filename, const Vector<double>& data)
+{
+   std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+
+   if(!file.is_open())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "void save(const std::string&, const Vector<double>&) method.\n"
+             << "Cannot open binary data file: " << filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   const unsigned int size = data.size();
+
+   write_header(file, 1, size);
+
+   if(size > 0)
+   {
+      file.write((const char*)&data[0], (std::streamsize)(size*sizeof(double)));
+   }
+
+   if(!file.good())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "void save(const std::string&, const Vector<double>&) method.\n"
+             << "Cannot write binary data file: " << filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+}
+
+// void convert_text_data_file(const std::string&, const std::string&) method
+
+/// This method converts a text data file, as read by DataSet::load_data, into a binary data file.
+/// The text file is read one line at a time, so that its size is not limited by the available memory.
+/// @param text_filename Name of text data file.
+/// @param binary_filename Name of binary data file.
+
+void BinaryDataFile::convert_text_data_file(const std::string& text_filename, const std::string& binary_filename)
+{
+   std::ifstream text_file(text_filename.c_str());
+
+   if(!text_file.is_open())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "void convert_text_data_file(const std::string&, const std::string&) method.\n"
+             << "Cannot open text data file: " << text_filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   std::ofstream binary_file(binary_filename.c_str(), std::ios::binary | std::ios::trunc);
+
+   if(!binary_file.is_open())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "void convert_text_data_file(const std::string&, const std::string&) method.\n"
+             << "Cannot open binary data file: " << binary_filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   // The header is rewritten once the sizes are known.
+
+   write_header(binary_file, 0, 0);
+
+   unsigned int rows_number = 0;
+   unsigned int columns_number = 0;
+
+   std::vector<double> row;
+
+   std::string line;
+
+   while(std::getline(text_file, line))
+   {
+      std::istringstream line_stream(line);
+
+      row.clear();
+
+      double value;
+
+      while(line_stream >> value)
+      {
+         row.push_back(value);
+      }
+
+      if(!line_stream.eof())
+      {
+         std::ostringstream buffer;
+
+         buffer << "OpenNN Exception: BinaryDataFile class.\n"
+                << "void convert_text_data_file(const std::string&, const std::string&) method.\n"
+                << "Cannot read value in line " << rows_number+1 << " of text data file.\n";
+
+         throw std::logic_error(buffer.str());
+      }
+
+      if(row.empty())
+      {
+         continue;
+      }
+
+      if(rows_number == 0)
+      {
+         columns_number = (unsigned int)row.size();
+      }
+      else if(row.size() != columns_number)
+      {
+         std::ostringstream buffer;
+
+         buffer << "OpenNN Exception: BinaryDataFile class.\n"
+                << "void convert_text_data_file(const std::string&, const std::string&) method.\n"
+                << "Number of values in row " << rows_number+1 << " (" << row.size() << ") "
+                << "must be equal to number of columns (" << columns_number << ").\n";
+
+         throw std::logic_error(buffer.str());
+      }
+
+      binary_file.write((const char*)&row[0], (std::streamsize)(columns_number*sizeof(double)));
+
+      rows_number++;
+   }
+
+   binary_file.seekp(0, std::ios::beg);
+
+   write_header(binary_file, rows_number, columns_number);
+
+   if(!binary_file.good())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: BinaryDataFile class.\n"
+             << "void convert_text_data_file(const std::string&, const std::string&) method.\n"
+             << "Cannot write binary data file: " << binary_filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+}
+
+
+// void write_header(std::ostream&, const unsigned int&, const unsigned int&) method
+
+/// This method writes the header of a binary data file at the current position of a stream.
+/// @param stream Output stream.
+/// @param rows_number Number of rows in the data matrix.
+/// @param columns_number Number of columns in the data matrix.
+
+void BinaryDataFile::write_header(std::ostream& stream, const unsigned int& rows_number, const unsigned int& columns_number)
+{
+   char header[header_size];
+
+   memset(header, 0, header_size);
+
+   const uint64_t header_rows_number = rows_number;
+   const uint64_t header_columns_number = columns_number;
+
+   memcpy(header, binary_data_file_magic, sizeof(binary_data_file_magic));
+   memcpy(header + 8, &binary_data_file_version, sizeof(binary_data_file_version));
+   memcpy(header + 12, &binary_data_file_byte_order_mark, sizeof(binary_data_file_byte_order_mark));
+   memcpy(header + 16, &header_rows_number, sizeof(header_rows_number));
+   memcpy(header + 24, &header_columns_number, sizeof(header_columns_number));
+
+   stream.write(header, header_size);
+}
+
+}
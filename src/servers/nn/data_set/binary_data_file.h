@@ -0,0 +1,123 @@
+/****************************************************************************************************************/
+/*                                                                                                              */
+/*   OpenNN: Open Neural Networks Library                                                                       */
+/*   www.opennn.cimne.com                                                                                       */
+/*                                                                                                              */
+/*   B I N A R Y   D A T A   F I L E   C L A S S   H E A D E R                                                  */
+/*                                                                                                              */
+/*   Roberto Lopez                                                                                              */
+/*   International Center for Numerical Methods in Engineering (CIMNE)                                          */
+/*   Technical University of Catalonia (UPC)                                                                    */
+/*   Barcelona, Spain                                                                                           */
+/*   E-mail: rlopez@cimne.upc.edu                                                                               */
+/*                                                                                                              */
+/****************************************************************************************************************/
+
+#ifndef __BINARYDATAFILE_H__
+#define __BINARYDATAFILE_H__
+
+// System includes
+
+#include <string>
+
+// OpenNN includes
+
+#include "../utilities/matrix.h"
+
+namespace OpenNN
+{
+
+/// This class maps a binary data file into memory, so that its values can be used without parsing or copying them.
+/// A binary data file consists of a header of header_size bytes followed by the data matrix as row-major doubles
+/// in the byte order of the machine which wrote it.
+/// The mapping is private: values written through it are only seen by this process and never reach the file.
+
+class BinaryDataFile
+{
+
+public:
+
+   // DEFAULT CONSTRUCTOR
+
+   explicit BinaryDataFile(void);
+
+   // FILE CONSTRUCTOR
+
+   explicit BinaryDataFile(const std::string&);
+
+   // DESTRUCTOR
+
+   virtual ~BinaryDataFile(void);
+
+   // CONSTANTS
+
+   /// Size in bytes of the header which precedes the data values.
+
+   static const unsigned int header_size = 64;
+
+   // METHODS
+
+   void open(const std::string&);
+   void close(void);
+
+   bool is_open(void) const;
+
+   const std::string& get_filename(void) const;
+
+   const unsigned int& get_rows_number(void) const;
+   const unsigned int& get_columns_number(void) const;
+
+   double* get_data_pointer(void) const;
+   double* get_row_pointer(const unsigned int&) const;
+
+   // Static methods
+
+   static bool is_binary_data_file(const std::string&);
+
+   static void load_header(const std::string&, unsigned int&, unsigned int&);
+
+   static void save(const std::string&, const Matrix<double>&);
+   static void save(const std::string&, const Vector<double>&);
+
+   static void convert_text_data_file(const std::string&, const std::string&);
+
+private:
+
+   // COPY CONSTRUCTOR
+
+   BinaryDataFile(const BinaryDataFile&);
+
+   // ASSIGNMENT OPERATOR
+
+   BinaryDataFile& operator = (const BinaryDataFile&);
+
+   // PRIVATE METHODS
+
+   static void write_header(std::ostream&, const unsigned int&, const unsigned int&);
+
+   // MEMBERS
+
+   /// Name of the mapped file.
+
+   std::string filename;
+
+   /// Number of rows in the data matrix.
+
+   unsigned int rows_number;
+
+   /// Number of columns in the data matrix.
+
+   unsigned int columns_number;
+
+   /// Start of the mapping, or NULL if no file is open.
+
+   void* mapping_pointer;
+
+   /// Size in bytes of the mapping.
+
+   size_t mapping_size;
+};
+
+}
+
+#endif
@@ -428,6 +428,133 @@ Matrix<double> DataSet::arrange_training_target_data(void) const
 }
 
 
+// Matrix<double> arrange_training_input_data(const unsigned int&, const unsigned int&) const method
+
+/// This method returns a matrix with a block of consecutive training instances and the input variables.
+/// It is used to propagate several training instances at once through the neural network.
+/// @param first_training_instance_index Index of the first training instance in the block.
+/// @param block_instances_number Number of training instances in the block.
+
+Matrix<double> DataSet::arrange_training_input_data(const unsigned int& first_training_instance_index, const unsigned int& block_instances_number) const
+{
+   Matrix<double> block;
+
+   arrange_training_input_data(first_training_instance_index, block_instances_number, block);
+
+   return(block);
+}
+
+
+// void arrange_training_input_data(const unsigned int&, const unsigned int&, Matrix<double>&) const method
+
+/// This method writes a block of consecutive training instances and the input variables into a given matrix. 
+/// The storage of the matrix is reused if it already has the size of the block. 
+/// @param first_training_instance_index Index of the first training instance in the block.
+/// @param block_instances_number Number of training instances in the block.
+/// @param block Matrix to be set to the block, with one instance per row.
+
+void DataSet::arrange_training_input_data(const unsigned int& first_training_instance_index, const unsigned int& block_instances_number, Matrix<double>& block) const
+{
+   const Vector<unsigned int>& inputs_indices = variables_information.get_inputs_indices();
+
+   const Vector<unsigned int>& training_indices = instances_information.get_training_indices();
+
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   if(first_training_instance_index + block_instances_number > training_indices.size())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: DataSet class.\n"
+             << "void arrange_training_input_data(const unsigned int&, const unsigned int&, Matrix<double>&) const method.\n"
+             << "Block of training instances exceeds number of training instances.\n";
+
+	  throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   const unsigned int inputs_number = inputs_indices.size();
+
+   block.set(block_instances_number, inputs_number);
+
+   for(unsigned int i = 0; i < block_instances_number; i++)
+   {
+      const double* row = data[training_indices[first_training_instance_index+i]];
+
+      for(unsigned int j = 0; j < inputs_number; j++)
+      {
+         block[i][j] = row[inputs_indices[j]];
+      }
+   }
+}
+
+
+// Matrix<double> arrange_training_target_data(const unsigned int&, const unsigned int&) const method
+
+/// This method returns a matrix with a block of consecutive training instances and the target variables.
+/// @param first_training_instance_index Index of the first training instance in the block.
+/// @param block_instances_number Number of training instances in the block.
+
+Matrix<double> DataSet::arrange_training_target_data(const unsigned int& first_training_instance_index, const unsigned int& block_instances_number) const
+{
+   Matrix<double> block;
+
+   arrange_training_target_data(first_training_instance_index, block_instances_number, block);
+
+   return(block);
+}
+
+
+// void arrange_training_target_data(const unsigned int&, const unsigned int&, Matrix<double>&) const method
+
+/// This method writes a block of consecutive training instances and the target variables into a given matrix. 
+/// The storage of the matrix is reused if it already has the size of the block. 
+/// @param first_training_instance_index Index of the first training instance in the block.
+/// @param block_instances_number Number of training instances in the block.
+/// @param block Matrix to be set to the block, with one instance per row.
+
+void DataSet::arrange_training_target_data(const unsigned int& first_training_instance_index, const unsigned int& block_instances_number, Matrix<double>& block) const
+{
+   const Vector<unsigned int>& targets_indices = variables_information.get_targets_indices();
+
+   const Vector<unsigned int>& training_indices = instances_information.get_training_indices();
+
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   if(first_training_instance_index + block_instances_number > training_indices.size())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: DataSet class.\n"
+             << "void arrange_training_target_data(const unsigned int&, const unsigned int&, Matrix<double>&) const method.\n"
+             << "Block of training instances exceeds number of training instances.\n";
+
+	  throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   const unsigned int targets_number = targets_indices.size();
+
+   block.set(block_instances_number, targets_number);
+
+   for(unsigned int i = 0; i < block_instances_number; i++)
+   {
+      const double* row = data[training_indices[first_training_instance_index+i]];
+
+      for(unsigned int j = 0; j < targets_number; j++)
+      {
+         block[i][j] = row[targets_indices[j]];
+      }
+   }
+}
+
+
 // Matrix<double> get_generalization_input_data(void) const method
 
 /// This method returns a matrix with generalization instances and input variables.
@@ -889,6 +1016,173 @@ Vector<double> DataSet::get_testing_target_instance(const unsigned int& testing_
 }
 
 
+// InstanceView get_instance_view(const unsigned int&) const method
+
+/// This method returns a read-only view on the inputs and target values of a single instance, which does not copy them. 
+/// The view is valid as long as the data matrix is not resized or reloaded. 
+/// @param i Index of the instance. 
+
+InstanceView DataSet::get_instance_view(const unsigned int& i) const
+{
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   const unsigned int instances_number = get_instances_number();
+
+   if(i >= instances_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: DataSet class.\n"
+             << "InstanceView get_instance_view(const unsigned int&) const method.\n"
+             << "Index of instance must be less than number of instances.\n";
+
+	  throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   return(InstanceView(data[i], data.get_columns_number()));
+}
+
+
+// InstanceView get_input_instance_view(const unsigned int&) const method
+
+/// This method returns a read-only view on the input values of a single instance, which does not copy them. 
+/// The view is valid as long as neither the data matrix nor the variables information are modified. 
+/// @param instance_index Index of the instance. 
+
+InstanceView DataSet::get_input_instance_view(const unsigned int& instance_index) const
+{
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   const unsigned int instances_number = get_instances_number();
+
+   if(instance_index >= instances_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: DataSet class.\n"
+             << "InstanceView get_input_instance_view(const unsigned int&) const method.\n"
+             << "Index of instance must be less than number of instances.\n";
+
+	  throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   const Vector<unsigned int>& inputs_indices = variables_information.get_inputs_indices();
+
+   return(InstanceView(data[instance_index], inputs_indices));
+}
+
+
+// InstanceView get_target_instance_view(const unsigned int&) const method
+
+/// This method returns a read-only view on the target values of a single instance, which does not copy them. 
+/// The view is valid as long as neither the data matrix nor the variables information are modified. 
+/// @param instance_index Index of the instance. 
+
+InstanceView DataSet::get_target_instance_view(const unsigned int& instance_index) const
+{
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   const unsigned int instances_number = get_instances_number();
+
+   if(instance_index >= instances_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: DataSet class.\n"
+             << "InstanceView get_target_instance_view(const unsigned int&) const method.\n"
+             << "Index of instance must be less than number of instances.\n";
+
+	  throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   const Vector<unsigned int>& targets_indices = variables_information.get_targets_indices();
+
+   return(InstanceView(data[instance_index], targets_indices));
+}
+
+
+// InstanceView get_training_input_instance_view(const unsigned int&) const method
+
+/// This method returns a read-only view on the input values of a single training instance, which does not copy them. 
+/// The view is valid as long as neither the data matrix nor the variables information are modified. 
+/// @param training_instance_index Index of the training instance. 
+
+InstanceView DataSet::get_training_input_instance_view(const unsigned int& training_instance_index) const
+{
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   const unsigned int training_instances_number = instances_information.count_training_instances_number();  
+
+   if(training_instance_index >= training_instances_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: DataSet class.\n"
+             << "InstanceView get_training_input_instance_view(const unsigned int&) const method.\n"
+             << "Index of training instance (" << training_instance_index << ") must be less than number of training instances (" << training_instances_number << ").\n";
+
+	  throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   const Vector<unsigned int>& inputs_indices = variables_information.get_inputs_indices();
+
+   const Vector<unsigned int>& training_indices = instances_information.get_training_indices();
+
+   return(InstanceView(data[training_indices[training_instance_index]], inputs_indices));
+}
+
+
+// InstanceView get_training_target_instance_view(const unsigned int&) const method
+
+/// This method returns a read-only view on the target values of a single training instance, which does not copy them. 
+/// The view is valid as long as neither the data matrix nor the variables information are modified. 
+/// @param training_instance_index Index of the training instance. 
+
+InstanceView DataSet::get_training_target_instance_view(const unsigned int& training_instance_index) const
+{
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   const unsigned int training_instances_number = instances_information.count_training_instances_number();  
+
+   if(training_instance_index >= training_instances_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: DataSet class.\n"
+             << "InstanceView get_training_target_instance_view(const unsigned int&) const method.\n"
+             << "Index of training instance (" << training_instance_index << ") must be less than number of training instances (" << training_instances_number << ").\n";
+
+	  throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   const Vector<unsigned int>& targets_indices = variables_information.get_targets_indices();
+
+   const Vector<unsigned int>& training_indices = instances_information.get_training_indices();
+
+   return(InstanceView(data[training_indices[training_instance_index]], targets_indices));
+}
+
+
 // Vector<double> get_variable(const unsigned int&) const method
 
 /// This method returns all the instances of a single variable in the data set. 
@@ -3525,12 +3819,39 @@ void DataSet::save_data(const std::string& filename) const
 /// This method loads from a file the values of the data matrix. 
 /// The number of rows must be equal to the number of instances.
 /// The number of columns must be equal to the number of variables.
+/// A binary data file is mapped into memory instead of being read, so that its values are loaded on first access 
+/// and the data matrix refers to them without a copy. 
 
 void DataSet::load_data(const std::string& new_data_filename)
 {
    data_filename = new_data_filename;
 
-   data.load(data_filename);
+   data_stream.close();
+
+   if(BinaryDataFile::is_binary_data_file(data_filename))
+   {
+      // Drop any reference to the previous mapping before replacing it
+
+      data.set();
+
+      binary_data_file.open(data_filename);
+
+      const unsigned int rows_number = binary_data_file.get_rows_number();
+      const unsigned int columns_number = binary_data_file.get_columns_number();
+
+      if(rows_number != 0 && columns_number != 0)
+      {
+         data.set_external_data(rows_number, columns_number, binary_data_file.get_data_pointer());
+      }
+   }
+   else
+   {
+      data.set();
+
+      binary_data_file.close();
+
+      data.load(data_filename);
+   }
 
    unsigned int variables_number = data.get_columns_number();
 
@@ -3542,6 +3863,134 @@ void DataSet::load_data(const std::string& new_data_filename)
 }
 
 
+// void save_binary_data(const std::string&) const method
+
+/// This method saves the values of the data matrix to a binary data file, which load_data maps into memory. 
+/// It must not be the file the data are currently mapped from. 
+/// @param filename Name of binary data file. 
+
+void DataSet::save_binary_data(const std::string& filename) const
+{
+   BinaryDataFile::save(filename, data);
+}
+
+
+// bool is_data_mapped(void) const method
+
+/// This method returns true if the data matrix refers to the values of a binary data file mapped into memory, 
+/// and false otherwise. 
+
+bool DataSet::is_data_mapped(void) const
+{
+   return(data.has_external_data());
+}
+
+
+// void open_data_stream(const std::string&, const unsigned int&) method
+
+/// This method reads the data from a binary data file in chunks of consecutive instances, instead of loading all of them. 
+/// The data matrix holds one chunk at a time, and load_next_data_chunk replaces it with the next one, 
+/// which has been read on a background thread in the meantime. 
+/// All the instances of a chunk are training instances, so generalization must use a different data set. 
+/// The variables information is kept if the number of variables does not change. 
+/// @param new_data_filename Name of binary data file. 
+/// @param chunk_instances_number Number of instances in each chunk. 
+
+void DataSet::open_data_stream(const std::string& new_data_filename, const unsigned int& chunk_instances_number)
+{
+   data.set();
+
+   binary_data_file.close();
+
+   data_stream.open(new_data_filename, chunk_instances_number);
+
+   data_filename = new_data_filename;
+
+   const unsigned int variables_number = data_stream.get_variables_number();
+
+   if(variables_information.get_variables_number() != variables_number)
+   {
+      variables_information.set(variables_number);
+   }
+
+   load_next_data_chunk();
+}
+
+
+// void close_data_stream(void) method
+
+/// This method stops reading the data in chunks. 
+/// The data matrix keeps the last chunk. 
+
+void DataSet::close_data_stream(void)
+{
+   data_stream.close();
+}
+
+
+// bool is_data_streamed(void) const method
+
+/// This method returns true if the data are read from a binary data file in chunks, and false otherwise. 
+
+bool DataSet::is_data_streamed(void) const
+{
+   return(data_stream.is_open());
+}
+
+
+// DataStream* get_data_stream_pointer(void) method
+
+/// This method returns a pointer to the data stream, for instance to set its shuffling. 
+
+DataStream* DataSet::get_data_stream_pointer(void)
+{
+   return(&data_stream);
+}
+
+
+// void load_next_data_chunk(void) method
+
+/// This method replaces the data matrix with the next chunk of the data stream, 
+/// starting a new pass over the binary data file when the current one is finished. 
+/// All the instances of the chunk are set for training. 
+
+void DataSet::load_next_data_chunk(void)
+{
+   // Control sentence
+
+   if(!data_stream.is_open())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: DataSet class.\n"
+             << "void load_next_data_chunk(void) method.\n"
+             << "Data stream is not open.\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   if(!data_stream.read_chunk(data))
+   {
+      data_stream.rewind();
+
+      if(!data_stream.read_chunk(data))
+      {
+         std::ostringstream buffer;
+
+         buffer << "OpenNN Exception: DataSet class.\n"
+                << "void load_next_data_chunk(void) method.\n"
+                << "Data stream has no instances.\n";
+
+         throw std::logic_error(buffer.str());
+      }
+   }
+
+   const unsigned int instances_number = data.get_rows_number();
+
+   instances_information.set_instances_number(instances_number);
+}
+
+
 // Vector<int> calculate_target_class_distribution(void) const method
 
 /// This method returns a vector containing the number of instances of each class in the data set.
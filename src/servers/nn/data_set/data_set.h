@@ -27,6 +27,9 @@
 
 #include "variables_information.h"
 #include "instances_information.h"
+#include "binary_data_file.h"
+#include "data_stream.h"
+#include "instance_view.h"
 
 // TinyXml includes
 
@@ -131,6 +134,10 @@ public:
 
    Matrix<double> arrange_training_input_data(void) const;
    Matrix<double> arrange_training_target_data(void) const;  
+   Matrix<double> arrange_training_input_data(const unsigned int&, const unsigned int&) const;
+   Matrix<double> arrange_training_target_data(const unsigned int&, const unsigned int&) const;  
+   void arrange_training_input_data(const unsigned int&, const unsigned int&, Matrix<double>&) const;
+   void arrange_training_target_data(const unsigned int&, const unsigned int&, Matrix<double>&) const;
    Matrix<double> get_generalization_input_data(void) const;
    Matrix<double> get_generalization_target_data(void) const;
    Matrix<double> arrange_testing_input_data(void) const;
@@ -156,6 +163,16 @@ public:
    Vector<double> get_testing_input_instance(const unsigned int&) const;
    Vector<double> get_testing_target_instance(const unsigned int&) const;
 
+   // Instance view methods
+
+   InstanceView get_instance_view(const unsigned int&) const;
+
+   InstanceView get_input_instance_view(const unsigned int&) const;
+   InstanceView get_target_instance_view(const unsigned int&) const;
+
+   InstanceView get_training_input_instance_view(const unsigned int&) const;
+   InstanceView get_training_target_instance_view(const unsigned int&) const;
+
    // Variable methods
 
    Vector<double> get_variable(const unsigned int&) const;
@@ -334,6 +351,21 @@ public:
    void save_data(const std::string&) const;
    void load_data(const std::string&);
 
+   void save_binary_data(const std::string&) const;
+
+   bool is_data_mapped(void) const;
+
+   // Data stream methods
+
+   void open_data_stream(const std::string&, const unsigned int&);
+   void close_data_stream(void);
+
+   bool is_data_streamed(void) const;
+
+   DataStream* get_data_stream_pointer(void);
+
+   void load_next_data_chunk(void);
+
    // Task methods
 
 //   TiXmlElement* report_data_XML(void) const;
@@ -365,6 +397,16 @@ private:
 
    //unsigned int header_lines_number;
 
+   /// Binary data file mapped into memory, if the data were loaded from one. 
+   /// The data matrix then refers to the mapped values instead of owning a copy of them.
+
+   BinaryDataFile binary_data_file;
+
+   /// Data stream on a binary data file, if the data are read in chunks. 
+   /// The data matrix then holds the current chunk only.
+
+   DataStream data_stream;
+
    /// Data Matrix.
 
    Matrix<double> data;
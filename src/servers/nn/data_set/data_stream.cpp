@@ -0,0 +1,389 @@
+/****************************************************************************************************************/
+/*                                                                                                              */
+/*   OpenNN: Open Neural Networks Library                                                                       */
+/*   www.opennn.cimne.com                                                                                       */
+/*                                                                                                              */
+/*   D A T A   S T R E A M   C L A S S                                                                          */
+/*                                                                                                              */
+/*   Roberto Lopez                                                                                              */
+/*   International Center for Numerical Methods in Engineering (CIMNE)                                          */
+/*   Technical University of Catalonia (UPC)                                                                    */
+/*   Barcelona, Spain                                                                                           */
+/*   E-mail: rlopez@cimne.upc.edu                                                                               */
+/*                                                                                                              */
+/****************************************************************************************************************/
+
+// System includes
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <stdexcept>
+#include <exception>
+
+// OpenNN includes
+
+#include "data_stream.h"
+#include "binary_data_file.h"
+
+namespace OpenNN
+{
+
+// DEFAULT CONSTRUCTOR
+
+/// Default constructor. It creates a data stream which is not associated to any file.
+
+DataStream::DataStream(void)
+{
+   instances_number = 0;
+   variables_number = 0;
+   chunk_instances_number = 0;
+
+   shuffle = true;
+
+   chunk_position = 0;
+}
+
+
+// FILE CONSTRUCTOR
+
+/// File constructor. It creates a data stream on a binary data file and starts reading its first chunk.
+/// @param new_filename Name of binary data file.
+/// @param new_chunk_instances_number Number of instances in each chunk.
+
+DataStream::DataStream(const std::string& new_filename, const unsigned int& new_chunk_instances_number)
+{
+   instances_number = 0;
+   variables_number = 0;
+   chunk_instances_number = 0;
+
+   shuffle = true;
+
+   chunk_position = 0;
+
+   open(new_filename, new_chunk_instances_number);
+}
+
+
+// DESTRUCTOR
+
+/// Destructor. It waits for the prefetch task, if any, and closes the file.
+
+DataStream::~DataStream(void)
+{
+   close();
+}
+
+
+// METHODS
+
+// void open(const std::string&, const unsigned int&) method
+
+/// This method associates the data stream to a binary data file, closing the previous one,
+/// and starts reading the first chunk of a pass over the file.
+/// @param new_filename Name of binary data file.
+/// @param new_chunk_instances_number Number of instances in each chunk.
+/// It bounds the memory used by the stream, which holds at most two chunks.
+
+void DataStream::open(const std::string& new_filename, const unsigned int& new_chunk_instances_number)
+{
+   // Control sentence
+
+   if(new_chunk_instances_number == 0)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: DataStream class.\n"
+             << "void open(const std::string&, const unsigned int&) method.\n"
+             << "Number of instances in each chunk must be greater than zero.\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   close();
+
+   BinaryDataFile::load_header(new_filename, instances_number, variables_number);
+
+   file.open(new_filename.c_str(), std::ios::binary);
+
+   if(!file.is_open())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: DataStream class.\n"
+             << "void open(const std::string&, const unsigned int&) method.\n"
+             << "Cannot open binary data file: " << new_filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   filename = new_filename;
+
+   chunk_instances_number = std::min(new_chunk_instances_number, std::max(instances_number, 1u));
+
+   chunks_order.set(count_chunks_number());
+   chunks_order.initialize_sequential();
+
+   rewind();
+}
+
+
+// void close(void) method
+
+/// This method waits for the prefetch task, if any, and dissociates the data stream from its file.
+
+void DataStream::close(void)
+{
+   if(prefetch_future.valid())
+   {
+      prefetch_future.wait();
+      prefetch_future = std::future<void>();
+   }
+
+   if(file.is_open())
+   {
+      file.close();
+   }
+
+   file.clear();
+
+   filename.clear();
+
+   instances_number = 0;
+   variables_number = 0;
+   chunk_instances_number = 0;
+
+   chunks_order.set();
+   chunk_position = 0;
+
+   prefetched_chunk.set();
+}
+
+
+// bool is_open(void) const method
+
+/// This method returns true if the data stream is associated to a binary data file, and false otherwise.
+
+bool DataStream::is_open(void) const
+{
+   return(file.is_open());
+}
+
+
+// const std::string& get_filename(void) const method
+
+/// This method returns the name of the binary data file, or an empty string if the stream is not open.
+
+const std::string& DataStream::get_filename(void) const
+{
+   return(filename);
+}
+
+
+// const unsigned int& get_instances_number(void) const method
+
+/// This method returns the number of instances in the binary data file.
+
+const unsigned int& DataStream::get_instances_number(void) const
+{
+   return(instances_number);
+}
+
+
+// const unsigned int& get_variables_number(void) const method
+
+/// This method returns the number of variables in the binary data file.
+
+const unsigned int& DataStream::get_variables_number(void) const
+{
+   return(variables_number);
+}
+
+
+// const unsigned int& get_chunk_instances_number(void) const method
+
+/// This method returns the number of instances in each chunk.
+/// The last chunk of the file can be smaller.
+
+const unsigned int& DataStream::get_chunk_instances_number(void) const
+{
+   return(chunk_instances_number);
+}
+
+
+// unsigned int count_chunks_number(void) const method
+
+/// This method returns the number of chunks in a pass over the binary data file.
+
+unsigned int DataStream::count_chunks_number(void) const
+{
+   if(chunk_instances_number == 0)
+   {
+      return(0);
+   }
+
+   return((instances_number + chunk_instances_number - 1)/chunk_instances_number);
+}
+
+
+// const bool& get_shuffle(void) const method
+
+/// This method returns true if chunks and instances are read in a random order, and false otherwise.
+
+const bool& DataStream::get_shuffle(void) const
+{
+   return(shuffle);
+}
+
+
+// void set_shuffle(const bool&) method
+
+/// This method sets whether chunks and instances are read in a random order or in file order.
+/// It takes effect from the next pass over the file.
+/// @param new_shuffle True to shuffle, false to read in file order.
+
+void DataStream::set_shuffle(const bool& new_shuffle)
+{
+   shuffle = new_shuffle;
+}
+
+
+// void set_seed(const unsigned int&) method
+
+/// This method seeds the random number generator used for shuffling.
+/// It takes effect from the next pass over the file.
+/// @param new_seed Seed.
+
+void DataStream::set_seed(const unsigned int& new_seed)
+{
+   finish_prefetch();
+
+   random_generator.seed(new_seed);
+}
+
+
+// void rewind(void) method
+
+/// This method starts a new pass over the binary data file.
+/// It discards the rest of the current pass, draws a new order of the chunks and starts reading the first one.
+
+void DataStream::rewind(void)
+{
+   finish_prefetch();
+
+   chunks_order.initialize_sequential();
+
+   if(shuffle)
+   {
+      std::shuffle(chunks_order.begin(), chunks_order.end(), random_generator);
+   }
+
+   chunk_position = 0;
+
+   start_prefetch();
+}
+
+
+// bool read_chunk(Matrix<double>&) method
+
+/// This method returns the next chunk of the current pass and starts reading the following one on a background thread.
+/// It returns false, leaving the matrix unchanged, once all the chunks of the pass have been read.
+/// Errors in reading the file are thrown by this method.
+/// @param chunk Matrix whose rows are set to the instances of the chunk.
+
+bool DataStream::read_chunk(Matrix<double>& chunk)
+{
+   if(!prefetch_future.valid())
+   {
+      return(false);
+   }
+
+   prefetch_future.get();
+
+   chunk = prefetched_chunk;
+
+   chunk_position++;
+
+   start_prefetch();
+
+   return(true);
+}
+
+
+// void start_prefetch(void) method
+
+/// This method starts reading the chunk at the current position of the pass on a background thread,
+/// unless the pass is finished.
+
+void DataStream::start_prefetch(void)
+{
+   if(chunk_position < chunks_order.size())
+   {
+      prefetch_future = std::async(std::launch::async, &DataStream::load_chunk, this, chunks_order[chunk_position]);
+   }
+}
+
+
+// void finish_prefetch(void) method
+
+/// This method waits for the prefetch task, if any, and discards its chunk.
+
+void DataStream::finish_prefetch(void)
+{
+   if(prefetch_future.valid())
+   {
+      prefetch_future.wait();
+      prefetch_future = std::future<void>();
+   }
+}
+
+
+// void load_chunk(const unsigned int&) method
+
+/// This method reads a chunk of the binary data file into the prefetched chunk matrix,
+/// shuffling its instances if requested.
+/// It runs on the prefetch thread, which is the only user of the file and the random number generator while it runs.
+/// @param chunk_index Index of the chunk in the file.
+
+void DataStream::load_chunk(const unsigned int& chunk_index)
+{
+   const unsigned int first_instance = chunk_index*chunk_instances_number;
+   const unsigned int chunk_size = std::min(chunk_instances_number, instances_number - first_instance);
+
+   prefetched_chunk.set(chunk_size, variables_number);
+
+   const std::streamoff offset = (std::streamoff)BinaryDataFile::header_size
+                               + (std::streamoff)first_instance*variables_number*sizeof(double);
+
+   file.clear();
+   file.seekg(offset, std::ios::beg);
+   file.read((char*)prefetched_chunk[0], (std::streamsize)chunk_size*variables_number*sizeof(double));
+
+   if(!file)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: DataStream class.\n"
+             << "void load_chunk(const unsigned int&) method.\n"
+             << "Cannot read chunk " << chunk_index << " of binary data file: " << filename << "\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   if(shuffle)
+   {
+      for(unsigned int i = chunk_size; i > 1; i--)
+      {
+         const unsigned int j = std::uniform_int_distribution<unsigned int>(0, i-1)(random_generator);
+
+         if(j != i-1)
+         {
+            std::swap_ranges(prefetched_chunk[i-1], prefetched_chunk[i-1] + variables_number, prefetched_chunk[j]);
+         }
+      }
+   }
+}
+
+}
@@ -0,0 +1,152 @@
+/****************************************************************************************************************/
+/*                                                                                                              */
+/*   OpenNN: Open Neural Networks Library                                                                       */
+/*   www.opennn.cimne.com                                                                                       */
+/*                                                                                                              */
+/*   D A T A   S T R E A M   C L A S S   H E A D E R                                                            */
+/*                                                                                                              */
+/*   Roberto Lopez                                                                                              */
+/*   International Center for Numerical Methods in Engineering (CIMNE)                                          */
+/*   Technical University of Catalonia (UPC)                                                                    */
+/*   Barcelona, Spain                                                                                           */
+/*   E-mail: rlopez@cimne.upc.edu                                                                               */
+/*                                                                                                              */
+/****************************************************************************************************************/
+
+#ifndef __DATASTREAM_H__
+#define __DATASTREAM_H__
+
+// System includes
+
+#include <fstream>
+#include <future>
+#include <random>
+#include <string>
+
+// OpenNN includes
+
+#include "../utilities/vector.h"
+#include "../utilities/matrix.h"
+
+namespace OpenNN
+{
+
+/// This class reads the data matrix of a binary data file in chunks of consecutive instances,
+/// so that data sets larger than the available memory can be used for training.
+/// Each pass over the file visits the chunks in a random order and shuffles the instances inside every chunk.
+/// While a chunk is being used, the next one is read on a background thread.
+
+class DataStream
+{
+
+public:
+
+   // DEFAULT CONSTRUCTOR
+
+   explicit DataStream(void);
+
+   // FILE CONSTRUCTOR
+
+   explicit DataStream(const std::string&, const unsigned int&);
+
+   // DESTRUCTOR
+
+   virtual ~DataStream(void);
+
+   // METHODS
+
+   void open(const std::string&, const unsigned int&);
+   void close(void);
+
+   bool is_open(void) const;
+
+   // Get methods
+
+   const std::string& get_filename(void) const;
+
+   const unsigned int& get_instances_number(void) const;
+   const unsigned int& get_variables_number(void) const;
+   const unsigned int& get_chunk_instances_number(void) const;
+
+   unsigned int count_chunks_number(void) const;
+
+   const bool& get_shuffle(void) const;
+
+   // Set methods
+
+   void set_shuffle(const bool&);
+   void set_seed(const unsigned int&);
+
+   // Reading methods
+
+   void rewind(void);
+
+   bool read_chunk(Matrix<double>&);
+
+private:
+
+   // COPY CONSTRUCTOR
+
+   DataStream(const DataStream&);
+
+   // ASSIGNMENT OPERATOR
+
+   DataStream& operator = (const DataStream&);
+
+   // PRIVATE METHODS
+
+   void start_prefetch(void);
+   void finish_prefetch(void);
+
+   void load_chunk(const unsigned int&);
+
+   // MEMBERS
+
+   /// Name of the binary data file.
+
+   std::string filename;
+
+   /// Binary data file, which is only read by the prefetch task.
+
+   std::ifstream file;
+
+   /// Number of instances in the file.
+
+   unsigned int instances_number;
+
+   /// Number of variables in the file.
+
+   unsigned int variables_number;
+
+   /// Number of instances in each chunk, except maybe the last one.
+
+   unsigned int chunk_instances_number;
+
+   /// True if chunks and instances are read in a random order, false if they are read in file order.
+
+   bool shuffle;
+
+   /// Random number generator for shuffling, so that a given seed always gives the same order.
+
+   std::mt19937 random_generator;
+
+   /// Order in which the chunks are read in the current pass.
+
+   Vector<unsigned int> chunks_order;
+
+   /// Position in chunks_order of the chunk being prefetched.
+
+   unsigned int chunk_position;
+
+   /// Chunk read by the prefetch task.
+
+   Matrix<double> prefetched_chunk;
+
+   /// Completion of the prefetch task, which is invalid if no chunk is being prefetched.
+
+   std::future<void> prefetch_future;
+};
+
+}
+
+#endif
@@ -0,0 +1,157 @@
+/****************************************************************************************************************/
+/*                                                                                                              */
+/*   OpenNN: Open Neural Networks Library                                                                       */
+/*   www.opennn.cimne.com                                                                                       */
+/*                                                                                                              */
+/*   I N S T A N C E   V I E W   C L A S S   H E A D E R                                                        */
+/*                                                                                                              */
+/*   Roberto Lopez                                                                                              */
+/*   International Center for Numerical Methods in Engineering (CIMNE)                                          */
+/*   Technical University of Catalonia (UPC)                                                                    */
+/*   Barcelona, Spain                                                                                           */
+/*   E-mail: rlopez@cimne.upc.edu                                                                               */
+/*                                                                                                              */
+/****************************************************************************************************************/
+
+#ifndef __INSTANCEVIEW_H__
+#define __INSTANCEVIEW_H__
+
+// OpenNN includes
+
+#include "../utilities/vector.h"
+
+namespace OpenNN
+{
+
+/// This class is a read-only view on the values of an instance, which refers to the data of a data set instead of copying it.
+/// It either spans a whole row of the data matrix or selects some of its columns through a vector of indices.
+/// A view is only valid as long as the data matrix and, if used, the indices vector are not modified.
+
+class InstanceView
+{
+
+public:
+
+   // DEFAULT CONSTRUCTOR
+
+   /// Default constructor. It creates an empty view.
+
+   explicit InstanceView(void)
+   {
+      row_pointer = NULL;
+      indices_pointer = NULL;
+      size = 0;
+   }
+
+
+   // ROW CONSTRUCTOR
+
+   /// Row constructor. It creates a view on a number of contiguous values.
+   /// @param new_row_pointer Pointer to the first value.
+   /// @param new_size Number of values.
+
+   explicit InstanceView(const double* new_row_pointer, const unsigned int& new_size)
+   {
+      row_pointer = new_row_pointer;
+      indices_pointer = NULL;
+      size = new_size;
+   }
+
+
+   // INDICES CONSTRUCTOR
+
+   /// Indices constructor. It creates a view on some values of a row.
+   /// @param new_row_pointer Pointer to the first value of the row.
+   /// @param new_indices Indices of the values in the row. The vector is referred to, not copied.
+
+   explicit InstanceView(const double* new_row_pointer, const Vector<unsigned int>& new_indices)
+   {
+      row_pointer = new_row_pointer;
+      indices_pointer = &new_indices;
+      size = new_indices.size();
+   }
+
+
+   // const double& operator [] (const unsigned int&) const method
+
+   /// Reference operator.
+   /// @param i Index of value in the view.
+
+   inline const double& operator [] (const unsigned int& i) const
+   {
+      if(indices_pointer == NULL)
+      {
+         return(row_pointer[i]);
+      }
+      else
+      {
+         return(row_pointer[(*indices_pointer)[i]]);
+      }
+   }
+
+
+   // const unsigned int& get_size(void) const method
+
+   /// This method returns the number of values in the view.
+
+   const unsigned int& get_size(void) const
+   {
+      return(size);
+   }
+
+
+   // bool is_contiguous(void) const method
+
+   /// This method returns true if the values of the view are contiguous in memory, and false otherwise.
+
+   bool is_contiguous(void) const
+   {
+      return(indices_pointer == NULL);
+   }
+
+
+   // const double* get_row_pointer(void) const method
+
+   /// This method returns a pointer to the row of the data matrix this view refers to.
+
+   const double* get_row_pointer(void) const
+   {
+      return(row_pointer);
+   }
+
+
+   // Vector<double> arrange_vector(void) const method
+
+   /// This method returns a copy of the values of the view.
+
+   Vector<double> arrange_vector(void) const
+   {
+      Vector<double> vector(size);
+
+      for(unsigned int i = 0; i < size; i++)
+      {
+         vector[i] = (*this)[i];
+      }
+
+      return(vector);
+   }
+
+
+private:
+
+   /// Pointer to the row of the data matrix.
+
+   const double* row_pointer;
+
+   /// Indices of the values of the view in the row, or NULL if the view spans the row.
+
+   const Vector<unsigned int>* indices_pointer;
+
+   /// Number of values in the view.
+
+   unsigned int size;
+};
+
+}
+
+#endif
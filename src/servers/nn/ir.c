@@ -0,0 +1,839 @@
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "mzcc.h"
+
+/*
+ * Lowers the AST of a function into the IR of ir.h.
+ *
+ * Scalar locals and parameters whose address is never taken live in virtual
+ * registers; arrays, structs and addressed variables live in the frame.
+ * Functions using floating point values or whole structs are not lowered, so
+ * the caller falls back to the stack machine of codegen_x64.c for them.
+ */
+
+typedef struct {
+    Ast *var;
+    int vreg; /* -1 when the variable lives in the frame */
+    int off;
+} VarInfo;
+
+static IRFunc *fn;
+static VarInfo *vars;
+static int nvars;
+static bool *temps; /* vregs defined exactly once, by the last use of them */
+static jmp_buf unsupported_jmp;
+static char *unsupported_reason;
+static List *addressed;
+static Ctype *rettype;
+
+static void unsupported(char *fmt, ...)
+{
+    String s = make_string();
+    va_list args;
+    va_start(args, fmt);
+    char buf[256];
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    string_appendf(&s, "%s", buf);
+    unsupported_reason = s.body;
+    longjmp(unsupported_jmp, 1);
+}
+
+/* Hands [message] over to the caller if it asked for it. */
+static void set_error(char **err, char *message)
+{
+    if (err)
+        *err = message;
+    else
+        free(message);
+}
+
+static int align8(int n)
+{
+    return (n + 7) & ~7;
+}
+
+static IRInst *emit_inst(int op, int size, int dst, int src0, int src1)
+{
+    if (fn->ninsts == fn->nalloc) {
+        fn->nalloc = fn->nalloc ? fn->nalloc * 2 : 64;
+        fn->insts = realloc(fn->insts, fn->nalloc * sizeof(IRInst));
+    }
+    IRInst *inst = &fn->insts[fn->ninsts++];
+    memset(inst, 0, sizeof(IRInst));
+    inst->op = op;
+    inst->size = size;
+    inst->dst = dst;
+    inst->src[0] = src0;
+    inst->src[1] = src1;
+    inst->index = -1;
+    return inst;
+}
+
+static int new_vreg(bool temp)
+{
+    temps = realloc(temps, (fn->nvregs + 1) * sizeof(bool));
+    temps[fn->nvregs] = temp;
+    return fn->nvregs++;
+}
+
+static int new_label(void)
+{
+    return fn->nlabels++;
+}
+
+static int emit_op(int op, int size, int src0, int src1, long imm)
+{
+    int dst = new_vreg(true);
+    emit_inst(op, size, dst, src0, src1)->imm = imm;
+    return dst;
+}
+
+static int emit_imm(long val)
+{
+    return emit_op(IR_IMM, 8, -1, -1, val);
+}
+
+static void emit_label(int label)
+{
+    emit_inst(IR_LABEL, 0, -1, -1, -1)->label = label;
+}
+
+static void emit_jump(int op, int size, int src0, int src1, long imm, int label)
+{
+    IRInst *inst = emit_inst(op, size, -1, src0, src1);
+    inst->imm = imm;
+    inst->label = label;
+}
+
+static bool is_simple_type(Ctype *ctype)
+{
+    return is_inttype(ctype) || ctype->type == CTYPE_PTR;
+}
+
+static void check_type(Ctype *ctype)
+{
+    if (ctype && is_flotype(ctype))
+        unsupported("floating point values");
+}
+
+static VarInfo *find_var(Ast *var)
+{
+    for (int i = 0; i < nvars; i++)
+        if (vars[i].var == var)
+            return &vars[i];
+    return NULL;
+}
+
+static bool is_addressed(Ast *var)
+{
+    for (Iter i = list_iter(addressed); !iter_end(i);)
+        if (iter_next(&i) == var)
+            return true;
+    return false;
+}
+
+static VarInfo *add_var(Ast *var)
+{
+    check_type(var->ctype);
+    vars = realloc(vars, (nvars + 1) * sizeof(VarInfo));
+    VarInfo *v = &vars[nvars++];
+    v->var = var;
+    if (is_simple_type(var->ctype) && !is_addressed(var)) {
+        v->vreg = new_vreg(false);
+        v->off = 0;
+    } else {
+        if (var->ctype->size < 0)
+            unsupported("incomplete type of %s", var->varname);
+        v->vreg = -1;
+        fn->frame_size += align8(var->ctype->size);
+        v->off = -fn->frame_size;
+    }
+    return v;
+}
+
+static void find_addressed(Ast *ast)
+{
+    if (!ast)
+        return;
+    switch (ast->type) {
+    case AST_LITERAL:
+    case AST_STRING:
+    case AST_LVAR:
+    case AST_GVAR:
+        return;
+    case AST_FUNCALL:
+        for (Iter i = list_iter(ast->args); !iter_end(i);)
+            find_addressed(iter_next(&i));
+        return;
+    case AST_DECL:
+        find_addressed(ast->declinit);
+        return;
+    case AST_ARRAY_INIT:
+        for (Iter i = list_iter(ast->arrayinit); !iter_end(i);)
+            find_addressed(iter_next(&i));
+        return;
+    case AST_ADDR:
+        if (ast->operand->type == AST_LVAR)
+            list_push(addressed, ast->operand);
+        find_addressed(ast->operand);
+        return;
+    case AST_IF:
+    case AST_TERNARY:
+        find_addressed(ast->cond);
+        find_addressed(ast->then);
+        find_addressed(ast->els);
+        return;
+    case AST_FOR:
+        find_addressed(ast->forinit);
+        find_addressed(ast->forcond);
+        find_addressed(ast->forstep);
+        find_addressed(ast->forbody);
+        return;
+    case AST_RETURN:
+        find_addressed(ast->retval);
+        return;
+    case AST_COMPOUND_STMT:
+        for (Iter i = list_iter(ast->stmts); !iter_end(i);)
+            find_addressed(iter_next(&i));
+        return;
+    case AST_STRUCT_REF:
+        find_addressed(ast->struc);
+        return;
+    case AST_DEREF:
+    case PUNCT_INC:
+    case PUNCT_DEC:
+    case '!':
+        find_addressed(ast->operand);
+        return;
+    default:
+        find_addressed(ast->left);
+        find_addressed(ast->right);
+    }
+}
+
+static int lower_expr(Ast *ast);
+static void lower_branch(Ast *ast, int label, bool jump_if);
+
+/* Values of char and int type are only valid in the low 32 bits of their
+ * virtual register, so they are sign extended when used as 64 bits. */
+static int lower_conv(int v, Ctype *from, int size)
+{
+    if (fn->ninsts && fn->insts[fn->ninsts - 1].dst == v &&
+        fn->insts[fn->ninsts - 1].op == IR_IMM)
+        return v; /* literals are exact */
+    if (size == 8 && (from->type == CTYPE_CHAR || from->type == CTYPE_INT))
+        return emit_op(IR_SEXT, 4, v, -1, 0);
+    return v;
+}
+
+static int op_size(Ctype *ctype)
+{
+    if (ctype->type == CTYPE_ARRAY)
+        return 8;
+    return (ctype->size == 8) ? 8 : 4;
+}
+
+static bool is_imm_literal(Ast *ast)
+{
+    return ast->type == AST_LITERAL && is_inttype(ast->ctype) &&
+           ast->ival == (int) ast->ival;
+}
+
+typedef struct {
+    int base; /* -1 for the frame */
+    long off;
+    int index; /* -1 without index */
+    int scale;
+} Addr;
+
+static Addr frame_addr(long off)
+{
+    return (Addr){-1, off, -1, 0};
+}
+
+static Addr base_addr(int base, long off)
+{
+    return (Addr){base, off, -1, 0};
+}
+
+static Addr lower_addr(Ast *ast)
+{
+    switch (ast->type) {
+    case AST_LVAR: {
+        VarInfo *v = find_var(ast);
+        if (!v || v->vreg >= 0)
+            unsupported("address of %s", ast->varname);
+        return frame_addr(v->off);
+    }
+    case AST_GVAR: {
+        int dst = new_vreg(true);
+        emit_inst(IR_GADDR, 8, dst, -1, -1)->sym = ast->glabel;
+        return base_addr(dst, 0);
+    }
+    case AST_DEREF: {
+        /* p[i] indexes p in the addressing mode. */
+        Ast *op = ast->operand;
+        if (op->type == '+' && op->ctype->type == CTYPE_PTR &&
+            !is_imm_literal(op->right)) {
+            int scale = op->ctype->ptr->size;
+            if (scale == 1 || scale == 2 || scale == 4 || scale == 8) {
+                check_type(op->right->ctype);
+                int base = lower_expr(op->left);
+                int index =
+                    lower_conv(lower_expr(op->right), op->right->ctype, 8);
+                return (Addr){base, 0, index, scale};
+            }
+        }
+        return base_addr(lower_expr(op), 0);
+    }
+    case AST_STRUCT_REF: {
+        Addr addr = lower_addr(ast->struc);
+        addr.off += ast->ctype->offset;
+        return addr;
+    }
+    default:
+        unsupported("address of %s", ast_to_string(ast));
+        return frame_addr(0); /* non-reachable */
+    }
+}
+
+static int addr_value(Addr addr)
+{
+    if (addr.index >= 0) {
+        int index = addr.index;
+        if (addr.scale > 1)
+            index = emit_op(IR_MUL, 8, index, -1, addr.scale);
+        addr = base_addr(emit_op(IR_ADD, 8, addr.base, index, 0), addr.off);
+    }
+    if (addr.base < 0)
+        return emit_op(IR_LADDR, 8, -1, -1, addr.off);
+    if (addr.off)
+        return emit_op(IR_ADD, 8, addr.base, -1, addr.off);
+    return addr.base;
+}
+
+static int lower_load(Addr addr, Ctype *ctype)
+{
+    if (ctype->type == CTYPE_ARRAY)
+        return addr_value(addr);
+    if (ctype->type == CTYPE_STRUCT)
+        unsupported("struct values");
+    check_type(ctype);
+    int dst = emit_op(IR_LOAD, ctype->size, addr.base, -1, addr.off);
+    IRInst *inst = &fn->insts[fn->ninsts - 1];
+    inst->index = addr.index;
+    inst->scale = addr.scale;
+    return dst;
+}
+
+static void lower_store(Addr addr, Ctype *ctype, int v)
+{
+    if (!is_simple_type(ctype))
+        unsupported("assignment of %s", ctype_to_string(ctype));
+    IRInst *inst = emit_inst(IR_STORE, ctype->size, -1, addr.base, v);
+    inst->imm = addr.off;
+    inst->index = addr.index;
+    inst->scale = addr.scale;
+}
+
+static int lower_assign(Ast *var, int v, Ctype *vtype)
+{
+    check_type(vtype);
+    if (var->type == AST_LVAR) {
+        VarInfo *info = find_var(var);
+        if (info && info->vreg >= 0) {
+            int dst = info->vreg;
+            if (var->ctype->type == CTYPE_CHAR) {
+                emit_inst(IR_SEXT, 1, dst, v, -1);
+                return dst;
+            }
+            v = lower_conv(v, vtype, op_size(var->ctype));
+            IRInst *last = &fn->insts[fn->ninsts - 1];
+            if (temps[v] && last->dst == v) {
+                /* Compute straight into the variable. */
+                last->dst = dst;
+                return dst;
+            }
+            emit_inst(IR_MOV, 8, dst, v, -1);
+            return dst;
+        }
+    }
+    v = lower_conv(v, vtype, op_size(var->ctype));
+    lower_store(lower_addr(var), var->ctype, v);
+    return v;
+}
+
+static void lower_decl(Ast *ast)
+{
+    Ast *var = ast->declvar;
+    VarInfo *v = add_var(var);
+    Ast *init = ast->declinit;
+    if (!init)
+        return;
+    if (init->type == AST_ARRAY_INIT) {
+        Ctype *elem = var->ctype->ptr;
+        int off = 0;
+        for (Iter i = list_iter(init->arrayinit); !iter_end(i);) {
+            Ast *e = iter_next(&i);
+            int val = lower_conv(lower_expr(e), e->ctype, op_size(elem));
+            lower_store(frame_addr(v->off + off), elem, val);
+            off += elem->size;
+        }
+    } else if (var->ctype->type == CTYPE_ARRAY) {
+        assert(init->type == AST_STRING);
+        for (int i = 0; i <= (int) strlen(init->sval); i++) {
+            IRInst *inst = emit_inst(IR_STORE, 1, -1, -1, -1);
+            inst->imm = v->off + i;
+            inst->imm2 = init->sval[i];
+        }
+    } else {
+        lower_assign(var, lower_expr(init), init->ctype);
+    }
+}
+
+static int lower_binop(Ast *ast)
+{
+    check_type(ast->ctype);
+    check_type(ast->left->ctype);
+    check_type(ast->right->ctype);
+    Ctype *ctype = ast->ctype;
+    int size = op_size(ctype);
+    int op;
+    switch (ast->type) {
+    case '+':
+        op = IR_ADD;
+        break;
+    case '-':
+        op = IR_SUB;
+        break;
+    case '*':
+        op = IR_MUL;
+        break;
+    case '/':
+        op = IR_DIV;
+        break;
+    case '&':
+        op = IR_AND;
+        break;
+    case '|':
+        op = IR_OR;
+        break;
+    case PUNCT_LSHIFT:
+        op = IR_SHL;
+        break;
+    case PUNCT_RSHIFT:
+        op = IR_SAR;
+        break;
+    case PUNCT_EQ:
+        op = IR_EQ;
+        break;
+    case '<':
+        op = IR_LT;
+        break;
+    case '>':
+        op = IR_GT;
+        break;
+    default:
+        unsupported("operator %s", ast_to_string(ast));
+        return -1; /* non-reachable */
+    }
+    Ast *left = ast->left;
+    Ast *right = ast->right;
+    if (ctype->type == CTYPE_PTR && (op == IR_ADD || op == IR_SUB)) {
+        int ptr = lower_expr(left);
+        int scale = ctype->ptr->size;
+        if (is_imm_literal(right) && right->ival * scale == (int) (right->ival * scale))
+            return emit_op(op, 8, ptr, -1, right->ival * scale);
+        int index = lower_conv(lower_expr(right), right->ctype, 8);
+        if (scale > 1)
+            index = emit_op(IR_MUL, 8, index, -1, scale);
+        return emit_op(op, 8, ptr, index, 0);
+    }
+    bool commutative = op == IR_ADD || op == IR_MUL || op == IR_AND ||
+                       op == IR_OR || op == IR_EQ;
+    if (commutative && is_imm_literal(left) && !is_imm_literal(right)) {
+        Ast *tmp = left;
+        left = right;
+        right = tmp;
+    }
+    int a = lower_conv(lower_expr(left), left->ctype, size);
+    if (op != IR_DIV && is_imm_literal(right))
+        return emit_op(op, size, a, -1, right->ival);
+    int b = lower_conv(lower_expr(right), right->ctype, size);
+    return emit_op(op, size, a, b, 0);
+}
+
+static int lower_inc_dec(Ast *ast)
+{
+    Ast *var = ast->operand;
+    check_type(var->ctype);
+    int old = lower_expr(var);
+    int copy = emit_op(IR_MOV, 8, old, -1, 0);
+    int step = (var->ctype->type == CTYPE_PTR) ? var->ctype->ptr->size : 1;
+    int op = (ast->type == PUNCT_INC) ? IR_ADD : IR_SUB;
+    int v = emit_op(op, op_size(var->ctype), old, -1, step);
+    lower_assign(var, v, var->ctype);
+    return copy;
+}
+
+static int lower_funcall(Ast *ast)
+{
+    int nargs = list_len(ast->args);
+    int *args = malloc(nargs * sizeof(int));
+    int n = 0;
+    for (Iter i = list_iter(ast->args); !iter_end(i);) {
+        Ast *v = iter_next(&i);
+        check_type(v->ctype);
+        if (v->ctype->type == CTYPE_STRUCT)
+            unsupported("struct arguments");
+        args[n++] = lower_expr(v);
+    }
+    int dst = new_vreg(true);
+    IRInst *inst = emit_inst(IR_CALL, 8, dst, -1, -1);
+    inst->sym = ast->fname;
+    inst->args = args;
+    inst->nargs = nargs;
+    return dst;
+}
+
+/* Computes ast into a fresh variable of both branches of a condition. */
+static int lower_bool(Ast *ast)
+{
+    int dst = new_vreg(false);
+    int fals = new_label();
+    int end = new_label();
+    lower_branch(ast, fals, false);
+    emit_inst(IR_IMM, 8, dst, -1, -1)->imm = 1;
+    emit_jump(IR_JMP, 0, -1, -1, 0, end);
+    emit_label(fals);
+    emit_inst(IR_IMM, 8, dst, -1, -1)->imm = 0;
+    emit_label(end);
+    return dst;
+}
+
+static void lower_branch(Ast *ast, int label, bool jump_if)
+{
+    switch (ast->type) {
+    case '<':
+    case '>':
+    case PUNCT_EQ: {
+        check_type(ast->left->ctype);
+        check_type(ast->right->ctype);
+        int size = op_size(ast->ctype);
+        int op;
+        if (ast->type == '<')
+            op = jump_if ? IR_JLT : IR_JGE;
+        else if (ast->type == '>')
+            op = jump_if ? IR_JGT : IR_JLE;
+        else
+            op = jump_if ? IR_JEQ : IR_JNE;
+        int a = lower_conv(lower_expr(ast->left), ast->left->ctype, size);
+        if (is_imm_literal(ast->right)) {
+            emit_jump(op, size, a, -1, ast->right->ival, label);
+            return;
+        }
+        int b = lower_conv(lower_expr(ast->right), ast->right->ctype, size);
+        emit_jump(op, size, a, b, 0, label);
+        return;
+    }
+    case '!':
+        lower_branch(ast->operand, label, !jump_if);
+        return;
+    case PUNCT_LOGAND:
+    case PUNCT_LOGOR: {
+        /* a && b jumps when false if either does, a || b when true. */
+        bool shortcut = (ast->type == PUNCT_LOGOR);
+        if (jump_if == shortcut) {
+            lower_branch(ast->left, label, jump_if);
+            lower_branch(ast->right, label, jump_if);
+        } else {
+            int skip = new_label();
+            lower_branch(ast->left, skip, !jump_if);
+            lower_branch(ast->right, label, jump_if);
+            emit_label(skip);
+        }
+        return;
+    }
+    default: {
+        check_type(ast->ctype);
+        int v = lower_expr(ast);
+        emit_jump(jump_if ? IR_JNE : IR_JEQ, op_size(ast->ctype), v, -1, 0,
+                  label);
+    }
+    }
+}
+
+static int lower_expr(Ast *ast)
+{
+    switch (ast->type) {
+    case AST_LITERAL:
+        check_type(ast->ctype);
+        return emit_imm(ast->ival);
+    case AST_STRING: {
+        int dst = new_vreg(true);
+        emit_inst(IR_GADDR, 8, dst, -1, -1)->sym = ast->slabel;
+        return dst;
+    }
+    case AST_LVAR: {
+        VarInfo *v = find_var(ast);
+        if (!v)
+            unsupported("variable %s", ast->varname);
+        if (v->vreg >= 0)
+            return v->vreg;
+        return lower_load(frame_addr(v->off), ast->ctype);
+    }
+    case AST_GVAR:
+    case AST_STRUCT_REF:
+        return lower_load(lower_addr(ast), ast->ctype);
+    case AST_DEREF:
+        return lower_load(lower_addr(ast), ast->ctype);
+    case AST_FUNCALL:
+        return lower_funcall(ast);
+    case AST_DECL:
+        lower_decl(ast);
+        return -1;
+    case AST_ADDR:
+        return addr_value(lower_addr(ast->operand));
+    case AST_IF: {
+        int els = new_label();
+        lower_branch(ast->cond, els, false);
+        lower_expr(ast->then);
+        if (ast->els) {
+            int end = new_label();
+            emit_jump(IR_JMP, 0, -1, -1, 0, end);
+            emit_label(els);
+            lower_expr(ast->els);
+            emit_label(end);
+        } else {
+            emit_label(els);
+        }
+        return -1;
+    }
+    case AST_TERNARY: {
+        check_type(ast->ctype);
+        int dst = new_vreg(false);
+        int els = new_label();
+        int end = new_label();
+        lower_branch(ast->cond, els, false);
+        emit_inst(IR_MOV, 8, dst, lower_expr(ast->then), -1);
+        emit_jump(IR_JMP, 0, -1, -1, 0, end);
+        emit_label(els);
+        emit_inst(IR_MOV, 8, dst, lower_expr(ast->els), -1);
+        emit_label(end);
+        return dst;
+    }
+    case AST_FOR: {
+        /* The condition is tested at the bottom of the loop. */
+        int body = new_label();
+        int cond = new_label();
+        if (ast->forinit)
+            lower_expr(ast->forinit);
+        emit_jump(IR_JMP, 0, -1, -1, 0, cond);
+        emit_label(body);
+        lower_expr(ast->forbody);
+        if (ast->forstep)
+            lower_expr(ast->forstep);
+        emit_label(cond);
+        if (ast->forcond)
+            lower_branch(ast->forcond, body, true);
+        else
+            emit_jump(IR_JMP, 0, -1, -1, 0, body);
+        return -1;
+    }
+    case AST_RETURN: {
+        check_type(ast->retval->ctype);
+        int v = lower_expr(ast->retval);
+        v = lower_conv(v, ast->retval->ctype, op_size(rettype));
+        emit_inst(IR_RET, 8, -1, v, -1);
+        return -1;
+    }
+    case AST_COMPOUND_STMT:
+        for (Iter i = list_iter(ast->stmts); !iter_end(i);)
+            lower_expr(iter_next(&i));
+        return -1;
+    case PUNCT_INC:
+    case PUNCT_DEC:
+        return lower_inc_dec(ast);
+    case '!':
+        check_type(ast->operand->ctype);
+        return emit_op(IR_NOT, op_size(ast->operand->ctype),
+                       lower_expr(ast->operand), -1, 0);
+    case PUNCT_LOGAND:
+    case PUNCT_LOGOR:
+        return lower_bool(ast);
+    case '=': {
+        int v = lower_expr(ast->right);
+        return lower_assign(ast->left, v, ast->right->ctype);
+    }
+    default:
+        return lower_binop(ast);
+    }
+}
+
+IRFunc *lower_func(Ast *func, char **err)
+{
+    fn = calloc(1, sizeof(IRFunc));
+    fn->name = func->fname;
+    vars = NULL;
+    nvars = 0;
+    temps = NULL;
+    addressed = make_list();
+    if (setjmp(unsupported_jmp)) {
+        free(fn->insts);
+        free(fn);
+        fn = NULL;
+        set_error(err, unsupported_reason);
+        return NULL;
+    }
+    check_type(func->ctype);
+    rettype = func->ctype;
+    find_addressed(func->body);
+    /* The parameters are all received first, as one parallel move. */
+    int nparams = list_len(func->params);
+    if (nparams > 6)
+        unsupported("more than 6 parameters");
+    int *dsts = malloc(nparams * sizeof(int));
+    for (Iter i = list_iter(func->params); !iter_end(i);) {
+        Ast *param = iter_next(&i);
+        if (!is_simple_type(param->ctype))
+            unsupported("parameter %s", param->varname);
+        VarInfo *v = add_var(param);
+        int dst = (v->vreg >= 0) ? v->vreg : new_vreg(true);
+        dsts[fn->nparams] = dst;
+        emit_inst(IR_PARAM, 8, dst, -1, -1)->imm = fn->nparams++;
+    }
+    for (int i = 0; i < nparams; i++) {
+        VarInfo *v = &vars[i];
+        if (v->var->ctype->type == CTYPE_CHAR && v->vreg >= 0)
+            emit_inst(IR_SEXT, 1, dsts[i], dsts[i], -1);
+        if (v->vreg < 0)
+            lower_store(frame_addr(v->off), v->var->ctype, dsts[i]);
+    }
+    free(dsts);
+    lower_expr(func->body);
+    IRFunc *r = fn;
+    fn = NULL;
+    free(vars);
+    free(temps);
+    return r;
+}
+
+static IRData lower_data(Ast *decl)
+{
+    Ast *var = decl->declvar;
+    check_type(var->ctype);
+    IRData data = {var->glabel, var->ctype->size, NULL};
+    if (!decl->declinit)
+        return data;
+    data.init = calloc(1, data.size);
+    List *values = NULL;
+    Ctype *elem = var->ctype;
+    if (decl->declinit->type == AST_ARRAY_INIT) {
+        values = decl->declinit->arrayinit;
+        elem = var->ctype->ptr;
+    } else {
+        values = make_list();
+        list_push(values, decl->declinit);
+    }
+    int off = 0;
+    for (Iter i = list_iter(values); !iter_end(i);) {
+        Ast *v = iter_next(&i);
+        if (v->type != AST_LITERAL || !is_inttype(v->ctype))
+            unsupported("initializer of %s", var->varname);
+        memcpy(data.init + off, &v->ival, elem->size);
+        off += elem->size;
+    }
+    return data;
+}
+
+/* The string literals now belong to the module, or are dropped with it. */
+static void clear_strings(void)
+{
+    ListNode *node, *tmp;
+    list_for_each_safe (node, tmp, strings)
+        free(node);
+    strings->head = strings->tail = NULL;
+    strings->len = 0;
+}
+
+IRModule *ir_read_module(FILE *fp, char **err)
+{
+    /* Syntax errors come back here rather than exiting the process. */
+    IRModule *volatile module = NULL;
+    jmp_buf error_buf;
+    if (setjmp(error_buf)) {
+        error_jmp = NULL;
+        set_error(err, error_message);
+        reset_lexer();
+        reset_parser();
+        clear_strings();
+        if (module)
+            free_ir_module(module);
+        return NULL;
+    }
+    error_jmp = &error_buf;
+    infp = fp;
+    List *toplevels = read_toplevels();
+    module = calloc(1, sizeof(IRModule));
+    module->funcs = malloc(list_len(toplevels) * sizeof(IRFunc *));
+    module->data = malloc((list_len(toplevels) + list_len(strings)) *
+                          sizeof(IRData));
+    for (Iter i = list_iter(toplevels); !iter_end(i);) {
+        Ast *v = iter_next(&i);
+        if (v->type == AST_DECL) {
+            if (setjmp(unsupported_jmp)) {
+                set_error(err, unsupported_reason);
+                goto fail;
+            }
+            module->data[module->ndata++] = lower_data(v);
+            continue;
+        }
+        IRFunc *f = lower_func(v, err);
+        if (!f)
+            goto fail;
+        module->funcs[module->nfuncs++] = f;
+    }
+    for (Iter i = list_iter(strings); !iter_end(i);) {
+        Ast *v = iter_next(&i);
+        IRData data = {v->slabel, strlen(v->sval) + 1, strdup(v->sval)};
+        module->data[module->ndata++] = data;
+    }
+    clear_strings();
+    reset_parser();
+    error_jmp = NULL;
+    return module;
+
+fail:
+    error_jmp = NULL;
+    clear_strings();
+    reset_parser();
+    free_ir_module(module);
+    return NULL;
+}
+
+void free_ir_func(IRFunc *f)
+{
+    for (int i = 0; i < f->ninsts; i++)
+        free(f->insts[i].args);
+    free(f->insts);
+    free(f->reg);
+    free(f->slot);
+    if (f->code)
+        free(f->code->insts);
+    free(f->code);
+    free(f);
+}
+
+void free_ir_module(IRModule *module)
+{
+    for (int i = 0; i < module->nfuncs; i++)
+        free_ir_func(module->funcs[i]);
+    for (int i = 0; i < module->ndata; i++)
+        free(module->data[i].init);
+    free(module->funcs);
+    free(module->data);
+    free(module);
+}
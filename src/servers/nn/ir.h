@@ -0,0 +1,221 @@
+#ifndef MAZUCC_IR_H
+#define MAZUCC_IR_H
+
+/*
+ * Intermediate representation of the register allocating backend.
+ *
+ * Functions are lowered from the AST into three-address instructions over an
+ * unbounded set of virtual registers, which the linear scan allocator of
+ * regalloc.c maps onto x86-64 registers or stack slots. Instruction selection
+ * then turns them into X86Inst records, printed as GAS assembly by
+ * codegen_ir_x64.c or assembled into memory by jit_x64.cpp.
+ *
+ * This header is shared with C++, so it does not include mzcc.h.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {
+    IR_IMM,     /* dst = imm */
+    IR_MOV,     /* dst = src[0] */
+    IR_SEXT,    /* dst = sign extension of the low size bytes of src[0] */
+    IR_ADD,     /* dst = src[0] op (src[1] or imm) */
+    IR_SUB,
+    IR_MUL,
+    IR_DIV,
+    IR_AND,
+    IR_OR,
+    IR_SHL,
+    IR_SAR,
+    IR_EQ,      /* dst = src[0] == (src[1] or imm) */
+    IR_LT,
+    IR_GT,
+    IR_NOT,     /* dst = src[0] == 0 */
+    IR_LOAD,    /* dst = *(src[0] + index * scale + imm), or frame slot imm */
+    IR_STORE,   /* *(src[0] + index * scale + imm) = (src[1] or imm2) */
+    IR_LADDR,   /* dst = address of frame slot imm */
+    IR_GADDR,   /* dst = address of sym */
+    IR_PARAM,   /* dst = parameter imm */
+    IR_CALL,    /* dst = sym(args) */
+    IR_LABEL,   /* label: */
+    IR_JMP,     /* goto label */
+    IR_JEQ,     /* if (src[0] cc (src[1] or imm)) goto label */
+    IR_JNE,
+    IR_JLT,
+    IR_JGE,
+    IR_JGT,
+    IR_JLE,
+    IR_RET,     /* return src[0] */
+};
+
+typedef struct {
+    int op;
+    int size;   /* operation or memory access size: 1, 4 or 8 bytes */
+    int dst;    /* defined virtual register, or -1 */
+    int src[2]; /* used virtual registers, or -1 for the immediate */
+    long imm;   /* immediate operand, displacement or parameter index */
+    long imm2;  /* immediate stored by IR_STORE */
+    int index;  /* scaled index register of IR_LOAD and IR_STORE, or -1 */
+    int scale;
+    int label;
+    char *sym;
+    int *args;
+    int nargs;
+} IRInst;
+
+typedef struct {
+    char *name;
+    IRInst *insts;
+    int ninsts;
+    int nalloc;
+    int nvregs;
+    int nlabels;
+    int nparams;
+    int frame_size; /* bytes below %rbp for locals, spill and save slots */
+    /* Filled by allocate_registers(): a physical register, or -1 with the
+     * frame offset of the spill slot, or -1 and 0 for values never used. */
+    int *reg;
+    int *slot;
+    unsigned int used_regs;
+    struct X86Code *code;
+} IRFunc;
+
+typedef struct {
+    char *name;
+    int size;
+    char *init; /* NULL for zero filled data */
+} IRData;
+
+typedef struct {
+    IRFunc **funcs;
+    int nfuncs;
+    IRData *data;
+    int ndata;
+} IRModule;
+
+/* x86-64 registers, numbered as in the instruction encoding */
+enum {
+    X86_RAX,
+    X86_RCX,
+    X86_RDX,
+    X86_RBX,
+    X86_RSP,
+    X86_RBP,
+    X86_RSI,
+    X86_RDI,
+    X86_R8,
+    X86_R9,
+    X86_R10,
+    X86_R11,
+    X86_R12,
+    X86_R13,
+    X86_R14,
+    X86_R15,
+};
+
+enum {
+    OPND_NONE,
+    OPND_REG,
+    OPND_MEM,   /* reg + index * scale + val */
+    OPND_IMM,
+    OPND_LABEL, /* function local label val */
+    OPND_SYM,   /* address of a data symbol, or a function to call */
+};
+
+typedef struct {
+    int kind;
+    int reg;
+    long val;
+    char *sym;
+    int index; /* or -1 */
+    int scale;
+} X86Operand;
+
+enum {
+    X86_MOV,
+    X86_MOVSX, /* sign extends size bytes to the whole register */
+    X86_MOVZB, /* zero extends %al to %eax */
+    X86_LEA,
+    X86_ADD,
+    X86_SUB,
+    X86_IMUL,
+    X86_AND,
+    X86_OR,
+    X86_SHL,
+    X86_SAR,
+    X86_CQO,   /* cltd or cqto */
+    X86_IDIV,
+    X86_CMP,
+    X86_SETCC,
+    X86_JMP,
+    X86_JCC,
+    X86_CALL,
+    X86_PUSH,
+    X86_LEAVE,
+    X86_RET,
+    X86_LABEL,
+};
+
+enum {
+    CC_E,
+    CC_NE,
+    CC_L,
+    CC_GE,
+    CC_G,
+    CC_LE,
+};
+
+/* Two operand instruction in AT&T order: op src, dst */
+typedef struct {
+    int op;
+    int size;
+    int cc;
+    X86Operand src;
+    X86Operand dst;
+} X86Inst;
+
+typedef struct X86Code {
+    X86Inst *insts;
+    int ninsts;
+    int nalloc;
+} X86Code;
+
+enum {
+    MZCC_REGALLOC = 1, /* use the IR backend where a function allows it */
+    MZCC_SPILL_ALL = 2, /* keep every virtual register in the frame */
+};
+
+/* ir.c */
+/* On failure, this and mzcc_jit_compile() return NULL and point *err, unless
+ * err is NULL, at a message the caller frees with free(). */
+extern IRModule *ir_read_module(FILE *fp, char **err);
+extern void free_ir_func(IRFunc *fn);
+extern void free_ir_module(IRModule *module);
+
+/* regalloc.c */
+extern void allocate_registers(IRFunc *fn, bool spill_all);
+
+/* codegen_ir_x64.c */
+extern void select_instructions(IRFunc *fn);
+extern void emit_ir_func(IRFunc *fn);
+
+/* main.c */
+extern int mzcc_compile(FILE *in, FILE *out, int flags);
+
+/* jit_x64.cpp */
+typedef struct MzccJitModule MzccJitModule;
+
+extern MzccJitModule *mzcc_jit_compile(const char *source, int flags, char **err);
+extern void *mzcc_jit_lookup(MzccJitModule *module, const char *name);
+extern void mzcc_jit_free(MzccJitModule *module);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MAZUCC_IR_H */
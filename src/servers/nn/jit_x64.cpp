@@ -0,0 +1,330 @@
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#ifndef ASMJIT_STATIC
+#define ASMJIT_STATIC
+#endif
+#include "asmjit/x86.h"
+
+#include "ir.h"
+
+/*
+ * In-memory compilation of C sources.
+ *
+ * The sources go through the same parser, IR lowering, register allocation
+ * and instruction selection as the -O code generator, but the selected
+ * instructions are assembled by asmjit into executable memory instead of
+ * being printed as assembly. Functions of the module call each other
+ * directly; any other callee or data symbol is resolved with dlsym().
+ *
+ * Modules made of code the IR backend cannot lower (floating point, structs
+ * passed by value) are rejected with the reason in *err, as are sources the
+ * lexer or the parser cannot read.
+ */
+
+using namespace asmjit;
+
+struct MzccJitModule {
+    void *code;
+    char *data;
+    int nfuncs;
+    char **names;
+    void **addrs;
+};
+
+static JitRuntime &get_jit_runtime(void)
+{
+    static JitRuntime jit_runtime;
+    return jit_runtime;
+}
+
+/* The parser keeps global state, so modules are compiled one at a time. */
+static pthread_mutex_t compile_lock = PTHREAD_MUTEX_INITIALIZER;
+
+namespace {
+
+struct Assembly {
+    x86::Assembler *a;
+    IRModule *module;
+    std::vector<Label> funcs;
+    std::vector<Label> labels;
+    char **data_addrs;
+    const char *undefined;
+};
+
+static x86::Gp gp(int reg, int size)
+{
+    if (size == 1)
+        return x86::gpb(reg);
+    if (size == 4)
+        return x86::gpd(reg);
+    return x86::gpq(reg);
+}
+
+static int log2_scale(int scale)
+{
+    return scale == 8 ? 3 : scale == 4 ? 2 : scale == 2 ? 1 : 0;
+}
+
+static Operand opnd(Assembly *as, const X86Operand &o, int size)
+{
+    switch (o.kind) {
+    case OPND_REG:
+        return gp(o.reg, size);
+    case OPND_MEM:
+        if (o.index >= 0)
+            return x86::ptr(x86::gpq(o.reg), x86::gpq(o.index),
+                            log2_scale(o.scale), (int32_t) o.val, size);
+        return x86::ptr(x86::gpq(o.reg), (int32_t) o.val, size);
+    case OPND_IMM:
+        return Imm(o.val);
+    case OPND_LABEL:
+        return as->labels[o.val];
+    default:
+        return Operand();
+    }
+}
+
+static int find_func(IRModule *module, const char *name)
+{
+    for (int i = 0; i < module->nfuncs; i++)
+        if (!strcmp(module->funcs[i]->name, name))
+            return i;
+    return -1;
+}
+
+/* Address of a data symbol of the module, or of the process */
+static void *find_data(Assembly *as, const char *name)
+{
+    for (int i = 0; i < as->module->ndata; i++)
+        if (!strcmp(as->module->data[i].name, name))
+            return as->data_addrs[i];
+    void *addr = dlsym(RTLD_DEFAULT, name);
+    if (!addr)
+        as->undefined = name;
+    return addr;
+}
+
+static const uint32_t SETCC_IDS[] = {
+    x86::Inst::kIdSete, x86::Inst::kIdSetne, x86::Inst::kIdSetl,
+    x86::Inst::kIdSetge, x86::Inst::kIdSetg, x86::Inst::kIdSetle,
+};
+
+static const uint32_t JCC_IDS[] = {
+    x86::Inst::kIdJe, x86::Inst::kIdJne, x86::Inst::kIdJl,
+    x86::Inst::kIdJge, x86::Inst::kIdJg, x86::Inst::kIdJle,
+};
+
+static uint32_t alu_id(int op)
+{
+    switch (op) {
+    case X86_MOV:
+        return x86::Inst::kIdMov;
+    case X86_ADD:
+        return x86::Inst::kIdAdd;
+    case X86_SUB:
+        return x86::Inst::kIdSub;
+    case X86_IMUL:
+        return x86::Inst::kIdImul;
+    case X86_AND:
+        return x86::Inst::kIdAnd;
+    case X86_OR:
+        return x86::Inst::kIdOr;
+    case X86_SHL:
+        return x86::Inst::kIdShl;
+    case X86_SAR:
+        return x86::Inst::kIdSar;
+    default:
+        return x86::Inst::kIdCmp;
+    }
+}
+
+static Error assemble_inst(Assembly *as, const X86Inst *x)
+{
+    x86::Assembler &a = *as->a;
+    switch (x->op) {
+    case X86_LABEL:
+        return a.bind(as->labels[x->dst.val]);
+    case X86_MOVSX:
+        return a.emit(x->size == 4 ? x86::Inst::kIdMovsxd
+                                   : x86::Inst::kIdMovsx,
+                      x86::gpq(x->dst.reg),
+                      opnd(as, x->src, x->size));
+    case X86_MOVZB:
+        return a.movzx(x86::eax, x86::al);
+    case X86_CQO:
+        return x->size == 8 ? a.cqo() : a.cdq();
+    case X86_IDIV:
+        return a.emit(x86::Inst::kIdIdiv, opnd(as, x->dst, x->size));
+    case X86_SETCC:
+        return a.emit(SETCC_IDS[x->cc], x86::al);
+    case X86_JMP:
+        return a.jmp(as->labels[x->dst.val]);
+    case X86_JCC:
+        return a.emit(JCC_IDS[x->cc], as->labels[x->dst.val]);
+    case X86_CALL: {
+        int f = find_func(as->module, x->dst.sym);
+        if (f >= 0)
+            return a.call(as->funcs[f]);
+        /* %r11 holds no value across a call. */
+        void *addr = find_data(as, x->dst.sym);
+        a.mov(x86::r11, Imm((uint64_t) (uintptr_t) addr));
+        return a.call(x86::r11);
+    }
+    case X86_PUSH:
+        return a.push(x86::gpq(x->dst.reg));
+    case X86_LEAVE:
+        return a.leave();
+    case X86_RET:
+        return a.ret();
+    case X86_LEA:
+        if (x->src.kind == OPND_SYM) {
+            int f = find_func(as->module, x->src.sym);
+            if (f >= 0)
+                return a.lea(x86::gpq(x->dst.reg), x86::ptr(as->funcs[f]));
+            void *addr = find_data(as, x->src.sym);
+            return a.mov(x86::gpq(x->dst.reg),
+                         Imm((uint64_t) (uintptr_t) addr));
+        }
+        return a.emit(x86::Inst::kIdLea, x86::gpq(x->dst.reg),
+                      opnd(as, x->src, 8));
+    case X86_SHL:
+    case X86_SAR:
+        return a.emit(alu_id(x->op), opnd(as, x->dst, x->size),
+                      opnd(as, x->src, 1));
+    default:
+        return a.emit(alu_id(x->op), opnd(as, x->dst, x->size),
+                      opnd(as, x->src, x->size));
+    }
+}
+
+}  // namespace
+
+static MzccJitModule *fail(char **err, const char *reason)
+{
+    if (err)
+        *err = strdup(reason);
+    return NULL;
+}
+
+/* Lays out the data of the module in one zero filled block. */
+static char *allocate_data(IRModule *module, char **addrs)
+{
+    size_t size = 0;
+    for (int i = 0; i < module->ndata; i++)
+        size = ((size + 15) & ~(size_t) 15) + module->data[i].size;
+    char *data = (char *) calloc(1, size ? size : 1);
+    size = 0;
+    for (int i = 0; i < module->ndata; i++) {
+        size = (size + 15) & ~(size_t) 15;
+        addrs[i] = data + size;
+        if (module->data[i].init)
+            memcpy(addrs[i], module->data[i].init, module->data[i].size);
+        size += module->data[i].size;
+    }
+    return data;
+}
+
+static MzccJitModule *assemble_module(IRModule *module, char **err)
+{
+    JitRuntime &rt = get_jit_runtime();
+    CodeHolder code;
+    code.init(rt.environment());
+    x86::Assembler a(&code);
+
+    Assembly as;
+    as.a = &a;
+    as.module = module;
+    as.undefined = NULL;
+    as.data_addrs = (char **) malloc((module->ndata + 1) * sizeof(char *));
+    char *data = allocate_data(module, as.data_addrs);
+    for (int i = 0; i < module->nfuncs; i++)
+        as.funcs.push_back(a.newLabel());
+
+    Error error = kErrorOk;
+    for (int i = 0; i < module->nfuncs && error == kErrorOk; i++) {
+        IRFunc *f = module->funcs[i];
+        as.labels.clear();
+        for (int l = 0; l < f->nlabels + 1; l++)
+            as.labels.push_back(a.newLabel());
+        a.align(kAlignCode, 16);
+        a.bind(as.funcs[i]);
+        for (int j = 0; j < f->code->ninsts && error == kErrorOk; j++)
+            error = assemble_inst(&as, &f->code->insts[j]);
+    }
+    free(as.data_addrs);
+
+    void *base = NULL;
+    if (as.undefined) {
+        char message[256];
+        snprintf(message, sizeof(message), "undefined symbol %s",
+                 as.undefined);
+        free(data);
+        return fail(err, message);
+    }
+    if (error != kErrorOk || rt._add(&base, &code) != kErrorOk) {
+        free(data);
+        return fail(err, "cannot assemble the module");
+    }
+
+    MzccJitModule *m = (MzccJitModule *) calloc(1, sizeof(MzccJitModule));
+    m->code = base;
+    m->data = data;
+    m->nfuncs = module->nfuncs;
+    m->names = (char **) malloc((module->nfuncs + 1) * sizeof(char *));
+    m->addrs = (void **) malloc((module->nfuncs + 1) * sizeof(void *));
+    for (int i = 0; i < module->nfuncs; i++) {
+        m->names[i] = strdup(module->funcs[i]->name);
+        m->addrs[i] =
+            (char *) base + code.labelOffsetFromBase(as.funcs[i]);
+    }
+    return m;
+}
+
+MzccJitModule *mzcc_jit_compile(const char *source, int flags, char **err)
+{
+    FILE *fp = fmemopen((void *) source, strlen(source), "r");
+    if (!fp)
+        return fail(err, "cannot open the source");
+
+    pthread_mutex_lock(&compile_lock);
+    IRModule *module = ir_read_module(fp, err);
+    MzccJitModule *m = NULL;
+    if (module) {
+        for (int i = 0; i < module->nfuncs; i++) {
+            allocate_registers(module->funcs[i], flags & MZCC_SPILL_ALL);
+            select_instructions(module->funcs[i]);
+        }
+        m = assemble_module(module, err);
+        free_ir_module(module);
+    }
+    pthread_mutex_unlock(&compile_lock);
+    fclose(fp);
+    return m;
+}
+
+void *mzcc_jit_lookup(MzccJitModule *m, const char *name)
+{
+    for (int i = 0; i < m->nfuncs; i++)
+        if (!strcmp(m->names[i], name))
+            return m->addrs[i];
+    return NULL;
+}
+
+void mzcc_jit_free(MzccJitModule *m)
+{
+    if (!m)
+        return;
+    get_jit_runtime()._release(m->code);
+    for (int i = 0; i < m->nfuncs; i++)
+        free(m->names[i]);
+    free(m->names);
+    free(m->addrs);
+    free(m->data);
+    free(m);
+}
@@ -10,9 +10,17 @@
 #define make_number(x) make_token(TTYPE_NUMBER, (uintptr_t)(x))
 #define make_char(x) make_token(TTYPE_CHAR, (uintptr_t)(x))
 
+FILE *infp;
+
 static bool ungotten = false;
 static Token ungotten_buf = {0};
 
+/* Drops the token left over by a source that failed to parse. */
+void reset_lexer(void)
+{
+    ungotten = false;
+}
+
 static Token make_token(enum TokenType type, uintptr_t data)
 {
     return (Token){
@@ -24,7 +32,7 @@ static Token make_token(enum TokenType type, uintptr_t data)
 static int getc_nonspace(void)
 {
     int c;
-    while ((c = getc(stdin)) != EOF) {
+    while ((c = getc(infp)) != EOF) {
         if (isspace(c) || c == '\n' || c == '\r')
             continue;
         return c;
@@ -37,9 +45,9 @@ static Token read_number(char c)
     String s = make_string();
     string_append(&s, c);
     while (1) {
-        int c = getc(stdin);
+        int c = getc(infp);
         if (!isdigit(c) && !isalpha(c) && c != '.') {
-            ungetc(c, stdin);
+            ungetc(c, infp);
             return make_number(get_cstring(s));
         }
         string_append(&s, c);
@@ -48,15 +56,15 @@ static Token read_number(char c)
 
 static Token read_char(void)
 {
-    char c = getc(stdin);
+    char c = getc(infp);
     if (c == EOF)
         goto err;
     if (c == '\\') {
-        c = getc(stdin);
+        c = getc(infp);
         if (c == EOF)
             goto err;
     }
-    char c2 = getc(stdin);
+    char c2 = getc(infp);
     if (c2 == EOF)
         goto err;
     if (c2 != '\'')
@@ -71,13 +79,13 @@ static Token read_string(void)
 {
     String s = make_string();
     while (1) {
-        int c = getc(stdin);
+        int c = getc(infp);
         if (c == EOF)
             error("Unterminated string");
         if (c == '"')
             break;
         if (c == '\\') {
-            c = getc(stdin);
+            c = getc(infp);
             switch (c) {
             case EOF:
                 error("Unterminated \\");
@@ -100,11 +108,11 @@ static Token read_ident(char c)
     String s = make_string();
     string_append(&s, c);
     while (1) {
-        int c2 = getc(stdin);
+        int c2 = getc(infp);
         if (isalnum(c2) || c2 == '_') {
             string_append(&s, c2);
         } else {
-            ungetc(c2, stdin);
+            ungetc(c2, infp);
             return make_ident(s);
         }
     }
@@ -113,7 +121,7 @@ static Token read_ident(char c)
 static void skip_line_comment(void)
 {
     while (1) {
-        int c = getc(stdin);
+        int c = getc(infp);
         if (c == '\n' || c == EOF)
             return;
     }
@@ -123,7 +131,7 @@ static void skip_block_comment(void)
 {
     enum { in_comment, asterisk_read } state = in_comment;
     while (1) {
-        int c = getc(stdin);
+        int c = getc(infp);
         if (state == in_comment) {
             if (c == '*')
                 state = asterisk_read;
@@ -135,10 +143,10 @@ static void skip_block_comment(void)
 
 static Token read_rep(int expect, int t1, int t2)
 {
-    int c = getc(stdin);
+    int c = getc(infp);
     if (c == expect)
         return make_punct(t2);
-    ungetc(c, stdin);
+    ungetc(c, infp);
     return make_punct(t1);
 }
 
@@ -153,7 +161,7 @@ static Token read_token_int(void)
     case '_':
         return read_ident(c);
     case '/': {
-        c = getc(stdin);
+        c = getc(infp);
         if (c == '/') {
             skip_line_comment();
             return read_token_int();
@@ -162,7 +170,7 @@ static Token read_token_int(void)
             skip_block_comment();
             return read_token_int();
         }
-        ungetc(c, stdin);
+        ungetc(c, infp);
         return make_punct('/');
     }
     case '*':
@@ -180,12 +188,12 @@ static Token read_token_int(void)
     case ':':
         return make_punct(c);
     case '-':
-        c = getc(stdin);
+        c = getc(infp);
         if (c == '-')
             return make_punct(PUNCT_DEC);
         if (c == '>')
             return make_punct(PUNCT_ARROW);
-        ungetc(c, stdin);
+        ungetc(c, infp);
         return make_punct('-');
     case '=':
         return read_rep('=', '=', PUNCT_EQ);
@@ -1,3 +1,4 @@
+#include <setjmp.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -6,6 +7,10 @@
 static char *outfile = NULL, *infile = NULL;
 extern FILE *outfp;
 static bool dump_ast;
+static int flags;
+
+jmp_buf *error_jmp = NULL;
+char *error_message = NULL;
 
 int mainu(int argc, char **argv);
 static void usage()
@@ -14,6 +19,7 @@ static void usage()
             "mzcc [options] filename\n"
             "OPTIONS\n"
             "  -o filename            Write output to the specified file.\n"
+            "  -O                     Allocate registers in the IR backend\n"
             "  --dump-ast             Dump abstract syntax tree(AST)\n");
 }
 
@@ -46,6 +52,9 @@ static void parse_args(int argc, char **argv)
                 argv++;
                 outfile = *argv;
                 break;
+            case 'O':
+                flags |= MZCC_REGALLOC;
+                break;
             case '-':
                 if (!strcmp(*argv, "--dump-ast")) {
                     dump_ast = true;
@@ -89,22 +98,45 @@ static void open_input_file()
     }
 }
 
+/* Functions the IR backend can not lower are emitted by the stack machine. */
+int mzcc_compile(FILE *in, FILE *out, int flags)
+{
+    infp = in;
+    outfp = out;
+    List *toplevels = read_toplevels();
+    emit_data_section();
+
+    for (Iter i = list_iter(toplevels); !iter_end(i);) {
+        Ast *v = iter_next(&i);
+        if (v->type == AST_FUNC && (flags & MZCC_REGALLOC)) {
+            IRFunc *fn = lower_func(v, NULL);
+            if (fn) {
+                allocate_registers(fn, flags & MZCC_SPILL_ALL);
+                select_instructions(fn);
+                emit_ir_func(fn);
+                free_ir_func(fn);
+                continue;
+            }
+        }
+        emit_toplevel(v);
+    }
+    reset_parser();
+    return 0;
+}
+
 int mainu(int argc, char **argv)
 {
     parse_args(argc, argv);
     open_input_file();
     open_output_file();
 
-    List *toplevels = read_toplevels();
-    if (!dump_ast)
-        emit_data_section();
-
-    for (Iter i = list_iter(toplevels); !iter_end(i);) {
-        Ast *v = iter_next(&i);
-        if (dump_ast)
-            printf("%s", ast_to_string(v));
-        else
-            emit_toplevel(v);
+    if (dump_ast) {
+        infp = stdin;
+        List *toplevels = read_toplevels();
+        for (Iter i = list_iter(toplevels); !iter_end(i);)
+            printf("%s", ast_to_string(iter_next(&i)));
+    } else {
+        mzcc_compile(stdin, outfp, flags);
     }
     list_free(cstrings);
     list_free(ctypes);
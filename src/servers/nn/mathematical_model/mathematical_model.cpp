@@ -280,6 +280,20 @@ Vector<double> MathematicalModel::calculate_final_solutions(const NeuralNetwork&
 }
 
 
+// Matrix<double> calculate_final_solutions_parameters_Jacobian(const NeuralNetwork&) const method
+
+/// This virtual method returns the partial derivatives of the final dependent variables with respect to the neural network parameters,
+/// with one row for each dependent variable and one column for each parameter. 
+/// Mathematical models which cannot compute them return an empty matrix, which is what this method does. 
+
+Matrix<double> MathematicalModel::calculate_final_solutions_parameters_Jacobian(const NeuralNetwork&) const
+{
+   Matrix<double> final_solutions_parameters_Jacobian;
+
+   return(final_solutions_parameters_Jacobian);
+}
+
+
 // Matrix<double> calculate_dependent_variables(const NeuralNetwork&, const Matrix<double>&) const method
 
 /// This virtual method returns the dependent variables solutions to the mathematical model, 
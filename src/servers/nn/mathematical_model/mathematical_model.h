@@ -93,6 +93,8 @@ public:
 
    virtual Vector<double> calculate_final_solutions(const NeuralNetwork&) const;
 
+   virtual Matrix<double> calculate_final_solutions_parameters_Jacobian(const NeuralNetwork&) const;
+
    virtual Matrix<double> calculate_dependent_variables(const NeuralNetwork&, const Matrix<double>&) const;  
 
 
@@ -544,7 +544,7 @@ Matrix<double> OrdinaryDifferentialEquations::calculate_Runge_Kutta_solution(con
 
       for(unsigned int j = 0; j < dependent_variables_number; j++)
       {
-         variables[1+j] = solution[i][1+j] + h*c[2][j]/2.0; 
+         variables[1+j] = solution[i][1+j] + h*c[2][j]; 
       }
             
       c[3] = calculate_dependent_variables_dots(neural_network, variables);
@@ -588,15 +588,13 @@ Vector<double> OrdinaryDifferentialEquations::calculate_Runge_Kutta_final_soluti
 
    for(unsigned int j = 0; j < dependent_variables_number; j++)
    {
-      final_solution[0] = initial_dependent_variables[j];
+      final_solution[1+j] = initial_dependent_variables[j];
    }
 
    // Main loop
 
    for(unsigned int i = 0; i < points_number-1; i++)
    {
-      final_solution[0] = final_solution[0] + h;
-
       // First coefficient 
 
       variables[0] = final_solution[0]; 
@@ -632,23 +630,27 @@ Vector<double> OrdinaryDifferentialEquations::calculate_Runge_Kutta_final_soluti
 
       // Fourth coefficient
 
-      variables[0] = final_solution[0]; 
+      variables[0] = final_solution[0] + h; 
 
       for(unsigned int j = 0; j < dependent_variables_number; j++)
       {
-         variables[1+j] = final_solution[1+j] + h*c[2][j]/2.0; 
+         variables[1+j] = final_solution[1+j] + h*c[2][j]; 
       }
             
       c[3] = calculate_dependent_variables_dots(neural_network, variables);
 
       // Dependent variables
 
+      final_solution[0] = final_solution[0] + h;
+
       for(unsigned int j = 0; j < dependent_variables_number; j++)
       {
          final_solution[1+j] = final_solution[1+j] + h*(c[0][j] + 2.0*c[1][j] + 2.0*c[2][j] + c[3][j])/6.0;
       }
    }
 
+   final_solution[0] = final_independent_variable;
+
    return(final_solution);
 }
 
@@ -1087,6 +1089,163 @@ Vector<double> OrdinaryDifferentialEquations::calculate_Runge_Kutta_Fehlberg_fin
 }
 
 
+// Matrix<double> calculate_dependent_variables_dots_Jacobian(const NeuralNetwork&, const Vector<double>&) const method
+
+/// This method returns the partial derivatives of the dependent variables dots with respect to the dependent variables, 
+/// with one row for each dot and one column for each dependent variable. 
+/// It is used to compute the sensitivities of the solutions to the neural network parameters. 
+/// This default implementation uses central differences, which take two evaluations of the dots for each dependent variable. 
+/// Derived classes can return the exact derivatives instead. 
+/// @param neural_network Neural network which represents the external inputs to the mathematical model. 
+/// @param variables Values of the independent and the dependent variables. 
+
+Matrix<double> OrdinaryDifferentialEquations::calculate_dependent_variables_dots_Jacobian(const NeuralNetwork& neural_network, const Vector<double>& variables) const
+{
+   Matrix<double> Jacobian(dependent_variables_number, dependent_variables_number);
+
+   Vector<double> variables_forward(variables);
+   Vector<double> variables_backward(variables);
+
+   for(unsigned int j = 0; j < dependent_variables_number; j++)
+   {
+      const double h = 1.0e-6*(1.0 + fabs(variables[1+j]));
+
+      variables_forward[1+j] = variables[1+j] + h;
+      variables_backward[1+j] = variables[1+j] - h;
+
+      const Vector<double> dots_forward = calculate_dependent_variables_dots(neural_network, variables_forward);
+      const Vector<double> dots_backward = calculate_dependent_variables_dots(neural_network, variables_backward);
+
+      for(unsigned int i = 0; i < dependent_variables_number; i++)
+      {
+         Jacobian[i][j] = (dots_forward[i] - dots_backward[i])/(2.0*h);
+      }
+
+      variables_forward[1+j] = variables[1+j];
+      variables_backward[1+j] = variables[1+j];
+   }
+
+   return(Jacobian);
+}
+
+
+// Matrix<double> calculate_dependent_variables_dots_parameters_Jacobian(const NeuralNetwork&, const Vector<double>&) const method
+
+/// This method returns the partial derivatives of the dependent variables dots with respect to the neural network parameters, 
+/// with one row for each dot and one column for each parameter. 
+/// Derived classes which implement it make the sensitivities of the solutions available, and so exact gradients of 
+/// performance terms such as the final solutions error. 
+/// The dots usually depend on the parameters through the neural network outputs, in which case the derivatives are 
+/// those of the dots with respect to the outputs times NeuralNetwork::calculate_parameters_Jacobian(). 
+/// This default implementation returns an empty matrix, which means that the derivatives are not available. 
+/// @param neural_network Neural network which represents the external inputs to the mathematical model. 
+/// @param variables Values of the independent and the dependent variables. 
+
+Matrix<double> OrdinaryDifferentialEquations::calculate_dependent_variables_dots_parameters_Jacobian(const NeuralNetwork&, const Vector<double>&) const
+{
+   Matrix<double> parameters_Jacobian;
+
+   return(parameters_Jacobian);
+}
+
+
+// Matrix<double> calculate_Runge_Kutta_final_solution_parameters_Jacobian(const NeuralNetwork&) const method
+
+/// This method returns the partial derivatives of the final dependent variables computed with the Runge-Kutta method 
+/// with respect to the neural network parameters, with one row for each dependent variable and one column for each parameter. 
+/// The sensitivities are integrated together with the solution, by differentiating each step of the method, 
+/// so that the cost is a small multiple of that of one solution, whatever the number of parameters. 
+/// It returns an empty matrix if the derivatives of the dots with respect to the parameters are not available. 
+/// @param neural_network Neural network which represents the external inputs to the mathematical model. 
+
+Matrix<double> OrdinaryDifferentialEquations::calculate_Runge_Kutta_final_solution_parameters_Jacobian(const NeuralNetwork& neural_network) const
+{
+   const unsigned int variables_number = count_variables_number();
+   const unsigned int parameters_number = neural_network.count_parameters_number();
+
+   const double h = (final_independent_variable - initial_independent_variable)/(points_number-1.0);      
+
+   // Fraction of the step at which each coefficient is evaluated
+
+   const double stages[4] = {0.0, 0.5, 0.5, 1.0};
+
+   // Fourth order Runge-Kutta coefficients and their derivatives with respect to the parameters
+
+   Vector< Vector<double> > c(4);
+   Vector< Matrix<double> > c_parameters_Jacobian(4);
+
+   Vector<double> final_solution(variables_number);
+   Matrix<double> final_solution_parameters_Jacobian(dependent_variables_number, parameters_number, 0.0);
+
+   Vector<double> variables(variables_number);
+   Matrix<double> variables_parameters_Jacobian;
+
+   // Initial variables, which do not depend on the parameters
+
+   final_solution[0] = initial_independent_variable;
+
+   for(unsigned int j = 0; j < dependent_variables_number; j++)
+   {
+      final_solution[1+j] = initial_dependent_variables[j];
+   }
+
+   // Main loop
+
+   for(unsigned int i = 0; i < points_number-1; i++)
+   {
+      for(unsigned int k = 0; k < 4; k++)
+      {
+         variables[0] = final_solution[0] + stages[k]*h;
+
+         for(unsigned int j = 0; j < dependent_variables_number; j++)
+         {
+            variables[1+j] = final_solution[1+j];
+         }
+
+         variables_parameters_Jacobian = final_solution_parameters_Jacobian;
+
+         if(k > 0)
+         {
+            for(unsigned int j = 0; j < dependent_variables_number; j++)
+            {
+               variables[1+j] += stages[k]*h*c[k-1][j];
+            }
+
+            variables_parameters_Jacobian += c_parameters_Jacobian[k-1]*(stages[k]*h);
+         }
+
+         c[k] = calculate_dependent_variables_dots(neural_network, variables);
+
+         const Matrix<double> dots_parameters_Jacobian = calculate_dependent_variables_dots_parameters_Jacobian(neural_network, variables);
+
+         if(dots_parameters_Jacobian.empty())
+         {
+            return(dots_parameters_Jacobian);
+         }
+
+         // Chain rule through the dependent variables, plus the direct dependence on the parameters
+
+         c_parameters_Jacobian[k] = calculate_dependent_variables_dots_Jacobian(neural_network, variables).dot(variables_parameters_Jacobian);
+
+         c_parameters_Jacobian[k] += dots_parameters_Jacobian;
+      }
+
+      // Dependent variables and their sensitivities
+
+      final_solution[0] = final_solution[0] + h;
+
+      for(unsigned int j = 0; j < dependent_variables_number; j++)
+      {
+         final_solution[1+j] = final_solution[1+j] + h*(c[0][j] + 2.0*c[1][j] + 2.0*c[2][j] + c[3][j])/6.0;
+      }
+
+      final_solution_parameters_Jacobian += (c_parameters_Jacobian[0] + c_parameters_Jacobian[1]*2.0 + c_parameters_Jacobian[2]*2.0 + c_parameters_Jacobian[3])*(h/6.0);
+   }
+
+   return(final_solution_parameters_Jacobian);
+}
+
+
 // Matrix<double> calculate_solutions(const NeuralNetwork&) const method
 
 Matrix<double> OrdinaryDifferentialEquations::calculate_solutions(const NeuralNetwork& neural_network) const
@@ -1153,6 +1312,26 @@ Vector<double> OrdinaryDifferentialEquations::calculate_final_solutions(const Ne
 }
 
 
+// Matrix<double> calculate_final_solutions_parameters_Jacobian(const NeuralNetwork&) const method
+
+/// This method returns the partial derivatives of the final dependent variables with respect to the neural network parameters. 
+/// They are only available with the Runge-Kutta method, and when the derived class implements 
+/// calculate_dependent_variables_dots_parameters_Jacobian(). Otherwise, it returns an empty matrix. 
+/// @param neural_network Neural network which represents the external inputs to the mathematical model. 
+
+Matrix<double> OrdinaryDifferentialEquations::calculate_final_solutions_parameters_Jacobian(const NeuralNetwork& neural_network) const
+{
+   if(solution_method != RungeKutta)
+   {
+      Matrix<double> final_solutions_parameters_Jacobian;
+
+      return(final_solutions_parameters_Jacobian);
+   }
+
+   return(calculate_Runge_Kutta_final_solution_parameters_Jacobian(neural_network));
+}
+
+
 // std::string to_string(void) const method
 
 /// This method returns a string representation of the current ordinary differential equations object. 
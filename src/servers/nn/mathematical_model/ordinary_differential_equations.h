@@ -129,6 +129,9 @@ public:
 
    virtual Vector<double> calculate_dependent_variables_dots(const NeuralNetwork&, const Vector<double>&) const = 0;
 
+   virtual Matrix<double> calculate_dependent_variables_dots_Jacobian(const NeuralNetwork&, const Vector<double>&) const;
+   virtual Matrix<double> calculate_dependent_variables_dots_parameters_Jacobian(const NeuralNetwork&, const Vector<double>&) const;
+
    // Numerical solution methods
 
    Matrix<double> calculate_Runge_Kutta_solution(const NeuralNetwork&) const;
@@ -140,6 +143,12 @@ public:
    virtual Matrix<double> calculate_solutions(const NeuralNetwork&) const;
    virtual Vector<double> calculate_final_solutions(const NeuralNetwork&) const;
 
+   // Sensitivity methods
+
+   Matrix<double> calculate_Runge_Kutta_final_solution_parameters_Jacobian(const NeuralNetwork&) const;
+
+   virtual Matrix<double> calculate_final_solutions_parameters_Jacobian(const NeuralNetwork&) const;
+
    // Serialization methods
 
    std::string to_string(void) const;
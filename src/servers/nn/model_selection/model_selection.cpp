@@ -19,8 +19,12 @@
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <algorithm>
 #include <cmath>
 #include <ctime>
+#include <limits>
+#include <memory>
+#include <vector>
 
 // OpenNN includes
 
@@ -88,6 +92,16 @@ TrainingStrategy* ModelSelection::get_training_strategy_pointer(void) const
 }
 
 
+// const Vector< Vector<unsigned int> >& get_inputs_indices(void) const method
+
+/// This method returns the indices of the data set variables used as inputs by each candidate of the model inputs selection. 
+
+const Vector< Vector<unsigned int> >& ModelSelection::get_inputs_indices(void) const
+{
+   return(inputs_indices);
+}
+
+
 // const Vector<unsigned int>& get_hidden_perceptrons_numbers(void) const method
 
 /// This method returns the complexities of the neural networks given by the numbers of hidden perceptrons. 
@@ -108,6 +122,27 @@ const unsigned int& ModelSelection::get_parameters_assays_number(void) const
 }
 
 
+// const unsigned int& get_threads_number(void) const method
+
+/// This method returns the number of threads which train the candidates concurrently. 
+
+const unsigned int& ModelSelection::get_threads_number(void) const
+{
+   return(threads_number);
+}
+
+
+// const bool& get_successive_halving_flag(void) const method
+
+/// This method returns true if the worst half of the candidates is discarded after each round of assays, 
+/// and false if all the candidates are trained the parameters assays number of times. 
+
+const bool& ModelSelection::get_successive_halving_flag(void) const
+{
+   return(successive_halving_flag);
+}
+
+
 // const bool& get_reserve_parameters_data(void) method
 
 /// This method returns true if the neural network parameters are to be reserved, and false otherwise. 
@@ -202,16 +237,49 @@ void ModelSelection::set_training_strategy_pointer(TrainingStrategy* new_trainin
 
 // void set_default(void) method
 
-/// @todo
+/// This method sets the members of the model selection object to their default values:
+/// <ul>
+/// <li> Parameters assays number: 1.
+/// <li> Threads number: Number of hardware threads.
+/// <li> Successive halving: False.
+/// <li> Reserve evaluation data, generalization evaluation data and minimal parameters: True.
+/// <li> Reserve parameters data, statistics and plot: False.
+/// <li> Display: True.
+/// </ul>
 
 void ModelSelection::set_default(void)
 {
 //   set_assays_numbers(5, 3);
 
+   parameters_assays_number = 1;
+
+   threads_number = ThreadPool::count_hardware_threads_number();
+
+   successive_halving_flag = false;
+
+   reserve_parameters_data = false;
+   reserve_evaluation_data = true;
+   reserve_generalization_evaluation_data = true;
+   reserve_minimal_parameters = true;
+   reserve_evaluation_data_statistics = false;
+   reserve_generalization_evaluation_data_statistics = false;
+   reserve_model_order_selection_plot = false;
+
    display = true;
 }
 
 
+// void set_inputs_indices(const Vector< Vector<unsigned int> >&) method
+
+/// This method sets the candidates of the model inputs selection process. 
+/// @param new_inputs_indices Indices of the data set variables used as inputs by each candidate. 
+
+void ModelSelection::set_inputs_indices(const Vector< Vector<unsigned int> >& new_inputs_indices)
+{
+   inputs_indices = new_inputs_indices;
+}
+
+
 // void set_hidden_perceptrons_numbers(const Vector<unsigned int>&) method
 
 /// This method sets the number of complexities to be compared in the model order selection process.
@@ -234,6 +302,39 @@ void ModelSelection::set_parameters_assays_number(const unsigned int& new_parame
 }
 
 
+// void set_threads_number(const unsigned int&) method
+
+/// This method sets the number of threads which train the candidates concurrently. 
+/// Each thread works on its own copies of the neural network, the performance functional and the training strategy, 
+/// and of the data set for inputs selection. 
+/// @param new_threads_number Number of threads. Zero means the number of hardware threads. 
+
+void ModelSelection::set_threads_number(const unsigned int& new_threads_number)
+{
+   if(new_threads_number == 0)
+   {
+      threads_number = ThreadPool::count_hardware_threads_number();
+   }
+   else
+   {
+      threads_number = new_threads_number;
+   }
+}
+
+
+// void set_successive_halving_flag(const bool&) method
+
+/// This method sets whether obviously losing candidates are discarded early. 
+/// In that case all the candidates are trained once, then the half with the largest generalization evaluations is discarded 
+/// and the number of assays of the rest doubles, until the parameters assays number is reached. 
+/// @param new_successive_halving_flag True for successive halving, false for training all the candidates fully. 
+
+void ModelSelection::set_successive_halving_flag(const bool& new_successive_halving_flag)
+{
+   successive_halving_flag = new_successive_halving_flag;
+}
+
+
 // void set_assays_numbers(const unsigned int&, const unsigned int&) method
 
 /// This method sets the numbers of complexities and assays. 
@@ -460,337 +561,513 @@ void ModelSelection::check(void) const
 
 // ModelSelectionResults perform_model_inputs_selection(void) const method
 
-/// @todo
+/// This method trains neural networks with the different sets of inputs given by the inputs indices. 
+/// Finally, it sets the data set inputs and the neural network to those of the candidate with minimum generalization evaluation. 
+/// The statistics of the variables for the scaling layer are calculated once for all the candidates. 
 
 ModelSelection::ModelSelectionResults ModelSelection::perform_model_inputs_selection(void) const
 {
-   std::ostringstream buffer;
-
-   buffer << "OpenNN Exception: ModelSelection class.\n"
-          << "ModelSelectionResults perform_model_inputs_selection(void) const method.\n"
-          << "This method is under development.\n";
-
-   throw std::logic_error(buffer.str().c_str());
-/*
    #ifdef _DEBUG 
 
    check();
 
    #endif
 
-   // Training strategy stuff
+   std::ostringstream buffer;
 
-   // Performance functional stuff
+   if(inputs_indices.empty())
+   {
+      buffer << "OpenNN Exception: ModelSelection class.\n"
+             << "ModelSelectionResults perform_model_inputs_selection(void) const method.\n"
+             << "Inputs indices are empty.\n";
 
-   const PerformanceFunctional* performance_functional_pointer = training_strategy_pointer->get_performance_functional_pointer();
+      throw std::logic_error(buffer.str().c_str());
+   }
 
-   // Neural network stuff
+   const PerformanceTerm* objective_term_pointer = training_strategy_pointer->get_performance_functional_pointer()->get_objective_term_pointer();
 
-   NeuralNetwork* neural_network_pointer = performance_functional_pointer->get_neural_network_pointer(); 
+   if(!objective_term_pointer || !objective_term_pointer->get_data_set_pointer())
+   {
+      buffer << "OpenNN Exception: ModelSelection class.\n"
+             << "ModelSelectionResults perform_model_inputs_selection(void) const method.\n"
+             << "Pointer to data set of objective term is NULL.\n";
+
+      throw std::logic_error(buffer.str().c_str());
+   }
 
-   MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
+   return(perform_candidates_selection(true));
+}
+
+
+// ModelSelectionResults perform_model_order_selection(void) method
+
+/// This method trains neural networks with the different numbers of hidden perceptrons. 
+/// Finally, it sets the neural network to the candidate with minimum generalization evaluation. 
 
+ModelSelection::ModelSelectionResults ModelSelection::perform_model_order_selection(void) const
+{
    #ifdef _DEBUG 
 
+   check();
+
+   #endif
+
+   std::ostringstream buffer;
+
+   if(hidden_perceptrons_numbers.empty())
+   {
+      buffer << "OpenNN Exception: ModelSelection class.\n"
+             << "ModelSelectionResults perform_model_order_selection(void) method.\n"
+             << "Hidden perceptrons numbers are empty.\n";
+
+      throw std::logic_error(buffer.str().c_str());
+   }
+
+   const MultilayerPerceptron* multilayer_perceptron_pointer 
+   = training_strategy_pointer->get_performance_functional_pointer()->get_neural_network_pointer()->get_multilayer_perceptron_pointer();
+
    const unsigned int layers_number = multilayer_perceptron_pointer->count_layers_number();
 
    if(layers_number != 2) 
    {
-     std::ostringstream buffer;
-
       buffer << "OpenNN Exception: ModelSelection class.\n"
-             << "ModelSelectionResults perform_model_inputs_selection(void) method.\n"
+             << "ModelSelectionResults perform_model_order_selection(void) method.\n"
              << "Number of layers in multilayer perceptron must be two.\n";
 
       throw std::logic_error(buffer.str().c_str());
    }   
 
-   #endif
+   return(perform_candidates_selection(false));
+}
 
-   // Model order selection stuff
 
-   const unsigned int inputs_assays_number = hidden_perceptrons_numbers.size();
+// ModelSelectionResults perform_model_selection(void) const method
 
-   ModelSelectionResults model_selection_results;
-   model_selection_results.parameters_data.set(inputs_assays_number, parameters_assays_number);
-   model_selection_results.evaluation_data.set(inputs_assays_number, parameters_assays_number);
-   model_selection_results.generalization_evaluation_data.set(inputs_assays_number, parameters_assays_number);
+/// @todo
 
-   time_t beginning_time, current_time;
-   time(&beginning_time);
-   double elapsed_time;
+ModelSelection::ModelSelectionResults ModelSelection::perform_model_selection(void) const
+{
+   std::ostringstream buffer;
 
-   unsigned int assay_count = 0;
+   buffer << "OpenNN Exception: ModelSelection class.\n"
+          << "ModelSelectionResults perform_model_selection(void) method.\n"
+          << "This method is under development.\n";
 
-   for(unsigned int i = 0; i < inputs_assays_number; i++)
-   {
-      //multilayer_perceptron_pointer->set_inputs_number(1);
+   throw std::logic_error(buffer.str().c_str());
 
-      for(unsigned int j = 0; j < parameters_assays_number; j++)
-	  {
-         try
-		 {
-            assay_count++; 
+//   ModelSelectionResults model_selection_results;
 
-			// Multilayer perceptron
+//   return(model_selection_results);
+}
 
-            multilayer_perceptron_pointer->initialize_parameters_normal();
 
-			// Performance functional 
+// CANDIDATE WORKSPACE CONSTRUCTOR
 
-			// Training algorithm
+/// Candidate workspace constructor. 
+/// It copies the neural network and the performance functional of a training strategy, and the data set for inputs selection. 
+/// The training algorithms are constructed anew, with the settings of the original ones. 
+/// The performance terms of the copy use a single thread, as the candidates are trained concurrently. 
+/// @param other_training_strategy Training strategy to be copied. 
+/// @param inputs_selection True if the candidates differ in their inputs, false if they differ in their hidden perceptrons numbers. 
 
-   	        training_strategy_pointer->perform_training();
-	   
-			// Model order selection
+ModelSelection::CandidateWorkspace::CandidateWorkspace(TrainingStrategy& other_training_strategy, const bool& inputs_selection)
+ : data_set_pointer(NULL)
+ , neural_network(*other_training_strategy.get_performance_functional_pointer()->get_neural_network_pointer())
+ , performance_functional(*other_training_strategy.get_performance_functional_pointer())
+ , training_strategy(&performance_functional)
+{
+   performance_functional.set_neural_network_pointer(&neural_network);
+   performance_functional.set_threads_number(1);
 
-		    model_selection_results.parameters_data[i][j] = multilayer_perceptron_pointer->arrange_parameters();
+   if(inputs_selection)
+   {
+      PerformanceTerm* objective_term_pointer = performance_functional.get_objective_term_pointer();
+      PerformanceTerm* regularization_term_pointer = performance_functional.get_regularization_term_pointer();
+      PerformanceTerm* constraints_term_pointer = performance_functional.get_constraints_term_pointer();
 
-		    model_selection_results.evaluation_data[i][j] = training_strategy_pointer->get_performance_functional_pointer()->calculate_evaluation();
-		    model_selection_results.generalization_evaluation_data[i][j] = training_strategy_pointer->get_performance_functional_pointer()->calculate_generalization_evaluation();			
+      DataSet* other_data_set_pointer = objective_term_pointer->get_data_set_pointer();
 
-            time(&current_time);
-            elapsed_time = difftime(current_time, beginning_time);
+      data_set_pointer = new DataSet(*other_data_set_pointer);
 
-			if(display)
-			{
-               std::cout << "Assay " << assay_count << ";\n"
-                         << "Hidden layer size: " << hidden_perceptrons_numbers[i] << "\n"
-                         << "Parameters set: " << j+1 << "\n"
-						 << "Evaluation: " << model_selection_results.evaluation_data[i][j] << "\n"
-						 << "Generalization evaluation: " << model_selection_results.generalization_evaluation_data[i][j] << "\n"
-						 << "Elapsed time: " << elapsed_time << std::endl;
-			}
-		 }
-         catch(std::logic_error& e)
-         {
-            std::cerr << e.what() << std::endl;
-         }
+      objective_term_pointer->set_data_set_pointer(data_set_pointer);
+
+      if(regularization_term_pointer && regularization_term_pointer->get_data_set_pointer() == other_data_set_pointer)
+      {
+         regularization_term_pointer->set_data_set_pointer(data_set_pointer);
+      }
+
+      if(constraints_term_pointer && constraints_term_pointer->get_data_set_pointer() == other_data_set_pointer)
+      {
+         constraints_term_pointer->set_data_set_pointer(data_set_pointer);
       }
    }
 
-   const Vector<unsigned int> minimal_indices = model_selection_results.generalization_evaluation_data.calculate_minimal_indices();
+   // Training algorithms
+
+   if(other_training_strategy.get_initialization_training_algorithm_flag())
+   {
+      training_strategy.construct_initialization_training_algorithm(other_training_strategy.get_initialization_training_algorithm_type());
 
-   const Vector<double> minimal_parameters = model_selection_results.parameters_data[minimal_indices [0]][minimal_indices[1]];
+      copy_training_algorithm(other_training_strategy.get_initialization_training_algorithm_pointer(), training_strategy.get_initialization_training_algorithm_pointer());
+   }
 
-   multilayer_perceptron_pointer->set_parameters(minimal_parameters);
+   if(other_training_strategy.get_main_training_algorithm_flag())
+   {
+      training_strategy.construct_main_training_algorithm(other_training_strategy.get_main_training_algorithm_type());
 
-   return(model_selection_results);
-*/
+      copy_training_algorithm(other_training_strategy.get_main_training_algorithm_pointer(), training_strategy.get_main_training_algorithm_pointer());
+   }
+   else
+   {
+      training_strategy.set_main_training_algorithm_flag(false);
+   }
+
+   if(other_training_strategy.get_refinement_training_algorithm_flag())
+   {
+      training_strategy.construct_refinement_training_algorithm(other_training_strategy.get_refinement_training_algorithm_type());
+
+      copy_training_algorithm(other_training_strategy.get_refinement_training_algorithm_pointer(), training_strategy.get_refinement_training_algorithm_pointer());
+   }
+
+   training_strategy.set_display(false);
 }
 
 
-// ModelSelectionResults perform_model_order_selection(void) method
+// CANDIDATE WORKSPACE DESTRUCTOR
 
-/// @todo
+/// Candidate workspace destructor. 
 
-ModelSelection::ModelSelectionResults ModelSelection::perform_model_order_selection(void) const
+ModelSelection::CandidateWorkspace::~CandidateWorkspace(void)
 {
-   std::ostringstream buffer;
+   delete data_set_pointer;
+}
 
-   buffer << "OpenNN Exception: ModelSelection class.\n"
-          << "ModelSelectionResults perform_model_order_selection(void) method.\n"
-          << "This method is under development.\n";
 
-   throw std::logic_error(buffer.str().c_str());
-/*
-   // Training algorithm stuff
+// static void copy_training_algorithm(const TrainingAlgorithm*, TrainingAlgorithm*) method
 
-   #ifdef _DEBUG 
+/// This method copies the settings of a training algorithm into another one of the same type, through their XML representation. 
+/// User training algorithms cannot be constructed by the training strategy, and so they cannot be copied. 
+/// @param source_pointer Pointer to the training algorithm to be copied. 
+/// @param destination_pointer Pointer to the training algorithm which receives the settings. 
 
-   check();
+void ModelSelection::copy_training_algorithm(const TrainingAlgorithm* source_pointer, TrainingAlgorithm* destination_pointer)
+{
+   if(!source_pointer || !destination_pointer)
+   {
+      std::ostringstream buffer;
 
-   #endif
+      buffer << "OpenNN Exception: ModelSelection class.\n"
+             << "static void copy_training_algorithm(const TrainingAlgorithm*, TrainingAlgorithm*) method.\n"
+             << "Training algorithms of candidates must be constructed by the training strategy.\n";
 
-   // Performance functional stuff
+      throw std::logic_error(buffer.str().c_str());
+   }
 
-   const PerformanceFunctional* performance_functional_pointer = training_strategy_pointer->get_performance_functional_pointer();
+   TiXmlElement* training_algorithm_element = source_pointer->to_XML();
 
-   DataSet* data_set_pointer = performance_functional_pointer->get_objective_term_pointer()->get_data_set_pointer();
+   if(training_algorithm_element)
+   {
+      destination_pointer->from_XML(training_algorithm_element);
 
-   VariablesInformation* variables_information_pointer = data_set_pointer->get_variables_information_pointer();
+      delete training_algorithm_element;
+   }
 
-   // Neural network stuff
+   destination_pointer->set_display(false);
+}
 
-   NeuralNetwork* neural_network_pointer = performance_functional_pointer->get_neural_network_pointer(); 
 
-   MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
+// void set_candidate(const unsigned int&, const bool&, const Vector< Vector<double> >&, NeuralNetwork&, DataSet*) const method
 
-   #ifdef _DEBUG 
+/// This method sets the architecture of a neural network, and the inputs of a data set, to those of a candidate. 
+/// @param candidate_index Index of candidate. 
+/// @param inputs_selection True if the candidate is given by the inputs indices, false if it is given by the hidden perceptrons numbers. 
+/// @param variables_statistics Minimums, maximums, means and standard deviations of all the data set variables, 
+/// from which those of the scaling layer are taken. 
+/// @param neural_network Neural network to be set. 
+/// @param data_set_pointer Pointer to the data set to be set, only for inputs selection. 
 
-   const unsigned int layers_number = multilayer_perceptron_pointer->count_layers_number();
+void ModelSelection::set_candidate(const unsigned int& candidate_index, const bool& inputs_selection, const Vector< Vector<double> >& variables_statistics, NeuralNetwork& neural_network, DataSet* data_set_pointer) const
+{
+   MultilayerPerceptron* multilayer_perceptron_pointer = neural_network.get_multilayer_perceptron_pointer();
 
-   if(layers_number != 2) 
+   if(!inputs_selection)
+   {
+      multilayer_perceptron_pointer->set_layer_perceptrons_number(0, hidden_perceptrons_numbers[candidate_index]);
+
+      return;
+   }
+
+   const Vector<unsigned int>& candidate_inputs_indices = inputs_indices[candidate_index];
+
+   const unsigned int inputs_number = candidate_inputs_indices.size();
+
+   data_set_pointer->get_variables_information_pointer()->set_inputs_indices(candidate_inputs_indices);
+
+   multilayer_perceptron_pointer->set_inputs_number(inputs_number);
+
+   ScalingLayer* scaling_layer_pointer = neural_network.get_scaling_layer_pointer();
+
+   if(scaling_layer_pointer)
+   {
+      Vector< Vector<double> > statistics(4);
+
+      for(unsigned int i = 0; i < 4; i++)
+      {
+         statistics[i].set(inputs_number);
+
+         for(unsigned int j = 0; j < inputs_number; j++)
+         {
+            statistics[i][j] = variables_statistics[i][candidate_inputs_indices[j]];
+         }
+      }
+
+      const ScalingLayer::ScalingMethod scaling_method = scaling_layer_pointer->get_scaling_method();
+
+      scaling_layer_pointer->set(statistics);
+      scaling_layer_pointer->set_scaling_method(scaling_method);
+   }
+
+   InputsOutputsInformation* inputs_outputs_information_pointer = neural_network.get_inputs_outputs_information_pointer();
+
+   if(inputs_outputs_information_pointer)
    {
-     std::ostringstream buffer;
+      inputs_outputs_information_pointer->set_inputs_number(inputs_number);
+   }
+}
+
+
+// ModelSelectionResults perform_candidates_selection(const bool&) const method
+
+/// This method trains the candidates of the model inputs selection or the model order selection. 
+/// The assays are handed out to a pool of threads, each of which trains them on its own candidate workspace. 
+/// With successive halving, all the candidates are first trained once. 
+/// Then the half of them with the largest minimal generalization evaluation is discarded, and the rest are trained 
+/// as many more times, until the parameters assays number is reached. 
+/// Finally, the neural network is set to the candidate and the parameters with minimum generalization evaluation. 
+/// @param inputs_selection True for model inputs selection, false for model order selection. 
+
+ModelSelection::ModelSelectionResults ModelSelection::perform_candidates_selection(const bool& inputs_selection) const
+{
+   if(parameters_assays_number == 0)
+   {
+      std::ostringstream buffer;
 
       buffer << "OpenNN Exception: ModelSelection class.\n"
-             << "ModelSelectionResults perform_model_order_selection(void) method.\n"
-             << "Number of layers in multilayer perceptron must be two.\n";
+             << "ModelSelectionResults perform_candidates_selection(const bool&) const method.\n"
+             << "Number of parameters assays must be greater than zero.\n";
 
       throw std::logic_error(buffer.str().c_str());
-   }   
+   }
 
-   #endif
+   // Performance functional stuff
 
-   // Model order selection stuff
+   PerformanceFunctional* performance_functional_pointer = training_strategy_pointer->get_performance_functional_pointer();
 
-   const unsigned int complexity_assays_number = hidden_perceptrons_numbers.size();
+   DataSet* data_set_pointer = inputs_selection ? performance_functional_pointer->get_objective_term_pointer()->get_data_set_pointer() : NULL;
 
-   ModelSelectionResults model_order_selection_results;
+   // Neural network stuff
 
-   if(reserve_parameters_data)
-   {
-      model_order_selection_results.parameters_data.set(complexity_assays_number, parameters_assays_number);
-   }  
-	 
-   if(reserve_evaluation_data)
+   NeuralNetwork* neural_network_pointer = performance_functional_pointer->get_neural_network_pointer(); 
+
+   Vector< Vector<double> > variables_statistics;
+
+   if(inputs_selection && neural_network_pointer->get_scaling_layer_pointer())
    {
-      model_order_selection_results.evaluation_data.set(complexity_assays_number, parameters_assays_number);
+      variables_statistics = data_set_pointer->calculate_data_statistics();
    }
 
-   if(reserve_generalization_evaluation_data)
+   // Candidate workspaces
+
+   ThreadPool thread_pool(threads_number);
+
+   std::vector< std::unique_ptr<CandidateWorkspace> > candidate_workspaces(thread_pool.count_threads_number());
+
+   for(unsigned int i = 0; i < candidate_workspaces.size(); i++)
    {
-      model_order_selection_results.generalization_evaluation_data.set(complexity_assays_number, parameters_assays_number);
+      candidate_workspaces[i].reset(new CandidateWorkspace(*training_strategy_pointer, inputs_selection));
    }
 
+   // Model selection stuff
+
+   const unsigned int candidates_number = inputs_selection ? inputs_indices.size() : hidden_perceptrons_numbers.size();
+
+   Matrix< Vector<double> > parameters_data(candidates_number, parameters_assays_number);
+   Matrix<double> evaluation_data(candidates_number, parameters_assays_number, 0.0);
+   Matrix<double> generalization_evaluation_data(candidates_number, parameters_assays_number, 0.0);
+
+   Vector<unsigned int> assays_numbers(candidates_number, 0);
+
+   Vector<double> minimal_generalization_evaluations(candidates_number, std::numeric_limits<double>::max());
+   Vector<unsigned int> minimal_assays_indices(candidates_number, 0);
+
+   Vector<unsigned int> candidates_indices(0, 1, candidates_number-1);
+
+   unsigned int round_assays_number = successive_halving_flag ? 1 : parameters_assays_number;
+
    time_t beginning_time, current_time;
    time(&beginning_time);
    double elapsed_time;
 
-   unsigned int assay_count = 0;
-
-   for(unsigned int i = 0; i < complexity_assays_number; i++)
+   while(true)
    {
-	  variables_information_pointer->set_inputs_indices(inputs_indices[i]);
+      // Assays of this round
 
-      //multilayer_perceptron_pointer->set_layer_perceptrons_number(0, hidden_perceptrons_numbers[i]);
+      Vector<unsigned int> tasks_candidates_indices;
+      Vector<unsigned int> tasks_assays_indices;
+
+      for(unsigned int i = 0; i < candidates_indices.size(); i++)
+      {
+         for(unsigned int j = assays_numbers[candidates_indices[i]]; j < round_assays_number; j++)
+         {
+            tasks_candidates_indices.push_back(candidates_indices[i]);
+            tasks_assays_indices.push_back(j);
+         }
+      }
 
-      for(unsigned int j = 0; j < parameters_assays_number; j++)
-	  {
-         try
-		 {
-            assay_count++; 
+      thread_pool.run(tasks_candidates_indices.size(), [&](const unsigned int& task_index, const unsigned int& thread_index)
+      {
+         CandidateWorkspace& candidate_workspace = *candidate_workspaces[thread_index];
 
-			// Multilayer perceptron
+         const unsigned int i = tasks_candidates_indices[task_index];
+         const unsigned int j = tasks_assays_indices[task_index];
 
-            multilayer_perceptron_pointer->initialize_parameters_normal();
+         set_candidate(i, inputs_selection, variables_statistics, candidate_workspace.neural_network, candidate_workspace.data_set_pointer);
 
-			// Performance functional 
+         candidate_workspace.neural_network.initialize_parameters_normal();
 
-			// Training algorithm
+         const TrainingStrategy::Results training_strategy_results = candidate_workspace.training_strategy.perform_training();
 
-   	        training_strategy_pointer->perform_training();
-	   
-			// Model order selection
+         delete training_strategy_results.initialization_training_algorithm_results_pointer;
+         delete training_strategy_results.main_training_algorithm_results_pointer;
+         delete training_strategy_results.refinement_training_algorithm_results_pointer;
 
-            if(reserve_parameters_data)
-            {
-		       model_order_selection_results.parameters_data[i][j] = multilayer_perceptron_pointer->arrange_parameters();
-			}
+         parameters_data[i][j] = candidate_workspace.neural_network.arrange_parameters();
+         evaluation_data[i][j] = candidate_workspace.performance_functional.calculate_evaluation();
+         generalization_evaluation_data[i][j] = candidate_workspace.performance_functional.calculate_generalization_evaluation();
+      });
 
-            if(reserve_parameters_data)
-            {
-		       model_order_selection_results.evaluation_data[i][j] = training_strategy_pointer->get_performance_functional_pointer()->calculate_evaluation();
-			}
+      for(unsigned int i = 0; i < candidates_indices.size(); i++)
+      {
+         const unsigned int candidate_index = candidates_indices[i];
 
-            if(reserve_parameters_data)
-            {
-		       model_order_selection_results.generalization_evaluation_data[i][j] = training_strategy_pointer->get_performance_functional_pointer()->calculate_generalization_evaluation();			
-			}
-
-            time(&current_time);
-            elapsed_time = difftime(current_time, beginning_time);
-
-			if(display)
-			{
-               std::cout << "Assay " << assay_count << ";\n"
-                         << "Hidden layer size: " << hidden_perceptrons_numbers[i] << "\n"
-                         << "Parameters set: " << j+1 << "\n"
-						 << "Evaluation: " << model_order_selection_results.evaluation_data[i][j] << "\n"
-						 << "Generalization performance: " << model_order_selection_results.generalization_evaluation_data[i][j] << "\n"
-						 << "Elapsed time: " << elapsed_time << std::endl;
-			}
-		 }
-         catch(std::logic_error& e)
+         for(unsigned int j = assays_numbers[candidate_index]; j < round_assays_number; j++)
          {
-            std::cerr << e.what() << std::endl;
+            if(generalization_evaluation_data[candidate_index][j] < minimal_generalization_evaluations[candidate_index])
+            {
+               minimal_generalization_evaluations[candidate_index] = generalization_evaluation_data[candidate_index][j];
+               minimal_assays_indices[candidate_index] = j;
+            }
          }
+
+         assays_numbers[candidate_index] = round_assays_number;
       }
-   }
 
+      time(&current_time);
+      elapsed_time = difftime(current_time, beginning_time);
 
-   Vector<unsigned int> minimal_indices = model_order_selection_results.generalization_evaluation_data.calculate_minimal_indices();
+      if(display)
+      {
+         for(unsigned int i = 0; i < candidates_indices.size(); i++)
+         {
+            const unsigned int candidate_index = candidates_indices[i];
 
-   Vector<double> minimal_parameters = model_order_selection_results.parameters_data[minimal_indices [0]][minimal_indices[1]];
+            if(inputs_selection)
+            {
+               std::cout << "Inputs indices: " << inputs_indices[candidate_index] << "\n";
+            }
+            else
+            {
+               std::cout << "Hidden layer size: " << hidden_perceptrons_numbers[candidate_index] << "\n";
+            }
 
-   multilayer_perceptron_pointer->set_parameters(minimal_parameters);
+            std::cout << "Parameters sets: " << assays_numbers[candidate_index] << "\n"
+                      << "Minimal generalization evaluation: " << minimal_generalization_evaluations[candidate_index] << "\n";
+         }
 
-   if(reserve_minimal_parameters)
-   {
-   }
+         std::cout << "Elapsed time: " << elapsed_time << std::endl;
+      }
 
-// Vector< Vector<double> > calculate_performance_data_statistics(const ModelSelectionResults&) const method
-//   return(model_order_selection_data.performance_data.calculate_transpose().calculate_statistics());  
+      if(round_assays_number == parameters_assays_number)
+      {
+         break;
+      }
 
-// Vector< Vector<double> > calculate_generalization_evaluation_data_statistics(const ModelSelectionResults&) const method
-   //   return(model_order_selection_data.generalization_evaluation_data.calculate_transpose().calculate_statistics());  
+      // Discard the worst half of the candidates
 
-//   unsigned int complexities_number = hidden_perceptrons_numbers.size();
+      std::stable_sort(candidates_indices.begin(), candidates_indices.end(), [&](const unsigned int& a, const unsigned int& b)
+      {
+         return(minimal_generalization_evaluations[a] < minimal_generalization_evaluations[b]);
+      });
 
-//   file << "# Performance data\n\n";
+      candidates_indices.resize((candidates_indices.size()+1)/2);
 
-//   for(unsigned int i = 0; i < complexities_number; i++)
-//   {    
-//      file << hidden_perceptrons_numbers[i] << " ";
+      if(candidates_indices.size() == 1)
+      {
+         round_assays_number = parameters_assays_number;
+      }
+      else
+      {
+         round_assays_number = std::min(2*round_assays_number, parameters_assays_number);
+      }
+   }
 
-//      for(unsigned int j = 0; j < parameters_assays_number; j++)
-//	  {
-//	     file << model_order_selection_data.performance_data[i][j] << " ";
-//	  }
+   // Minimal candidate
 
-//	  file << "\n";
-//   }
+   const unsigned int minimal_candidate_index = minimal_generalization_evaluations.calculate_minimal_index();
 
-//   file << "\n";
+   const Vector<double>& minimal_parameters = parameters_data[minimal_candidate_index][minimal_assays_indices[minimal_candidate_index]];
 
-//   file << "# Validation performance data\n\n";
+   set_candidate(minimal_candidate_index, inputs_selection, variables_statistics, *neural_network_pointer, data_set_pointer);
 
-//   for(unsigned int i = 0; i < complexities_number; i++)
-//   {    
-//      file << hidden_perceptrons_numbers[i] << " ";
+   neural_network_pointer->set_parameters(minimal_parameters);
 
-//      for(unsigned int j = 0; j < parameters_assays_number; j++)
-//	  {
-//	     file << model_order_selection_data.generalization_evaluation_data[i][j] << " ";
-//	  }
+   // Model selection results
 
-//	  file << "\n";
-//   }
+   ModelSelectionResults model_selection_results;
 
+   model_selection_results.assays_numbers = assays_numbers;
 
-   return(model_order_selection_results);
-*/
-}
+   if(reserve_parameters_data)
+   {
+      model_selection_results.parameters_data = parameters_data;
+   }
 
+   if(reserve_evaluation_data)
+   {
+      model_selection_results.evaluation_data = evaluation_data;
+   }
 
-// ModelSelectionResults perform_model_selection(void) const method
+   if(reserve_generalization_evaluation_data)
+   {
+      model_selection_results.generalization_evaluation_data = generalization_evaluation_data;
+   }
 
-/// @todo
+   if(reserve_minimal_parameters)
+   {
+      model_selection_results.minimal_parameters = minimal_parameters;
+   }
 
-ModelSelection::ModelSelectionResults ModelSelection::perform_model_selection(void) const
-{
-   std::ostringstream buffer;
+   if(reserve_evaluation_data_statistics)
+   {
+      model_selection_results.evaluation_data_statistics.set(candidates_number);
 
-   buffer << "OpenNN Exception: ModelSelection class.\n"
-          << "ModelSelectionResults perform_model_selection(void) method.\n"
-          << "This method is under development.\n";
+      for(unsigned int i = 0; i < candidates_number; i++)
+      {
+         model_selection_results.evaluation_data_statistics[i] = evaluation_data.arrange_row(i).take_out(0, assays_numbers[i]).calculate_statistics();
+      }
+   }
 
-   throw std::logic_error(buffer.str().c_str());
+   if(reserve_generalization_evaluation_data_statistics)
+   {
+      model_selection_results.generalization_evaluation_data_statistics.set(candidates_number);
 
-//   ModelSelectionResults model_selection_results;
+      for(unsigned int i = 0; i < candidates_number; i++)
+      {
+         model_selection_results.generalization_evaluation_data_statistics[i] = generalization_evaluation_data.arrange_row(i).take_out(0, assays_numbers[i]).calculate_statistics();
+      }
+   }
 
-//   return(model_selection_results);
+   return(model_selection_results);
 }
 
 
@@ -830,6 +1107,28 @@ TiXmlElement* ModelSelection::to_XML(void) const
    TiXmlText* parameters_assays_number_text = new TiXmlText(buffer.str().c_str());
    parameters_assays_number_element->LinkEndChild(parameters_assays_number_text);
 
+   // Threads number
+
+   TiXmlElement* threads_number_element = new TiXmlElement("ThreadsNumber");
+   model_order_selection_element->LinkEndChild(threads_number_element);
+
+   buffer.str("");
+   buffer << threads_number;
+
+   TiXmlText* threads_number_text = new TiXmlText(buffer.str().c_str());
+   threads_number_element->LinkEndChild(threads_number_text);
+
+   // Successive halving flag
+
+   TiXmlElement* successive_halving_flag_element = new TiXmlElement("SuccessiveHalvingFlag");
+   model_order_selection_element->LinkEndChild(successive_halving_flag_element);
+
+   buffer.str("");
+   buffer << successive_halving_flag;
+
+   TiXmlText* successive_halving_flag_text = new TiXmlText(buffer.str().c_str());
+   successive_halving_flag_element->LinkEndChild(successive_halving_flag_text);
+
    return(model_order_selection_element);
 }
 
@@ -938,6 +1237,26 @@ void ModelSelection::load(const std::string& filename)
    {
       parameters_assays_number = atoi(parameters_assays_number_element->GetText());           
    }
+
+   // Threads number
+   
+   TiXmlElement* threads_number_element = model_order_selection_element->FirstChildElement("ThreadsNumber");
+
+   if(threads_number_element)
+   {
+      set_threads_number(atoi(threads_number_element->GetText()));
+   }
+
+   // Successive halving flag
+   
+   TiXmlElement* successive_halving_flag_element = model_order_selection_element->FirstChildElement("SuccessiveHalvingFlag");
+
+   if(successive_halving_flag_element)
+   {
+      const std::string new_successive_halving_flag = successive_halving_flag_element->GetText();
+
+      set_successive_halving_flag(new_successive_halving_flag != "0");
+   }
 }
 
 }
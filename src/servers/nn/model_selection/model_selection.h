@@ -20,6 +20,10 @@
 
 #include "../utilities/vector.h"
 #include "../utilities/matrix.h"
+#include "../utilities/thread_pool.h"
+#include "../data_set/data_set.h"
+#include "../neural_network/neural_network.h"
+#include "../performance_functional/performance_functional.h"
 #include "../training_strategy/training_strategy.h"
 
 // TinyXml includes
@@ -31,6 +35,8 @@ namespace OpenNN
 
 /// This class represents the concept of model selection algorithm.
 /// It is used for finding a network architecture with maximum generalization capabilities. 
+/// The candidates are trained concurrently, each thread on its own copies of the neural network, 
+/// the performance functional and the training strategy. 
 
 class ModelSelection
 {
@@ -84,6 +90,11 @@ public:
 	  /// Statistics of the generalization evaluation for the different neural networks.
 
 	  Vector< Vector<double> > generalization_evaluation_data_statistics; 
+
+	  /// Number of assays performed for each candidate. 
+	  /// Only the first assays of each row of the data matrices are set. 
+
+	  Vector<unsigned int> assays_numbers;
    };
 
    // METHODS
@@ -92,9 +103,13 @@ public:
 
    TrainingStrategy* get_training_strategy_pointer(void) const;
 
+   const Vector< Vector<unsigned int> >& get_inputs_indices(void) const;
    const Vector<unsigned int>& get_hidden_perceptrons_numbers(void) const;
    const unsigned int& get_parameters_assays_number(void) const;
 
+   const unsigned int& get_threads_number(void) const;
+   const bool& get_successive_halving_flag(void) const;
+
    const bool& get_reserve_parameters_data(void);
    const bool& get_reserve_evaluation_data(void);
    const bool& get_reserve_generalization_evaluation_data(void);
@@ -111,9 +126,13 @@ public:
 
    void set_default(void);
 
+   void set_inputs_indices(const Vector< Vector<unsigned int> >&);
    void set_hidden_perceptrons_numbers(const Vector<unsigned int>&);
    void set_parameters_assays_number(const unsigned int&);
 
+   void set_threads_number(const unsigned int&);
+   void set_successive_halving_flag(const bool&);
+
    void set_assays_numbers(const unsigned int&, const unsigned int&);
 
    void set_reserve_parameters_data(const bool&);
@@ -149,6 +168,50 @@ public:
 
 private: 
 
+   // STRUCTURES
+
+   ///
+   /// This structure contains the objects with which a thread trains the candidates.
+   /// They are copies of those of the model selection, made once and reused for all the candidates. 
+   ///
+
+   struct CandidateWorkspace
+   {
+      explicit CandidateWorkspace(TrainingStrategy&, const bool&);
+
+      virtual ~CandidateWorkspace(void);
+
+      /// Copy of the data set, only for inputs selection. 
+
+      DataSet* data_set_pointer;
+
+      /// Copy of the neural network. 
+
+      NeuralNetwork neural_network;
+
+      /// Copy of the performance functional, measured on the copy of the neural network. 
+
+      PerformanceFunctional performance_functional;
+
+      /// Training strategy with the same training algorithms and settings as the original one. 
+
+      TrainingStrategy training_strategy;
+
+   private:
+
+      CandidateWorkspace(const CandidateWorkspace&);
+
+      CandidateWorkspace& operator = (const CandidateWorkspace&);
+   };
+
+   // PRIVATE METHODS
+
+   static void copy_training_algorithm(const TrainingAlgorithm*, TrainingAlgorithm*);
+
+   void set_candidate(const unsigned int&, const bool&, const Vector< Vector<double> >&, NeuralNetwork&, DataSet*) const;
+
+   ModelSelectionResults perform_candidates_selection(const bool&) const;
+
    // MEMBERS
 
    /// Pointer to a training strategy object.
@@ -167,6 +230,15 @@ private:
 
    unsigned int parameters_assays_number;
 
+   /// Number of threads which train candidates concurrently. 
+
+   unsigned int threads_number;
+
+   /// True if the worst half of the candidates is discarded after each round of assays, 
+   /// while the number of assays of the rest doubles. 
+
+   bool successive_halving_flag;
+
    // Model selection results
 
    /// True if the parameters of all neural networks are to be reserved. 
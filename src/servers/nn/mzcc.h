@@ -4,6 +4,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "dict.h"
+#include "ir.h"
 #include "list.h"
 #include "util.h"
 
@@ -169,10 +170,12 @@ extern char *ast_to_string(Ast *ast);
 extern char *ctype_to_string(Ctype *ctype);
 
 /* lexer.c */
+extern FILE *infp;
 extern bool is_punct(const Token tok, int c);
 extern void unget_token(const Token tok);
 extern Token peek_token(void);
 extern Token read_token(void);
+extern void reset_lexer(void);
 
 #define get_priv(tok, type)                                       \
     ({                                                            \
@@ -204,6 +207,7 @@ extern List *flonums;
 extern List *ctypes;
 extern char *make_label(void);
 extern List *read_toplevels(void);
+extern void reset_parser(void);
 extern bool is_inttype(Ctype *ctype);
 extern bool is_flotype(Ctype *ctype);
 
@@ -211,4 +215,7 @@ extern bool is_flotype(Ctype *ctype);
 extern void emit_data_section(void);
 extern void emit_toplevel(Ast *v);
 
+/* ir.c */
+extern IRFunc *lower_func(Ast *func, char **err);
+
 #endif /* MAZUCC_H */
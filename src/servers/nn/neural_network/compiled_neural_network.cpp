@@ -0,0 +1,1070 @@
+/****************************************************************************************************************/
+/*                                                                                                              */
+/*   OpenNN: Open Neural Networks Library                                                                       */
+/*   www.opennn.cimne.com                                                                                       */
+/*                                                                                                              */
+/*   C O M P I L E D   N E U R A L   N E T W O R K   C L A S S                                                  */
+/*                                                                                                              */
+/*   Roberto Lopez                                                                                              */
+/*   International Center for Numerical Methods in Engineering (CIMNE)                                          */
+/*   Technical University of Catalonia (UPC)                                                                    */
+/*   Barcelona, Spain                                                                                           */
+/*   E-mail: rlopez@cimne.upc.edu                                                                               */
+/*                                                                                                              */
+/****************************************************************************************************************/
+
+// System includes
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <cmath>
+#include <stdexcept>
+#include <exception>
+#include <algorithm>
+
+// OpenNN includes
+
+#include "compiled_neural_network.h"
+#include "multilayer_perceptron.h"
+#include "scaling_layer.h"
+#include "unscaling_layer.h"
+#include "bounding_layer.h"
+
+#include "../utilities/matrix_kernels.h"
+
+// Machine code is generated with the asmjit library on x86-64 only.
+// Other targets evaluate the flattened layers by loops.
+
+#if defined(__x86_64__) || defined(_M_X64)
+   #define __OPENNN_JIT_X86_64__
+   #ifndef ASMJIT_STATIC
+      #define ASMJIT_STATIC
+   #endif
+   #include "../asmjit/x86.h"
+#endif
+
+namespace OpenNN
+{
+
+#ifdef __OPENNN_JIT_X86_64__
+
+// asmjit::JitRuntime& get_jit_runtime(void) function
+
+/// This function returns the runtime which owns the executable memory of all the compiled neural networks.
+
+static asmjit::JitRuntime& get_jit_runtime(void)
+{
+   static asmjit::JitRuntime jit_runtime;
+
+   return(jit_runtime);
+}
+
+#endif
+
+
+// DEFAULT CONSTRUCTOR
+
+/// Default constructor. It creates a compiled neural network which is not compiled yet.
+
+CompiledNeuralNetwork::CompiledNeuralNetwork(void)
+{
+   compiled = false;
+
+   inputs_number = 0;
+   outputs_number = 0;
+   maximal_layer_size = 0;
+
+   output_transformation_flag = false;
+   probabilistic_flag = false;
+   probabilistic_method = ProbabilisticLayer::Softmax;
+   bounding_flag = false;
+
+   jit_flag = true;
+
+   compiled_function = NULL;
+}
+
+
+// NEURAL NETWORK CONSTRUCTOR
+
+/// Neural network constructor. It creates a compiled version of a given neural network.
+/// @param neural_network Neural network to be compiled.
+
+CompiledNeuralNetwork::CompiledNeuralNetwork(const NeuralNetwork& neural_network)
+{
+   compiled = false;
+
+   inputs_number = 0;
+   outputs_number = 0;
+   maximal_layer_size = 0;
+
+   output_transformation_flag = false;
+   probabilistic_flag = false;
+   probabilistic_method = ProbabilisticLayer::Softmax;
+   bounding_flag = false;
+
+   jit_flag = true;
+
+   compiled_function = NULL;
+
+   compile(neural_network);
+}
+
+
+// DESTRUCTOR
+
+/// Destructor. It releases the generated machine code, if any.
+
+CompiledNeuralNetwork::~CompiledNeuralNetwork(void)
+{
+   release_function();
+}
+
+
+// METHODS
+
+// void compile(const NeuralNetwork&) method
+
+/// This method compiles a neural network, replacing the previous one.
+/// The result computes the same outputs as NeuralNetwork::calculate_outputs, up to rounding errors.
+/// @param neural_network Neural network to be compiled.
+/// It must have a multilayer perceptron, and its conditions layer must not be active.
+
+void CompiledNeuralNetwork::compile(const NeuralNetwork& neural_network)
+{
+   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network.get_multilayer_perceptron_pointer();
+
+   if(!multilayer_perceptron_pointer || !neural_network.get_multilayer_perceptron_flag()
+   || multilayer_perceptron_pointer->count_layers_number() == 0)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: CompiledNeuralNetwork class.\n"
+             << "void compile(const NeuralNetwork&) method.\n"
+             << "Neural network must have a multilayer perceptron.\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   if(neural_network.get_conditions_layer_pointer() && neural_network.get_conditions_layer_flag())
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: CompiledNeuralNetwork class.\n"
+             << "void compile(const NeuralNetwork&) method.\n"
+             << "Neural networks with conditions layer cannot be compiled.\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   clear();
+
+   // Perceptron layers
+
+   const unsigned int layers_number = multilayer_perceptron_pointer->count_layers_number();
+
+   layers.set(layers_number);
+
+   for(unsigned int i = 0; i < layers_number; i++)
+   {
+      const PerceptronLayer& perceptron_layer = multilayer_perceptron_pointer->get_layer(i);
+
+      layers[i].inputs_number = perceptron_layer.count_inputs_number();
+      layers[i].perceptrons_number = perceptron_layer.count_perceptrons_number();
+      layers[i].synaptic_weights = perceptron_layer.arrange_synaptic_weights();
+      layers[i].biases = perceptron_layer.arrange_biases();
+      layers[i].activation_function = perceptron_layer.get_activation_function();
+
+      if(layers[i].perceptrons_number > maximal_layer_size)
+      {
+         maximal_layer_size = layers[i].perceptrons_number;
+      }
+   }
+
+   inputs_number = layers[0].inputs_number;
+   outputs_number = layers[layers_number-1].perceptrons_number;
+
+   // Scaling layer, folded into the first layer as an affine transformation of its inputs
+
+   const ScalingLayer* scaling_layer_pointer = neural_network.get_scaling_layer_pointer();
+
+   if(scaling_layer_pointer && neural_network.get_scaling_layer_flag())
+   {
+      CompiledLayer& first_layer = layers[0];
+
+      for(unsigned int j = 0; j < inputs_number; j++)
+      {
+         double factor = 1.0;
+         double offset = 0.0;
+
+         if(scaling_layer_pointer->get_scaling_method() == ScalingLayer::MinimumMaximum)
+         {
+            const double minimum = scaling_layer_pointer->get_minimum(j);
+            const double range = scaling_layer_pointer->get_maximum(j) - minimum;
+
+            if(range >= 1e-99)
+            {
+               factor = 2.0/range;
+               offset = -2.0*minimum/range - 1.0;
+            }
+         }
+         else
+         {
+            const double standard_deviation = scaling_layer_pointer->get_standard_deviation(j);
+
+            if(standard_deviation >= 1e-99)
+            {
+               factor = 1.0/standard_deviation;
+               offset = -scaling_layer_pointer->get_mean(j)/standard_deviation;
+            }
+         }
+
+         for(unsigned int i = 0; i < first_layer.perceptrons_number; i++)
+         {
+            first_layer.biases[i] += first_layer.synaptic_weights[i][j]*offset;
+            first_layer.synaptic_weights[i][j] *= factor;
+         }
+      }
+   }
+
+   // Unscaling layer, folded into the last layer if it is linear
+
+   const UnscalingLayer* unscaling_layer_pointer = neural_network.get_unscaling_layer_pointer();
+
+   if(unscaling_layer_pointer && neural_network.get_unscaling_layer_flag())
+   {
+      output_factors.set(outputs_number, 1.0);
+      output_offsets.set(outputs_number, 0.0);
+
+      for(unsigned int i = 0; i < outputs_number; i++)
+      {
+         if(unscaling_layer_pointer->get_unscaling_method() == UnscalingLayer::MinimumMaximum)
+         {
+            const double minimum = unscaling_layer_pointer->get_minimum(i);
+            const double range = unscaling_layer_pointer->get_maximum(i) - minimum;
+
+            if(range >= 1e-99)
+            {
+               output_factors[i] = 0.5*range;
+               output_offsets[i] = 0.5*range + minimum;
+            }
+         }
+         else
+         {
+            const double standard_deviation = unscaling_layer_pointer->get_standard_deviation(i);
+
+            if(standard_deviation >= 1e-99)
+            {
+               output_factors[i] = standard_deviation;
+               output_offsets[i] = unscaling_layer_pointer->get_mean(i);
+            }
+         }
+      }
+
+      CompiledLayer& last_layer = layers[layers_number-1];
+
+      if(last_layer.activation_function == Perceptron::Linear)
+      {
+         for(unsigned int i = 0; i < outputs_number; i++)
+         {
+            for(unsigned int j = 0; j < last_layer.inputs_number; j++)
+            {
+               last_layer.synaptic_weights[i][j] *= output_factors[i];
+            }
+
+            last_layer.biases[i] = last_layer.biases[i]*output_factors[i] + output_offsets[i];
+         }
+
+         output_factors.set();
+         output_offsets.set();
+      }
+      else
+      {
+         output_transformation_flag = true;
+      }
+   }
+
+   for(unsigned int i = 0; i < layers_number; i++)
+   {
+      layers[i].synaptic_weights_transpose = layers[i].synaptic_weights.calculate_transpose();
+   }
+
+   // Probabilistic layer
+
+   const ProbabilisticLayer* probabilistic_layer_pointer = neural_network.get_probabilistic_layer_pointer();
+
+   if(probabilistic_layer_pointer && neural_network.get_probabilistic_layer_flag())
+   {
+      probabilistic_flag = true;
+      probabilistic_method = probabilistic_layer_pointer->get_probabilistic_method();
+   }
+
+   // Bounding layer
+
+   const BoundingLayer* bounding_layer_pointer = neural_network.get_bounding_layer_pointer();
+
+   if(bounding_layer_pointer && neural_network.get_bounding_layer_flag())
+   {
+      bounding_flag = true;
+      lower_bounds = bounding_layer_pointer->get_lower_bounds();
+      upper_bounds = bounding_layer_pointer->get_upper_bounds();
+   }
+
+   compiled = true;
+
+   if(jit_flag)
+   {
+      generate_function();
+   }
+}
+
+
+// void clear(void) method
+
+/// This method releases the compiled neural network, leaving this object as if it was just constructed.
+/// The JIT flag is kept.
+
+void CompiledNeuralNetwork::clear(void)
+{
+   release_function();
+
+   compiled = false;
+
+   inputs_number = 0;
+   outputs_number = 0;
+   maximal_layer_size = 0;
+
+   layers.set();
+
+   output_transformation_flag = false;
+   output_factors.set();
+   output_offsets.set();
+
+   probabilistic_flag = false;
+   probabilistic_method = ProbabilisticLayer::Softmax;
+
+   bounding_flag = false;
+   lower_bounds.set();
+   upper_bounds.set();
+}
+
+
+// bool is_compiled(void) const method
+
+/// This method returns true if a neural network has been compiled, and false otherwise.
+
+bool CompiledNeuralNetwork::is_compiled(void) const
+{
+   return(compiled);
+}
+
+
+// bool is_jit_compiled(void) const method
+
+/// This method returns true if the compiled neural network is evaluated by generated machine code,
+/// and false if it is evaluated by loops over the flattened layers.
+
+bool CompiledNeuralNetwork::is_jit_compiled(void) const
+{
+   return(compiled_function != NULL);
+}
+
+
+// const unsigned int& get_inputs_number(void) const method
+
+/// This method returns the number of inputs to the compiled neural network.
+
+const unsigned int& CompiledNeuralNetwork::get_inputs_number(void) const
+{
+   return(inputs_number);
+}
+
+
+// const unsigned int& get_outputs_number(void) const method
+
+/// This method returns the number of outputs from the compiled neural network.
+
+const unsigned int& CompiledNeuralNetwork::get_outputs_number(void) const
+{
+   return(outputs_number);
+}
+
+
+// const bool& get_jit_flag(void) const method
+
+/// This method returns true if machine code is generated when compiling, and false otherwise.
+
+const bool& CompiledNeuralNetwork::get_jit_flag(void) const
+{
+   return(jit_flag);
+}
+
+
+// void set_jit_flag(const bool&) method
+
+/// This method sets whether machine code is generated when compiling.
+/// It takes effect from the next call to compile.
+/// @param new_jit_flag True to generate machine code where possible, false to always evaluate the flattened layers by loops.
+
+void CompiledNeuralNetwork::set_jit_flag(const bool& new_jit_flag)
+{
+   jit_flag = new_jit_flag;
+}
+
+
+// Vector<double> calculate_outputs(const Vector<double>&) const method
+
+/// This method returns the outputs from the compiled neural network for a given vector of inputs.
+/// @param inputs Vector of inputs.
+
+Vector<double> CompiledNeuralNetwork::calculate_outputs(const Vector<double>& inputs) const
+{
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG
+
+   if(inputs.size() != inputs_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: CompiledNeuralNetwork class.\n"
+             << "Vector<double> calculate_outputs(const Vector<double>&) const method.\n"
+             << "Size of inputs must be equal to number of inputs.\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   Vector<double> outputs(outputs_number);
+
+   calculate_output_data(&inputs[0], 1, &outputs[0]);
+
+   return(outputs);
+}
+
+
+// Matrix<double> calculate_output_data(const Matrix<double>&) const method
+
+/// This method returns the outputs from the compiled neural network for a batch of instances.
+/// @param input_data Matrix of inputs, with one row for each instance.
+
+Matrix<double> CompiledNeuralNetwork::calculate_output_data(const Matrix<double>& input_data) const
+{
+   Matrix<double> output_data;
+
+   calculate_output_data(input_data, output_data);
+
+   return(output_data);
+}
+
+
+// void calculate_output_data(const Matrix<double>&, Matrix<double>&) const method
+
+/// This method computes the outputs from the compiled neural network for a batch of instances.
+/// The output matrix is only reallocated if its size changes, so that it can be reused between batches.
+/// @param input_data Matrix of inputs, with one row for each instance.
+/// @param output_data Matrix of outputs, with one row for each instance.
+
+void CompiledNeuralNetwork::calculate_output_data(const Matrix<double>& input_data, Matrix<double>& output_data) const
+{
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG
+
+   if(input_data.get_columns_number() != inputs_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: CompiledNeuralNetwork class.\n"
+             << "void calculate_output_data(const Matrix<double>&, Matrix<double>&) const method.\n"
+             << "Number of columns must be equal to number of inputs.\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   const unsigned int instances_number = input_data.get_rows_number();
+
+   if(output_data.get_rows_number() != instances_number || output_data.get_columns_number() != outputs_number)
+   {
+      output_data.set(instances_number, outputs_number);
+   }
+
+   if(instances_number != 0)
+   {
+      calculate_output_data(input_data[0], instances_number, output_data[0]);
+   }
+}
+
+
+// void calculate_output_data(const double*, const unsigned int&, double*) const method
+
+/// This method computes the outputs from the compiled neural network for a batch of instances in raw memory.
+/// It does not allocate memory if the neural network has been translated into machine code.
+/// It can be called from several threads at the same time.
+/// @param input_data Inputs of the instances, one after the other.
+/// @param instances_number Number of instances.
+/// @param output_data Array where the outputs of the instances are written, one after the other.
+
+void CompiledNeuralNetwork::calculate_output_data(const double* input_data, const unsigned int& instances_number, double* output_data) const
+{
+   // Control sentence
+
+   if(!compiled)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: CompiledNeuralNetwork class.\n"
+             << "void calculate_output_data(const double*, const unsigned int&, double*) const method.\n"
+             << "No neural network has been compiled.\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   if(compiled_function)
+   {
+      compiled_function(input_data, output_data, instances_number);
+
+      return;
+   }
+
+   const unsigned int maximal_block_size = (instances_number < block_instances_number) ? instances_number : block_instances_number;
+
+   Vector<double> workspace(2*maximal_block_size*maximal_layer_size);
+
+   for(unsigned int i = 0; i < instances_number; i += maximal_block_size)
+   {
+      const unsigned int block_size = std::min(maximal_block_size, instances_number - i);
+
+      calculate_block_outputs(input_data + (size_t)i*inputs_number, block_size, output_data + (size_t)i*outputs_number, &workspace[0]);
+   }
+}
+
+
+// void generate_function(void) method
+
+/// This method translates the flattened layers into machine code.
+/// The generated function loops over the instances of a batch, keeping the intermediate layers in its stack frame.
+/// The perceptrons of a layer are computed in groups of up to sixteen, two in each SSE2 register,
+/// so that every input is loaded once per group and multiplied by a pair of weights at a time.
+/// The weights and biases are constants of the function, and the loops over inputs and perceptrons are unrolled.
+/// Threshold and linear activations are generated inline, while the transcendental ones, the softmax and
+/// the competitive functions are calls to the same functions used by the loops, once per layer.
+/// Machine code pays off for small networks, where the cost of a call dominates.
+/// If the target is not x86-64, the network is too big to be unrolled, or code generation fails,
+/// no machine code is generated and the loops are used instead.
+
+void CompiledNeuralNetwork::generate_function(void)
+{
+   #ifdef __OPENNN_JIT_X86_64__
+
+   using namespace asmjit;
+
+   // Beyond this number of parameters the unrolled code does not fit in the instruction cache,
+   // and the matrix product kernels used by the loops are faster
+
+   const unsigned int maximal_parameters_number = 2048;
+
+   unsigned int parameters_number = 0;
+
+   for(unsigned int l = 0; l < layers.size(); l++)
+   {
+      parameters_number += layers[l].perceptrons_number*(layers[l].inputs_number + 1);
+   }
+
+   if(parameters_number > maximal_parameters_number)
+   {
+      return;
+   }
+
+   JitRuntime& jit_runtime = get_jit_runtime();
+
+   CodeHolder code;
+   code.init(jit_runtime.environment());
+
+   x86::Compiler compiler(&code);
+
+   compiler.addFunc(FuncSignatureT<void, const double*, double*, size_t>());
+
+   x86::Gp input_pointer = compiler.newIntPtr("input_pointer");
+   x86::Gp output_pointer = compiler.newIntPtr("output_pointer");
+   x86::Gp instances_count = compiler.newUIntPtr("instances_count");
+
+   compiler.setArg(0, input_pointer);
+   compiler.setArg(1, output_pointer);
+   compiler.setArg(2, instances_count);
+
+   // Intermediate layers alternate between the two halves of the workspace
+
+   x86::Mem workspace = compiler.newStack(2*maximal_layer_size*sizeof(double), 16);
+
+   x86::Mem second_workspace(workspace);
+   second_workspace.addOffset(maximal_layer_size*sizeof(double));
+
+   x86::Gp workspace_pointers[2] = {compiler.newIntPtr("workspace_0"), compiler.newIntPtr("workspace_1")};
+
+   compiler.lea(workspace_pointers[0], workspace);
+   compiler.lea(workspace_pointers[1], second_workspace);
+
+   // Registers
+
+   const unsigned int group_size = 16;
+
+   x86::Xmm accumulators[group_size/2];
+
+   for(unsigned int k = 0; k < group_size/2; k++)
+   {
+      accumulators[k] = compiler.newXmmPd();
+   }
+
+   x86::Xmm input = compiler.newXmmPd("input");
+   x86::Xmm product = compiler.newXmmPd("product");
+   x86::Xmm zero = compiler.newXmmPd("zero");
+   x86::Xmm mask = compiler.newXmmPd("mask");
+   x86::Xmm activation = compiler.newXmmPd("activation");
+
+   // Constant with the values of a pair of perceptrons, padded with zero if the second one does not exist
+
+   auto pair_constant = [&compiler](const double* values, const bool& pair) -> x86::Mem
+   {
+      const double data[2] = {values[0], pair ? values[1] : 0.0};
+
+      return(compiler.newConst(ConstPool::kScopeLocal, data, sizeof(data)));
+   };
+
+   const double ones[2] = {1.0, 1.0};
+   const double twos[2] = {2.0, 2.0};
+
+   const FuncSignatureT<void, double*, unsigned int> helper_signature;
+
+   Label loop_label = compiler.newLabel();
+   Label end_label = compiler.newLabel();
+
+   compiler.test(instances_count, instances_count);
+   compiler.jz(end_label);
+
+   compiler.bind(loop_label);
+
+   x86::Gp layer_inputs = input_pointer;
+
+   for(unsigned int l = 0; l < layers.size(); l++)
+   {
+      const CompiledLayer& layer = layers[l];
+
+      const unsigned int perceptrons_number = layer.perceptrons_number;
+
+      x86::Gp layer_outputs = (l == layers.size()-1) ? output_pointer : workspace_pointers[l%2];
+
+      for(unsigned int first = 0; first < perceptrons_number; first += group_size)
+      {
+         const unsigned int pairs_number = (std::min(group_size, perceptrons_number - first) + 1)/2;
+
+         for(unsigned int k = 0; k < pairs_number; k++)
+         {
+            const unsigned int i = first + 2*k;
+
+            compiler.movapd(accumulators[k], pair_constant(&layer.biases[i], i+1 < perceptrons_number));
+         }
+
+         for(unsigned int j = 0; j < layer.inputs_number; j++)
+         {
+            compiler.movsd(input, x86::qword_ptr(layer_inputs, (int32_t)(j*sizeof(double))));
+            compiler.unpcklpd(input, input);
+
+            for(unsigned int k = 0; k < pairs_number; k++)
+            {
+               const unsigned int i = first + 2*k;
+
+               compiler.movapd(product, input);
+               compiler.mulpd(product, pair_constant(&layer.synaptic_weights_transpose[j][i], i+1 < perceptrons_number));
+               compiler.addpd(accumulators[k], product);
+            }
+         }
+
+         for(unsigned int k = 0; k < pairs_number; k++)
+         {
+            const unsigned int i = first + 2*k;
+
+            if(layer.activation_function == Perceptron::Threshold
+            || layer.activation_function == Perceptron::SymmetricThreshold)
+            {
+               // Negative combinations give a mask of ones, which selects the activation for negative values
+
+               compiler.xorpd(zero, zero);
+               compiler.movapd(mask, accumulators[k]);
+               compiler.cmppd(mask, zero, 1);
+
+               if(layer.activation_function == Perceptron::Threshold)
+               {
+                  compiler.movapd(activation, compiler.newConst(ConstPool::kScopeLocal, ones, sizeof(ones)));
+                  compiler.andnpd(mask, activation);
+                  compiler.movapd(accumulators[k], mask);
+               }
+               else
+               {
+                  compiler.movapd(activation, compiler.newConst(ConstPool::kScopeLocal, twos, sizeof(twos)));
+                  compiler.andpd(mask, activation);
+                  compiler.movapd(accumulators[k], compiler.newConst(ConstPool::kScopeLocal, ones, sizeof(ones)));
+                  compiler.subpd(accumulators[k], mask);
+               }
+            }
+
+            const x86::Mem outputs = x86::ptr(layer_outputs, (int32_t)(i*sizeof(double)));
+
+            if(i+1 < perceptrons_number)
+            {
+               compiler.movupd(outputs, accumulators[k]);
+            }
+            else
+            {
+               compiler.movsd(outputs, accumulators[k]);
+            }
+         }
+      }
+
+      if(layer.activation_function == Perceptron::Logistic
+      || layer.activation_function == Perceptron::HyperbolicTangent)
+      {
+         InvokeNode* invoke_node;
+
+         const uint64_t helper_address = (layer.activation_function == Perceptron::Logistic)
+         ? (uint64_t)&CompiledNeuralNetwork::calculate_logistic
+         : (uint64_t)&CompiledNeuralNetwork::calculate_hyperbolic_tangent;
+
+         compiler.invoke(&invoke_node, helper_address, helper_signature);
+         invoke_node->setArg(0, layer_outputs);
+         invoke_node->setArg(1, Imm(perceptrons_number));
+      }
+
+      layer_inputs = layer_outputs;
+   }
+
+   // Output transformation, probabilistic layer and bounds
+
+   x86::Xmm value = compiler.newXmmSd("value");
+
+   if(output_transformation_flag)
+   {
+      for(unsigned int i = 0; i < outputs_number; i++)
+      {
+         const x86::Mem output = x86::qword_ptr(output_pointer, (int32_t)(i*sizeof(double)));
+
+         compiler.movsd(value, output);
+         compiler.mulsd(value, compiler.newDoubleConst(ConstPool::kScopeLocal, output_factors[i]));
+         compiler.addsd(value, compiler.newDoubleConst(ConstPool::kScopeLocal, output_offsets[i]));
+         compiler.movsd(output, value);
+      }
+   }
+
+   if(probabilistic_flag)
+   {
+      InvokeNode* invoke_node;
+
+      const uint64_t helper_address = (probabilistic_method == ProbabilisticLayer::Competitive)
+      ? (uint64_t)&CompiledNeuralNetwork::calculate_competitive
+      : (uint64_t)&CompiledNeuralNetwork::calculate_softmax;
+
+      compiler.invoke(&invoke_node, helper_address, helper_signature);
+      invoke_node->setArg(0, output_pointer);
+      invoke_node->setArg(1, Imm(outputs_number));
+   }
+
+   if(bounding_flag)
+   {
+      for(unsigned int i = 0; i < outputs_number; i++)
+      {
+         const x86::Mem output = x86::qword_ptr(output_pointer, (int32_t)(i*sizeof(double)));
+
+         compiler.movsd(value, output);
+         compiler.maxsd(value, compiler.newDoubleConst(ConstPool::kScopeLocal, lower_bounds[i]));
+         compiler.minsd(value, compiler.newDoubleConst(ConstPool::kScopeLocal, upper_bounds[i]));
+         compiler.movsd(output, value);
+      }
+   }
+
+   compiler.add(input_pointer, (int32_t)(inputs_number*sizeof(double)));
+   compiler.add(output_pointer, (int32_t)(outputs_number*sizeof(double)));
+   compiler.dec(instances_count);
+   compiler.jnz(loop_label);
+
+   compiler.bind(end_label);
+   compiler.ret();
+
+   compiler.endFunc();
+
+   if(compiler.finalize() != kErrorOk)
+   {
+      return;
+   }
+
+   CompiledFunction new_function = NULL;
+
+   if(jit_runtime.add(&new_function, &code) != kErrorOk)
+   {
+      return;
+   }
+
+   compiled_function = new_function;
+
+   #endif
+}
+
+
+// void release_function(void) method
+
+/// This method releases the generated machine code, if any.
+
+void CompiledNeuralNetwork::release_function(void)
+{
+   #ifdef __OPENNN_JIT_X86_64__
+
+   if(compiled_function)
+   {
+      get_jit_runtime().release(compiled_function);
+   }
+
+   #endif
+
+   compiled_function = NULL;
+}
+
+
+// void calculate_block_outputs(const double*, const unsigned int&, double*, double*) const method
+
+/// This method evaluates the flattened layers for a block of instances, without generated machine code.
+/// The combinations of each layer are computed for all the instances of the block with a single matrix product,
+/// or with a matrix-vector product if the block has only one instance.
+/// @param inputs Inputs of the instances, one after the other.
+/// @param block_size Number of instances, which must not be greater than the block instances number.
+/// @param outputs Array where the outputs of the instances are written, one after the other.
+/// @param workspace Array of twice the block size times the maximal layer size for the intermediate layers.
+
+void CompiledNeuralNetwork::calculate_block_outputs(const double* inputs, const unsigned int& block_size, double* outputs, double* workspace) const
+{
+   const unsigned int layers_number = layers.size();
+
+   const double* layer_inputs = inputs;
+
+   for(unsigned int l = 0; l < layers_number; l++)
+   {
+      const CompiledLayer& layer = layers[l];
+
+      double* layer_outputs = (l == layers_number-1) ? outputs : workspace + (l%2)*block_size*maximal_layer_size;
+
+      if(block_size == 1)
+      {
+         MatrixKernels::gemv(layer.perceptrons_number, layer.inputs_number,
+                             layer.synaptic_weights[0], layer.inputs_number,
+                             layer_inputs, layer_outputs);
+      }
+      else
+      {
+         MatrixKernels::gemm(block_size, layer.perceptrons_number, layer.inputs_number,
+                             layer_inputs, layer.inputs_number,
+                             layer.synaptic_weights_transpose[0], layer.perceptrons_number,
+                             layer_outputs, layer.perceptrons_number);
+      }
+
+      for(unsigned int k = 0; k < block_size; k++)
+      {
+         double* combinations = layer_outputs + (size_t)k*layer.perceptrons_number;
+
+         for(unsigned int i = 0; i < layer.perceptrons_number; i++)
+         {
+            combinations[i] += layer.biases[i];
+         }
+
+         calculate_activation(layer.activation_function, combinations, layer.perceptrons_number);
+      }
+
+      layer_inputs = layer_outputs;
+   }
+
+   if(output_transformation_flag || probabilistic_flag || bounding_flag)
+   {
+      for(unsigned int k = 0; k < block_size; k++)
+      {
+         calculate_output_layers(outputs + (size_t)k*outputs_number);
+      }
+   }
+}
+
+
+// void calculate_output_layers(double*) const method
+
+/// This method applies in place the layers which follow the perceptron layers to the outputs of an instance:
+/// the output transformation, the probabilistic layer and the bounding layer.
+/// @param outputs Outputs of the last perceptron layer for an instance.
+
+void CompiledNeuralNetwork::calculate_output_layers(double* outputs) const
+{
+   if(output_transformation_flag)
+   {
+      for(unsigned int i = 0; i < outputs_number; i++)
+      {
+         outputs[i] = outputs[i]*output_factors[i] + output_offsets[i];
+      }
+   }
+
+   if(probabilistic_flag)
+   {
+      if(probabilistic_method == ProbabilisticLayer::Competitive)
+      {
+         calculate_competitive(outputs, outputs_number);
+      }
+      else
+      {
+         calculate_softmax(outputs, outputs_number);
+      }
+   }
+
+   if(bounding_flag)
+   {
+      for(unsigned int i = 0; i < outputs_number; i++)
+      {
+         if(outputs[i] < lower_bounds[i])
+         {
+            outputs[i] = lower_bounds[i];
+         }
+         else if(outputs[i] > upper_bounds[i])
+         {
+            outputs[i] = upper_bounds[i];
+         }
+      }
+   }
+}
+
+
+// void calculate_activation(const Perceptron::ActivationFunction&, double*, const unsigned int&) method
+
+/// This method applies an activation function in place to the combinations of a layer.
+/// @param activation_function Activation function of the layer.
+/// @param values Combinations of the perceptrons, which are replaced by their activations.
+/// @param size Number of perceptrons.
+
+void CompiledNeuralNetwork::calculate_activation(const Perceptron::ActivationFunction& activation_function, double* values, const unsigned int& size)
+{
+   switch(activation_function)
+   {
+      case Perceptron::Logistic:
+      {
+         calculate_logistic(values, size);
+      }
+      break;
+
+      case Perceptron::HyperbolicTangent:
+      {
+         calculate_hyperbolic_tangent(values, size);
+      }
+      break;
+
+      case Perceptron::Threshold:
+      {
+         for(unsigned int i = 0; i < size; i++)
+         {
+            values[i] = (values[i] < 0) ? 0.0 : 1.0;
+         }
+      }
+      break;
+
+      case Perceptron::SymmetricThreshold:
+      {
+         for(unsigned int i = 0; i < size; i++)
+         {
+            values[i] = (values[i] < 0) ? -1.0 : 1.0;
+         }
+      }
+      break;
+
+      case Perceptron::Linear:
+      {
+      }
+      break;
+   }
+}
+
+
+// void calculate_logistic(double*, unsigned int) method
+
+/// This method applies the logistic function in place, with the same formula as the Perceptron class.
+/// It is also called from the generated machine code.
+/// @param values Combinations of the perceptrons of a layer.
+/// @param size Number of perceptrons.
+
+void CompiledNeuralNetwork::calculate_logistic(double* values, unsigned int size)
+{
+   for(unsigned int i = 0; i < size; i++)
+   {
+      values[i] = 1.0/(1.0 + exp(-values[i]));
+   }
+}
+
+
+// void calculate_hyperbolic_tangent(double*, unsigned int) method
+
+/// This method applies the hyperbolic tangent in place, with the same formula as the Perceptron class.
+/// It is also called from the generated machine code.
+/// @param values Combinations of the perceptrons of a layer.
+/// @param size Number of perceptrons.
+
+void CompiledNeuralNetwork::calculate_hyperbolic_tangent(double* values, unsigned int size)
+{
+   for(unsigned int i = 0; i < size; i++)
+   {
+      values[i] = 1.0 - 2.0/(exp(2.0*values[i]) + 1.0);
+   }
+}
+
+
+// void calculate_competitive(double*, unsigned int) method
+
+/// This method replaces the outputs by one for the first maximal output and zero for the others,
+/// as the competitive method of the probabilistic layer.
+/// @param values Outputs.
+/// @param size Number of outputs.
+
+void CompiledNeuralNetwork::calculate_competitive(double* values, unsigned int size)
+{
+   unsigned int maximal_index = 0;
+
+   for(unsigned int i = 1; i < size; i++)
+   {
+      if(values[i] > values[maximal_index])
+      {
+         maximal_index = i;
+      }
+   }
+
+   for(unsigned int i = 0; i < size; i++)
+   {
+      values[i] = (i == maximal_index) ? 1.0 : 0.0;
+   }
+}
+
+
+// void calculate_softmax(double*, unsigned int) method
+
+/// This method replaces the outputs by their softmax, as the softmax method of the probabilistic layer.
+/// @param values Outputs.
+/// @param size Number of outputs.
+
+void CompiledNeuralNetwork::calculate_softmax(double* values, unsigned int size)
+{
+   double sum = 0.0;
+
+   for(unsigned int i = 0; i < size; i++)
+   {
+      values[i] = exp(values[i]);
+      sum += values[i];
+   }
+
+   for(unsigned int i = 0; i < size; i++)
+   {
+      values[i] /= sum;
+   }
+}
+
+}
@@ -0,0 +1,218 @@
+/****************************************************************************************************************/
+/*                                                                                                              */
+/*   OpenNN: Open Neural Networks Library                                                                       */
+/*   www.opennn.cimne.com                                                                                       */
+/*                                                                                                              */
+/*   C O M P I L E D   N E U R A L   N E T W O R K   C L A S S   H E A D E R                                    */
+/*                                                                                                              */
+/*   Roberto Lopez                                                                                              */
+/*   International Center for Numerical Methods in Engineering (CIMNE)                                          */
+/*   Technical University of Catalonia (UPC)                                                                    */
+/*   Barcelona, Spain                                                                                           */
+/*   E-mail: rlopez@cimne.upc.edu                                                                               */
+/*                                                                                                              */
+/****************************************************************************************************************/
+
+#ifndef __COMPILEDNEURALNETWORK_H__
+#define __COMPILEDNEURALNETWORK_H__
+
+// System includes
+
+#include <cstddef>
+
+// OpenNN includes
+
+#include "neural_network.h"
+#include "perceptron.h"
+#include "probabilistic_layer.h"
+
+#include "../utilities/vector.h"
+#include "../utilities/matrix.h"
+
+namespace OpenNN
+{
+
+/// This class is a read only, fast version of a trained neural network for deployment.
+/// Compiling a neural network flattens its layers into contiguous arrays, folds the scaling layer into the first
+/// perceptron layer and, when possible, the unscaling layer into the last one.
+/// On x86-64, small networks are then translated into machine code with the weights as constants,
+/// so that evaluating the network neither allocates memory nor goes through the layer classes.
+/// Otherwise, or if machine code is disabled, the same flattened network is evaluated for blocks of instances
+/// with the matrix product kernels.
+/// A compiled neural network is a snapshot: later changes to the original neural network are not seen by it.
+/// Neural networks with an active conditions layer cannot be compiled.
+
+class CompiledNeuralNetwork
+{
+
+public:
+
+   // DEFAULT CONSTRUCTOR
+
+   explicit CompiledNeuralNetwork(void);
+
+   // NEURAL NETWORK CONSTRUCTOR
+
+   explicit CompiledNeuralNetwork(const NeuralNetwork&);
+
+   // DESTRUCTOR
+
+   virtual ~CompiledNeuralNetwork(void);
+
+   // METHODS
+
+   void compile(const NeuralNetwork&);
+   void clear(void);
+
+   bool is_compiled(void) const;
+   bool is_jit_compiled(void) const;
+
+   // Get methods
+
+   const unsigned int& get_inputs_number(void) const;
+   const unsigned int& get_outputs_number(void) const;
+
+   const bool& get_jit_flag(void) const;
+
+   // Set methods
+
+   void set_jit_flag(const bool&);
+
+   // Output methods
+
+   Vector<double> calculate_outputs(const Vector<double>&) const;
+
+   Matrix<double> calculate_output_data(const Matrix<double>&) const;
+   void calculate_output_data(const Matrix<double>&, Matrix<double>&) const;
+
+   void calculate_output_data(const double*, const unsigned int&, double*) const;
+
+private:
+
+   // COPY CONSTRUCTOR
+
+   CompiledNeuralNetwork(const CompiledNeuralNetwork&);
+
+   // ASSIGNMENT OPERATOR
+
+   CompiledNeuralNetwork& operator = (const CompiledNeuralNetwork&);
+
+   /// Flattened perceptron layer.
+
+   struct CompiledLayer
+   {
+      /// Number of inputs to the layer.
+
+      unsigned int inputs_number;
+
+      /// Number of perceptrons in the layer.
+
+      unsigned int perceptrons_number;
+
+      /// Synaptic weights, with one row for each perceptron, for the product with a single instance.
+
+      Matrix<double> synaptic_weights;
+
+      /// Transposed synaptic weights, with one row for each input, for the product with a block of instances.
+
+      Matrix<double> synaptic_weights_transpose;
+
+      /// Biases of the perceptrons.
+
+      Vector<double> biases;
+
+      /// Activation function of all the perceptrons.
+
+      Perceptron::ActivationFunction activation_function;
+   };
+
+   /// Type of the generated machine code, which evaluates a number of consecutive instances.
+
+   typedef void (*CompiledFunction)(const double*, double*, size_t);
+
+   // PRIVATE METHODS
+
+   void generate_function(void);
+   void release_function(void);
+
+   void calculate_block_outputs(const double*, const unsigned int&, double*, double*) const;
+   void calculate_output_layers(double*) const;
+
+   static void calculate_activation(const Perceptron::ActivationFunction&, double*, const unsigned int&);
+
+   static void calculate_logistic(double*, unsigned int);
+   static void calculate_hyperbolic_tangent(double*, unsigned int);
+
+   static void calculate_competitive(double*, unsigned int);
+   static void calculate_softmax(double*, unsigned int);
+
+   // MEMBERS
+
+   /// True if the neural network has been compiled, false otherwise.
+
+   bool compiled;
+
+   /// Number of inputs to the compiled neural network.
+
+   unsigned int inputs_number;
+
+   /// Number of outputs from the compiled neural network.
+
+   unsigned int outputs_number;
+
+   /// Number of instances evaluated together by the loops.
+
+   static const unsigned int block_instances_number = 64;
+
+   /// Largest number of values produced by any of the layers, which sizes the evaluation workspace.
+
+   unsigned int maximal_layer_size;
+
+   /// Flattened perceptron layers, with the scaling layer folded into the first one.
+
+   Vector<CompiledLayer> layers;
+
+   /// True if the outputs go through an affine transformation which could not be folded into the last layer.
+
+   bool output_transformation_flag;
+
+   /// Factors of the affine output transformation.
+
+   Vector<double> output_factors;
+
+   /// Offsets of the affine output transformation.
+
+   Vector<double> output_offsets;
+
+   /// True if the outputs go through the probabilistic layer.
+
+   bool probabilistic_flag;
+
+   /// Method of the probabilistic layer.
+
+   ProbabilisticLayer::ProbabilisticMethod probabilistic_method;
+
+   /// True if the outputs are bounded.
+
+   bool bounding_flag;
+
+   /// Lower bounds of the outputs.
+
+   Vector<double> lower_bounds;
+
+   /// Upper bounds of the outputs.
+
+   Vector<double> upper_bounds;
+
+   /// True if machine code is to be generated when compiling, false to always use the flattened layers.
+
+   bool jit_flag;
+
+   /// Generated machine code, or NULL if the flattened layers are evaluated by loops.
+
+   CompiledFunction compiled_function;
+};
+
+}
+
+#endif
@@ -26,6 +26,8 @@
 
 #include "multilayer_perceptron.h"
 
+#include "../data_set/binary_data_file.h"
+
 
 namespace OpenNN
 {
@@ -1696,6 +1698,58 @@ Vector<double> MultilayerPerceptron::calculate_outputs(const Vector<double>& inp
 }
 
 
+// Matrix<double> calculate_outputs(const Matrix<double>&) const method
+
+/// This method returns the outputs from the last layer in the multilayer perceptron for a block of inputs. 
+/// Each row of the inputs matrix is an instance, and the corresponding row of the returned matrix contains its outputs. 
+/// The whole block is propagated with one matrix product per layer. 
+/// @param inputs Matrix of inputs to the first layer, with one instance per row. 
+
+Matrix<double> MultilayerPerceptron::calculate_outputs(const Matrix<double>& inputs) const
+{
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   const unsigned int columns_number = inputs.get_columns_number();
+
+   const unsigned int inputs_number = count_inputs_number();
+
+   if(columns_number != inputs_number) 
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: MultilayerPerceptron class.\n"
+             << "Matrix<double> calculate_outputs(const Matrix<double>&) const method.\n"
+             << "Number of columns of inputs (" << columns_number <<") must be equal to number of inputs (" << inputs_number << ").\n";
+
+	  throw std::logic_error(buffer.str());
+   }   
+   
+   #endif
+
+   const unsigned int layers_number = count_layers_number();
+
+   Matrix<double> outputs;
+
+   if(layers_number == 0)
+   {
+      return(outputs);   
+   }
+   else
+   {
+      outputs = layers[0].calculate_outputs(inputs);
+
+      for(unsigned int i = 1; i < layers_number; i++)
+      {
+         outputs = layers[i].calculate_outputs(outputs);
+      }
+   }
+
+   return(outputs);
+}
+
+
 // Matrix<double> calculate_Jacobian(const Vector<double>&) const method
 
 /// This method returns the partial derivatives of the outputs from the last layer with respect to the inputs to the first layer in the multilayer perceptron 
@@ -3100,6 +3154,117 @@ Vector< Vector< Vector<double> > > MultilayerPerceptron::calculate_first_order_f
 }
 
 
+// Vector< Vector< Matrix<double> > > calculate_first_order_forward_propagation(const Matrix<double>&) const method
+
+/// This method returns the first order forward propagation quantities from the multilayer perceptron for a block of inputs. 
+/// That quantites include the activation and the activation derivative of all layers. 
+/// The format is a vector of vectors of matrices. 
+/// The first index refers to the quantity (0 for the activation and 1 for the activation derivative).
+/// The second index is the index of the layer. 
+/// Each matrix has one row per instance and one column per neuron in the layer. 
+/// @param inputs Matrix of inputs to the multilayer perceptron, with one instance per row. 
+
+Vector< Vector< Matrix<double> > > MultilayerPerceptron::calculate_first_order_forward_propagation(const Matrix<double>& inputs) const
+{
+   Vector< Vector< Matrix<double> > > first_order_forward_propagation(2);
+
+   calculate_first_order_forward_propagation(inputs, first_order_forward_propagation[0], first_order_forward_propagation[1]);
+
+   return(first_order_forward_propagation);
+}
+
+
+// void calculate_first_order_forward_propagation(const Matrix<double>&, Vector< Matrix<double> >&, Vector< Matrix<double> >&) const method
+
+/// This method writes the activations and the activation derivatives of all layers for a block of inputs into given vectors of matrices. 
+/// The storage of those matrices is reused if they already have the right sizes, so that propagating blocks of the same size does not allocate memory. 
+/// @param inputs Matrix of inputs to the multilayer perceptron, with one instance per row. 
+/// @param layers_activation Vector to be set to the activation matrix of each layer. 
+/// @param layers_activation_derivative Vector to be set to the activation derivative matrix of each layer. 
+
+void MultilayerPerceptron::calculate_first_order_forward_propagation
+(const Matrix<double>& inputs, Vector< Matrix<double> >& layers_activation, Vector< Matrix<double> >& layers_activation_derivative) const
+{
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   const unsigned int columns_number = inputs.get_columns_number();
+
+   const unsigned int inputs_number = count_inputs_number();
+
+   if(columns_number != inputs_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: MultilayerPerceptron class.\n"
+             << "void calculate_first_order_forward_propagation(const Matrix<double>&, Vector< Matrix<double> >&, Vector< Matrix<double> >&) const method.\n"
+             << "Number of columns must be equal to number of inputs.\n";
+
+	  throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   const unsigned int layers_number = count_layers_number();
+
+   layers_activation.set(layers_number);
+   layers_activation_derivative.set(layers_number);
+
+   for(unsigned int i = 0; i < layers_number; i++)
+   {
+      // The activation derivative matrix holds the combination until it is overwritten element by element
+
+      Matrix<double>& layer_combination = layers_activation_derivative[i];
+
+      if(i == 0)
+      {
+         layers[0].calculate_combination(inputs, layer_combination);
+      }
+      else
+      {
+         layers[i].calculate_combination(layers_activation[i-1], layer_combination);
+      }
+
+      layers[i].calculate_activation(layer_combination, layers_activation[i]);
+
+      layers[i].calculate_activation_derivative(layer_combination, layers_activation_derivative[i]);
+   }
+}
+
+
+// void calculate_layers_activation(const Matrix<double>&, Vector< Matrix<double> >&) const method
+
+/// This method writes the activations of all layers for a block of inputs into a given vector of matrices. 
+/// The last matrix contains the outputs of the multilayer perceptron. 
+/// The storage of the matrices is reused if they already have the right sizes. 
+/// @param inputs Matrix of inputs to the multilayer perceptron, with one instance per row. 
+/// @param layers_activation Vector to be set to the activation matrix of each layer. 
+
+void MultilayerPerceptron::calculate_layers_activation(const Matrix<double>& inputs, Vector< Matrix<double> >& layers_activation) const
+{
+   const unsigned int layers_number = count_layers_number();
+
+   layers_activation.set(layers_number);
+
+   for(unsigned int i = 0; i < layers_number; i++)
+   {
+      // Activations are computed in place from the combinations
+
+      if(i == 0)
+      {
+         layers[0].calculate_combination(inputs, layers_activation[0]);
+      }
+      else
+      {
+         layers[i].calculate_combination(layers_activation[i-1], layers_activation[i]);
+      }
+
+      layers[i].calculate_activation(layers_activation[i], layers_activation[i]);
+   }
+}
+
+
 // Vector< Vector< Vector<double> > > calculate_second_order_forward_propagation(const Vector<double>&) const method
 
 /// This method returns the second order forward propagation quantities from the multilayer perceptron for a given inputs. 
@@ -3351,6 +3516,159 @@ void MultilayerPerceptron::from_XML(TiXmlElement* multilayer_perceptron_element)
 }
 
 
+// void write_XML(XMLStreamWriter&) const method
+
+/// This method writes the multilayer perceptron to a XML stream, in the same format as the to_XML method.
+/// The parameters are written with as many digits as needed to read them back exactly.
+/// @param writer XML stream which receives the multilayer perceptron element.
+
+void MultilayerPerceptron::write_XML(XMLStreamWriter& writer) const
+{
+   write_XML(writer, "");
+}
+
+
+// void write_XML(XMLStreamWriter&, const std::string&) const method
+
+/// This method writes the multilayer perceptron to a XML stream.
+/// If a parameters file name is given, the parameters are saved to that binary data file instead of as text,
+/// and the Parameters element only refers to it.
+/// @param writer XML stream which receives the multilayer perceptron element.
+/// @param parameters_filename Name of the binary data file for the parameters, or an empty string to write them as text.
+
+void MultilayerPerceptron::write_XML(XMLStreamWriter& writer, const std::string& parameters_filename) const
+{
+   std::ostringstream buffer;
+
+   writer.write_start_element("MultilayerPerceptron");
+   writer.write_attribute("Version", 4);
+
+   // Architecture
+
+   writer.write_text_element("Architecture", arrange_architecture().to_string());
+
+   // Layers activation function
+
+   writer.write_text_element("LayersActivationFunction", write_layers_activation_function().to_string());
+
+   // Parameters
+
+   const Vector<double> parameters = arrange_parameters();
+
+   if(parameters_filename.empty())
+   {
+      writer.write_start_element("Parameters");
+      writer.write_attribute("Size", parameters.size());
+      writer.write_text(parameters);
+      writer.write_end_element();
+   }
+   else
+   {
+      BinaryDataFile::save(parameters_filename, parameters);
+
+      // The file is referred to by its name only, as it is kept next to the XML file.
+
+      const size_t separator = parameters_filename.find_last_of("/\\");
+
+      writer.write_start_element("Parameters");
+      writer.write_attribute("Size", parameters.size());
+      writer.write_attribute("BinaryFile", separator == std::string::npos ? parameters_filename : parameters_filename.substr(separator+1));
+      writer.write_end_element();
+   }
+
+   // Display
+
+   buffer << display;
+
+   writer.write_text_element("Display", buffer.str());
+
+   writer.write_end_element();
+}
+
+
+// void read_XML(XMLStreamReader&, const std::string&) method
+
+/// This method reads a multilayer perceptron element from a XML stream, whose start has just been read.
+/// It reads the text format of the to_XML and write_XML methods, and the parameters saved to binary data files.
+/// @param reader XML stream positioned after the start of the multilayer perceptron element.
+/// @param directory Directory of the XML file, with a trailing separator, where the binary data files are looked for.
+
+void MultilayerPerceptron::read_XML(XMLStreamReader& reader, const std::string& directory)
+{
+   while(reader.read_start_element())
+   {
+      const std::string element_name = reader.get_name();
+
+      if(element_name == "Architecture")
+      {
+         Vector<unsigned int> new_architecture;
+         new_architecture.parse(reader.read_text());
+
+         try
+         {
+            set(new_architecture);
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "LayersActivationFunction")
+      {
+         Vector<std::string> new_layers_activation_function;
+         new_layers_activation_function.parse(reader.read_text());
+
+         try
+         {
+            set_layers_activation_function(new_layers_activation_function);
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "Parameters")
+      {
+         Vector<double> new_parameters;
+
+         if(reader.has_attribute("BinaryFile"))
+         {
+            const std::string parameters_filename = directory + reader.get_attribute("BinaryFile");
+
+            reader.skip_element();
+
+            BinaryDataFile parameters_file(parameters_filename);
+
+            const double* parameters_pointer = parameters_file.get_data_pointer();
+            const unsigned int parameters_number = parameters_file.get_rows_number()*parameters_file.get_columns_number();
+
+            new_parameters.assign(parameters_pointer, parameters_pointer + parameters_number);
+         }
+         else
+         {
+            reader.read_text(new_parameters);
+         }
+
+         try
+         {
+            set_parameters(new_parameters);
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "Display")
+      {
+         set_display(reader.read_text() != "0");
+      }
+      else
+      {
+         reader.skip_element();
+      }
+   }
+}
+
 // std::string write_expression(const Vector<std::string>&, const Vector<std::string>&) const method
 
 /// This method returns a string with the expression of the forward propagation process in a multilayer perceptron.
@@ -28,6 +28,7 @@
 
 #include "../utilities/vector.h"
 #include "../utilities/matrix.h"
+#include "../utilities/xml_stream.h"
 
 // TinyXml includes
 
@@ -357,9 +358,15 @@ public:
    Vector< Vector< Vector<double> > > calculate_first_order_forward_propagation(const Vector<double>&) const;
    Vector< Vector< Vector<double> > > calculate_second_order_forward_propagation(const Vector<double>&) const;
 
+   Vector< Vector< Matrix<double> > > calculate_first_order_forward_propagation(const Matrix<double>&) const;
+   void calculate_first_order_forward_propagation(const Matrix<double>&, Vector< Matrix<double> >&, Vector< Matrix<double> >&) const;
+
+   void calculate_layers_activation(const Matrix<double>&, Vector< Matrix<double> >&) const;
+
    // Output 
 
    Vector<double> calculate_outputs(const Vector<double>&) const;
+   Matrix<double> calculate_outputs(const Matrix<double>&) const;
    Matrix<double> calculate_Jacobian(const Vector<double>&) const;
    Vector< Matrix<double> > calculate_Hessian_form(const Vector<double>&) const;
 
@@ -371,6 +378,10 @@ public:
 
    TiXmlElement* to_XML(void) const;
    void from_XML(TiXmlElement*);
+
+   void write_XML(XMLStreamWriter&) const;
+   void write_XML(XMLStreamWriter&, const std::string&) const;
+   void read_XML(XMLStreamReader&, const std::string&);
    
    // Expression methods
 
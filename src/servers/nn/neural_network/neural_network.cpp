@@ -3224,6 +3224,320 @@ void NeuralNetwork::from_XML(TiXmlElement* neural_network_element)
 }
 
 
+// void write_XML(XMLStreamWriter&, const std::string&) const method
+
+/// This method writes the neural network to a XML stream, in the same format as the to_XML method.
+/// The multilayer perceptron is written straight to the stream, and the other layers, which are small, through their to_XML methods.
+/// @param writer XML stream which receives the neural network element.
+/// @param parameters_filename Name of the binary data file for the multilayer perceptron parameters, or an empty string to write them as text.
+
+void NeuralNetwork::write_XML(XMLStreamWriter& writer, const std::string& parameters_filename) const
+{
+   std::ostringstream buffer;
+
+   writer.write_start_element("NeuralNetwork");
+   writer.write_attribute("Version", 4);
+
+   // Inputs outputs information
+
+   if(inputs_outputs_information_pointer)
+   {
+      TiXmlElement* element = inputs_outputs_information_pointer->to_XML();
+      writer.write_element(element);
+      delete element;
+   }
+
+   // Multilayer perceptron
+
+   if(multilayer_perceptron_pointer)
+   {
+      multilayer_perceptron_pointer->write_XML(writer, parameters_filename);
+   }
+
+   // Scaling layer
+
+   if(scaling_layer_pointer)
+   {
+      TiXmlElement* element = scaling_layer_pointer->to_XML();
+      writer.write_element(element);
+      delete element;
+   }
+
+   // Unscaling layer
+
+   if(unscaling_layer_pointer)
+   {
+      TiXmlElement* element = unscaling_layer_pointer->to_XML();
+      writer.write_element(element);
+      delete element;
+   }
+
+   // Probabilistic layer
+
+   if(probabilistic_layer_pointer)
+   {
+      TiXmlElement* element = probabilistic_layer_pointer->to_XML();
+      writer.write_element(element);
+      delete element;
+   }
+
+   // Bounding layer
+
+   if(bounding_layer_pointer)
+   {
+      TiXmlElement* element = bounding_layer_pointer->to_XML();
+      writer.write_element(element);
+      delete element;
+   }
+
+   // Conditions layer
+
+   if(conditions_layer_pointer)
+   {
+      TiXmlElement* element = conditions_layer_pointer->to_XML();
+      writer.write_element(element);
+      delete element;
+   }
+
+   // Independent parameters
+
+   if(independent_parameters_pointer)
+   {
+      TiXmlElement* element = independent_parameters_pointer->to_XML();
+      writer.write_element(element);
+      delete element;
+   }
+
+   // Flags
+
+   buffer.str("");
+   buffer << scaling_layer_flag;
+   writer.write_text_element("ScalingLayerFlag", buffer.str());
+
+   buffer.str("");
+   buffer << unscaling_layer_flag;
+   writer.write_text_element("UnscalingLayerFlag", buffer.str());
+
+   buffer.str("");
+   buffer << probabilistic_layer_flag;
+   writer.write_text_element("ProbabilisticLayerFlag", buffer.str());
+
+   buffer.str("");
+   buffer << bounding_layer_flag;
+   writer.write_text_element("BoundingLayerFlag", buffer.str());
+
+   buffer.str("");
+   buffer << conditions_layer_flag;
+   writer.write_text_element("ConditionsLayerFlag", buffer.str());
+
+   // Display warnings
+
+   buffer.str("");
+   buffer << display;
+   writer.write_text_element("Display", buffer.str());
+
+   writer.write_end_element();
+}
+
+
+// void read_XML(XMLStreamReader&, const std::string&) method
+
+/// This method reads a neural network element from a XML stream, whose start has just been read.
+/// The multilayer perceptron is read straight from the stream, and the other layers, which are small, through their from_XML methods.
+/// @param reader XML stream positioned after the start of the neural network element.
+/// @param directory Directory of the XML file, with a trailing separator, where the binary data files are looked for.
+
+void NeuralNetwork::read_XML(XMLStreamReader& reader, const std::string& directory)
+{
+   while(reader.read_start_element())
+   {
+      const std::string element_name = reader.get_name();
+
+      if(element_name == "MultilayerPerceptron")
+      {
+         if(!multilayer_perceptron_pointer)
+         {
+            multilayer_perceptron_pointer = new MultilayerPerceptron();
+         }
+
+         multilayer_perceptron_pointer->read_XML(reader, directory);
+      }
+      else if(element_name == "ScalingLayer")
+      {
+         if(!scaling_layer_pointer)
+         {
+            scaling_layer_pointer = new ScalingLayer();
+         }
+
+         TiXmlElement* element = reader.read_element();
+         scaling_layer_pointer->from_XML(element);
+         delete element;
+      }
+      else if(element_name == "UnscalingLayer")
+      {
+         if(!unscaling_layer_pointer)
+         {
+            unscaling_layer_pointer = new UnscalingLayer();
+         }
+
+         TiXmlElement* element = reader.read_element();
+         unscaling_layer_pointer->from_XML(element);
+         delete element;
+      }
+      else if(element_name == "BoundingLayer")
+      {
+         if(!bounding_layer_pointer)
+         {
+            bounding_layer_pointer = new BoundingLayer();
+         }
+
+         TiXmlElement* element = reader.read_element();
+         bounding_layer_pointer->from_XML(element);
+         delete element;
+      }
+      else if(element_name == "ProbabilisticLayer")
+      {
+         if(!probabilistic_layer_pointer)
+         {
+            probabilistic_layer_pointer = new ProbabilisticLayer();
+         }
+
+         TiXmlElement* element = reader.read_element();
+         probabilistic_layer_pointer->from_XML(element);
+         delete element;
+      }
+      else if(element_name == "ConditionsLayer")
+      {
+         if(!conditions_layer_pointer)
+         {
+            conditions_layer_pointer = new ConditionsLayer();
+         }
+
+         TiXmlElement* element = reader.read_element();
+         conditions_layer_pointer->from_XML(element);
+         delete element;
+      }
+      else if(element_name == "InputsOutputsInformation")
+      {
+         if(!inputs_outputs_information_pointer)
+         {
+            inputs_outputs_information_pointer = new InputsOutputsInformation();
+         }
+
+         TiXmlElement* element = reader.read_element();
+         inputs_outputs_information_pointer->from_XML(element);
+         delete element;
+      }
+      else if(element_name == "IndependentParameters")
+      {
+         if(!independent_parameters_pointer)
+         {
+            independent_parameters_pointer = new IndependentParameters();
+         }
+
+         TiXmlElement* element = reader.read_element();
+         independent_parameters_pointer->from_XML(element);
+         delete element;
+      }
+      else if(element_name == "MultilayerPerceptronFlag")
+      {
+         const std::string new_flag_string = reader.read_text();
+
+         try
+         {
+            set_multilayer_perceptron_flag(new_flag_string != "0");
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "ScalingLayerFlag")
+      {
+         const std::string new_flag_string = reader.read_text();
+
+         try
+         {
+            set_scaling_layer_flag(new_flag_string != "0");
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "UnscalingLayerFlag")
+      {
+         const std::string new_flag_string = reader.read_text();
+
+         try
+         {
+            set_unscaling_layer_flag(new_flag_string != "0");
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "BoundingLayerFlag")
+      {
+         const std::string new_flag_string = reader.read_text();
+
+         try
+         {
+            set_bounding_layer_flag(new_flag_string != "0");
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "ProbabilisticLayerFlag")
+      {
+         const std::string new_flag_string = reader.read_text();
+
+         try
+         {
+            set_probabilistic_layer_flag(new_flag_string != "0");
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "ConditionsLayerFlag")
+      {
+         const std::string new_flag_string = reader.read_text();
+
+         try
+         {
+            set_conditions_layer_flag(new_flag_string != "0");
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "Display")
+      {
+         const std::string new_flag_string = reader.read_text();
+
+         try
+         {
+            set_display(new_flag_string != "0");
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else
+      {
+         reader.skip_element();
+      }
+   }
+}
+
+
 // void print(void) const method   
 
 /// This method prints to the screen the members of a neural network object in a XML-type format.
@@ -3240,26 +3554,44 @@ void NeuralNetwork::print(void) const
 // void save(const std::string&) const method 
 
 /// This method saves to a XML-type format file the members of a neural network object.
+/// The file is written as it is generated, without building the XML document in memory.
 /// @param filename Name of multilayer perceptron XML-type file.
 
 void NeuralNetwork::save(const std::string& filename) const
 {
-   TiXmlDocument document;
+   save(filename, false);
+}
 
-   // Declaration
 
-   TiXmlDeclaration* declaration = new TiXmlDeclaration("1.0", "", "");
-   document.LinkEndChild(declaration);
+// void save(const std::string&, const bool&) const method 
 
-   // Multilayer perceptron element
+/// This method saves to a XML-type format file the members of a neural network object.
+/// If requested, the multilayer perceptron parameters are saved to a binary data file next to it, whose name is that of the XML file followed by ".parameters".
+/// Such files load much faster than the text parameters of large networks, and keep the parameters exactly.
+/// @param filename Name of multilayer perceptron XML-type file.
+/// @param binary_parameters True to save the parameters to a binary data file, false to save them as text in the XML file.
 
-   TiXmlElement* multilayer_perceptron_element = to_XML();
-   document.LinkEndChild(multilayer_perceptron_element);
+void NeuralNetwork::save(const std::string& filename, const bool& binary_parameters) const
+{
+   std::ofstream file(filename.c_str());
 
-   // Save
+   if(!file.is_open())
+   {
+      std::ostringstream buffer;
 
-   document.SaveFile(filename.c_str());
- }
+      buffer << "OpenNN Exception: NeuralNetwork class.\n"
+             << "void save(const std::string&, const bool&) const method.\n"
+             << "Cannot open XML file " << filename << ".\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   XMLStreamWriter writer(file);
+
+   writer.write_declaration();
+
+   write_XML(writer, binary_parameters ? filename + ".parameters" : "");
+}
 
 
 // void save_parameters(const std::string&) const method 
@@ -3295,6 +3627,7 @@ void NeuralNetwork::save_parameters(const std::string& filename) const
 // void load(const std::string&) method
 
 /// This method loads from a XML-type file the members of a neural network object.
+/// The file is read sequentially, without building the XML document in memory.
 /// Please mind about the file format, which is specified in the User's Guide. 
 /// @param filename Name of multilayer perceptron XML-type file.
 
@@ -3302,9 +3635,9 @@ void NeuralNetwork::load(const std::string& filename)
 {
    std::ostringstream buffer;
 
-   TiXmlDocument document(filename.c_str());
+   std::ifstream file(filename.c_str());
 
-   if(!document.LoadFile())
+   if(!file.is_open())
    {
       buffer << "OpenNN Exception: NeuralNetwork class.\n"
              << "void load(const std::string&) method.\n"
@@ -3313,11 +3646,11 @@ void NeuralNetwork::load(const std::string& filename)
       throw std::logic_error(buffer.str());
    }
 
+   XMLStreamReader reader(file);
+
    // Neural network element
-  
-   TiXmlElement* neural_network_element = document.FirstChildElement();
 
-   if(!neural_network_element)
+   if(!reader.read_start_element())
    {
       buffer << "OpenNN Exception: NeuralNetwork class.\n"
              << "void load(const std::string&) method.\n"
@@ -3326,7 +3659,11 @@ void NeuralNetwork::load(const std::string& filename)
       throw std::logic_error(buffer.str());
    }
 
-   from_XML(neural_network_element);
+   // Binary data files are looked for next to the XML file.
+
+   const size_t separator = filename.find_last_of("/\\");
+
+   read_XML(reader, separator == std::string::npos ? std::string() : filename.substr(0, separator+1));
 }
 
 
@@ -255,8 +255,12 @@ public:
    virtual TiXmlElement* to_XML(void) const;
    virtual void from_XML(TiXmlElement*);
 
+   void write_XML(XMLStreamWriter&, const std::string&) const;
+   void read_XML(XMLStreamReader&, const std::string&);
+
    void print(void) const;
    void save(const std::string&) const;
+   void save(const std::string&, const bool&) const;
    void save_parameters(const std::string&) const;
 
    virtual void load(const std::string&);
@@ -21,6 +21,7 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <vector>
 
 // OpenNN includes
 
@@ -1082,6 +1083,103 @@ Vector<double> PerceptronLayer::calculate_combination(const Vector<double>& inpu
 }
 
 
+// Matrix<double> calculate_combination(const Matrix<double>&) const method
+
+/// This method returns the combination to every perceptron in the layer for a whole block of inputs. 
+/// Each row of the inputs matrix is an instance, and each row of the returned matrix contains the combinations for that instance. 
+/// The synaptic weights are multiplied with a single blocked matrix product instead of one dot product per perceptron and instance. 
+/// @param inputs Matrix of inputs to the layer, with one instance per row. 
+
+Matrix<double> PerceptronLayer::calculate_combination(const Matrix<double>& inputs) const
+{
+   Matrix<double> combination;
+
+   calculate_combination(inputs, combination);
+
+   return(combination);
+}
+
+
+// void calculate_combination(const Matrix<double>&, Matrix<double>&) const method
+
+/// This method writes the combination to every perceptron in the layer for a whole block of inputs into a given matrix. 
+/// The storage of the combination matrix, and of the transposed synaptic weights used by the product, is reused between calls. 
+/// @param inputs Matrix of inputs to the layer, with one instance per row. 
+/// @param combination Matrix to be set to the combinations, with one instance per row. 
+
+void PerceptronLayer::calculate_combination(const Matrix<double>& inputs, Matrix<double>& combination) const
+{
+   const unsigned int inputs_number = count_inputs_number();
+
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   const unsigned int inputs_columns_number = inputs.get_columns_number();
+
+   if(inputs_columns_number != inputs_number) 
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: PerceptronLayer class.\n"
+             << "void calculate_combination(const Matrix<double>&, Matrix<double>&) const method.\n"
+             << "Number of columns of inputs to layer must be equal to number of layer inputs.\n";
+
+	  throw std::logic_error(buffer.str());
+   }   
+
+   #endif
+
+   const unsigned int perceptrons_number = count_perceptrons_number();
+
+   const unsigned int instances_number = inputs.get_rows_number();
+
+   if(instances_number == 0 || perceptrons_number == 0)
+   {
+      combination.set();
+
+      return;
+   }
+
+   // Transposed synaptic weights, so that the product has one instance per row. 
+   // The buffer is kept by each thread and only grows, so that layers of any size reuse it.
+
+   static thread_local std::vector<double> synaptic_weights_transpose;
+
+   if(synaptic_weights_transpose.size() < inputs_number*perceptrons_number)
+   {
+      synaptic_weights_transpose.resize(inputs_number*perceptrons_number);
+   }
+
+   for(unsigned int i = 0; i < perceptrons_number; i++)
+   {
+      const Vector<double>& synaptic_weights = perceptrons[i].arrange_synaptic_weights();
+
+      for(unsigned int j = 0; j < inputs_number; j++)
+      {
+         synaptic_weights_transpose[j*perceptrons_number + i] = synaptic_weights[j];
+      }
+   }
+
+   combination.set(instances_number, perceptrons_number);
+
+   MatrixKernels::gemm(instances_number, perceptrons_number, inputs_number,
+                       inputs[0], inputs_number,
+                       &synaptic_weights_transpose[0], perceptrons_number,
+                       combination[0], perceptrons_number);
+
+   for(unsigned int i = 0; i < perceptrons_number; i++)
+   {
+      const double bias = perceptrons[i].get_bias();
+
+      for(unsigned int k = 0; k < instances_number; k++)
+      {
+         combination[k][i] += bias;
+      }
+   }
+}
+
+
 // Matrix<double> calculate_combination_Jacobian(const Vector<double>&) const method
 
 /// This method returns the partial derivatives of the combination of a layer with respect to the inputs. 
@@ -1347,6 +1445,128 @@ Vector<double> PerceptronLayer::calculate_activation_second_derivative(const Vec
 }
 
 
+// Matrix<double> calculate_activation(const Matrix<double>&) const method
+
+/// This method returns the activations from every perceptron in the layer for a block of combinations. 
+/// Each row of the combination matrix corresponds to an instance, and each column to a perceptron. 
+/// @param combination Combinations to the layer, with one instance per row. 
+
+Matrix<double> PerceptronLayer::calculate_activation(const Matrix<double>& combination) const
+{
+   Matrix<double> activation;
+
+   calculate_activation(combination, activation);
+
+   return(activation);
+}
+
+
+// void calculate_activation(const Matrix<double>&, Matrix<double>&) const method
+
+/// This method writes the activations from every perceptron in the layer for a block of combinations into a given matrix. 
+/// The storage of that matrix is reused if it already has the right size. 
+/// @param combination Combinations to the layer, with one instance per row. 
+/// @param activation Matrix to be set to the activations, with one instance per row. 
+/// It can be the combination matrix itself, which is then overwritten. 
+
+void PerceptronLayer::calculate_activation(const Matrix<double>& combination, Matrix<double>& activation) const
+{
+   const unsigned int perceptrons_number = count_perceptrons_number();
+
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   const unsigned int combination_columns_number = combination.get_columns_number();
+
+   if(combination_columns_number != perceptrons_number) 
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: PerceptronLayer class.\n"
+             << "void calculate_activation(const Matrix<double>&, Matrix<double>&) const method.\n"
+             << "Number of columns of combination must be equal to number of neurons.\n";
+
+	  throw std::logic_error(buffer.str());
+   }   
+
+   #endif
+
+   const unsigned int instances_number = combination.get_rows_number();
+
+   activation.set(instances_number, perceptrons_number);
+
+   for(unsigned int k = 0; k < instances_number; k++)
+   {
+      for(unsigned int i = 0; i < perceptrons_number; i++)
+      {
+         activation[k][i] = perceptrons[i].calculate_activation(combination[k][i]);
+      }
+   }
+}
+
+
+// Matrix<double> calculate_activation_derivative(const Matrix<double>&) const method
+
+/// This method returns the activation derivatives from every perceptron in the layer for a block of combinations. 
+/// Each row of the combination matrix corresponds to an instance, and each column to a perceptron. 
+/// @param combination Combinations to the layer, with one instance per row. 
+
+Matrix<double> PerceptronLayer::calculate_activation_derivative(const Matrix<double>& combination) const
+{
+   Matrix<double> activation_derivative;
+
+   calculate_activation_derivative(combination, activation_derivative);
+
+   return(activation_derivative);
+}
+
+
+// void calculate_activation_derivative(const Matrix<double>&, Matrix<double>&) const method
+
+/// This method writes the activation derivatives from every perceptron in the layer for a block of combinations into a given matrix. 
+/// The storage of that matrix is reused if it already has the right size. 
+/// @param combination Combinations to the layer, with one instance per row. 
+/// @param activation_derivative Matrix to be set to the activation derivatives, with one instance per row. 
+/// It can be the combination matrix itself, which is then overwritten. 
+
+void PerceptronLayer::calculate_activation_derivative(const Matrix<double>& combination, Matrix<double>& activation_derivative) const
+{
+   const unsigned int perceptrons_number = count_perceptrons_number();
+
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   const unsigned int combination_columns_number = combination.get_columns_number();
+
+   if(combination_columns_number != perceptrons_number) 
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: PerceptronLayer class.\n"
+             << "void calculate_activation_derivative(const Matrix<double>&, Matrix<double>&) const method.\n"
+             << "Number of columns of combination must be equal to number of neurons.\n";
+
+	  throw std::logic_error(buffer.str());
+   }   
+
+   #endif
+
+   const unsigned int instances_number = combination.get_rows_number();
+
+   activation_derivative.set(instances_number, perceptrons_number);
+
+   for(unsigned int k = 0; k < instances_number; k++)
+   {
+      for(unsigned int i = 0; i < perceptrons_number; i++)
+      {
+         activation_derivative[k][i] = perceptrons[i].calculate_activation_derivative(combination[k][i]);
+      }
+   }
+}
+
+
 // Matrix<double> arrange_activation_Jacobian(const Vector<double>&) const method
 
 /// This method arranges a "Jacobian" matrix from a vector of derivatives. 
@@ -1417,6 +1637,18 @@ Vector<double> PerceptronLayer::calculate_outputs(const Vector<double>& inputs)
 }
 
 
+// Matrix<double> calculate_outputs(const Matrix<double>&) const method
+
+/// This method returns the outputs from every perceptron in the layer for a block of inputs. 
+/// Each row of the inputs and outputs matrices corresponds to an instance. 
+/// @param inputs Inputs to the layer, with one instance per row. 
+
+Matrix<double> PerceptronLayer::calculate_outputs(const Matrix<double>& inputs) const
+{
+   return(calculate_activation(calculate_combination(inputs)));
+}
+
+
 // Matrix<double> calculate_Jacobian(const Vector<double>&) const method
 
 /// This method returns the Jacobian matrix of a layer for a given inputs to that layer. 
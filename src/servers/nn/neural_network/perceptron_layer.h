@@ -161,6 +161,8 @@ public:
    // PerceptronLayer combination
 
    Vector<double> calculate_combination(const Vector<double>&) const; 
+   Matrix<double> calculate_combination(const Matrix<double>&) const; 
+   void calculate_combination(const Matrix<double>&, Matrix<double>&) const; 
    Matrix<double> calculate_combination_Jacobian(const Vector<double>&) const;
    Vector< Matrix<double> > calculate_combination_Hessian_form(const Vector<double>&) const;
 
@@ -174,12 +176,18 @@ public:
    Vector<double> calculate_activation_derivative(const Vector<double>&) const;
    Vector<double> calculate_activation_second_derivative(const Vector<double>&) const;
 
+   Matrix<double> calculate_activation(const Matrix<double>&) const;
+   Matrix<double> calculate_activation_derivative(const Matrix<double>&) const;
+   void calculate_activation(const Matrix<double>&, Matrix<double>&) const;
+   void calculate_activation_derivative(const Matrix<double>&, Matrix<double>&) const;
+
    Matrix<double> arrange_activation_Jacobian(const Vector<double>&) const;
    Vector< Matrix<double> > arrange_activation_Hessian_form(const Vector<double>&) const;
 
    // PerceptronLayer outputs 
 
    Vector<double> calculate_outputs(const Vector<double>&) const;
+   Matrix<double> calculate_outputs(const Matrix<double>&) const;
    Matrix<double> calculate_Jacobian(const Vector<double>&) const;
    Vector< Matrix<double> > calculate_Hessian_form(const Vector<double>&) const;
 
@@ -65,6 +65,7 @@ static const int32 MSG_DEBUG_THIS_TEAM = 'dbtt';
 
 #include "queue.h"
 #include "file/TextFile.h"
+#include "RequestScheduler.h"
 
 using std::map;
 using std::nothrow;
@@ -72,6 +73,13 @@ using std::nothrow;
 
 static const char *kSignature = "application/x-vnd.Haiku-nn";
 
+static const int32 kListenerPortCapacity = 64;
+
+// Inference requests are batched until they have that many rows, or until
+// the oldest of them has waited that long.
+static const uint32 kMaxBatchRows = 256;
+static const bigtime_t kMaxBatchLatency = 2000;
+
 
 
 class NN : public BServer {
@@ -85,7 +93,7 @@ public:
 private:
 	static status_t _ListenerEntry(void *data);
 	status_t _Listener();
-	status_t GotMessage(Msg *message);
+	status_t GotMessage(Msg *message, ssize_t size);
 
 //	void _DeleteNNHandler(NNHandler *handler);
 
@@ -95,6 +103,7 @@ private:
 	port_id				fListenerPort;
 	thread_id			fListener;
 	bool				fTerminating;
+	RequestScheduler	fScheduler;
 };
 
 
@@ -460,10 +469,14 @@ NN::Init()
 	
 	debug_printf("NN::Init creating listener port\n");
 	// create listener port
-	fListenerPort = create_port(10, NN_PORT);
+	fListenerPort = create_port(kListenerPortCapacity, NN_PORT);
 	if (fListenerPort < 0)
 		return fListenerPort;
 
+	status_t error = fScheduler.Init(kMaxBatchRows, kMaxBatchLatency);
+	if (error != B_OK)
+		return error;
+
 	// spawn the listener thread
 	fListener = spawn_thread(_ListenerEntry, "neural listener",
 		B_NORMAL_PRIORITY, this);
@@ -730,61 +743,54 @@ NN::_Listener()
 {
 debug_printf("NN:: _Listener \n");
 	while (!fTerminating) {
-	debug_printf("NN:: _Listener fTerminating false \n");
-		// receive the next debug message
-		DebugMessage *message = new DebugMessage;
-		int32 code;
-		//char data[100];
-		ssize_t bytesRead;
-		//char abc[200]; //working good
-		Msg *deta = new Msg();
+		// receive the next request, and find out which team sent it
+		Msg message;
+		port_message_info info;
+		status_t status;
 		do {
-		debug_printf("reading\n");
-			/*bytesRead = read_port(fListenerPort, &code, &message->Data(),
-				sizeof(debug_debugger_message_data));*/
-			//below is working good
-			//bytesRead = read_port(fListenerPort, &code, &abc,
-			//	sizeof(abc));
-			bytesRead = read_port(fListenerPort, &code, &deta->Data(),
-				sizeof(kile));
-			//bytesRead = read_port(fListenerPort, &code, data,
-			//	sizeof(data));
-		} while (bytesRead == B_INTERRUPTED);
-		debug_printf("NN _Listener = %ld\n",bytesRead);
+			status = get_port_message_info_etc(fListenerPort, &info, 0, 0);
+		} while (status == B_INTERRUPTED);
+
+		int32 code;
+		ssize_t bytesRead = status;
+		if (status == B_OK) {
+			do {
+				bytesRead = read_port(fListenerPort, &code,
+					&message.Request(), sizeof(nn_request));
+			} while (bytesRead == B_INTERRUPTED);
+		}
 
 		if (bytesRead < 0) {
-			debug_printf("debug_server: Failed to read from listener port: "
+			debug_printf("nn: Failed to read from listener port: "
 				"%s. Terminating!\n", strerror(bytesRead));
 			exit(1);
 		}
-		debug_printf("code = %d\n", code);
-/*debug_printf("debug_server: Got debug message: team: %" B_PRId32 ", code: %" B_PRId32
-	 " %s\n", message->Data().origin.team, code, abc);*/
-	 debug_printf("debug_server: Got debug message: team: %" B_PRId32 ", code: %" B_PRId32
-	 " %ld area_id = %d \n", message->Data().origin.team, code, deta->Data().size, deta->Data().areaID);
+		TRACE(("nn: got request %" B_PRId32 " of %ld bytes\n", code,
+			bytesRead));
 
-		deta->SetCode((nn_msg)code);
+		message.SetCode((nn_msg)code);
+		message.SetSenderTeam(info.sender_team);
 
 		// dispatch the message
-		GotMessage(deta);
+		GotMessage(&message, bytesRead);
 	}
 
 	return B_OK;
 }
 
 
-status_t NN::GotMessage(Msg *message){
+status_t NN::GotMessage(Msg *message, ssize_t size){
 
-	debug_printf("NN DispatchMessage \n");
-	debug_printf("size = %ld \n", message->Data().size);
-	
 	switch(message->Code()){
 		case NN_INIT:
-			debug_printf("NN NN_INIT\n");
+			debug_printf("NN NN_INIT area_id = %d size = %ld\n",
+				message->Data().areaID, message->Data().size);
 			
 		break;
 		default:
-			debug_printf("NN GotMessage default\n");
+			// model, inference and training requests
+			fScheduler.HandleRequest(message->Code(), message->Request(),
+				size, message->SenderTeam());
 		break;
 	}
 	
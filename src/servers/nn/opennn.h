@@ -20,6 +20,9 @@
 // Data set
 
 #include "data_set/data_set.h"
+#include "data_set/binary_data_file.h"
+#include "data_set/data_stream.h"
+#include "data_set/instance_view.h"
 #include "data_set/instances_information.h"
 #include "data_set/variables_information.h"
 
@@ -48,6 +51,7 @@
 #include "neural_network/scaling_layer.h"
 #include "neural_network/unscaling_layer.h"
 #include "neural_network/neural_network.h"
+#include "neural_network/compiled_neural_network.h"
 
 // Performance functional
 
@@ -95,6 +99,7 @@
 #include "utilities/matrix.h"
 #include "utilities/numerical_differentiation.h"
 #include "utilities/numerical_integration.h"
+#include "utilities/thread_pool.h"
 #include "utilities/vector.h"
 
 // TinyXml includes
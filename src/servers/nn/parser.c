@@ -1072,6 +1072,26 @@ static Ast *read_decl_or_func_def(void)
     return NULL; /* non-reachable */
 }
 
+static void clear_dict(Dict *dict)
+{
+    list_free(dict->list);
+    *dict->list = EMPTY_LIST;
+}
+
+/* Forgets the declarations and types of the last source, whether it parsed
+ * or not, so that the next one starts from an empty global scope. */
+void reset_parser(void)
+{
+    localenv = NULL;
+    localvars = NULL;
+    clear_dict(globalenv);
+    clear_dict(struct_defs);
+    clear_dict(union_defs);
+    list_free(ctypes);
+    *ctypes = EMPTY_LIST;
+    labelseq = 0;
+}
+
 List *read_toplevels(void)
 {
     List *r = make_list();
@@ -547,74 +547,79 @@ Vector<double> CrossEntropyError::calculate_gradient(void) const
 
    #endif
 
-   // Neural network stuff    
-
-   Vector< Vector< Vector<double> > > first_order_forward_propagation(2); 
-
-   Vector<double> particular_solution;
-   Vector<double> homogeneous_solution;
-
    // Data set stuff
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
 
    const unsigned int training_instances_number = instances_information.count_training_instances_number();
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> targets(outputs_number);
-
    // Sum squared error stuff
 
-   Vector<double> output_objective_gradient(outputs_number);
-
-   Vector< Vector<double> > layers_delta; 
+   Vector<double> gradient(network_parameters_number, 0.0);
 
-   Vector<double> point_gradient(network_parameters_number, 0.0);
+   gradient = calculate_instances_sum< Vector<double> >(training_instances_number, gradient, 
+   [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
+   {
+      Vector< Vector< Vector<double> > > first_order_forward_propagation(2);
 
-   Vector<double> gradient(network_parameters_number, 0.0);
+      Vector<double> particular_solution;
+      Vector<double> homogeneous_solution;
 
+      Vector<double> inputs(inputs_number);
+      Vector<double> targets(outputs_number);
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
-   {
-      inputs = data_set_pointer->get_training_input_instance(i);
+      Vector<double> output_objective_gradient(outputs_number);
 
-      targets = data_set_pointer->get_training_target_instance(i);
+      Vector< Vector<double> > layers_delta;
 
-      first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
+      Vector<double> point_gradient(network_parameters_number, 0.0);
 
-      const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
-      const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+      Vector<double> block_gradient(network_parameters_number, 0.0);
 
-      if(!conditions_layer_flag)
+      for(unsigned int i = first_instance; i < first_instance+block_instances_number; i++)
       {
-         const Vector<double>& outputs = layers_activation[layers_number-1];
+         inputs = data_set_pointer->get_training_input_instance(i);
+
+         targets = data_set_pointer->get_training_target_instance(i);
+
+         first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
 
-         for(unsigned int j = 0; j < outputs_number; j++)
+         const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
+         const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+
+         if(!conditions_layer_flag)
          {
-            output_objective_gradient[j] = -targets[j]/outputs[j] + (1.0 - targets[j])*(1.0 - outputs[j]);
+            const Vector<double>& outputs = layers_activation[layers_number-1];
+
+            for(unsigned int j = 0; j < outputs_number; j++)
+            {
+               output_objective_gradient[j] = -targets[j]/outputs[j] + (1.0 - targets[j])*(1.0 - outputs[j]);
+            }
+
+            layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
          }
+         else
+         {
+            particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
+            homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
 
-         layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
-      }
-      else
-      {
-         particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
-         homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
+            Vector<double> outputs = particular_solution + homogeneous_solution*layers_activation[layers_number-1];
 
-         Vector<double> outputs = particular_solution + homogeneous_solution*layers_activation[layers_number-1];
+            for(unsigned int j = 0; j < outputs_number; j++)
+            {
+               output_objective_gradient[j] = -targets[j]/outputs[j] + (1.0 - targets[j])*(1.0 - outputs[j]);
+            }
 
-         for(unsigned int j = 0; j < outputs_number; j++)
-         {
-            output_objective_gradient[j] = -targets[j]/outputs[j] + (1.0 - targets[j])*(1.0 - outputs[j]);
+		    layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
          }
 
-		 layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
-      }
+         point_gradient = calculate_point_gradient(inputs, layers_activation, layers_delta);
 
-      point_gradient = calculate_point_gradient(inputs, layers_activation, layers_delta);
+         block_gradient += point_gradient;
+      }
 
-      gradient += point_gradient;
-   }
+      return(block_gradient);
+   });
 
    return(gradient);
 }
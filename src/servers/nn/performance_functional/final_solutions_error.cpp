@@ -525,14 +525,54 @@ double FinalSolutionsError::calculate_evaluation(const Vector<double>& parameter
    NeuralNetwork neural_network_copy(*neural_network_pointer);
    neural_network_copy.set_parameters(parameters);
 
+   // The copy shares the mathematical model; setting it again would reset the targets and weights.
+
    FinalSolutionsError final_solutions_error_copy(*this);
    final_solutions_error_copy.set_neural_network_pointer(&neural_network_copy);
-   final_solutions_error_copy.set_mathematical_model_pointer(mathematical_model_pointer);
 
    return(final_solutions_error_copy.calculate_evaluation());
 }
 
 
+// Vector<double> calculate_gradient(void) const method
+
+/// This method returns the gradient of the final solutions error with respect to the neural network parameters. 
+/// When the mathematical model provides the sensitivities of its final solutions to the parameters, 
+/// the gradient is exact and costs about one solution of the model. 
+/// Otherwise, it is computed by numerical differentiation, which takes two solutions for each parameter. 
+
+Vector<double> FinalSolutionsError::calculate_gradient(void) const
+{
+   // Control sentence
+
+   #ifdef _DEBUG 
+
+   check();
+
+   #endif
+
+   const Matrix<double> final_solutions_parameters_Jacobian = mathematical_model_pointer->calculate_final_solutions_parameters_Jacobian(*neural_network_pointer);
+
+   if(final_solutions_parameters_Jacobian.empty())
+   {
+      return(PerformanceTerm::calculate_gradient());
+   }
+
+   // Final solutions error stuff
+
+   const unsigned int independent_variables_number = mathematical_model_pointer->get_independent_variables_number();
+   const unsigned int dependent_variables_number = mathematical_model_pointer->get_dependent_variables_number();
+
+   const Vector<double> final_solutions = mathematical_model_pointer->calculate_final_solutions(*neural_network_pointer);
+
+   const Vector<double> dependent_variables_final_solutions = final_solutions.take_out(independent_variables_number, dependent_variables_number);
+
+   const Vector<double> final_solutions_errors = dependent_variables_final_solutions - target_final_solutions;
+
+   return((final_solutions_errors_weights*final_solutions_errors*2.0).dot(final_solutions_parameters_Jacobian));
+}
+
+
 // std::string write_performance_term_type(void) const method
 
 /// This method returns a string with the name of the final solutions error performance type, "FINAL_SOLUTIONS_ERROR".
@@ -115,6 +115,8 @@ public:
 
    double calculate_evaluation(const Vector<double>&) const;
 
+   Vector<double> calculate_gradient(void) const;
+
    std::string write_performance_term_type(void) const;
 
    std::string write_information(void) const;
@@ -17,6 +17,7 @@
 
 #include <string>
 #include <sstream>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <limits>
@@ -232,13 +233,6 @@ double MeanSquaredError::calculate_evaluation(void) const
 
    #endif
 
-   // Neural network stuff 
-
-   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
-
-   const unsigned int inputs_number = multilayer_perceptron_pointer->count_inputs_number();
-   const unsigned int outputs_number = multilayer_perceptron_pointer->count_outputs_number();
-
    // Data set stuff 
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
@@ -247,30 +241,13 @@ double MeanSquaredError::calculate_evaluation(void) const
 
    // Mean squared error stuff
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> outputs(outputs_number);
-   Vector<double> targets(outputs_number);
-
    double sum_squared_error = 0.0;
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   calculate_instances_sum<double>(training_instances_number, 0.0, sum_squared_error, 
+   [&](const unsigned int& first_instance, const unsigned int& block_instances_number, BlockWorkspace& workspace, double& block_sum_squared_error)
    {
-      // Input vector
-
-	  inputs = data_set_pointer->get_training_input_instance(i);
-
-      // Output vector
-
-      outputs = multilayer_perceptron_pointer->calculate_outputs(inputs);
-
-      // Target vector
-
-      targets = data_set_pointer->get_training_target_instance(i);
-
-      // Sum squared error
-
-	  sum_squared_error += outputs.calculate_sum_squared_error(targets);
-   }
+      block_sum_squared_error += calculate_block_sum_squared_error(first_instance, block_instances_number, workspace);
+   });
 
    return(sum_squared_error/(double)training_instances_number);
 }
@@ -410,67 +387,77 @@ Vector<double> MeanSquaredError::calculate_gradient(void) const
 
    const unsigned int parameters_number = multilayer_perceptron_pointer->count_parameters_number();
 
-   Vector< Vector< Vector<double> > > first_order_forward_propagation(2); 
-
    const ConditionsLayer* conditions_layer_pointer = neural_network_pointer->get_conditions_layer_pointer();
 
    const bool& conditions_layer_flag = neural_network_pointer->get_conditions_layer_flag();
 
-   Vector<double> particular_solution;
-   Vector<double> homogeneous_solution;
-
    // Data set stuff
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
 
    const unsigned int training_instances_number = instances_information.count_training_instances_number();
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> targets(outputs_number);
-
    // Mean squared error stuff
 
-   Vector< Vector<double> > layers_delta; 
+   Vector<double> objective_gradient(parameters_number, 0.0);
+
+   if(!conditions_layer_flag)
+   {
+      // Propagate blocks of training instances as matrices
 
-   Vector<double> output_objective_gradient(outputs_number);
+      const Vector<double> zero(parameters_number, 0.0);
 
-   Vector<double> point_gradient(parameters_number, 0.0);
+      calculate_instances_sum< Vector<double> >(training_instances_number, zero, objective_gradient, 
+      [&](const unsigned int& first_instance, const unsigned int& block_instances_number, BlockWorkspace& workspace, Vector<double>& block_gradient)
+      {
+         add_block_squared_errors_gradient(first_instance, block_instances_number, 1.0/(double)training_instances_number, workspace, block_gradient);
+      });
 
-   Vector<double> objective_gradient(parameters_number, 0.0);
+      return(objective_gradient);
+   }
 
    // Main loop
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   objective_gradient = calculate_instances_sum< Vector<double> >(training_instances_number, objective_gradient, 
+   [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
    {
-      inputs = data_set_pointer->get_training_input_instance(i);
+      Vector<double> inputs(inputs_number);
+      Vector<double> targets(outputs_number);
 
-      targets = data_set_pointer->get_training_target_instance(i);
+      Vector< Vector< Vector<double> > > first_order_forward_propagation(2); 
 
-      first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
+      Vector<double> particular_solution;
+      Vector<double> homogeneous_solution;
 
-	  const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
-      const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+      Vector< Vector<double> > layers_delta; 
 
-      if(!conditions_layer_flag)
-      {
-         output_objective_gradient = (layers_activation[layers_number-1]-targets)*(2.0/(double)training_instances_number);
+      Vector<double> output_objective_gradient(outputs_number);
 
-         layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
-      }
-      else
+      Vector<double> block_gradient(parameters_number, 0.0);
+
+      for(unsigned int i = first_instance; i < first_instance+block_instances_number; i++)
       {
+         inputs = data_set_pointer->get_training_input_instance(i);
+
+         targets = data_set_pointer->get_training_target_instance(i);
+
+         first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
+
+	     const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
+         const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+
          particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
          homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
 
          output_objective_gradient = (particular_solution+homogeneous_solution*layers_activation[layers_number-1] - targets)*(2.0/(double)training_instances_number);              
 
-		 layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
-      }
+         layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
 
-      point_gradient = calculate_point_gradient(inputs, layers_activation, layers_delta);
+         block_gradient += calculate_point_gradient(inputs, layers_activation, layers_delta);
+      }
 
-      objective_gradient += point_gradient;
-   }
+      return(block_gradient);
+   });
 
    return(objective_gradient);
 }
@@ -534,13 +521,6 @@ Vector<double> MeanSquaredError::calculate_evaluation_terms(void) const
 
    #endif
 
-   // Neural network stuff
-
-   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
-
-   const unsigned int inputs_number = multilayer_perceptron_pointer->count_inputs_number();
-   const unsigned int outputs_number = multilayer_perceptron_pointer->count_outputs_number();
-
    // Data set stuff
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
@@ -551,28 +531,15 @@ Vector<double> MeanSquaredError::calculate_evaluation_terms(void) const
 
    Vector<double> evaluation_terms(training_instances_number);
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> outputs(outputs_number);
-   Vector<double> targets(outputs_number);
-
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   run_instances_blocks(training_instances_number, [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
    {
-      // Input vector
-
-	  inputs = data_set_pointer->get_training_input_instance(i);
-
-      // Output vector
-
-      outputs = multilayer_perceptron_pointer->calculate_outputs(inputs);
-
-      // Target vector
+      calculate_block_squared_errors(first_instance, block_instances_number, get_block_workspace(block_instances_number), evaluation_terms);
 
-      targets = data_set_pointer->get_training_target_instance(i);
-
-      // Error
-
-      evaluation_terms[i] = outputs.calculate_distance(targets);
-   }
+      for(unsigned int i = 0; i < block_instances_number; i++)
+      {
+         evaluation_terms[first_instance+i] = sqrt(evaluation_terms[first_instance+i]);
+      }
+   });
 
    return(evaluation_terms/sqrt((double)training_instances_number));
 }
@@ -651,11 +618,6 @@ Matrix<double> MeanSquaredError::calculate_Jacobian_terms(void) const
 
    const unsigned int network_parameters_number = multilayer_perceptron_pointer->count_parameters_number();
 
-   Vector< Vector< Vector<double> > > first_order_forward_propagation(2);
-
-   Vector<double> particular_solution;
-   Vector<double> homogeneous_solution;
-
    const ConditionsLayer* conditions_layer_pointer = neural_network_pointer->get_conditions_layer_pointer();
 
    const bool& conditions_layer_flag = neural_network_pointer->get_conditions_layer_flag();
@@ -666,76 +628,84 @@ Matrix<double> MeanSquaredError::calculate_Jacobian_terms(void) const
 
    const unsigned int training_instances_number = instances_information.count_training_instances_number();
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> targets(outputs_number);
-
    // Objective functional
 
-   Vector<double> term(outputs_number);
-   double term_norm;
-
-   Vector<double> output_objective_gradient(outputs_number);
-
-   Vector< Vector<double> > layers_delta(layers_number);
-   Vector<double> point_gradient(network_parameters_number);
-
    Matrix<double> Jacobian_terms(training_instances_number, network_parameters_number);
 
    // Main loop
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   run_instances_blocks(training_instances_number, [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
    {
-      inputs = data_set_pointer->get_training_input_instance(i);
+      Vector< Vector< Vector<double> > > first_order_forward_propagation(2);
+
+      Vector<double> particular_solution;
+      Vector<double> homogeneous_solution;
+
+      Vector<double> inputs(inputs_number);
+      Vector<double> targets(outputs_number);
 
-	  targets = data_set_pointer->get_training_target_instance(i);
+      Vector<double> term(outputs_number);
+      double term_norm;
 
-      first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
+      Vector<double> output_objective_gradient(outputs_number);
 
-      const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
-      const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+      Vector< Vector<double> > layers_delta(layers_number);
+      Vector<double> point_gradient(network_parameters_number);
 
-      if(!conditions_layer_flag)
+      for(unsigned int i = first_instance; i < first_instance+block_instances_number; i++)
       {
-         const Vector<double>& outputs = first_order_forward_propagation[0][layers_number-1]; 
+         inputs = data_set_pointer->get_training_input_instance(i);
 
-         term = (outputs-targets);
-         term_norm = term.calculate_norm();
+	     targets = data_set_pointer->get_training_target_instance(i);
 
-         if(term_norm == 0.0)
-   	     {
-	        output_objective_gradient.initialize(0.0);
-	     }
-         else
-	     {
-            output_objective_gradient = term/term_norm;	      
-	     }
+         first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
 
-         layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
-      }
-      else
-      {
-         particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
-         homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
+         const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
+         const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
 
-         term = (particular_solution+homogeneous_solution*layers_activation[layers_number-1] - targets)/sqrt((double)training_instances_number);              
-         term_norm = term.calculate_norm();
+         if(!conditions_layer_flag)
+         {
+            const Vector<double>& outputs = first_order_forward_propagation[0][layers_number-1]; 
 
-         if(term_norm == 0.0)
-   	     {
-	        output_objective_gradient.initialize(0.0);
-	     }
-	     else
-	     {
-            output_objective_gradient = term/term_norm;	      
-	     }
+            term = (outputs-targets);
+            term_norm = term.calculate_norm();
 
-		 layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
-	  }
+            if(term_norm == 0.0)
+      	     {
+	           output_objective_gradient.initialize(0.0);
+	        }
+            else
+	        {
+               output_objective_gradient = term/term_norm;	      
+	        }
 
-      point_gradient = calculate_point_gradient(inputs, layers_activation, layers_delta);
+            layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
+         }
+         else
+         {
+            particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
+            homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
+
+            term = (particular_solution+homogeneous_solution*layers_activation[layers_number-1] - targets)/sqrt((double)training_instances_number);              
+            term_norm = term.calculate_norm();
+
+            if(term_norm == 0.0)
+      	     {
+	           output_objective_gradient.initialize(0.0);
+	        }
+	        else
+	        {
+               output_objective_gradient = term/term_norm;	      
+	        }
+
+		    layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
+	     }
 
-      Jacobian_terms.set_row(i, point_gradient);
-  }
+         point_gradient = calculate_point_gradient(inputs, layers_activation, layers_delta);
+
+         Jacobian_terms.set_row(i, point_gradient);
+      }
+   });
 
    return(Jacobian_terms/sqrt((double)training_instances_number));
 }
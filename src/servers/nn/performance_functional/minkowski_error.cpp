@@ -333,30 +333,36 @@ double MinkowskiError::calculate_evaluation(void) const
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
    const unsigned int training_instances_number = instances_information.count_training_instances_number();
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> outputs(outputs_number);
-   Vector<double> targets(outputs_number);
+   const double Minkowski_error = calculate_instances_sum<double>(training_instances_number, 0.0, 
+   [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
+   {
+      Vector<double> inputs(inputs_number);
+      Vector<double> outputs(outputs_number);
+      Vector<double> targets(outputs_number);
 
-   double Minkowski_error = 0.0;
+      double block_Minkowski_error = 0.0;
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
-   {
-      // Input vector
+      for(unsigned int i = first_instance; i < first_instance+block_instances_number; i++)
+      {
+         // Input vector
 
-	  inputs = data_set_pointer->get_training_input_instance(i);
+	     inputs = data_set_pointer->get_training_input_instance(i);
 
-      // Output vector
+         // Output vector
 
-      outputs = multilayer_perceptron_pointer->calculate_outputs(inputs);
+         outputs = multilayer_perceptron_pointer->calculate_outputs(inputs);
 
-      // Target vector
+         // Target vector
 
-      targets = data_set_pointer->get_training_target_instance(i);
+         targets = data_set_pointer->get_training_target_instance(i);
 
-      // Minkowski error
+         // Minkowski error
 
-	  Minkowski_error += outputs.calculate_Minkowski_error(targets, Minkowski_parameter);
-   }
+	     block_Minkowski_error += outputs.calculate_Minkowski_error(targets, Minkowski_parameter);
+      }
+
+      return(block_Minkowski_error);
+   });
 
    return(Minkowski_error);
 }
@@ -18,6 +18,7 @@
 #include <string>
 #include <sstream>
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <limits>
@@ -123,6 +124,28 @@ double NormalizedSquaredError::calculate_normalization_coefficient(const Matrix<
 }
 
 
+// double calculate_training_normalization_coefficient(const Vector<double>&) const method
+
+/// This method returns the normalization coefficient measured on the training instances of the data set. 
+/// The target data is visited in blocks of instances, which are processed concurrently if several threads are used. 
+/// @param training_target_data_mean Mean of the training target data.
+
+double NormalizedSquaredError::calculate_training_normalization_coefficient(const Vector<double>& training_target_data_mean) const
+{
+   const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
+
+   const unsigned int training_instances_number = instances_information.count_training_instances_number();
+
+   return(calculate_instances_sum<double>(training_instances_number, 0.0, 
+   [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
+   {
+      const Matrix<double> targets = data_set_pointer->arrange_training_target_data(first_instance, block_instances_number);
+
+      return(calculate_normalization_coefficient(targets, training_target_data_mean));
+   }));
+}
+
+
 // void check(void) const method
 
 /// This method checks that there are a neural network and a data set associated to the normalized squared error, 
@@ -229,13 +252,6 @@ double NormalizedSquaredError::calculate_evaluation(void) const
 
    #endif
 
-   // Neural network stuff
-
-   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
-
-   const unsigned int inputs_number = multilayer_perceptron_pointer->count_inputs_number();
-   const unsigned int outputs_number = multilayer_perceptron_pointer->count_outputs_number();
-
    // Data set stuff
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
@@ -246,35 +262,17 @@ double NormalizedSquaredError::calculate_evaluation(void) const
 
    // Normalized squared error stuff 
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> outputs(outputs_number);
-   Vector<double> targets(outputs_number);
-
    double sum_squared_error = 0.0;
-   double normalization_coefficient = 0.0;
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   calculate_instances_sum<double>(training_instances_number, 0.0, sum_squared_error, 
+   [&](const unsigned int& first_instance, const unsigned int& block_instances_number, BlockWorkspace& workspace, double& block_sum_squared_error)
    {
-      // Input vector
-
-	  inputs = data_set_pointer->get_training_input_instance(i);
-
-      // Output vector
+      block_sum_squared_error += calculate_block_sum_squared_error(first_instance, block_instances_number, workspace);
+   });
 
-      outputs = multilayer_perceptron_pointer->calculate_outputs(inputs);
-
-      // Target vector
+   // Normalization coefficient
 
-      targets = data_set_pointer->get_training_target_instance(i);
-
-      // Sum squared error
-
-	  sum_squared_error += outputs.calculate_sum_squared_error(targets);
-
-	  // Normalization coefficient
-
-	  normalization_coefficient += targets.calculate_sum_squared_error(training_target_data_mean);
-   }
+   const double normalization_coefficient = calculate_training_normalization_coefficient(training_target_data_mean);
 
    if(normalization_coefficient < 1.0e-99)
    {
@@ -439,19 +437,10 @@ Vector<double> NormalizedSquaredError::calculate_gradient(void) const
 
    const unsigned int layers_number = multilayer_perceptron_pointer->count_layers_number();
 
-   Vector< Vector< Vector<double> > > first_order_forward_propagation(2); 
-
-   Vector< Vector<double> > layers_inputs(layers_number); 
-
-   Vector< Matrix<double> > layers_combination_parameters_Jacobian; 
-
    const ConditionsLayer* conditions_layer_pointer = neural_network_pointer->get_conditions_layer_pointer();
 
    const bool& conditions_layer_flag = neural_network_pointer->get_conditions_layer_flag();
 
-   Vector<double> particular_solution;
-   Vector<double> homogeneous_solution;
-
    // Data set stuff
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
@@ -460,61 +449,82 @@ Vector<double> NormalizedSquaredError::calculate_gradient(void) const
 
    const Vector<double> training_target_data_mean = data_set_pointer->calculate_training_target_data_mean();
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> targets(outputs_number);
-
    // Normalized squared error stuff
 
-   Vector<double> output_objective_gradient(outputs_number);
+   Vector<double> gradient(parameters_number, 0.0);
 
-   Vector< Vector<double> > layers_delta; 
+   const double normalization_coefficient = calculate_training_normalization_coefficient(training_target_data_mean);
 
-   Vector<double> gradient(parameters_number, 0.0);
+   if(!conditions_layer_flag)
+   {
+      // Propagate blocks of training instances as matrices
 
-   double normalization_coefficient = 0.0;
+      const Vector<double> zero(parameters_number, 0.0);
+
+      calculate_instances_sum< Vector<double> >(training_instances_number, zero, gradient, 
+      [&](const unsigned int& first_instance, const unsigned int& block_instances_number, BlockWorkspace& workspace, Vector<double>& block_gradient)
+      {
+         add_block_squared_errors_gradient(first_instance, block_instances_number, 1.0, workspace, block_gradient);
+      });
+
+      return(gradient/normalization_coefficient);
+   }
 
    // Main loop
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   gradient = calculate_instances_sum< Vector<double> >(training_instances_number, gradient, 
+   [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
    {
-      // Data set
+      Vector< Vector< Vector<double> > > first_order_forward_propagation(2); 
 
-      inputs = data_set_pointer->get_training_input_instance(i);
+      Vector< Vector<double> > layers_inputs(layers_number); 
 
-      targets = data_set_pointer->get_training_target_instance(i);
+      Vector< Matrix<double> > layers_combination_parameters_Jacobian; 
 
-	  // Multilayer perceptron
+      Vector<double> particular_solution;
+      Vector<double> homogeneous_solution;
 
-      first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
-      const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
-      const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+      Vector<double> inputs(inputs_number);
+      Vector<double> targets(outputs_number);
 
-      layers_inputs = multilayer_perceptron_pointer->arrange_layers_input(inputs, layers_activation);   
+      Vector<double> output_objective_gradient(outputs_number);
 
-	  layers_combination_parameters_Jacobian = multilayer_perceptron_pointer->calculate_layers_combination_parameters_Jacobian(layers_inputs);
+      Vector< Vector<double> > layers_delta; 
 
-	  // Performance functional
+      Vector<double> block_gradient(parameters_number, 0.0);
 
-      if(!conditions_layer_flag)
+      for(unsigned int i = first_instance; i < first_instance+block_instances_number; i++)
       {
-         output_objective_gradient = (layers_activation[layers_number-1]-targets)*2.0;
+         // Data set
+
+         inputs = data_set_pointer->get_training_input_instance(i);
+
+         targets = data_set_pointer->get_training_target_instance(i);
+
+	     // Multilayer perceptron
+
+         first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
+         const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
+         const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+
+         layers_inputs = multilayer_perceptron_pointer->arrange_layers_input(inputs, layers_activation);   
+
+	     layers_combination_parameters_Jacobian = multilayer_perceptron_pointer->calculate_layers_combination_parameters_Jacobian(layers_inputs);
+
+	     // Performance functional
 
-         layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
-      }
-      else
-      {
          particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
          homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
 
          output_objective_gradient = (particular_solution+homogeneous_solution*layers_activation[layers_number-1] - targets)*2.0;              
 
-		 layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
-      }
+         layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
 
-	  normalization_coefficient += targets.calculate_sum_squared_error(training_target_data_mean);
+         block_gradient += calculate_point_gradient(layers_combination_parameters_Jacobian, layers_delta);
+      }
 
-      gradient += calculate_point_gradient(layers_combination_parameters_Jacobian, layers_delta);
-   }
+      return(block_gradient);
+   });
 
    return(gradient/normalization_coefficient);
 }
@@ -549,13 +559,6 @@ Vector<double> NormalizedSquaredError::calculate_evaluation_terms(void) const
 
    #endif
 
-   // Neural network stuff
-
-   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
-
-   unsigned int inputs_number = multilayer_perceptron_pointer->count_inputs_number();
-   unsigned int outputs_number = multilayer_perceptron_pointer->count_outputs_number();
-
    // Data set stuff
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
@@ -568,34 +571,19 @@ Vector<double> NormalizedSquaredError::calculate_evaluation_terms(void) const
 
    Vector<double> evaluation_terms(training_instances_number);
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> outputs(outputs_number);
-   Vector<double> targets(outputs_number);
-
-   double normalization_coefficient = 0.0;
-
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   run_instances_blocks(training_instances_number, [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
    {
-      // Input vector
-
-	  inputs = data_set_pointer->get_training_input_instance(i);
-
-      // Output vector
-
-      outputs = multilayer_perceptron_pointer->calculate_outputs(inputs);
-
-      // Target vector
+      calculate_block_squared_errors(first_instance, block_instances_number, get_block_workspace(block_instances_number), evaluation_terms);
 
-      targets = data_set_pointer->get_training_target_instance(i);
-
-      // Sum squared error
-
-	  evaluation_terms[i] = outputs.calculate_distance(targets);
+      for(unsigned int i = 0; i < block_instances_number; i++)
+      {
+         evaluation_terms[first_instance+i] = sqrt(evaluation_terms[first_instance+i]);
+      }
+   });
 
-	  // Normalization coefficient
+   // Normalization coefficient
 
-	  normalization_coefficient += targets.calculate_sum_squared_error(training_target_data_mean);
-   }
+   const double normalization_coefficient = calculate_training_normalization_coefficient(training_target_data_mean);
 
    if(normalization_coefficient < 1.0e-99)
    {
@@ -688,15 +676,6 @@ Matrix<double> NormalizedSquaredError::calculate_Jacobian_terms(void) const
 
    const unsigned int parameters_number = multilayer_perceptron_pointer->count_parameters_number();
 
-   Vector< Vector< Vector<double> > > first_order_forward_propagation(2);
-
-   Vector< Matrix<double> > layers_combination_parameters_Jacobian; 
-
-   Vector< Vector<double> > layers_inputs(layers_number); 
-
-   Vector<double> particular_solution;
-   Vector<double> homogeneous_solution;
-
    const bool conditions_layer_flag = neural_network_pointer->get_conditions_layer_flag();
 
    const ConditionsLayer* conditions_layer_pointer = neural_network_pointer->get_conditions_layer_pointer();
@@ -711,93 +690,103 @@ Matrix<double> NormalizedSquaredError::calculate_Jacobian_terms(void) const
 
    const Vector<double> training_target_data_mean = data_set_pointer->calculate_training_target_data_mean();
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> targets(outputs_number);
-
    // Normalized squared error
 
-   Vector<double> term(outputs_number);
-   double term_norm;
-
-   Vector<double> output_objective_gradient(outputs_number);
-
-   Vector< Vector<double> > layers_delta(layers_number);
-   Vector<double> point_gradient(parameters_number);
-
    Matrix<double> Jacobian_terms(training_instances_number, parameters_number);
 
-   double normalization_coefficient = 0.0;
+   const double normalization_coefficient = calculate_training_normalization_coefficient(training_target_data_mean);
 
    // Main loop
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   run_instances_blocks(training_instances_number, [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
    {
-      // Data set
+      Vector< Vector< Vector<double> > > first_order_forward_propagation(2);
 
-      inputs = data_set_pointer->get_training_input_instance(i);
+      Vector< Matrix<double> > layers_combination_parameters_Jacobian;
 
-	  targets = data_set_pointer->get_training_target_instance(i);
+      Vector< Vector<double> > layers_inputs(layers_number);
 
-	  // Neural network
+      Vector<double> particular_solution;
+      Vector<double> homogeneous_solution;
 
-      first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
+      Vector<double> inputs(inputs_number);
+      Vector<double> targets(outputs_number);
 
-      const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
-      const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+      Vector<double> term(outputs_number);
+      double term_norm;
 
-      layers_inputs = multilayer_perceptron_pointer->arrange_layers_input(inputs, layers_activation);
+      Vector<double> output_objective_gradient(outputs_number);
 
-	  layers_combination_parameters_Jacobian = multilayer_perceptron_pointer->calculate_layers_combination_parameters_Jacobian(layers_inputs);
-	  
-	  // Performance functional
+      Vector< Vector<double> > layers_delta(layers_number);
+      Vector<double> point_gradient(parameters_number);
 
-      if(!conditions_layer_flag) // No boundary conditions
+      for(unsigned int i = first_instance; i < first_instance+block_instances_number; i++)
       {
-         const Vector<double>& outputs = layers_activation[layers_number-1]; 
+         // Data set
 
-         term = outputs-targets;
-         term_norm = term.calculate_norm();
+         inputs = data_set_pointer->get_training_input_instance(i);
 
-         if(term_norm == 0.0)
-   	     {
-	        output_objective_gradient.initialize(0.0);
-	     }
-         else
-	     {
-            output_objective_gradient = term/term_norm;	      
-	     }
+	     targets = data_set_pointer->get_training_target_instance(i);
 
-         layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
-      }
-      else // Conditions
-      {        
+	     // Neural network
 
-         particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
-         homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
+         first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
 
-         const Vector<double>& output_layer_activation = layers_activation[layers_number-1]; 
+         const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
+         const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
 
-         term = (particular_solution+homogeneous_solution*output_layer_activation - targets);              
-         term_norm = term.calculate_norm();
+         layers_inputs = multilayer_perceptron_pointer->arrange_layers_input(inputs, layers_activation);
 
-         if(term_norm == 0.0)
-   	     {
-	        output_objective_gradient.initialize(0.0);
-	     }
-	     else
-	     {
-            output_objective_gradient = term/term_norm;	      
-	     }
+	     layers_combination_parameters_Jacobian = multilayer_perceptron_pointer->calculate_layers_combination_parameters_Jacobian(layers_inputs);
+
+	     // Performance functional
+
+         if(!conditions_layer_flag) // No boundary conditions
+         {
+            const Vector<double>& outputs = layers_activation[layers_number-1]; 
+
+            term = outputs-targets;
+            term_norm = term.calculate_norm();
+
+            if(term_norm == 0.0)
+      	     {
+	           output_objective_gradient.initialize(0.0);
+	        }
+            else
+	        {
+               output_objective_gradient = term/term_norm;	      
+	        }
+
+            layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
+         }
+         else // Conditions
+         {        
+
+            particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
+            homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
 
-		 layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
-	  }
+            const Vector<double>& output_layer_activation = layers_activation[layers_number-1]; 
 
-	  normalization_coefficient += targets.calculate_sum_squared_error(training_target_data_mean);
+            term = (particular_solution+homogeneous_solution*output_layer_activation - targets);              
+            term_norm = term.calculate_norm();
 
-      point_gradient = calculate_point_gradient(layers_combination_parameters_Jacobian, layers_delta);
+            if(term_norm == 0.0)
+      	     {
+	           output_objective_gradient.initialize(0.0);
+	        }
+	        else
+	        {
+               output_objective_gradient = term/term_norm;	      
+	        }
 
-      Jacobian_terms.set_row(i, point_gradient);
-  }
+		    layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
+	     }
+
+         point_gradient = calculate_point_gradient(layers_combination_parameters_Jacobian, layers_delta);
+
+         Jacobian_terms.set_row(i, point_gradient);
+      }
+   });
 
    return(Jacobian_terms/sqrt(normalization_coefficient));
 }
@@ -834,13 +823,6 @@ Vector<double> NormalizedSquaredError::calculate_squared_errors(void) const
 
    #endif
 
-   // Neural network stuff
-
-   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
-
-   const unsigned int inputs_number = multilayer_perceptron_pointer->count_inputs_number();
-   const unsigned int outputs_number = multilayer_perceptron_pointer->count_outputs_number();
-
    // Data set stuff
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
@@ -851,28 +833,10 @@ Vector<double> NormalizedSquaredError::calculate_squared_errors(void) const
 
    Vector<double> squared_errors(training_instances_number);
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> outputs(outputs_number);
-   Vector<double> targets(outputs_number);
-
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   run_instances_blocks(training_instances_number, [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
    {
-      // Input vector
-
-	  inputs = data_set_pointer->get_training_input_instance(i);
-
-      // Output vector
-
-      outputs = multilayer_perceptron_pointer->calculate_outputs(inputs);
-
-      // Target vector
-
-      targets = data_set_pointer->get_training_target_instance(i);
-
-      // Error
-
-      squared_errors[i] = outputs.calculate_sum_squared_error(targets);
-   }
+      calculate_block_squared_errors(first_instance, block_instances_number, get_block_workspace(block_instances_number), squared_errors);
+   });
 
    return(squared_errors);
 }
@@ -71,6 +71,7 @@ public:
    // Normalization coefficients 
 
    double calculate_normalization_coefficient(const Matrix<double>&, const Vector<double>&) const;
+   double calculate_training_normalization_coefficient(const Vector<double>&) const;
 
    // Checking methods
 
@@ -21,6 +21,7 @@
 #include <sstream>
 #include <string>
 #include <limits>
+#include <cstdlib>
 
 // OpenNN includes
 
@@ -43,6 +44,8 @@ namespace OpenNN
 OutputsIntegrals::OutputsIntegrals(void) 
  : PerformanceTerm()
 {
+   construct_numerical_differentiation();
+
    set_default();
 }
 
@@ -57,6 +60,8 @@ OutputsIntegrals::OutputsIntegrals(void)
 OutputsIntegrals::OutputsIntegrals(NeuralNetwork* new_neural_network_pointer) 
 : PerformanceTerm(new_neural_network_pointer)
 {
+   construct_numerical_differentiation();
+
    set_default();
 }
 
@@ -71,6 +76,8 @@ OutputsIntegrals::OutputsIntegrals(NeuralNetwork* new_neural_network_pointer)
 OutputsIntegrals::OutputsIntegrals(TiXmlElement* outputs_integrals_element) 
  : PerformanceTerm(outputs_integrals_element)
 {
+   construct_numerical_differentiation();
+
    set_default();
 
    from_XML(outputs_integrals_element);
@@ -127,6 +134,16 @@ const double& OutputsIntegrals::get_output_integral_weight(const unsigned int& i
 }
 
 
+// const unsigned int& get_points_number(void) const method
+
+/// This method returns the number of points at which the neural network outputs are evaluated to integrate them. 
+
+const unsigned int& OutputsIntegrals::get_points_number(void) const
+{
+   return(points_number);
+}
+
+
 // void set_numerical_integration(const NumericalIntegration&) method
 
 /// This method sets a new numerical integration object inside the outputs integral object. 
@@ -161,11 +178,23 @@ void OutputsIntegrals::set_output_integral_weight(const unsigned int& i, const d
 }
 
 
+// void set_points_number(const unsigned int&) method
+
+/// This method sets the number of points at which the neural network outputs are evaluated to integrate them. 
+/// @param new_points_number Number of integration points, which must be odd for the Simpson method. 
+
+void OutputsIntegrals::set_points_number(const unsigned int& new_points_number)
+{
+   points_number = new_points_number;
+}
+
+
 // void set_default(void) method
 
 /// This method sets the default values for the outputs integrals object: 
 /// <ul>
 /// <li> Outputs integrals weights: 1 for each neural network output. 
+/// <li> Points number: 101.
 /// <li> Display: true.
 /// </ul>
 
@@ -179,11 +208,13 @@ void OutputsIntegrals::set_default(void)
 
       if(multilayer_perceptron_pointer)
 	  {
-         outputs_number = multilayer_perceptron_pointer->count_inputs_number();
+         outputs_number = multilayer_perceptron_pointer->count_outputs_number();
 	  }
    }
 
    outputs_integrals_weights.set(outputs_number, 1.0);
+
+   points_number = 101;
   
    display = true;
 }
@@ -247,22 +278,57 @@ void OutputsIntegrals::check(void) const
 }
 
 
-// double calculate_evaluation(void) const method
+// Vector<double> calculate_integration_inputs(void) const method
 
-/// This method returns the objective value of a multilayer perceptron according to the sum squared error on a data set.
-/// @todo
+/// This method returns the values of the neural network input at which the outputs are integrated, 
+/// evenly spaced between the minimum and the maximum of the input in the scaling layer. 
 
-double OutputsIntegrals::calculate_evaluation(void) const
+Vector<double> OutputsIntegrals::calculate_integration_inputs(void) const
 {
-   std::ostringstream buffer;
+   const ScalingLayer* scaling_layer_pointer = neural_network_pointer->get_scaling_layer_pointer();
+
+   if(!scaling_layer_pointer)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: OutputsIntegrals class.\n"
+             << "Vector<double> calculate_integration_inputs(void) const method.\n"
+             << "Pointer to scaling layer is NULL.\n";
+
+      throw std::logic_error(buffer.str().c_str());	  
+   }
+
+   if(points_number < 2)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: OutputsIntegrals class.\n"
+             << "Vector<double> calculate_integration_inputs(void) const method.\n"
+             << "Number of points must be greater than one.\n";
+
+      throw std::logic_error(buffer.str().c_str());	  
+   }
+
+   const double minimum = scaling_layer_pointer->get_minimum(0);
+   const double maximum = scaling_layer_pointer->get_maximum(0);
+
+   Vector<double> inputs(points_number);
+
+   for(unsigned int i = 0; i < points_number; i++)
+   {
+      inputs[i] = minimum + (maximum - minimum)*i/(points_number - 1.0);
+   }
+
+   return(inputs);
+}
 
-   buffer << "OpenNN Exception: OutputsIntegrals class.\n"
-          << "double calculate_evaluation(void) const method.\n"
-          << "This method is under development.\n";
 
-   throw std::logic_error(buffer.str().c_str());	  
+// double calculate_evaluation(void) const method
+
+/// This method returns the weighted sum of the integrals of the neural network outputs. 
 
-/*
+double OutputsIntegrals::calculate_evaluation(void) const
+{
    // Control sentence
 
    #ifdef _DEBUG 
@@ -279,15 +345,23 @@ double OutputsIntegrals::calculate_evaluation(void) const
 
    // Outputs integrals
 
-   double evaluation = 0;
+   const Vector<double> inputs = calculate_integration_inputs();
+
+   Matrix<double> outputs(points_number, outputs_number);
+
+   for(unsigned int i = 0; i < points_number; i++)
+   {
+      outputs.set_row(i, neural_network_pointer->calculate_outputs(Vector<double>(1, inputs[i])));
+   }
+
+   double evaluation = 0.0;
 
-   for(unsigned int i = 0; i < outputs_number; i++)
+   for(unsigned int j = 0; j < outputs_number; j++)
    {
-      evaluation += 0.0;
+      evaluation += outputs_integrals_weights[j]*numerical_integration.calculate_integral(inputs, outputs.arrange_column(j));
    }
 
    return(evaluation);
-*/
 }
 
 
@@ -295,19 +369,11 @@ double OutputsIntegrals::calculate_evaluation(void) const
 
 /// This method returns which would be the evaluation of a neural network for an hypothetical vector of parameters. 
 /// It does not set that vector of parameters to the neural network. 
-// @param parameters Vector of a potential parameters for the neural network associated to the performance functional.
+/// @param parameters Vector of a potential parameters for the neural network associated to the performance functional.
 
-double OutputsIntegrals::calculate_evaluation(const Vector<double>&) const
+double OutputsIntegrals::calculate_evaluation(const Vector<double>& parameters) const
 {
-   std::ostringstream buffer;
-
-   buffer << "OpenNN Exception: OutputsIntegrals class.\n"
-          << "double calculate_evaluation(const Vector<double>&) const method.\n"
-          << "This method is under development.\n";
-
-   throw std::logic_error(buffer.str().c_str());	  
-/*  
- // Control sentence (if debug)
+   // Control sentence (if debug)
 
    #ifdef _DEBUG 
 
@@ -338,20 +404,22 @@ double OutputsIntegrals::calculate_evaluation(const Vector<double>&) const
 
    neural_network_copy.set_parameters(parameters);
 
-   OutputsIntegrals sum_squared_error_copy(*this);
+   OutputsIntegrals outputs_integrals_copy(*this);
 
-   sum_squared_error_copy.set_neural_network_pointer(&neural_network_copy);
+   outputs_integrals_copy.set_neural_network_pointer(&neural_network_copy);
 
-   return(sum_squared_error_copy.calculate_evaluation());
-*/
+   return(outputs_integrals_copy.calculate_evaluation());
 }
 
 
 // Vector<double> calculate_gradient(void) const method
 
-/// This method calculates the objective gradient by means of the back-propagation algorithm, 
-/// and returns it in a single vector of size the number of multilayer_perceptron_pointer parameters. 
-/// @todo
+/// This method returns the gradient of the outputs integrals with respect to the neural network parameters. 
+/// The derivatives of the outputs are computed exactly at each integration point, 
+/// from the parameters Jacobian of the multilayer perceptron and the derivatives of the unscaling and bounding layers, 
+/// and then integrated in the same way as the outputs. 
+/// The independent parameters do not change the outputs, so their derivatives are zero. 
+/// Neural networks with conditions or probabilistic layers use numerical differentiation instead. 
 
 Vector<double> OutputsIntegrals::calculate_gradient(void) const
 {
@@ -363,7 +431,68 @@ Vector<double> OutputsIntegrals::calculate_gradient(void) const
 
    #endif
 
-   Vector<double> gradient;
+   const bool conditions_layer_flag = neural_network_pointer->get_conditions_layer_pointer() && neural_network_pointer->get_conditions_layer_flag();
+   const bool probabilistic_layer_flag = neural_network_pointer->get_probabilistic_layer_pointer() && neural_network_pointer->get_probabilistic_layer_flag();
+
+   if(conditions_layer_flag || probabilistic_layer_flag)
+   {
+      return(PerformanceTerm::calculate_gradient());
+   }
+
+   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
+   const ScalingLayer* scaling_layer_pointer = neural_network_pointer->get_scaling_layer_pointer();
+   const UnscalingLayer* unscaling_layer_pointer = neural_network_pointer->get_unscaling_layer_flag() ? neural_network_pointer->get_unscaling_layer_pointer() : NULL;
+   const BoundingLayer* bounding_layer_pointer = neural_network_pointer->get_bounding_layer_flag() ? neural_network_pointer->get_bounding_layer_pointer() : NULL;
+
+   const unsigned int parameters_number = neural_network_pointer->count_parameters_number();
+   const unsigned int multilayer_perceptron_parameters_number = multilayer_perceptron_pointer->count_parameters_number();
+
+   const Vector<double> multilayer_perceptron_parameters = multilayer_perceptron_pointer->arrange_parameters();
+
+   // Weighted sum of the outputs derivatives at each integration point
+
+   const Vector<double> inputs = calculate_integration_inputs();
+
+   Matrix<double> outputs_derivatives(points_number, multilayer_perceptron_parameters_number);
+
+   for(unsigned int i = 0; i < points_number; i++)
+   {
+      Vector<double> outputs(1, inputs[i]);
+
+      if(neural_network_pointer->get_scaling_layer_flag())
+      {
+         outputs = scaling_layer_pointer->calculate_outputs(outputs);
+      }
+
+      const Matrix<double> parameters_Jacobian = multilayer_perceptron_pointer->calculate_parameters_Jacobian(outputs, multilayer_perceptron_parameters);
+
+      outputs = multilayer_perceptron_pointer->calculate_outputs(outputs);
+
+      Vector<double> weights(outputs_integrals_weights);
+
+      if(unscaling_layer_pointer)
+      {
+         weights = weights*unscaling_layer_pointer->calculate_derivative(outputs);
+
+         outputs = unscaling_layer_pointer->calculate_outputs(outputs);
+      }
+
+      if(bounding_layer_pointer)
+      {
+         weights = weights*bounding_layer_pointer->calculate_derivative(outputs);
+      }
+
+      outputs_derivatives.set_row(i, weights.dot(parameters_Jacobian));
+   }
+
+   // Integrals of the derivatives
+
+   Vector<double> gradient(parameters_number, 0.0);
+
+   for(unsigned int j = 0; j < multilayer_perceptron_parameters_number; j++)
+   {
+      gradient[j] = numerical_integration.calculate_integral(inputs, outputs_derivatives.arrange_column(j));
+   }
 
    return(gradient);
 }
@@ -371,9 +500,7 @@ Vector<double> OutputsIntegrals::calculate_gradient(void) const
 
 // Matrix<double> calculate_Hessian(void) const method
 
-/// This method calculates the objective Hessian by means of the back-propagation algorithm, 
-/// and returns it in a single symmetric matrix of size the number of multilayer_perceptron_pointer parameters. 
-/// @todo
+/// This method returns the objective Hessian, which is computed by numerical differentiation. 
 
 Matrix<double> OutputsIntegrals::calculate_Hessian(void) const
 {
@@ -385,9 +512,7 @@ Matrix<double> OutputsIntegrals::calculate_Hessian(void) const
 
    #endif
     
-   Matrix<double> Hessian;
-
-   return(Hessian);   
+   return(PerformanceTerm::calculate_Hessian());
 }
 
 
@@ -434,6 +559,18 @@ TiXmlElement* OutputsIntegrals::to_XML(void) const
       element->LinkEndChild(text);
    }
 
+   // Points number
+   {
+      TiXmlElement* element = new TiXmlElement("PointsNumber");
+      outputs_integrals_element->LinkEndChild(element);
+
+      buffer.str("");
+      buffer << points_number;
+
+      TiXmlText* text = new TiXmlText(buffer.str().c_str());
+      element->LinkEndChild(text);
+   }
+
    // Display
    {
       TiXmlElement* element = new TiXmlElement("Display");
@@ -459,6 +596,25 @@ void OutputsIntegrals::from_XML(TiXmlElement* outputs_integrals_element)
 {
    if(outputs_integrals_element)
    { 
+      // Points number
+      {
+         TiXmlElement* points_number_element = outputs_integrals_element->FirstChildElement("PointsNumber");
+
+         if(points_number_element)
+         {
+            const unsigned int new_points_number = atoi(points_number_element->GetText());
+
+            try
+            {
+               set_points_number(new_points_number);
+            }
+            catch(std::exception& e)
+            {
+               std::cout << e.what() << std::endl;		 
+            }
+         }
+      }
+
       // Display
       {
          TiXmlElement* display_element = outputs_integrals_element->FirstChildElement("Display");
@@ -27,6 +27,7 @@ namespace OpenNN
 /// This class represents the outputs integrals performance term. 
 /// It is defined as the weighted sum of the integrals of the neural network outputs.
 /// The neural network here must have only one input. 
+/// The integrals are taken between the minimum and the maximum of that input in the scaling layer. 
 /// This performance term might be used in optimal control as an objective or a regularization terms. 
 
 class OutputsIntegrals : public PerformanceTerm
@@ -62,6 +63,8 @@ public:
    const Vector<double>& get_outputs_integrals_weights(void) const;
    const double& get_output_integral_weight(const unsigned int&) const;
 
+   const unsigned int& get_points_number(void) const;
+
    // Set methods
 
    void set_numerical_integration(const NumericalIntegration&);
@@ -69,6 +72,8 @@ public:
    void set_outputs_integrals_weights(const Vector<double>&);
    void set_output_integral_weight(const unsigned int&, const double&);
 
+   void set_points_number(const unsigned int&);
+
    void set_default(void);
 
    // Checking methods
@@ -94,6 +99,10 @@ public:
 
 private:
 
+   // Integration methods
+
+   Vector<double> calculate_integration_inputs(void) const;
+
    /// Object for numerical integration of functions. 
 
    NumericalIntegration numerical_integration;
@@ -102,6 +111,10 @@ private:
 
    Vector<double> outputs_integrals_weights;
 
+   /// Number of points at which the outputs are evaluated to integrate them. 
+
+   unsigned int points_number;
+
 };
 
 }
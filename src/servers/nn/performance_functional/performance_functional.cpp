@@ -559,11 +559,27 @@ const bool& PerformanceFunctional::get_display(void) const
 // void set_neural_network_pointer(NeuralNetwork*) method
 
 /// This method sets a pointer to a multilayer perceptron object which is to be associated to the performance functional.
+/// The objective, regularization and constraints terms are associated to that neural network too. 
 /// @param new_neural_network_pointer Pointer to a neural network object to be associated to the performance functional.
 
 void PerformanceFunctional::set_neural_network_pointer(NeuralNetwork* new_neural_network_pointer)
 {
    neural_network_pointer = new_neural_network_pointer;
+
+   if(objective_term_pointer)
+   {
+      objective_term_pointer->set_neural_network_pointer(new_neural_network_pointer);
+   }
+
+   if(regularization_term_pointer)
+   {
+      regularization_term_pointer->set_neural_network_pointer(new_neural_network_pointer);
+   }
+
+   if(constraints_term_pointer)
+   {
+      constraints_term_pointer->set_neural_network_pointer(new_neural_network_pointer);
+   }
 }
 
 
@@ -936,6 +952,58 @@ void PerformanceFunctional::set_constraints_term_flag(const bool& new_constraint
 }
 
 
+// void set_threads_number(const unsigned int&) method
+
+/// This method sets the number of threads which evaluate the objective, regularization and constraints terms, 
+/// together with their gradients, Jacobians and Hessians. 
+/// It only applies to the terms which have already been constructed. 
+/// @param new_threads_number Number of threads. A value of one evaluates all the terms on the calling thread. 
+
+void PerformanceFunctional::set_threads_number(const unsigned int& new_threads_number)
+{
+   if(objective_term_pointer)
+   {
+      objective_term_pointer->set_threads_number(new_threads_number);
+   }
+
+   if(regularization_term_pointer)
+   {
+      regularization_term_pointer->set_threads_number(new_threads_number);
+   }
+
+   if(constraints_term_pointer)
+   {
+      constraints_term_pointer->set_threads_number(new_threads_number);
+   }
+}
+
+
+// void set_deterministic_reduction(const bool&) method
+
+/// This method sets whether the contributions of the training instances to all the performance terms 
+/// are summed in a fixed order, so that the results do not depend on the number of threads. 
+/// It only applies to the terms which have already been constructed. 
+/// @param new_deterministic_reduction True for a fixed summation order, false otherwise. 
+
+void PerformanceFunctional::set_deterministic_reduction(const bool& new_deterministic_reduction)
+{
+   if(objective_term_pointer)
+   {
+      objective_term_pointer->set_deterministic_reduction(new_deterministic_reduction);
+   }
+
+   if(regularization_term_pointer)
+   {
+      regularization_term_pointer->set_deterministic_reduction(new_deterministic_reduction);
+   }
+
+   if(constraints_term_pointer)
+   {
+      constraints_term_pointer->set_deterministic_reduction(new_deterministic_reduction);
+   }
+}
+
+
 // void set_display(const bool&) method
 
 /// This method sets a new display value. 
@@ -2122,22 +2190,14 @@ Matrix<double> PerformanceFunctional::calculate_Hessian(const Vector<double>& pa
 // Matrix<double> calculate_inverse_Hessian(void) const method
 
 /// This method returns inverse matrix of the Hessian.
-/// It first computes the Hessian matrix and then computes its inverse. 
-/// @todo
+/// It first computes the Hessian matrix and then computes its inverse from the LU factorization. 
+/// Training algorithms should rather solve linear systems with the Hessian, which does not form the inverse. 
 
 Matrix<double> PerformanceFunctional::calculate_inverse_Hessian(void) const
 {  
-   std::ostringstream buffer;
-
-   buffer << "OpenNN Exception: PerformanceFunctional class.\n"
-          << "Matrix<double> calculate_inverse_Hessian(void) const method.\n"
-          << "This method is not yet implemented.\n";
-
-   throw std::logic_error(buffer.str().c_str());	  
-
-//   const Matrix<double> Hessian = calculate_Hessian();
+   const Matrix<double> Hessian = calculate_Hessian();
          
-//   return(Hessian.calculate_inverse());               
+   return(Hessian.calculate_inverse());               
 }
 
 
@@ -244,6 +244,9 @@ public:
    void set_regularization_term_flag(const bool&);
    void set_constraints_term_flag(const bool&);
 
+   void set_threads_number(const unsigned int&);
+   void set_deterministic_reduction(const bool&);
+
    // Serialization methods
 
    void set_display(const bool&);
@@ -19,6 +19,8 @@
 #include <sstream>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
+#include <vector>
 
 // OpenNN includes
 
@@ -206,6 +208,12 @@ PerformanceTerm::PerformanceTerm(const PerformanceTerm& other_performance_term)
       numerical_differentiation_pointer = new NumericalDifferentiation(*other_performance_term.numerical_differentiation_pointer);
    }
 
+   batch_instances_number = other_performance_term.batch_instances_number;
+
+   thread_pool_pointer = other_performance_term.thread_pool_pointer;
+
+   deterministic_reduction = other_performance_term.deterministic_reduction;
+
    display = other_performance_term.display;  
 }
 
@@ -237,6 +245,9 @@ PerformanceTerm& PerformanceTerm::operator = (const PerformanceTerm& other_perfo
       data_set_pointer = other_performance_term.data_set_pointer;
       mathematical_model_pointer = other_performance_term.mathematical_model_pointer;
       numerical_differentiation_pointer = other_performance_term.numerical_differentiation_pointer;
+      batch_instances_number = other_performance_term.batch_instances_number;
+      thread_pool_pointer = other_performance_term.thread_pool_pointer;
+      deterministic_reduction = other_performance_term.deterministic_reduction;
       display = other_performance_term.display;
    }
 
@@ -258,6 +269,9 @@ bool PerformanceTerm::operator == (const PerformanceTerm& other_performance_term
    && *data_set_pointer == *other_performance_term.data_set_pointer
    && *mathematical_model_pointer == *other_performance_term.mathematical_model_pointer
 //   && *numerical_differentiation_pointer == *other_performance_term.numerical_differentiation_pointer
+   && batch_instances_number == other_performance_term.batch_instances_number
+   && count_threads_number() == other_performance_term.count_threads_number()
+   && deterministic_reduction == other_performance_term.deterministic_reduction
    && display == other_performance_term.display)
    {
       return(true);
@@ -271,6 +285,46 @@ bool PerformanceTerm::operator == (const PerformanceTerm& other_performance_term
 
 // METHODS
 
+// const unsigned int& get_batch_instances_number(void) const method
+
+/// This method returns the maximum number of training instances which are propagated together through the multilayer perceptron 
+/// when evaluating the performance term and its gradient. 
+
+const unsigned int& PerformanceTerm::get_batch_instances_number(void) const
+{
+   return(batch_instances_number);
+}
+
+
+// unsigned int count_threads_number(void) const method
+
+/// This method returns the number of threads which evaluate the performance term, its gradient, Jacobian and Hessian. 
+/// It is one if no thread pool has been constructed. 
+
+unsigned int PerformanceTerm::count_threads_number(void) const
+{
+   if(thread_pool_pointer)
+   {
+      return(thread_pool_pointer->count_threads_number());
+   }
+   else
+   {
+      return(1);
+   }
+}
+
+
+// const bool& get_deterministic_reduction(void) const method
+
+/// This method returns true if the contributions of the blocks of instances are always summed in the same order, 
+/// so that results do not depend on the number of threads, and false otherwise. 
+
+const bool& PerformanceTerm::get_deterministic_reduction(void) const
+{
+   return(deterministic_reduction);
+}
+
+
 // const bool& get_display(void) const method
 
 /// This method returns true if messages from this class can be displayed on the screen, or false if messages 
@@ -425,6 +479,12 @@ void PerformanceTerm::set(const PerformanceTerm& other_performance_term)
       numerical_differentiation_pointer = new NumericalDifferentiation(*other_performance_term.numerical_differentiation_pointer);
    }
 
+   batch_instances_number = other_performance_term.batch_instances_number;
+
+   thread_pool_pointer = other_performance_term.thread_pool_pointer;
+
+   deterministic_reduction = other_performance_term.deterministic_reduction;
+
    display = other_performance_term.display;  
 }
 
@@ -475,15 +535,90 @@ void PerformanceTerm::set_numerical_differentiation_pointer(NumericalDifferentia
 
 /// This method sets the members of the performance term to their default values:
 /// <ul>
+/// <li> Batch instances number: 256.
+/// <li> Deterministic reduction: false.
 /// <li> Display: true.
 /// </ul>
+/// The number of threads is not modified. 
 
 void PerformanceTerm::set_default(void)
 {
+   batch_instances_number = 256;
+
+   deterministic_reduction = false;
+
    display = true;
 }
 
 
+// void set_batch_instances_number(const unsigned int&) method
+
+/// This method sets the maximum number of training instances which are propagated together as a matrix. 
+/// Larger blocks make better use of the matrix product kernels, at the cost of more temporary memory. 
+/// @param new_batch_instances_number Number of instances per block. It must be greater than zero. 
+
+void PerformanceTerm::set_batch_instances_number(const unsigned int& new_batch_instances_number)
+{
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   if(new_batch_instances_number == 0)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: PerformanceTerm class.\n"
+             << "void set_batch_instances_number(const unsigned int&) method.\n"
+             << "Number of instances per batch must be greater than zero.\n";
+
+      throw std::logic_error(buffer.str());	  
+   }
+
+   #endif
+
+   batch_instances_number = new_batch_instances_number;
+}
+
+
+// void set_threads_number(const unsigned int&) method
+
+/// This method sets the number of threads which evaluate the performance term, its gradient, Jacobian and Hessian. 
+/// The training instances are split into blocks of batch_instances_number instances, which are processed concurrently. 
+/// @param new_threads_number Number of threads, including the calling one. 
+/// A value of one, or zero, deletes the thread pool, so that all the computations run on the calling thread. 
+
+void PerformanceTerm::set_threads_number(const unsigned int& new_threads_number)
+{
+   if(new_threads_number == count_threads_number())
+   {
+      return;
+   }
+
+   if(new_threads_number > 1)
+   {
+      thread_pool_pointer.reset(new ThreadPool(new_threads_number));
+   }
+   else
+   {
+      thread_pool_pointer.reset();
+   }
+}
+
+
+// void set_deterministic_reduction(const bool&) method
+
+/// This method sets whether the contributions of the blocks of instances are summed in a fixed order. 
+/// In that case the evaluation, gradient and Hessian are bitwise reproducible for any number of threads, 
+/// at the cost of a synchronization point every few blocks. 
+/// Otherwise each thread accumulates its own blocks, and the rounding errors depend on the scheduling. 
+/// @param new_deterministic_reduction True for a fixed summation order, false otherwise. 
+
+void PerformanceTerm::set_deterministic_reduction(const bool& new_deterministic_reduction)
+{
+   deterministic_reduction = new_deterministic_reduction;
+}
+
+
 // void set_display(const bool&) method
 
 /// This method sets a new display value. 
@@ -522,6 +657,176 @@ void PerformanceTerm::delete_numerical_differentiation_pointer(void)
 }
 
 
+// void run_instances_blocks(const unsigned int&, const BlockTask&) const method
+
+/// This method splits a number of instances into consecutive blocks of at most batch_instances_number instances, 
+/// and calls a function for each block, concurrently if a thread pool has been constructed. 
+/// The function must only write data which is private to its block, such as the rows of a Jacobian matrix. 
+/// @param instances_number Number of instances. 
+/// @param block_task Function taking the index of the first instance in the block and the number of instances in the block.
+
+void PerformanceTerm::run_instances_blocks(const unsigned int& instances_number, const BlockTask& block_task) const
+{
+   const unsigned int blocks_number = count_blocks_number(instances_number);
+
+   if(!thread_pool_pointer || blocks_number <= 1)
+   {
+      for(unsigned int i = 0; i < instances_number; i += batch_instances_number)
+      {
+         block_task(i, std::min(batch_instances_number, instances_number-i));
+      }
+
+      return;
+   }
+
+   thread_pool_pointer->run(blocks_number, [&](const unsigned int& block_index, const unsigned int&)
+   {
+      const unsigned int first_instance = block_index*batch_instances_number;
+
+      block_task(first_instance, std::min(batch_instances_number, instances_number-first_instance));
+   });
+}
+
+
+// unsigned int count_blocks_number(const unsigned int&) const method
+
+/// This method returns the number of blocks of batch_instances_number instances needed to cover a number of instances. 
+/// @param instances_number Number of instances. 
+
+unsigned int PerformanceTerm::count_blocks_number(const unsigned int& instances_number) const
+{
+   return((instances_number + batch_instances_number - 1)/batch_instances_number);
+}
+
+
+// BlockWorkspace& get_block_workspace(const unsigned int&) const method
+
+/// This method returns the workspace which the calling thread uses to evaluate a block of instances. 
+/// The workspaces belong to the thread, not to the performance term, so that concurrent evaluations of the same term 
+/// never share them. A thread evaluates one block at a time, so all the terms it evaluates can use the same ones. 
+/// Full blocks and the last, smaller block use different workspaces, so that neither of them is resized in every evaluation. 
+/// @param block_instances_number Number of instances in the block. 
+
+PerformanceTerm::BlockWorkspace& PerformanceTerm::get_block_workspace(const unsigned int& block_instances_number) const
+{
+   static thread_local BlockWorkspace full_block_workspace;
+   static thread_local BlockWorkspace last_block_workspace;
+
+   return(block_instances_number == batch_instances_number ? full_block_workspace : last_block_workspace);
+}
+
+
+// double calculate_block_sum_squared_error(const unsigned int&, const unsigned int&, BlockWorkspace&) const method
+
+/// This method returns the sum squared error of the multilayer perceptron over a block of consecutive training instances. 
+/// The inputs, targets and layers activations of the block are written into a workspace. 
+/// @param first_instance Index of the first training instance in the block. 
+/// @param block_instances_number Number of training instances in the block. 
+/// @param workspace Workspace of the thread which evaluates the block. 
+
+double PerformanceTerm::calculate_block_sum_squared_error
+(const unsigned int& first_instance, const unsigned int& block_instances_number, BlockWorkspace& workspace) const
+{
+   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
+
+   const unsigned int layers_number = multilayer_perceptron_pointer->count_layers_number();
+
+   data_set_pointer->arrange_training_input_data(first_instance, block_instances_number, workspace.inputs);
+   data_set_pointer->arrange_training_target_data(first_instance, block_instances_number, workspace.targets);
+
+   multilayer_perceptron_pointer->calculate_layers_activation(workspace.inputs, workspace.layers_activation);
+
+   return(workspace.layers_activation[layers_number-1].calculate_sum_squared_error(workspace.targets));
+}
+
+
+// void calculate_block_squared_errors(const unsigned int&, const unsigned int&, BlockWorkspace&, Vector<double>&) const method
+
+/// This method writes the squared error of each training instance in a block of consecutive training instances. 
+/// The outputs and the targets are read through row pointers into the workspace, so that no row is copied. 
+/// @param first_instance Index of the first training instance in the block. 
+/// @param block_instances_number Number of training instances in the block. 
+/// @param workspace Workspace of the thread which evaluates the block. 
+/// @param squared_errors Vector of the squared errors of all the training instances, whose elements of the block are set. 
+
+void PerformanceTerm::calculate_block_squared_errors
+(const unsigned int& first_instance, const unsigned int& block_instances_number, BlockWorkspace& workspace, Vector<double>& squared_errors) const
+{
+   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
+
+   const unsigned int layers_number = multilayer_perceptron_pointer->count_layers_number();
+
+   data_set_pointer->arrange_training_input_data(first_instance, block_instances_number, workspace.inputs);
+   data_set_pointer->arrange_training_target_data(first_instance, block_instances_number, workspace.targets);
+
+   multilayer_perceptron_pointer->calculate_layers_activation(workspace.inputs, workspace.layers_activation);
+
+   const Matrix<double>& outputs = workspace.layers_activation[layers_number-1];
+
+   const unsigned int outputs_number = outputs.get_columns_number();
+
+   for(unsigned int i = 0; i < block_instances_number; i++)
+   {
+      const double* output = outputs[i];
+      const double* target = workspace.targets[i];
+
+      double squared_error = 0.0;
+
+      for(unsigned int j = 0; j < outputs_number; j++)
+      {
+         squared_error += (output[j] - target[j])*(output[j] - target[j]);
+      }
+
+      squared_errors[first_instance+i] = squared_error;
+   }
+}
+
+
+// void add_block_squared_errors_gradient(const unsigned int&, const unsigned int&, const double&, BlockWorkspace&, Vector<double>&) const method
+
+/// This method adds to a vector the gradient of the sum squared error over a block of consecutive training instances, 
+/// multiplied by a factor. 
+/// The block is back-propagated through the multilayer perceptron as matrices stored in a workspace, 
+/// so that it does not allocate memory once the workspace has grown to the size of the block. 
+/// @param first_instance Index of the first training instance in the block. 
+/// @param block_instances_number Number of training instances in the block. 
+/// @param factor Factor which multiplies the squared errors, such as the inverse of the number of instances for the mean squared error. 
+/// @param workspace Workspace of the thread which evaluates the block. 
+/// @param gradient Vector to which the gradient of the block is added. 
+
+void PerformanceTerm::add_block_squared_errors_gradient
+(const unsigned int& first_instance, const unsigned int& block_instances_number, const double& factor, BlockWorkspace& workspace, Vector<double>& gradient) const
+{
+   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
+
+   const unsigned int layers_number = multilayer_perceptron_pointer->count_layers_number();
+   const unsigned int outputs_number = multilayer_perceptron_pointer->count_outputs_number();
+
+   data_set_pointer->arrange_training_input_data(first_instance, block_instances_number, workspace.inputs);
+   data_set_pointer->arrange_training_target_data(first_instance, block_instances_number, workspace.targets);
+
+   multilayer_perceptron_pointer->calculate_first_order_forward_propagation(workspace.inputs, workspace.layers_activation, workspace.layers_activation_derivative);
+
+   // Output objective gradient
+
+   const Matrix<double>& outputs = workspace.layers_activation[layers_number-1];
+
+   workspace.output_objective_gradient.set(block_instances_number, outputs_number);
+
+   for(unsigned int i = 0; i < block_instances_number; i++)
+   {
+      for(unsigned int j = 0; j < outputs_number; j++)
+      {
+         workspace.output_objective_gradient[i][j] = 2.0*factor*(outputs[i][j] - workspace.targets[i][j]);
+      }
+   }
+
+   calculate_layers_delta(workspace.layers_activation_derivative, workspace.output_objective_gradient, workspace.layers_delta);
+
+   add_batch_gradient(workspace.inputs, workspace.layers_activation, workspace.layers_delta, gradient);
+}
+
+
 // void check(void) const method
 
 /// This method checks that there is a neural network associated to the performance term.
@@ -738,6 +1043,299 @@ Vector< Vector<double> > PerformanceTerm::calculate_layers_delta
 }
 
 
+// Vector< Matrix<double> > calculate_layers_delta(const Vector< Matrix<double> >&, const Matrix<double>&) method
+
+/// This method returns the delta matrices for all the layers in the multilayer perceptron, for a block of instances. 
+/// Each matrix has one row per instance and one column per neuron in the layer. 
+/// @param layers_activation_derivative Forward propagation activation derivative of a block of instances. 
+/// @param output_objective_gradient Gradient of the outputs objective function, with one row per instance. 
+
+Vector< Matrix<double> > PerformanceTerm::calculate_layers_delta
+(const Vector< Matrix<double> >& layers_activation_derivative, 
+ const Matrix<double>& output_objective_gradient) const
+{
+   Vector< Matrix<double> > layers_delta;
+
+   calculate_layers_delta(layers_activation_derivative, output_objective_gradient, layers_delta);
+
+   return(layers_delta);
+}
+
+
+// void calculate_layers_delta(const Vector< Matrix<double> >&, const Matrix<double>&, Vector< Matrix<double> >&) const method
+
+/// This method writes the delta matrices for all the layers in the multilayer perceptron, for a block of instances, into a given vector. 
+/// The storage of the matrices is reused if they already have the right sizes. 
+/// The deltas are back-propagated with one matrix product per layer, 
+/// the product of the next layer deltas with the synaptic weights of the next layer. 
+/// @param layers_activation_derivative Forward propagation activation derivative of a block of instances. 
+/// @param output_objective_gradient Gradient of the outputs objective function, with one row per instance. 
+/// @param layers_delta Vector to be set to the delta matrix of each layer. 
+
+void PerformanceTerm::calculate_layers_delta
+(const Vector< Matrix<double> >& layers_activation_derivative, 
+ const Matrix<double>& output_objective_gradient, 
+ Vector< Matrix<double> >& layers_delta) const
+{
+   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
+
+   const unsigned int layers_number = multilayer_perceptron_pointer->count_layers_number();
+
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   const unsigned int layers_activation_derivative_size = layers_activation_derivative.size();
+
+   if(layers_activation_derivative_size != layers_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: PerformanceTerm class.\n"
+             << "void calculate_layers_delta(const Vector< Matrix<double> >&, const Matrix<double>&, Vector< Matrix<double> >&) const method.\n"
+             << "Size of forward propagation activation derivative vector must be equal to number of layers.\n";
+
+      throw std::logic_error(buffer.str().c_str());	  
+   }
+
+   #endif
+
+   layers_delta.set(layers_number);
+
+   if(layers_number == 0)
+   {
+      return;
+   }
+
+   const unsigned int instances_number = output_objective_gradient.get_rows_number();
+
+   // Output layer
+
+   const unsigned int outputs_number = output_objective_gradient.get_columns_number();
+
+   layers_delta[layers_number-1].set(instances_number, outputs_number);
+
+   for(unsigned int k = 0; k < instances_number; k++)
+   {
+      for(unsigned int j = 0; j < outputs_number; j++)
+      {
+         layers_delta[layers_number-1][k][j] = layers_activation_derivative[layers_number-1][k][j]*output_objective_gradient[k][j];
+      }
+   }
+
+   // Rest of hidden layers
+
+   // Synaptic weights of the next layer, with one row per perceptron of that layer. 
+   // The buffer is kept by each thread and only grows, so that layers of any size reuse it.
+
+   static thread_local std::vector<double> next_synaptic_weights;
+
+   for(int i = layers_number-2; i >= 0; i--) 
+   {   
+      const PerceptronLayer& next_layer = multilayer_perceptron_pointer->get_layer(i+1);
+
+      const unsigned int next_perceptrons_number = next_layer.count_perceptrons_number();
+      const unsigned int perceptrons_number = layers_activation_derivative[i].get_columns_number();
+
+      Matrix<double>& layer_delta = layers_delta[i];
+
+      layer_delta.set(instances_number, perceptrons_number);
+
+      if(instances_number == 0 || perceptrons_number == 0)
+      {
+         continue;
+      }
+
+      if(next_synaptic_weights.size() < next_perceptrons_number*perceptrons_number)
+      {
+         next_synaptic_weights.resize(next_perceptrons_number*perceptrons_number);
+      }
+
+      for(unsigned int p = 0; p < next_perceptrons_number; p++)
+      {
+         const Vector<double>& synaptic_weights = next_layer.get_perceptron(p).arrange_synaptic_weights();
+
+         std::copy(synaptic_weights.begin(), synaptic_weights.end(), next_synaptic_weights.begin() + p*perceptrons_number);
+      }
+
+      MatrixKernels::gemm(instances_number, perceptrons_number, next_perceptrons_number,
+                          layers_delta[i+1][0], next_perceptrons_number,
+                          &next_synaptic_weights[0], perceptrons_number,
+                          layer_delta[0], perceptrons_number);
+
+      for(unsigned int k = 0; k < instances_number; k++)
+      {
+         double* layer_delta_row = layer_delta[k];
+         const double* activation_derivative_row = layers_activation_derivative[i][k];
+
+         for(unsigned int j = 0; j < perceptrons_number; j++)
+         {
+            layer_delta_row[j] *= activation_derivative_row[j];
+         }
+      }
+   }
+}
+
+
+// Vector<double> calculate_batch_gradient(const Matrix<double>&, const Vector< Matrix<double> >&, const Vector< Matrix<double> >&) const method
+
+/// This method returns the sum of the performance term gradients over a block of instances. 
+/// The layout of the returned vector is the same as that of the multilayer perceptron parameters. 
+/// For each layer, the synaptic weights gradient is the product of the transposed delta matrix with the layer inputs matrix, 
+/// and the biases gradient is the sum of the delta matrix rows. 
+/// @param inputs Inputs to the multilayer perceptron, with one instance per row. 
+/// @param layers_activation Activations of all layers for that block of instances. 
+/// @param layers_delta Deltas of all layers for that block of instances. 
+
+Vector<double> PerformanceTerm::calculate_batch_gradient
+(const Matrix<double>& inputs, 
+ const Vector< Matrix<double> >& layers_activation, 
+ const Vector< Matrix<double> >& layers_delta) const
+{
+   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
+
+   const unsigned int parameters_number = multilayer_perceptron_pointer->count_parameters_number();
+
+   Vector<double> batch_gradient(parameters_number, 0.0);
+
+   add_batch_gradient(inputs, layers_activation, layers_delta, batch_gradient);
+
+   return(batch_gradient);
+}
+
+
+// void add_batch_gradient(const Matrix<double>&, const Vector< Matrix<double> >&, const Vector< Matrix<double> >&, Vector<double>&) const method
+
+/// This method adds the sum of the performance term gradients over a block of instances to a given vector. 
+/// The layout of that vector is the same as that of the multilayer perceptron parameters. 
+/// For each layer, the synaptic weights gradient is the product of the transposed delta matrix with the layer inputs matrix, 
+/// and the biases gradient is the sum of the delta matrix rows. 
+/// @param inputs Inputs to the multilayer perceptron, with one instance per row. 
+/// @param layers_activation Activations of all layers for that block of instances. 
+/// @param layers_delta Deltas of all layers for that block of instances. 
+/// @param gradient Vector to which the gradient of the block is added. 
+
+void PerformanceTerm::add_batch_gradient
+(const Matrix<double>& inputs, 
+ const Vector< Matrix<double> >& layers_activation, 
+ const Vector< Matrix<double> >& layers_delta, 
+ Vector<double>& gradient) const
+{
+   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
+
+   const unsigned int layers_number = multilayer_perceptron_pointer->count_layers_number();
+
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   const unsigned int layers_delta_size = layers_delta.size();
+
+   if(layers_delta_size != layers_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: PerformanceTerm class.\n"
+             << "void add_batch_gradient(const Matrix<double>&, const Vector< Matrix<double> >&, const Vector< Matrix<double> >&, Vector<double>&) const method.\n"
+             << "Size of layers delta ("<< layers_delta_size << ") must be equal to number of layers (" << layers_number << ").\n";
+
+      throw std::logic_error(buffer.str().c_str());	  
+   }
+
+   const unsigned int gradient_size = gradient.size();
+
+   const unsigned int parameters_number = multilayer_perceptron_pointer->count_parameters_number();
+
+   if(gradient_size != parameters_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: PerformanceTerm class.\n"
+             << "void add_batch_gradient(const Matrix<double>&, const Vector< Matrix<double> >&, const Vector< Matrix<double> >&, Vector<double>&) const method.\n"
+             << "Size of gradient ("<< gradient_size << ") must be equal to number of parameters (" << parameters_number << ").\n";
+
+      throw std::logic_error(buffer.str().c_str());	  
+   }
+
+   #endif
+
+   const unsigned int instances_number = inputs.get_rows_number();
+
+   if(instances_number == 0)
+   {
+      return;
+   }
+
+   // Transposed deltas of a layer, and their product with the layer inputs. 
+   // The buffers are kept by each thread and only grow, so that layers of any size reuse them.
+
+   static thread_local std::vector<double> delta_transpose;
+   static thread_local std::vector<double> synaptic_weights_gradient;
+
+   double* layer_gradient = gradient.data();
+
+   for(unsigned int h = 0; h < layers_number; h++)
+   {
+      const Matrix<double>& layer_inputs = (h == 0) ? inputs : layers_activation[h-1];
+
+      const unsigned int perceptrons_number = layers_delta[h].get_columns_number();
+      const unsigned int layer_inputs_number = layer_inputs.get_columns_number();
+
+      if(delta_transpose.size() < perceptrons_number*instances_number)
+      {
+         delta_transpose.resize(perceptrons_number*instances_number);
+      }
+
+      if(synaptic_weights_gradient.size() < perceptrons_number*layer_inputs_number)
+      {
+         synaptic_weights_gradient.resize(perceptrons_number*layer_inputs_number);
+      }
+
+      for(unsigned int k = 0; k < instances_number; k++)
+      {
+         const double* delta_row = layers_delta[h][k];
+
+         for(unsigned int i = 0; i < perceptrons_number; i++)
+         {
+            delta_transpose[i*instances_number + k] = delta_row[i];
+         }
+      }
+
+      if(perceptrons_number > 0 && layer_inputs_number > 0)
+      {
+         MatrixKernels::gemm(perceptrons_number, layer_inputs_number, instances_number,
+                             &delta_transpose[0], instances_number,
+                             layer_inputs[0], layer_inputs_number,
+                             &synaptic_weights_gradient[0], layer_inputs_number);
+      }
+
+      // Each perceptron has its bias followed by its synaptic weights
+
+      for(unsigned int i = 0; i < perceptrons_number; i++)
+      {
+         const double* perceptron_delta = &delta_transpose[i*instances_number];
+         const double* perceptron_synaptic_weights_gradient = &synaptic_weights_gradient[i*layer_inputs_number];
+
+         double bias_gradient = 0.0;
+
+         for(unsigned int k = 0; k < instances_number; k++)
+         {
+            bias_gradient += perceptron_delta[k];
+         }
+
+         layer_gradient[0] += bias_gradient;
+
+         for(unsigned int j = 0; j < layer_inputs_number; j++)
+         {
+            layer_gradient[1+j] += perceptron_synaptic_weights_gradient[j];
+         }
+
+         layer_gradient += 1 + layer_inputs_number;
+      }
+   }
+}
+
+
 // Vector<double> calculate_point_gradient(const Vector<double>&, const Vector< Vector<double> >&, const Vector<double>&) const method
 
 /// This method returns the gradient of the performance term function at some input point. 
@@ -1087,7 +1685,7 @@ Matrix< Matrix<double> > PerformanceTerm::calculate_interlayers_Delta
    {
       for(unsigned int j = 0; j < layers_number; j++)
       {
-         interlayers_Delta[i][j].set(layers_size[i], layers_size[j]);
+         interlayers_Delta[i][j].set(layers_size[i], layers_size[j], 0.0);
       }
    }
 
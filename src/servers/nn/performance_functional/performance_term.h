@@ -19,12 +19,17 @@
 // System includes
 
 #include <string>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
 
 // OpenNN includes
 
 #include "../utilities/vector.h"
 #include "../utilities/matrix.h"
 #include "../utilities/numerical_differentiation.h"
+#include "../utilities/thread_pool.h"
 
 #include "../data_set/data_set.h"
 #include "../mathematical_model/mathematical_model.h"
@@ -191,6 +196,11 @@ public:
       return(numerical_differentiation_pointer);
    }
 
+   const unsigned int& get_batch_instances_number(void) const;
+
+   unsigned int count_threads_number(void) const;
+   const bool& get_deterministic_reduction(void) const;
+
    const bool& get_display(void) const;
 
    // Set methods
@@ -213,6 +223,11 @@ public:
 
    virtual void set_default(void);
 
+   void set_batch_instances_number(const unsigned int&);
+
+   void set_threads_number(const unsigned int&);
+   void set_deterministic_reduction(const bool&);
+
    void set_display(const bool&);
 
    // Pointer methods
@@ -229,6 +244,9 @@ public:
    Vector< Vector<double> > calculate_layers_delta(const Vector< Vector<double> >&, const Vector<double>&) const;
    Vector< Vector<double> > calculate_layers_delta(const Vector< Vector<double> >&, const Vector<double>&, const Vector<double>&) const;
 
+   Vector< Matrix<double> > calculate_layers_delta(const Vector< Matrix<double> >&, const Matrix<double>&) const;
+   void calculate_layers_delta(const Vector< Matrix<double> >&, const Matrix<double>&, Vector< Matrix<double> >&) const;
+
    // Interlayers Delta methods
 
    Matrix< Matrix <double> > calculate_interlayers_Delta(const Vector< Vector<double> >&, const Vector< Vector<double> >&, const Matrix< Matrix<double> >&, const Vector<double>&, const Matrix<double>&, const Vector< Vector<double> >&) const;
@@ -238,6 +256,9 @@ public:
    Vector<double> calculate_point_gradient(const Vector<double>&, const Vector< Vector<double> >&, const Vector< Vector<double> >&) const;
    Vector<double> calculate_point_gradient(const Vector< Matrix<double> >&, const Vector< Vector<double> >&) const;
 
+   Vector<double> calculate_batch_gradient(const Matrix<double>&, const Vector< Matrix<double> >&, const Vector< Matrix<double> >&) const;
+   void add_batch_gradient(const Matrix<double>&, const Vector< Matrix<double> >&, const Vector< Matrix<double> >&, Vector<double>&) const;
+
    Matrix<double> calculate_point_Hessian(const Vector< Vector<double> >&, const Vector< Vector< Vector<double> > >&, const Matrix< Matrix<double> >&, const Vector< Vector<double> >&, const Matrix< Matrix<double> >&) const;
 
    // Objective methods
@@ -290,6 +311,162 @@ public:
 
 protected:
 
+   /// This structure holds the matrices used to evaluate a block of instances. 
+   /// Each thread keeps its own workspaces between evaluations, so that blocks of the same size do not allocate memory. 
+
+   struct BlockWorkspace
+   {
+      /// Inputs of the block, with one instance per row.
+
+      Matrix<double> inputs;
+
+      /// Targets of the block, with one instance per row.
+
+      Matrix<double> targets;
+
+      /// Activations of all layers of the multilayer perceptron.
+
+      Vector< Matrix<double> > layers_activation;
+
+      /// Activation derivatives of all layers of the multilayer perceptron.
+
+      Vector< Matrix<double> > layers_activation_derivative;
+
+      /// Gradient of the outputs objective function, with one instance per row.
+
+      Matrix<double> output_objective_gradient;
+
+      /// Deltas of all layers of the multilayer perceptron.
+
+      Vector< Matrix<double> > layers_delta;
+   };
+
+   /// Signature of the functions which process a block of instances. 
+   /// The arguments are the index of the first instance in the block and the number of instances in the block. 
+
+   typedef std::function<void (const unsigned int&, const unsigned int&)> BlockTask;
+
+   // Parallel reduction methods
+
+   void run_instances_blocks(const unsigned int&, const BlockTask&) const;
+
+   unsigned int count_blocks_number(const unsigned int&) const;
+
+   BlockWorkspace& get_block_workspace(const unsigned int&) const;
+
+   // Block methods
+
+   double calculate_block_sum_squared_error(const unsigned int&, const unsigned int&, BlockWorkspace&) const;
+
+   void calculate_block_squared_errors(const unsigned int&, const unsigned int&, BlockWorkspace&, Vector<double>&) const;
+
+   void add_block_squared_errors_gradient(const unsigned int&, const unsigned int&, const double&, BlockWorkspace&, Vector<double>&) const;
+
+   // Type calculate_instances_sum(const unsigned int&, const Type&, const std::function<Type (const unsigned int&, const unsigned int&)>&) const method
+
+   /// This method returns the sum of a quantity over a number of instances, which are split into consecutive blocks 
+   /// of at most batch_instances_number instances. 
+   /// The blocks are evaluated concurrently if a thread pool has been constructed. 
+   /// If the deterministic reduction flag is set, the block results are added in block order, 
+   /// so that the result is the same for any number of threads; 
+   /// otherwise each thread accumulates the blocks it evaluates and the thread results are added at the end. 
+   /// @param instances_number Number of instances. 
+   /// @param zero Neutral element of the sum, with the size of the result. 
+   /// @param calculate_block_sum Function returning the sum over the block starting at its first argument 
+   /// and containing the number of instances given by its second argument.
+
+   template<class Type>
+   Type calculate_instances_sum(const unsigned int& instances_number, const Type& zero,
+                                const std::function<Type (const unsigned int&, const unsigned int&)>& calculate_block_sum) const
+   {
+      Type sum(zero);
+
+      calculate_instances_sum<Type>(instances_number, zero, sum, 
+      [&](const unsigned int& first_instance, const unsigned int& block_instances_number, BlockWorkspace&, Type& block_sum)
+      {
+         block_sum += calculate_block_sum(first_instance, block_instances_number);
+      });
+
+      return(sum);
+   }
+
+   // void calculate_instances_sum(const unsigned int&, const Type&, Type&, const std::function<void (const unsigned int&, const unsigned int&, BlockWorkspace&, Type&)>&) const method
+
+   /// This method writes the sum of a quantity over a number of instances into a given variable, 
+   /// letting each block add its contribution in place instead of returning it. 
+   /// Each block is also given the workspace of the thread which evaluates it, 
+   /// so that the evaluation of the blocks does not allocate memory once the workspaces have grown to their sizes. 
+   /// The blocks and their reduction are organized as in the method above. 
+   /// @param instances_number Number of instances. 
+   /// @param zero Neutral element of the sum, with the size of the result. 
+   /// @param sum Variable to be set to the sum. 
+   /// @param add_block_sum Function adding to its last argument the sum over the block starting at its first argument 
+   /// and containing the number of instances given by its second argument.
+
+   template<class Type>
+   void calculate_instances_sum(const unsigned int& instances_number, const Type& zero, Type& sum,
+                                const std::function<void (const unsigned int&, const unsigned int&, BlockWorkspace&, Type&)>& add_block_sum) const
+   {
+      const unsigned int blocks_number = count_blocks_number(instances_number);
+
+      sum = zero;
+
+      if(!thread_pool_pointer || blocks_number <= 1)
+      {
+         for(unsigned int i = 0; i < instances_number; i += batch_instances_number)
+         {
+            const unsigned int block_instances_number = std::min(batch_instances_number, instances_number-i);
+
+            add_block_sum(i, block_instances_number, get_block_workspace(block_instances_number), sum);
+         }
+      }
+      else if(deterministic_reduction)
+      {
+         // Evaluate a few blocks per thread at a time, and add them in block order
+
+         const unsigned int round_blocks_number = 2*thread_pool_pointer->count_threads_number();
+
+         std::vector<Type> blocks_sum(round_blocks_number, zero);
+
+         for(unsigned int first_block = 0; first_block < blocks_number; first_block += round_blocks_number)
+         {
+            const unsigned int current_blocks_number = std::min(round_blocks_number, blocks_number-first_block);
+
+            thread_pool_pointer->run(current_blocks_number, [&](const unsigned int& task_index, const unsigned int& thread_index)
+            {
+               const unsigned int first_instance = (first_block+task_index)*batch_instances_number;
+               const unsigned int block_instances_number = std::min(batch_instances_number, instances_number-first_instance);
+
+               blocks_sum[task_index] = zero;
+
+               add_block_sum(first_instance, block_instances_number, get_block_workspace(block_instances_number), blocks_sum[task_index]);
+            });
+
+            for(unsigned int i = 0; i < current_blocks_number; i++)
+            {
+               sum += blocks_sum[i];
+            }
+         }
+      }
+      else
+      {
+         std::vector<Type> threads_sum(thread_pool_pointer->count_threads_number(), zero);
+
+         thread_pool_pointer->run(blocks_number, [&](const unsigned int& block_index, const unsigned int& thread_index)
+         {
+            const unsigned int first_instance = block_index*batch_instances_number;
+            const unsigned int block_instances_number = std::min(batch_instances_number, instances_number-first_instance);
+
+            add_block_sum(first_instance, block_instances_number, get_block_workspace(block_instances_number), threads_sum[thread_index]);
+         });
+
+         for(unsigned int i = 0; i < threads_sum.size(); i++)
+         {
+            sum += threads_sum[i];
+         }
+      }
+   }
+
    /// Pointer to a multilayer perceptron object.
 
    NeuralNetwork* neural_network_pointer;
@@ -306,6 +483,20 @@ protected:
 
    NumericalDifferentiation* numerical_differentiation_pointer;
 
+   /// Maximum number of training instances which are propagated together as a single matrix. 
+
+   unsigned int batch_instances_number;
+
+   /// Pool of threads which evaluate blocks of instances concurrently. 
+   /// It is shared with the copies of this performance term, so that evaluating a copy does not start new threads. 
+   /// It is empty when the performance term is evaluated on the calling thread only.
+
+   std::shared_ptr<ThreadPool> thread_pool_pointer;
+
+   /// True if the contributions of the blocks of instances are added in a fixed order, false otherwise. 
+
+   bool deterministic_reduction;
+
    /// Display messages to screen. 
 
    bool display;  
@@ -232,30 +232,36 @@ double RootMeanSquaredError::calculate_evaluation(void) const
 
    // Root mean squared error
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> outputs(outputs_number);
-   Vector<double> targets(outputs_number);
+   const double sum_squared_error = calculate_instances_sum<double>(training_instances_number, 0.0, 
+   [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
+   {
+      Vector<double> inputs(inputs_number);
+      Vector<double> outputs(outputs_number);
+      Vector<double> targets(outputs_number);
 
-   double sum_squared_error = 0.0;
+      double block_sum_squared_error = 0.0;
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
-   {
-      // Input vector
+      for(unsigned int i = first_instance; i < first_instance+block_instances_number; i++)
+      {
+         // Input vector
 
-	  inputs = data_set_pointer->get_training_input_instance(i);
+	     inputs = data_set_pointer->get_training_input_instance(i);
 
-      // Output vector
+         // Output vector
 
-      outputs = multilayer_perceptron_pointer->calculate_outputs(inputs);
+         outputs = multilayer_perceptron_pointer->calculate_outputs(inputs);
 
-      // Target vector
+         // Target vector
 
-      targets = data_set_pointer->get_training_target_instance(i);
+         targets = data_set_pointer->get_training_target_instance(i);
 
-      // Sum squaresd error
+         // Sum squaresd error
 
-	  sum_squared_error += outputs.calculate_sum_squared_error(targets);           
-   }
+	     block_sum_squared_error += outputs.calculate_sum_squared_error(targets);
+      }
+
+      return(block_sum_squared_error);
+   });
 
    return(sqrt(sum_squared_error/(double)training_instances_number));
 }
@@ -336,68 +342,76 @@ Vector<double> RootMeanSquaredError::calculate_gradient(void) const
 
    // Data set stuff
 
-   Vector< Vector< Vector<double> > > first_order_forward_propagation(2); 
-
    const bool& conditions_layer_flag = neural_network_pointer->get_conditions_layer_flag();
 
    const ConditionsLayer* conditions_layer_pointer = neural_network_pointer->get_conditions_layer_pointer();
 
-   Vector<double> particular_solution;
-   Vector<double> homogeneous_solution;
-
    // Data set stuff
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
 
    const unsigned int training_instances_number = instances_information.count_training_instances_number();
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> targets(outputs_number);
-
    // Performance functional stuff
 
-   double objective = calculate_evaluation();
-
-   Vector< Vector<double> > layers_delta; 
-
-   Vector<double> output_objective_gradient(outputs_number);
-
-   Vector<double> point_gradient(parameters_number, 0.0);
+   const double objective = calculate_evaluation();
 
    Vector<double> objective_gradient(parameters_number, 0.0);
 
    // Main loop
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   objective_gradient = calculate_instances_sum< Vector<double> >(training_instances_number, objective_gradient, 
+   [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
    {
-      inputs = data_set_pointer->get_training_input_instance(i);
+      Vector< Vector< Vector<double> > > first_order_forward_propagation(2);
 
-      targets = data_set_pointer->get_training_target_instance(i);
+      Vector<double> particular_solution;
+      Vector<double> homogeneous_solution;
 
-      first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
+      Vector<double> inputs(inputs_number);
+      Vector<double> targets(outputs_number);
 
-	  const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
-      const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+      Vector< Vector<double> > layers_delta;
 
-      if(!conditions_layer_flag)
-      {
-         output_objective_gradient = (layers_activation[layers_number-1]-targets)/(training_instances_number*objective);
+      Vector<double> output_objective_gradient(outputs_number);
 
-         layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
-      }
-      else
+      Vector<double> point_gradient(parameters_number, 0.0);
+
+      Vector<double> block_gradient(parameters_number, 0.0);
+
+      for(unsigned int i = first_instance; i < first_instance+block_instances_number; i++)
       {
-         particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
-         homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
+         inputs = data_set_pointer->get_training_input_instance(i);
+
+         targets = data_set_pointer->get_training_target_instance(i);
+
+         first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
+
+	     const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
+         const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
 
-         output_objective_gradient = (particular_solution+homogeneous_solution*layers_activation[layers_number-1] - targets)/(training_instances_number*objective);              
+         if(!conditions_layer_flag)
+         {
+            output_objective_gradient = (layers_activation[layers_number-1]-targets)/(training_instances_number*objective);
 
-		 layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
+            layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
+         }
+         else
+         {
+            particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
+            homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
+
+            output_objective_gradient = (particular_solution+homogeneous_solution*layers_activation[layers_number-1] - targets)/(training_instances_number*objective);              
+
+		    layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
+         }
+
+         point_gradient = calculate_point_gradient(inputs, layers_activation, layers_delta);
+         block_gradient += point_gradient;
       }
 
-      point_gradient = calculate_point_gradient(inputs, layers_activation, layers_delta);
-      objective_gradient += point_gradient;
-   }
+      return(block_gradient);
+   });
 
    return(objective_gradient);
 }
@@ -15,6 +15,7 @@
 
 // System includes
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <cmath>
@@ -209,13 +210,6 @@ double SumSquaredError::calculate_evaluation(void) const
 
    #endif
 
-   // Neural network stuff
-
-   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
-
-   const unsigned int inputs_number = multilayer_perceptron_pointer->count_inputs_number();
-   const unsigned int outputs_number = multilayer_perceptron_pointer->count_outputs_number();
-
    // Data set stuff
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
@@ -224,30 +218,13 @@ double SumSquaredError::calculate_evaluation(void) const
 
    // Sum squared error stuff
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> outputs(outputs_number);
-   Vector<double> targets(outputs_number);
-
    double sum_squared_error = 0.0;
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   calculate_instances_sum<double>(training_instances_number, 0.0, sum_squared_error, 
+   [&](const unsigned int& first_instance, const unsigned int& block_instances_number, BlockWorkspace& workspace, double& block_sum_squared_error)
    {
-      // Input vector
-
-	  inputs = data_set_pointer->get_training_input_instance(i);
-
-      // Output vector
-
-      outputs = multilayer_perceptron_pointer->calculate_outputs(inputs);
-
-      // Target vector
-
-      targets = data_set_pointer->get_training_target_instance(i);
-
-      // Sum squared error
-
-	  sum_squared_error += outputs.calculate_sum_squared_error(targets);
-   }
+      block_sum_squared_error += calculate_block_sum_squared_error(first_instance, block_instances_number, workspace);
+   });
 
    return(sum_squared_error);
 }
@@ -386,76 +363,85 @@ Vector<double> SumSquaredError::calculate_gradient(void) const
 
    const unsigned int network_parameters_number = multilayer_perceptron_pointer->count_parameters_number();
 
-   Vector< Vector< Vector<double> > > first_order_forward_propagation(2); 
-
    const bool& conditions_layer_flag = neural_network_pointer->get_conditions_layer_flag();
 
-   Vector<double> particular_solution;
-   Vector<double> homogeneous_solution;
-
    // Data set stuff
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
 
-   unsigned int training_instances_number = instances_information.count_training_instances_number();
-
-   Vector<double> inputs(inputs_number);
-   Vector<double> targets(outputs_number);
+   const unsigned int training_instances_number = instances_information.count_training_instances_number();
 
    // Sum squared error stuff
 
-   Vector<double> output_objective_gradient(outputs_number);
+   Vector<double> objective_gradient(network_parameters_number, 0.0);
 
-   Vector< Matrix<double> > layers_combination_parameters_Jacobian; 
+   if(!conditions_layer_flag)
+   {
+      // Propagate blocks of training instances as matrices
 
-   Vector< Vector<double> > layers_inputs(layers_number); 
-   Vector< Vector<double> > layers_delta; 
+      const Vector<double> zero(network_parameters_number, 0.0);
 
-   Vector<double> point_gradient(network_parameters_number, 0.0);
+      calculate_instances_sum< Vector<double> >(training_instances_number, zero, objective_gradient, 
+      [&](const unsigned int& first_instance, const unsigned int& block_instances_number, BlockWorkspace& workspace, Vector<double>& block_gradient)
+      {
+         add_block_squared_errors_gradient(first_instance, block_instances_number, 1.0, workspace, block_gradient);
+      });
 
-   Vector<double> objective_gradient(network_parameters_number, 0.0);
+      return(objective_gradient);
+   }
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   objective_gradient = calculate_instances_sum< Vector<double> >(training_instances_number, objective_gradient, 
+   [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
    {
-      inputs = data_set_pointer->get_training_input_instance(i);
+      Vector<double> inputs(inputs_number);
+      Vector<double> targets(outputs_number);
 
-      targets = data_set_pointer->get_training_target_instance(i);
+      Vector< Vector< Vector<double> > > first_order_forward_propagation(2); 
 
-      first_order_forward_propagation = neural_network_pointer->get_multilayer_perceptron_pointer()->calculate_first_order_forward_propagation(inputs);
+      Vector<double> particular_solution;
+      Vector<double> homogeneous_solution;
 
-      const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
-      const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+      Vector<double> output_objective_gradient(outputs_number);
 
-	  layers_inputs[0] = inputs;
+      Vector< Matrix<double> > layers_combination_parameters_Jacobian; 
 
-	  for(unsigned int j = 1; j < layers_number; j++)
-	  {
-	     layers_inputs[j] = layers_activation[j-1];
-	  }
+      Vector< Vector<double> > layers_inputs(layers_number); 
+      Vector< Vector<double> > layers_delta; 
 
-	  layers_combination_parameters_Jacobian = neural_network_pointer->get_multilayer_perceptron_pointer()->calculate_layers_combination_parameters_Jacobian(layers_inputs);
+      Vector<double> block_gradient(network_parameters_number, 0.0);
 
-      if(!conditions_layer_flag)
+      for(unsigned int i = first_instance; i < first_instance+block_instances_number; i++)
       {
-         output_objective_gradient = (layers_activation[layers_number-1]-targets)*2.0;
+         inputs = data_set_pointer->get_training_input_instance(i);
+
+         targets = data_set_pointer->get_training_target_instance(i);
+
+         first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
+
+         const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
+         const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+
+	     layers_inputs[0] = inputs;
+
+	     for(unsigned int j = 1; j < layers_number; j++)
+	     {
+	        layers_inputs[j] = layers_activation[j-1];
+	     }
+
+	     layers_combination_parameters_Jacobian = multilayer_perceptron_pointer->calculate_layers_combination_parameters_Jacobian(layers_inputs);
 
-         layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
-      }
-      else
-      {
          particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
          homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
 
          output_objective_gradient = (particular_solution+homogeneous_solution*layers_activation[layers_number-1] - targets)*2.0;              
 
-		 layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
-      }
-
-      point_gradient = calculate_point_gradient(layers_combination_parameters_Jacobian, layers_delta);
+         layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
 
-      objective_gradient += point_gradient;
-   }
+         block_gradient += calculate_point_gradient(layers_combination_parameters_Jacobian, layers_delta);
+      }
 
+      return(block_gradient);
+   });
 
    return(objective_gradient);
 }
@@ -491,78 +477,86 @@ Matrix<double> SumSquaredError::calculate_Hessian(void) const
 
    const unsigned int conditions_layer_flag = neural_network_pointer->get_conditions_layer_flag();
 
-   Vector< Vector< Vector<double> > > second_order_forward_propagation(3); 
-
-   Vector < Vector< Vector<double> > > perceptrons_combination_parameters_gradient(layers_number);
-   Matrix < Matrix<double> > interlayers_combination_combination_Jacobian;
-
-   Vector<double> particular_solution;
-   Vector<double> homogeneous_solution;
-
    // Data set stuff
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
 
    const unsigned int training_instances_number = instances_information.count_training_instances_number();
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> targets(outputs_number);
-
    // Sum squared error stuff
 
-   Vector< Vector<double> > layers_delta(layers_number);
-   Matrix< Matrix<double> > interlayers_Delta(layers_number, layers_number);
+   const Matrix<double> zero_Hessian(parameters_number, parameters_number, 0.0);
 
-   Vector<double> output_objective_gradient(outputs_number);
-   Matrix<double> output_objective_Hessian(outputs_number, outputs_number);
+   const Matrix<double> objective_Hessian = calculate_instances_sum< Matrix<double> >(training_instances_number, zero_Hessian, 
+   [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
+   {
+      Vector< Vector< Vector<double> > > second_order_forward_propagation(3); 
 
-   Matrix<double> objective_Hessian(parameters_number, parameters_number, 0.0);
+      Vector < Vector< Vector<double> > > perceptrons_combination_parameters_gradient(layers_number);
+      Matrix < Matrix<double> > interlayers_combination_combination_Jacobian;
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
-   {
-      inputs = data_set_pointer->get_training_input_instance(i);
+      Vector<double> particular_solution;
+      Vector<double> homogeneous_solution;
+
+      Vector<double> inputs(inputs_number);
+      Vector<double> targets(outputs_number);
+
+      Vector< Vector<double> > layers_delta(layers_number);
+      Matrix< Matrix<double> > interlayers_Delta(layers_number, layers_number);
 
-      targets = data_set_pointer->get_training_target_instance(i);
+      Vector<double> output_objective_gradient(outputs_number);
+      Matrix<double> output_objective_Hessian(outputs_number, outputs_number);
 
-      second_order_forward_propagation = multilayer_perceptron_pointer->calculate_second_order_forward_propagation(inputs);
+      Matrix<double> block_Hessian(zero_Hessian);
+
+      for(unsigned int i = first_instance; i < first_instance+block_instances_number; i++)
+      {
+         inputs = data_set_pointer->get_training_input_instance(i);
+
+         targets = data_set_pointer->get_training_target_instance(i);
+
+         second_order_forward_propagation = multilayer_perceptron_pointer->calculate_second_order_forward_propagation(inputs);
 	  
-	  Vector< Vector<double> >& layers_activation = second_order_forward_propagation[0];
-	  Vector< Vector<double> >& layers_activation_derivative = second_order_forward_propagation[1];
-	  Vector< Vector<double> >& layers_activation_second_derivative = second_order_forward_propagation[2];
+	     Vector< Vector<double> >& layers_activation = second_order_forward_propagation[0];
+	     Vector< Vector<double> >& layers_activation_derivative = second_order_forward_propagation[1];
+	     Vector< Vector<double> >& layers_activation_second_derivative = second_order_forward_propagation[2];
 
-	  Vector< Vector<double> > layers_inputs(layers_number);
+	     Vector< Vector<double> > layers_inputs(layers_number);
 
-	  layers_inputs[0] = inputs;
+	     layers_inputs[0] = inputs;
 
-	  for(unsigned int j = 1; j < layers_number; j++)
-	  {
-	     layers_inputs[j] = layers_activation[j-1];
-	  }
+	     for(unsigned int j = 1; j < layers_number; j++)
+	     {
+	        layers_inputs[j] = layers_activation[j-1];
+	     }
 
-	  perceptrons_combination_parameters_gradient = multilayer_perceptron_pointer->calculate_perceptrons_combination_parameters_gradient(layers_inputs);
+	     perceptrons_combination_parameters_gradient = multilayer_perceptron_pointer->calculate_perceptrons_combination_parameters_gradient(layers_inputs);
 
-      interlayers_combination_combination_Jacobian = multilayer_perceptron_pointer->calculate_interlayers_combination_combination_Jacobian(inputs);
+         interlayers_combination_combination_Jacobian = multilayer_perceptron_pointer->calculate_interlayers_combination_combination_Jacobian(inputs);
 
-      if(!conditions_layer_flag)
-      {
-         output_objective_gradient = (layers_activation[layers_number-1] - targets)*2.0;
-		 output_objective_Hessian.initialize_diagonal(2.0);
+         if(!conditions_layer_flag)
+         {
+            output_objective_gradient = (layers_activation[layers_number-1] - targets)*2.0;
+		    output_objective_Hessian.initialize_diagonal(2.0);
 
-		 layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
-         interlayers_Delta = calculate_interlayers_Delta(layers_activation_derivative, layers_activation_second_derivative, interlayers_combination_combination_Jacobian, output_objective_gradient, output_objective_Hessian, layers_delta);
-      }
-      else
-      {
-         particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
-         homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
+		    layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
+            interlayers_Delta = calculate_interlayers_Delta(layers_activation_derivative, layers_activation_second_derivative, interlayers_combination_combination_Jacobian, output_objective_gradient, output_objective_Hessian, layers_delta);
+         }
+         else
+         {
+            particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
+            homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
 
-         output_objective_gradient = (particular_solution+homogeneous_solution*layers_activation[layers_number-1] - targets)*2.0;              
+            output_objective_gradient = (particular_solution+homogeneous_solution*layers_activation[layers_number-1] - targets)*2.0;              
+
+		    layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
+         }
 
-		 layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
+	     block_Hessian += calculate_point_Hessian(layers_activation_derivative, perceptrons_combination_parameters_gradient, interlayers_combination_combination_Jacobian, layers_delta, interlayers_Delta);
       }
 
-	  objective_Hessian += calculate_point_Hessian(layers_activation_derivative, perceptrons_combination_parameters_gradient, interlayers_combination_combination_Jacobian, layers_delta, interlayers_Delta);
-   }
+      return(block_Hessian);
+   });
 
    return(objective_Hessian);   
 }
@@ -582,39 +576,21 @@ Vector<double> SumSquaredError::calculate_evaluation_terms(void) const
 
    #endif
 
-   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
-
-   const unsigned int inputs_number = multilayer_perceptron_pointer->count_inputs_number();
-   const unsigned int outputs_number = multilayer_perceptron_pointer->count_outputs_number();
-
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
 
    const unsigned int training_instances_number = instances_information.count_training_instances_number();
 
    Vector<double> evaluation_terms(training_instances_number);
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> outputs(outputs_number);
-   Vector<double> targets(outputs_number);
-
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   run_instances_blocks(training_instances_number, [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
    {
-      // Input vector
-
-	  inputs = data_set_pointer->get_training_input_instance(i);
-
-      // Output vector
-
-      outputs = multilayer_perceptron_pointer->calculate_outputs(inputs);
-
-      // Target vector
-
-      targets = data_set_pointer->get_training_target_instance(i);
-
-      // Error
+      calculate_block_squared_errors(first_instance, block_instances_number, get_block_workspace(block_instances_number), evaluation_terms);
 
-      evaluation_terms[i] = outputs.calculate_distance(targets);
-   }
+      for(unsigned int i = 0; i < block_instances_number; i++)
+      {
+         evaluation_terms[first_instance+i] = sqrt(evaluation_terms[first_instance+i]);
+      }
+   });
 
    return(evaluation_terms);
 }
@@ -689,14 +665,6 @@ Matrix<double> SumSquaredError::calculate_Jacobian_terms(void) const
 
    const unsigned int network_parameters_number = multilayer_perceptron_pointer->count_parameters_number();
 
-   Vector< Vector< Vector<double> > > first_order_forward_propagation(2);
-
-   Vector< Vector<double> > layers_inputs(layers_number);
-   Vector< Matrix<double> > layers_combination_parameters_Jacobian(layers_number);
-
-   Vector<double> particular_solution;
-   Vector<double> homogeneous_solution;
-
    const bool conditions_layer_flag = neural_network_pointer->get_conditions_layer_flag();
 
    // Data set
@@ -705,89 +673,100 @@ Matrix<double> SumSquaredError::calculate_Jacobian_terms(void) const
 
    const unsigned int training_instances_number = instances_information.count_training_instances_number();
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> targets(outputs_number);
-
    // Objective functional
 
-   Vector<double> term(outputs_number);
-   double term_norm;
-
-   Vector<double> output_objective_gradient(outputs_number);
-
-   Vector< Vector<double> > layers_delta(layers_number);
-   Vector<double> point_gradient(network_parameters_number);
-
    Matrix<double> Jacobian_terms(training_instances_number, network_parameters_number);
 
    // Main loop
 
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   run_instances_blocks(training_instances_number, [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
    {
-      inputs = data_set_pointer->get_training_input_instance(i);
+      Vector< Vector< Vector<double> > > first_order_forward_propagation(2);
 
-	  targets = data_set_pointer->get_training_target_instance(i);
+      Vector< Vector<double> > layers_inputs(layers_number);
+      Vector< Matrix<double> > layers_combination_parameters_Jacobian(layers_number);
 
-      first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
+      Vector<double> particular_solution;
+      Vector<double> homogeneous_solution;
 
-      const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
-      const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+      Vector<double> inputs(inputs_number);
+      Vector<double> targets(outputs_number);
 
-	  layers_inputs[0] = inputs;
+      Vector<double> term(outputs_number);
+      double term_norm;
 
-	  for(unsigned int j = 1; j < layers_number; j++)
-	  {
-	     layers_inputs[j] = layers_activation[j-1];
-	  }
+      Vector<double> output_objective_gradient(outputs_number);
 
-	  layers_combination_parameters_Jacobian = multilayer_perceptron_pointer->calculate_layers_combination_parameters_Jacobian(layers_inputs);
+      Vector< Vector<double> > layers_delta(layers_number);
+      Vector<double> point_gradient(network_parameters_number);
 
-      if(!conditions_layer_flag)
+      for(unsigned int i = first_instance; i < first_instance+block_instances_number; i++)
       {
-         const Vector<double>& outputs = first_order_forward_propagation[0][layers_number-1]; 
+         inputs = data_set_pointer->get_training_input_instance(i);
 
-         term = outputs-targets;
-         term_norm = term.calculate_norm();
+	     targets = data_set_pointer->get_training_target_instance(i);
 
-         if(term_norm == 0.0)
-   	     {
-	        output_objective_gradient.initialize(0.0);
-	     }
-         else
+         first_order_forward_propagation = multilayer_perceptron_pointer->calculate_first_order_forward_propagation(inputs);
+
+         const Vector< Vector<double> >& layers_activation = first_order_forward_propagation[0];
+         const Vector< Vector<double> >& layers_activation_derivative = first_order_forward_propagation[1];
+
+	     layers_inputs[0] = inputs;
+
+	     for(unsigned int j = 1; j < layers_number; j++)
 	     {
-            output_objective_gradient = term/term_norm;	      
+	        layers_inputs[j] = layers_activation[j-1];
 	     }
 
-         layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
-      }
-      else
-      {
-         ConditionsLayer* conditions_layer_pointer = neural_network_pointer->get_conditions_layer_pointer();
+	     layers_combination_parameters_Jacobian = multilayer_perceptron_pointer->calculate_layers_combination_parameters_Jacobian(layers_inputs);
 
-         particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
-         homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
+         if(!conditions_layer_flag)
+         {
+            const Vector<double>& outputs = first_order_forward_propagation[0][layers_number-1]; 
 
-         const Vector<double>& output_layer_activation = first_order_forward_propagation[0][layers_number-1]; 
+            term = outputs-targets;
+            term_norm = term.calculate_norm();
 
-         term = (particular_solution+homogeneous_solution*output_layer_activation - targets);              
-         term_norm = term.calculate_norm();
+            if(term_norm == 0.0)
+   	        {
+	           output_objective_gradient.initialize(0.0);
+	        }
+            else
+	        {
+               output_objective_gradient = term/term_norm;	      
+	        }
 
-         if(term_norm == 0.0)
-   	     {
-	        output_objective_gradient.initialize(0.0);
-	     }
-	     else
-	     {
-            output_objective_gradient = term/term_norm;	      
-	     }
+            layers_delta = calculate_layers_delta(layers_activation_derivative, output_objective_gradient);
+         }
+         else
+         {
+            ConditionsLayer* conditions_layer_pointer = neural_network_pointer->get_conditions_layer_pointer();
+
+            particular_solution = conditions_layer_pointer->calculate_particular_solution(inputs);
+            homogeneous_solution = conditions_layer_pointer->calculate_homogeneous_solution(inputs);
 
-		 layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
-	  }
+            const Vector<double>& output_layer_activation = first_order_forward_propagation[0][layers_number-1]; 
 
-      point_gradient = calculate_point_gradient(layers_combination_parameters_Jacobian, layers_delta);
+            term = (particular_solution+homogeneous_solution*output_layer_activation - targets);              
+            term_norm = term.calculate_norm();
 
-      Jacobian_terms.set_row(i, point_gradient);
-  }
+            if(term_norm == 0.0)
+   	        {
+	           output_objective_gradient.initialize(0.0);
+	        }
+	        else
+	        {
+               output_objective_gradient = term/term_norm;	      
+	        }
+
+		    layers_delta = calculate_layers_delta(layers_activation_derivative, homogeneous_solution, output_objective_gradient);
+	     }
+
+         point_gradient = calculate_point_gradient(layers_combination_parameters_Jacobian, layers_delta);
+
+         Jacobian_terms.set_row(i, point_gradient);
+      }
+   });
 
    return(Jacobian_terms);
 }
@@ -823,13 +802,6 @@ Vector<double> SumSquaredError::calculate_squared_errors(void) const
 
    #endif
 
-   // Neural network stuff
-
-   const MultilayerPerceptron* multilayer_perceptron_pointer = neural_network_pointer->get_multilayer_perceptron_pointer();
-
-   const unsigned int inputs_number = multilayer_perceptron_pointer->count_inputs_number();
-   const unsigned int outputs_number = multilayer_perceptron_pointer->count_outputs_number();
-
    // Data set stuff
 
    const InstancesInformation& instances_information = data_set_pointer->get_instances_information();
@@ -838,28 +810,10 @@ Vector<double> SumSquaredError::calculate_squared_errors(void) const
 
    Vector<double> squared_errors(training_instances_number);
 
-   Vector<double> inputs(inputs_number);
-   Vector<double> outputs(outputs_number);
-   Vector<double> targets(outputs_number);
-
-   for(unsigned int i = 0; i < training_instances_number; i++)
+   run_instances_blocks(training_instances_number, [&](const unsigned int& first_instance, const unsigned int& block_instances_number)
    {
-      // Input vector
-
-	  inputs = data_set_pointer->get_training_input_instance(i);
-
-      // Output vector
-
-      outputs = multilayer_perceptron_pointer->calculate_outputs(inputs);
-
-      // Target vector
-
-      targets = data_set_pointer->get_training_target_instance(i);
-
-      // Error
-
-      squared_errors[i] = outputs.calculate_sum_squared_error(targets);
-   }
+      calculate_block_squared_errors(first_instance, block_instances_number, get_block_workspace(block_instances_number), squared_errors);
+   });
 
    return(squared_errors);
 }
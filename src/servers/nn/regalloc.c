@@ -0,0 +1,244 @@
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ir.h"
+
+/*
+ * Linear scan register allocation (Poletto and Sarkar).
+ *
+ * Liveness is solved per instruction with bit sets, then every virtual
+ * register gets the single interval from its first to its last live point.
+ * Intervals are visited by increasing start; when no register is free the
+ * interval ending last is spilled to a frame slot for its whole lifetime.
+ *
+ * %rax, %rcx and %rdx are left to instruction selection as scratch
+ * registers. Intervals live across a call only get callee saved registers.
+ */
+
+static const int caller_saved[] = {X86_RSI, X86_RDI, X86_R8,
+                                   X86_R9,  X86_R10, X86_R11};
+static const int callee_saved[] = {X86_RBX, X86_R12, X86_R13, X86_R14, X86_R15};
+static const int arg_regs[] = {X86_RDI, X86_RSI, X86_RDX,
+                               X86_RCX, X86_R8,  X86_R9};
+
+#define NCALLER (int) (sizeof(caller_saved) / sizeof(caller_saved[0]))
+#define NCALLEE (int) (sizeof(callee_saved) / sizeof(callee_saved[0]))
+
+typedef struct {
+    int vreg;
+    int start;
+    int end;
+    bool crosses_call;
+    int hint; /* argument register the value is received or passed in */
+} Interval;
+
+static bool is_jump(int op)
+{
+    return op >= IR_JMP && op <= IR_JLE;
+}
+
+static int compare_start(const void *a, const void *b)
+{
+    const Interval *x = a;
+    const Interval *y = b;
+    if (x->start != y->start)
+        return x->start - y->start;
+    return x->vreg - y->vreg;
+}
+
+static void set_bit(uint64_t *set, int i)
+{
+    set[i / 64] |= (uint64_t) 1 << (i % 64);
+}
+
+static void add_uses(const IRInst *inst, uint64_t *set)
+{
+    for (int j = 0; j < 2; j++)
+        if (inst->src[j] >= 0)
+            set_bit(set, inst->src[j]);
+    if (inst->index >= 0)
+        set_bit(set, inst->index);
+    for (int j = 0; j < inst->nargs; j++)
+        set_bit(set, inst->args[j]);
+}
+
+/* Returns the live in sets of all instructions, nwords words each. */
+static uint64_t *compute_liveness(IRFunc *fn, int nwords)
+{
+    int n = fn->ninsts;
+    int *label_pos = malloc((fn->nlabels + 1) * sizeof(int));
+    for (int i = 0; i < n; i++)
+        if (fn->insts[i].op == IR_LABEL)
+            label_pos[fn->insts[i].label] = i;
+
+    uint64_t *live = calloc((size_t) (n + 1) * nwords, sizeof(uint64_t));
+    uint64_t *out = malloc(nwords * sizeof(uint64_t));
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int i = n - 1; i >= 0; i--) {
+            const IRInst *inst = &fn->insts[i];
+            memset(out, 0, nwords * sizeof(uint64_t));
+            if (inst->op != IR_RET && inst->op != IR_JMP) {
+                const uint64_t *next = live + (size_t) (i + 1) * nwords;
+                for (int w = 0; w < nwords; w++)
+                    out[w] |= next[w];
+            }
+            if (is_jump(inst->op)) {
+                const uint64_t *target =
+                    live + (size_t) label_pos[inst->label] * nwords;
+                for (int w = 0; w < nwords; w++)
+                    out[w] |= target[w];
+            }
+            if (inst->dst >= 0)
+                out[inst->dst / 64] &= ~((uint64_t) 1 << (inst->dst % 64));
+            add_uses(inst, out);
+            uint64_t *in = live + (size_t) i * nwords;
+            if (memcmp(in, out, nwords * sizeof(uint64_t))) {
+                memcpy(in, out, nwords * sizeof(uint64_t));
+                changed = true;
+            }
+        }
+    }
+    free(out);
+    free(label_pos);
+    return live;
+}
+
+static int new_slot(IRFunc *fn)
+{
+    fn->frame_size += 8;
+    return -fn->frame_size;
+}
+
+void allocate_registers(IRFunc *fn, bool spill_all)
+{
+    int n = fn->ninsts;
+    int nv = fn->nvregs;
+    int nwords = (nv + 63) / 64;
+    fn->reg = malloc(nv * sizeof(int));
+    fn->slot = calloc(nv, sizeof(int));
+    fn->used_regs = 0;
+
+    Interval *intervals = malloc(nv * sizeof(Interval));
+    for (int v = 0; v < nv; v++)
+        intervals[v] = (Interval){v, INT_MAX, -1, false, -1};
+
+    uint64_t *live = compute_liveness(fn, nwords);
+    int *calls_before = malloc((n + 1) * sizeof(int));
+    int *last_def = calloc(nv, sizeof(int));
+    calls_before[0] = 0;
+    for (int i = 0; i < n; i++) {
+        const IRInst *inst = &fn->insts[i];
+        const uint64_t *in = live + (size_t) i * nwords;
+        for (int w = 0; w < nwords; w++) {
+            for (uint64_t bits = in[w]; bits; bits &= bits - 1) {
+                Interval *it = &intervals[w * 64 + __builtin_ctzll(bits)];
+                if (it->start > i)
+                    it->start = i;
+                it->end = i;
+            }
+        }
+        /* Even dead definitions write the location of their value. */
+        if (inst->dst >= 0) {
+            Interval *it = &intervals[inst->dst];
+            if (it->start > i)
+                it->start = i;
+            last_def[inst->dst] = i;
+        }
+        if (inst->op == IR_PARAM)
+            intervals[inst->dst].hint = arg_regs[inst->imm];
+        for (int j = 0; j < inst->nargs; j++)
+            if (intervals[inst->args[j]].hint < 0)
+                intervals[inst->args[j]].hint = arg_regs[j];
+        calls_before[i + 1] = calls_before[i] + (inst->op == IR_CALL);
+    }
+    free(live);
+
+    int count = 0;
+    for (int v = 0; v < nv; v++) {
+        Interval *it = &intervals[v];
+        fn->reg[v] = -1;
+        if (it->end < 0)
+            continue; /* never used */
+        if (it->end < last_def[v])
+            it->end = last_def[v];
+        if (spill_all) {
+            fn->slot[v] = new_slot(fn);
+            continue;
+        }
+        it->crosses_call =
+            it->end > it->start + 1 &&
+            calls_before[it->end] - calls_before[it->start + 1] > 0;
+        intervals[count++] = *it;
+    }
+    free(calls_before);
+    free(last_def);
+    qsort(intervals, count, sizeof(Interval), compare_start);
+
+    /* Active intervals, by increasing end */
+    Interval **active = malloc((NCALLER + NCALLEE) * sizeof(Interval *));
+    int nactive = 0;
+    bool used[16] = {false};
+    for (int k = 0; k < count; k++) {
+        Interval *cur = &intervals[k];
+        int j = 0;
+        for (int a = 0; a < nactive; a++) {
+            if (active[a]->end < cur->start)
+                used[fn->reg[active[a]->vreg]] = false;
+            else
+                active[j++] = active[a];
+        }
+        nactive = j;
+
+        int reg = -1;
+        if (!cur->crosses_call)
+            for (int r = 0; r < NCALLER && reg < 0; r++)
+                if (caller_saved[r] == cur->hint && !used[cur->hint])
+                    reg = cur->hint;
+        if (!cur->crosses_call)
+            for (int r = 0; r < NCALLER && reg < 0; r++)
+                if (!used[caller_saved[r]])
+                    reg = caller_saved[r];
+        for (int r = 0; r < NCALLEE && reg < 0; r++)
+            if (!used[callee_saved[r]])
+                reg = callee_saved[r];
+
+        if (reg < 0) {
+            /* Spill whichever of cur and the intervals holding a register
+             * cur could use ends last. */
+            int victim = -1;
+            for (int a = nactive - 1; a >= 0 && victim < 0; a--) {
+                int r = fn->reg[active[a]->vreg];
+                bool callee = r == X86_RBX || r >= X86_R12;
+                if (callee || !cur->crosses_call)
+                    victim = a;
+            }
+            if (victim < 0 || active[victim]->end <= cur->end) {
+                fn->slot[cur->vreg] = new_slot(fn);
+                continue;
+            }
+            Interval *spilled = active[victim];
+            reg = fn->reg[spilled->vreg];
+            fn->reg[spilled->vreg] = -1;
+            fn->slot[spilled->vreg] = new_slot(fn);
+            memmove(&active[victim], &active[victim + 1],
+                    (nactive - victim - 1) * sizeof(Interval *));
+            nactive--;
+        }
+
+        fn->reg[cur->vreg] = reg;
+        used[reg] = true;
+        fn->used_regs |= 1u << reg;
+        int pos = nactive;
+        while (pos > 0 && active[pos - 1]->end > cur->end) {
+            active[pos] = active[pos - 1];
+            pos--;
+        }
+        active[pos] = cur;
+        nactive++;
+    }
+    free(active);
+    free(intervals);
+}
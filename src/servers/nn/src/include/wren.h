@@ -150,6 +150,56 @@ typedef struct
 typedef WrenForeignClassMethods (*WrenBindForeignClassFn)(
     WrenVM* vm, const char* module, const char* className);
 
+// What the garbage collector did during a pause.
+typedef enum
+{
+  // Collected the nursery, the objects allocated since the last collection.
+  WREN_GC_MINOR,
+
+  // Marked a bounded slice of the whole heap.
+  WREN_GC_MARK,
+
+  // Traced the roots again and everything changed since marking started, to
+  // finish marking the whole heap.
+  WREN_GC_REMARK,
+
+  // Collected the nursery and freed a bounded slice of the unreachable objects
+  // of the whole heap.
+  WREN_GC_SWEEP,
+
+  // Collected the whole heap at once, because of [wrenCollectGarbage].
+  WREN_GC_FULL
+} WrenGCPauseType;
+
+// Pause time statistics of the garbage collector.
+typedef struct
+{
+  // The kind of the last pause.
+  WrenGCPauseType pauseType;
+
+  // How long the last pause took, in seconds.
+  double pauseTime;
+
+  // The longest pause so far and the total time spent in pauses, in seconds.
+  double maxPauseTime;
+  double totalPauseTime;
+
+  // The number of pauses, of minor collections, and of completed collections
+  // of the whole heap so far.
+  int numPauses;
+  int numMinorCollections;
+  int numMajorCollections;
+
+  // The number of bytes known to be allocated after the last pause.
+  size_t bytesAllocated;
+} WrenGCStats;
+
+// Reports each pause of the garbage collector with the updated [stats].
+//
+// This is called while the collector is running, so it must not call back
+// into [vm].
+typedef void (*WrenGCFn)(WrenVM* vm, const WrenGCStats* stats);
+
 typedef struct
 {
   // The callback Wren will use to allocate, reallocate, and deallocate memory.
@@ -232,13 +282,44 @@ typedef struct
   // errors.
   WrenErrorFn errorFn;
 
-  // The number of bytes Wren will allocate before triggering the first garbage
-  // collection.
+  // The callback Wren uses to report the pauses of the garbage collector.
+  //
+  // If this is `NULL`, the statistics are only available through
+  // [wrenGetGCStats].
+  WrenGCFn gcFn;
+
+  // New objects are allocated in a nursery, which is collected on its own
+  // every time this many bytes have been allocated. The objects that survive
+  // are moved to the old generation, which is only collected by the
+  // collections of the whole heap described below.
+  //
+  // Each minor collection also traces the whole of every old object that was
+  // changed to reference a young one, such as a large map which is written
+  // to in a loop. A larger nursery does that less often, at the cost of
+  // longer pauses.
+  //
+  // While a collection of the whole heap is in progress, it advances by one
+  // slice at each of these points instead, so this also bounds how much work
+  // a pause does.
+  //
+  // If zero, defaults to 256KB.
+  size_t nurserySize;
+
+  // The number of bytes of objects a slice of an incremental collection
+  // marks or sweeps, as a percentage of [nurserySize]. This needs to be more
+  // than 100 for the collection to finish before the program allocates more
+  // than it can mark.
+  //
+  // If zero, defaults to 200.
+  int sliceSizePercent;
+
+  // The number of bytes Wren will allocate before starting the first
+  // collection of the whole heap.
   //
   // If zero, defaults to 10MB.
   size_t initialHeapSize;
 
-  // After a collection occurs, the threshold for the next collection is
+  // After a collection of the whole heap, the threshold for the next one is
   // determined based on the number of bytes remaining in use. This allows Wren
   // to shrink its memory usage automatically after reclaiming a large amount
   // of memory.
@@ -317,8 +398,15 @@ WREN_API WrenVM* wrenNewVM(WrenConfiguration* configuration);
 WREN_API void wrenFreeVM(WrenVM* vm);
 
 // Immediately run the garbage collector to free unused memory.
+//
+// This collects the whole heap at once, finishing any incremental collection
+// in progress.
 WREN_API void wrenCollectGarbage(WrenVM* vm);
 
+// Fills [stats] with the pause time statistics of the garbage collector of
+// [vm].
+WREN_API void wrenGetGCStats(WrenVM* vm, WrenGCStats* stats);
+
 // Runs [source], a string of Wren source code in a new fiber in [vm] in the
 // context of resolved [module].
 WREN_API WrenInterpretResult wrenInterpret(WrenVM* vm, const char* module,
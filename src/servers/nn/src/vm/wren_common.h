@@ -44,6 +44,15 @@
   #endif
 #endif
 
+// If true, each method call site remembers the methods it called for the last
+// few receiver classes, so that calls skip the lookup in the class's method
+// table. The bytecode is the same either way, which makes it possible to
+// measure the difference.
+// Defaults to true.
+#ifndef WREN_INLINE_CACHE
+  #define WREN_INLINE_CACHE 1
+#endif
+
 // The VM includes a number of optional modules. You can choose to include
 // these or not. By default, they are all available. To disable one, set the
 // corresponding `WREN_OPT_<name>` define to `0`.
@@ -33,6 +33,11 @@
 // two-byte argument.
 #define MAX_CONSTANTS (1 << 16)
 
+// The maximum number of method call sites in a function. This value is explicit
+// in the bytecode since the inline cache of a `CODE_CALL_*` is identified by a
+// two-byte argument.
+#define MAX_CALL_CACHES (1 << 16)
+
 // The maximum distance a CODE_JUMP or CODE_JUMP_IF instruction can move the
 // instruction pointer.
 #define MAX_JUMP (1 << 16)
@@ -510,6 +515,7 @@ static int addConstant(Compiler* compiler, Value constant)
     if (IS_OBJ(constant)) wrenPushRoot(compiler->parser->vm, AS_OBJ(constant));
     wrenValueBufferWrite(compiler->parser->vm, &compiler->fn->constants,
                          constant);
+    wrenWriteBarrier(compiler->parser->vm, &compiler->fn->obj, constant);
     if (IS_OBJ(constant)) wrenPopRoot(compiler->parser->vm);
     
     if (compiler->constants == NULL)
@@ -1356,6 +1362,19 @@ static void emitShortArg(Compiler* compiler, Code instruction, int arg)
   emitShort(compiler, arg);
 }
 
+// Emits the argument of a `CODE_CALL_*` which identifies the inline cache of
+// the call site.
+static void emitCallCache(Compiler* compiler)
+{
+  if (compiler->fn->numCallCaches == MAX_CALL_CACHES)
+  {
+    error(compiler, "A function may only contain %d method calls.",
+          MAX_CALL_CACHES);
+  }
+
+  emitShort(compiler, compiler->fn->numCallCaches++);
+}
+
 // Emits [instruction] followed by a placeholder for a jump offset. The
 // placeholder can be patched by calling [jumpPatch]. Returns the index of the
 // placeholder.
@@ -1672,6 +1691,15 @@ static ObjFn* endCompiler(Compiler* compiler,
   // we can't rely on CODE_RETURN to tell us we're at the end.
   emitOp(compiler, CODE_END);
 
+  // The inline caches start empty and are filled in by the calls.
+  ObjFn* fn = compiler->fn;
+  fn->callCaches = ALLOCATE_ARRAY(compiler->parser->vm, CallCache,
+                                  fn->numCallCaches);
+  if (fn->numCallCaches > 0)
+  {
+    memset(fn->callCaches, 0, sizeof(CallCache) * fn->numCallCaches);
+  }
+
   wrenFunctionBindName(compiler->parser->vm, compiler->fn,
                        debugName, debugNameLength);
   
@@ -1977,7 +2005,11 @@ static void callSignature(Compiler* compiler, Code instruction,
   int symbol = signatureSymbol(compiler, signature);
   emitShortArg(compiler, (Code)(instruction + signature->arity), symbol);
 
-  if (instruction == CODE_SUPER_0)
+  if (instruction == CODE_CALL_0)
+  {
+    emitCallCache(compiler);
+  }
+  else
   {
     // Super calls need to be statically bound to the class's superclass. This
     // ensures we call the right method even when a method containing a super
@@ -1997,6 +2029,7 @@ static void callMethod(Compiler* compiler, int numArgs, const char* name,
 {
   int symbol = methodSymbol(compiler, name, length);
   emitShortArg(compiler, (Code)(CODE_CALL_0 + numArgs), symbol);
+  emitCallCache(compiler);
 }
 
 // Compiles an (optional) argument list for a method call with [methodSignature]
@@ -2902,6 +2935,17 @@ static int getByteCountForArguments(const uint8_t* bytecode,
     case CODE_CONSTANT:
     case CODE_LOAD_MODULE_VAR:
     case CODE_STORE_MODULE_VAR:
+    case CODE_JUMP:
+    case CODE_LOOP:
+    case CODE_JUMP_IF:
+    case CODE_AND:
+    case CODE_OR:
+    case CODE_METHOD_INSTANCE:
+    case CODE_METHOD_STATIC:
+    case CODE_IMPORT_MODULE:
+    case CODE_IMPORT_VARIABLE:
+      return 2;
+
     case CODE_CALL_0:
     case CODE_CALL_1:
     case CODE_CALL_2:
@@ -2919,17 +2963,6 @@ static int getByteCountForArguments(const uint8_t* bytecode,
     case CODE_CALL_14:
     case CODE_CALL_15:
     case CODE_CALL_16:
-    case CODE_JUMP:
-    case CODE_LOOP:
-    case CODE_JUMP_IF:
-    case CODE_AND:
-    case CODE_OR:
-    case CODE_METHOD_INSTANCE:
-    case CODE_METHOD_STATIC:
-    case CODE_IMPORT_MODULE:
-    case CODE_IMPORT_VARIABLE:
-      return 2;
-
     case CODE_SUPER_0:
     case CODE_SUPER_1:
     case CODE_SUPER_2:
@@ -3289,6 +3322,7 @@ static void createConstructor(Compiler* compiler, Signature* signature,
   // Run its initializer.
   emitShortArg(&methodCompiler, (Code)(CODE_CALL_0 + signature->arity),
                initializerSymbol);
+  emitCallCache(&methodCompiler);
   
   // Return the instance.
   emitOp(&methodCompiler, CODE_RETURN);
@@ -3782,19 +3816,24 @@ ObjFn* wrenCompile(WrenVM* vm, ObjModule* module, const char* source,
   parser.next.length = 0;
   parser.next.line = 0;
   parser.next.value = UNDEFINED_VAL;
+  parser.current = parser.next;
+  parser.previous = parser.next;
 
   parser.printErrors = printErrors;
   parser.hasError = false;
 
+  int numExistingVariables = module->variables.count;
+
+  // Register the compiler before lexing so that the string values of the
+  // tokens are reachable by the collector.
+  Compiler compiler;
+  initCompiler(&compiler, &parser, NULL, false);
+
   // Read the first token into next
   nextToken(&parser);
   // Copy next -> current
   nextToken(&parser);
 
-  int numExistingVariables = module->variables.count;
-
-  Compiler compiler;
-  initCompiler(&compiler, &parser, NULL, false);
   ignoreNewlines(&compiler);
 
   if (isExpression)
@@ -3840,7 +3879,7 @@ ObjFn* wrenCompile(WrenVM* vm, ObjModule* module, const char* source,
   return endCompiler(&compiler, "(script)", 8);
 }
 
-void wrenBindMethodCode(ObjClass* classObj, ObjFn* fn)
+void wrenBindMethodCode(WrenVM* vm, ObjClass* classObj, ObjFn* fn)
 {
   int ip = 0;
   for (;;)
@@ -3879,6 +3918,7 @@ void wrenBindMethodCode(ObjClass* classObj, ObjFn* fn)
         // Fill in the constant slot with a reference to the superclass.
         int constant = (fn->code.data[ip + 3] << 8) | fn->code.data[ip + 4];
         fn->constants.data[constant] = OBJ_VAL(classObj->superclass);
+        wrenWriteBarrier(vm, &fn->obj, OBJ_VAL(classObj->superclass));
         break;
       }
 
@@ -3886,7 +3926,7 @@ void wrenBindMethodCode(ObjClass* classObj, ObjFn* fn)
       {
         // Bind the nested closure too.
         int constant = (fn->code.data[ip + 1] << 8) | fn->code.data[ip + 2];
-        wrenBindMethodCode(classObj, AS_FN(fn->constants.data[constant]));
+        wrenBindMethodCode(vm, classObj, AS_FN(fn->constants.data[constant]));
         break;
       }
 
@@ -3981,6 +4021,7 @@ static void addToAttributeGroup(Compiler* compiler,
   //keyItems.add(value)
   ObjList* keyItems = AS_LIST(keyItemsValue);
   wrenValueBufferWrite(vm, &keyItems->elements, value);
+  wrenWriteBarrier(vm, &keyItems->obj, value);
 
   if(IS_OBJ(group)) wrenPopRoot(vm);
   if(IS_OBJ(key))   wrenPopRoot(vm);
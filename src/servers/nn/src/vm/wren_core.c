@@ -322,6 +322,7 @@ DEF_PRIMITIVE(list_new)
 DEF_PRIMITIVE(list_add)
 {
   wrenValueBufferWrite(vm, &AS_LIST(args[0])->elements, args[1]);
+  wrenWriteBarrier(vm, AS_OBJ(args[0]), args[1]);
   RETURN_VAL(args[1]);
 }
 
@@ -331,6 +332,7 @@ DEF_PRIMITIVE(list_add)
 DEF_PRIMITIVE(list_addCore)
 {
   wrenValueBufferWrite(vm, &AS_LIST(args[0])->elements, args[1]);
+  wrenWriteBarrier(vm, AS_OBJ(args[0]), args[1]);
   
   // Return the list.
   RETURN_VAL(args[0]);
@@ -467,6 +469,7 @@ DEF_PRIMITIVE(list_subscriptSetter)
   if (index == UINT32_MAX) return false;
 
   list->elements.data[index] = args[2];
+  wrenWriteBarrier(vm, &list->obj, args[2]);
   RETURN_VAL(args[2]);
 }
 
@@ -1266,6 +1269,8 @@ void wrenInitializeCore(WrenVM* vm)
   vm->objectClass->obj.classObj = objectMetaclass;
   objectMetaclass->obj.classObj = vm->classClass;
   vm->classClass->obj.classObj = vm->classClass;
+  wrenWriteBarrier(vm, &vm->objectClass->obj, OBJ_VAL(objectMetaclass));
+  wrenWriteBarrier(vm, &objectMetaclass->obj, OBJ_VAL(vm->classClass));
 
   // Do this after wiring up the metaclasses so objectMetaclass doesn't get
   // collected.
@@ -1479,9 +1484,14 @@ void wrenInitializeCore(WrenVM* vm)
   // for its name.
   //
   // These all currently have a NULL classObj pointer, so go back and assign
-  // them now that the string class is known.
-  for (Obj* obj = vm->first; obj != NULL; obj = obj->next)
+  // them now that the string class is known. Some may have been moved to the
+  // old generation already.
+  Obj* lists[] = { vm->first, vm->tenured };
+  for (int i = 0; i < 2; i++)
   {
-    if (obj->type == OBJ_STRING) obj->classObj = vm->stringClass;
+    for (Obj* obj = lists[i]; obj != NULL; obj = obj->next)
+    {
+      if (obj->type == OBJ_STRING) obj->classObj = vm->stringClass;
+    }
   }
 }
@@ -198,8 +198,9 @@ static int dumpInstruction(WrenVM* vm, ObjFn* fn, int i, int* lastLine)
     {
       int numArgs = bytecode[i - 1] - CODE_CALL_0;
       int symbol = READ_SHORT();
-      printf("CALL_%-11d %5d '%s'\n", numArgs, symbol,
-             vm->methodNames.data[symbol]->value);
+      int cache = READ_SHORT();
+      printf("CALL_%-11d %5d '%s' %5d\n", numArgs, symbol,
+             vm->methodNames.data[symbol]->value, cache);
       break;
     }
 
@@ -77,8 +77,9 @@ OPCODE(STORE_FIELD, -1)
 // Pop and discard the top of stack.
 OPCODE(POP, -1)
 
-// Invoke the method with symbol [arg]. The number indicates the number of
-// arguments (not including the receiver).
+// Invoke the method with symbol [arg1], using inline cache [arg2] of the
+// function. The number indicates the number of arguments (not including the
+// receiver).
 OPCODE(CALL_0, 0)
 OPCODE(CALL_1, -1)
 OPCODE(CALL_2, -2)
@@ -38,9 +38,16 @@ static void initObj(WrenVM* vm, Obj* obj, ObjType type, ObjClass* classObj)
 {
   obj->type = type;
   obj->isDark = false;
+  obj->isOld = false;
+  obj->isRemembered = false;
   obj->classObj = classObj;
-  obj->next = vm->first;
-  vm->first = obj;
+
+  // While the whole heap is being marked, new objects go with the old ones so
+  // that the sweep which follows frees those that end up unreachable. The list
+  // stays ordered from newest to oldest either way.
+  Obj** list = vm->gcPhase == GC_MARK ? &vm->tenured : &vm->first;
+  obj->next = *list;
+  *list = obj;
 }
 
 ObjClass* wrenNewSingleClass(WrenVM* vm, int numFields, ObjString* name)
@@ -64,6 +71,7 @@ void wrenBindSuperclass(WrenVM* vm, ObjClass* subclass, ObjClass* superclass)
   ASSERT(superclass != NULL, "Must have superclass.");
 
   subclass->superclass = superclass;
+  wrenWriteBarrier(vm, &subclass->obj, OBJ_VAL(superclass));
 
   // Include the superclass in the total number of fields.
   if (subclass->numFields != -1)
@@ -129,6 +137,10 @@ void wrenBindMethod(WrenVM* vm, ObjClass* classObj, int symbol, Method method)
   }
 
   classObj->methods.data[symbol] = method;
+  if (method.type == METHOD_BLOCK)
+  {
+    wrenWriteBarrier(vm, &classObj->obj, OBJ_VAL(method.as.closure));
+  }
 }
 
 ObjClosure* wrenNewClosure(WrenVM* vm, ObjFn* fn)
@@ -256,6 +268,8 @@ ObjFn* wrenNewFunction(WrenVM* vm, ObjModule* module, int maxSlots)
   fn->maxSlots = maxSlots;
   fn->numUpvalues = 0;
   fn->arity = 0;
+  fn->callCaches = NULL;
+  fn->numCallCaches = 0;
   fn->debug = debug;
   
   return fn;
@@ -318,6 +332,7 @@ void wrenListInsert(WrenVM* vm, ObjList* list, Value value, uint32_t index)
 
   // Store the new element.
   list->elements.data[index] = value;
+  wrenWriteBarrier(vm, &list->obj, value);
 }
 
 int wrenListIndexOf(WrenVM* vm, ObjList* list, Value value)
@@ -596,6 +611,9 @@ void wrenMapSet(WrenVM* vm, ObjMap* map, Value key, Value value)
     // A new key was added.
     map->count++;
   }
+
+  wrenWriteBarrier(vm, &map->obj, key);
+  wrenWriteBarrier(vm, &map->obj, value);
 }
 
 void wrenMapClear(WrenVM* vm, ObjMap* map)
@@ -980,8 +998,14 @@ void wrenGrayObj(WrenVM* vm, Obj* obj)
   // Stop if the object is already darkened so we don't get stuck in a cycle.
   if (obj->isDark) return;
 
-  // It's been reached.
+  // A minor collection only traces the nursery. The old objects that may
+  // reference young ones are in the remembered set, which it traces too.
+  if (obj->isOld && vm->gcPhase == GC_MINOR) return;
+
+  // It's been reached. Whatever a collection reaches ends up in the old
+  // generation.
   obj->isDark = true;
+  obj->isOld = true;
 
   // Add it to the gray list so it can be recursively explored for
   // more marks later.
@@ -996,6 +1020,20 @@ void wrenGrayObj(WrenVM* vm, Obj* obj)
   vm->gray[vm->grayCount++] = obj;
 }
 
+void wrenRememberObj(WrenVM* vm, Obj* obj)
+{
+  if (vm->rememberedCount >= vm->rememberedCapacity)
+  {
+    vm->rememberedCapacity = vm->rememberedCapacity == 0
+        ? 16 : vm->rememberedCapacity * 2;
+    vm->remembered = (Obj**)vm->config.reallocateFn(vm->remembered,
+        vm->rememberedCapacity * sizeof(Obj*), vm->config.userData);
+  }
+
+  obj->isRemembered = true;
+  vm->remembered[vm->rememberedCount++] = obj;
+}
+
 void wrenGrayValue(WrenVM* vm, Value value)
 {
   if (!IS_OBJ(value)) return;
@@ -1030,10 +1068,6 @@ static void blackenClass(WrenVM* vm, ObjClass* classObj)
   wrenGrayObj(vm, (Obj*)classObj->name);
 
   if(!IS_NULL(classObj->attributes)) wrenGrayObj(vm, AS_OBJ(classObj->attributes));
-
-  // Keep track of how much memory is still in use.
-  vm->bytesAllocated += sizeof(ObjClass);
-  vm->bytesAllocated += classObj->methods.capacity * sizeof(Method);
 }
 
 static void blackenClosure(WrenVM* vm, ObjClosure* closure)
@@ -1046,10 +1080,6 @@ static void blackenClosure(WrenVM* vm, ObjClosure* closure)
   {
     wrenGrayObj(vm, (Obj*)closure->upvalues[i]);
   }
-
-  // Keep track of how much memory is still in use.
-  vm->bytesAllocated += sizeof(ObjClosure);
-  vm->bytesAllocated += sizeof(ObjUpvalue*) * closure->fn->numUpvalues;
 }
 
 static void blackenFiber(WrenVM* vm, ObjFiber* fiber)
@@ -1078,10 +1108,9 @@ static void blackenFiber(WrenVM* vm, ObjFiber* fiber)
   wrenGrayObj(vm, (Obj*)fiber->caller);
   wrenGrayValue(vm, fiber->error);
 
-  // Keep track of how much memory is still in use.
-  vm->bytesAllocated += sizeof(ObjFiber);
-  vm->bytesAllocated += fiber->frameCapacity * sizeof(CallFrame);
-  vm->bytesAllocated += fiber->stackCapacity * sizeof(Value);
+  // The stack changes without going through write barriers, so every fiber
+  // that survives a collection is traced again by the following ones.
+  if (!fiber->obj.isRemembered) wrenRememberObj(vm, (Obj*)fiber);
 }
 
 static void blackenFn(WrenVM* vm, ObjFn* fn)
@@ -1089,23 +1118,23 @@ static void blackenFn(WrenVM* vm, ObjFn* fn)
   // Mark the constants.
   wrenGrayBuffer(vm, &fn->constants);
 
-  // Keep track of how much memory is still in use.
-  vm->bytesAllocated += sizeof(ObjFn);
-  vm->bytesAllocated += sizeof(uint8_t) * fn->code.capacity;
-  vm->bytesAllocated += sizeof(Value) * fn->constants.capacity;
-  
-  // The debug line number buffer.
-  vm->bytesAllocated += sizeof(int) * fn->code.capacity;
-  // TODO: What about the function name?
-}
-
-static void blackenForeign(WrenVM* vm, ObjForeign* foreign)
-{
-  // TODO: Keep track of how much memory the foreign object uses. We can store
-  // this in each foreign object, but it will balloon the size. We may not want
-  // that much overhead. One option would be to let the foreign class register
-  // a C function that returns a size for the object. That way the VM doesn't
-  // always have to explicitly store it.
+  // Mark the cached classes, so that a new class allocated at the address of
+  // a collected one can never hit the cache.
+  if (fn->callCaches != NULL)
+  {
+    for (int i = 0; i < fn->numCallCaches; i++)
+    {
+      CallCache* cache = &fn->callCaches[i];
+      for (int j = 0; j < CALL_CACHE_SIZE && cache->classes[j] != NULL; j++)
+      {
+        wrenGrayObj(vm, (Obj*)cache->classes[j]);
+        if (cache->methods[j].type == METHOD_BLOCK)
+        {
+          wrenGrayObj(vm, (Obj*)cache->methods[j].as.closure);
+        }
+      }
+    }
+  }
 }
 
 static void blackenInstance(WrenVM* vm, ObjInstance* instance)
@@ -1117,20 +1146,12 @@ static void blackenInstance(WrenVM* vm, ObjInstance* instance)
   {
     wrenGrayValue(vm, instance->fields[i]);
   }
-
-  // Keep track of how much memory is still in use.
-  vm->bytesAllocated += sizeof(ObjInstance);
-  vm->bytesAllocated += sizeof(Value) * instance->obj.classObj->numFields;
 }
 
 static void blackenList(WrenVM* vm, ObjList* list)
 {
   // Mark the elements.
   wrenGrayBuffer(vm, &list->elements);
-
-  // Keep track of how much memory is still in use.
-  vm->bytesAllocated += sizeof(ObjList);
-  vm->bytesAllocated += sizeof(Value) * list->elements.capacity;
 }
 
 static void blackenMap(WrenVM* vm, ObjMap* map)
@@ -1144,10 +1165,6 @@ static void blackenMap(WrenVM* vm, ObjMap* map)
     wrenGrayValue(vm, entry->key);
     wrenGrayValue(vm, entry->value);
   }
-
-  // Keep track of how much memory is still in use.
-  vm->bytesAllocated += sizeof(ObjMap);
-  vm->bytesAllocated += sizeof(MapEntry) * map->capacity;
 }
 
 static void blackenModule(WrenVM* vm, ObjModule* module)
@@ -1161,33 +1178,15 @@ static void blackenModule(WrenVM* vm, ObjModule* module)
   wrenBlackenSymbolTable(vm, &module->variableNames);
 
   wrenGrayObj(vm, (Obj*)module->name);
-
-  // Keep track of how much memory is still in use.
-  vm->bytesAllocated += sizeof(ObjModule);
-}
-
-static void blackenRange(WrenVM* vm, ObjRange* range)
-{
-  // Keep track of how much memory is still in use.
-  vm->bytesAllocated += sizeof(ObjRange);
-}
-
-static void blackenString(WrenVM* vm, ObjString* string)
-{
-  // Keep track of how much memory is still in use.
-  vm->bytesAllocated += sizeof(ObjString) + string->length + 1;
 }
 
 static void blackenUpvalue(WrenVM* vm, ObjUpvalue* upvalue)
 {
   // Mark the closed-over object (in case it is closed).
   wrenGrayValue(vm, upvalue->closed);
-
-  // Keep track of how much memory is still in use.
-  vm->bytesAllocated += sizeof(ObjUpvalue);
 }
 
-static void blackenObject(WrenVM* vm, Obj* obj)
+void wrenBlackenObject(WrenVM* vm, Obj* obj)
 {
 #if WREN_DEBUG_TRACE_MEMORY
   printf("mark ");
@@ -1202,14 +1201,17 @@ static void blackenObject(WrenVM* vm, Obj* obj)
     case OBJ_CLOSURE:  blackenClosure( vm, (ObjClosure*) obj); break;
     case OBJ_FIBER:    blackenFiber(   vm, (ObjFiber*)   obj); break;
     case OBJ_FN:       blackenFn(      vm, (ObjFn*)      obj); break;
-    case OBJ_FOREIGN:  blackenForeign( vm, (ObjForeign*) obj); break;
     case OBJ_INSTANCE: blackenInstance(vm, (ObjInstance*)obj); break;
     case OBJ_LIST:     blackenList(    vm, (ObjList*)    obj); break;
     case OBJ_MAP:      blackenMap(     vm, (ObjMap*)     obj); break;
     case OBJ_MODULE:   blackenModule(  vm, (ObjModule*)  obj); break;
-    case OBJ_RANGE:    blackenRange(   vm, (ObjRange*)   obj); break;
-    case OBJ_STRING:   blackenString(  vm, (ObjString*)  obj); break;
     case OBJ_UPVALUE:  blackenUpvalue( vm, (ObjUpvalue*) obj); break;
+
+    // These don't reference any other object.
+    case OBJ_FOREIGN:
+    case OBJ_RANGE:
+    case OBJ_STRING:
+      break;
   }
 }
 
@@ -1219,10 +1221,87 @@ void wrenBlackenObjects(WrenVM* vm)
   {
     // Pop an item from the gray stack.
     Obj* obj = vm->gray[--vm->grayCount];
-    blackenObject(vm, obj);
+    wrenBlackenObject(vm, obj);
   }
 }
 
+size_t wrenObjSize(Obj* obj)
+{
+  switch (obj->type)
+  {
+    case OBJ_CLASS:
+    {
+      ObjClass* classObj = (ObjClass*)obj;
+      return sizeof(ObjClass) + classObj->methods.capacity * sizeof(Method);
+    }
+
+    case OBJ_CLOSURE:
+    {
+      ObjClosure* closure = (ObjClosure*)obj;
+      return sizeof(ObjClosure) +
+             sizeof(ObjUpvalue*) * closure->fn->numUpvalues;
+    }
+
+    case OBJ_FIBER:
+    {
+      ObjFiber* fiber = (ObjFiber*)obj;
+      return sizeof(ObjFiber) +
+             fiber->frameCapacity * sizeof(CallFrame) +
+             fiber->stackCapacity * sizeof(Value);
+    }
+
+    case OBJ_FN:
+    {
+      ObjFn* fn = (ObjFn*)obj;
+
+      // The code and its debug line number buffer grow together.
+      // TODO: What about the function name?
+      return sizeof(ObjFn) +
+             (sizeof(uint8_t) + sizeof(int)) * fn->code.capacity +
+             sizeof(Value) * fn->constants.capacity +
+             sizeof(CallCache) * fn->numCallCaches;
+    }
+
+    case OBJ_FOREIGN:
+      // TODO: Keep track of how much memory the foreign object uses. We can
+      // store this in each foreign object, but it will balloon the size. We
+      // may not want that much overhead. One option would be to let the
+      // foreign class register a C function that returns a size for the
+      // object. That way the VM doesn't always have to explicitly store it.
+      return sizeof(ObjForeign);
+
+    case OBJ_INSTANCE:
+      return sizeof(ObjInstance) + sizeof(Value) * obj->classObj->numFields;
+
+    case OBJ_LIST:
+      return sizeof(ObjList) +
+             sizeof(Value) * ((ObjList*)obj)->elements.capacity;
+
+    case OBJ_MAP:
+      return sizeof(ObjMap) + sizeof(MapEntry) * ((ObjMap*)obj)->capacity;
+
+    case OBJ_MODULE:
+    {
+      ObjModule* module = (ObjModule*)obj;
+      return sizeof(ObjModule) +
+             sizeof(Value) * module->variables.capacity +
+             sizeof(ObjString*) * module->variableNames.capacity;
+    }
+
+    case OBJ_RANGE:
+      return sizeof(ObjRange);
+
+    case OBJ_STRING:
+      return sizeof(ObjString) + ((ObjString*)obj)->length + 1;
+
+    case OBJ_UPVALUE:
+      return sizeof(ObjUpvalue);
+  }
+
+  UNREACHABLE();
+  return 0;
+}
+
 void wrenFreeObj(WrenVM* vm, Obj* obj)
 {
 #if WREN_DEBUG_TRACE_MEMORY
@@ -1250,6 +1329,7 @@ void wrenFreeObj(WrenVM* vm, Obj* obj)
       ObjFn* fn = (ObjFn*)obj;
       wrenValueBufferClear(vm, &fn->constants);
       wrenByteBufferClear(vm, &fn->code);
+      DEALLOCATE(vm, fn->callCaches);
       wrenIntBufferClear(vm, &fn->debug->sourceLines);
       DEALLOCATE(vm, fn->debug->name);
       DEALLOCATE(vm, fn->debug);
@@ -104,6 +104,8 @@ typedef enum {
 
 typedef struct sObjClass ObjClass;
 
+typedef struct sCallCache CallCache;
+
 // Base struct for all heap-allocated objects.
 typedef struct sObj Obj;
 struct sObj
@@ -111,6 +113,13 @@ struct sObj
   ObjType type;
   bool isDark;
 
+  // Whether the object survived a collection and was moved from the nursery
+  // to the old generation.
+  bool isOld;
+
+  // Whether the object is in the VM's remembered set.
+  bool isRemembered;
+
   // The object's class.
   ObjClass* classObj;
 
@@ -264,6 +273,13 @@ typedef struct
   // handles a mismatch between number of parameters and arguments. This will
   // only be set for fns, and not ObjFns that represent methods or scripts.
   int arity;
+
+  // The inline caches of the method calls in [code], indexed by the second
+  // argument of each `CODE_CALL_*`. While compiling, this is NULL and
+  // [numCallCaches] counts the call sites.
+  CallCache* callCaches;
+  int numCallCaches;
+
   FnDebug* debug;
 } ObjFn;
 
@@ -370,7 +386,13 @@ typedef enum
   METHOD_BLOCK,
   
   // No method for the given symbol.
-  METHOD_NONE
+  METHOD_NONE,
+
+  // A user-defined method which only returns the field [as.field] of the
+  // receiver, or only stores its argument in that field. They are only found
+  // in inline caches, which run them without calling the method.
+  METHOD_FIELD_GETTER,
+  METHOD_FIELD_SETTER
 } MethodType;
 
 typedef struct
@@ -384,11 +406,24 @@ typedef struct
     Primitive primitive;
     WrenForeignMethodFn foreign;
     ObjClosure* closure;
+    int field;
   } as;
 } Method;
 
 DECLARE_BUFFER(Method, Method);
 
+// The number of receiver classes an inline cache remembers. Call sites that see
+// more classes than this look the remaining ones up in the class every time.
+#define CALL_CACHE_SIZE 4
+
+// The inline cache of a method call site. Entries are filled in order, so the
+// first NULL class ends the cached ones.
+struct sCallCache
+{
+  ObjClass* classes[CALL_CACHE_SIZE];
+  Method methods[CALL_CACHE_SIZE];
+};
+
 struct sObjClass
 {
   Obj obj;
@@ -778,6 +813,10 @@ void wrenGrayObj(WrenVM* vm, Obj* obj);
 // during the sweep phase of a garbage collection.
 void wrenGrayValue(WrenVM* vm, Value value);
 
+// Adds [obj] to the VM's remembered set, the objects a collection traces even
+// when they are old or already marked. See [wrenWriteBarrier].
+void wrenRememberObj(WrenVM* vm, Obj* obj);
+
 // Mark the values in [buffer] as reachable and still in use. This should only
 // be called during the sweep phase of a garbage collection.
 void wrenGrayBuffer(WrenVM* vm, ValueBuffer* buffer);
@@ -787,6 +826,17 @@ void wrenGrayBuffer(WrenVM* vm, ValueBuffer* buffer);
 // (in use and fully traversed).
 void wrenBlackenObjects(WrenVM* vm);
 
+// Marks all of the objects [obj] references. Unlike [wrenBlackenObjects], this
+// also traverses objects that are already dark, to trace them again after
+// they changed.
+void wrenBlackenObject(WrenVM* vm, Obj* obj);
+
+// Returns the number of bytes of memory [obj] uses.
+//
+// For instances and closures, this reads their class and function, so it must
+// be called before those are freed.
+size_t wrenObjSize(Obj* obj);
+
 // Releases all memory owned by [obj], including [obj] itself.
 void wrenFreeObj(WrenVM* vm, Obj* obj);
 
@@ -1,5 +1,6 @@
 #include <stdarg.h>
 #include <string.h>
+#include <time.h>
 
 #include "wren.h"
 #include "wren_common.h"
@@ -17,7 +18,6 @@
 #endif
 
 #if WREN_DEBUG_TRACE_MEMORY || WREN_DEBUG_TRACE_GC
-  #include <time.h>
   #include <stdio.h>
 #endif
 
@@ -50,6 +50,9 @@ void wrenInitConfiguration(WrenConfiguration* config)
   config->bindForeignClassFn = NULL;
   config->writeFn = NULL;
   config->errorFn = NULL;
+  config->gcFn = NULL;
+  config->nurserySize = 1024 * 256;
+  config->sliceSizePercent = 200;
   config->initialHeapSize = 1024 * 1024 * 10;
   config->minHeapSize = 1024 * 1024;
   config->heapGrowthPercent = 50;
@@ -100,17 +103,23 @@ void wrenFreeVM(WrenVM* vm)
 {
   ASSERT(vm->methodNames.count > 0, "VM appears to have already been freed.");
   
-  // Free all of the GC objects.
-  Obj* obj = vm->first;
-  while (obj != NULL)
+  // Free all of the GC objects, young and old.
+  Obj* lists[] = { vm->first, vm->tenured };
+  for (int i = 0; i < 2; i++)
   {
-    Obj* next = obj->next;
-    wrenFreeObj(vm, obj);
-    obj = next;
+    Obj* obj = lists[i];
+    while (obj != NULL)
+    {
+      Obj* next = obj->next;
+      wrenFreeObj(vm, obj);
+      obj = next;
+    }
   }
 
-  // Free up the GC gray set.
+  // Free up the GC gray and remembered sets.
   vm->gray = (Obj**)vm->config.reallocateFn(vm->gray, 0, vm->config.userData);
+  vm->remembered = (Obj**)vm->config.reallocateFn(vm->remembered, 0,
+                                                  vm->config.userData);
 
   // Tell the user if they didn't free any handles. We don't want to just free
   // them here because the host app may still have pointers to them that they
@@ -122,27 +131,9 @@ void wrenFreeVM(WrenVM* vm)
   DEALLOCATE(vm, vm);
 }
 
-void wrenCollectGarbage(WrenVM* vm)
+// Grays every root of the object graph.
+static void grayRoots(WrenVM* vm)
 {
-#if WREN_DEBUG_TRACE_MEMORY || WREN_DEBUG_TRACE_GC
-  printf("-- gc --\n");
-
-  size_t before = vm->bytesAllocated;
-  double startTime = (double)clock() / CLOCKS_PER_SEC;
-#endif
-
-  // Mark all reachable objects.
-
-  // Reset this. As we mark objects, their size will be counted again so that
-  // we can track how much memory is in use without needing to know the size
-  // of each *freed* object.
-  //
-  // This is important because when freeing an unmarked object, we don't always
-  // know how much memory it is using. For example, when freeing an instance,
-  // we need to know its class to know how big it is, but its class may have
-  // already been freed.
-  vm->bytesAllocated = 0;
-
   wrenGrayObj(vm, (Obj*)vm->modules);
 
   // Temporary roots.
@@ -167,47 +158,303 @@ void wrenCollectGarbage(WrenVM* vm)
 
   // Method names.
   wrenBlackenSymbolTable(vm, &vm->methodNames);
+}
+
+// Traces every object of the remembered set again.
+static void traceRemembered(WrenVM* vm)
+{
+  // Blackening a remembered object never adds to the set, so it can be walked
+  // in place.
+  for (int i = 0; i < vm->rememberedCount; i++)
+  {
+    wrenBlackenObject(vm, vm->remembered[i]);
+  }
+}
+
+// Empties the remembered set, except for the fibers if [keepFibers].
+static void forgetRemembered(WrenVM* vm, bool keepFibers)
+{
+  int count = 0;
+  for (int i = 0; i < vm->rememberedCount; i++)
+  {
+    Obj* obj = vm->remembered[i];
+    if (keepFibers && obj->type == OBJ_FIBER)
+    {
+      vm->remembered[count++] = obj;
+    }
+    else
+    {
+      obj->isRemembered = false;
+    }
+  }
 
-  // Now that we have grayed the roots, do a depth-first search over all of the
-  // reachable objects.
+  vm->rememberedCount = count;
+}
+
+// Frees the unreachable objects of the nursery and moves the others to the
+// old generation. This can happen while the old generation is being swept.
+static void collectNursery(WrenVM* vm)
+{
+  GCPhase phase = vm->gcPhase;
+  vm->gcPhase = GC_MINOR;
+
+  grayRoots(vm);
+  traceRemembered(vm);
   wrenBlackenObjects(vm);
 
-  // Collect the white objects.
-  Obj** obj = &vm->first;
-  while (*obj != NULL)
+  // Walk the nursery from the newest object to the oldest, so that instances
+  // and closures are freed before their class and function, which their size
+  // depends on. The survivors keep their order at the head of the old
+  // generation.
+  Obj* survivors = NULL;
+  Obj** tail = &survivors;
+  Obj* obj = vm->first;
+  while (obj != NULL)
   {
-    if (!((*obj)->isDark))
+    Obj* next = obj->next;
+    if (obj->isDark)
+    {
+      obj->isDark = false;
+      *tail = obj;
+      tail = &obj->next;
+    }
+    else
+    {
+      vm->bytesAllocated -= wrenObjSize(obj);
+      wrenFreeObj(vm, obj);
+    }
+    obj = next;
+  }
+
+  // [tail] still points at the local list head when nothing survived, and
+  // must not be kept then.
+  bool hadSurvivors = tail != &survivors;
+  *tail = vm->tenured;
+  vm->tenured = survivors;
+  vm->first = NULL;
+
+  // The survivors are unmarked, so a sweep which hasn't started yet must skip
+  // them.
+  if (vm->sweep == &vm->tenured && hadSurvivors) vm->sweep = tail;
+
+  // There are no young objects left for the old ones to reference.
+  forgetRemembered(vm, true);
+
+  vm->gcStats.numMinorCollections++;
+  vm->gcPhase = phase;
+}
+
+// Starts marking the whole heap. This comes right after a minor collection, so
+// every object is in the old generation.
+static void startMarking(WrenVM* vm)
+{
+  // Marking traces every object, so the remembered set is only needed for
+  // those that change after they are marked. The fibers join it again as they
+  // are marked.
+  forgetRemembered(vm, false);
+
+  vm->gcPhase = GC_MARK;
+  grayRoots(vm);
+}
+
+// Blackens gray objects until about [budget] bytes of them have been traced.
+static void markSlice(WrenVM* vm, size_t budget)
+{
+  // Trace the objects that changed after they were marked, except for the
+  // fibers, which are traced again when marking finishes.
+  int count = 0;
+  for (int i = 0; i < vm->rememberedCount; i++)
+  {
+    Obj* obj = vm->remembered[i];
+    if (obj->type == OBJ_FIBER)
+    {
+      vm->remembered[count++] = obj;
+    }
+    else
+    {
+      obj->isRemembered = false;
+      wrenBlackenObject(vm, obj);
+    }
+  }
+  vm->rememberedCount = count;
+
+  size_t traced = 0;
+  while (vm->grayCount > 0 && traced < budget)
+  {
+    Obj* obj = vm->gray[--vm->grayCount];
+    wrenBlackenObject(vm, obj);
+    traced += wrenObjSize(obj);
+  }
+}
+
+// Marks whatever the program made reachable while the heap was marked, then
+// starts sweeping.
+static void finishMarking(WrenVM* vm)
+{
+  grayRoots(vm);
+  traceRemembered(vm);
+  wrenBlackenObjects(vm);
+
+  // Every object reached is now old, so only the fibers need remembering.
+  forgetRemembered(vm, true);
+
+  // The live bytes are counted again as they are swept.
+  vm->bytesAllocated = 0;
+  vm->sweep = &vm->tenured;
+  vm->gcPhase = GC_SWEEP;
+}
+
+// Sweeps the old generation until about [budget] bytes of objects have been
+// visited. Returns true when the whole heap has been collected.
+static bool sweepSlice(WrenVM* vm, size_t budget)
+{
+  // The old generation is ordered from the newest object to the oldest too,
+  // so the sizes of the unreachable objects can still be read.
+  size_t swept = 0;
+  while (*vm->sweep != NULL && swept < budget)
+  {
+    Obj* obj = *vm->sweep;
+    size_t size = wrenObjSize(obj);
+    swept += size;
+
+    if (!obj->isDark)
     {
       // This object wasn't reached, so remove it from the list and free it.
-      Obj* unreached = *obj;
-      *obj = unreached->next;
-      wrenFreeObj(vm, unreached);
+      *vm->sweep = obj->next;
+      wrenFreeObj(vm, obj);
     }
     else
     {
       // This object was reached, so unmark it (for the next GC) and move on to
       // the next.
-      (*obj)->isDark = false;
-      obj = &(*obj)->next;
+      obj->isDark = false;
+      vm->bytesAllocated += size;
+      vm->sweep = &obj->next;
     }
   }
 
+  if (*vm->sweep != NULL) return false;
+
   // Calculate the next gc point, this is the current allocation plus
   // a configured percentage of the current allocation.
   vm->nextGC = vm->bytesAllocated + ((vm->bytesAllocated * vm->config.heapGrowthPercent) / 100);
   if (vm->nextGC < vm->config.minHeapSize) vm->nextGC = vm->config.minHeapSize;
 
+  vm->sweep = NULL;
+  vm->gcStats.numMajorCollections++;
+  vm->gcPhase = GC_IDLE;
+  return true;
+}
+
+static double gcClock()
+{
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+// Updates the statistics with a pause of [type] which started at [startTime]
+// and reports it.
+static void endPause(WrenVM* vm, WrenGCPauseType type, double startTime)
+{
+  WrenGCStats* stats = &vm->gcStats;
+  stats->pauseType = type;
+  stats->pauseTime = gcClock() - startTime;
+  if (stats->pauseTime > stats->maxPauseTime)
+  {
+    stats->maxPauseTime = stats->pauseTime;
+  }
+  stats->totalPauseTime += stats->pauseTime;
+  stats->numPauses++;
+  stats->bytesAllocated = vm->bytesAllocated;
+
 #if WREN_DEBUG_TRACE_MEMORY || WREN_DEBUG_TRACE_GC
-  double elapsed = ((double)clock() / CLOCKS_PER_SEC) - startTime;
+  static const char* pauseNames[] = {
+    "minor", "mark", "remark", "sweep", "full"
+  };
   // Explicit cast because size_t has different sizes on 32-bit and 64-bit and
   // we need a consistent type for the format string.
-  printf("GC %lu before, %lu after (%lu collected), next at %lu. Took %.3fms.\n",
-         (unsigned long)before,
+  printf("GC %s, %lu after, next at %lu. Took %.3fms.\n",
+         pauseNames[type],
          (unsigned long)vm->bytesAllocated,
-         (unsigned long)(before - vm->bytesAllocated),
          (unsigned long)vm->nextGC,
-         elapsed*1000.0);
+         stats->pauseTime * 1000.0);
 #endif
+
+  if (vm->config.gcFn != NULL) vm->config.gcFn(vm, stats);
+}
+
+// Runs the next pause of the collector: a minor collection, or a slice of the
+// collection of the whole heap in progress.
+static void stepGarbageCollector(WrenVM* vm)
+{
+  double startTime = gcClock();
+  // Every slice does some work, so that the collection always finishes.
+  size_t budget = vm->config.nurserySize * vm->config.sliceSizePercent / 100;
+  if (budget == 0) budget = 1;
+  vm->nurseryBytes = 0;
+
+  WrenGCPauseType type;
+  switch (vm->gcPhase)
+  {
+    case GC_MARK:
+      if (vm->grayCount > 0)
+      {
+        markSlice(vm, budget);
+        type = WREN_GC_MARK;
+      }
+      else
+      {
+        finishMarking(vm);
+        type = WREN_GC_REMARK;
+      }
+      break;
+
+    case GC_SWEEP:
+      // Keep collecting the nursery too, so that it doesn't grow for as long
+      // as the sweep takes.
+      collectNursery(vm);
+      sweepSlice(vm, budget);
+      type = WREN_GC_SWEEP;
+      break;
+
+    default:
+      collectNursery(vm);
+      type = WREN_GC_MINOR;
+
+    #if WREN_DEBUG_GC_STRESS
+      startMarking(vm);
+    #else
+      if (vm->bytesAllocated > vm->nextGC) startMarking(vm);
+    #endif
+      break;
+  }
+
+  endPause(vm, type, startTime);
+}
+
+void wrenCollectGarbage(WrenVM* vm)
+{
+  double startTime = gcClock();
+  vm->nurseryBytes = 0;
+
+  // Finish the collection in progress, if any, then collect everything at
+  // once.
+  if (vm->gcPhase == GC_SWEEP) sweepSlice(vm, (size_t)-1);
+  if (vm->gcPhase == GC_IDLE)
+  {
+    collectNursery(vm);
+    startMarking(vm);
+  }
+
+  wrenBlackenObjects(vm);
+  finishMarking(vm);
+  sweepSlice(vm, (size_t)-1);
+
+  endPause(vm, WREN_GC_FULL, startTime);
+}
+
+void wrenGetGCStats(WrenVM* vm, WrenGCStats* stats)
+{
+  *stats = vm->gcStats;
 }
 
 void* wrenReallocate(WrenVM* vm, void* memory, size_t oldSize, size_t newSize)
@@ -221,16 +468,20 @@ void* wrenReallocate(WrenVM* vm, void* memory, size_t oldSize, size_t newSize)
 
   // If new bytes are being allocated, add them to the total count. If objects
   // are being completely deallocated, we don't track that (since we don't
-  // track the original size). Instead, that will be handled while marking
-  // during the next GC.
+  // track the original size). Instead, the collector subtracts the size of the
+  // objects it frees, and counts the live ones again when sweeping.
   vm->bytesAllocated += newSize - oldSize;
+  if (newSize > oldSize) vm->nurseryBytes += newSize - oldSize;
 
 #if WREN_DEBUG_GC_STRESS
   // Since collecting calls this function to free things, make sure we don't
   // recurse.
-  if (newSize > 0) wrenCollectGarbage(vm);
+  if (newSize > 0) stepGarbageCollector(vm);
 #else
-  if (newSize > 0 && vm->bytesAllocated > vm->nextGC) wrenCollectGarbage(vm);
+  if (newSize > 0 && vm->nurseryBytes > vm->config.nurserySize)
+  {
+    stepGarbageCollector(vm);
+  }
 #endif
 
   return vm->config.reallocateFn(memory, newSize, vm->config.userData);
@@ -284,7 +535,7 @@ static ObjUpvalue* captureUpvalue(WrenVM* vm, ObjFiber* fiber, Value* local)
 
 // Closes any open upvalues that have been created for stack slots at [last]
 // and above.
-static void closeUpvalues(ObjFiber* fiber, Value* last)
+static void closeUpvalues(WrenVM* vm, ObjFiber* fiber, Value* last)
 {
   while (fiber->openUpvalues != NULL &&
          fiber->openUpvalues->value >= last)
@@ -294,6 +545,7 @@ static void closeUpvalues(ObjFiber* fiber, Value* last)
     // Move the value into the upvalue itself and point the upvalue to it.
     upvalue->closed = *upvalue->value;
     upvalue->value = &upvalue->closed;
+    wrenWriteBarrier(vm, &upvalue->obj, upvalue->closed);
 
     // Remove it from the open upvalue list.
     fiber->openUpvalues = upvalue->next;
@@ -375,7 +627,7 @@ static void bindMethod(WrenVM* vm, int methodType, int symbol,
     method.type = METHOD_BLOCK;
 
     // Patch up the bytecode now that we know the superclass.
-    wrenBindMethodCode(classObj, method.as.closure->fn);
+    wrenBindMethodCode(vm, classObj, method.as.closure->fn);
   }
 
   wrenBindMethod(vm, classObj, symbol, method);
@@ -625,7 +877,8 @@ static void endClass(WrenVM* vm)
   vm->fiber->stackTop -= 2;
 
   ObjClass* classObj = AS_CLASS(classValue);
-    classObj->attributes = attributes;
+  classObj->attributes = attributes;
+  wrenWriteBarrier(vm, &classObj->obj, attributes);
 }
 
 // Creates a new class.
@@ -821,6 +1074,32 @@ inline static bool checkArity(WrenVM* vm, Value value, int numArgs)
 }
 
 
+// Replaces [method], found for a call with [numArgs] on [receiver], with a
+// field accessor when all it does is returning or storing a field.
+static void specializeCachedMethod(Value receiver, int numArgs, Method* method)
+{
+  if (method->type != METHOD_BLOCK || !IS_INSTANCE(receiver)) return;
+
+  ObjFn* fn = method->as.closure->fn;
+  const uint8_t* code = fn->code.data;
+
+  // `name { _field }`
+  if (numArgs == 1 && fn->code.count >= 3 &&
+      code[0] == CODE_LOAD_FIELD_THIS && code[2] == CODE_RETURN)
+  {
+    method->type = METHOD_FIELD_GETTER;
+    method->as.field = code[1];
+  }
+
+  // `name=(value) { _field = value }`
+  if (numArgs == 2 && fn->code.count >= 4 && code[0] == CODE_LOAD_LOCAL_1 &&
+      code[1] == CODE_STORE_FIELD_THIS && code[3] == CODE_RETURN)
+  {
+    method->type = METHOD_FIELD_SETTER;
+    method->as.field = code[2];
+  }
+}
+
 // The main bytecode interpreter loop. This is where the magic happens. It is
 // also, as you can imagine, highly performance critical.
 static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
@@ -978,6 +1257,7 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
       ObjClass* classObj;
 
       Method* method;
+      CallCache* cache;
 
     CASE_CODE(CALL_0):
     CASE_CODE(CALL_1):
@@ -999,10 +1279,29 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
       // Add one for the implicit receiver argument.
       numArgs = instruction - CODE_CALL_0 + 1;
       symbol = READ_SHORT();
+      cache = &fn->callCaches[READ_SHORT()];
 
       // The receiver is the first argument.
       args = fiber->stackTop - numArgs;
       classObj = wrenGetClassInline(vm, args[0]);
+
+    #if WREN_INLINE_CACHE
+      // Most call sites only ever see one receiver class, or very few.
+      if (cache->classes[0] == classObj)
+      {
+        method = &cache->methods[0];
+        goto invokeMethod;
+      }
+
+      for (int i = 1; i < CALL_CACHE_SIZE && cache->classes[i] != NULL; i++)
+      {
+        if (cache->classes[i] == classObj)
+        {
+          method = &cache->methods[i];
+          goto invokeMethod;
+        }
+      }
+    #endif
       goto completeCall;
 
     CASE_CODE(SUPER_0):
@@ -1029,8 +1328,10 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
       // The receiver is the first argument.
       args = fiber->stackTop - numArgs;
 
-      // The superclass is stored in a constant.
+      // The superclass is stored in a constant. As the class is the same for
+      // every call, there is nothing to cache.
       classObj = AS_CLASS(fn->constants.data[READ_SHORT()]);
+      cache = NULL;
       goto completeCall;
 
     completeCall:
@@ -1042,6 +1343,28 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
         RUNTIME_ERROR();
       }
 
+    #if WREN_INLINE_CACHE
+      if (cache != NULL)
+      {
+        for (int i = 0; i < CALL_CACHE_SIZE; i++)
+        {
+          if (cache->classes[i] == NULL)
+          {
+            cache->classes[i] = classObj;
+            cache->methods[i] = *method;
+            specializeCachedMethod(args[0], numArgs, &cache->methods[i]);
+            wrenWriteBarrier(vm, &fn->obj, OBJ_VAL(classObj));
+            if (method->type == METHOD_BLOCK)
+            {
+              wrenWriteBarrier(vm, &fn->obj, OBJ_VAL(method->as.closure));
+            }
+            break;
+          }
+        }
+      }
+
+    invokeMethod:
+    #endif
       switch (method->type)
       {
         case METHOD_PRIMITIVE:
@@ -1084,6 +1407,17 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
           LOAD_FRAME();
           break;
 
+        case METHOD_FIELD_GETTER:
+          args[0] = AS_INSTANCE(args[0])->fields[method->as.field];
+          break;
+
+        case METHOD_FIELD_SETTER:
+          AS_INSTANCE(args[0])->fields[method->as.field] = args[1];
+          wrenWriteBarrier(vm, AS_OBJ(args[0]), args[1]);
+          args[0] = args[1];
+          fiber->stackTop--;
+          break;
+
         case METHOD_NONE:
           UNREACHABLE();
           break;
@@ -1100,8 +1434,9 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
 
     CASE_CODE(STORE_UPVALUE):
     {
-      ObjUpvalue** upvalues = frame->closure->upvalues;
-      *upvalues[READ_BYTE()]->value = PEEK();
+      ObjUpvalue* upvalue = frame->closure->upvalues[READ_BYTE()];
+      *upvalue->value = PEEK();
+      wrenWriteBarrier(vm, &upvalue->obj, PEEK());
       DISPATCH();
     }
 
@@ -1111,6 +1446,7 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
 
     CASE_CODE(STORE_MODULE_VAR):
       fn->module->variables.data[READ_SHORT()] = PEEK();
+      wrenWriteBarrier(vm, &fn->module->obj, PEEK());
       DISPATCH();
 
     CASE_CODE(STORE_FIELD_THIS):
@@ -1121,6 +1457,7 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
       ObjInstance* instance = AS_INSTANCE(receiver);
       ASSERT(field < instance->obj.classObj->numFields, "Out of bounds field.");
       instance->fields[field] = PEEK();
+      wrenWriteBarrier(vm, &instance->obj, PEEK());
       DISPATCH();
     }
 
@@ -1143,6 +1480,7 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
       ObjInstance* instance = AS_INSTANCE(receiver);
       ASSERT(field < instance->obj.classObj->numFields, "Out of bounds field.");
       instance->fields[field] = PEEK();
+      wrenWriteBarrier(vm, &instance->obj, PEEK());
       DISPATCH();
     }
 
@@ -1208,7 +1546,7 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
 
     CASE_CODE(CLOSE_UPVALUE):
       // Close the upvalue for the local if we have one.
-      closeUpvalues(fiber, fiber->stackTop - 1);
+      closeUpvalues(vm, fiber, fiber->stackTop - 1);
       DROP();
       DISPATCH();
 
@@ -1218,7 +1556,7 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
       fiber->numFrames--;
 
       // Close any upvalues still in scope.
-      closeUpvalues(fiber, stackStart);
+      closeUpvalues(vm, fiber, stackStart);
 
       // If the fiber is complete, end it.
       if (fiber->numFrames == 0)
@@ -1291,6 +1629,9 @@ static WrenInterpretResult runInterpreter(WrenVM* vm, register ObjFiber* fiber)
           // Use the same upvalue as the current call frame.
           closure->upvalues[i] = frame->closure->upvalues[index];
         }
+
+        // Capturing can run the collector and promote the closure.
+        wrenWriteBarrier(vm, &closure->obj, OBJ_VAL(closure->upvalues[i]));
       }
       DISPATCH();
     }
@@ -1431,9 +1772,15 @@ WrenHandle* wrenMakeCallHandle(WrenVM* vm, const char* signature)
   wrenByteBufferWrite(vm, &fn->code, (uint8_t)(CODE_CALL_0 + numParams));
   wrenByteBufferWrite(vm, &fn->code, (method >> 8) & 0xff);
   wrenByteBufferWrite(vm, &fn->code, method & 0xff);
+  wrenByteBufferWrite(vm, &fn->code, 0);
+  wrenByteBufferWrite(vm, &fn->code, 0);
   wrenByteBufferWrite(vm, &fn->code, CODE_RETURN);
   wrenByteBufferWrite(vm, &fn->code, CODE_END);
-  wrenIntBufferFill(vm, &fn->debug->sourceLines, 0, 5);
+  wrenIntBufferFill(vm, &fn->debug->sourceLines, 0, 7);
+
+  fn->callCaches = ALLOCATE(vm, CallCache);
+  memset(fn->callCaches, 0, sizeof(CallCache));
+  fn->numCallCaches = 1;
   wrenFunctionBindName(vm, fn, signature, signatureLength);
 
   return value;
@@ -1569,7 +1916,10 @@ int wrenDeclareVariable(WrenVM* vm, ObjModule* module, const char* name,
   // variable is first used. We'll use that later to report an error on the
   // right line.
   wrenValueBufferWrite(vm, &module->variables, NUM_VAL(line));
-  return wrenSymbolTableAdd(vm, &module->variableNames, name, length);
+  int symbol = wrenSymbolTableAdd(vm, &module->variableNames, name, length);
+  wrenWriteBarrier(vm, &module->obj,
+                   OBJ_VAL(module->variableNames.data[symbol]));
+  return symbol;
 }
 
 int wrenDefineVariable(WrenVM* vm, ObjModule* module, const char* name,
@@ -1586,7 +1936,10 @@ int wrenDefineVariable(WrenVM* vm, ObjModule* module, const char* name,
   {
     // Brand new variable.
     symbol = wrenSymbolTableAdd(vm, &module->variableNames, name, length);
+    wrenWriteBarrier(vm, &module->obj,
+                     OBJ_VAL(module->variableNames.data[symbol]));
     wrenValueBufferWrite(vm, &module->variables, value);
+    wrenWriteBarrier(vm, &module->obj, value);
   }
   else if (IS_NUM(module->variables.data[symbol]))
   {
@@ -1594,6 +1947,7 @@ int wrenDefineVariable(WrenVM* vm, ObjModule* module, const char* name,
     // Now we have a real definition.
     if(line) *line = (int)AS_NUM(module->variables.data[symbol]);
     module->variables.data[symbol] = value;
+    wrenWriteBarrier(vm, &module->obj, value);
 
 	// If this was a localname we want to error if it was 
 	// referenced before this definition.
@@ -1824,6 +2178,7 @@ void wrenSetListElement(WrenVM* vm, int listSlot, int index, int elementSlot)
   ASSERT(usedIndex != UINT32_MAX, "Index out of bounds.");
   
   list->elements.data[usedIndex] = vm->apiStack[elementSlot];
+  wrenWriteBarrier(vm, &list->obj, vm->apiStack[elementSlot]);
 }
 
 void wrenInsertInList(WrenVM* vm, int listSlot, int index, int elementSlot)
@@ -17,6 +17,22 @@ typedef enum
   #undef OPCODE
 } Code;
 
+// What the garbage collector is doing between two pauses.
+typedef enum
+{
+  // Waiting for the nursery to fill up.
+  GC_IDLE,
+
+  // Collecting the nursery. The program never runs during this phase.
+  GC_MINOR,
+
+  // Marking the whole heap incrementally.
+  GC_MARK,
+
+  // Sweeping the old generation incrementally.
+  GC_SWEEP
+} GCPhase;
+
 // A handle to a value, basically just a linked list of extra GC roots.
 //
 // Note that even non-heap-allocated values can be stored here.
@@ -64,18 +80,45 @@ struct WrenVM
   // were freed since the last GC.
   size_t bytesAllocated;
 
-  // The number of total allocated bytes that will trigger the next GC.
+  // The number of total allocated bytes that will start the next collection
+  // of the whole heap.
   size_t nextGC;
 
-  // The first object in the linked list of all currently allocated objects.
+  // The number of bytes allocated since the last pause of the collector.
+  size_t nurseryBytes;
+
+  // The first object in the linked list of the objects of the nursery, those
+  // allocated since the last minor collection.
   Obj* first;
 
+  // The first object in the linked list of the objects of the old generation,
+  // those that survived a collection.
+  Obj* tenured;
+
+  // What the collector is doing, and while sweeping, the link to the next old
+  // object to sweep.
+  GCPhase gcPhase;
+  Obj** sweep;
+
   // The "gray" set for the garbage collector. This is the stack of unprocessed
   // objects while a garbage collection pass is in process.
   Obj** gray;
   int grayCount;
   int grayCapacity;
 
+  // The "remembered" set of the garbage collector. Between collections, these
+  // are the old objects that may reference young ones, which minor collections
+  // trace in addition to the roots. While marking incrementally, these are the
+  // objects which changed after they were marked, to trace again. Every fiber
+  // that survived a collection is also in it, since a stack changes without
+  // any write barrier.
+  Obj** remembered;
+  int rememberedCount;
+  int rememberedCapacity;
+
+  // The pause time statistics reported by [wrenGetGCStats].
+  WrenGCStats gcStats;
+
   // The list of temporary roots. This is for temporary or new objects that are
   // not otherwise reachable but should not be collected.
   //
@@ -236,6 +279,25 @@ static inline ObjClass* wrenGetClassInline(WrenVM* vm, Value value)
   return NULL;
 }
 
+// Tells the garbage collector that [value] was stored into [obj].
+//
+// This must follow every store of a value into an object that may already
+// have survived a collection or been marked, except into a fiber's stack, and
+// come before anything else is allocated.
+// Without it, a minor collection could miss a young object only an old one
+// references, and an incremental one an object only a marked one references.
+static inline void wrenWriteBarrier(WrenVM* vm, Obj* obj, Value value)
+{
+  if (!IS_OBJ(value) || obj->isRemembered) return;
+
+  Obj* target = AS_OBJ(value);
+  if (vm->gcPhase == GC_MARK ? obj->isDark && !target->isDark
+                             : obj->isOld && !target->isOld)
+  {
+    wrenRememberObj(vm, obj);
+  }
+}
+
 // Returns `true` if [name] is a local variable name (starts with a lowercase
 // letter).
 static inline bool wrenIsLocalName(const char* name)
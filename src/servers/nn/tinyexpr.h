@@ -79,6 +79,23 @@ void te_print(const te_expr *n);
 void te_free(te_expr *n);
 
 
+/* Flat bytecode of an expression, for evaluating it over many rows. */
+typedef struct te_program te_program;
+
+/* Flattens a compiled expression into bytecode. */
+/* Variable i of variables takes its values from column i in te_eval_batch, */
+/* any other bound variable keeps one value for the whole call. */
+/* Returns NULL on error. */
+te_program *te_compile_program(const te_expr *n, const te_variable *variables, int var_count);
+
+/* Evaluates the program for count rows, out[row] from columns[i][row]. */
+void te_eval_batch(const te_program *p, const double *const *columns, int count, double *out);
+
+/* Frees the program. */
+/* This is safe to call on NULL pointers. */
+void te_free_program(te_program *p);
+
+
 #ifdef __cplusplus
 }
 #endif
@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <functional>
 #include <cmath>
+#include <vector>
 #include <time.h>
 
 // OpenNN includes
@@ -440,6 +441,24 @@ const unsigned int& EvolutionaryAlgorithm::get_display_period(void) const
 }
 
 
+// unsigned int count_threads_number(void) const method
+
+/// This method returns the number of threads which evaluate the individuals of the population. 
+/// It is one if no thread pool has been constructed. 
+
+unsigned int EvolutionaryAlgorithm::count_threads_number(void) const
+{
+   if(thread_pool_pointer)
+   {
+      return(thread_pool_pointer->count_threads_number());
+   }
+   else
+   {
+      return(1);
+   }
+}
+
+
 
 // const bool& get_reserve_population_history(void) const method
 
@@ -1569,6 +1588,32 @@ void EvolutionaryAlgorithm::set_display_period(const unsigned int& new_display_p
 }
 
 
+// void set_threads_number(const unsigned int&) method
+
+/// This method sets the number of threads which evaluate the individuals of the population. 
+/// Each thread evaluates its individuals on its own copy of the neural network and the performance functional, 
+/// so the performance terms must not be modified by their evaluation. 
+/// @param new_threads_number Number of threads, including the calling one. 
+/// A value of one, or zero, deletes the thread pool, so that the population is evaluated on the calling thread. 
+
+void EvolutionaryAlgorithm::set_threads_number(const unsigned int& new_threads_number)
+{
+   if(new_threads_number == count_threads_number())
+   {
+      return;
+   }
+
+   if(new_threads_number > 1)
+   {
+      thread_pool_pointer.reset(new ThreadPool(new_threads_number));
+   }
+   else
+   {
+      thread_pool_pointer.reset();
+   }
+}
+
+
 
 // Vector<double> calculate_population_norm(void) const method
 
@@ -2265,6 +2310,8 @@ void EvolutionaryAlgorithm::evolve_population(void)
 
 /// This method evaluates the performance functional of all individuals in the population. 
 /// Results are stored in the performance vector.
+/// If a thread pool has been constructed, the individuals are evaluated concurrently, 
+/// each thread using its own copies of the neural network and the performance functional. 
 
 void EvolutionaryAlgorithm::evaluate_population(void)
 {
@@ -2308,18 +2355,54 @@ void EvolutionaryAlgorithm::evaluate_population(void)
 
    const unsigned int parameters_number = neural_network_pointer->count_parameters_number();
 
-   Vector<double> individual(parameters_number);
-
    // Evaluate performance functional for all individuals
 
-   unsigned int population_size = get_population_size();
+   const unsigned int population_size = get_population_size();
 
-   for(unsigned int i = 0; i < population_size; i++)
+   if(!thread_pool_pointer || population_size <= 1)
    {
-      individual = get_individual(i);
+      Vector<double> individual(parameters_number);
 
-      performance[i] = performance_functional_pointer->calculate_evaluation(individual);
-      
+      for(unsigned int i = 0; i < population_size; i++)
+      {
+         std::copy(population[i], population[i] + parameters_number, individual.begin());
+
+         performance[i] = performance_functional_pointer->calculate_evaluation(individual);
+      }
+   }
+   else
+   {
+      const unsigned int threads_number = thread_pool_pointer->count_threads_number();
+
+      std::vector<NeuralNetwork> neural_networks(threads_number, *neural_network_pointer);
+
+      std::vector<PerformanceFunctional> performance_functionals(threads_number, *performance_functional_pointer);
+
+      std::vector< Vector<double> > individuals(threads_number, Vector<double>(parameters_number));
+
+      for(unsigned int i = 0; i < threads_number; i++)
+      {
+         performance_functionals[i].set_neural_network_pointer(&neural_networks[i]);
+
+         // Individuals are the unit of parallelism, so each evaluation runs on a single thread
+
+         performance_functionals[i].set_threads_number(1);
+      }
+
+      thread_pool_pointer->run(population_size, [&](const unsigned int& individual_index, const unsigned int& thread_index)
+      {
+         Vector<double>& individual = individuals[thread_index];
+
+         std::copy(population[individual_index], population[individual_index] + parameters_number, individual.begin());
+
+         neural_networks[thread_index].set_parameters(individual);
+
+         performance[individual_index] = performance_functionals[thread_index].calculate_evaluation();
+      });
+   }
+
+   for(unsigned int i = 0; i < population_size; i++)
+   {
       if(!(performance[i] > -1.0e99 && performance[i] < 1.0e99))
       {
          std::ostringstream buffer;
@@ -2338,34 +2421,44 @@ void EvolutionaryAlgorithm::evaluate_population(void)
 //
 /// This method ranks all individuals in the population by their objective performance, so that the least fit 
 /// individual has rank 1 and the fittest individual has rank [population size].
+/// Individuals with the same performance share the lowest rank of their group. 
 /// It then assigns them a fitness value linearly proportional to their rank. Results are stored in the fitness 
 /// vector.
 
 void EvolutionaryAlgorithm::perform_linear_ranking_fitness_assignment(void)
 {
-   // Sorted performance vector
+   // Indices of individuals sorted by performance
 
-   unsigned int population_size = get_population_size();
+   const unsigned int population_size = get_population_size();
 
-   Vector<double> sorted_performance(population_size);
+   Vector<unsigned int> sorted_indices(population_size);
 
-   sorted_performance = performance;
+   sorted_indices.initialize_sequential();
 
-   std::sort(sorted_performance.begin(), sorted_performance.end(), std::less<double>());
+   std::stable_sort(sorted_indices.begin(), sorted_indices.end(), 
+   [&](const unsigned int& index_1, const unsigned int& index_2) { return(performance[index_1] < performance[index_2]); });
 
    // Rank vector
 
    Vector<int> rank(population_size);
 
-   for(unsigned int i = 0; i < population_size; i++)
+   unsigned int group_begin = 0;
+
+   while(group_begin < population_size)
    {
-      for(unsigned int j = 0; j < population_size; j++)
+      unsigned int group_end = group_begin + 1;
+
+      while(group_end < population_size && performance[sorted_indices[group_end]] == performance[sorted_indices[group_begin]])
       {
-         if(performance[j] == sorted_performance[i])
-         {
-            rank[j] = population_size - i;
-         }
+         group_end++;
+      }
+
+      for(unsigned int i = group_begin; i < group_end; i++)
+      {
+         rank[sorted_indices[i]] = population_size - (group_end - 1);
       }
+
+      group_begin = group_end;
    }
 
    // Perform linear ranking fitness assignment
@@ -2569,34 +2662,19 @@ void EvolutionaryAlgorithm::perform_stochastic_universal_sampling_selection(void
 
 // void perform_intermediate_recombination(void) method
 
-/// This method performs inediate recombination between pairs of selected individuals to generate a new 
+/// This method performs intermediate recombination between pairs of selected individuals to generate a new 
 /// population. 
 /// Each selected individual is to be recombined with two other selected individuals chosen at random. 
 /// Results are stored in the population matrix.
+/// Offspring are written directly into the rows of a second population matrix, which is then swapped with the current one.
 
 void EvolutionaryAlgorithm::perform_intermediate_recombination(void)
 {
-   unsigned int population_size = get_population_size();
-
-   const NeuralNetwork* neural_network_pointer = performance_functional_pointer->get_neural_network_pointer();
-     
-   const unsigned int parameters_number = neural_network_pointer->count_parameters_number();
-
-   Matrix<double> new_population(population_size, parameters_number);
-
-   unsigned int count = 0;
-   for(unsigned int i = 0; i < population_size; i++)
-   {
-      if(selection[i] == true)
-      count ++;        
-   }
-
-   Vector<double> parent_1(parameters_number);
-   Vector<double> parent_2(parameters_number);
+   const unsigned int population_size = get_population_size();
 
-   Vector<double> offspring(parameters_number);
+   const unsigned int parameters_number = population.get_columns_number();
 
-   Matrix<int> recombination(population_size, 2);
+   new_population.set(population_size, parameters_number);
 
    // Start recombination   
 
@@ -2608,20 +2686,34 @@ void EvolutionaryAlgorithm::perform_intermediate_recombination(void)
       {
          // Set parent 1
 
-         parent_1 = get_individual(i);
+         const double* parent_1 = population[i];
 
          // Generate 2 offspring with parent 1
 
          for(unsigned int j = 0; j < 2; j++)
          {
+            // Count new population size control sentence
+
+            if(new_population_size_count == population_size)
+            {
+               std::ostringstream buffer;
+
+               buffer << "OpenNN Exception: EvolutionaryAlgorithm class.\n"
+                      << "void perform_intermediate_recombination(void) method.\n"
+                      << "Count new population size is not equal to population size.\n";
+
+               throw std::logic_error(buffer.str().c_str());	  
+            }
+
             // Choose parent 2 at random among selected individuals   
 
             bool parent_2_candidate = false;
 
-            do{
+            do
+            {
                // Integer random number beteen 0 and population size
 
-               double random = (double)rand()/(RAND_MAX+1.0);
+               double random = (double)rand()/(RAND_MAX + 1.0);
 
                unsigned int parent_2_candidate_index = (unsigned int)(population_size*random);
 
@@ -2631,15 +2723,15 @@ void EvolutionaryAlgorithm::perform_intermediate_recombination(void)
                {
                   parent_2_candidate = true;
 
-                  recombination[new_population_size_count][0] = i;
+                  const double* parent_2 = population[parent_2_candidate_index];
 
-                  recombination[new_population_size_count][1] = parent_2_candidate_index;
+                  // Write offspring into new population matrix
 
-                  parent_2 = get_individual(parent_2_candidate_index);
+                  double* offspring = new_population[new_population_size_count];
 
-                  // Perform inediate recombination between parent 1 and parent 2
+                  // Perform intermediate recombination between parent 1 and parent 2
 
-                  for(unsigned int j = 0; j < parameters_number; j++)
+                  for(unsigned int k = 0; k < parameters_number; k++)
                   {
                      // Choose the scaling factor to be a random number between
                      // -recombination_size and 1+recombination_size for each
@@ -2649,21 +2741,17 @@ void EvolutionaryAlgorithm::perform_intermediate_recombination(void)
 
                      double scaling_factor = -1.0*recombination_size + (1.0 + recombination_size)*random;
 
-                     offspring[j] = scaling_factor*parent_1[j] + (1.0 - scaling_factor)*parent_2[j];
+                     offspring[k] = scaling_factor*parent_1[k] + (1.0 - scaling_factor)*parent_2[k];
                   }
 
-                  // Add offspring to new_population matrix
-
-                  new_population.set_row(new_population_size_count, offspring);   
-                  
                   new_population_size_count++;
                }
-            }while(parent_2_candidate != true);
+            }while(parent_2_candidate == false);
          }
       }
    }
 
-   // Count number of new individuals control sentence
+   // Count new population size control sentence
 
    if(new_population_size_count != population_size)
    {
@@ -2678,7 +2766,7 @@ void EvolutionaryAlgorithm::perform_intermediate_recombination(void)
 
    // Set new population
 
-   population = new_population;
+   population.swap(new_population);
 }
 
 
@@ -2687,25 +2775,15 @@ void EvolutionaryAlgorithm::perform_intermediate_recombination(void)
 /// This method performs line recombination between pairs of selected individuals to generate a new population. 
 /// Each selected individual is to be recombined with two other selected individuals chosen at random. 
 /// Results are stored in the population matrix.
+/// Offspring are written directly into the rows of a second population matrix, which is then swapped with the current one.
 
 void EvolutionaryAlgorithm::perform_line_recombination(void)
 {
    const unsigned int population_size = get_population_size();
 
-   const NeuralNetwork* neural_network_pointer = performance_functional_pointer->get_neural_network_pointer();
-     
-   const unsigned int parameters_number = neural_network_pointer->count_parameters_number();
+   const unsigned int parameters_number = population.get_columns_number();
 
-   Matrix<double> new_population(population_size, parameters_number);
-
-   Vector<double> parent_1(parameters_number);
-   Vector<double> parent_2(parameters_number);
-
-   Vector<double> offspring(parameters_number);
-   Vector<double> parent_1_term(parameters_number);
-   Vector<double> parent_2_term(parameters_number);
-
-   Matrix<int> recombination(population_size, 2);
+   new_population.set(population_size, parameters_number);
 
    // Start recombination   
 
@@ -2717,12 +2795,25 @@ void EvolutionaryAlgorithm::perform_line_recombination(void)
       {
          // Set parent 1
 
-         parent_1 = get_individual(i);
+         const double* parent_1 = population[i];
 
          // Generate 2 offspring with parent 1
 
          for(unsigned int j = 0; j < 2; j++)
          {
+            // Count new population size control sentence
+
+            if(new_population_size_count == population_size)
+            {
+               std::ostringstream buffer;
+
+               buffer << "OpenNN Exception: EvolutionaryAlgorithm class.\n"
+                      << "void perform_line_recombination(void) method.\n"
+                      << "Count new population size is not equal to population size.\n";
+
+               throw std::logic_error(buffer.str().c_str());	  
+            }
+
             // Choose parent 2 at random among selected individuals   
 
             bool parent_2_candidate = false;
@@ -2741,13 +2832,13 @@ void EvolutionaryAlgorithm::perform_line_recombination(void)
                {
                   parent_2_candidate = true;
 
-                  recombination[new_population_size_count][0] = i;
-                  recombination[new_population_size_count][1] = parent_2_candidate_index;
+                  const double* parent_2 = population[parent_2_candidate_index];
+
+                  // Write offspring into new population matrix
 
-                  parent_2 = get_individual(parent_2_candidate_index);
+                  double* offspring = new_population[new_population_size_count];
 
-                  // Perform inediate recombination between parent 1
-                  // and parent 2
+                  // Perform line recombination between parent 1 and parent 2
 
                   // Choose the scaling factor to be a random number between
                   // -recombination_size and 1+recombination_size for all
@@ -2758,14 +2849,10 @@ void EvolutionaryAlgorithm::perform_line_recombination(void)
                   double scaling_factor = -1.0*recombination_size 
                   + (1.0 + recombination_size)*random;
 
-                  parent_1_term = parent_1*scaling_factor;
-                  parent_2_term = parent_2*(1.0 - scaling_factor); 
-
-                  offspring = parent_1_term + parent_2_term;
-
-                  // Add offspring to new_population matrix
-
-                  new_population.set_row(new_population_size_count, offspring);   
+                  for(unsigned int k = 0; k < parameters_number; k++)
+                  {
+                     offspring[k] = parent_1[k]*scaling_factor + parent_2[k]*(1.0 - scaling_factor);
+                  }
 
                   new_population_size_count++;
                }
@@ -2789,7 +2876,7 @@ void EvolutionaryAlgorithm::perform_line_recombination(void)
 
    // Set new population
 
-   population = new_population;
+   population.swap(new_population);
 }
 
 
@@ -2800,17 +2887,13 @@ void EvolutionaryAlgorithm::perform_line_recombination(void)
 
 void EvolutionaryAlgorithm::perform_normal_mutation(void)
 {
-   unsigned int population_size = get_population_size();
-
-   const NeuralNetwork* neural_network_pointer = performance_functional_pointer->get_neural_network_pointer();
-     
-   const unsigned int parameters_number = neural_network_pointer->count_parameters_number();
+   const unsigned int population_size = get_population_size();
 
-   Vector<double> individual(parameters_number);
+   const unsigned int parameters_number = population.get_columns_number();
 
    for(unsigned int i = 0; i < population_size; i++)
    {
-      individual = get_individual(i);
+      double* individual = population[i];
 
       for(unsigned int j = 0; j < parameters_number; j++)
       {
@@ -2823,8 +2906,6 @@ void EvolutionaryAlgorithm::perform_normal_mutation(void)
             individual[j] += calculate_random_normal(0.0, mutation_range);
          }
       }
-
-      set_individual(i, individual);
    }
 }  
 
@@ -2838,15 +2919,11 @@ void EvolutionaryAlgorithm::perform_uniform_mutation(void)
 {
    const unsigned int population_size = get_population_size();
 
-   const NeuralNetwork* neural_network_pointer = performance_functional_pointer->get_neural_network_pointer();
-     
-   const unsigned int parameters_number = neural_network_pointer->count_parameters_number();
-   
-   Vector<double> individual(parameters_number, 0.0);
+   const unsigned int parameters_number = population.get_columns_number();
 
    for(unsigned int i = 0; i < population_size; i++)
    {
-      individual = get_individual(i);
+      double* individual = population[i];
 
       for(unsigned int j = 0; j < parameters_number; j++)
       {
@@ -2866,8 +2943,6 @@ void EvolutionaryAlgorithm::perform_uniform_mutation(void)
             individual[j] += uniformlyDistributedRandomNumber;
          }
       }
-
-      set_individual(i, individual);
    }
 }
 
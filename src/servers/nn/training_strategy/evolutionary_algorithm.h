@@ -18,8 +18,15 @@
 #define __EVOLUTIONARYALGORITHM_H__
 
 
+// System includes
+
+#include <memory>
+
+// OpenNN includes
+
 #include "training_algorithm.h"
 #include "../performance_functional/performance_functional.h"
+#include "../utilities/thread_pool.h"
 
 namespace OpenNN
 {
@@ -204,6 +211,8 @@ public:
 
    const unsigned int& get_display_period(void) const;
 
+   unsigned int count_threads_number(void) const;
+
    // Population methods
 
    unsigned int get_population_size(void) const;
@@ -331,6 +340,8 @@ public:
 
    void set_display_period(const unsigned int&);
 
+   void set_threads_number(const unsigned int&);
+
    // Population methods
 
    Vector<double> get_individual(const unsigned int&) const;
@@ -434,6 +445,15 @@ private:
    /// Selected individuals in population.
 
    Vector<bool> selection;
+
+   /// Population matrix being generated by recombination, kept between generations to reuse its storage.
+
+   Matrix<double> new_population;
+
+   /// Pool of threads which evaluate the individuals of the population concurrently. 
+   /// It is empty when the population is evaluated on the calling thread only.
+
+   std::shared_ptr<ThreadPool> thread_pool_pointer;
    
    // Training parameters
 
@@ -325,6 +325,17 @@ const bool& GradientDescent::get_reserve_elapsed_time_history(void) const
 }
 
 
+// const bool& get_reserve_evaluations_number_history(void) const method
+
+/// This method returns true if the history of the number of performance evaluations of the line minimizations is 
+/// to be reserved, and false otherwise.
+
+const bool& GradientDescent::get_reserve_evaluations_number_history(void) const
+{
+   return(reserve_evaluations_number_history);     
+}
+
+
 // const bool& get_reserve_generalization_evaluation_history(void) const method
 
 /// This method returns true if the Generalization evaluation history vector is to be reserved, and false otherwise.
@@ -395,6 +406,7 @@ void GradientDescent::set_default(void)
    reserve_training_direction_history = false;
    reserve_training_rate_history = false;
    reserve_elapsed_time_history = false;
+   reserve_evaluations_number_history = false;
 
    // UTILITIES
 
@@ -440,6 +452,7 @@ void GradientDescent::set_reserve_all_training_history(const bool& new_reserve_a
    reserve_training_rate_history = new_reserve_all_training_history;
 
    reserve_elapsed_time_history = new_reserve_all_training_history;
+   reserve_evaluations_number_history = new_reserve_all_training_history;
 }
 
 
@@ -912,6 +925,19 @@ void GradientDescent::set_reserve_elapsed_time_history(const bool& new_reserve_e
 }
 
 
+// void set_reserve_evaluations_number_history(bool) method
+
+/// This method makes the number of performance evaluations of the line minimization of each epoch to be reseved or 
+/// not in memory. This is a vector.
+/// @param new_reserve_evaluations_number_history True if the history of the number of evaluations is to be reserved, 
+/// false otherwise.
+
+void GradientDescent::set_reserve_evaluations_number_history(const bool& new_reserve_evaluations_number_history)
+{
+   reserve_evaluations_number_history = new_reserve_evaluations_number_history;     
+}
+
+
 // void set_reserve_generalization_evaluation_history(bool) method
 
 /// This method makes the Generalization evaluation history to be reserved or not in memory. 
@@ -1054,6 +1080,14 @@ std::string GradientDescent::GradientDescentResults::to_string(void) const
               << elapsed_time_history << "\n"; 
    }
 
+   // Evaluations number history
+
+   if(!evaluations_number_history.empty())
+   {
+       buffer << "% Evaluations number history:\n"
+              << evaluations_number_history << "\n"; 
+   }
+
    return(buffer.str());
 }
 
@@ -1076,6 +1110,7 @@ void GradientDescent::GradientDescentResults::resize_training_history(const unsi
    training_direction_history.resize(new_size);
    training_rate_history.resize(new_size);
    elapsed_time_history.resize(new_size);
+   evaluations_number_history.resize(new_size);
 }
 
 
@@ -1102,6 +1137,10 @@ GradientDescent::GradientDescentResults* GradientDescent::perform_training(void)
       std::cout << "Training with gradient descent...\n";
    }
 
+   // The network may have changed since the last training, so the line minimization copies it again
+
+   training_rate_algorithm.clear_thread_copies();
+
    // Neural network stuff
 
    NeuralNetwork* neural_network_pointer = performance_functional_pointer->get_neural_network_pointer();
@@ -1111,6 +1150,10 @@ GradientDescent::GradientDescentResults* GradientDescent::perform_training(void)
    Vector<double> parameters(parameters_number);
    double parameters_norm;
 
+   // Data set stuff
+
+   DataSet* streamed_data_set_pointer = get_streamed_data_set_pointer();
+
    Vector<double> parameters_increment(parameters_number);
    double parameters_increment_norm;
 
@@ -1155,6 +1198,13 @@ GradientDescent::GradientDescentResults* GradientDescent::perform_training(void)
 
    for(unsigned int epoch = 0; epoch <= maximum_epochs_number; epoch++)
    {
+      // Data set stuff
+
+      if(streamed_data_set_pointer && epoch != 0)
+      {
+         streamed_data_set_pointer->load_next_data_chunk();
+      }
+
       // Neural network stuff
 
       parameters = neural_network_pointer->arrange_parameters();
@@ -1168,7 +1218,7 @@ GradientDescent::GradientDescentResults* GradientDescent::perform_training(void)
 
       // Performance functional stuff
       
-      if(epoch == 0)
+      if(epoch == 0 || streamed_data_set_pointer)
       {      
          performance = performance_functional_pointer->calculate_evaluation();
          performance_increase = 0.0; 
@@ -1208,6 +1258,8 @@ GradientDescent::GradientDescentResults* GradientDescent::perform_training(void)
          initial_training_rate = old_training_rate;
       }    
       
+      const unsigned int old_evaluations_number = training_rate_algorithm.get_evaluations_number();
+
 	  directional_point = training_rate_algorithm.calculate_directional_point(performance, training_direction, initial_training_rate);
 
       training_rate = directional_point[0];
@@ -1271,6 +1323,11 @@ GradientDescent::GradientDescentResults* GradientDescent::perform_training(void)
          training_results_pointer->elapsed_time_history[epoch] = elapsed_time;
       }
 
+      if(reserve_evaluations_number_history)
+      {
+         training_results_pointer->evaluations_number_history[epoch] = training_rate_algorithm.get_evaluations_number() - old_evaluations_number;
+      }
+
       // Stopping Criteria
 
       if(parameters_increment_norm <= minimum_parameters_increment_norm)
@@ -1284,7 +1341,7 @@ GradientDescent::GradientDescentResults* GradientDescent::perform_training(void)
          stop_training = true;
       }
 
-      else if(epoch != 0 && performance_increase <= minimum_performance_increase)
+      else if(epoch != 0 && !streamed_data_set_pointer && performance_increase <= minimum_performance_increase)
       {
          if(display)
          {
@@ -1657,6 +1714,17 @@ TiXmlElement* GradientDescent::to_XML(void) const
    TiXmlText* reserve_elapsed_time_history_text = new TiXmlText(buffer.str().c_str());
    reserve_elapsed_time_history_element->LinkEndChild(reserve_elapsed_time_history_text);
 
+   // Reserve evaluations number history 
+
+   TiXmlElement* reserve_evaluations_number_history_element = new TiXmlElement("ReserveEvaluationsNumberHistory");
+   gradient_descent_element->LinkEndChild(reserve_evaluations_number_history_element);
+
+   buffer.str("");
+   buffer << reserve_evaluations_number_history;
+
+   TiXmlText* reserve_evaluations_number_history_text = new TiXmlText(buffer.str().c_str());
+   reserve_evaluations_number_history_element->LinkEndChild(reserve_evaluations_number_history_text);
+
    // Reserve generalization evaluation history 
 
    TiXmlElement* reserve_generalization_evaluation_history_element = new TiXmlElement("ReserveGeneralizationPerformanceHistory");
@@ -2092,6 +2160,24 @@ void GradientDescent::from_XML(TiXmlElement* gradient_descent_element)
       }
    }
 
+   // Reserve evaluations number history 
+
+   TiXmlElement* reserve_evaluations_number_history_element = gradient_descent_element->FirstChildElement("ReserveEvaluationsNumberHistory");
+
+   if(reserve_evaluations_number_history_element)
+   {
+      std::string new_reserve_evaluations_number_history = reserve_evaluations_number_history_element->GetText(); 
+
+      try
+      {
+         set_reserve_evaluations_number_history(new_reserve_evaluations_number_history != "0");
+      }
+      catch(std::exception& e)
+      {
+         std::cout << e.what() << std::endl;		 
+      }
+   }
+
    // Reserve generalization evaluation history 
 
    TiXmlElement* reserve_generalization_evaluation_history_element = gradient_descent_element->FirstChildElement("ReserveGeneralizationPerformanceHistory");
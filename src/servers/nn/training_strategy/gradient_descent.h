@@ -98,6 +98,10 @@ public:
 
       Vector<double> elapsed_time_history;
 
+      /// History of the number of performance evaluations of the line minimizations over the training epochs. 
+
+      Vector<unsigned int> evaluations_number_history;
+
       // Final values
 
       /// Final neural network parameters vector. 
@@ -180,6 +184,7 @@ public:
    const bool& get_reserve_training_direction_history(void) const;
    const bool& get_reserve_training_rate_history(void) const;
    const bool& get_reserve_elapsed_time_history(void) const;
+   const bool& get_reserve_evaluations_number_history(void) const;
 
    // Utilities
 
@@ -230,6 +235,7 @@ public:
    void set_reserve_training_direction_history(const bool&);
    void set_reserve_training_rate_history(const bool&);
    void set_reserve_elapsed_time_history(const bool&);
+   void set_reserve_evaluations_number_history(const bool&);
 
    // Utilities
 
@@ -345,6 +351,10 @@ private:
 
    bool reserve_elapsed_time_history;
 
+   /// True if the history of the number of line minimization evaluations is to be reserved, false otherwise.
+
+   bool reserve_evaluations_number_history;
+
    /// True if the Generalization evaluation history vector is to be reserved, false otherwise. 
 
    bool reserve_generalization_evaluation_history;
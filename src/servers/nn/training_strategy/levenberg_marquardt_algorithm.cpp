@@ -30,7 +30,6 @@
 #include "levenberg_marquardt_algorithm.h"
 
 #include "../data_set/data_set.h"
-//#include "../utilities/linear_algebraic_equations.h"
 
 namespace OpenNN
 {
@@ -1440,8 +1439,9 @@ LevenbergMarquardtAlgorithm::LevenbergMarquardtAlgorithmResults* LevenbergMarqua
       {
          Hessian_approximation = (JacobianT_dot_Jacobian + identity*damping_parameter);
 
-         parameters_increment = gradient*(-1.0);         
-         linear_algebraic_equations.perform_Gauss_Jordan_elimination(Hessian_approximation, parameters_increment);
+         // The damped normal equations matrix is symmetric positive definite
+
+         parameters_increment = Hessian_approximation.calculate_Cholesky_solution(gradient*(-1.0));
 
          parameters += parameters_increment;
 		 
@@ -1506,7 +1506,7 @@ LevenbergMarquardtAlgorithm::LevenbergMarquardtAlgorithmResults* LevenbergMarqua
 
       if(reserve_inverse_Hessian_history)
       {
-         Levenberg_Marquardt_algorithm_training_results_pointer->Hessian_approximation_history[epoch] = Hessian_approximation; // as computed by linear algebraic equations object
+         Levenberg_Marquardt_algorithm_training_results_pointer->Hessian_approximation_history[epoch] = Hessian_approximation;
       }
 
       // Training history training algorithm
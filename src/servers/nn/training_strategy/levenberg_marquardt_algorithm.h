@@ -24,8 +24,6 @@
 
 #include "training_algorithm.h"
 
-#include "../utilities/linear_algebraic_equations.h"
-
 // TinyXml includes
 
 #include "../tinyxml.h"
@@ -264,10 +262,6 @@ private:
 
    // MEMBERS
 
-   /// Linear algebraic equations object.
-
-   LinearAlgebraicEquations linear_algebraic_equations;
-
    /// Initial Levenberg-Marquardt parameter.
 
    double damping_parameter;
@@ -944,13 +944,15 @@ Vector<double> NewtonMethod::calculate_gradient_descent_training_direction(const
 // Vector<double> calculate_training_direction(const Vector<double>&, const Matrix<double>&) const method
 
 /// This method returns the Newton method training direction, which has been previously normalized.
+/// The direction is the solution of the system Hd = -g, which is computed by LU factorization 
+/// instead of forming the inverse Hessian. 
 /// @param gradient Gradient vector. 
-/// @param inverse_Hessian Inverse Hessian matrix. 
+/// @param Hessian Hessian matrix. 
 
 Vector<double> NewtonMethod::calculate_training_direction
-(const Vector<double>& gradient, const Matrix<double>& inverse_Hessian) const
+(const Vector<double>& gradient, const Matrix<double>& Hessian) const
 {
-   Vector<double> training_direction = inverse_Hessian.dot(gradient)*(-1.0);
+   Vector<double> training_direction = Hessian.calculate_LU_solution(gradient*(-1.0));
 
    double training_direction_norm = training_direction.calculate_norm();
 
@@ -1149,7 +1151,7 @@ NewtonMethod::NewtonMethodResults* NewtonMethod::perform_training(void)
    Vector<double> gradient(parameters_number);
    double gradient_norm;
 
-   Matrix<double> inverse_Hessian(parameters_number, parameters_number);
+   Matrix<double> Hessian(parameters_number, parameters_number);
 
    // Training algorithm stuff 
 
@@ -1219,11 +1221,11 @@ NewtonMethod::NewtonMethodResults* NewtonMethod::perform_training(void)
          std::cout << "OpenNN Warning: Gradient norm is " << gradient_norm << ".\n";          
       }
 
-      inverse_Hessian = performance_functional_pointer->calculate_inverse_Hessian();
+      Hessian = performance_functional_pointer->calculate_Hessian();
 
       // Training algorithm 
 
-      training_direction = calculate_training_direction(gradient, inverse_Hessian);
+      training_direction = calculate_training_direction(gradient, Hessian);
 
       // Calculate evaluation training_slope
 
@@ -1300,7 +1302,7 @@ NewtonMethod::NewtonMethodResults* NewtonMethod::perform_training(void)
 
       if(reserve_inverse_Hessian_history)
       {
-         Newton_method_training_results_pointer->inverse_Hessian_history[epoch] = inverse_Hessian;
+         Newton_method_training_results_pointer->inverse_Hessian_history[epoch] = Hessian.calculate_inverse();
       }
 
       // Training history training algorithm
@@ -369,6 +369,17 @@ const bool& QuasiNewtonMethod::get_reserve_elapsed_time_history(void) const
 }
 
 
+// const bool& get_reserve_evaluations_number_history(void) const method
+
+/// This method returns true if the history of the number of performance evaluations of the line minimizations is 
+/// to be reserved, and false otherwise.
+
+const bool& QuasiNewtonMethod::get_reserve_evaluations_number_history(void) const
+{
+   return(reserve_evaluations_number_history);     
+}
+
+
 // const bool& get_reserve_inverse_Hessian_history(void) const method
 
 /// This method returns true if the inverse Hessian history is to be reserved, and false otherwise.
@@ -460,6 +471,7 @@ void QuasiNewtonMethod::set_reserve_all_training_history(const bool& new_reserve
    reserve_gradient_norm_history = new_reserve_all_training_history;
    reserve_training_direction_history = new_reserve_all_training_history;
    reserve_training_rate_history = new_reserve_all_training_history;
+   reserve_evaluations_number_history = new_reserve_all_training_history;
 }
 
 
@@ -507,6 +519,7 @@ void QuasiNewtonMethod::set_default(void)
    reserve_training_direction_history = false;
    reserve_training_rate_history = false;
    reserve_elapsed_time_history = false;
+   reserve_evaluations_number_history = false;
 
    // UTILITIES
 
@@ -996,6 +1009,19 @@ void QuasiNewtonMethod::set_reserve_elapsed_time_history(const bool& new_reserve
 }
 
 
+// void set_reserve_evaluations_number_history(bool) method
+
+/// This method makes the number of performance evaluations of the line minimization of each epoch to be reseved or 
+/// not in memory. This is a vector.
+/// @param new_reserve_evaluations_number_history True if the history of the number of evaluations is to be reserved, 
+/// false otherwise.
+
+void QuasiNewtonMethod::set_reserve_evaluations_number_history(const bool& new_reserve_evaluations_number_history)
+{
+   reserve_evaluations_number_history = new_reserve_evaluations_number_history;     
+}
+
+
 // void set_reserve_generalization_evaluation_history(bool) method
 
 /// This method makes the Generalization evaluation history to be reserved or not in memory. 
@@ -1531,6 +1557,11 @@ void QuasiNewtonMethod::QuasiNetwonMethodResults::resize_training_history(const
    {
       elapsed_time_history.resize(new_size);
    }
+
+   if(!evaluations_number_history.empty())
+   {
+      evaluations_number_history.resize(new_size);
+   }
 }
 
 
@@ -1634,6 +1665,14 @@ std::string QuasiNewtonMethod::QuasiNetwonMethodResults::to_string(void) const
               << elapsed_time_history << "\n"; 
    }
 
+   // Evaluations number history
+
+   if(!evaluations_number_history.empty())
+   {
+       buffer << "% Evaluations number history:\n"
+              << evaluations_number_history << "\n"; 
+   }
+
    return(buffer.str());
 }
 
@@ -1660,6 +1699,10 @@ QuasiNewtonMethod::QuasiNetwonMethodResults* QuasiNewtonMethod::perform_training
       std::cout << "Training with quasi-Newton method...\n";
    }
 
+   // The network may have changed since the last training, so the line minimization copies it again
+
+   training_rate_algorithm.clear_thread_copies();
+
    QuasiNetwonMethodResults* results_pointer = new QuasiNetwonMethodResults;
 
    if(reserve_parameters_history)
@@ -1702,6 +1745,10 @@ QuasiNewtonMethod::QuasiNetwonMethodResults* QuasiNewtonMethod::perform_training
    {
       results_pointer->elapsed_time_history.resize(1 + maximum_epochs_number);
    }
+   if(reserve_evaluations_number_history)
+   {
+      results_pointer->evaluations_number_history.resize(1 + maximum_epochs_number);
+   }
 
    // Neural network stuff
 
@@ -1716,6 +1763,10 @@ QuasiNewtonMethod::QuasiNetwonMethodResults* QuasiNewtonMethod::perform_training
    Vector<double> parameters_increment(parameters_number);
    double parameters_increment_norm;
 
+   // Data set stuff
+
+   DataSet* streamed_data_set_pointer = get_streamed_data_set_pointer();
+
    // Performance functional stuff
      
    double performance = 0.0;
@@ -1760,6 +1811,17 @@ QuasiNewtonMethod::QuasiNetwonMethodResults* QuasiNewtonMethod::perform_training
 
    for(unsigned int epoch = 0; epoch <= maximum_epochs_number; epoch++)
    {
+      // Data set stuff
+
+      if(streamed_data_set_pointer && epoch != 0)
+      {
+         streamed_data_set_pointer->load_next_data_chunk();
+
+         // Both gradients of the inverse Hessian update must be taken on the same chunk
+
+         old_gradient = performance_functional_pointer->calculate_gradient(old_parameters);
+      }
+
       // Neural network
 
       parameters = neural_network_pointer->arrange_parameters();
@@ -1773,7 +1835,7 @@ QuasiNewtonMethod::QuasiNetwonMethodResults* QuasiNewtonMethod::perform_training
 
       // Performance functional stuff
 
-      if(epoch == 0)
+      if(epoch == 0 || streamed_data_set_pointer)
       {      
          performance = performance_functional_pointer->calculate_evaluation();
          performance_increase = 0.0; 
@@ -1837,6 +1899,8 @@ QuasiNewtonMethod::QuasiNetwonMethodResults* QuasiNewtonMethod::perform_training
          initial_training_rate = old_training_rate;
       }
 
+      const unsigned int old_evaluations_number = training_rate_algorithm.get_evaluations_number();
+
       directional_point = training_rate_algorithm.calculate_directional_point(performance, training_direction, initial_training_rate);
 
       training_rate = directional_point[0];      
@@ -1914,6 +1978,11 @@ QuasiNewtonMethod::QuasiNetwonMethodResults* QuasiNewtonMethod::perform_training
          results_pointer->elapsed_time_history[epoch] = elapsed_time;
       }
 
+      if(reserve_evaluations_number_history)
+      {
+         results_pointer->evaluations_number_history[epoch] = training_rate_algorithm.get_evaluations_number() - old_evaluations_number;
+      }
+
       // Stopping Criteria
 
       if(parameters_increment_norm <= minimum_parameters_increment_norm)
@@ -1927,7 +1996,7 @@ QuasiNewtonMethod::QuasiNetwonMethodResults* QuasiNewtonMethod::perform_training
          stop_training = true;
       }
 
-      if(epoch != 0 && performance_increase <= minimum_performance_increase)
+      if(epoch != 0 && !streamed_data_set_pointer && performance_increase <= minimum_performance_increase)
       {
          if(display)
          {
@@ -2336,6 +2405,17 @@ TiXmlElement* QuasiNewtonMethod::to_XML(void) const
    TiXmlText* reserve_elapsed_time_history_text = new TiXmlText(buffer.str().c_str());
    reserve_elapsed_time_history_element->LinkEndChild(reserve_elapsed_time_history_text);
 
+   // Reserve evaluations number history 
+
+   TiXmlElement* reserve_evaluations_number_history_element = new TiXmlElement("ReserveEvaluationsNumberHistory");
+   quasi_Newton_method_element->LinkEndChild(reserve_evaluations_number_history_element);
+
+   buffer.str("");
+   buffer << reserve_evaluations_number_history;
+
+   TiXmlText* reserve_evaluations_number_history_text = new TiXmlText(buffer.str().c_str());
+   reserve_evaluations_number_history_element->LinkEndChild(reserve_evaluations_number_history_text);
+
    // Reserve generalization evaluation history 
 
    TiXmlElement* reserve_generalization_evaluation_history_element = new TiXmlElement("ReserveGeneralizationPerformanceHistory");
@@ -2807,6 +2887,24 @@ void QuasiNewtonMethod::from_XML(TiXmlElement* quasi_Newton_method_element)
       }
    }
 
+   // Reserve evaluations number history 
+
+   TiXmlElement* reserve_evaluations_number_history_element = quasi_Newton_method_element->FirstChildElement("ReserveEvaluationsNumberHistory");
+
+   if(reserve_evaluations_number_history_element)
+   {
+      std::string new_reserve_evaluations_number_history = reserve_evaluations_number_history_element->GetText(); 
+
+      try
+      {
+         set_reserve_evaluations_number_history(new_reserve_evaluations_number_history != "0");
+      }
+      catch(std::exception& e)
+      {
+         std::cout << e.what() << std::endl;		 
+      }
+   }
+
    // Reserve generalization evaluation history 
 
    TiXmlElement* reserve_generalization_evaluation_history_element = quasi_Newton_method_element->FirstChildElement("ReserveGeneralizationPerformanceHistory");
@@ -214,6 +214,37 @@ void TrainingAlgorithm::check(void) const
 }
 
 
+// DataSet* get_streamed_data_set_pointer(void) const method
+
+/// This method returns a pointer to the data set of the objective term if it reads its data in chunks, and NULL otherwise. 
+/// Training algorithms then move to the next chunk at every epoch, so that an epoch is a step on a chunk 
+/// rather than on the whole data set. 
+
+DataSet* TrainingAlgorithm::get_streamed_data_set_pointer(void) const
+{
+   if(!performance_functional_pointer)
+   {
+      return(NULL);
+   }
+
+   const PerformanceTerm* objective_term_pointer = performance_functional_pointer->get_objective_term_pointer();
+
+   if(!objective_term_pointer)
+   {
+      return(NULL);
+   }
+
+   DataSet* data_set_pointer = objective_term_pointer->get_data_set_pointer();
+
+   if(data_set_pointer && data_set_pointer->is_data_streamed())
+   {
+      return(data_set_pointer);
+   }
+
+   return(NULL);
+}
+
+
 // std::string to_string(void) const method
 
 /// This method returns a default string representation of a training algorithm. 
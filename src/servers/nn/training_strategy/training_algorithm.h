@@ -59,6 +59,12 @@ public:
 
    struct Results
    {
+      /// Destructor, so that the results of any training algorithm can be deleted through this structure. 
+
+      virtual ~Results(void)
+      {
+      }
+
       /// This method returns a string representation of the results structure. 
 
       virtual std::string to_string(void) const
@@ -112,6 +118,10 @@ public:
 
 protected:
 
+   // Data stream methods
+
+   DataSet* get_streamed_data_set_pointer(void) const;
+
    // FIELDS
 
    /// Pointer to a performance functional for a multilayer perceptron object.
@@ -41,7 +41,7 @@ namespace OpenNN
 /// It also initializes the class members to their default values. 
 
 TrainingRateAlgorithm::TrainingRateAlgorithm(void)
- : performance_functional_pointer(NULL)
+ : performance_functional_pointer(NULL), evaluations_number(0)
 { 
    set_default();
 }
@@ -55,7 +55,7 @@ TrainingRateAlgorithm::TrainingRateAlgorithm(void)
 /// @param new_performance_functional_pointer Pointer to a performance functional object.
 
 TrainingRateAlgorithm::TrainingRateAlgorithm(PerformanceFunctional* new_performance_functional_pointer)
- : performance_functional_pointer(new_performance_functional_pointer)
+ : performance_functional_pointer(new_performance_functional_pointer), evaluations_number(0)
 {
    set_default();
 }
@@ -69,7 +69,7 @@ TrainingRateAlgorithm::TrainingRateAlgorithm(PerformanceFunctional* new_performa
 /// 
 
 TrainingRateAlgorithm::TrainingRateAlgorithm(TiXmlElement* training_rate_algorithm_element)
- : performance_functional_pointer(NULL)
+ : performance_functional_pointer(NULL), evaluations_number(0)
 { 
    from_XML(training_rate_algorithm_element);
 }
@@ -211,6 +211,36 @@ const bool& TrainingRateAlgorithm::get_display(void) const
 }
 
 
+// unsigned int count_threads_number(void) const method
+
+/// This method returns the number of threads which evaluate candidate training rates at once. 
+/// It is one if no thread pool has been constructed. 
+
+unsigned int TrainingRateAlgorithm::count_threads_number(void) const
+{
+   if(thread_pool_pointer)
+   {
+      return(thread_pool_pointer->count_threads_number());
+   }
+   else
+   {
+      return(1);
+   }
+}
+
+
+// const unsigned int& get_evaluations_number(void) const method
+
+/// This method returns the number of performance evaluations made by the line minimizations of this object. 
+/// Training rates evaluated twice within a line minimization only count once. 
+/// Training algorithms take the difference of this number over an epoch to obtain the evaluations of that epoch. 
+
+const unsigned int& TrainingRateAlgorithm::get_evaluations_number(void) const
+{
+   return(evaluations_number);
+}
+
+
 // void set(void) method
 
 /// This method sets the performance functional pointer to NULL.
@@ -271,6 +301,8 @@ void TrainingRateAlgorithm::set_default(void)
 void TrainingRateAlgorithm::set_performance_functional_pointer(PerformanceFunctional* new_performance_functional_pointer)
 {
    performance_functional_pointer = new_performance_functional_pointer;
+
+   clear_thread_copies();
 }
 
 
@@ -478,6 +510,52 @@ void TrainingRateAlgorithm::set_display(const bool& new_display)
 }
 
 
+// void set_threads_number(const unsigned int&) method
+
+/// This method sets the number of threads which evaluate candidate training rates at once. 
+/// While bracketing, the next training rates of the bracketing sequence are evaluated ahead, which gives the same 
+/// bracket as a single thread. 
+/// The golden section and the Brent's methods evaluate as many training rates inside the bracket as threads at each 
+/// iteration, and keep the lowest one with its neighbours as the new bracket. 
+/// Each thread evaluates its training rates on its own copy of the neural network and the performance functional, 
+/// so the performance terms must not be modified by their evaluation. 
+/// @param new_threads_number Number of threads, including the calling one. 
+/// A value of one, or zero, deletes the thread pool, so that the training rates are evaluated one by one. 
+
+void TrainingRateAlgorithm::set_threads_number(const unsigned int& new_threads_number)
+{
+   if(new_threads_number == count_threads_number())
+   {
+      return;
+   }
+
+   if(new_threads_number > 1)
+   {
+      thread_pool_pointer.reset(new ThreadPool(new_threads_number));
+   }
+   else
+   {
+      thread_pool_pointer.reset();
+   }
+
+   clear_thread_copies();
+}
+
+
+// void clear_thread_copies(void) method
+
+/// This method deletes the copies of the neural network and the performance functional used by the threads, so that 
+/// the next line minimization copies them again. 
+/// The copies only follow the parameters of the neural network, so this method must be called after any other change 
+/// to the neural network or the performance functional, such as new scaling statistics or activation functions. 
+/// The training algorithms call it at the start of each training. 
+
+void TrainingRateAlgorithm::clear_thread_copies(void)
+{
+   thread_copies_pointer.reset();
+}
+
+
 // Vector<double> calculate_directional_point(const double&, const Vector<double>&, const double&) const method
 
 /// This method returns a vector with two elements, the training rate calculated by means of the training rate
@@ -566,6 +644,8 @@ Vector<double> TrainingRateAlgorithm::calculate_directional_point(const double&
 
 Vector< Vector<double> > TrainingRateAlgorithm::calculate_bracketing_training_rate(const double& performance, const Vector<double>& training_direction, const double& initial_training_rate) const
 {
+   clear_directional_performances(performance);
+
    // Interior point
 
    Vector<double> A(2);
@@ -574,7 +654,7 @@ Vector< Vector<double> > TrainingRateAlgorithm::calculate_bracketing_training_ra
 
    Vector<double> U(2);
    U[0] = initial_training_rate;
-   U[1] = performance_functional_pointer->calculate_directional_performance(training_direction, U[0]);      
+   U[1] = calculate_directional_performance(training_direction, U[0]);      
 
    Vector<double> B = U;
 
@@ -583,7 +663,7 @@ Vector< Vector<double> > TrainingRateAlgorithm::calculate_bracketing_training_ra
       B = U;
 
       U[0] /= bracketing_factor;
-      U[1] = performance_functional_pointer->calculate_directional_performance(training_direction, U[0]);      
+      U[1] = calculate_bracketing_directional_performance(training_direction, U[0], true);      
 
 	  if(U[0] < training_rate_tolerance)
 	  {
@@ -604,7 +684,7 @@ Vector< Vector<double> > TrainingRateAlgorithm::calculate_bracketing_training_ra
    while(U[1] >= B[1])
    {
       B[0] *= bracketing_factor;
-      B[1] = performance_functional_pointer->calculate_directional_performance(training_direction, B[0]);      
+      B[1] = calculate_bracketing_directional_performance(training_direction, B[0], false);      
 
 
 	  if(B[0] > error_training_rate)
@@ -650,12 +730,14 @@ Vector< Vector<double> > TrainingRateAlgorithm::calculate_bracketing_training_ra
 /// and the performance for that training rate. 
 /// @param training_direction Initial training direction.
 
-Vector<double> TrainingRateAlgorithm::calculate_fixed_directional_point(const double&, const Vector<double>& training_direction, const double&) const 
+Vector<double> TrainingRateAlgorithm::calculate_fixed_directional_point(const double& performance, const Vector<double>& training_direction, const double&) const 
 {
+   clear_directional_performances(performance);
+
    Vector<double> directional_point(2);
 
    directional_point[0] = first_training_rate;
-   directional_point[1] = performance_functional_pointer->calculate_directional_performance(training_direction, first_training_rate);
+   directional_point[1] = calculate_directional_performance(training_direction, first_training_rate);
 
    return(directional_point);
 }
@@ -689,6 +771,30 @@ Vector<double> TrainingRateAlgorithm::calculate_golden_section_directional_point
 	     return(A);
 	  }
 
+      const unsigned int threads_number = count_threads_number();
+
+      if(threads_number > 1)
+      {
+         // Reduce the interval with evenly spaced training rates
+
+         Vector<double> training_rates(threads_number);
+
+         while(B[0] - A[0] > training_rate_tolerance)
+         {
+            for(unsigned int i = 0; i < threads_number; i++)
+            {
+               training_rates[i] = A[0] + (B[0] - A[0])*(i+1)/(threads_number+1);
+            }
+
+            if(!reduce_bracket(training_direction, training_rates, A, U, B))
+            {
+               break;
+            }
+         }
+
+         return(U);
+      }
+
       Vector<double> V(2);
 
       // Reduce the interval
@@ -696,7 +802,7 @@ Vector<double> TrainingRateAlgorithm::calculate_golden_section_directional_point
       do
       {
          V[0] = calculate_golden_section_training_rate(A, U, B);	  
-         V[1] = performance_functional_pointer->calculate_directional_performance(training_direction, V[0]);
+         V[1] = calculate_directional_performance(training_direction, V[0]);
 
          // Update points
  
@@ -781,7 +887,7 @@ Vector<double> TrainingRateAlgorithm::calculate_golden_section_directional_point
 
 	  Vector<double> X(2);
 	  X[0] = first_training_rate;
-      X[1] = performance_functional_pointer->calculate_directional_performance(training_direction, X[0]);
+      X[1] = calculate_directional_performance(training_direction, X[0]);
 
 	   if(X[1] > performance)
 	   {
@@ -822,6 +928,39 @@ Vector<double> TrainingRateAlgorithm::calculate_Brent_method_directional_point
 	     return(A);
 	  }
 
+      const unsigned int threads_number = count_threads_number();
+
+      if(threads_number > 1)
+      {
+         // Reduce the interval with the minimum of the parabola and evenly spaced training rates
+
+         Vector<double> training_rates(threads_number);
+
+         while(B[0] - A[0] > training_rate_tolerance)
+         {
+            try
+            {
+               training_rates[0] = calculate_Brent_method_training_rate(A, U, B);
+            }
+            catch(std::logic_error&)
+            {
+               training_rates[0] = calculate_golden_section_training_rate(A, U, B);
+            }
+
+            for(unsigned int i = 1; i < threads_number; i++)
+            {
+               training_rates[i] = A[0] + (B[0] - A[0])*i/threads_number;
+            }
+
+            if(!reduce_bracket(training_direction, training_rates, A, U, B))
+            {
+               break;
+            }
+         }
+
+         return(U);
+      }
+
       Vector<double> V(2);
 
       // Reduce the interval
@@ -839,7 +978,7 @@ Vector<double> TrainingRateAlgorithm::calculate_Brent_method_directional_point
 
          // Calculate performance for V
 
-         V[1] = performance_functional_pointer->calculate_directional_performance(training_direction, V[0]);
+         V[1] = calculate_directional_performance(training_direction, V[0]);
 
          // Update points
  
@@ -923,7 +1062,7 @@ Vector<double> TrainingRateAlgorithm::calculate_Brent_method_directional_point
 
 	  Vector<double> X(2);
 	  X[0] = first_training_rate;
-      X[1] = performance_functional_pointer->calculate_directional_performance(training_direction, X[0]);      
+      X[1] = calculate_directional_performance(training_direction, X[0]);      
 
       if(X[1] > performance)
 	  {
@@ -1007,6 +1146,258 @@ double TrainingRateAlgorithm::calculate_Brent_method_training_rate(const Vector<
 }
 
 
+// void clear_directional_performances(const double&) const method
+
+/// This method starts a new line minimization, forgetting the performances evaluated by the previous one. 
+/// @param performance Performance at the current parameters, which is the performance at a zero training rate.
+
+void TrainingRateAlgorithm::clear_directional_performances(const double& performance) const
+{
+   directional_performances.clear();
+
+   directional_performances[0.0] = performance;
+}
+
+
+// double calculate_directional_performance(const Vector<double>&, const double&) const method
+
+/// This method returns the performance at some training rate along the training direction of the current line 
+/// minimization. 
+/// The performance is only evaluated the first time the training rate is met. 
+/// @param training_direction Training direction vector.
+/// @param training_rate Training rate.
+
+double TrainingRateAlgorithm::calculate_directional_performance(const Vector<double>& training_direction, const double& training_rate) const
+{
+   const std::map<double, double>::const_iterator iterator = directional_performances.find(training_rate);
+
+   if(iterator != directional_performances.end())
+   {
+      return(iterator->second);
+   }
+
+   const double performance = performance_functional_pointer->calculate_directional_performance(training_direction, training_rate);
+
+   evaluations_number++;
+
+   directional_performances[training_rate] = performance;
+
+   return(performance);
+}
+
+
+// double calculate_bracketing_directional_performance(const Vector<double>&, const double&, const bool&) const method
+
+/// This method returns the performance at a training rate of the bracketing sequence. 
+/// With several threads, the following training rates of the sequence are evaluated at the same time, up to the 
+/// first one which would stop the bracketing. 
+/// They are computed in the same way as by the bracketing, so that it finds them in the cache. 
+/// @param training_direction Training direction vector.
+/// @param training_rate Training rate.
+/// @param decreasing True if the sequence divides the training rate by the bracketing factor, false if it multiplies it. 
+
+double TrainingRateAlgorithm::calculate_bracketing_directional_performance(const Vector<double>& training_direction, const double& training_rate, const bool& decreasing) const
+{
+   const unsigned int threads_number = count_threads_number();
+
+   if(threads_number > 1 && directional_performances.find(training_rate) == directional_performances.end())
+   {
+      Vector<double> training_rates(threads_number);
+
+      training_rates[0] = training_rate;
+
+      unsigned int training_rates_number = 1;
+
+      while(training_rates_number < threads_number)
+      {
+         const double& last_training_rate = training_rates[training_rates_number-1];
+
+         if(decreasing ? last_training_rate < training_rate_tolerance : last_training_rate > error_training_rate)
+         {
+            break;
+         }
+
+         training_rates[training_rates_number] = decreasing ? last_training_rate/bracketing_factor : last_training_rate*bracketing_factor;
+
+         training_rates_number++;
+      }
+
+      training_rates.resize(training_rates_number);
+
+      calculate_directional_performances(training_direction, training_rates);
+   }
+
+   return(calculate_directional_performance(training_direction, training_rate));
+}
+
+
+// Vector<double> calculate_directional_performances(const Vector<double>&, const Vector<double>&) const method
+
+/// This method returns the performances at some training rates along the training direction of the current line 
+/// minimization. 
+/// The training rates which are not in the cache are evaluated at the same time on the thread pool, if any. 
+/// @param training_direction Training direction vector.
+/// @param training_rates Training rates.
+
+Vector<double> TrainingRateAlgorithm::calculate_directional_performances(const Vector<double>& training_direction, const Vector<double>& training_rates) const
+{
+   const unsigned int training_rates_number = training_rates.size();
+
+   // Training rates to be evaluated, without repetitions
+
+   Vector<double> new_training_rates;
+
+   for(unsigned int i = 0; i < training_rates_number; i++)
+   {
+      if(directional_performances.find(training_rates[i]) == directional_performances.end()
+      && std::find(new_training_rates.begin(), new_training_rates.end(), training_rates[i]) == new_training_rates.end())
+      {
+         new_training_rates.push_back(training_rates[i]);
+      }
+   }
+
+   const unsigned int new_training_rates_number = new_training_rates.size();
+
+   if(thread_pool_pointer && new_training_rates_number > 1)
+   {
+      NeuralNetwork* neural_network_pointer = performance_functional_pointer->get_neural_network_pointer();
+
+      const Vector<double> parameters = neural_network_pointer->arrange_parameters();
+
+      const unsigned int threads_number = thread_pool_pointer->count_threads_number();
+
+      // The copies are made again only if the network or the performance functional are not the copied ones
+
+      if(!thread_copies_pointer
+      || thread_copies_pointer->performance_functional_pointer != performance_functional_pointer
+      || thread_copies_pointer->neural_network_pointer != neural_network_pointer
+      || thread_copies_pointer->parameters_number != parameters.size()
+      || thread_copies_pointer->neural_networks.size() != threads_number)
+      {
+         std::shared_ptr<ThreadCopies> new_thread_copies_pointer(new ThreadCopies);
+
+         new_thread_copies_pointer->performance_functional_pointer = performance_functional_pointer;
+         new_thread_copies_pointer->neural_network_pointer = neural_network_pointer;
+         new_thread_copies_pointer->parameters_number = parameters.size();
+
+         new_thread_copies_pointer->neural_networks.assign(threads_number, *neural_network_pointer);
+         new_thread_copies_pointer->performance_functionals.assign(threads_number, *performance_functional_pointer);
+
+         for(unsigned int i = 0; i < threads_number; i++)
+         {
+            new_thread_copies_pointer->performance_functionals[i].set_neural_network_pointer(&new_thread_copies_pointer->neural_networks[i]);
+
+            // Training rates are the unit of parallelism, so each evaluation runs on a single thread
+
+            new_thread_copies_pointer->performance_functionals[i].set_threads_number(1);
+         }
+
+         thread_copies_pointer = new_thread_copies_pointer;
+      }
+
+      std::vector<NeuralNetwork>& neural_networks = thread_copies_pointer->neural_networks;
+      std::vector<PerformanceFunctional>& performance_functionals = thread_copies_pointer->performance_functionals;
+
+      Vector<double> new_performances(new_training_rates_number);
+
+      thread_pool_pointer->run(new_training_rates_number, [&](const unsigned int& training_rate_index, const unsigned int& thread_index)
+      {
+         neural_networks[thread_index].set_parameters(parameters + training_direction*new_training_rates[training_rate_index]);
+
+         new_performances[training_rate_index] = performance_functionals[thread_index].calculate_evaluation();
+      });
+
+      for(unsigned int i = 0; i < new_training_rates_number; i++)
+      {
+         directional_performances[new_training_rates[i]] = new_performances[i];
+      }
+
+      evaluations_number += new_training_rates_number;
+   }
+
+   Vector<double> performances(training_rates_number);
+
+   for(unsigned int i = 0; i < training_rates_number; i++)
+   {
+      performances[i] = calculate_directional_performance(training_direction, training_rates[i]);
+   }
+
+   return(performances);
+}
+
+
+// bool reduce_bracket(const Vector<double>&, const Vector<double>&, Vector<double>&, Vector<double>&, Vector<double>&) const method
+
+/// This method evaluates some training rates inside a bracket at the same time, and replaces the bracket by the 
+/// point with the lowest performance and its neighbours among the old and the new points. 
+/// It returns false if the bracket does not change. 
+/// @param training_direction Training direction vector.
+/// @param training_rates Training rates to be evaluated. Those outside the bracket are ignored. 
+/// @param A Left point of the bracket. 
+/// @param U Interior point of the bracket. 
+/// @param B Right point of the bracket. 
+
+bool TrainingRateAlgorithm::reduce_bracket(const Vector<double>& training_direction, const Vector<double>& training_rates, Vector<double>& A, Vector<double>& U, Vector<double>& B) const
+{
+   Vector<double> interior_training_rates;
+
+   for(unsigned int i = 0; i < training_rates.size(); i++)
+   {
+      if(training_rates[i] > A[0] && training_rates[i] < B[0] && training_rates[i] != U[0])
+      {
+         interior_training_rates.push_back(training_rates[i]);
+      }
+   }
+
+   if(interior_training_rates.empty())
+   {
+      return(false);
+   }
+
+   const Vector<double> interior_performances = calculate_directional_performances(training_direction, interior_training_rates);
+
+   // Points sorted by training rate
+
+   std::map<double, double> points;
+
+   points[A[0]] = A[1];
+   points[U[0]] = U[1];
+   points[B[0]] = B[1];
+
+   for(unsigned int i = 0; i < interior_training_rates.size(); i++)
+   {
+      points[interior_training_rates[i]] = interior_performances[i];
+   }
+
+   // Lowest interior point, which is U unless a new point is strictly lower
+
+   std::map<double, double>::const_iterator lowest = points.find(U[0]);
+
+   for(std::map<double, double>::const_iterator iterator = ++points.begin(); iterator != --points.end(); ++iterator)
+   {
+      if(iterator->second < lowest->second)
+      {
+         lowest = iterator;
+      }
+   }
+
+   std::map<double, double>::const_iterator left = lowest;
+   std::map<double, double>::const_iterator right = lowest;
+
+   --left;
+   ++right;
+
+   A[0] = left->first;
+   A[1] = left->second;
+   U[0] = lowest->first;
+   U[1] = lowest->second;
+   B[0] = right->first;
+   B[1] = right->second;
+
+   return(true);
+}
+
+
 // TiXmlElement* to_XML(void) const method
 
 /// This method returns a default string representation in XML-type format of the training algorithm object.
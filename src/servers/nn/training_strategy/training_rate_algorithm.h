@@ -16,10 +16,16 @@
 #ifndef __TRAININGRATEALGORITHM_H__
 #define __TRAININGRATEALGORITHM_H__
 
+// System includes
+
+#include <map>
+#include <memory>
+
 // OpenNN includes
 
 #include "../neural_network/neural_network.h"
 #include "../performance_functional/performance_functional.h"
+#include "../utilities/thread_pool.h"
 
 // TinyXml includes
 
@@ -83,6 +89,10 @@ public:
    // Utilities
    
    const bool& get_display(void) const;
+
+   unsigned int count_threads_number(void) const;
+
+   const unsigned int& get_evaluations_number(void) const;
   
    // Set methods
 
@@ -110,8 +120,12 @@ public:
 
    void set_display(const bool&);
 
+   void set_threads_number(const unsigned int&);
+
    virtual void set_default(void);
 
+   void clear_thread_copies(void);
+
    // Training rate method
 
    double calculate_golden_section_training_rate(const Vector<double>&, const Vector<double>&, const Vector<double>&) const;
@@ -133,6 +147,17 @@ public:
 
 protected:
 
+   // Directional evaluations
+
+   void clear_directional_performances(const double&) const;
+
+   double calculate_directional_performance(const Vector<double>&, const double&) const;
+   double calculate_bracketing_directional_performance(const Vector<double>&, const double&, const bool&) const;
+
+   Vector<double> calculate_directional_performances(const Vector<double>&, const Vector<double>&) const;
+
+   bool reduce_bracket(const Vector<double>&, const Vector<double>&, Vector<double>&, Vector<double>&, Vector<double>&) const;
+
    // FIELDS
 
    /// Pointer to an external performance functional object.
@@ -171,6 +196,53 @@ protected:
    /// Display messages to screen.
 
    bool display;
+
+   /// Thread pool which evaluates several training rates at once. 
+   /// It is null when the training rates are evaluated one by one on the calling thread. 
+
+   std::shared_ptr<ThreadPool> thread_pool_pointer;
+
+   /// This structure holds a copy of the neural network and of the performance functional for each thread of the pool. 
+   /// Each performance functional copy evaluates the neural network copy of its thread. 
+
+   struct ThreadCopies
+   {
+      /// Performance functional which was copied. 
+
+      const PerformanceFunctional* performance_functional_pointer;
+
+      /// Neural network which was copied. 
+
+      const NeuralNetwork* neural_network_pointer;
+
+      /// Number of parameters of the neural network when it was copied. 
+
+      unsigned int parameters_number;
+
+      /// Neural network copies, one for each thread. 
+
+      std::vector<NeuralNetwork> neural_networks;
+
+      /// Performance functional copies, one for each thread. 
+
+      std::vector<PerformanceFunctional> performance_functionals;
+   };
+
+   /// Copies used by the threads to evaluate several training rates at once. 
+   /// They are made by the first line minimization which needs them, and only their parameters are set afterwards. 
+   /// It is null until then, and after the thread pool or the performance functional change. 
+
+   mutable std::shared_ptr<ThreadCopies> thread_copies_pointer;
+
+   // DIRECTIONAL EVALUATIONS
+
+   /// Performance at the training rates evaluated during the current line minimization, keyed by training rate. 
+
+   mutable std::map<double, double> directional_performances;
+
+   /// Number of performance evaluations made by all the line minimizations, not counting the ones found in the cache. 
+
+   mutable unsigned int evaluations_number;
 };
 
 }
@@ -1494,34 +1494,234 @@ void TrainingStrategy::from_XML(TiXmlElement* training_strategy_element)
 }
 
 
+// void write_XML(XMLStreamWriter&) const method
+
+/// This method writes the training strategy to a XML stream, in the same format as the to_XML method.
+/// @param writer XML stream which receives the training strategy element.
+
+void TrainingStrategy::write_XML(XMLStreamWriter& writer) const
+{
+   std::ostringstream buffer;
+
+   writer.write_start_element("TrainingStrategy");
+   writer.write_attribute("Version", 4);
+
+   // Training algorithm types
+
+   writer.write_text_element("InitializationTrainingAlgorithmType", write_initialization_training_algorithm_type());
+   writer.write_text_element("MainTrainingAlgorithmType", write_main_training_algorithm_type());
+   writer.write_text_element("RefinementTrainingAlgorithmType", write_refinement_training_algorithm_type());
+
+   // Training algorithm flags
+
+   buffer.str("");
+   buffer << initialization_training_algorithm_flag;
+   writer.write_text_element("InitializationTrainingAlgorithmFlag", buffer.str());
+
+   buffer.str("");
+   buffer << main_training_algorithm_flag;
+   writer.write_text_element("MainTrainingAlgorithmFlag", buffer.str());
+
+   buffer.str("");
+   buffer << refinement_training_algorithm_flag;
+   writer.write_text_element("RefinementTrainingAlgorithmFlag", buffer.str());
+
+   // Training algorithms
+
+   const TrainingAlgorithm* training_algorithms[3] = {initialization_training_algorithm_pointer, main_training_algorithm_pointer, refinement_training_algorithm_pointer};
+
+   for(unsigned int i = 0; i < 3; i++)
+   {
+      if(training_algorithms[i])
+      {
+         TiXmlElement* element = training_algorithms[i]->to_XML();
+         writer.write_element(element);
+         delete element;
+      }
+   }
+
+   // Display
+
+   buffer.str("");
+   buffer << display;
+   writer.write_text_element("Display", buffer.str());
+
+   writer.write_end_element();
+}
+
+
+// void read_XML(XMLStreamReader&) method
+
+/// This method reads a training strategy element from a XML stream, whose start has just been read.
+/// The training algorithm elements are loaded, in the order written by the to_XML method, 
+/// into the initialization, main and refinement training algorithm objects which are set.
+/// @param reader XML stream positioned after the start of the training strategy element.
+
+void TrainingStrategy::read_XML(XMLStreamReader& reader)
+{
+   TrainingAlgorithm* training_algorithms[3] = {initialization_training_algorithm_pointer, main_training_algorithm_pointer, refinement_training_algorithm_pointer};
+
+   unsigned int training_algorithm_index = 0;
+
+   while(reader.read_start_element())
+   {
+      const std::string element_name = reader.get_name();
+
+      if(element_name == "InitializationTrainingAlgorithmType")
+      {
+         const std::string new_initialization_training_algorithm_type = reader.read_text();
+
+         try
+         {
+            set_initialization_training_algorithm_type(new_initialization_training_algorithm_type);
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "MainTrainingAlgorithmType")
+      {
+         const std::string new_main_training_algorithm_type = reader.read_text();
+
+         try
+         {
+            set_main_training_algorithm_type(new_main_training_algorithm_type);
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "RefinementTrainingAlgorithmType")
+      {
+         const std::string new_refinement_training_algorithm_type = reader.read_text();
+
+         try
+         {
+            set_refinement_training_algorithm_type(new_refinement_training_algorithm_type);
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "InitializationTrainingAlgorithmFlag")
+      {
+         const std::string new_initialization_training_algorithm_flag = reader.read_text();
+
+         try
+         {
+            set_initialization_training_algorithm_flag(new_initialization_training_algorithm_flag != "0");
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "MainTrainingAlgorithmFlag")
+      {
+         const std::string new_main_training_algorithm_flag = reader.read_text();
+
+         try
+         {
+            set_main_training_algorithm_flag(new_main_training_algorithm_flag != "0");
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "RefinementTrainingAlgorithmFlag")
+      {
+         const std::string new_refinement_training_algorithm_flag = reader.read_text();
+
+         try
+         {
+            set_refinement_training_algorithm_flag(new_refinement_training_algorithm_flag != "0");
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else if(element_name == "Display")
+      {
+         const std::string new_display = reader.read_text();
+
+         try
+         {
+            set_display(new_display != "0");
+         }
+         catch(std::exception& e)
+         {
+            std::cout << e.what() << std::endl;
+         }
+      }
+      else
+      {
+         // Training algorithm
+
+         TiXmlElement* element = reader.read_element();
+
+         while(training_algorithm_index < 3 && !training_algorithms[training_algorithm_index])
+         {
+            training_algorithm_index++;
+         }
+
+         if(training_algorithm_index < 3)
+         {
+            try
+            {
+               training_algorithms[training_algorithm_index]->from_XML(element);
+            }
+            catch(std::exception& e)
+            {
+               std::cout << e.what() << std::endl;
+            }
+
+            training_algorithm_index++;
+         }
+
+         delete element;
+      }
+   }
+}
+
+
 // void save(const std::string&) const method
 
 /// This method saves to a XML-type file the members of the training algorithm object. 
+/// The file is written as it is generated, without building the XML document in memory.
 /// @param filename Name of training algorithm XML-type file. 
 
 void TrainingStrategy::save(const std::string& filename) const
 {
-   std::ostringstream buffer;
+   std::ofstream file(filename.c_str());
 
-   TiXmlDocument document;
+   if(!file.is_open())
+   {
+      std::ostringstream buffer;
 
-   // Declaration
+      buffer << "OpenNN Exception: TrainingStrategy class.\n"
+             << "void save(const std::string&) const method.\n"
+             << "Cannot open XML file " << filename << ".\n";
 
-   TiXmlDeclaration* declaration = new TiXmlDeclaration("1.0", "", "");
-   document.LinkEndChild(declaration);
+      throw std::logic_error(buffer.str());
+   }
 
-   // Training strategy
+   XMLStreamWriter writer(file);
 
-   TiXmlElement* training_strategy_element = to_XML();
-   document.LinkEndChild(training_strategy_element);
+   writer.write_declaration();
 
-   document.SaveFile(filename.c_str());
+   write_XML(writer);
 }
 
 
 // void load(const std::string&) method
 
-/// This method loads a gradient descent object from a XML-type file. 
+/// This method loads a training strategy object from a XML-type file. 
+/// The file is read sequentially, without building the XML document in memory.
 /// Please mind about the file format, wich is specified in the User's Guide. 
 /// @param filename Name of training algorithm XML-type file. 
 
@@ -1531,9 +1731,9 @@ void TrainingStrategy::load(const std::string& filename)
 
    std::ostringstream buffer;
 
-   TiXmlDocument document(filename.c_str());
+   std::ifstream file(filename.c_str());
 
-   if (!document.LoadFile())
+   if(!file.is_open())
    {
       buffer << "OpenNN Exception: TrainingStrategy class.\n"
              << "void load(const std::string&) method.\n"
@@ -1542,11 +1742,11 @@ void TrainingStrategy::load(const std::string& filename)
       throw std::logic_error(buffer.str());
    }
 
+   XMLStreamReader reader(file);
+
    // Training algorithm element
-  
-   TiXmlElement* training_algorithm_element = document.FirstChildElement("TrainingStrategy");
 
-   if(!training_algorithm_element)
+   if(!reader.read_start_element() || reader.get_name() != "TrainingStrategy")
    {
       buffer << "OpenNN Exception: TrainingStrategy class.\n"
              << "void load(const std::string&) method.\n"
@@ -1554,6 +1754,8 @@ void TrainingStrategy::load(const std::string& filename)
 
       throw std::logic_error(buffer.str());
    }
+
+   read_XML(reader);
 }
 
 
@@ -22,6 +22,8 @@
 
 #include "training_algorithm.h"
 
+#include "../utilities/xml_stream.h"
+
 // TinyXml includes
 
 #include "../tinyxml.h"
@@ -177,6 +179,9 @@ public:
    virtual TiXmlElement* to_XML(void) const;   
    virtual void from_XML(TiXmlElement*);   
 
+   void write_XML(XMLStreamWriter&) const;
+   void read_XML(XMLStreamReader&);
+
    void save(const std::string&) const;
    void load(const std::string&);
 
@@ -1,6 +1,7 @@
 #ifndef MAZUCC_UTIL_H
 #define MAZUCC_UTIL_H
 
+#include <setjmp.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -73,10 +74,26 @@ static inline void string_appendf(String *s, char *fmt, ...)
             error("Assertion failed: " #expr); \
     } while (0)
 
+/* While error_jmp is set, as it is when the JIT reads a module, errors keep
+ * their message in error_message and jump there instead of exiting. The
+ * message is allocated with malloc() and belongs to whoever catches it. */
+extern jmp_buf *error_jmp;
+extern char *error_message;
+
 static inline void errorf(char *file, int line, char *fmt, ...)
 {
-    fprintf(stderr, "%s:%d: ", file, line);
     va_list args;
+    if (error_jmp) {
+        String s = make_string();
+        char buf[256];
+        va_start(args, fmt);
+        vsnprintf(buf, sizeof(buf), fmt, args);
+        va_end(args);
+        string_appendf(&s, "%s:%d: %s", file, line, buf);
+        error_message = s.body;
+        longjmp(*error_jmp, 1);
+    }
+    fprintf(stderr, "%s:%d: ", file, line);
     va_start(args, fmt);
     vfprintf(stderr, fmt, args);
     fprintf(stderr, "\n");
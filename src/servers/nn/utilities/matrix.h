@@ -49,6 +49,8 @@ public:
 
 explicit Matrix(void) 
 {
+   external_data = false;
+
    rows_number = 0;
    columns_number = 0;
    data = NULL;
@@ -62,6 +64,8 @@ explicit Matrix(void)
 
 explicit Matrix(const unsigned int& new_rows_number, const unsigned int& new_columns_number) 
 {
+   external_data = false;
+
    if(new_rows_number == 0 && new_columns_number == 0)
    {
       rows_number = 0;
@@ -111,6 +115,8 @@ explicit Matrix(const unsigned int& new_rows_number, const unsigned int& new_col
 
 explicit Matrix(const unsigned int& new_rows_number, const unsigned int& new_columns_number, const Type& type) 
 {
+   external_data = false;
+
    if(new_rows_number == 0 && new_columns_number == 0)
    {
       rows_number = 0;
@@ -170,6 +176,8 @@ explicit Matrix(const unsigned int& new_rows_number, const unsigned int& new_col
 
 explicit Matrix(const std::string& filename) 
 {
+   external_data = false;
+
    rows_number = 0;
    columns_number = 0;
    data = NULL;
@@ -186,6 +194,8 @@ Matrix(const Matrix& other_matrix)
    const unsigned int new_rows_number = other_matrix.rows_number;
    const unsigned int new_columns_number = other_matrix.columns_number;
 
+   external_data = false;
+
    data = NULL;
 
    if(new_rows_number == 0 && new_columns_number == 0)
@@ -238,17 +248,30 @@ Matrix(const Matrix& other_matrix)
 }
 
 
+/// Move constructor. It takes the elements of a temporary matrix without copying them, and leaves that matrix empty. 
+/// @param other_matrix Matrix to be moved.
+
+Matrix(Matrix&& other_matrix)
+{
+   rows_number = other_matrix.rows_number;
+   columns_number = other_matrix.columns_number;
+   data = other_matrix.data;
+   external_data = other_matrix.external_data;
+
+   other_matrix.rows_number = 0;
+   other_matrix.columns_number = 0;
+   other_matrix.data = NULL;
+   other_matrix.external_data = false;
+}
+
+
 // DESTRUCTOR
 
 /// Destructor. 
 
 ~Matrix(void)
 {
-   if(data != NULL) 
-   {
-      delete[] (data[0]);
-      delete[] (data);
-   }
+   release_data();
 }
 
 
@@ -263,11 +286,7 @@ inline Matrix<Type>& operator = (const Matrix<Type>& other_matrix)
    {
       if(rows_number != other_matrix.rows_number || columns_number != other_matrix.columns_number) // other sizes
       {
-         if(data != NULL) 
-         {
-            delete[] (data[0]);
-            delete[] (data);
-         }
+         release_data();
 
          rows_number = other_matrix.rows_number;
          columns_number = other_matrix.columns_number;
@@ -294,6 +313,22 @@ inline Matrix<Type>& operator = (const Matrix<Type>& other_matrix)
 }
 
 
+/// Move assignment operator. It releases the elements of this matrix and takes those of a temporary matrix without copying them. 
+/// @param other_matrix Matrix to be moved.
+
+inline Matrix<Type>& operator = (Matrix<Type>&& other_matrix)
+{
+   if(this != &other_matrix) 
+   {
+      set();
+
+      swap(other_matrix);
+   }
+
+   return(*this);
+}
+
+
 // REFERENCE OPERATORS
 
 /// Reference operator.  
@@ -840,15 +875,10 @@ const unsigned int& get_columns_number(void) const
 
 void set(void)
 {
-   if(data != NULL) 
-   {
-      delete[] (data[0]);
-      delete[] (data);
-   }
+   release_data();
 
    rows_number = 0;
    columns_number = 0;
-   data = NULL;
 }
 
 
@@ -895,11 +925,7 @@ void set(const unsigned int& new_rows_number, const unsigned int& new_columns_nu
       rows_number = new_rows_number;
       columns_number = new_columns_number;
 
-      if(data != NULL) 
-      {
-         delete[] (data[0]);
-         delete[] (data);
-      }
+      release_data();
 
       data = new Type*[rows_number];
       data[0] = new Type[rows_number*columns_number];
@@ -975,6 +1001,73 @@ void set(const std::string& filename)
 }
 
 
+// void set_external_data(const unsigned int&, const unsigned int&, Type*) method
+
+/// This method makes the matrix refer to an existing block of row-major elements, such as a memory mapped file, 
+/// without copying them. 
+/// The matrix does not own that block, so it is never freed by the matrix, and any later change of size allocates new storage. 
+/// The caller must keep the block alive while the matrix refers to it. 
+/// @param new_rows_number Number of rows.
+/// @param new_columns_number Number of columns.
+/// @param new_data Pointer to the first of new_rows_number*new_columns_number elements.
+
+void set_external_data(const unsigned int& new_rows_number, const unsigned int& new_columns_number, Type* new_data)
+{
+   // Control sentence
+
+   if(new_rows_number == 0 || new_columns_number == 0 || new_data == NULL)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: Matrix Template.\n" 
+             << "void set_external_data(const unsigned int&, const unsigned int&, Type*) method.\n"
+             << "Numbers of rows and columns must be greater than zero and data must not be NULL.\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   release_data();
+
+   rows_number = new_rows_number;
+   columns_number = new_columns_number;
+
+   data = new Type*[rows_number];
+   data[0] = new_data;
+
+   for(unsigned int i = 1; i < rows_number; i++)
+   {
+      data[i] = data[i-1] + columns_number;
+   }
+
+   external_data = true;
+}
+
+
+// bool has_external_data(void) const method
+
+/// This method returns true if the elements of this matrix are stored in a block which the matrix does not own, 
+/// and false otherwise. 
+
+bool has_external_data(void) const
+{
+   return(external_data);
+}
+
+
+// void swap(Matrix<Type>&) method
+
+/// This method exchanges the sizes and elements of this matrix with those of another matrix, without copying the elements. 
+/// @param other_matrix Matrix to be exchanged with this one.
+
+void swap(Matrix<Type>& other_matrix)
+{
+   std::swap(rows_number, other_matrix.rows_number);
+   std::swap(columns_number, other_matrix.columns_number);
+   std::swap(data, other_matrix.data);
+   std::swap(external_data, other_matrix.external_data);
+}
+
+
 // void set_identity(unsigned int) method
 
 /// This method sets the matrix to be squared, with elements equal one in the diagonal and zero outside the diagonal. 
@@ -1035,13 +1128,7 @@ void resize(const unsigned int& new_rows_number, const unsigned int& new_columns
       rows_number = 0;
       columns_number = 0;
 
-      if(data != NULL) 
-      {
-         delete[] (data[0]);
-         delete[] (data);
-      }
-
-      data = NULL;    
+      release_data();
    }
    else if(new_rows_number == 0)
    {
@@ -3551,12 +3638,17 @@ Matrix<Type> calculate_transpose(void) const
 }
 
 
-// Type calculate_determinant(void) const method
+// void factorize_LU(Vector<unsigned int>&) method
 
-/// This method returns the determinant of a square matrix. 
+/// This method replaces this square matrix by its LU factorization with partial pivoting, PA = LU. 
+/// On output the strictly lower triangle holds L, whose diagonal elements are one and are not stored, 
+/// and the upper triangle holds U. 
+/// A singular matrix is factorized too, leaving a zero in the diagonal of U. 
+/// @param row_indices Permutation P. On output, row i of the factorization corresponds to row row_indices[i] of the original matrix. 
+/// The method returns the number of row interchanges, so that the sign of the permutation is (-1)^interchanges. 
 
-Type calculate_determinant(void) const
-{ 
+unsigned int factorize_LU(Vector<unsigned int>& row_indices)
+{
    // Control sentence (if debug)
 
    #ifdef _DEBUG 
@@ -3566,7 +3658,7 @@ Type calculate_determinant(void) const
       std::ostringstream buffer;
 
       buffer << "OpenNN Exception: Matrix Template.\n"
-             << "calculate_determinant(void) const method.\n"
+             << "unsigned int factorize_LU(Vector<unsigned int>&) method.\n"
              << "Matrix must be square.\n";
       
       throw std::logic_error(buffer.str());
@@ -3574,58 +3666,372 @@ Type calculate_determinant(void) const
 
    #endif
 
-   Type determinant = 0;
-   
-   if(rows_number == 0)
+   const unsigned int n = rows_number;
+
+   row_indices.set(n);
+
+   for(unsigned int i = 0; i < n; i++)
+   {
+      row_indices[i] = i;
+   }
+
+   unsigned int interchanges_number = 0;
+
+   for(unsigned int k = 0; k < n; k++)
+   {
+      // Partial pivoting
+
+      unsigned int pivot_index = k;
+      Type pivot_magnitude = fabs(data[k][k]);
+
+      for(unsigned int i = k+1; i < n; i++)
+      {
+         if(fabs(data[i][k]) > pivot_magnitude)
+         {
+            pivot_index = i;
+            pivot_magnitude = fabs(data[i][k]);
+         }
+      }
+
+      if(pivot_index != k)
+      {
+         for(unsigned int j = 0; j < n; j++)
+         {
+            const Type element = data[k][j];
+            data[k][j] = data[pivot_index][j];
+            data[pivot_index][j] = element;
+         }
+
+         const unsigned int row_index = row_indices[k];
+         row_indices[k] = row_indices[pivot_index];
+         row_indices[pivot_index] = row_index;
+
+         interchanges_number++;
+      }
+
+      if(data[k][k] == 0)
+      {
+         continue;
+      }
+
+      // Eliminate below the pivot, updating the trailing submatrix row by row
+
+      const Type* pivot_row = data[k];
+
+      for(unsigned int i = k+1; i < n; i++)
+      {
+         Type* row = data[i];
+
+         const Type multiplier = row[k]/pivot_row[k];
+
+         row[k] = multiplier;
+
+         for(unsigned int j = k+1; j < n; j++)
+         {
+            row[j] -= multiplier*pivot_row[j];
+         }
+      }
+   }
+
+   return(interchanges_number);
+}
+
+
+// Vector<Type> solve_LU(const Vector<unsigned int>&, const Vector<Type>&) const method
+
+/// This method solves the linear system Ax = b, where this matrix holds the LU factorization of A 
+/// computed by the factorize_LU method. 
+/// @param row_indices Permutation returned by factorize_LU. 
+/// @param b Right hand side vector. 
+
+Vector<Type> solve_LU(const Vector<unsigned int>& row_indices, const Vector<Type>& b) const
+{
+   const unsigned int n = rows_number;
+
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   if(b.size() != n || row_indices.size() != n)
    {
       std::ostringstream buffer;
 
       buffer << "OpenNN Exception: Matrix Template.\n"
-             << "calculate_determinant(void) const method.\n"
-             << "Size of matrix is zero.\n";
+             << "Vector<Type> solve_LU(const Vector<unsigned int>&, const Vector<Type>&) const method.\n"
+             << "Sizes of permutation and right hand side must be equal to number of rows.\n";
       
       throw std::logic_error(buffer.str());
    }
-   else if(rows_number == 1)
+
+   #endif
+
+   for(unsigned int i = 0; i < n; i++)
    {
-      determinant = data[0][0];                   
+      if(data[i][i] == 0)
+      {
+         std::ostringstream buffer;
+
+         buffer << "OpenNN Exception: Matrix Template.\n"
+                << "Vector<Type> solve_LU(const Vector<unsigned int>&, const Vector<Type>&) const method.\n"
+                << "Matrix is singular.\n";
+      
+         throw std::logic_error(buffer.str());
+      }
    }
-   else if(rows_number == 2)
+
+   Vector<Type> x(n);
+
+   // Forward substitution, Ly = Pb
+
+   for(unsigned int i = 0; i < n; i++)
    {
-      determinant = data[0][0]*data[1][1] - data[1][0]*data[0][1];
+      Type sum = b[row_indices[i]];
+
+      for(unsigned int j = 0; j < i; j++)
+      {
+         sum -= data[i][j]*x[j];
+      }
+
+      x[i] = sum;
    }
-   else
+
+   // Back substitution, Ux = y
+
+   for(int i = (int)n-1; i >= 0; i--)
    {
-      unsigned int sign;
+      Type sum = x[i];
 
-      for(unsigned int row_index = 0; row_index < rows_number; row_index++) 
+      for(unsigned int j = i+1; j < n; j++)
       {
-         // Calculate sub data
- 
-         Matrix<Type> sub_matrix(rows_number-1, columns_number-1);     
-     
-         for(unsigned int i = 1; i < rows_number; i++) 
-         {
-            unsigned int j2 = 0;
+         sum -= data[i][j]*x[j];
+      }
+
+      x[i] = sum/data[i][i];
+   }
+
+   return(x);
+}
+
+
+// Vector<Type> calculate_LU_solution(const Vector<Type>&) const method
+
+/// This method returns the solution x of the linear system Ax = b, being A this square matrix. 
+/// It uses LU factorization with partial pivoting, and it throws an exception if the matrix is singular. 
+/// @param b Right hand side vector. 
+
+Vector<Type> calculate_LU_solution(const Vector<Type>& b) const
+{
+   Matrix<Type> LU(*this);
+
+   Vector<unsigned int> row_indices;
+
+   LU.factorize_LU(row_indices);
+
+   return(LU.solve_LU(row_indices, b));
+}
+
+
+// void factorize_Cholesky(void) method
+
+/// This method replaces this symmetric positive definite matrix by its Cholesky factor L, with A = LL^T. 
+/// Only the lower triangle of the matrix is read, and the upper triangle is set to zero on output. 
+/// The method throws an exception if the matrix is not positive definite. 
+
+void factorize_Cholesky(void)
+{
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   if(rows_number != columns_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: Matrix Template.\n"
+             << "void factorize_Cholesky(void) method.\n"
+             << "Matrix must be square.\n";
       
-            for(unsigned int j = 0; j < columns_number; j++) 
-            {
-               if(j == row_index)
-               {
-                  continue;
-               }
+      throw std::logic_error(buffer.str());
+   }
 
-               sub_matrix[i-1][j2] = data[i][j];
+   #endif
 
-               j2++;
-            }
+   const unsigned int n = rows_number;
+
+   for(unsigned int j = 0; j < n; j++)
+   {
+      Type* row_j = data[j];
+
+      // Diagonal element
+
+      Type diagonal = row_j[j];
+
+      for(unsigned int k = 0; k < j; k++)
+      {
+         diagonal -= row_j[k]*row_j[k];
+      }
+
+      if(!(diagonal > 0))
+      {
+         std::ostringstream buffer;
+
+         buffer << "OpenNN Exception: Matrix Template.\n"
+                << "void factorize_Cholesky(void) method.\n"
+                << "Matrix is not positive definite.\n";
+      
+         throw std::logic_error(buffer.str());
+      }
+
+      row_j[j] = sqrt(diagonal);
+
+      // Elements below the diagonal in column j
+
+      for(unsigned int i = j+1; i < n; i++)
+      {
+         Type* row_i = data[i];
+
+         Type sum = row_i[j];
+
+         for(unsigned int k = 0; k < j; k++)
+         {
+            sum -= row_i[k]*row_j[k];
          }
 
-         sign = (unsigned int)(pow(-1.0, row_index+2.0));
-       
-         determinant += sign*data[0][row_index]*sub_matrix.calculate_determinant();    
+         row_i[j] = sum/row_j[j];
+      }
+
+      for(unsigned int k = j+1; k < n; k++)
+      {
+         row_j[k] = 0;
       }
    }
+}
+
+
+// Vector<Type> solve_Cholesky(const Vector<Type>&) const method
+
+/// This method solves the linear system Ax = b, where this matrix holds the Cholesky factor of A 
+/// computed by the factorize_Cholesky method. 
+/// @param b Right hand side vector. 
+
+Vector<Type> solve_Cholesky(const Vector<Type>& b) const
+{
+   const unsigned int n = rows_number;
+
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   if(b.size() != n)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: Matrix Template.\n"
+             << "Vector<Type> solve_Cholesky(const Vector<Type>&) const method.\n"
+             << "Size of right hand side must be equal to number of rows.\n";
+      
+      throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   Vector<Type> x(b);
+
+   // Forward substitution, Ly = b
+
+   for(unsigned int i = 0; i < n; i++)
+   {
+      Type sum = x[i];
+
+      for(unsigned int j = 0; j < i; j++)
+      {
+         sum -= data[i][j]*x[j];
+      }
+
+      x[i] = sum/data[i][i];
+   }
+
+   // Back substitution, L^T x = y
+
+   for(int i = (int)n-1; i >= 0; i--)
+   {
+      Type sum = x[i];
+
+      for(unsigned int j = i+1; j < n; j++)
+      {
+         sum -= data[j][i]*x[j];
+      }
+
+      x[i] = sum/data[i][i];
+   }
+
+   return(x);
+}
+
+
+// Vector<Type> calculate_Cholesky_solution(const Vector<Type>&) const method
+
+/// This method returns the solution x of the linear system Ax = b, being A this symmetric positive definite matrix. 
+/// It uses the Cholesky factorization, and it throws an exception if the matrix is not positive definite. 
+/// @param b Right hand side vector. 
+
+Vector<Type> calculate_Cholesky_solution(const Vector<Type>& b) const
+{
+   Matrix<Type> L(*this);
+
+   L.factorize_Cholesky();
+
+   return(L.solve_Cholesky(b));
+}
+
+
+// Type calculate_determinant(void) const method
+
+/// This method returns the determinant of a square matrix. 
+/// It is the product of the diagonal of the LU factorization, with the sign of the row permutation. 
+
+Type calculate_determinant(void) const
+{ 
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+
+   if(rows_number != columns_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: Matrix Template.\n"
+             << "calculate_determinant(void) const method.\n"
+             << "Matrix must be square.\n";
+      
+      throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   if(rows_number == 0)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: Matrix Template.\n"
+             << "calculate_determinant(void) const method.\n"
+             << "Size of matrix is zero.\n";
+      
+      throw std::logic_error(buffer.str());
+   }
+
+   Matrix<Type> LU(*this);
+
+   Vector<unsigned int> row_indices;
+
+   const unsigned int interchanges_number = LU.factorize_LU(row_indices);
+
+   Type determinant = (interchanges_number%2 == 0) ? 1 : -1;
+
+   for(unsigned int i = 0; i < rows_number; i++)
+   {
+      determinant *= LU[i][i];
+   }
      
    return(determinant);
 }
@@ -3683,8 +4089,10 @@ Matrix<Type> calculate_cofactor(void) const
 
 // Matrix<Type> calculate_inverse(void) const method
 
-/// This method returns the inverse of a square matrix.
-/// An error message is printed if the matrix is singular.
+/// This method returns the inverse of a square matrix, which is computed column by column from its LU factorization.
+/// An exception is thrown if the matrix is singular.
+/// Solving a linear system with calculate_LU_solution or calculate_Cholesky_solution is cheaper and more accurate 
+/// than multiplying by the inverse.
 
 Matrix<Type> calculate_inverse(void) const
 {
@@ -3705,30 +4113,24 @@ Matrix<Type> calculate_inverse(void) const
 
    #endif
 
-   const double determinant = calculate_determinant();
+   Matrix<Type> LU(*this);
 
-   if(determinant == 0.0)
-   {
-      std::ostringstream buffer;
+   Vector<unsigned int> row_indices;
 
-      buffer << "OpenNN Exception: Matrix Template.\n"
-             << "calculate_inverse(void) const method.\n"
-             << "Matrix is singular.\n";
-      
-      throw std::logic_error(buffer.str());
-   }
-   
-   // Calculate cofactor matrix
-   
-   const Matrix<double> cofactor = calculate_cofactor();
+   LU.factorize_LU(row_indices);
 
-   // Adjoint matrix is the transpose of cofactor matrix
+   Matrix<Type> inverse(rows_number, columns_number);
 
-   const Matrix<double> adjoint = cofactor.calculate_transpose();
-   
-   // Inverse matrix is adjoint matrix divided by matrix determinant
+   Vector<Type> unit(rows_number, 0);
+
+   for(unsigned int j = 0; j < columns_number; j++)
+   {
+      unit[j] = 1;
+
+      inverse.set_column(j, LU.solve_LU(row_indices, unit));
 
-   const Matrix<double> inverse = adjoint/determinant;
+      unit[j] = 0;
+   }
 
    return(inverse);
 }
@@ -4422,18 +4824,15 @@ Vector<Type> dot(const Vector<Type>& vector) const
 
    // Calculate matrix-vector poduct   
       
-   Vector<Type> product(rows_number);
+   Vector<Type> product(rows_number, 0);
 
-   for(unsigned int i = 0; i < rows_number; i++)
-   {     
-      product[i] = 0;      
-
-      for(unsigned int j = 0; j < columns_number; j++)
-      {
-         product[i] += vector[j]*data[i][j];
-      }
+   if(rows_number == 0 || columns_number == 0)
+   {
+      return(product);
    }
 
+   MatrixKernels::gemv(rows_number, columns_number, data[0], columns_number, &vector[0], &product[0]);
+
    return(product);
 }
 
@@ -4441,7 +4840,7 @@ Vector<Type> dot(const Vector<Type>& vector) const
 // Matrix<Type> dot(const Matrix<Type>&) const method
 
 /// This method returns the dot product of this matrix with another matrix. 
-///
+/// The product is computed by the blocked kernel in matrix_kernels.h.
 /// @param other_matrix Matrix to be multiplied to this matrix.
 
 Matrix<Type> dot(const Matrix<Type>& other_matrix) const
@@ -4469,21 +4868,68 @@ Matrix<Type> dot(const Matrix<Type>& other_matrix) const
 
    Matrix<Type> product(rows_number, other_columns_number, 0.0);
 
-   for(unsigned int i = 0; i < rows_number; i++)
+   if(rows_number == 0 || other_columns_number == 0 || columns_number == 0)
    {
-      for(unsigned int j = 0; j < other_columns_number; j++)
-      { 
-         for(unsigned int k = 0; k < columns_number; k++)
-         {
-             product[i][j] += data[i][k]*other_matrix[k][j];
-         }
-      }
+      return(product);
    }
 
+   // Packed, cache blocked product
+
+   MatrixKernels::gemm(rows_number, other_columns_number, columns_number,
+                       data[0], columns_number,
+                       other_matrix[0], other_columns_number,
+                       product[0], other_columns_number);
+
    return(product);
 }
 
 
+// void dot(const Matrix<Type>&, Matrix<Type>&) const method
+
+/// This method writes the dot product of this matrix with another matrix into a given matrix. 
+/// The storage of the product matrix is reused if it already has the right size. 
+/// @param other_matrix Matrix to be multiplied to this matrix.
+/// @param product Matrix to be set to the product. It must not be this matrix or the other matrix.
+
+void dot(const Matrix<Type>& other_matrix, Matrix<Type>& product) const
+{
+   const unsigned int other_columns_number = other_matrix.get_columns_number();    
+
+   // Control sentence (if debug)
+
+   #ifdef _DEBUG 
+       
+   const unsigned int other_rows_number = other_matrix.get_rows_number();
+
+   if(other_rows_number != columns_number)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: Matrix Template.\n" 
+             << "void dot(const Matrix<Type>&, Matrix<Type>&) const method.\n"
+             << "The number of rows of the other matrix (" << other_rows_number << ") must be equal to the number of columns of this matrix (" << columns_number << ").\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   if(rows_number == 0 || other_columns_number == 0)
+   {
+      product.set();
+
+      return;
+   }
+
+   product.set(rows_number, other_columns_number);
+
+   MatrixKernels::gemm(rows_number, other_columns_number, columns_number,
+                       data[0], columns_number,
+                       other_matrix[0], other_columns_number,
+                       product[0], other_columns_number);
+}
+
+
 // Matrix<Type> direct(const Matrix<Type>&) const method 
 
 /// This method calculates the direct product of this matrix with another matrix. 
@@ -4936,6 +5382,32 @@ unsigned int columns_number;
 
 Type** data;
 
+/// True if data[0] points to a block of elements which this matrix does not own.
+
+bool external_data;
+
+// void release_data(void) method
+
+/// This method frees the storage of the matrix, except for an external block of elements, and leaves data set to NULL. 
+/// It does not modify the numbers of rows and columns. 
+
+void release_data(void)
+{
+   if(data != NULL) 
+   {
+      if(!external_data)
+      {
+         delete[] (data[0]);
+      }
+
+      delete[] (data);
+   }
+
+   data = NULL;
+   external_data = false;
+}
+
+
 // double calculate_random_uniform(const double&, const double&) const method
 
 /// This method returns a random number chosen from a uniform distribution.
@@ -0,0 +1,921 @@
+/****************************************************************************************************************/
+/*                                                                                                              */
+/*   OpenNN: Open Neural Networks Library                                                                       */
+/*   www.opennn.cimne.com                                                                                       */
+/*                                                                                                              */
+/*   M A T R I X   K E R N E L S                                                                                */
+/*                                                                                                              */
+/*   Roberto Lopez                                                                                              */
+/*   International Center for Numerical Methods in Engineering (CIMNE)                                          */
+/*   Technical University of Catalonia (UPC)                                                                    */
+/*   Barcelona, Spain                                                                                           */
+/*   E-mail: rlopez@cimne.upc.edu                                                                               */
+/*                                                                                                              */
+/****************************************************************************************************************/
+
+#ifndef __MATRIXKERNELS_H__
+#define __MATRIXKERNELS_H__
+
+// System includes
+
+#include <cstddef>
+#include <vector>
+
+// The double precision kernels use SSE2/AVX2 paths selected at run time.
+// Other targets, and compilers older than gcc 5, get the scalar code only.
+// The packing buffers are thread_local, so the file needs a C++11 compiler in any case (not gcc2).
+
+#if defined(__GNUC__) && (__GNUC__ >= 5) && (defined(__x86_64__) || defined(__i386__))
+   #define __OPENNN_KERNELS_X86__
+   #include <immintrin.h>
+#endif
+
+namespace OpenNN
+{
+
+/// This namespace contains the low level dense linear algebra kernels used by the Vector and Matrix templates.
+/// All the matrices are row major and contiguous, with an explicit leading dimension.
+/// The general template versions are cache friendly loops valid for any arithmetic type.
+/// The double precision versions pack the operands into cache sized blocks and dispatch at run time to SSE2 or AVX2 micro-kernels.
+
+namespace MatrixKernels
+{
+
+// Blocking parameters for the double precision matrix product.
+// A panel of kc x nc doubles of the right operand is packed to stay in L2/L3,
+// a block of mc x kc doubles of the left operand is packed to stay in L2,
+// and the micro-kernel updates a mr x nr tile of the product held in registers.
+
+const unsigned int mr = 4;
+const unsigned int nr = 8;
+
+const unsigned int mc = 128;
+const unsigned int kc = 256;
+const unsigned int nc = 2048;
+
+/// Under this number of multiply-add operations packing does not pay off and a plain loop is used.
+
+const std::size_t small_product_size = 32*32*32;
+
+
+/// Instruction sets which the double precision kernels can use.
+
+enum InstructionSet{Scalar, SSE2, AVX2};
+
+
+// Type dot(const unsigned int&, const Type*, const Type*) function
+
+/// This function returns the dot product of two contiguous arrays.
+/// @param n Size of the arrays.
+/// @param x First array.
+/// @param y Second array.
+
+template<class Type>
+inline Type dot(const unsigned int& n, const Type* x, const Type* y)
+{
+   Type dot_product = 0;
+
+   for(unsigned int i = 0; i < n; i++)
+   {
+      dot_product += x[i]*y[i];
+   }
+
+   return(dot_product);
+}
+
+
+// void gemv(const unsigned int&, const unsigned int&, const Type*, const unsigned int&, const Type*, Type*) function
+
+/// This function computes y = A*x, where A is a row major matrix.
+/// @param m Number of rows of A.
+/// @param n Number of columns of A.
+/// @param a Matrix A.
+/// @param lda Leading dimension of A.
+/// @param x Vector of size n.
+/// @param y Vector of size m.
+
+template<class Type>
+inline void gemv(const unsigned int& m, const unsigned int& n, const Type* a, const unsigned int& lda, const Type* x, Type* y)
+{
+   for(unsigned int i = 0; i < m; i++)
+   {
+      y[i] = dot(n, a + (std::size_t)i*lda, x);
+   }
+}
+
+
+// void gemv_transpose(const unsigned int&, const unsigned int&, const Type*, const unsigned int&, const Type*, Type*) function
+
+/// This function computes y = A^T*x, where A is a row major matrix.
+/// The rows of A are accumulated in turn, so that the matrix is traversed with unit stride.
+/// @param m Number of rows of A.
+/// @param n Number of columns of A.
+/// @param a Matrix A.
+/// @param lda Leading dimension of A.
+/// @param x Vector of size m.
+/// @param y Vector of size n.
+
+template<class Type>
+inline void gemv_transpose(const unsigned int& m, const unsigned int& n, const Type* a, const unsigned int& lda, const Type* x, Type* y)
+{
+   for(unsigned int j = 0; j < n; j++)
+   {
+      y[j] = 0;
+   }
+
+   for(unsigned int i = 0; i < m; i++)
+   {
+      const Type* row = a + (std::size_t)i*lda;
+      const Type x_i = x[i];
+
+      for(unsigned int j = 0; j < n; j++)
+      {
+         y[j] += x_i*row[j];
+      }
+   }
+}
+
+
+// void gemm(const unsigned int&, const unsigned int&, const unsigned int&, const Type*, const unsigned int&, const Type*, const unsigned int&, Type*, const unsigned int&) function
+
+/// This function computes C = A*B, where all the matrices are row major.
+/// The general version blocks over the inner dimension and uses the i-k-j loop order, so that B and C are traversed with unit stride.
+/// @param m Number of rows of A and C.
+/// @param n Number of columns of B and C.
+/// @param k Number of columns of A and rows of B.
+/// @param a Matrix A.
+/// @param lda Leading dimension of A.
+/// @param b Matrix B.
+/// @param ldb Leading dimension of B.
+/// @param c Matrix C.
+/// @param ldc Leading dimension of C.
+
+template<class Type>
+inline void gemm(const unsigned int& m, const unsigned int& n, const unsigned int& k,
+                 const Type* a, const unsigned int& lda,
+                 const Type* b, const unsigned int& ldb,
+                 Type* c, const unsigned int& ldc)
+{
+   for(unsigned int i = 0; i < m; i++)
+   {
+      Type* c_row = c + (std::size_t)i*ldc;
+
+      for(unsigned int j = 0; j < n; j++)
+      {
+         c_row[j] = 0;
+      }
+   }
+
+   for(unsigned int p0 = 0; p0 < k; p0 += kc)
+   {
+      const unsigned int p1 = (p0 + kc < k) ? p0 + kc : k;
+
+      for(unsigned int i = 0; i < m; i++)
+      {
+         Type* c_row = c + (std::size_t)i*ldc;
+         const Type* a_row = a + (std::size_t)i*lda;
+
+         for(unsigned int p = p0; p < p1; p++)
+         {
+            const Type a_ip = a_row[p];
+            const Type* b_row = b + (std::size_t)p*ldb;
+
+            for(unsigned int j = 0; j < n; j++)
+            {
+               c_row[j] += a_ip*b_row[j];
+            }
+         }
+      }
+   }
+}
+
+
+// Double precision micro-kernels
+
+// void pack_a(const unsigned int&, const unsigned int&, const double*, const unsigned int&, double*) function
+
+/// This function copies a block of A into strips of mr rows, stored column by column and padded with zeros.
+
+inline void pack_a(const unsigned int& rows, const unsigned int& depth, const double* a, const unsigned int& lda, double* packed)
+{
+   for(unsigned int i0 = 0; i0 < rows; i0 += mr)
+   {
+      const unsigned int strip_rows = (i0 + mr < rows) ? mr : rows - i0;
+
+      for(unsigned int p = 0; p < depth; p++)
+      {
+         unsigned int i = 0;
+
+         for(; i < strip_rows; i++)
+         {
+            *packed++ = a[(std::size_t)(i0 + i)*lda + p];
+         }
+         for(; i < mr; i++)
+         {
+            *packed++ = 0.0;
+         }
+      }
+   }
+}
+
+
+// void pack_b(const unsigned int&, const unsigned int&, const double*, const unsigned int&, double*) function
+
+/// This function copies a panel of B into strips of nr columns, stored row by row and padded with zeros.
+
+inline void pack_b(const unsigned int& depth, const unsigned int& columns, const double* b, const unsigned int& ldb, double* packed)
+{
+   for(unsigned int j0 = 0; j0 < columns; j0 += nr)
+   {
+      const unsigned int strip_columns = (j0 + nr < columns) ? nr : columns - j0;
+
+      for(unsigned int p = 0; p < depth; p++)
+      {
+         const double* b_row = b + (std::size_t)p*ldb + j0;
+
+         unsigned int j = 0;
+
+         for(; j < strip_columns; j++)
+         {
+            *packed++ = b_row[j];
+         }
+         for(; j < nr; j++)
+         {
+            *packed++ = 0.0;
+         }
+      }
+   }
+}
+
+
+/// Signature of the mr x nr micro-kernels.
+/// They compute the product of a packed strip of A by a packed strip of B and add it to a tile of C.
+
+typedef void (*MicroKernel)(const unsigned int&, const double*, const double*, double*, const unsigned int&);
+
+
+// void micro_kernel_scalar(const unsigned int&, const double*, const double*, double*, const unsigned int&) function
+
+/// Portable micro-kernel.
+
+inline void micro_kernel_scalar(const unsigned int& depth, const double* a, const double* b, double* c, const unsigned int& ldc)
+{
+   double accumulator[mr][nr] = {{0.0}};
+
+   for(unsigned int p = 0; p < depth; p++)
+   {
+      for(unsigned int i = 0; i < mr; i++)
+      {
+         const double a_ip = a[i];
+
+         for(unsigned int j = 0; j < nr; j++)
+         {
+            accumulator[i][j] += a_ip*b[j];
+         }
+      }
+
+      a += mr;
+      b += nr;
+   }
+
+   for(unsigned int i = 0; i < mr; i++)
+   {
+      for(unsigned int j = 0; j < nr; j++)
+      {
+         c[(std::size_t)i*ldc + j] += accumulator[i][j];
+      }
+   }
+}
+
+
+#ifdef __OPENNN_KERNELS_X86__
+
+// void micro_kernel_sse2(const unsigned int&, const double*, const double*, double*, const unsigned int&) function
+
+/// SSE2 micro-kernel. The 4x8 tile needs sixteen xmm accumulators, and the four B vectors and the broadcast A value
+/// bring the live values to 21. That is more than the sixteen xmm registers of x86-64, so the compiler spills some of them.
+
+__attribute__((target("sse2")))
+inline void micro_kernel_sse2(const unsigned int& depth, const double* a, const double* b, double* c, const unsigned int& ldc)
+{
+   __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd(), c02 = _mm_setzero_pd(), c03 = _mm_setzero_pd();
+   __m128d c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd(), c12 = _mm_setzero_pd(), c13 = _mm_setzero_pd();
+   __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd(), c22 = _mm_setzero_pd(), c23 = _mm_setzero_pd();
+   __m128d c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd(), c32 = _mm_setzero_pd(), c33 = _mm_setzero_pd();
+
+   for(unsigned int p = 0; p < depth; p++)
+   {
+      const __m128d b0 = _mm_loadu_pd(b);
+      const __m128d b1 = _mm_loadu_pd(b + 2);
+      const __m128d b2 = _mm_loadu_pd(b + 4);
+      const __m128d b3 = _mm_loadu_pd(b + 6);
+
+      __m128d a_i = _mm_set1_pd(a[0]);
+      c00 = _mm_add_pd(c00, _mm_mul_pd(a_i, b0)); c01 = _mm_add_pd(c01, _mm_mul_pd(a_i, b1));
+      c02 = _mm_add_pd(c02, _mm_mul_pd(a_i, b2)); c03 = _mm_add_pd(c03, _mm_mul_pd(a_i, b3));
+
+      a_i = _mm_set1_pd(a[1]);
+      c10 = _mm_add_pd(c10, _mm_mul_pd(a_i, b0)); c11 = _mm_add_pd(c11, _mm_mul_pd(a_i, b1));
+      c12 = _mm_add_pd(c12, _mm_mul_pd(a_i, b2)); c13 = _mm_add_pd(c13, _mm_mul_pd(a_i, b3));
+
+      a_i = _mm_set1_pd(a[2]);
+      c20 = _mm_add_pd(c20, _mm_mul_pd(a_i, b0)); c21 = _mm_add_pd(c21, _mm_mul_pd(a_i, b1));
+      c22 = _mm_add_pd(c22, _mm_mul_pd(a_i, b2)); c23 = _mm_add_pd(c23, _mm_mul_pd(a_i, b3));
+
+      a_i = _mm_set1_pd(a[3]);
+      c30 = _mm_add_pd(c30, _mm_mul_pd(a_i, b0)); c31 = _mm_add_pd(c31, _mm_mul_pd(a_i, b1));
+      c32 = _mm_add_pd(c32, _mm_mul_pd(a_i, b2)); c33 = _mm_add_pd(c33, _mm_mul_pd(a_i, b3));
+
+      a += mr;
+      b += nr;
+   }
+
+   double* c0 = c;
+   double* c1 = c + ldc;
+   double* c2 = c + 2*(std::size_t)ldc;
+   double* c3 = c + 3*(std::size_t)ldc;
+
+   _mm_storeu_pd(c0, _mm_add_pd(_mm_loadu_pd(c0), c00)); _mm_storeu_pd(c0 + 2, _mm_add_pd(_mm_loadu_pd(c0 + 2), c01));
+   _mm_storeu_pd(c0 + 4, _mm_add_pd(_mm_loadu_pd(c0 + 4), c02)); _mm_storeu_pd(c0 + 6, _mm_add_pd(_mm_loadu_pd(c0 + 6), c03));
+   _mm_storeu_pd(c1, _mm_add_pd(_mm_loadu_pd(c1), c10)); _mm_storeu_pd(c1 + 2, _mm_add_pd(_mm_loadu_pd(c1 + 2), c11));
+   _mm_storeu_pd(c1 + 4, _mm_add_pd(_mm_loadu_pd(c1 + 4), c12)); _mm_storeu_pd(c1 + 6, _mm_add_pd(_mm_loadu_pd(c1 + 6), c13));
+   _mm_storeu_pd(c2, _mm_add_pd(_mm_loadu_pd(c2), c20)); _mm_storeu_pd(c2 + 2, _mm_add_pd(_mm_loadu_pd(c2 + 2), c21));
+   _mm_storeu_pd(c2 + 4, _mm_add_pd(_mm_loadu_pd(c2 + 4), c22)); _mm_storeu_pd(c2 + 6, _mm_add_pd(_mm_loadu_pd(c2 + 6), c23));
+   _mm_storeu_pd(c3, _mm_add_pd(_mm_loadu_pd(c3), c30)); _mm_storeu_pd(c3 + 2, _mm_add_pd(_mm_loadu_pd(c3 + 2), c31));
+   _mm_storeu_pd(c3 + 4, _mm_add_pd(_mm_loadu_pd(c3 + 4), c32)); _mm_storeu_pd(c3 + 6, _mm_add_pd(_mm_loadu_pd(c3 + 6), c33));
+}
+
+
+// void micro_kernel_avx2(const unsigned int&, const double*, const double*, double*, const unsigned int&) function
+
+/// AVX2/FMA micro-kernel. The 4x8 tile is held in eight ymm registers.
+
+__attribute__((target("avx2,fma")))
+inline void micro_kernel_avx2(const unsigned int& depth, const double* a, const double* b, double* c, const unsigned int& ldc)
+{
+   __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+   __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+   __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+   __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+
+   for(unsigned int p = 0; p < depth; p++)
+   {
+      const __m256d b0 = _mm256_loadu_pd(b);
+      const __m256d b1 = _mm256_loadu_pd(b + 4);
+
+      __m256d a_i = _mm256_broadcast_sd(a);
+      c00 = _mm256_fmadd_pd(a_i, b0, c00); c01 = _mm256_fmadd_pd(a_i, b1, c01);
+
+      a_i = _mm256_broadcast_sd(a + 1);
+      c10 = _mm256_fmadd_pd(a_i, b0, c10); c11 = _mm256_fmadd_pd(a_i, b1, c11);
+
+      a_i = _mm256_broadcast_sd(a + 2);
+      c20 = _mm256_fmadd_pd(a_i, b0, c20); c21 = _mm256_fmadd_pd(a_i, b1, c21);
+
+      a_i = _mm256_broadcast_sd(a + 3);
+      c30 = _mm256_fmadd_pd(a_i, b0, c30); c31 = _mm256_fmadd_pd(a_i, b1, c31);
+
+      a += mr;
+      b += nr;
+   }
+
+   double* c0 = c;
+   double* c1 = c + ldc;
+   double* c2 = c + 2*(std::size_t)ldc;
+   double* c3 = c + 3*(std::size_t)ldc;
+
+   _mm256_storeu_pd(c0, _mm256_add_pd(_mm256_loadu_pd(c0), c00)); _mm256_storeu_pd(c0 + 4, _mm256_add_pd(_mm256_loadu_pd(c0 + 4), c01));
+   _mm256_storeu_pd(c1, _mm256_add_pd(_mm256_loadu_pd(c1), c10)); _mm256_storeu_pd(c1 + 4, _mm256_add_pd(_mm256_loadu_pd(c1 + 4), c11));
+   _mm256_storeu_pd(c2, _mm256_add_pd(_mm256_loadu_pd(c2), c20)); _mm256_storeu_pd(c2 + 4, _mm256_add_pd(_mm256_loadu_pd(c2 + 4), c21));
+   _mm256_storeu_pd(c3, _mm256_add_pd(_mm256_loadu_pd(c3), c30)); _mm256_storeu_pd(c3 + 4, _mm256_add_pd(_mm256_loadu_pd(c3 + 4), c31));
+}
+
+
+// double dot_sse2(const unsigned int&, const double*, const double*) function
+
+/// SSE2 dot product with two independent accumulators.
+
+__attribute__((target("sse2")))
+inline double dot_sse2(const unsigned int& n, const double* x, const double* y)
+{
+   __m128d sum_0 = _mm_setzero_pd();
+   __m128d sum_1 = _mm_setzero_pd();
+
+   unsigned int i = 0;
+
+   for(; i + 4 <= n; i += 4)
+   {
+      sum_0 = _mm_add_pd(sum_0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+      sum_1 = _mm_add_pd(sum_1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+   }
+
+   double partial[2];
+
+   _mm_storeu_pd(partial, _mm_add_pd(sum_0, sum_1));
+
+   double dot_product = partial[0] + partial[1];
+
+   for(; i < n; i++)
+   {
+      dot_product += x[i]*y[i];
+   }
+
+   return(dot_product);
+}
+
+
+// double dot_avx2(const unsigned int&, const double*, const double*) function
+
+/// AVX2/FMA dot product with two independent accumulators.
+
+__attribute__((target("avx2,fma")))
+inline double dot_avx2(const unsigned int& n, const double* x, const double* y)
+{
+   __m256d sum_0 = _mm256_setzero_pd();
+   __m256d sum_1 = _mm256_setzero_pd();
+
+   unsigned int i = 0;
+
+   for(; i + 8 <= n; i += 8)
+   {
+      sum_0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum_0);
+      sum_1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), sum_1);
+   }
+
+   double partial[4];
+
+   _mm256_storeu_pd(partial, _mm256_add_pd(sum_0, sum_1));
+
+   double dot_product = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+
+   for(; i < n; i++)
+   {
+      dot_product += x[i]*y[i];
+   }
+
+   return(dot_product);
+}
+
+
+// void gemv_transpose_sse2(const unsigned int&, const unsigned int&, const double*, const unsigned int&, const double*, double*) function
+
+/// SSE2 transposed matrix-vector product.
+/// Four rows of A are added to y at a time, so that y is loaded and stored once for every four rows.
+
+__attribute__((target("sse2")))
+inline void gemv_transpose_sse2(const unsigned int& m, const unsigned int& n, const double* a, const unsigned int& lda, const double* x, double* y)
+{
+   for(unsigned int j = 0; j < n; j++)
+   {
+      y[j] = 0.0;
+   }
+
+   unsigned int i = 0;
+
+   for(; i + 4 <= m; i += 4)
+   {
+      const double* row_0 = a + (std::size_t)i*lda;
+      const double* row_1 = row_0 + lda;
+      const double* row_2 = row_1 + lda;
+      const double* row_3 = row_2 + lda;
+
+      const __m128d x_0 = _mm_set1_pd(x[i]);
+      const __m128d x_1 = _mm_set1_pd(x[i+1]);
+      const __m128d x_2 = _mm_set1_pd(x[i+2]);
+      const __m128d x_3 = _mm_set1_pd(x[i+3]);
+
+      unsigned int j = 0;
+
+      for(; j + 2 <= n; j += 2)
+      {
+         __m128d y_j = _mm_loadu_pd(y + j);
+
+         y_j = _mm_add_pd(y_j, _mm_mul_pd(x_0, _mm_loadu_pd(row_0 + j)));
+         y_j = _mm_add_pd(y_j, _mm_mul_pd(x_1, _mm_loadu_pd(row_1 + j)));
+         y_j = _mm_add_pd(y_j, _mm_mul_pd(x_2, _mm_loadu_pd(row_2 + j)));
+         y_j = _mm_add_pd(y_j, _mm_mul_pd(x_3, _mm_loadu_pd(row_3 + j)));
+
+         _mm_storeu_pd(y + j, y_j);
+      }
+
+      for(; j < n; j++)
+      {
+         y[j] += x[i]*row_0[j] + x[i+1]*row_1[j] + x[i+2]*row_2[j] + x[i+3]*row_3[j];
+      }
+   }
+
+   for(; i < m; i++)
+   {
+      const double* row = a + (std::size_t)i*lda;
+
+      const __m128d x_i = _mm_set1_pd(x[i]);
+
+      unsigned int j = 0;
+
+      for(; j + 2 <= n; j += 2)
+      {
+         _mm_storeu_pd(y + j, _mm_add_pd(_mm_loadu_pd(y + j), _mm_mul_pd(x_i, _mm_loadu_pd(row + j))));
+      }
+
+      for(; j < n; j++)
+      {
+         y[j] += x[i]*row[j];
+      }
+   }
+}
+
+
+// void gemv_transpose_avx2(const unsigned int&, const unsigned int&, const double*, const unsigned int&, const double*, double*) function
+
+/// AVX2/FMA transposed matrix-vector product, with the same four row blocking as the SSE2 version.
+
+__attribute__((target("avx2,fma")))
+inline void gemv_transpose_avx2(const unsigned int& m, const unsigned int& n, const double* a, const unsigned int& lda, const double* x, double* y)
+{
+   for(unsigned int j = 0; j < n; j++)
+   {
+      y[j] = 0.0;
+   }
+
+   unsigned int i = 0;
+
+   for(; i + 4 <= m; i += 4)
+   {
+      const double* row_0 = a + (std::size_t)i*lda;
+      const double* row_1 = row_0 + lda;
+      const double* row_2 = row_1 + lda;
+      const double* row_3 = row_2 + lda;
+
+      const __m256d x_0 = _mm256_set1_pd(x[i]);
+      const __m256d x_1 = _mm256_set1_pd(x[i+1]);
+      const __m256d x_2 = _mm256_set1_pd(x[i+2]);
+      const __m256d x_3 = _mm256_set1_pd(x[i+3]);
+
+      unsigned int j = 0;
+
+      for(; j + 4 <= n; j += 4)
+      {
+         __m256d y_j = _mm256_loadu_pd(y + j);
+
+         y_j = _mm256_fmadd_pd(x_0, _mm256_loadu_pd(row_0 + j), y_j);
+         y_j = _mm256_fmadd_pd(x_1, _mm256_loadu_pd(row_1 + j), y_j);
+         y_j = _mm256_fmadd_pd(x_2, _mm256_loadu_pd(row_2 + j), y_j);
+         y_j = _mm256_fmadd_pd(x_3, _mm256_loadu_pd(row_3 + j), y_j);
+
+         _mm256_storeu_pd(y + j, y_j);
+      }
+
+      for(; j < n; j++)
+      {
+         y[j] += x[i]*row_0[j] + x[i+1]*row_1[j] + x[i+2]*row_2[j] + x[i+3]*row_3[j];
+      }
+   }
+
+   for(; i < m; i++)
+   {
+      const double* row = a + (std::size_t)i*lda;
+
+      const __m256d x_i = _mm256_set1_pd(x[i]);
+
+      unsigned int j = 0;
+
+      for(; j + 4 <= n; j += 4)
+      {
+         _mm256_storeu_pd(y + j, _mm256_fmadd_pd(x_i, _mm256_loadu_pd(row + j), _mm256_loadu_pd(y + j)));
+      }
+
+      for(; j < n; j++)
+      {
+         y[j] += x[i]*row[j];
+      }
+   }
+}
+
+#endif
+
+
+// InstructionSet get_instruction_set(void) function
+
+/// This function returns the best instruction set supported by the processor.
+/// The processor is queried only once.
+
+inline InstructionSet get_instruction_set(void)
+{
+   #ifdef __OPENNN_KERNELS_X86__
+
+   static const InstructionSet instruction_set
+   = (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) ? AVX2
+   : __builtin_cpu_supports("sse2") ? SSE2
+   : Scalar;
+
+   return(instruction_set);
+
+   #else
+
+   return(Scalar);
+
+   #endif
+}
+
+
+// MicroKernel get_micro_kernel(void) function
+
+/// This function returns the fastest micro-kernel for this processor.
+
+inline MicroKernel get_micro_kernel(void)
+{
+   #ifdef __OPENNN_KERNELS_X86__
+
+   switch(get_instruction_set())
+   {
+      case AVX2:
+      {
+         return(micro_kernel_avx2);
+      }
+
+      case SSE2:
+      {
+         return(micro_kernel_sse2);
+      }
+
+      default:
+      {
+         return(micro_kernel_scalar);
+      }
+   }
+
+   #else
+
+   return(micro_kernel_scalar);
+
+   #endif
+}
+
+
+// double dot(const unsigned int&, const double*, const double*) function
+
+/// Double precision specialization of the dot product.
+
+template<>
+inline double dot<double>(const unsigned int& n, const double* x, const double* y)
+{
+   #ifdef __OPENNN_KERNELS_X86__
+
+   switch(get_instruction_set())
+   {
+      case AVX2:
+      {
+         return(dot_avx2(n, x, y));
+      }
+
+      case SSE2:
+      {
+         return(dot_sse2(n, x, y));
+      }
+
+      default:
+      {
+         break;
+      }
+   }
+
+   #endif
+
+   double dot_product = 0.0;
+
+   for(unsigned int i = 0; i < n; i++)
+   {
+      dot_product += x[i]*y[i];
+   }
+
+   return(dot_product);
+}
+
+
+// void gemm(const unsigned int&, const unsigned int&, const unsigned int&, const double*, const unsigned int&, const double*, const unsigned int&, double*, const unsigned int&) function
+
+/// Double precision specialization of the matrix product.
+/// Small products use the general loop.
+/// Otherwise B is packed in kc x nc panels, A in mc x kc blocks, and every mr x nr tile of C is computed by the micro-kernel.
+/// Partial tiles at the borders are computed into a scratch tile and then copied.
+
+template<>
+inline void gemm<double>(const unsigned int& m, const unsigned int& n, const unsigned int& k,
+                         const double* a, const unsigned int& lda,
+                         const double* b, const unsigned int& ldb,
+                         double* c, const unsigned int& ldc)
+{
+   if(m == 0 || n == 0)
+   {
+      return;
+   }
+
+   if((std::size_t)m*n*k < small_product_size || k == 0)
+   {
+      for(unsigned int i = 0; i < m; i++)
+      {
+         double* c_row = c + (std::size_t)i*ldc;
+         const double* a_row = a + (std::size_t)i*lda;
+
+         for(unsigned int j = 0; j < n; j++)
+         {
+            c_row[j] = 0.0;
+         }
+
+         for(unsigned int p = 0; p < k; p++)
+         {
+            const double a_ip = a_row[p];
+            const double* b_row = b + (std::size_t)p*ldb;
+
+            for(unsigned int j = 0; j < n; j++)
+            {
+               c_row[j] += a_ip*b_row[j];
+            }
+         }
+      }
+
+      return;
+   }
+
+   const MicroKernel micro_kernel = get_micro_kernel();
+
+   const unsigned int panel_columns = (n < nc) ? n : nc;
+   const unsigned int block_rows = (m < mc) ? m : mc;
+
+   // Packing buffers are kept by each thread, so that repeated products do not allocate
+
+   static thread_local std::vector<double> packed_b;
+   static thread_local std::vector<double> packed_a;
+
+   const std::size_t packed_b_size = (std::size_t)kc*(((panel_columns + nr - 1)/nr)*nr);
+   const std::size_t packed_a_size = (std::size_t)kc*(((block_rows + mr - 1)/mr)*mr);
+
+   if(packed_b.size() < packed_b_size)
+   {
+      packed_b.resize(packed_b_size);
+   }
+
+   if(packed_a.size() < packed_a_size)
+   {
+      packed_a.resize(packed_a_size);
+   }
+
+   double tile[mr*nr];
+
+   for(unsigned int i = 0; i < m; i++)
+   {
+      double* c_row = c + (std::size_t)i*ldc;
+
+      for(unsigned int j = 0; j < n; j++)
+      {
+         c_row[j] = 0.0;
+      }
+   }
+
+   for(unsigned int j0 = 0; j0 < n; j0 += nc)
+   {
+      const unsigned int columns = (j0 + nc < n) ? nc : n - j0;
+
+      for(unsigned int p0 = 0; p0 < k; p0 += kc)
+      {
+         const unsigned int depth = (p0 + kc < k) ? kc : k - p0;
+
+         pack_b(depth, columns, b + (std::size_t)p0*ldb + j0, ldb, &packed_b[0]);
+
+         for(unsigned int i0 = 0; i0 < m; i0 += mc)
+         {
+            const unsigned int rows = (i0 + mc < m) ? mc : m - i0;
+
+            pack_a(rows, depth, a + (std::size_t)i0*lda + p0, lda, &packed_a[0]);
+
+            for(unsigned int jr = 0; jr < columns; jr += nr)
+            {
+               const unsigned int tile_columns = (jr + nr < columns) ? nr : columns - jr;
+
+               const double* b_strip = &packed_b[0] + (std::size_t)jr*depth;
+
+               for(unsigned int ir = 0; ir < rows; ir += mr)
+               {
+                  const unsigned int tile_rows = (ir + mr < rows) ? mr : rows - ir;
+
+                  const double* a_strip = &packed_a[0] + (std::size_t)ir*depth;
+
+                  double* c_tile = c + (std::size_t)(i0 + ir)*ldc + j0 + jr;
+
+                  if(tile_rows == mr && tile_columns == nr)
+                  {
+                     micro_kernel(depth, a_strip, b_strip, c_tile, ldc);
+                  }
+                  else
+                  {
+                     for(unsigned int t = 0; t < mr*nr; t++)
+                     {
+                        tile[t] = 0.0;
+                     }
+
+                     micro_kernel(depth, a_strip, b_strip, tile, nr);
+
+                     for(unsigned int i = 0; i < tile_rows; i++)
+                     {
+                        for(unsigned int j = 0; j < tile_columns; j++)
+                        {
+                           c_tile[(std::size_t)i*ldc + j] += tile[i*nr + j];
+                        }
+                     }
+                  }
+               }
+            }
+         }
+      }
+   }
+}
+
+
+// void gemv(const unsigned int&, const unsigned int&, const double*, const unsigned int&, const double*, double*) function
+
+/// Double precision specialization of the matrix-vector product.
+/// The rows of A are contiguous, so every component is a vectorized dot product.
+
+template<>
+inline void gemv<double>(const unsigned int& m, const unsigned int& n, const double* a, const unsigned int& lda, const double* x, double* y)
+{
+   for(unsigned int i = 0; i < m; i++)
+   {
+      y[i] = dot<double>(n, a + (std::size_t)i*lda, x);
+   }
+}
+
+
+// void gemv_transpose(const unsigned int&, const unsigned int&, const double*, const unsigned int&, const double*, double*) function
+
+/// Double precision specialization of the transposed matrix-vector product, which is the vector-matrix product.
+
+template<>
+inline void gemv_transpose<double>(const unsigned int& m, const unsigned int& n, const double* a, const unsigned int& lda, const double* x, double* y)
+{
+   #ifdef __OPENNN_KERNELS_X86__
+
+   switch(get_instruction_set())
+   {
+      case AVX2:
+      {
+         gemv_transpose_avx2(m, n, a, lda, x, y);
+
+         return;
+      }
+
+      case SSE2:
+      {
+         gemv_transpose_sse2(m, n, a, lda, x, y);
+
+         return;
+      }
+
+      default:
+      {
+         break;
+      }
+   }
+
+   #endif
+
+   for(unsigned int j = 0; j < n; j++)
+   {
+      y[j] = 0.0;
+   }
+
+   for(unsigned int i = 0; i < m; i++)
+   {
+      const double* row = a + (std::size_t)i*lda;
+      const double x_i = x[i];
+
+      for(unsigned int j = 0; j < n; j++)
+      {
+         y[j] += x_i*row[j];
+      }
+   }
+}
+
+}
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright (C) 2005-2012 Roberto Lopez
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
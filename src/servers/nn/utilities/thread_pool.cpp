@@ -0,0 +1,248 @@
+/****************************************************************************************************************/
+/*                                                                                                              */
+/*   OpenNN: Open Neural Networks Library                                                                       */
+/*   www.opennn.cimne.com                                                                                       */
+/*                                                                                                              */
+/*   T H R E A D   P O O L   C L A S S                                                                          */
+/*                                                                                                              */
+/*   Roberto Lopez                                                                                              */
+/*   International Center for Numerical Methods in Engineering (CIMNE)                                          */
+/*   Technical University of Catalonia (UPC)                                                                    */
+/*   Barcelona, Spain                                                                                           */
+/*   E-mail: rlopez@cimne.upc.edu                                                                               */
+/*                                                                                                              */
+/****************************************************************************************************************/
+
+// OpenNN includes
+
+#include "thread_pool.h"
+
+
+namespace OpenNN
+{
+
+// THREADS NUMBER CONSTRUCTOR
+
+/// Threads number constructor. 
+/// It creates a pool which executes tasks on a given number of threads, including the calling thread. 
+/// @param new_threads_number Number of threads. Values of zero and one create a pool which executes all tasks on the calling thread. 
+
+ThreadPool::ThreadPool(const unsigned int& new_threads_number)
+ : task_pointer(NULL),
+   tasks_number(0),
+   next_task_index(0),
+   busy_threads_number(0),
+   generation(0),
+   stopping(false)
+{
+   for(unsigned int i = 1; i < new_threads_number; i++)
+   {
+      threads.push_back(std::thread(&ThreadPool::work, this, i));
+   }
+}
+
+
+// DESTRUCTOR
+
+/// Destructor. 
+/// It asks the background threads to finish and waits for them. 
+
+ThreadPool::~ThreadPool(void)
+{
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      stopping = true;
+   }
+
+   start_condition.notify_all();
+
+   for(unsigned int i = 0; i < threads.size(); i++)
+   {
+      threads[i].join();
+   }
+}
+
+
+// METHODS
+
+// unsigned int count_threads_number(void) const method
+
+/// This method returns the number of threads which execute tasks, including the calling thread. 
+
+unsigned int ThreadPool::count_threads_number(void) const
+{
+   return(threads.size() + 1);
+}
+
+
+// static unsigned int count_hardware_threads_number(void) method
+
+/// This method returns the number of threads which the hardware can run concurrently, or one if it is not known. 
+
+unsigned int ThreadPool::count_hardware_threads_number(void)
+{
+   const unsigned int hardware_threads_number = std::thread::hardware_concurrency();
+
+   if(hardware_threads_number == 0)
+   {
+      return(1);
+   }
+   else
+   {
+      return(hardware_threads_number);
+   }
+}
+
+
+// void run(const unsigned int&, const Task&) method
+
+/// This method executes a number of tasks and returns when all of them have finished. 
+/// If some task throws an exception, the remaining tasks are still executed and the first exception is rethrown. 
+/// @param new_tasks_number Number of tasks. They are given the indices 0, ..., new_tasks_number-1. 
+/// @param task Function to be called for every task index. 
+
+void ThreadPool::run(const unsigned int& new_tasks_number, const Task& task)
+{
+   if(threads.empty() || new_tasks_number <= 1)
+   {
+      for(unsigned int i = 0; i < new_tasks_number; i++)
+      {
+         task(i, 0);
+      }
+
+      return;
+   }
+
+   std::lock_guard<std::mutex> run_lock(run_mutex);
+
+   {
+      std::lock_guard<std::mutex> lock(mutex);
+
+      task_pointer = &task;
+      tasks_number = new_tasks_number;
+      next_task_index = 0;
+      busy_threads_number = threads.size();
+      exception_pointer = std::exception_ptr();
+      generation++;
+   }
+
+   start_condition.notify_all();
+
+   execute_tasks(0);
+
+   std::exception_ptr task_exception_pointer;
+
+   {
+      std::unique_lock<std::mutex> lock(mutex);
+
+      while(busy_threads_number != 0)
+      {
+         done_condition.wait(lock);
+      }
+
+      task_pointer = NULL;
+
+      task_exception_pointer = exception_pointer;
+      exception_pointer = std::exception_ptr();
+   }
+
+   if(task_exception_pointer)
+   {
+      std::rethrow_exception(task_exception_pointer);
+   }
+}
+
+
+// void execute_tasks(const unsigned int&) method
+
+/// This method takes tasks from the current set until there are none left. 
+/// @param thread_index Index of the thread executing the tasks. 
+
+void ThreadPool::execute_tasks(const unsigned int& thread_index)
+{
+   for(;;)
+   {
+      const unsigned int task_index = next_task_index.fetch_add(1);
+
+      if(task_index >= tasks_number)
+      {
+         return;
+      }
+
+      try
+      {
+         (*task_pointer)(task_index, thread_index);
+      }
+      catch(...)
+      {
+         std::lock_guard<std::mutex> lock(mutex);
+
+         if(!exception_pointer)
+         {
+            exception_pointer = std::current_exception();
+         }
+      }
+   }
+}
+
+
+// void work(const unsigned int&) method
+
+/// This method is the main loop of the background threads. 
+/// @param thread_index Index of the background thread. 
+
+void ThreadPool::work(const unsigned int& thread_index)
+{
+   unsigned long last_generation = 0;
+
+   std::unique_lock<std::mutex> lock(mutex);
+
+   for(;;)
+   {
+      while(!stopping && generation == last_generation)
+      {
+         start_condition.wait(lock);
+      }
+
+      if(stopping)
+      {
+         return;
+      }
+
+      last_generation = generation;
+
+      lock.unlock();
+
+      execute_tasks(thread_index);
+
+      lock.lock();
+
+      busy_threads_number--;
+
+      if(busy_threads_number == 0)
+      {
+         done_condition.notify_all();
+      }
+   }
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright (C) 2005-2012 Roberto Lopez
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
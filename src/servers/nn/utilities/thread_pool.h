@@ -0,0 +1,151 @@
+/****************************************************************************************************************/
+/*                                                                                                              */
+/*   OpenNN: Open Neural Networks Library                                                                       */
+/*   www.opennn.cimne.com                                                                                       */
+/*                                                                                                              */
+/*   T H R E A D   P O O L   C L A S S   H E A D E R                                                            */
+/*                                                                                                              */
+/*   Roberto Lopez                                                                                              */
+/*   International Center for Numerical Methods in Engineering (CIMNE)                                          */
+/*   Technical University of Catalonia (UPC)                                                                    */
+/*   Barcelona, Spain                                                                                           */
+/*   E-mail: rlopez@cimne.upc.edu                                                                               */
+/*                                                                                                              */
+/****************************************************************************************************************/
+
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+// System includes
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace OpenNN
+{
+
+/// This class represents a fixed set of worker threads which execute indexed tasks. 
+/// The thread calling the run method takes part in the work, so that a pool of n threads creates n-1 background threads.
+/// Tasks are handed out dynamically, so that the assignment of tasks to threads is not deterministic.  
+/// The run method must not be called from inside a task. 
+
+class ThreadPool
+{
+
+public:
+
+   /// Signature of the tasks. 
+   /// The first argument is the index of the task and the second one the index of the thread executing it, 
+   /// which is less than the number of threads in the pool. 
+
+   typedef std::function<void (const unsigned int&, const unsigned int&)> Task;
+
+   // THREADS NUMBER CONSTRUCTOR
+
+   explicit ThreadPool(const unsigned int&);
+
+   // DESTRUCTOR
+
+   virtual ~ThreadPool(void);
+
+   // METHODS
+
+   unsigned int count_threads_number(void) const;
+
+   static unsigned int count_hardware_threads_number(void);
+
+   void run(const unsigned int&, const Task&);
+
+private:
+
+   // COPY CONSTRUCTOR
+
+   ThreadPool(const ThreadPool&);
+
+   // ASSIGNMENT OPERATOR
+
+   ThreadPool& operator = (const ThreadPool&);
+
+   // PRIVATE METHODS
+
+   void execute_tasks(const unsigned int&);
+
+   void work(const unsigned int&);
+
+   // MEMBERS
+
+   /// Background threads. 
+
+   std::vector<std::thread> threads;
+
+   /// Mutex protecting the state shared with the background threads. 
+
+   std::mutex mutex;
+
+   /// Mutex which serializes concurrent calls to the run method. 
+
+   std::mutex run_mutex;
+
+   /// Condition signaled when a new set of tasks is available or the pool is stopping. 
+
+   std::condition_variable start_condition;
+
+   /// Condition signaled when the last background thread finishes its tasks. 
+
+   std::condition_variable done_condition;
+
+   /// Tasks being executed. 
+
+   const Task* task_pointer;
+
+   /// Number of tasks being executed. 
+
+   unsigned int tasks_number;
+
+   /// Index of the next task to be handed out. 
+
+   std::atomic<unsigned int> next_task_index;
+
+   /// Number of background threads which have not finished the current set of tasks. 
+
+   unsigned int busy_threads_number;
+
+   /// Counter of sets of tasks, used to wake up the background threads. 
+
+   unsigned long generation;
+
+   /// True when the destructor asks the background threads to finish. 
+
+   bool stopping;
+
+   /// First exception thrown by a task, which is rethrown by the run method. 
+
+   std::exception_ptr exception_pointer;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright (C) 2005-2012 Roberto Lopez
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
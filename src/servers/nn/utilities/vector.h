@@ -31,8 +31,13 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
+// OpenNN includes
+
+#include "matrix_kernels.h"
+
 namespace OpenNN
 {
 
@@ -125,6 +130,14 @@ Vector(const Vector<Type>& other_vector) : std::vector<Type>(other_vector)
 }
 
 
+/// Move constructor. It takes the elements of a temporary Vector without copying them. 
+/// @param other_vector Vector to be moved.
+
+Vector(Vector<Type>&& other_vector) : std::vector<Type>(std::move(other_vector))
+{
+}
+
+
 // DESTRUCTOR
 
 /// Destructor. 
@@ -134,6 +147,31 @@ Vector(const Vector<Type>& other_vector) : std::vector<Type>(other_vector)
 }
 
 
+// ASSIGNMENT OPERATORS
+
+/// Assignment operator. It assigns to self a copy of an existing Vector. 
+/// The storage of this vector is reused if it is large enough. 
+/// @param other_vector Vector to be assigned.
+
+inline Vector<Type>& operator = (const Vector<Type>& other_vector)
+{
+   std::vector<Type>::operator = (other_vector);
+
+   return(*this);
+}
+
+
+/// Move assignment operator. It takes the elements of a temporary Vector without copying them. 
+/// @param other_vector Vector to be moved.
+
+inline Vector<Type>& operator = (Vector<Type>&& other_vector)
+{
+   std::vector<Type>::operator = (std::move(other_vector));
+
+   return(*this);
+}
+
+
 // bool operator == (const Type&) const
 
 /// Equal to operator between this vector and a Type value.
@@ -2080,17 +2118,14 @@ Vector<Type> dot(const Matrix<Type>& matrix) const
 
    const unsigned int columns_number = matrix.get_columns_number();
 
-   Vector<Type> product(columns_number);
-  
-   for(unsigned int j = 0; j < columns_number; j++)
-   {     
-      product[j] = 0;      
+   Vector<Type> product(columns_number, 0);
 
-      for(unsigned int i = 0; i < rows_number; i++)
-      {
-         product[j] += (*this)[i]*matrix[i][j];
-      }
+   if(rows_number == 0 || columns_number == 0)
+   {
+      return(product);
    }
+
+   MatrixKernels::gemv_transpose(rows_number, columns_number, matrix[0], columns_number, &(*this)[0], &product[0]);
     
    return(product);
 }
@@ -2124,14 +2159,12 @@ Type dot(const Vector<Type>& other_vector) const
 
    #endif
 
-   Type dot_product = 0;
-  
-   for(unsigned int i = 0; i < this_size; i++)
+   if(this_size == 0)
    {
-      dot_product += (*this)[i]*other_vector[i];
+      return(0);
    }
-   
-   return(dot_product);
+
+   return(MatrixKernels::dot(this_size, &(*this)[0], &other_vector[0]));
 }
 
 
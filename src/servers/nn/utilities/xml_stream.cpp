@@ -0,0 +1,1104 @@
+/****************************************************************************************************************/
+/*                                                                                                              */
+/*   OpenNN: Open Neural Networks Library                                                                       */
+/*   www.opennn.cimne.com                                                                                       */
+/*                                                                                                              */
+/*   X M L   S T R E A M   C L A S S E S                                                                        */
+/*                                                                                                              */
+/*   Roberto Lopez                                                                                              */
+/*   International Center for Numerical Methods in Engineering (CIMNE)                                          */
+/*   Technical University of Catalonia (UPC)                                                                    */
+/*   Barcelona, Spain                                                                                           */
+/*   E-mail: rlopez@cimne.upc.edu                                                                               */
+/*                                                                                                              */
+/****************************************************************************************************************/
+
+// System includes
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+// OpenNN includes
+
+#include "xml_stream.h"
+
+
+namespace OpenNN
+{
+
+// XMLStreamWriter class
+
+// STREAM CONSTRUCTOR
+
+/// Stream constructor.
+/// It creates a writer which writes a XML document to a given stream.
+/// @param new_stream Stream which receives the document.
+
+XMLStreamWriter::XMLStreamWriter(std::ostream& new_stream)
+ : stream(new_stream),
+   start_tag_open(false),
+   has_child_elements(false)
+{
+}
+
+
+// DESTRUCTOR
+
+/// Destructor.
+
+XMLStreamWriter::~XMLStreamWriter(void)
+{
+}
+
+
+// METHODS
+
+// void write_declaration(void) method
+
+/// This method writes the XML declaration, which must come before the root element.
+
+void XMLStreamWriter::write_declaration(void)
+{
+   stream << "<?xml version=\"1.0\" ?>\n";
+}
+
+
+// void write_start_element(const std::string&) method
+
+/// This method opens an element inside the innermost open element.
+/// Its attributes must be written before anything else.
+/// @param name Name of the element.
+
+void XMLStreamWriter::write_start_element(const std::string& name)
+{
+   if(start_tag_open)
+   {
+      stream << ">\n";
+
+      start_tag_open = false;
+   }
+
+   write_indentation();
+
+   stream << "<" << name;
+
+   open_elements.push_back(name);
+
+   start_tag_open = true;
+   has_child_elements = false;
+}
+
+
+// void write_attribute(const std::string&, const std::string&) method
+
+/// This method writes an attribute of the element which has just been opened.
+/// @param name Name of the attribute.
+/// @param value Value of the attribute.
+
+void XMLStreamWriter::write_attribute(const std::string& name, const std::string& value)
+{
+   #ifdef _DEBUG
+
+   if(!start_tag_open)
+   {
+      std::ostringstream buffer;
+
+      buffer << "OpenNN Exception: XMLStreamWriter class.\n"
+             << "void write_attribute(const std::string&, const std::string&) method.\n"
+             << "Attributes must be written right after the start of their element.\n";
+
+      throw std::logic_error(buffer.str());
+   }
+
+   #endif
+
+   stream << " " << name << "=\"";
+
+   write_escaped(value);
+
+   stream << "\"";
+}
+
+
+// void write_attribute(const std::string&, const unsigned int&) method
+
+/// This method writes a numeric attribute of the element which has just been opened.
+/// @param name Name of the attribute.
+/// @param value Value of the attribute.
+
+void XMLStreamWriter::write_attribute(const std::string& name, const unsigned int& value)
+{
+   std::ostringstream buffer;
+
+   buffer << value;
+
+   write_attribute(name, buffer.str());
+}
+
+
+// void write_end_element(void) method
+
+/// This method closes the innermost open element.
+
+void XMLStreamWriter::write_end_element(void)
+{
+   const std::string name = open_elements.back();
+
+   open_elements.pop_back();
+
+   if(start_tag_open)
+   {
+      stream << " />\n";
+   }
+   else
+   {
+      if(has_child_elements)
+      {
+         write_indentation();
+      }
+
+      stream << "</" << name << ">\n";
+   }
+
+   start_tag_open = false;
+   has_child_elements = true;
+}
+
+
+// void write_text(const std::string&) method
+
+/// This method writes text inside the innermost open element.
+/// @param text Text to be written.
+
+void XMLStreamWriter::write_text(const std::string& text)
+{
+   close_start_tag();
+
+   write_escaped(text);
+}
+
+
+// void write_text(const Vector<double>&) method
+
+/// This method writes the values of a vector, separated by spaces, inside the innermost open element.
+/// The values are written with as many digits as needed to read them back exactly, and without building a string with all of them.
+/// @param values Values to be written.
+
+void XMLStreamWriter::write_text(const Vector<double>& values)
+{
+   const unsigned int size = values.size();
+
+   if(size == 0)
+   {
+      return;
+   }
+
+   close_start_tag();
+
+   // Formatting into a buffer and writing it in blocks is much faster than formatting each value through the stream.
+
+   char block[4096];
+   size_t length = 0;
+
+   for(unsigned int i = 0; i < size; i++)
+   {
+      if(length > sizeof(block) - 32)
+      {
+         stream.write(block, (std::streamsize)length);
+
+         length = 0;
+      }
+
+      length += (size_t)sprintf(block + length, i == 0 ? "%.*g" : " %.*g", std::numeric_limits<double>::digits10 + 2, values[i]);
+   }
+
+   stream.write(block, (std::streamsize)length);
+}
+
+
+// void write_text_element(const std::string&, const std::string&) method
+
+/// This method writes an element which only contains text.
+/// @param name Name of the element.
+/// @param text Content of the element.
+
+void XMLStreamWriter::write_text_element(const std::string& name, const std::string& text)
+{
+   write_start_element(name);
+
+   if(!text.empty())
+   {
+      write_text(text);
+   }
+
+   write_end_element();
+}
+
+
+// void write_text_element(const std::string&, const Vector<double>&) method
+
+/// This method writes an element which contains the values of a vector separated by spaces.
+/// @param name Name of the element.
+/// @param values Content of the element.
+
+void XMLStreamWriter::write_text_element(const std::string& name, const Vector<double>& values)
+{
+   write_start_element(name);
+
+   write_text(values);
+
+   write_end_element();
+}
+
+
+// void write_element(const TiXmlElement*) method
+
+/// This method writes an element built with the TinyXML library, with its attributes and contents, inside the innermost open element.
+/// @param element Pointer to a TinyXML element.
+
+void XMLStreamWriter::write_element(const TiXmlElement* element)
+{
+   write_start_element(element->Value());
+
+   for(const TiXmlAttribute* attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+   {
+      write_attribute(attribute->Name(), attribute->Value());
+   }
+
+   for(const TiXmlNode* node = element->FirstChild(); node; node = node->NextSibling())
+   {
+      if(node->ToElement())
+      {
+         write_element(node->ToElement());
+      }
+      else if(node->ToText())
+      {
+         write_text(node->Value());
+      }
+   }
+
+   write_end_element();
+}
+
+
+// void close_start_tag(void) method
+
+/// This method ends the start tag of the innermost open element, if it still accepts attributes.
+
+void XMLStreamWriter::close_start_tag(void)
+{
+   if(start_tag_open)
+   {
+      stream << ">";
+
+      start_tag_open = false;
+   }
+}
+
+
+// void write_indentation(void) method
+
+/// This method writes four spaces for each element open.
+
+void XMLStreamWriter::write_indentation(void)
+{
+   for(unsigned int i = 0; i < open_elements.size(); i++)
+   {
+      stream << "    ";
+   }
+}
+
+
+// void write_escaped(const std::string&) method
+
+/// This method writes a string, replacing the characters with a special meaning in XML by their entities.
+/// @param str String to be written.
+
+void XMLStreamWriter::write_escaped(const std::string& str)
+{
+   for(size_t i = 0; i < str.size(); i++)
+   {
+      switch(str[i])
+      {
+         case '&':
+            stream << "&amp;";
+            break;
+
+         case '<':
+            stream << "&lt;";
+            break;
+
+         case '>':
+            stream << "&gt;";
+            break;
+
+         case '"':
+            stream << "&quot;";
+            break;
+
+         case '\'':
+            stream << "&apos;";
+            break;
+
+         default:
+            stream << str[i];
+            break;
+      }
+   }
+}
+
+
+// XMLStreamReader class
+
+// STREAM CONSTRUCTOR
+
+/// Stream constructor.
+/// It creates a reader which reads a XML document from a given stream.
+/// @param new_stream Stream which supplies the document.
+
+XMLStreamReader::XMLStreamReader(std::istream& new_stream)
+ : stream(new_stream),
+   buffer(65536 + 1, '\0'),
+   position(0),
+   size(0),
+   token(EndDocument),
+   empty_element(false),
+   depth(0)
+{
+}
+
+
+// DESTRUCTOR
+
+/// Destructor.
+
+XMLStreamReader::~XMLStreamReader(void)
+{
+}
+
+
+// METHODS
+
+// Token read_next(void) method
+
+/// This method reads the next start element, end element or text token of the document.
+/// Declarations, comments and document type definitions are skipped, as well as text made only of white space.
+
+XMLStreamReader::Token XMLStreamReader::read_next(void)
+{
+   if(empty_element)
+   {
+      empty_element = false;
+
+      depth--;
+
+      token = EndElement;
+
+      return(token);
+   }
+
+   for(;;)
+   {
+      int character = peek_character();
+
+      if(character == EOF)
+      {
+         if(depth > 0)
+         {
+            throw_exception("Token read_next(void)", "Unexpected end of document.");
+         }
+
+         token = EndDocument;
+
+         return(token);
+      }
+
+      if(character != '<')
+      {
+         text = read_until('<');
+
+         if(!text.empty())
+         {
+            token = Text;
+
+            return(token);
+         }
+
+         continue;
+      }
+
+      get_character();
+
+      character = peek_character();
+
+      if(character == '?')
+      {
+         skip_until("?>");
+      }
+      else if(character == '!')
+      {
+         get_character();
+
+         if(peek_character() == '-')
+         {
+            skip_until("-->");
+         }
+         else if(peek_character() == '[')
+         {
+            skip_until("[");
+
+            if(read_name() != "CDATA[")
+            {
+               throw_exception("Token read_next(void)", "Unknown markup.");
+            }
+
+            text.clear();
+
+            while(text.size() < 3 || text.compare(text.size()-3, 3, "]]>") != 0)
+            {
+               character = get_character();
+
+               if(character == EOF)
+               {
+                  throw_exception("Token read_next(void)", "Unexpected end of document.");
+               }
+
+               text += (char)character;
+            }
+
+            text.resize(text.size()-3);
+
+            token = Text;
+
+            return(token);
+         }
+         else
+         {
+            skip_until(">");
+         }
+      }
+      else if(character == '/')
+      {
+         get_character();
+
+         name = read_name();
+
+         skip_until(">");
+
+         if(depth == 0)
+         {
+            throw_exception("Token read_next(void)", "Unexpected end tag " + name + ".");
+         }
+
+         depth--;
+
+         token = EndElement;
+
+         return(token);
+      }
+      else
+      {
+         read_tag();
+
+         depth++;
+
+         token = StartElement;
+
+         return(token);
+      }
+   }
+}
+
+
+// const Token& get_token(void) const method
+
+/// This method returns the last token read.
+
+const XMLStreamReader::Token& XMLStreamReader::get_token(void) const
+{
+   return(token);
+}
+
+
+// const std::string& get_name(void) const method
+
+/// This method returns the name of the element of the last start or end element token.
+
+const std::string& XMLStreamReader::get_name(void) const
+{
+   return(name);
+}
+
+
+// const std::string& get_text(void) const method
+
+/// This method returns the content of the last text token.
+
+const std::string& XMLStreamReader::get_text(void) const
+{
+   return(text);
+}
+
+
+// bool has_attribute(const std::string&) const method
+
+/// This method returns true if the element of the last start element token has a given attribute, and false otherwise.
+/// @param attribute_name Name of the attribute.
+
+bool XMLStreamReader::has_attribute(const std::string& attribute_name) const
+{
+   for(size_t i = 0; i < attributes.size(); i++)
+   {
+      if(attributes[i].first == attribute_name)
+      {
+         return(true);
+      }
+   }
+
+   return(false);
+}
+
+
+// const std::string& get_attribute(const std::string&) const method
+
+/// This method returns the value of an attribute of the element of the last start element token.
+/// It returns an empty string if the element has no such attribute.
+/// @param attribute_name Name of the attribute.
+
+const std::string& XMLStreamReader::get_attribute(const std::string& attribute_name) const
+{
+   static const std::string empty_value;
+
+   for(size_t i = 0; i < attributes.size(); i++)
+   {
+      if(attributes[i].first == attribute_name)
+      {
+         return(attributes[i].second);
+      }
+   }
+
+   return(empty_value);
+}
+
+
+// bool read_start_element(void) method
+
+/// This method reads the start of the next child element of the current element, skipping any text before it.
+/// It returns true if there is such an element, and false if the end of the current element was read instead.
+/// The usual way of going through the children of an element is to call it in a loop, and to read or skip the whole child each time.
+
+bool XMLStreamReader::read_start_element(void)
+{
+   for(;;)
+   {
+      switch(read_next())
+      {
+         case StartElement:
+            return(true);
+
+         case Text:
+            break;
+
+         case EndElement:
+         case EndDocument:
+            return(false);
+      }
+   }
+}
+
+
+// std::string read_text(void) method
+
+/// This method reads the rest of the element whose start has just been read, and returns its text.
+/// Child elements are skipped.
+
+std::string XMLStreamReader::read_text(void)
+{
+   std::string element_text;
+
+   for(;;)
+   {
+      switch(read_next())
+      {
+         case StartElement:
+            skip_element();
+            break;
+
+         case Text:
+            element_text += text;
+            break;
+
+         case EndElement:
+         case EndDocument:
+            return(element_text);
+      }
+   }
+}
+
+
+// void read_text(Vector<double>&) method
+
+/// This method reads the rest of the element whose start has just been read, and parses its text as numbers separated by white space.
+/// The numbers are parsed straight from the stream, without building a string with all of them.
+/// If the element has a Size attribute, the vector reserves that many numbers beforehand.
+/// @param values Vector which receives the numbers.
+
+void XMLStreamReader::read_text(Vector<double>& values)
+{
+   values.clear();
+
+   if(has_attribute("Size"))
+   {
+      values.reserve(strtoul(get_attribute("Size").c_str(), NULL, 10));
+   }
+
+   if(empty_element)
+   {
+      read_next();
+
+      return;
+   }
+
+   for(;;)
+   {
+      skip_spaces();
+
+      const int character = peek_character();
+
+      if(character == EOF)
+      {
+         throw_exception("void read_text(Vector<double>&)", "Unexpected end of document.");
+      }
+
+      if(character == '<')
+      {
+         break;
+      }
+
+      // Keep the whole number in the buffer, which ends with a null character, so that it can be parsed in place.
+
+      if(size - position < 64)
+      {
+         fill_buffer();
+      }
+
+      const char* start = &buffer[position];
+      char* end;
+
+      const double value = strtod(start, &end);
+
+      if(end == start || (*end != '\0' && *end != '<' && !isspace((unsigned char)*end)))
+      {
+         throw_exception("void read_text(Vector<double>&)", "Invalid number in element " + name + ".");
+      }
+
+      position += (size_t)(end - start);
+
+      values.push_back(value);
+   }
+
+   if(read_next() != EndElement)
+   {
+      throw_exception("void read_text(Vector<double>&)", "Element " + name + " does not contain only numbers.");
+   }
+}
+
+
+// TiXmlElement* read_element(void) method
+
+/// This method reads the rest of the element whose start has just been read into a new TinyXML element, which the caller owns.
+/// It is meant for small elements, to be loaded with the from_XML methods of the classes.
+
+TiXmlElement* XMLStreamReader::read_element(void)
+{
+   TiXmlElement* element = new TiXmlElement(name.c_str());
+
+   for(size_t i = 0; i < attributes.size(); i++)
+   {
+      element->SetAttribute(attributes[i].first.c_str(), attributes[i].second.c_str());
+   }
+
+   for(;;)
+   {
+      switch(read_next())
+      {
+         case StartElement:
+            element->LinkEndChild(read_element());
+            break;
+
+         case Text:
+            element->LinkEndChild(new TiXmlText(text.c_str()));
+            break;
+
+         case EndElement:
+         case EndDocument:
+            return(element);
+      }
+   }
+}
+
+
+// void skip_element(void) method
+
+/// This method reads the rest of the element whose start has just been read, and discards it.
+
+void XMLStreamReader::skip_element(void)
+{
+   unsigned int level = 1;
+
+   while(level > 0)
+   {
+      switch(read_next())
+      {
+         case StartElement:
+            level++;
+            break;
+
+         case EndElement:
+            level--;
+            break;
+
+         case Text:
+            break;
+
+         case EndDocument:
+            throw_exception("void skip_element(void)", "Unexpected end of document.");
+      }
+   }
+}
+
+
+// void fill_buffer(void) method
+
+/// This method moves the characters not consumed yet to the start of the buffer, and fills the rest of it from the stream.
+/// The buffer always ends with a null character after the valid ones.
+
+void XMLStreamReader::fill_buffer(void)
+{
+   const size_t remaining = size - position;
+
+   if(remaining > 0 && position > 0)
+   {
+      memmove(&buffer[0], &buffer[position], remaining);
+   }
+
+   stream.read(&buffer[remaining], (std::streamsize)(buffer.size() - 1 - remaining));
+
+   size = remaining + (size_t)stream.gcount();
+   position = 0;
+
+   buffer[size] = '\0';
+}
+
+
+// int peek_character(void) method
+
+/// This method returns the next character of the stream without consuming it, or EOF at the end of the stream.
+
+int XMLStreamReader::peek_character(void)
+{
+   if(position == size)
+   {
+      fill_buffer();
+
+      if(size == 0)
+      {
+         return(EOF);
+      }
+   }
+
+   return((unsigned char)buffer[position]);
+}
+
+
+// int get_character(void) method
+
+/// This method consumes the next character of the stream and returns it, or EOF at the end of the stream.
+
+int XMLStreamReader::get_character(void)
+{
+   const int character = peek_character();
+
+   if(character != EOF)
+   {
+      position++;
+   }
+
+   return(character);
+}
+
+
+// void skip_until(const char*) method
+
+/// This method consumes characters up to and including a given terminator.
+/// @param terminator Sequence of characters which ends the skipped part.
+
+void XMLStreamReader::skip_until(const char* terminator)
+{
+   const std::string end(terminator);
+
+   std::string window;
+
+   while(window != end)
+   {
+      const int character = get_character();
+
+      if(character == EOF)
+      {
+         throw_exception("void skip_until(const char*)", "Unexpected end of document.");
+      }
+
+      window += (char)character;
+
+      if(window.size() > end.size())
+      {
+         window.erase(0, 1);
+      }
+   }
+}
+
+
+// void skip_spaces(void) method
+
+/// This method consumes the white space characters which come next in the stream.
+
+void XMLStreamReader::skip_spaces(void)
+{
+   int character = peek_character();
+
+   while(character != EOF && isspace(character))
+   {
+      get_character();
+
+      character = peek_character();
+   }
+}
+
+
+// std::string read_name(void) method
+
+/// This method reads the name of an element or an attribute.
+
+std::string XMLStreamReader::read_name(void)
+{
+   std::string new_name;
+
+   int character = peek_character();
+
+   while(character != EOF && !isspace(character) && character != '/' && character != '>' && character != '=')
+   {
+      new_name += (char)character;
+
+      get_character();
+
+      character = peek_character();
+   }
+
+   return(new_name);
+}
+
+
+// std::string read_until(const char&) method
+
+/// This method reads characters up to a given delimiter, which is not consumed.
+/// It replaces the entities by the characters they stand for, and removes the white space around the result.
+/// @param delimiter Character which ends the string.
+
+std::string XMLStreamReader::read_until(const char& delimiter)
+{
+   std::string result;
+
+   int character = peek_character();
+
+   while(character != EOF && character != delimiter)
+   {
+      get_character();
+
+      if(character == '&')
+      {
+         std::string entity;
+
+         character = get_character();
+
+         while(character != EOF && character != ';' && entity.size() < 10)
+         {
+            entity += (char)character;
+
+            character = get_character();
+         }
+
+         if(entity == "lt")
+         {
+            result += '<';
+         }
+         else if(entity == "gt")
+         {
+            result += '>';
+         }
+         else if(entity == "amp")
+         {
+            result += '&';
+         }
+         else if(entity == "quot")
+         {
+            result += '"';
+         }
+         else if(entity == "apos")
+         {
+            result += '\'';
+         }
+         else if(entity.size() > 1 && entity[0] == '#')
+         {
+            const unsigned long code = entity[1] == 'x'
+               ? strtoul(entity.c_str()+2, NULL, 16) : strtoul(entity.c_str()+1, NULL, 10);
+
+            // Encode the character as UTF-8.
+
+            if(code < 0x80)
+            {
+               result += (char)code;
+            }
+            else if(code < 0x800)
+            {
+               result += (char)(0xC0 | (code >> 6));
+               result += (char)(0x80 | (code & 0x3F));
+            }
+            else
+            {
+               result += (char)(0xE0 | (code >> 12));
+               result += (char)(0x80 | ((code >> 6) & 0x3F));
+               result += (char)(0x80 | (code & 0x3F));
+            }
+         }
+         else
+         {
+            result += '&' + entity + ';';
+         }
+      }
+      else
+      {
+         result += (char)character;
+      }
+
+      character = peek_character();
+   }
+
+   const size_t first = result.find_first_not_of(" \t\r\n");
+
+   if(first == std::string::npos)
+   {
+      return(std::string());
+   }
+
+   const size_t last = result.find_last_not_of(" \t\r\n");
+
+   return(result.substr(first, last-first+1));
+}
+
+
+// void read_tag(void) method
+
+/// This method reads the name and the attributes of a start tag, whose '<' character has just been consumed.
+
+void XMLStreamReader::read_tag(void)
+{
+   name = read_name();
+
+   attributes.clear();
+
+   for(;;)
+   {
+      skip_spaces();
+
+      const int character = get_character();
+
+      if(character == '>')
+      {
+         return;
+      }
+      else if(character == '/')
+      {
+         if(get_character() != '>')
+         {
+            throw_exception("void read_tag(void)", "Malformed empty element " + name + ".");
+         }
+
+         empty_element = true;
+
+         return;
+      }
+      else if(character == EOF)
+      {
+         throw_exception("void read_tag(void)", "Unexpected end of document.");
+      }
+
+      std::string attribute_name(1, (char)character);
+
+      attribute_name += read_name();
+
+      skip_spaces();
+
+      if(get_character() != '=')
+      {
+         throw_exception("void read_tag(void)", "Malformed attribute " + attribute_name + " of element " + name + ".");
+      }
+
+      skip_spaces();
+
+      const int quote = get_character();
+
+      if(quote != '"' && quote != '\'')
+      {
+         throw_exception("void read_tag(void)", "Malformed attribute " + attribute_name + " of element " + name + ".");
+      }
+
+      const std::string value = read_until((char)quote);
+
+      get_character();
+
+      attributes.push_back(std::make_pair(attribute_name, value));
+   }
+}
+
+
+// void throw_exception(const std::string&, const std::string&) const method
+
+/// This method throws an exception about a document which cannot be read.
+/// @param method Signature of the method which failed.
+/// @param message Description of the problem.
+
+void XMLStreamReader::throw_exception(const std::string& method, const std::string& message) const
+{
+   std::ostringstream buffer;
+
+   buffer << "OpenNN Exception: XMLStreamReader class.\n"
+          << method << " method.\n"
+          << message << "\n";
+
+   throw std::logic_error(buffer.str());
+}
+
+}
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright (C) 2005-2012 Roberto Lopez
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -0,0 +1,238 @@
+/****************************************************************************************************************/
+/*                                                                                                              */
+/*   OpenNN: Open Neural Networks Library                                                                       */
+/*   www.opennn.cimne.com                                                                                       */
+/*                                                                                                              */
+/*   X M L   S T R E A M   C L A S S E S   H E A D E R                                                          */
+/*                                                                                                              */
+/*   Roberto Lopez                                                                                              */
+/*   International Center for Numerical Methods in Engineering (CIMNE)                                          */
+/*   Technical University of Catalonia (UPC)                                                                    */
+/*   Barcelona, Spain                                                                                           */
+/*   E-mail: rlopez@cimne.upc.edu                                                                               */
+/*                                                                                                              */
+/****************************************************************************************************************/
+
+#ifndef __XMLSTREAM_H__
+#define __XMLSTREAM_H__
+
+// System includes
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// OpenNN includes
+
+#include "vector.h"
+
+// TinyXml includes
+
+#include "../tinyxml.h"
+
+namespace OpenNN
+{
+
+/// This class writes a XML document sequentially to a stream, without building it in memory first.
+/// The output has the same layout as the files saved by the TinyXML library, so that both can read it.
+/// Small parts of the document can still be built as TinyXML elements and written with the write_element method.
+
+class XMLStreamWriter
+{
+
+public:
+
+   // STREAM CONSTRUCTOR
+
+   explicit XMLStreamWriter(std::ostream&);
+
+   // DESTRUCTOR
+
+   virtual ~XMLStreamWriter(void);
+
+   // METHODS
+
+   void write_declaration(void);
+
+   void write_start_element(const std::string&);
+   void write_attribute(const std::string&, const std::string&);
+   void write_attribute(const std::string&, const unsigned int&);
+   void write_end_element(void);
+
+   void write_text(const std::string&);
+   void write_text(const Vector<double>&);
+
+   void write_text_element(const std::string&, const std::string&);
+   void write_text_element(const std::string&, const Vector<double>&);
+
+   void write_element(const TiXmlElement*);
+
+private:
+
+   // COPY CONSTRUCTOR
+
+   XMLStreamWriter(const XMLStreamWriter&);
+
+   // ASSIGNMENT OPERATOR
+
+   XMLStreamWriter& operator = (const XMLStreamWriter&);
+
+   // PRIVATE METHODS
+
+   void close_start_tag(void);
+   void write_indentation(void);
+   void write_escaped(const std::string&);
+
+   // MEMBERS
+
+   /// Stream which receives the document.
+
+   std::ostream& stream;
+
+   /// Names of the elements which are open, from the root.
+
+   std::vector<std::string> open_elements;
+
+   /// True if the start tag of the innermost open element still accepts attributes.
+
+   bool start_tag_open;
+
+   /// True if the innermost open element has child elements.
+
+   bool has_child_elements;
+};
+
+
+/// This class reads a XML document sequentially from a stream, one token at a time, without building it in memory.
+/// Only the text of the element being read is held in memory, and the values of numeric text elements are parsed straight from the stream.
+/// Small parts of the document can still be read as TinyXML elements with the read_element method.
+
+class XMLStreamReader
+{
+
+public:
+
+   // STREAM CONSTRUCTOR
+
+   explicit XMLStreamReader(std::istream&);
+
+   // DESTRUCTOR
+
+   virtual ~XMLStreamReader(void);
+
+   // ENUMERATIONS
+
+   /// Enumeration of the tokens of a XML document.
+   /// Empty elements are read as a start element token followed by an end element token.
+
+   enum Token{StartElement, EndElement, Text, EndDocument};
+
+   // METHODS
+
+   Token read_next(void);
+
+   const Token& get_token(void) const;
+   const std::string& get_name(void) const;
+   const std::string& get_text(void) const;
+
+   bool has_attribute(const std::string&) const;
+   const std::string& get_attribute(const std::string&) const;
+
+   bool read_start_element(void);
+
+   std::string read_text(void);
+   void read_text(Vector<double>&);
+
+   TiXmlElement* read_element(void);
+   void skip_element(void);
+
+private:
+
+   // COPY CONSTRUCTOR
+
+   XMLStreamReader(const XMLStreamReader&);
+
+   // ASSIGNMENT OPERATOR
+
+   XMLStreamReader& operator = (const XMLStreamReader&);
+
+   // PRIVATE METHODS
+
+   void fill_buffer(void);
+
+   int peek_character(void);
+   int get_character(void);
+
+   void skip_until(const char*);
+   void skip_spaces(void);
+
+   std::string read_name(void);
+   std::string read_until(const char&);
+   void read_tag(void);
+
+   void throw_exception(const std::string&, const std::string&) const;
+
+   // MEMBERS
+
+   /// Stream which supplies the document.
+
+   std::istream& stream;
+
+   /// Characters read from the stream and not consumed yet, followed by a null character.
+
+   std::vector<char> buffer;
+
+   /// Position of the next character in the buffer.
+
+   size_t position;
+
+   /// Number of valid characters in the buffer.
+
+   size_t size;
+
+   /// Last token read.
+
+   Token token;
+
+   /// Name of the element of the last start or end element token.
+
+   std::string name;
+
+   /// Content of the last text token, with the entities replaced and the surrounding white space removed.
+
+   std::string text;
+
+   /// Names and values of the attributes of the last start element token.
+
+   std::vector< std::pair<std::string, std::string> > attributes;
+
+   /// True if the last start element token came from an empty element, so that the next token is its end.
+
+   bool empty_element;
+
+   /// Number of elements which are open.
+
+   unsigned int depth;
+};
+
+}
+
+#endif
+
+
+// OpenNN: Open Neural Networks Library.
+// Copyright (C) 2005-2012 Roberto Lopez
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
@@ -7,6 +7,7 @@
 #include "vnode_store.h"
 
 #include <unistd.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -19,6 +20,7 @@
 #include <low_resource_manager.h>
 #include <thread.h>
 #include <util/AutoLock.h>
+#include <util/DoublyLinkedList.h>
 #include <util/kernel_cpp.h>
 #include <vfs.h>
 #include <vm/vm.h>
@@ -113,6 +115,31 @@ static phys_addr_t sZeroPage;
 static generic_io_vec sZeroVecs[kZeroVecCount];
 
 
+struct prefetch_request : DoublyLinkedListLinkImpl<prefetch_request> {
+	dev_t			device;
+	ino_t			node;
+	off_t			offset;
+		// where the next part to be read starts
+	off_t			end;
+};
+
+typedef DoublyLinkedList<prefetch_request> PrefetchRequestList;
+
+static const int32 kPrefetchThreadCount = 2;
+static const uint32 kMaxPrefetchRequests = 256;
+static const size_t kPrefetchChunkSize = 1024 * 1024;
+static const int32 kMaxPrefetchPagesInFlight = 4 * 1024 * 1024 / B_PAGE_SIZE;
+
+static mutex sPrefetchLock = MUTEX_INITIALIZER("file cache prefetch");
+static ConditionVariable sPrefetchCondition;
+static ConditionVariable sPrefetchIOCondition;
+static PrefetchRequestList sPrefetchRequests;
+static uint32 sPrefetchRequestCount;
+static prefetch_request* sActivePrefetches[kPrefetchThreadCount];
+static int32 sPrefetchThreadsStarted;
+static int32 sPrefetchPagesInFlight;
+
+
 //	#pragma mark -
 
 
@@ -128,6 +155,8 @@ PrecacheIO::PrecacheIO(file_cache_ref* ref, off_t offset, generic_size_t size)
 {
 	fPageCount = (size + B_PAGE_SIZE - 1) / B_PAGE_SIZE;
 	fCache->AcquireRefLocked();
+
+	atomic_add(&sPrefetchPagesInFlight, (int32)fPageCount);
 }
 
 
@@ -136,6 +165,11 @@ PrecacheIO::~PrecacheIO()
 	delete[] fPages;
 	delete[] fVecs;
 	fCache->ReleaseRefLocked();
+
+	if (atomic_add(&sPrefetchPagesInFlight, -(int32)fPageCount)
+			>= kMaxPrefetchPagesInFlight) {
+		sPrefetchIOCondition.NotifyAll();
+	}
 }
 
 
@@ -947,42 +981,22 @@ file_cache_control(const char* subsystem, uint32 function, void* buffer,
 }
 
 
-//	#pragma mark - private kernel API
+//	#pragma mark - prefetching
 
 
-extern "C" void
-cache_prefetch_vnode(struct vnode* vnode, off_t offset, size_t size)
+/*!	Starts reading the pages of the given range of the vnode cache that are
+	not cached yet. \a offset and \a size must be page aligned.
+	Returns \c false, if there weren't enough unused pages to do so.
+*/
+static bool
+prefetch_cache_range(VMCache* cache, off_t offset, size_t size)
 {
-	if (size == 0)
-		return;
-
-	VMCache* cache;
-	if (vfs_get_vnode_cache(vnode, &cache, false) != B_OK)
-		return;
-	if (cache->type != CACHE_TYPE_VNODE) {
-		cache->ReleaseRef();
-		return;
-	}
-
 	file_cache_ref* ref = ((VMVnodeCache*)cache)->FileCacheRef();
-	off_t fileSize = cache->virtual_end;
-
-	if ((off_t)(offset + size) > fileSize)
-		size = fileSize - offset;
-
-	// "offset" and "size" are always aligned to B_PAGE_SIZE,
-	offset = ROUNDDOWN(offset, B_PAGE_SIZE);
-	size = ROUNDUP(size, B_PAGE_SIZE);
-
 	size_t reservePages = size / B_PAGE_SIZE;
 
-	// Don't do anything if we don't have the resources left, or the cache
-	// already contains more than 2/3 of its pages
-	if (offset >= fileSize || vm_page_num_unused_pages() < 2 * reservePages
-		|| 3 * cache->page_count > 2 * fileSize / B_PAGE_SIZE) {
-		cache->ReleaseRef();
-		return;
-	}
+	// Don't do anything if we don't have the resources left
+	if (vm_page_num_unused_pages() < 2 * reservePages)
+		return false;
 
 	size_t bytesToRead = 0;
 	off_t lastOffset = offset;
@@ -1030,28 +1044,293 @@ cache_prefetch_vnode(struct vnode* vnode, off_t offset, size_t size)
 		lastOffset = offset;
 	}
 
-	cache->ReleaseRefAndUnlock();
+	cache->Unlock();
 	vm_page_unreserve_pages(&reservation);
+	return true;
 }
 
 
-extern "C" void
-cache_prefetch(dev_t mountID, ino_t vnodeID, off_t offset, size_t size)
+/*!	Waits until the asynchronous reads of earlier prefetches have progressed
+	enough, so that prefetching doesn't hold up demand I/O by filling up the
+	device queues.
+*/
+static void
+wait_for_prefetch_io()
 {
-	// ToDo: schedule prefetch
+	while (atomic_get(&sPrefetchPagesInFlight) >= kMaxPrefetchPagesInFlight) {
+		ConditionVariableEntry entry;
+		sPrefetchIOCondition.Add(&entry);
 
-	TRACE(("cache_prefetch(vnode %ld:%Ld)\n", mountID, vnodeID));
+		if (atomic_get(&sPrefetchPagesInFlight) < kMaxPrefetchPagesInFlight)
+			break;
+
+		entry.Wait(B_RELATIVE_TIMEOUT, 100000);
+	}
+}
+
+
+/*!	Takes the next part to be read off the given request.
+	Returns \c false, if the request is done, or has been cancelled.
+*/
+static bool
+next_prefetch_chunk(prefetch_request* request, off_t fileSize, off_t& _offset,
+	size_t& _size)
+{
+	if (low_resource_state(B_KERNEL_RESOURCE_PAGES | B_KERNEL_RESOURCE_MEMORY)
+			!= B_NO_LOW_RESOURCE) {
+		return false;
+	}
+
+	wait_for_prefetch_io();
+
+	MutexLocker locker(sPrefetchLock);
+
+	off_t end = min_c(request->end, fileSize);
+	if (request->offset >= end)
+		return false;
+
+	_offset = ROUNDDOWN(request->offset, B_PAGE_SIZE);
+	_size = ROUNDUP(min_c(end - _offset, (off_t)kPrefetchChunkSize),
+		B_PAGE_SIZE);
+
+	request->offset = _offset + _size;
+	return true;
+}
+
+
+static void
+prefetch_node(prefetch_request* request)
+{
+	TRACE(("prefetch_node(vnode %" B_PRIdDEV ":%" B_PRIdINO ")\n",
+		request->device, request->node));
 
 	// get the vnode for the object, this also grabs a ref to it
 	struct vnode* vnode;
-	if (vfs_get_vnode(mountID, vnodeID, true, &vnode) != B_OK)
+	if (vfs_get_vnode(request->device, request->node, true, &vnode) != B_OK)
 		return;
 
-	cache_prefetch_vnode(vnode, offset, size);
+	VMCache* cache;
+	if (vfs_get_vnode_cache(vnode, &cache, false) == B_OK) {
+		off_t fileSize = cache->virtual_end;
+
+		// Don't do anything if the cache already contains more than 2/3 of
+		// its pages
+		if (cache->type == CACHE_TYPE_VNODE
+			&& 3 * cache->page_count <= 2 * fileSize / B_PAGE_SIZE) {
+			off_t offset;
+			size_t size;
+			while (next_prefetch_chunk(request, fileSize, offset, size)) {
+				if (!prefetch_cache_range(cache, offset, size))
+					break;
+			}
+		}
+
+		cache->ReleaseRef();
+	}
+
 	vfs_put_vnode(vnode);
 }
 
 
+static status_t
+prefetch_thread(void* data)
+{
+	const int32 index = (addr_t)data;
+
+	MutexLocker locker(sPrefetchLock);
+
+	while (true) {
+		prefetch_request* request = sPrefetchRequests.RemoveHead();
+		if (request == NULL) {
+			sPrefetchCondition.Wait(&sPrefetchLock);
+			continue;
+		}
+
+		sPrefetchRequestCount--;
+		sActivePrefetches[index] = request;
+		locker.Unlock();
+
+		prefetch_node(request);
+
+		locker.Lock();
+		sActivePrefetches[index] = NULL;
+		delete request;
+	}
+
+	return B_OK;
+}
+
+
+/*!	Adds the given range to a queued or active request of the same node it
+	overlaps with, if any.
+*/
+static bool
+merge_prefetch_request(dev_t device, ino_t node, off_t offset, off_t end)
+{
+	for (int32 i = 0; i < kPrefetchThreadCount; i++) {
+		prefetch_request* request = sActivePrefetches[i];
+		if (request != NULL && request->device == device
+			&& request->node == node && request->offset <= offset
+			&& end <= request->end) {
+			return true;
+		}
+	}
+
+	for (PrefetchRequestList::Iterator it = sPrefetchRequests.GetIterator();
+			prefetch_request* request = it.Next();) {
+		if (request->device == device && request->node == node
+			&& offset <= request->end && request->offset <= end) {
+			request->offset = min_c(request->offset, offset);
+			request->end = max_c(request->end, end);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/*!	Cancels all queued prefetches, and stops the active ones, as the memory
+	they would use is needed more urgently elsewhere.
+*/
+static void
+prefetch_low_resource_handler(void* data, uint32 resources, int32 level)
+{
+	if (level == B_NO_LOW_RESOURCE)
+		return;
+
+	MutexLocker locker(sPrefetchLock);
+
+	while (prefetch_request* request = sPrefetchRequests.RemoveHead())
+		delete request;
+	sPrefetchRequestCount = 0;
+
+	for (int32 i = 0; i < kPrefetchThreadCount; i++) {
+		if (sActivePrefetches[i] != NULL)
+			sActivePrefetches[i]->end = sActivePrefetches[i]->offset;
+	}
+}
+
+
+static void
+init_prefetch_threads()
+{
+	sPrefetchCondition.Init(&sPrefetchRequests, "prefetch requests");
+	sPrefetchIOCondition.Init(&sPrefetchPagesInFlight, "prefetch I/O");
+	new(&sPrefetchRequests) PrefetchRequestList;
+		// manually call constructor
+
+	for (int32 i = 0; i < kPrefetchThreadCount; i++) {
+		// below the priority of the threads waiting for their I/O
+		thread_id thread = spawn_kernel_thread(&prefetch_thread,
+			"file cache prefetcher", B_LOW_PRIORITY, (void*)(addr_t)i);
+		if (thread < 0)
+			break;
+
+		resume_thread(thread);
+		sPrefetchThreadsStarted++;
+	}
+
+	register_low_resource_handler(&prefetch_low_resource_handler, NULL,
+		B_KERNEL_RESOURCE_PAGES | B_KERNEL_RESOURCE_MEMORY, 10);
+}
+
+
+//	#pragma mark - private kernel API
+
+
+extern "C" void
+cache_prefetch_vnode(struct vnode* vnode, off_t offset, size_t size)
+{
+	if (size == 0)
+		return;
+
+	VMCache* cache;
+	if (vfs_get_vnode_cache(vnode, &cache, false) != B_OK)
+		return;
+	if (cache->type != CACHE_TYPE_VNODE) {
+		cache->ReleaseRef();
+		return;
+	}
+
+	off_t fileSize = cache->virtual_end;
+
+	if ((off_t)(offset + size) > fileSize)
+		size = fileSize - offset;
+
+	// "offset" and "size" are always aligned to B_PAGE_SIZE,
+	offset = ROUNDDOWN(offset, B_PAGE_SIZE);
+	size = ROUNDUP(size, B_PAGE_SIZE);
+
+	// Don't do anything if the cache already contains more than 2/3 of its
+	// pages
+	if (offset < fileSize
+		&& 3 * cache->page_count <= 2 * fileSize / B_PAGE_SIZE) {
+		prefetch_cache_range(cache, offset, size);
+	}
+
+	cache->ReleaseRef();
+}
+
+
+/*!	Queues the given range of the node to be read into its cache by the
+	prefetch threads. Ranges overlapping with queued ones are merged into them.
+	Prefetching is skipped when memory is low, or too much is queued already.
+*/
+extern "C" void
+cache_prefetch(dev_t mountID, ino_t vnodeID, off_t offset, size_t size)
+{
+	TRACE(("cache_prefetch(vnode %ld:%Ld)\n", mountID, vnodeID));
+
+	if (size == 0 || offset < 0)
+		return;
+
+	if (sPrefetchThreadsStarted == 0) {
+		// get the vnode for the object, this also grabs a ref to it
+		struct vnode* vnode;
+		if (vfs_get_vnode(mountID, vnodeID, true, &vnode) != B_OK)
+			return;
+
+		cache_prefetch_vnode(vnode, offset, size);
+		vfs_put_vnode(vnode);
+		return;
+	}
+
+	if (low_resource_state(B_KERNEL_RESOURCE_PAGES | B_KERNEL_RESOURCE_MEMORY)
+			!= B_NO_LOW_RESOURCE) {
+		return;
+	}
+
+	// the whole file is usually requested with a size of ~0UL
+	off_t end = size > (size_t)(OFF_MAX - offset) ? OFF_MAX : offset + size;
+
+	// Allocate before locking: an allocation waiting for memory must not
+	// block the low resource handler, which needs the lock to free some.
+	prefetch_request* request = new(std::nothrow) prefetch_request;
+	if (request == NULL)
+		return;
+
+	request->device = mountID;
+	request->node = vnodeID;
+	request->offset = offset;
+	request->end = end;
+
+	MutexLocker locker(sPrefetchLock);
+
+	if (merge_prefetch_request(mountID, vnodeID, offset, end)
+		|| sPrefetchRequestCount >= kMaxPrefetchRequests) {
+		locker.Unlock();
+		delete request;
+		return;
+	}
+
+	sPrefetchRequests.Add(request);
+	sPrefetchRequestCount++;
+
+	sPrefetchCondition.NotifyOne();
+}
+
+
 extern "C" void
 cache_node_opened(struct vnode* vnode, int32 fdType, VMCache* cache,
 	dev_t mountID, ino_t parentID, ino_t vnodeID, const char* name)
@@ -1127,6 +1406,8 @@ file_cache_init(void)
 		sZeroVecs[i].length = B_PAGE_SIZE;
 	}
 
+	init_prefetch_threads();
+
 	register_generic_syscall(CACHE_SYSCALLS, file_cache_control, 1, 0);
 	return B_OK;
 }
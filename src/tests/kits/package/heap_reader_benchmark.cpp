@@ -0,0 +1,177 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Reads a compressed package file heap sequentially in small and in unaligned
+// large pieces, with and without the chunk cache of the heap reader, and
+// prints the time each run takes, the hit rate of the cache, the number of
+// chunks decompressed ahead and the time spent decompressing. The heap data
+// are generated text.
+
+
+#include <OS.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include <DataIO.h>
+
+#include <package/hpkg/ErrorOutput.h>
+#include <package/hpkg/HPKGDefs.h>
+#include <package/hpkg/PackageFileHeapReader.h>
+#include <package/hpkg/PackageFileHeapWriter.h>
+#include <ZlibCompressionAlgorithm.h>
+
+
+using namespace BPackageKit::BHPKG;
+using BPackageKit::BHPKG::BPrivate::CompressionAlgorithmOwner;
+using BPackageKit::BHPKG::BPrivate::DecompressionAlgorithmOwner;
+using BPackageKit::BHPKG::BPrivate::PackageFileHeapAccessorBase;
+using BPackageKit::BHPKG::BPrivate::PackageFileHeapReader;
+using BPackageKit::BHPKG::BPrivate::PackageFileHeapWriter;
+
+
+static const size_t kDataSize = 64 * 1024 * 1024;
+
+
+class StandardErrorOutput : public BErrorOutput {
+	virtual void PrintErrorVarArgs(const char* format, va_list args)
+	{
+		vfprintf(stderr, format, args);
+	}
+};
+
+
+static void
+generate_data(uint8* data, size_t size)
+{
+	static const char* kWords[] = { "package", "heap", "chunk", "the", "of",
+		"compression", "file", "data", "a", "system", "haiku", "read",
+		"offset", "size", "cache", "\n" };
+
+	uint32 random = 1;
+	size_t offset = 0;
+	while (offset < size) {
+		random = random * 1103515245 + 12345;
+		const char* word = kWords[(random >> 16) % 16];
+		size_t length = std::min(strlen(word), size - offset);
+		memcpy(data + offset, word, length);
+		offset += length;
+		if (offset < size)
+			data[offset++] = ' ';
+	}
+}
+
+
+static void
+read_heap(const char* name, PackageFileHeapReader* reader, const uint8* data,
+	size_t size, size_t readSize)
+{
+	uint8* buffer = (uint8*)malloc(readSize);
+	if (buffer == NULL)
+		exit(1);
+
+	const bigtime_t start = system_time();
+
+	bool identical = true;
+	for (size_t offset = 0; offset < size; offset += readSize) {
+		size_t toRead = std::min(readSize, size - offset);
+		if (reader->ReadData(offset, buffer, toRead) != B_OK)
+			exit(1);
+		identical &= memcmp(buffer, data + offset, toRead) == 0;
+	}
+
+	const bigtime_t time = system_time() - start;
+	free(buffer);
+
+	printf("%-8s %7" B_PRIuSIZE " bytes %9.1f ms %8.1f MiB/s", name, readSize,
+		time / 1000.0, size / (time / 1000000.0) / 1048576);
+
+	PackageFileHeapAccessorBase::ChunkCacheStatistics statistics;
+	if (reader->GetChunkCacheStatistics(statistics)) {
+		uint64 reads = statistics.hits + statistics.misses;
+		printf("  hits %5.1f%%  ahead %5" B_PRIu64 "  decompressing %8.1f ms",
+			reads > 0 ? 100.0 * statistics.hits / reads : 0.0,
+			statistics.readAheadChunks,
+			statistics.decompressionTime / 1000.0);
+	}
+
+	printf("  %s\n", identical ? "identical" : "DIFFERENT");
+}
+
+
+static PackageFileHeapReader*
+create_reader(BErrorOutput* errorOutput, BMallocIO& heap, size_t size,
+	DecompressionAlgorithmOwner* decompressionAlgorithm, bool cache)
+{
+	PackageFileHeapReader* reader = new PackageFileHeapReader(errorOutput,
+		&heap, 0, heap.BufferLength(), size, decompressionAlgorithm);
+	if (reader->Init() != B_OK)
+		exit(1);
+
+	if (!cache)
+		reader->UninitChunkCache();
+
+	return reader;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	StandardErrorOutput errorOutput;
+
+	uint8* data = (uint8*)malloc(kDataSize);
+	if (data == NULL)
+		return 1;
+	generate_data(data, kDataSize);
+
+	CompressionAlgorithmOwner* compressionAlgorithm
+		= CompressionAlgorithmOwner::Create(new BZlibCompressionAlgorithm,
+			new BZlibCompressionParameters(B_ZLIB_COMPRESSION_BEST));
+	DecompressionAlgorithmOwner* decompressionAlgorithm
+		= DecompressionAlgorithmOwner::Create(new BZlibCompressionAlgorithm,
+			new BZlibDecompressionParameters);
+	if (compressionAlgorithm == NULL || decompressionAlgorithm == NULL)
+		return 1;
+
+	BMallocIO heap;
+	{
+		PackageFileHeapWriter writer(&errorOutput, &heap, 0,
+			compressionAlgorithm, decompressionAlgorithm);
+		writer.Init();
+		writer.AddDataThrows(data, kDataSize);
+		if (writer.Finish() != B_OK)
+			return 1;
+	}
+
+	printf("%" B_PRIuSIZE " MiB of heap data, %" B_PRIuSIZE " MiB compressed\n",
+		kDataSize / 1048576, heap.BufferLength() / 1048576);
+
+	// small reads, as when reading attributes or small files, and large ones
+	// not aligned to chunks, as when extracting files
+	const size_t readSizes[] = { 4096, 65536 + 512 };
+
+	for (size_t i = 0; i < sizeof(readSizes) / sizeof(readSizes[0]); i++) {
+		PackageFileHeapReader* reader = create_reader(&errorOutput, heap,
+			kDataSize, decompressionAlgorithm, false);
+		read_heap("uncached", reader, data, kDataSize, readSizes[i]);
+		delete reader;
+
+		reader = create_reader(&errorOutput, heap, kDataSize,
+			decompressionAlgorithm, true);
+		read_heap("cached", reader, data, kDataSize, readSizes[i]);
+		delete reader;
+	}
+
+	compressionAlgorithm->ReleaseReference();
+	decompressionAlgorithm->ReleaseReference();
+	free(data);
+	return 0;
+}
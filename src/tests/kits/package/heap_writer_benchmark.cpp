@@ -0,0 +1,203 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Writes a package file heap with a growing number of compression threads,
+// and prints the time each run takes, its speedup over a single thread, and
+// whether the heap is the same as with a single thread. The heap data are the
+// contents of the file given as argument, e.g. a large package, or else
+// generated text.
+
+
+#include <OS.h>
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <DataIO.h>
+#include <File.h>
+
+#include <package/hpkg/DataReader.h>
+#include <package/hpkg/ErrorOutput.h>
+#include <package/hpkg/HPKGDefs.h>
+#include <package/hpkg/PackageFileHeapWriter.h>
+#include <ZlibCompressionAlgorithm.h>
+#include <ZstdCompressionAlgorithm.h>
+
+
+using namespace BPackageKit::BHPKG;
+using BPackageKit::BHPKG::BPrivate::CompressionAlgorithmOwner;
+using BPackageKit::BHPKG::BPrivate::DecompressionAlgorithmOwner;
+using BPackageKit::BHPKG::BPrivate::PackageFileHeapWriter;
+
+
+static const size_t kGeneratedDataSize = 128 * 1024 * 1024;
+static const size_t kAddDataSize = 1024 * 1024;
+
+
+class StandardErrorOutput : public BErrorOutput {
+	virtual void PrintErrorVarArgs(const char* format, va_list args)
+	{
+		vfprintf(stderr, format, args);
+	}
+};
+
+
+static void
+generate_data(uint8* data, size_t size)
+{
+	static const char* kWords[] = { "package", "heap", "chunk", "the", "of",
+		"compression", "file", "data", "a", "system", "haiku", "write",
+		"offset", "size", "thread", "\n" };
+
+	uint32 random = 1;
+	size_t offset = 0;
+	while (offset < size) {
+		random = random * 1103515245 + 12345;
+		const char* word = kWords[(random >> 16) % 16];
+		size_t length = std::min(strlen(word), size - offset);
+		memcpy(data + offset, word, length);
+		offset += length;
+		if (offset < size)
+			data[offset++] = ' ';
+	}
+}
+
+
+static bigtime_t
+write_heap(CompressionAlgorithmOwner* compressionAlgorithm,
+	DecompressionAlgorithmOwner* decompressionAlgorithm, int32 threadCount,
+	const uint8* data, size_t size, BMallocIO& output)
+{
+	StandardErrorOutput errorOutput;
+	output.SetSize(0);
+
+	const bigtime_t start = system_time();
+
+	PackageFileHeapWriter writer(&errorOutput, &output, 0,
+		compressionAlgorithm, decompressionAlgorithm);
+	writer.Init(threadCount);
+
+	for (size_t offset = 0; offset < size; offset += kAddDataSize) {
+		writer.AddDataThrows(data + offset,
+			std::min(kAddDataSize, size - offset));
+	}
+
+	if (writer.Finish() != B_OK)
+		exit(1);
+
+	return system_time() - start;
+}
+
+
+static void
+run_algorithm(const char* name, BCompressionAlgorithm* algorithm,
+	BCompressionParameters* parameters,
+	BCompressionAlgorithm* decompressionAlgorithm,
+	BDecompressionParameters* decompressionParameters, const uint8* data,
+	size_t size)
+{
+	CompressionAlgorithmOwner* compressionOwner
+		= CompressionAlgorithmOwner::Create(algorithm, parameters);
+	DecompressionAlgorithmOwner* decompressionOwner
+		= DecompressionAlgorithmOwner::Create(decompressionAlgorithm,
+			decompressionParameters);
+	if (compressionOwner == NULL || decompressionOwner == NULL)
+		exit(1);
+
+	// skip algorithms this build doesn't support
+	char buffer[256];
+	size_t compressedSize;
+	if (algorithm->CompressBuffer(data, sizeof(buffer), buffer, sizeof(buffer),
+			compressedSize, parameters) == B_NOT_SUPPORTED) {
+		printf("%-5s not supported\n", name);
+		compressionOwner->ReleaseReference();
+		decompressionOwner->ReleaseReference();
+		return;
+	}
+
+	const int32 cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+
+	BMallocIO reference;
+	const bigtime_t referenceTime = write_heap(compressionOwner,
+		decompressionOwner, 1, data, size, reference);
+	printf("%-5s %2d threads %9.1f ms %8.1f MiB/s  ratio %.3f\n", name, 1,
+		referenceTime / 1000.0, size / (referenceTime / 1000000.0) / 1048576,
+		(double)reference.BufferLength() / size);
+
+	for (int32 threadCount = 2; threadCount < cpuCount * 2;
+			threadCount *= 2) {
+		if (threadCount > cpuCount)
+			threadCount = cpuCount;
+
+		BMallocIO output;
+		const bigtime_t time = write_heap(compressionOwner, decompressionOwner,
+			threadCount, data, size, output);
+		bool identical = output.BufferLength() == reference.BufferLength()
+			&& memcmp(output.Buffer(), reference.Buffer(),
+				output.BufferLength()) == 0;
+
+		printf("%-5s %2" B_PRId32 " threads %9.1f ms %8.1f MiB/s  x%.2f  %s\n",
+			name, threadCount, time / 1000.0,
+			size / (time / 1000000.0) / 1048576, (double)referenceTime / time,
+			identical ? "identical" : "DIFFERENT");
+
+		if (threadCount == cpuCount)
+			break;
+	}
+
+	compressionOwner->ReleaseReference();
+	decompressionOwner->ReleaseReference();
+}
+
+
+int
+main(int argc, char** argv)
+{
+	size_t size = kGeneratedDataSize;
+	uint8* data;
+
+	if (argc > 1) {
+		BFile file(argv[1], B_READ_ONLY);
+		off_t fileSize;
+		if (file.InitCheck() != B_OK || file.GetSize(&fileSize) != B_OK) {
+			fprintf(stderr, "Failed to open \"%s\"\n", argv[1]);
+			return 1;
+		}
+
+		size = fileSize;
+		data = (uint8*)malloc(size);
+		if (data == NULL || file.ReadAtExactly(0, data, size) != B_OK) {
+			fprintf(stderr, "Failed to read \"%s\"\n", argv[1]);
+			return 1;
+		}
+	} else {
+		data = (uint8*)malloc(size);
+		if (data == NULL)
+			return 1;
+		generate_data(data, size);
+	}
+
+	printf("%" B_PRIuSIZE " MiB of heap data\n", size / 1048576);
+
+	// zlib at the level "package create" uses by default, zstd at its
+	// default level, since its best one is far slower
+	run_algorithm("zlib", new BZlibCompressionAlgorithm,
+		new BZlibCompressionParameters(B_ZLIB_COMPRESSION_BEST),
+		new BZlibCompressionAlgorithm, new BZlibDecompressionParameters,
+		data, size);
+	run_algorithm("zstd", new BZstdCompressionAlgorithm,
+		new BZstdCompressionParameters(B_ZSTD_COMPRESSION_DEFAULT),
+		new BZstdCompressionAlgorithm, new BZstdDecompressionParameters,
+		data, size);
+
+	free(data);
+	return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Trains autoencoders of the ANN library one sample at a time, and prints the
+// time per sample with the rate at which the weights go through memory. Each
+// training step reads the weights for the feed forward pass and for the hidden
+// gradients, and reads and writes them for the update. The benchmark exits
+// with an error if the training diverges.
+
+
+#include <OS.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include "NeuralNetwork.hpp"
+
+
+// Returns whether the final error is finite.
+static bool
+run_autoencoder(const vector<int>& topology, int samples, int epochs)
+{
+	ANNConfig config;
+	config.topology = topology;
+	config.bias = 1;
+	config.learningRate = 0.05;
+	config.momentum = 1;
+	config.epoch = epochs;
+	config.hActivation = A_RELU;
+	config.oActivation = A_SIGM;
+	config.cost = COST_MSE;
+
+	NeuralNetwork network(config);
+
+	vector< vector<double> > data(samples, vector<double>(topology[0]));
+	for (int i = 0; i < samples; i++) {
+		for (int j = 0; j < topology[0]; j++)
+			data[i][j] = 0.5 + 0.5 * sin(i * 0.3 + j * 0.11);
+	}
+
+	double weights = 0;
+	for (unsigned int i = 0; i + 1 < topology.size(); i++)
+		weights += (double)topology[i] * topology[i + 1];
+
+	const bigtime_t start = system_time();
+	for (int epoch = 0; epoch < epochs; epoch++) {
+		for (int i = 0; i < samples; i++) {
+			network.train(data[i], data[i], config.bias, config.learningRate,
+				config.momentum);
+		}
+	}
+	const bigtime_t time = system_time() - start;
+
+	const double perSample = (double)time / (samples * epochs);
+	printf("%4d", topology[0]);
+	for (unsigned int i = 1; i < topology.size(); i++)
+		printf("-%d", topology[i]);
+	printf("  %8.0f weights  %9.1f us/sample  %6.2f GB/s  error %.6f\n",
+		weights, perSample, weights * sizeof(double) * 4 / perSample / 1000,
+		network.error);
+
+	return isfinite(network.error);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	vector<int> small;
+	small.push_back(64);
+	small.push_back(32);
+	small.push_back(16);
+	small.push_back(32);
+	small.push_back(64);
+
+	vector<int> large;
+	large.push_back(784);
+	large.push_back(512);
+	large.push_back(128);
+	large.push_back(512);
+	large.push_back(784);
+
+	bool finite = run_autoencoder(small, 1000, 10);
+	finite = run_autoencoder(large, 100, 3) && finite;
+
+	return finite ? 0 : 1;
+}
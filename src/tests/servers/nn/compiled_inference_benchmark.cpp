@@ -0,0 +1,177 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Compares the throughput of NeuralNetwork::calculate_output_data() with a
+// CompiledNeuralNetwork evaluated by loops and by generated machine code, and
+// checks that the three of them compute the same outputs. Also compares the
+// latency of single instance calls to calculate_outputs(). Exits with an error
+// if the outputs differ by more than rounding.
+
+
+#include <OS.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include "neural_network/compiled_neural_network.h"
+#include "neural_network/neural_network.h"
+#include "neural_network/scaling_layer.h"
+#include "neural_network/unscaling_layer.h"
+
+
+using OpenNN::CompiledNeuralNetwork;
+using OpenNN::Matrix;
+using OpenNN::NeuralNetwork;
+using OpenNN::Vector;
+
+
+// The outputs are unscaled to [-10, 10], and only the order of the operations
+// differs between the three evaluations.
+static const double kTolerance = 1e-9;
+
+static bool sFailed = false;
+
+
+static double
+max_difference(const Matrix<double>& a, const Matrix<double>& b)
+{
+	double difference = 0.0;
+	for (unsigned int i = 0; i < a.get_rows_number(); i++) {
+		for (unsigned int j = 0; j < a.get_columns_number(); j++)
+			difference = fmax(difference, fabs(a[i][j] - b[i][j]));
+	}
+
+	return difference;
+}
+
+
+static void
+run_architecture(const Vector<unsigned int>& architecture,
+	unsigned int instances)
+{
+	static const int kIterations = 5;
+
+	const unsigned int inputsNumber = architecture[0];
+	const unsigned int outputsNumber = architecture[architecture.size() - 1];
+
+	NeuralNetwork neuralNetwork(architecture);
+	neuralNetwork.initialize_parameters_normal();
+
+	neuralNetwork.construct_scaling_layer();
+	neuralNetwork.get_scaling_layer_pointer()->set_means(
+		Vector<double>(inputsNumber, 0.5));
+	neuralNetwork.get_scaling_layer_pointer()->set_standard_deviations(
+		Vector<double>(inputsNumber, 2.0));
+	neuralNetwork.get_scaling_layer_pointer()->set_scaling_method(
+		OpenNN::ScalingLayer::MeanStandardDeviation);
+
+	neuralNetwork.construct_unscaling_layer();
+	neuralNetwork.get_unscaling_layer_pointer()->set_minimums(
+		Vector<double>(outputsNumber, -10.0));
+	neuralNetwork.get_unscaling_layer_pointer()->set_maximums(
+		Vector<double>(outputsNumber, 10.0));
+
+	Matrix<double> inputs(instances, inputsNumber);
+	for (unsigned int i = 0; i < instances; i++) {
+		for (unsigned int j = 0; j < inputsNumber; j++)
+			inputs[i][j] = sin(0.37 * i + j);
+	}
+
+	bigtime_t start = system_time();
+	Matrix<double> interpretedOutputs;
+	for (int i = 0; i < kIterations; i++)
+		interpretedOutputs = neuralNetwork.calculate_output_data(inputs);
+	const bigtime_t interpretedTime = (system_time() - start) / kIterations;
+
+	CompiledNeuralNetwork loopNetwork;
+	loopNetwork.set_jit_flag(false);
+	loopNetwork.compile(neuralNetwork);
+
+	Matrix<double> loopOutputs;
+	start = system_time();
+	for (int i = 0; i < kIterations; i++)
+		loopNetwork.calculate_output_data(inputs, loopOutputs);
+	const bigtime_t loopTime = (system_time() - start) / kIterations;
+
+	start = system_time();
+	CompiledNeuralNetwork jitNetwork(neuralNetwork);
+	const bigtime_t compileTime = system_time() - start;
+
+	Matrix<double> jitOutputs;
+	start = system_time();
+	for (int i = 0; i < kIterations; i++)
+		jitNetwork.calculate_output_data(inputs, jitOutputs);
+	const bigtime_t jitTime = (system_time() - start) / kIterations;
+
+	const Vector<double> instance = inputs.arrange_row(0);
+
+	start = system_time();
+	for (unsigned int i = 0; i < instances; i++)
+		neuralNetwork.calculate_outputs(instance);
+	const bigtime_t interpretedCallTime = system_time() - start;
+
+	start = system_time();
+	for (unsigned int i = 0; i < instances; i++)
+		jitNetwork.calculate_outputs(instance);
+	const bigtime_t compiledCallTime = system_time() - start;
+
+	printf("%2u-", architecture[0]);
+	for (unsigned int i = 1; i < architecture.size(); i++)
+		printf("%u%s", architecture[i], i + 1 < architecture.size() ? "-" : "");
+	printf("\t%u instances\n", instances);
+	printf("\tinterpreted %9.1f us\n", (double)interpretedTime);
+	const double loopDifference
+		= max_difference(interpretedOutputs, loopOutputs);
+	printf("\tloops       %9.1f us  %5.1fx  max difference %g%s\n",
+		(double)loopTime, (double)interpretedTime / loopTime, loopDifference,
+		loopDifference > kTolerance ? "  WRONG" : "");
+	if (loopDifference > kTolerance)
+		sFailed = true;
+	if (jitNetwork.is_jit_compiled()) {
+		const double jitDifference
+			= max_difference(interpretedOutputs, jitOutputs);
+		printf("\tjit         %9.1f us  %5.1fx  max difference %g"
+			"  (compiled in %.1f us)%s\n", (double)jitTime,
+			(double)interpretedTime / jitTime, jitDifference,
+			(double)compileTime, jitDifference > kTolerance ? "  WRONG" : "");
+		if (jitDifference > kTolerance)
+			sFailed = true;
+	} else
+		printf("\tjit         not generated\n");
+	printf("\tsingle instance calls %.3f us interpreted, %.3f us compiled\n",
+		(double)interpretedCallTime / instances,
+		(double)compiledCallTime / instances);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	static const unsigned int kInstances = 20000;
+
+	Vector<unsigned int> small(3);
+	small[0] = 4;
+	small[1] = 12;
+	small[2] = 3;
+
+	Vector<unsigned int> medium(4);
+	medium[0] = 16;
+	medium[1] = 32;
+	medium[2] = 16;
+	medium[3] = 4;
+
+	Vector<unsigned int> large(4);
+	large[0] = 64;
+	large[1] = 128;
+	large[2] = 64;
+	large[3] = 8;
+
+	run_architecture(small, kInstances);
+	run_architecture(medium, kInstances);
+	run_architecture(large, kInstances);
+
+	return sFailed ? 1 : 0;
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Trains a neural network with the quasi-Newton method and gradient descent,
+// with the golden section and the Brent's line minimizations evaluating one
+// training rate at a time or several at once, and prints the number of
+// performance evaluations of the line minimizations with the training time.
+// Several training rates at once change the path of the golden section and
+// the Brent's methods, so the final performances differ slightly. Exits with
+// an error if one with several threads is more than 1.5 times the one with a
+// single thread.
+
+
+#include <OS.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include "training_strategy/gradient_descent.h"
+#include "training_strategy/quasi_newton_method.h"
+
+
+using OpenNN::DataSet;
+using OpenNN::GradientDescent;
+using OpenNN::Matrix;
+using OpenNN::NeuralNetwork;
+using OpenNN::PerformanceFunctional;
+using OpenNN::QuasiNewtonMethod;
+using OpenNN::ThreadPool;
+using OpenNN::TrainingRateAlgorithm;
+using OpenNN::Vector;
+
+
+static bool sFailed = false;
+
+
+static void
+fill_data(Matrix<double>& data)
+{
+	for (unsigned int i = 0; i < data.get_rows_number(); i++) {
+		for (unsigned int j = 0; j < 4; j++)
+			data[i][j] = sin(0.37 * i * (j + 1) + j);
+		data[i][4] = data[i][0] * data[i][1] + 0.5 * sin(3.0 * data[i][2])
+			- data[i][3];
+	}
+}
+
+
+static void
+check_evaluation(double evaluation, double singleThreadEvaluation)
+{
+	if (!(evaluation <= 1.5 * singleThreadEvaluation)) {
+		printf("  evaluation too far from the single thread one\n");
+		sFailed = true;
+	}
+}
+
+
+static void
+print_results(const char* name, TrainingRateAlgorithm& trainingRateAlgorithm,
+	unsigned int threads, const Vector<unsigned int>& evaluationsNumbers,
+	double finalEvaluation, bigtime_t time)
+{
+	unsigned int evaluations = 0;
+	for (unsigned int i = 0; i < evaluationsNumbers.size(); i++)
+		evaluations += evaluationsNumbers[i];
+
+	printf("%-6s %-13s %2u threads %4u epochs %6u evaluations %6.1f per epoch"
+		"  %9.1f ms  evaluation %.6e\n", name,
+		trainingRateAlgorithm.write_training_rate_method().c_str(), threads,
+		(unsigned int)evaluationsNumbers.size(), evaluations,
+		(double)evaluations / evaluationsNumbers.size(), time / 1000.0,
+		finalEvaluation);
+}
+
+
+// Returns the performance after the training.
+static double
+run_quasi_Newton(NeuralNetwork& neuralNetwork,
+	PerformanceFunctional& performanceFunctional,
+	const Vector<double>& parameters, const char* method,
+	unsigned int threads)
+{
+	neuralNetwork.set_parameters(parameters);
+
+	QuasiNewtonMethod quasiNewtonMethod(&performanceFunctional);
+	quasiNewtonMethod.set_maximum_epochs_number(200);
+	quasiNewtonMethod.set_display(false);
+	quasiNewtonMethod.set_reserve_evaluations_number_history(true);
+
+	TrainingRateAlgorithm* trainingRateAlgorithm
+		= quasiNewtonMethod.get_training_rate_algorithm_pointer();
+	trainingRateAlgorithm->set_training_rate_method(method);
+	trainingRateAlgorithm->set_threads_number(threads);
+	trainingRateAlgorithm->set_display(false);
+
+	const bigtime_t start = system_time();
+	QuasiNewtonMethod::QuasiNetwonMethodResults* results
+		= quasiNewtonMethod.perform_training();
+	const bigtime_t time = system_time() - start;
+
+	const double evaluation = performanceFunctional.calculate_evaluation();
+	print_results("quasi", *trainingRateAlgorithm, threads,
+		results->evaluations_number_history, evaluation, time);
+
+	delete results;
+	return evaluation;
+}
+
+
+// Returns the performance after the training.
+static double
+run_gradient_descent(NeuralNetwork& neuralNetwork,
+	PerformanceFunctional& performanceFunctional,
+	const Vector<double>& parameters, const char* method,
+	unsigned int threads)
+{
+	neuralNetwork.set_parameters(parameters);
+
+	GradientDescent gradientDescent(&performanceFunctional);
+	gradientDescent.set_maximum_epochs_number(200);
+	gradientDescent.set_display(false);
+	gradientDescent.set_reserve_evaluations_number_history(true);
+
+	TrainingRateAlgorithm* trainingRateAlgorithm
+		= gradientDescent.get_training_rate_algorithm_pointer();
+	trainingRateAlgorithm->set_training_rate_method(method);
+	trainingRateAlgorithm->set_threads_number(threads);
+	trainingRateAlgorithm->set_display(false);
+
+	const bigtime_t start = system_time();
+	GradientDescent::GradientDescentResults* results
+		= gradientDescent.perform_training();
+	const bigtime_t time = system_time() - start;
+
+	const double evaluation = performanceFunctional.calculate_evaluation();
+	print_results("grad", *trainingRateAlgorithm, threads,
+		results->evaluations_number_history, evaluation, time);
+
+	delete results;
+	return evaluation;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	Matrix<double> data(4000, 5);
+	fill_data(data);
+
+	DataSet dataSet(4000, 4, 1);
+	dataSet.set_data(data);
+
+	NeuralNetwork neuralNetwork(4, 16, 1);
+	const Vector<double> parameters = neuralNetwork.arrange_parameters();
+
+	PerformanceFunctional performanceFunctional(&neuralNetwork, &dataSet);
+
+	const unsigned int threads = ThreadPool::count_hardware_threads_number();
+	const char* methods[] = { "GoldenSection", "BrentMethod" };
+
+	for (unsigned int i = 0; i < 2; i++) {
+		const double evaluation = run_quasi_Newton(neuralNetwork,
+			performanceFunctional, parameters, methods[i], 1);
+		check_evaluation(run_quasi_Newton(neuralNetwork, performanceFunctional,
+			parameters, methods[i], threads), evaluation);
+	}
+
+	for (unsigned int i = 0; i < 2; i++) {
+		const double evaluation = run_gradient_descent(neuralNetwork,
+			performanceFunctional, parameters, methods[i], 1);
+		check_evaluation(run_gradient_descent(neuralNetwork,
+			performanceFunctional, parameters, methods[i], threads),
+			evaluation);
+	}
+
+	return sFailed ? 1 : 0;
+}
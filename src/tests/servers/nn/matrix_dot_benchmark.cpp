@@ -0,0 +1,222 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Compares the blocked Matrix<double>::dot() kernel with the naive i-j-k
+// loop it replaced, for square and tall-skinny shapes, and the matrix-vector
+// and vector-matrix kernels with plain loops. Fails if any kernel disagrees
+// with its loop by more than rounding.
+
+
+#include <OS.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "utilities/matrix.h"
+
+
+using OpenNN::Matrix;
+using OpenNN::Vector;
+
+
+static bool sFailed = false;
+
+
+static void
+check_error(double maxError, unsigned int depth)
+{
+	// Each result sums depth products of values below 0.5 in magnitude
+	if (maxError > 1e-12 * depth) {
+		printf("  max error too large\n");
+		sFailed = true;
+	}
+}
+
+
+static void
+naive_dot(const Matrix<double>& a, const Matrix<double>& b, Matrix<double>& c)
+{
+	const unsigned int rows = a.get_rows_number();
+	const unsigned int columns = b.get_columns_number();
+	const unsigned int depth = a.get_columns_number();
+
+	for (unsigned int i = 0; i < rows; i++) {
+		for (unsigned int j = 0; j < columns; j++) {
+			double sum = 0;
+			for (unsigned int k = 0; k < depth; k++)
+				sum += a[i][k] * b[k][j];
+			c[i][j] = sum;
+		}
+	}
+}
+
+
+static void
+fill_random(Matrix<double>& matrix)
+{
+	for (unsigned int i = 0; i < matrix.get_rows_number(); i++) {
+		for (unsigned int j = 0; j < matrix.get_columns_number(); j++)
+			matrix[i][j] = (double)rand() / RAND_MAX - 0.5;
+	}
+}
+
+
+static void
+run_shape(unsigned int m, unsigned int k, unsigned int n)
+{
+	Matrix<double> a(m, k);
+	Matrix<double> b(k, n);
+	Matrix<double> reference(m, n);
+	fill_random(a);
+	fill_random(b);
+
+	const double flops = 2.0 * m * n * k;
+	const int iterations = flops > 1e9 ? 1 : (int)(1e9 / flops) + 1;
+
+	bigtime_t start = system_time();
+	for (int i = 0; i < iterations; i++)
+		naive_dot(a, b, reference);
+	const bigtime_t naiveTime = system_time() - start;
+
+	Matrix<double> product;
+	start = system_time();
+	for (int i = 0; i < iterations; i++)
+		product = a.dot(b);
+	const bigtime_t blockedTime = system_time() - start;
+
+	double maxError = 0;
+	for (unsigned int i = 0; i < m; i++) {
+		for (unsigned int j = 0; j < n; j++)
+			maxError = fmax(maxError, fabs(product[i][j] - reference[i][j]));
+	}
+
+	const double naiveGflops = flops * iterations / (naiveTime * 1e3);
+	const double blockedGflops = flops * iterations / (blockedTime * 1e3);
+
+	printf("%6u x %6u x %6u  naive %7.2f GFLOP/s  blocked %7.2f GFLOP/s"
+		"  speedup %6.2fx  max error %.3g\n", m, k, n, naiveGflops,
+		blockedGflops, blockedGflops / naiveGflops, maxError);
+	check_error(maxError, k);
+}
+
+
+static void
+run_vector_shape(unsigned int m, unsigned int n)
+{
+	Matrix<double> a(m, n);
+	fill_random(a);
+	Vector<double> x(n);
+	for (unsigned int i = 0; i < n; i++)
+		x[i] = (double)rand() / RAND_MAX - 0.5;
+
+	const double flops = 2.0 * m * n;
+	const int iterations = (int)(1e9 / flops) + 1;
+
+	Vector<double> reference(m);
+	bigtime_t start = system_time();
+	for (int iteration = 0; iteration < iterations; iteration++) {
+		for (unsigned int i = 0; i < m; i++) {
+			double sum = 0;
+			for (unsigned int j = 0; j < n; j++)
+				sum += x[j] * a[i][j];
+			reference[i] = sum;
+		}
+	}
+	const bigtime_t naiveTime = system_time() - start;
+
+	Vector<double> product;
+	start = system_time();
+	for (int i = 0; i < iterations; i++)
+		product = a.dot(x);
+	const bigtime_t blockedTime = system_time() - start;
+
+	double maxError = 0;
+	for (unsigned int i = 0; i < m; i++)
+		maxError = fmax(maxError, fabs(product[i] - reference[i]));
+
+	const double naiveGflops = flops * iterations / (naiveTime * 1e3);
+	const double blockedGflops = flops * iterations / (blockedTime * 1e3);
+
+	printf("%6u x %6u (gemv)    naive %7.2f GFLOP/s  kernel  %7.2f GFLOP/s"
+		"  speedup %6.2fx  max error %.3g\n", m, n, naiveGflops,
+		blockedGflops, blockedGflops / naiveGflops, maxError);
+	check_error(maxError, n);
+}
+
+
+static void
+run_transposed_vector_shape(unsigned int m, unsigned int n)
+{
+	Matrix<double> a(m, n);
+	fill_random(a);
+	Vector<double> x(m);
+	for (unsigned int i = 0; i < m; i++)
+		x[i] = (double)rand() / RAND_MAX - 0.5;
+
+	const double flops = 2.0 * m * n;
+	const int iterations = (int)(1e9 / flops) + 1;
+
+	// the scalar loop the kernel replaced, accumulating the rows in turn
+	Vector<double> reference(n);
+	bigtime_t start = system_time();
+	for (int iteration = 0; iteration < iterations; iteration++) {
+		for (unsigned int j = 0; j < n; j++)
+			reference[j] = 0;
+		for (unsigned int i = 0; i < m; i++) {
+			for (unsigned int j = 0; j < n; j++)
+				reference[j] += x[i] * a[i][j];
+		}
+	}
+	const bigtime_t naiveTime = system_time() - start;
+
+	Vector<double> product;
+	start = system_time();
+	for (int i = 0; i < iterations; i++)
+		product = x.dot(a);
+	const bigtime_t blockedTime = system_time() - start;
+
+	double maxError = 0;
+	for (unsigned int j = 0; j < n; j++)
+		maxError = fmax(maxError, fabs(product[j] - reference[j]));
+
+	const double naiveGflops = flops * iterations / (naiveTime * 1e3);
+	const double blockedGflops = flops * iterations / (blockedTime * 1e3);
+
+	printf("%6u x %6u (gemv^T)  naive %7.2f GFLOP/s  kernel  %7.2f GFLOP/s"
+		"  speedup %6.2fx  max error %.3g\n", m, n, naiveGflops,
+		blockedGflops, blockedGflops / naiveGflops, maxError);
+	check_error(maxError, m);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	static const char* kInstructionSets[] = { "scalar", "SSE2", "AVX2" };
+	printf("instruction set: %s\n",
+		kInstructionSets[OpenNN::MatrixKernels::get_instruction_set()]);
+
+	// square
+	run_shape(64, 64, 64);
+	run_shape(256, 256, 256);
+	run_shape(512, 512, 512);
+	run_shape(1024, 1024, 1024);
+
+	// tall-skinny: instances x features times features x perceptrons
+	run_shape(100000, 64, 16);
+	run_shape(20000, 1000, 8);
+	run_shape(8, 1000, 20000);
+
+	run_vector_shape(1000, 1000);
+	run_vector_shape(100000, 16);
+
+	run_transposed_vector_shape(1000, 1000);
+	run_transposed_vector_shape(100000, 16);
+	run_transposed_vector_shape(16, 4099);
+
+	return sFailed ? 1 : 0;
+}
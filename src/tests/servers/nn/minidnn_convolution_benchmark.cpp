@@ -0,0 +1,192 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Compares the algorithms of the convolutions of MiniDNN on the shapes of the
+// forward and backward passes of a few convolutional layers: the time each
+// one takes and its largest difference with MEC. Then trains networks with
+// each algorithm, and with the algorithm chosen for each convolution at first
+// use. The algorithms only differ in the order of their operations, so the
+// benchmark exits with an error if a convolution or a final loss differs from
+// the MEC one by more than rounding.
+
+
+#include <OS.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <limits>
+
+#include <MiniDNN.h>
+
+
+using namespace MiniDNN;
+
+typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+typedef Eigen::Matrix<Scalar, Eigen::Dynamic, 1> Vector;
+
+
+static const ConvAlgorithm kAlgorithms[] = { CONV_MEC, CONV_IM2COL,
+	CONV_WINOGRAD };
+static const char* kAlgorithmNames[] = { "mec", "im2col", "winograd" };
+static const int kAlgorithmCount = 3;
+
+// Relative tolerances, in units of the rounding error of Scalar.
+static const Scalar kConvolutionTolerance
+	= 1e4 * std::numeric_limits<Scalar>::epsilon();
+static const Scalar kLossTolerance
+	= 1e6 * std::numeric_limits<Scalar>::epsilon();
+
+static bool sFailed = false;
+
+
+// Runs one convolution with every algorithm that applies. 'full' selects the
+// "full" rule, which always has its images as the outer loop.
+static void
+compare_algorithms(const char* name, const internal::ConvDims& dim,
+	bool imageOuterLoop, bool full, int count)
+{
+	static const int kIterations = 5;
+
+	const int channelSize = dim.channel_rows * dim.channel_cols;
+	const int filterSize = dim.filter_rows * dim.filter_cols;
+	const int resultSize = full
+		? (dim.channel_rows + dim.filter_rows - 1)
+			* (dim.channel_cols + dim.filter_cols - 1)
+		: dim.conv_rows * dim.conv_cols;
+
+	const Vector src = Vector::Random(channelSize * dim.in_channels * count);
+	const Vector filters = Vector::Random(filterSize * dim.in_channels
+		* dim.out_channels);
+
+	printf("%s\t%d x %dx%d -> %d, %dx%d filters, %d\n", name, dim.in_channels,
+		dim.channel_rows, dim.channel_cols, dim.out_channels, dim.filter_rows,
+		dim.filter_cols, count);
+
+	Vector reference;
+	for (int a = 0; a < kAlgorithmCount; a++) {
+		const ConvAlgorithm algorithm = kAlgorithms[a];
+		if (!internal::conv_algorithm_applies(algorithm, dim))
+			continue;
+
+		Vector dest(resultSize * dim.out_channels * count);
+		bigtime_t time = 0;
+		for (int i = 0; i <= kIterations; i++) {
+			// The first run only warms the caches up.
+			const bigtime_t start = system_time();
+			if (full) {
+				internal::convolve_full(dim, algorithm, src.data(), count,
+					filters.data(), dest.data());
+			} else {
+				internal::convolve_valid(dim, algorithm, src.data(),
+					imageOuterLoop, count, filters.data(), dest.data());
+			}
+			if (i > 0)
+				time += system_time() - start;
+		}
+		time /= kIterations;
+
+		if (a == 0) {
+			reference = dest;
+			printf("\t%-9s %9.1f us\n", kAlgorithmNames[a], (double)time);
+			continue;
+		}
+
+		const Scalar scale = reference.cwiseAbs().maxCoeff();
+		const Scalar error = (dest - reference).cwiseAbs().maxCoeff();
+		const bool wrong = !(error <= kConvolutionTolerance * scale);
+		printf("\t%-9s %9.1f us  max difference %.2e of %.2e%s\n",
+			kAlgorithmNames[a], (double)time, (double)error, (double)scale,
+			wrong ? "  WRONG" : "");
+		if (wrong)
+			sFailed = true;
+	}
+}
+
+
+// The three convolutions of a layer taking 'count' observations.
+static void
+compare_layer(const char* name, int width, int height, int inChannels,
+	int outChannels, int window, int count)
+{
+	const internal::ConvDims dim(inChannels, outChannels, height, width, window,
+		window);
+	char label[64];
+
+	snprintf(label, sizeof(label), "%s forward", name);
+	compare_algorithms(label, dim, true, false, count);
+
+	const internal::ConvDims filterDim(count, outChannels, height, width,
+		dim.conv_rows, dim.conv_cols);
+	snprintf(label, sizeof(label), "%s filters", name);
+	compare_algorithms(label, filterDim, false, false, inChannels);
+
+	const internal::ConvDims inputDim(outChannels, inChannels, dim.conv_rows,
+		dim.conv_cols, window, window);
+	snprintf(label, sizeof(label), "%s input", name);
+	compare_algorithms(label, inputDim, true, true, count);
+}
+
+
+// Returns the loss after the training.
+static Scalar
+train_network(const char* name, ConvAlgorithm algorithm, const Matrix& x,
+	const Matrix& y)
+{
+	Network network;
+	Convolutional<ReLU>* first = new Convolutional<ReLU>(28, 28, 1, 16, 3, 3);
+	Convolutional<ReLU>* second = new Convolutional<ReLU>(26, 26, 16, 16, 3,
+		3);
+	first->set_conv_algorithm(algorithm);
+	second->set_conv_algorithm(algorithm);
+
+	network.add_layer(first);
+	network.add_layer(second);
+	network.add_layer(new MaxPooling<ReLU>(24, 24, 16, 2, 2));
+	network.add_layer(new FullyConnected<Identity>(12 * 12 * 16, 10));
+	network.set_output(new RegressionMSE());
+	network.init(0, 0.05, 1);
+
+	SGD optimizer;
+	optimizer.m_lrate = 0.01;
+
+	const bigtime_t start = system_time();
+	network.fit(optimizer, x, y, 32, 2, 1);
+	const bigtime_t time = system_time() - start;
+
+	const Scalar loss = network.get_output()->loss();
+	printf("\t%-9s %9.1f ms  loss %.6f\n", name, time / 1000.0, (double)loss);
+
+	return loss;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	compare_layer("mnist 5x5", 28, 28, 1, 8, 5, 32);
+	compare_layer("mnist 3x3", 28, 28, 1, 16, 3, 32);
+	compare_layer("deep 3x3", 26, 26, 16, 16, 3, 32);
+	compare_layer("wide 3x3", 14, 14, 64, 64, 3, 32);
+
+	Matrix x = (Matrix::Random(28 * 28, 512).array() + 1) / 2;
+	Matrix y = Matrix::Random(10, 512);
+
+	printf("training, 2 epochs of %d observations\n", (int)x.cols());
+	Scalar losses[kAlgorithmCount + 1];
+	for (int a = 0; a < kAlgorithmCount; a++)
+		losses[a] = train_network(kAlgorithmNames[a], kAlgorithms[a], x, y);
+	losses[kAlgorithmCount] = train_network("auto", CONV_AUTO, x, y);
+
+	for (int a = 1; a <= kAlgorithmCount; a++) {
+		if (!(fabs(losses[a] - losses[0]) <= kLossTolerance * losses[0])) {
+			printf("loss %d differs from the MEC one\n", a);
+			sFailed = true;
+		}
+	}
+
+	return sFailed ? 1 : 0;
+}
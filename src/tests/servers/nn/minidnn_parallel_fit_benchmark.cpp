@@ -0,0 +1,99 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Fits the same MiniDNN convolutional network with one and with several
+// threads per mini-batch, and compares the time taken and the parameters
+// reached, which only differ by the rounding of the gradient sums. The
+// benchmark exits with an error if they differ by more than that.
+
+
+#include <OS.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <limits>
+
+#include <MiniDNN.h>
+
+
+using namespace MiniDNN;
+
+typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+
+// Largest parameter difference allowed, in units of the rounding error of
+// Scalar.
+static const Scalar kTolerance = 1e6 * std::numeric_limits<Scalar>::epsilon();
+
+
+static void
+build_network(Network& network)
+{
+	network.add_layer(new Convolutional<ReLU>(28, 28, 1, 8, 5, 5));
+	network.add_layer(new MaxPooling<ReLU>(24, 24, 8, 2, 2));
+	network.add_layer(new Convolutional<ReLU>(12, 12, 8, 16, 3, 3));
+	network.add_layer(new FullyConnected<Identity>(10 * 10 * 16, 10));
+	network.set_output(new RegressionMSE());
+	network.init(0, 0.1, 1);
+}
+
+
+static Scalar
+max_difference(const Network& a, const Network& b)
+{
+	const std::vector<std::vector<Scalar> > first = a.get_parameters();
+	const std::vector<std::vector<Scalar> > second = b.get_parameters();
+
+	Scalar difference = 0;
+	for (size_t i = 0; i < first.size(); i++) {
+		for (size_t j = 0; j < first[i].size(); j++)
+			difference = std::max(difference, std::abs(first[i][j] - second[i][j]));
+	}
+
+	return difference;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const int maxThreads = argc > 1 ? atoi(argv[1]) : 4;
+
+	Matrix images = (Matrix::Random(28 * 28, 1024).array() + 1) / 2;
+	Matrix targets = Matrix::Random(10, 1024);
+
+	Network reference;
+	build_network(reference);
+
+	bool failed = false;
+	bigtime_t referenceTime = 0;
+	for (int threads = 1; threads <= maxThreads; threads *= 2) {
+		Network network;
+		build_network(network);
+
+		SGD optimizer;
+		optimizer.m_lrate = 0.01;
+
+		const bigtime_t start = system_time();
+		network.fit(optimizer, images, targets, 64, 2, 1, threads);
+		const bigtime_t time = system_time() - start;
+
+		if (threads == 1) {
+			reference.set_parameters(network.get_parameters());
+			referenceTime = time;
+		}
+
+		const Scalar difference = max_difference(network, reference);
+		const bool wrong = !(difference <= kTolerance);
+		printf("%d thread(s)\t%9.1f ms  %5.2fx  max parameter difference %.2e%s\n",
+			threads, time / 1000.0, (double)referenceTime / time,
+			(double)difference, wrong ? "  WRONG" : "");
+		if (wrong)
+			failed = true;
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Compares the predictions of MiniDNN networks with their parameters in full
+// precision, in int8 and in float16, together with the time they take and
+// the memory taken by the parameters. Also checks the conversions between
+// single and half precision numbers. The benchmark exits with an error if a
+// conversion fails or if a quantized prediction is further from the full
+// precision one than the rounding of its parameters allows.
+
+
+#include <OS.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include <MiniDNN.h>
+
+
+using namespace MiniDNN;
+
+typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> Matrix;
+
+
+static bool sFailed = false;
+
+
+static int
+check_half_conversions()
+{
+	int failures = 0;
+	for (unsigned int i = 0; i < 0x10000; i++) {
+		const uint16_t half = (uint16_t)i;
+		const float value = internal::half_to_float(half);
+		if (value != value)
+			continue;
+
+		if (internal::float_to_half(value) != half)
+			failures++;
+	}
+
+	// Halfway between 1 and the next half precision number rounds to even.
+	if (internal::float_to_half(1.0f + 1.0f / 2048) != 0x3c00)
+		failures++;
+	if (internal::float_to_half(1.0f + 3.0f / 2048) != 0x3c02)
+		failures++;
+	if (internal::float_to_half(65520.0f) != 0x7c00)
+		failures++;
+
+	return failures;
+}
+
+
+static size_t
+parameters_size(const Network& network)
+{
+	size_t size = 0;
+	std::vector<std::vector<Scalar> > parameters = network.get_parameters();
+	for (size_t i = 0; i < parameters.size(); i++)
+		size += parameters[i].size() * sizeof(Scalar);
+
+	return size;
+}
+
+
+static void
+run_network(const char* name, Network& network, const Matrix& inputs)
+{
+	static const int kIterations = 5;
+
+	const size_t fullSize = parameters_size(network);
+	const Precision precisions[] = { FULL_PRECISION, INT8_PRECISION,
+		FLOAT16_PRECISION };
+	const char* precisionNames[] = { "full", "int8", "float16" };
+	// Largest error allowed, relative to the largest output.
+	const Scalar tolerances[] = { 0, 0.05, 0.002 };
+
+	printf("%s\t%ld observations, %lu bytes of parameters\n", name,
+		(long)inputs.cols(), (unsigned long)fullSize);
+
+	const std::vector<std::vector<Scalar> > parameters
+		= network.get_parameters();
+
+	Matrix reference;
+	bigtime_t referenceTime = 0;
+	for (int p = 0; p < 3; p++) {
+		// Quantizing back to full precision would keep the rounded parameters.
+		network.set_parameters(parameters);
+		network.quantize(precisions[p]);
+
+		Matrix outputs;
+		const bigtime_t start = system_time();
+		for (int i = 0; i < kIterations; i++)
+			outputs = network.predict(inputs);
+		const bigtime_t time = (system_time() - start) / kIterations;
+
+		if (p == 0) {
+			reference = outputs;
+			referenceTime = time;
+			printf("\t%-8s %9.1f us\n", precisionNames[p], (double)time);
+			continue;
+		}
+
+		const Scalar scale = reference.cwiseAbs().maxCoeff();
+		const Scalar error = (outputs - reference).cwiseAbs().maxCoeff();
+		const bool wrong = !(error <= tolerances[p] * scale);
+		printf("\t%-8s %9.1f us  %5.2fx  max error %.2e of %.2e%s\n",
+			precisionNames[p], (double)time, (double)referenceTime / time,
+			(double)error, (double)scale, wrong ? "  WRONG" : "");
+		if (wrong)
+			sFailed = true;
+	}
+
+	network.set_parameters(parameters);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	const int failures = check_half_conversions();
+	printf("half conversions: %d failures\n", failures);
+	if (failures > 0)
+		sFailed = true;
+
+	Network dense;
+	dense.add_layer(new FullyConnected<ReLU>(256, 512));
+	dense.add_layer(new FullyConnected<ReLU>(512, 512));
+	dense.add_layer(new FullyConnected<Identity>(512, 10));
+	dense.set_output(new RegressionMSE());
+	dense.init(0, 0.05, 1);
+
+	Matrix denseInputs = Matrix::Random(256, 2000);
+	run_network("256-512-512-10", dense, denseInputs);
+
+	Network convolutional;
+	convolutional.add_layer(new Convolutional<ReLU>(28, 28, 1, 8, 5, 5));
+	convolutional.add_layer(new MaxPooling<ReLU>(24, 24, 8, 2, 2));
+	convolutional.add_layer(new Convolutional<ReLU>(12, 12, 8, 16, 3, 3));
+	convolutional.add_layer(new FullyConnected<Identity>(10 * 10 * 16, 10));
+	convolutional.set_output(new RegressionMSE());
+	convolutional.init(0, 0.1, 1);
+
+	Matrix images = (Matrix::Random(28 * 28, 200).array() + 1) / 2;
+	run_network("convolutional", convolutional, images);
+
+	return sFailed ? 1 : 0;
+}
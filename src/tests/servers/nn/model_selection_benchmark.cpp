@@ -0,0 +1,162 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Times the model order and inputs selections with one thread and all the
+// candidates fully trained, against several threads with successive halving,
+// and prints the candidate each of them selects. Exits with an error if an
+// inputs selection misses the only candidate with both relevant inputs, or if
+// successive halving selects an order more than ten times worse than the full
+// selection, since it trains fewer assays of each candidate.
+
+
+#include <OS.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include "model_selection/model_selection.h"
+#include "training_strategy/quasi_newton_method.h"
+
+
+using OpenNN::DataSet;
+using OpenNN::Matrix;
+using OpenNN::ModelSelection;
+using OpenNN::NeuralNetwork;
+using OpenNN::PerformanceFunctional;
+using OpenNN::QuasiNewtonMethod;
+using OpenNN::ThreadPool;
+using OpenNN::TrainingStrategy;
+using OpenNN::Vector;
+
+
+// The target only depends on the first two of the five inputs.
+static void
+fill_data(Matrix<double>& data)
+{
+	for (unsigned int i = 0; i < data.get_rows_number(); i++) {
+		for (unsigned int j = 0; j < 5; j++)
+			data[i][j] = sin(0.37 * i * (j + 1) + j);
+		data[i][5] = data[i][0] * data[i][1] + 0.5 * sin(3.0 * data[i][0]);
+	}
+}
+
+
+// Returns the index of the selected candidate, and its generalization
+// evaluation in minimum.
+static unsigned int
+run_selection(const char* name, ModelSelection& modelSelection,
+	bool inputsSelection, unsigned int threads, bool successiveHalving,
+	double& minimum)
+{
+	modelSelection.set_threads_number(threads);
+	modelSelection.set_successive_halving_flag(successiveHalving);
+
+	const bigtime_t start = system_time();
+	const ModelSelection::ModelSelectionResults results = inputsSelection
+		? modelSelection.perform_model_inputs_selection()
+		: modelSelection.perform_model_order_selection();
+	const bigtime_t time = system_time() - start;
+
+	unsigned int assays = 0;
+	unsigned int selected = 0;
+	minimum = HUGE_VAL;
+	for (unsigned int i = 0; i < results.assays_numbers.size(); i++) {
+		assays += results.assays_numbers[i];
+		for (unsigned int j = 0; j < results.assays_numbers[i]; j++) {
+			if (results.generalization_evaluation_data[i][j] < minimum) {
+				minimum = results.generalization_evaluation_data[i][j];
+				selected = i;
+			}
+		}
+	}
+
+	printf("%-6s %u threads  %-9s %3u assays %10.1f ms  candidate %u"
+		"  generalization evaluation %.4e\n", name, threads,
+		successiveHalving ? "halving" : "full", assays, time / 1000.0,
+		selected, minimum);
+
+	return selected;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	Matrix<double> data(400, 6);
+	fill_data(data);
+
+	DataSet dataSet(400, 5, 1);
+	dataSet.set_data(data);
+	dataSet.get_instances_information_pointer()->split_sequential_indices(0.6,
+		0.4, 0.0);
+
+	NeuralNetwork neuralNetwork(5, 4, 1);
+
+	PerformanceFunctional performanceFunctional(&neuralNetwork, &dataSet);
+
+	TrainingStrategy trainingStrategy(&performanceFunctional);
+	trainingStrategy.construct_main_training_algorithm(
+		TrainingStrategy::QUASI_NEWTON_METHOD);
+	QuasiNewtonMethod* quasiNewtonMethod = static_cast<QuasiNewtonMethod*>(
+		trainingStrategy.get_main_training_algorithm_pointer());
+	quasiNewtonMethod->set_maximum_epochs_number(100);
+	quasiNewtonMethod->set_display(false);
+
+	ModelSelection modelSelection(&trainingStrategy);
+	modelSelection.set_display(false);
+	modelSelection.set_parameters_assays_number(8);
+
+	Vector<unsigned int> hiddenPerceptronsNumbers(8);
+	for (unsigned int i = 0; i < hiddenPerceptronsNumbers.size(); i++)
+		hiddenPerceptronsNumbers[i] = 1 + 2 * i;
+	modelSelection.set_hidden_perceptrons_numbers(hiddenPerceptronsNumbers);
+
+	Vector< Vector<unsigned int> > inputsIndices(6);
+	for (unsigned int i = 0; i < inputsIndices.size(); i++)
+		inputsIndices[i].set(2);
+	inputsIndices[0][0] = 0; inputsIndices[0][1] = 1;
+	inputsIndices[1][0] = 0; inputsIndices[1][1] = 2;
+	inputsIndices[2][0] = 1; inputsIndices[2][1] = 3;
+	inputsIndices[3][0] = 2; inputsIndices[3][1] = 3;
+	inputsIndices[4][0] = 2; inputsIndices[4][1] = 4;
+	inputsIndices[5][0] = 3; inputsIndices[5][1] = 4;
+	modelSelection.set_inputs_indices(inputsIndices);
+
+	const unsigned int threads = ThreadPool::count_hardware_threads_number();
+
+	bool failed = false;
+	double fullMinimum;
+	double halvingMinimum;
+
+	run_selection("order", modelSelection, false, 1, false, fullMinimum);
+	run_selection("order", modelSelection, false, threads, false,
+		fullMinimum);
+	run_selection("order", modelSelection, false, threads, true,
+		halvingMinimum);
+	if (!(halvingMinimum <= 10 * fullMinimum)) {
+		printf("order selection with halving is too far from the full one\n");
+		failed = true;
+	}
+
+	neuralNetwork.set(5, 8, 1);
+
+	double minimum;
+	const unsigned int selected[3] = {
+		run_selection("inputs", modelSelection, true, 1, false, minimum),
+		run_selection("inputs", modelSelection, true, threads, false, minimum),
+		run_selection("inputs", modelSelection, true, threads, true, minimum)
+	};
+
+	// Only the first candidate has the two inputs the target depends on
+	for (int i = 0; i < 3; i++) {
+		if (selected[i] != 0) {
+			printf("inputs selection missed the first candidate\n");
+			failed = true;
+		}
+	}
+
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Saves and loads a neural network with a large multilayer perceptron through
+// a TinyXML document, as the NeuralNetwork class used to, and through the XML
+// stream classes with the parameters as text and in a binary data file. It
+// prints the time of each, and the largest difference between the parameters
+// loaded and the ones saved. The parameters written through TinyXML are
+// rounded to five decimals, while the stream classes keep them exactly; the
+// benchmark exits with an error if a difference is larger than that.
+
+
+#include <OS.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include "neural_network/neural_network.h"
+
+
+using OpenNN::NeuralNetwork;
+using OpenNN::Vector;
+
+
+static const char* kDocumentFilename = "/tmp/model_xml_benchmark_document.xml";
+static const char* kStreamFilename = "/tmp/model_xml_benchmark_stream.xml";
+static const char* kBinaryFilename = "/tmp/model_xml_benchmark_binary.xml";
+
+// Largest difference allowed for the parameters written by TinyXML.
+static const double kDocumentTolerance = 1e-5;
+
+static bool sFailed = false;
+
+
+static void
+save_document(const NeuralNetwork& neuralNetwork, const char* filename)
+{
+	TiXmlDocument document;
+	document.LinkEndChild(new TiXmlDeclaration("1.0", "", ""));
+	document.LinkEndChild(neuralNetwork.to_XML());
+	document.SaveFile(filename);
+}
+
+
+static void
+load_document(NeuralNetwork& neuralNetwork, const char* filename)
+{
+	TiXmlDocument document(filename);
+	document.LoadFile();
+	neuralNetwork.from_XML(document.FirstChildElement());
+}
+
+
+static void
+report(const char* name, bigtime_t saveTime, bigtime_t loadTime,
+	const Vector<double>& saved, const NeuralNetwork& loaded, double tolerance)
+{
+	const Vector<double> parameters = loaded.arrange_parameters();
+
+	double difference = parameters.size() == saved.size() ? 0.0 : HUGE_VAL;
+	for (unsigned int i = 0; i < parameters.size() && i < saved.size(); i++) {
+		if (fabs(parameters[i] - saved[i]) > difference)
+			difference = fabs(parameters[i] - saved[i]);
+	}
+
+	const bool wrong = !(difference <= tolerance);
+	printf("%-8s save %9.1f ms  load %9.1f ms  max difference %.3e%s\n", name,
+		saveTime / 1000.0, loadTime / 1000.0, difference,
+		wrong ? "  WRONG" : "");
+	if (wrong)
+		sFailed = true;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	Vector<unsigned int> architecture(4);
+	architecture[0] = 256;
+	architecture[1] = 1024;
+	architecture[2] = 1024;
+	architecture[3] = 16;
+
+	NeuralNetwork neuralNetwork(architecture);
+	neuralNetwork.initialize_parameters_normal();
+
+	const Vector<double> parameters = neuralNetwork.arrange_parameters();
+	printf("%u parameters\n", (unsigned)parameters.size());
+
+	{
+		NeuralNetwork loaded;
+
+		bigtime_t start = system_time();
+		save_document(neuralNetwork, kDocumentFilename);
+		const bigtime_t saveTime = system_time() - start;
+
+		start = system_time();
+		load_document(loaded, kDocumentFilename);
+		const bigtime_t loadTime = system_time() - start;
+
+		report("document", saveTime, loadTime, parameters, loaded,
+			kDocumentTolerance);
+	}
+
+	{
+		NeuralNetwork loaded;
+
+		bigtime_t start = system_time();
+		neuralNetwork.save(kStreamFilename);
+		const bigtime_t saveTime = system_time() - start;
+
+		start = system_time();
+		loaded.load(kStreamFilename);
+		const bigtime_t loadTime = system_time() - start;
+
+		report("stream", saveTime, loadTime, parameters, loaded, 0.0);
+	}
+
+	{
+		NeuralNetwork loaded;
+
+		bigtime_t start = system_time();
+		neuralNetwork.save(kBinaryFilename, true);
+		const bigtime_t saveTime = system_time() - start;
+
+		start = system_time();
+		loaded.load(kBinaryFilename);
+		const bigtime_t loadTime = system_time() - start;
+
+		report("binary", saveTime, loadTime, parameters, loaded, 0.0);
+	}
+
+	// Files saved by TinyXML are still loaded by the stream classes.
+	{
+		NeuralNetwork loaded;
+
+		const bigtime_t start = system_time();
+		loaded.load(kDocumentFilename);
+		const bigtime_t loadTime = system_time() - start;
+
+		report("mixed", 0, loadTime, parameters, loaded, kDocumentTolerance);
+	}
+
+	return sFailed ? 1 : 0;
+}
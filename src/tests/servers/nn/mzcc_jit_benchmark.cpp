@@ -0,0 +1,329 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Times small C programs compiled in memory by mzcc, with the linear scan
+// register allocator and with every value kept in the stack frame, and checks
+// their results against the same functions compiled natively. Also compares
+// the latency of the in-memory compilation with that of emitting assembly
+// text with the stack machine and the register allocating backends, that
+// malformed sources are rejected without ending the process, and that a
+// module doesn't see the declarations of the one compiled before. Exits with
+// an error if any of these checks fails.
+
+
+#include <OS.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ir.h"
+
+
+static const char* kSource =
+	"int fib(int n)\n"
+	"{\n"
+	"    if (n < 2)\n"
+	"        return n;\n"
+	"    return fib(n - 1) + fib(n - 2);\n"
+	"}\n"
+	"\n"
+	"int sieve(int n)\n"
+	"{\n"
+	"    char composite[65536];\n"
+	"    int count = 0;\n"
+	"    int i;\n"
+	"    int j;\n"
+	"    for (i = 0; i < n; i++)\n"
+	"        composite[i] = 0;\n"
+	"    for (i = 2; i < n; i++) {\n"
+	"        if (composite[i] == 0) {\n"
+	"            count++;\n"
+	"            for (j = i + i; j < n; j = j + i)\n"
+	"                composite[j] = 1;\n"
+	"        }\n"
+	"    }\n"
+	"    return count;\n"
+	"}\n"
+	"\n"
+	"int sort(int *a, int n)\n"
+	"{\n"
+	"    int i;\n"
+	"    int j;\n"
+	"    for (i = 1; i < n; i++) {\n"
+	"        int v = a[i];\n"
+	"        for (j = i; j > 0 && v < a[j - 1]; j--)\n"
+	"            a[j] = a[j - 1];\n"
+	"        a[j] = v;\n"
+	"    }\n"
+	"    int checksum = 0;\n"
+	"    for (i = 0; i < n; i++)\n"
+	"        checksum = checksum * 31 + a[i] * i;\n"
+	"    return checksum;\n"
+	"}\n"
+	"\n"
+	"int matmul(int *a, int *b, int *c, int n)\n"
+	"{\n"
+	"    int i;\n"
+	"    int j;\n"
+	"    int k;\n"
+	"    int checksum = 0;\n"
+	"    for (i = 0; i < n; i++) {\n"
+	"        for (j = 0; j < n; j++) {\n"
+	"            int s = 0;\n"
+	"            for (k = 0; k < n; k++)\n"
+	"                s = s + a[i * n + k] * b[k * n + j];\n"
+	"            c[i * n + j] = s;\n"
+	"            checksum = checksum * 7 + s;\n"
+	"        }\n"
+	"    }\n"
+	"    return checksum;\n"
+	"}\n";
+
+
+typedef int (*FibFunction)(int);
+typedef int (*SortFunction)(int*, int);
+typedef int (*MatmulFunction)(int*, int*, int*, int);
+
+
+// Native references of the functions of kSource, with the same overflows.
+
+static int
+native_fib(int n)
+{
+	if (n < 2)
+		return n;
+	return native_fib(n - 1) + native_fib(n - 2);
+}
+
+
+static int
+native_sieve(int n)
+{
+	static char composite[65536];
+	int count = 0;
+	memset(composite, 0, n);
+	for (int i = 2; i < n; i++) {
+		if (composite[i] == 0) {
+			count++;
+			for (int j = i + i; j < n; j += i)
+				composite[j] = 1;
+		}
+	}
+	return count;
+}
+
+
+static int
+native_sort(int* a, int n)
+{
+	for (int i = 1; i < n; i++) {
+		int v = a[i];
+		int j = i;
+		for (; j > 0 && v < a[j - 1]; j--)
+			a[j] = a[j - 1];
+		a[j] = v;
+	}
+	unsigned int checksum = 0;
+	for (int i = 0; i < n; i++)
+		checksum = checksum * 31 + (unsigned int)(a[i] * i);
+	return (int)checksum;
+}
+
+
+static int
+native_matmul(int* a, int* b, int* c, int n)
+{
+	unsigned int checksum = 0;
+	for (int i = 0; i < n; i++) {
+		for (int j = 0; j < n; j++) {
+			int s = 0;
+			for (int k = 0; k < n; k++)
+				s += a[i * n + k] * b[k * n + j];
+			c[i * n + j] = s;
+			checksum = checksum * 7 + (unsigned int)s;
+		}
+	}
+	return (int)checksum;
+}
+
+
+static void
+fill(int* values, int count, unsigned int seed)
+{
+	for (int i = 0; i < count; i++) {
+		seed = seed * 1103515245 + 12345;
+		values[i] = (int)((seed >> 16) & 1023) - 512;
+	}
+}
+
+
+struct Results {
+	int		fib;
+	int		sieve;
+	int		sort;
+	int		matmul;
+};
+
+
+static const int kFibArgument = 27;
+static const int kSieveSize = 65536;
+static const int kSortSize = 4000;
+static const int kMatrixSize = 96;
+
+static bool sFailed = false;
+
+
+static bigtime_t
+run(FibFunction fib, FibFunction sieve, SortFunction sort,
+	MatmulFunction matmul, Results& results)
+{
+	static int values[kSortSize];
+	static int a[kMatrixSize * kMatrixSize];
+	static int b[kMatrixSize * kMatrixSize];
+	static int c[kMatrixSize * kMatrixSize];
+	fill(values, kSortSize, 1);
+	fill(a, kMatrixSize * kMatrixSize, 2);
+	fill(b, kMatrixSize * kMatrixSize, 3);
+
+	const bigtime_t start = system_time();
+	results.fib = fib(kFibArgument);
+	results.sieve = sieve(kSieveSize);
+	results.sort = sort(values, kSortSize);
+	results.matmul = matmul(a, b, c, kMatrixSize);
+	return system_time() - start;
+}
+
+
+static void
+run_jit(const char* name, int flags, const Results& reference,
+	bigtime_t nativeTime)
+{
+	char* error = NULL;
+	MzccJitModule* module = mzcc_jit_compile(kSource, flags, &error);
+	if (module == NULL) {
+		printf("%-22s compilation failed: %s\n", name, error);
+		free(error);
+		sFailed = true;
+		return;
+	}
+
+	Results results;
+	const bigtime_t time = run(
+		(FibFunction)mzcc_jit_lookup(module, "fib"),
+		(FibFunction)mzcc_jit_lookup(module, "sieve"),
+		(SortFunction)mzcc_jit_lookup(module, "sort"),
+		(MatmulFunction)mzcc_jit_lookup(module, "matmul"), results);
+	const bool same = results.fib == reference.fib
+		&& results.sieve == reference.sieve && results.sort == reference.sort
+		&& results.matmul == reference.matmul;
+
+	printf("%-22s %8lld us  %5.2fx native  results %s\n", name,
+		(long long)time, (double)time / nativeTime, same ? "match" : "DIFFER");
+	if (!same)
+		sFailed = true;
+
+	mzcc_jit_free(module);
+}
+
+
+static void
+check_malformed(const char* source)
+{
+	char* error = NULL;
+	MzccJitModule* module = mzcc_jit_compile(source, MZCC_REGALLOC, &error);
+	if (module != NULL) {
+		printf("malformed source compiled: %s\n", source);
+		mzcc_jit_free(module);
+		sFailed = true;
+		return;
+	}
+
+	printf("%-22s rejected: %s\n", "malformed source",
+		error != NULL ? error : "(no message)");
+	free(error);
+}
+
+
+// Compiles two modules which declare the same global with different types,
+// and checks that the second one uses its own declaration.
+static void
+check_redeclared()
+{
+	char* error = NULL;
+	MzccJitModule* first = mzcc_jit_compile(
+		"int g; int seta() { g = 7; return g; }", MZCC_REGALLOC, &error);
+	MzccJitModule* second = first == NULL ? NULL : mzcc_jit_compile(
+		"long g; long setb() { g = 4294967296; return g; }", MZCC_REGALLOC,
+		&error);
+	if (second == NULL) {
+		printf("%-22s compilation failed: %s\n", "redeclared global",
+			error != NULL ? error : "(no message)");
+		free(error);
+		sFailed = true;
+	} else {
+		typedef long (*LongFunction)();
+		const long value = ((LongFunction)mzcc_jit_lookup(second, "setb"))();
+		printf("%-22s %ld\n", "redeclared global", value);
+		if (value != 4294967296L)
+			sFailed = true;
+	}
+
+	if (first != NULL)
+		mzcc_jit_free(first);
+	if (second != NULL)
+		mzcc_jit_free(second);
+}
+
+
+static void
+time_compilation(const char* name, int flags, bool jit, int repeats)
+{
+	const bigtime_t start = system_time();
+	for (int i = 0; i < repeats; i++) {
+		if (jit) {
+			mzcc_jit_free(mzcc_jit_compile(kSource, flags, NULL));
+			continue;
+		}
+		FILE* in = fmemopen((void*)kSource, strlen(kSource), "r");
+		FILE* out = fopen("/dev/null", "w");
+		mzcc_compile(in, out, flags);
+		fclose(out);
+		fclose(in);
+	}
+	const bigtime_t time = system_time() - start;
+
+	printf("%-22s %8.1f us per compilation\n", name, (double)time / repeats);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	Results reference;
+	const bigtime_t nativeTime = run(native_fib, native_sieve, native_sort,
+		native_matmul, reference);
+	printf("%-22s %8lld us\n", "native", (long long)nativeTime);
+
+	// The sources compiled after these must not see what they left behind.
+	check_malformed("int f( { return; }");
+	check_malformed("int f() { return \"unterminated; }");
+	check_malformed("int f(int a) { return a +; }");
+
+	check_redeclared();
+
+	run_jit("jit, registers", MZCC_REGALLOC, reference, nativeTime);
+	run_jit("jit, all spilled", MZCC_REGALLOC | MZCC_SPILL_ALL, reference,
+		nativeTime);
+
+	static const int kRepeats = 200;
+
+	time_compilation("text, stack machine", 0, false, kRepeats);
+	time_compilation("text, registers", MZCC_REGALLOC, false, kRepeats);
+	time_compilation("jit, registers", MZCC_REGALLOC, true, kRepeats);
+
+	return sFailed ? 1 : 0;
+}
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Compares the gradients of the final solutions error of an optimal control
+// problem, and of the outputs integrals of a neural network, computed exactly
+// and by numerical differentiation, together with the time they take. The
+// benchmark exits with an error if they differ by more than the error of the
+// numerical differentiation.
+
+
+#include <OS.h>
+
+#include <math.h>
+#include <stdio.h>
+
+#include "mathematical_model/ordinary_differential_equations.h"
+#include "neural_network/neural_network.h"
+#include "neural_network/scaling_layer.h"
+#include "neural_network/unscaling_layer.h"
+#include "performance_functional/final_solutions_error.h"
+#include "performance_functional/outputs_integrals.h"
+
+
+using OpenNN::FinalSolutionsError;
+using OpenNN::Matrix;
+using OpenNN::MultilayerPerceptron;
+using OpenNN::NeuralNetwork;
+using OpenNN::OrdinaryDifferentialEquations;
+using OpenNN::OutputsIntegrals;
+using OpenNN::PerformanceTerm;
+using OpenNN::Vector;
+
+
+// Largest difference allowed, relative to the largest gradient component.
+static const double kTolerance = 1e-5;
+
+static bool sFailed = false;
+
+
+// A body moved by the force given by the neural network, as a function of
+// time: the dependent variables are its position and its velocity.
+class DoubleIntegrator : public OrdinaryDifferentialEquations {
+public:
+	DoubleIntegrator()
+	{
+		set_dependent_variables_number(2);
+		set_initial_independent_variable(0.0);
+		set_final_independent_variable(1.0);
+		set_initial_dependent_variables(Vector<double>(2, 0.0));
+		set_solution_method(RungeKutta);
+		set_points_number(201);
+		set_display(false);
+	}
+
+	Vector<double> calculate_dependent_variables_dots(
+		const NeuralNetwork& neuralNetwork,
+		const Vector<double>& variables) const
+	{
+		const Vector<double> force
+			= neuralNetwork.calculate_outputs(Vector<double>(1, variables[0]));
+
+		Vector<double> dots(2);
+		dots[0] = variables[2];
+		dots[1] = force[0];
+		return dots;
+	}
+
+	Matrix<double> calculate_dependent_variables_dots_Jacobian(
+		const NeuralNetwork& neuralNetwork,
+		const Vector<double>& variables) const
+	{
+		// The force depends on time only.
+		Matrix<double> jacobian(2, 2, 0.0);
+		jacobian[0][1] = 1.0;
+		return jacobian;
+	}
+
+	Matrix<double> calculate_dependent_variables_dots_parameters_Jacobian(
+		const NeuralNetwork& neuralNetwork,
+		const Vector<double>& variables) const
+	{
+		const Matrix<double> forceJacobian
+			= neuralNetwork.calculate_parameters_Jacobian(
+				Vector<double>(1, variables[0]),
+				neuralNetwork.arrange_parameters());
+
+		const unsigned int parametersNumber
+			= forceJacobian.get_columns_number();
+
+		Matrix<double> jacobian(2, parametersNumber, 0.0);
+		for (unsigned int j = 0; j < parametersNumber; j++)
+			jacobian[1][j] = forceJacobian[0][j];
+
+		return jacobian;
+	}
+};
+
+
+static double
+max_difference(const Vector<double>& a, const Vector<double>& b)
+{
+	double difference = 0.0;
+	for (unsigned int i = 0; i < a.size(); i++)
+		difference = fmax(difference, fabs(a[i] - b[i]));
+
+	return difference;
+}
+
+
+static void
+compare_gradients(const char* name, const PerformanceTerm& term)
+{
+	static const int kIterations = 3;
+
+	Vector<double> exact;
+	bigtime_t start = system_time();
+	for (int i = 0; i < kIterations; i++)
+		exact = term.calculate_gradient();
+	const bigtime_t exactTime = (system_time() - start) / kIterations;
+
+	Vector<double> numerical;
+	start = system_time();
+	for (int i = 0; i < kIterations; i++)
+		numerical = term.PerformanceTerm::calculate_gradient();
+	const bigtime_t numericalTime = (system_time() - start) / kIterations;
+
+	const double difference = max_difference(exact, numerical);
+	const double scale = exact.calculate_absolute_value().calculate_maximum();
+	const bool wrong = !(difference <= kTolerance * scale);
+
+	printf("%s\t%u parameters\n", name, (unsigned)exact.size());
+	printf("\texact      %9.1f us\n", (double)exactTime);
+	printf("\tnumerical  %9.1f us  %6.1fx slower  max difference %.2e of %.2e%s\n",
+		(double)numericalTime, (double)numericalTime / exactTime, difference,
+		scale, wrong ? "  WRONG" : "");
+	if (wrong)
+		sFailed = true;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	// Optimal control: reach position 1 at rest after one second.
+
+	NeuralNetwork controller(1, 10, 1);
+	controller.initialize_parameters_normal(0.0, 0.5);
+
+	DoubleIntegrator model;
+
+	FinalSolutionsError finalSolutionsError(&controller, &model);
+	Vector<double> targets(2);
+	targets[0] = 1.0;
+	targets[1] = 0.0;
+	finalSolutionsError.set_target_final_solutions(targets);
+	finalSolutionsError.set_final_solutions_errors_weights(
+		Vector<double>(2, 1.0));
+
+	compare_gradients("final solutions error", finalSolutionsError);
+
+	// Integrals of the outputs of a scaled network over [0, 2].
+
+	NeuralNetwork network(1, 10, 2);
+	network.initialize_parameters_normal(0.0, 0.5);
+
+	network.construct_scaling_layer();
+	network.get_scaling_layer_pointer()->set_minimum(0, 0.0);
+	network.get_scaling_layer_pointer()->set_maximum(0, 2.0);
+	network.get_scaling_layer_pointer()->set_scaling_method(
+		OpenNN::ScalingLayer::MinimumMaximum);
+
+	network.construct_unscaling_layer();
+	network.get_unscaling_layer_pointer()->set_minimums(
+		Vector<double>(2, -3.0));
+	network.get_unscaling_layer_pointer()->set_maximums(
+		Vector<double>(2, 5.0));
+	network.get_unscaling_layer_pointer()->set_unscaling_method(
+		OpenNN::UnscalingLayer::MinimumMaximum);
+
+	OutputsIntegrals outputsIntegrals(&network);
+	Vector<double> weights(2);
+	weights[0] = 1.0;
+	weights[1] = -0.5;
+	outputsIntegrals.set_outputs_integrals_weights(weights);
+
+	compare_gradients("outputs integrals", outputsIntegrals);
+
+	return sFailed ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Compares the throughput of te_eval() called for each row with that of
+// te_eval_batch() over whole columns, and checks that both compute the same
+// values, for formulas mixing arithmetic operators and library functions.
+// The benchmark exits with an error if any value differs.
+
+
+#include <OS.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "tinyexpr.h"
+
+
+static const int kRows = 1000000;
+
+static bool sFailed = false;
+
+
+static void
+run_expression(const char* expression, const double* const* columns)
+{
+	static double x, y, z;
+	te_variable variables[] = {
+		{"x", &x, TE_VARIABLE, NULL},
+		{"y", &y, TE_VARIABLE, NULL},
+		{"z", &z, TE_VARIABLE, NULL}
+	};
+
+	int error;
+	te_expr* tree = te_compile(expression, variables, 3, &error);
+	if (tree == NULL) {
+		printf("%-34s parse error at %d\n", expression, error);
+		sFailed = true;
+		return;
+	}
+	te_program* program = te_compile_program(tree, variables, 3);
+
+	double* treeValues = new double[kRows];
+	double* batchValues = new double[kRows];
+
+	bigtime_t start = system_time();
+	for (int i = 0; i < kRows; i++) {
+		x = columns[0][i];
+		y = columns[1][i];
+		z = columns[2][i];
+		treeValues[i] = te_eval(tree);
+	}
+	const bigtime_t treeTime = system_time() - start;
+
+	start = system_time();
+	te_eval_batch(program, columns, kRows, batchValues);
+	const bigtime_t batchTime = system_time() - start;
+
+	int differences = 0;
+	for (int i = 0; i < kRows; i++) {
+		if (memcmp(&treeValues[i], &batchValues[i], sizeof(double)) != 0
+			&& !(isnan(treeValues[i]) && isnan(batchValues[i])))
+			differences++;
+	}
+
+	printf("%-34s tree %7lld us  batch %7lld us  %5.2fx  %d differences\n",
+		expression, (long long)treeTime, (long long)batchTime,
+		(double)treeTime / batchTime, differences);
+	if (differences > 0)
+		sFailed = true;
+
+	delete[] treeValues;
+	delete[] batchValues;
+	te_free_program(program);
+	te_free(tree);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	double* x = new double[kRows];
+	double* y = new double[kRows];
+	double* z = new double[kRows];
+	for (int i = 0; i < kRows; i++) {
+		x[i] = sin(0.001 * i) * 10.0;
+		y[i] = cos(0.0037 * i) * 3.0;
+		z[i] = 0.5 + (i % 1000) * 0.01;
+	}
+	const double* columns[] = {x, y, z};
+
+	run_expression("x + y * z", columns);
+	run_expression("(x - y) / (z + 1) - 2 * x", columns);
+	run_expression("sqrt(x^2 + y^2) + abs(z - x)", columns);
+	run_expression("x * (1 - x) * (x + y * z) - -y", columns);
+	run_expression("exp(-z) * sin(x) + y", columns);
+	run_expression("ln(z) * pow(z, 1.5) + atan2(x, y)", columns);
+
+	delete[] x;
+	delete[] y;
+	delete[] z;
+
+	return sFailed ? 1 : 0;
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Counts the memory allocations made by the evaluation and the gradient of
+// the squared error performance terms once their block workspaces have
+// grown, and checks that they do not depend on the number of instances.
+// Also checks the gradients against central differences of the evaluation,
+// and exits with an error if they disagree.
+
+
+#include <OS.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <new>
+
+#include "neural_network/neural_network.h"
+#include "performance_functional/mean_squared_error.h"
+#include "performance_functional/sum_squared_error.h"
+
+
+using OpenNN::DataSet;
+using OpenNN::Matrix;
+using OpenNN::MeanSquaredError;
+using OpenNN::NeuralNetwork;
+using OpenNN::PerformanceTerm;
+using OpenNN::SumSquaredError;
+using OpenNN::Vector;
+
+
+static std::atomic<long> sAllocationsCount(0);
+
+
+void*
+operator new(size_t size)
+{
+	sAllocationsCount++;
+
+	void* pointer = malloc(size > 0 ? size : 1);
+	if (pointer == NULL)
+		throw std::bad_alloc();
+
+	return pointer;
+}
+
+
+void
+operator delete(void* pointer) noexcept
+{
+	free(pointer);
+}
+
+
+void*
+operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+
+void
+operator delete[](void* pointer) noexcept
+{
+	free(pointer);
+}
+
+
+static void
+fill_data(Matrix<double>& data)
+{
+	for (unsigned int i = 0; i < data.get_rows_number(); i++) {
+		for (unsigned int j = 0; j < 3; j++)
+			data[i][j] = sin(0.37 * i + j);
+		data[i][3] = data[i][0] * data[i][1];
+		data[i][4] = cos(data[i][2]);
+	}
+}
+
+
+static void
+run_term(const char* name, PerformanceTerm& term, unsigned int instances,
+	unsigned int threads)
+{
+	static const int kWarmUpIterations = 20;
+	static const int kIterations = 50;
+
+	term.set_threads_number(threads);
+
+	for (int i = 0; i < kWarmUpIterations; i++) {
+		term.calculate_evaluation();
+		term.calculate_gradient();
+	}
+
+	long allocations = sAllocationsCount;
+	bigtime_t start = system_time();
+	for (int i = 0; i < kIterations; i++)
+		term.calculate_evaluation();
+	const bigtime_t evaluationTime = system_time() - start;
+	const long evaluationAllocations = sAllocationsCount - allocations;
+
+	allocations = sAllocationsCount;
+	start = system_time();
+	for (int i = 0; i < kIterations; i++)
+		term.calculate_gradient();
+	const bigtime_t gradientTime = system_time() - start;
+	const long gradientAllocations = sAllocationsCount - allocations;
+
+	printf("%-4s %6u instances  %u threads  evaluation %5.1f allocs %8.1f us"
+		"  gradient %5.1f allocs %8.1f us\n", name, instances, threads,
+		(double)evaluationAllocations / kIterations,
+		(double)evaluationTime / kIterations,
+		(double)gradientAllocations / kIterations,
+		(double)gradientTime / kIterations);
+}
+
+
+static bool
+check_gradient(const char* name, PerformanceTerm& term,
+	NeuralNetwork& neuralNetwork)
+{
+	static const double kStep = 1.0e-6;
+	static const double kTolerance = 1.0e-4;
+
+	const Vector<double> parameters = neuralNetwork.arrange_parameters();
+	const Vector<double> gradient = term.calculate_gradient();
+
+	// The errors are relative to the largest component, since the rounding
+	// errors of the differences grow with the evaluation.
+	double scale = 1.0;
+	for (unsigned int i = 0; i < gradient.size(); i++) {
+		if (fabs(gradient[i]) > scale)
+			scale = fabs(gradient[i]);
+	}
+
+	double maximumError = 0.0;
+	for (unsigned int i = 0; i < parameters.size(); i++) {
+		Vector<double> shifted = parameters;
+		shifted[i] = parameters[i] + kStep;
+		neuralNetwork.set_parameters(shifted);
+		const double forward = term.calculate_evaluation();
+		shifted[i] = parameters[i] - kStep;
+		neuralNetwork.set_parameters(shifted);
+		const double backward = term.calculate_evaluation();
+
+		const double difference = (forward - backward) / (2.0 * kStep);
+		const double error = fabs(gradient[i] - difference) / scale;
+		if (error > maximumError)
+			maximumError = error;
+	}
+	neuralNetwork.set_parameters(parameters);
+
+	const bool correct = maximumError < kTolerance;
+	printf("%-4s gradient relative error %.2e%s\n", name, maximumError,
+		correct ? "" : "  WRONG");
+	return correct;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	static const unsigned int kInstances[] = { 1000, 10000 };
+
+	Vector<unsigned int> architecture(4);
+	architecture[0] = 3;
+	architecture[1] = 10;
+	architecture[2] = 5;
+	architecture[3] = 2;
+
+	bool correct = true;
+
+	for (unsigned int i = 0; i < sizeof(kInstances) / sizeof(kInstances[0]);
+			i++) {
+		Matrix<double> data(kInstances[i], 5);
+		fill_data(data);
+
+		DataSet dataSet(kInstances[i], 3, 2);
+		dataSet.set_data(data);
+
+		NeuralNetwork neuralNetwork(architecture);
+		neuralNetwork.initialize_parameters_normal();
+
+		SumSquaredError sumSquaredError(&neuralNetwork, &dataSet);
+		MeanSquaredError meanSquaredError(&neuralNetwork, &dataSet);
+
+		for (unsigned int threads = 1; threads <= 4; threads *= 4) {
+			run_term("SSE", sumSquaredError, kInstances[i], threads);
+			run_term("MSE", meanSquaredError, kInstances[i], threads);
+		}
+
+		correct &= check_gradient("SSE", sumSquaredError, neuralNetwork);
+		correct &= check_gradient("MSE", meanSquaredError, neuralNetwork);
+	}
+
+	return correct ? 0 : 1;
+}
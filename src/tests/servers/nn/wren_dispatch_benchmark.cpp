@@ -0,0 +1,204 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Times method call heavy Wren scripts: polymorphic calls, recursion, object
+// allocation and field access. The VM caches the methods looked up by each
+// call site unless it is built with WREN_INLINE_CACHE set to 0, which gives
+// the timings to compare with. The benchmark exits with an error if a script
+// fails or prints something else than what it computes.
+
+
+#include <OS.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "wren.hpp"
+
+
+static const char* kMethodCall =
+	"class Toggle {\n"
+	"  construct new(startState) { _state = startState }\n"
+	"  value { _state }\n"
+	"  activate {\n"
+	"    _state = !_state\n"
+	"    return this\n"
+	"  }\n"
+	"}\n"
+	"class NthToggle is Toggle {\n"
+	"  construct new(startState, maxCounter) {\n"
+	"    super(startState)\n"
+	"    _countMax = maxCounter\n"
+	"    _count = 0\n"
+	"  }\n"
+	"  activate {\n"
+	"    _count = _count + 1\n"
+	"    if (_count >= _countMax) {\n"
+	"      super.activate\n"
+	"      _count = 0\n"
+	"    }\n"
+	"    return this\n"
+	"  }\n"
+	"}\n"
+	"var n = 200000\n"
+	"var val = true\n"
+	"var toggle = Toggle.new(val)\n"
+	"for (i in 0...n) {\n"
+	"  val = toggle.activate.value\n"
+	"  val = toggle.activate.value\n"
+	"  val = toggle.activate.value\n"
+	"  val = toggle.activate.value\n"
+	"  val = toggle.activate.value\n"
+	"}\n"
+	"System.print(toggle.value)\n"
+	"val = true\n"
+	"var ntoggle = NthToggle.new(val, 3)\n"
+	"for (i in 0...n) {\n"
+	"  val = ntoggle.activate.value\n"
+	"  val = ntoggle.activate.value\n"
+	"  val = ntoggle.activate.value\n"
+	"  val = ntoggle.activate.value\n"
+	"  val = ntoggle.activate.value\n"
+	"}\n"
+	"System.print(ntoggle.value)\n";
+
+static const char* kFib =
+	"class Fib {\n"
+	"  static get(n) {\n"
+	"    if (n < 2) return n\n"
+	"    return get(n - 1) + get(n - 2)\n"
+	"  }\n"
+	"}\n"
+	"System.print(Fib.get(27))\n";
+
+static const char* kBinaryTrees =
+	"class Tree {\n"
+	"  construct new(item, depth) {\n"
+	"    _item = item\n"
+	"    if (depth > 0) {\n"
+	"      var item2 = item + item\n"
+	"      depth = depth - 1\n"
+	"      _left = Tree.new(item2 - 1, depth)\n"
+	"      _right = Tree.new(item2, depth)\n"
+	"    }\n"
+	"  }\n"
+	"  check {\n"
+	"    if (_left == null) return _item\n"
+	"    return _item + _left.check - _right.check\n"
+	"  }\n"
+	"}\n"
+	"var maxDepth = 12\n"
+	"var total = 0\n"
+	"var depth = 4\n"
+	"while (depth <= maxDepth) {\n"
+	"  var iterations = 1 << (maxDepth - depth + 4)\n"
+	"  var check = 0\n"
+	"  for (i in 1..iterations) {\n"
+	"    check = check + Tree.new(i, depth).check + Tree.new(-i, depth).check\n"
+	"  }\n"
+	"  total = total + check\n"
+	"  depth = depth + 2\n"
+	"}\n"
+	"System.print(total)\n";
+
+static const char* kFieldAccess =
+	"class Point {\n"
+	"  construct new(x, y) {\n"
+	"    _x = x\n"
+	"    _y = y\n"
+	"  }\n"
+	"  x { _x }\n"
+	"  y { _y }\n"
+	"  x=(value) { _x = value }\n"
+	"  y=(value) { _y = value }\n"
+	"  translate(dx, dy) {\n"
+	"    _x = _x + dx\n"
+	"    _y = _y + dy\n"
+	"  }\n"
+	"}\n"
+	"class Point3 is Point {\n"
+	"  construct new(x, y, z) {\n"
+	"    super(x, y)\n"
+	"    _z = z\n"
+	"  }\n"
+	"  z { _z }\n"
+	"}\n"
+	"var points = [Point.new(1, 2), Point3.new(3, 4, 5)]\n"
+	"var sum = 0\n"
+	"for (i in 0...500000) {\n"
+	"  var p = points[i & 1]\n"
+	"  p.translate(1, -1)\n"
+	"  p.x = p.x - 1\n"
+	"  sum = sum + p.x + p.y\n"
+	"}\n"
+	"System.print(sum)\n";
+
+
+static char sOutput[256];
+static bool sFailed = false;
+
+
+static void
+write_output(WrenVM* vm, const char* text)
+{
+	if (strcmp(text, "\n") == 0)
+		return;
+	strncat(sOutput, text, sizeof(sOutput) - strlen(sOutput) - 2);
+	strcat(sOutput, " ");
+}
+
+
+static void
+report_error(WrenVM* vm, WrenErrorType type, const char* module, int line,
+	const char* message)
+{
+	fprintf(stderr, "%s:%d: %s\n", module != NULL ? module : "?", line,
+		message);
+}
+
+
+static void
+run_script(const char* name, const char* source, const char* expected)
+{
+	WrenConfiguration config;
+	wrenInitConfiguration(&config);
+	config.writeFn = write_output;
+	config.errorFn = report_error;
+
+	WrenVM* vm = wrenNewVM(&config);
+	sOutput[0] = '\0';
+
+	const bigtime_t start = system_time();
+	const WrenInterpretResult result = wrenInterpret(vm, "main", source);
+	const bigtime_t time = system_time() - start;
+
+	// Each printed value is followed by a space.
+	const size_t length = strlen(sOutput);
+	if (length > 0)
+		sOutput[length - 1] = '\0';
+
+	const bool wrong = result != WREN_RESULT_SUCCESS
+		|| strcmp(sOutput, expected) != 0;
+	printf("%-14s %8lld us  %s%s%s\n", name, (long long)time,
+		result == WREN_RESULT_SUCCESS ? "" : "failed: ", sOutput,
+		wrong ? "  WRONG" : "");
+	if (wrong)
+		sFailed = true;
+
+	wrenFreeVM(vm);
+}
+
+
+int
+main(int argc, char** argv)
+{
+	run_script("method_call", kMethodCall, "true false");
+	run_script("fib", kFib, "196418");
+	run_script("binary_trees", kBinaryTrees, "-10912");
+	run_script("field_access", kFieldAccess, "-62497750000");
+
+	return sFailed ? 1 : 0;
+}
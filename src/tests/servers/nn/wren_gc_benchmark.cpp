@@ -0,0 +1,180 @@
+/*
+ * Copyright 2026, Haiku, Inc. All rights reserved.
+ * Distributed under the terms of the MIT License.
+ */
+
+
+// Runs allocation heavy Wren scripts which keep a large heap alive, and
+// reports the pauses of the garbage collector: how many minor collections and
+// collections of the whole heap it did, and the longest and total pause. The
+// scripts are run with the default nursery and slice sizes, with slices so
+// large that every collection of the whole heap is marked and swept in one
+// pause each, and with a nursery so large that the heap is barely collected
+// at all. Exits with an error if a script fails or prints a wrong result.
+
+
+#include <OS.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include "wren.hpp"
+
+
+static const char* kBinaryTrees =
+	"class Tree {\n"
+	"  construct new(item, depth) {\n"
+	"    _item = item\n"
+	"    if (depth > 0) {\n"
+	"      var item2 = item + item\n"
+	"      depth = depth - 1\n"
+	"      _left = Tree.new(item2 - 1, depth)\n"
+	"      _right = Tree.new(item2, depth)\n"
+	"    }\n"
+	"  }\n"
+	"  check {\n"
+	"    if (_left == null) return _item\n"
+	"    return _item + _left.check - _right.check\n"
+	"  }\n"
+	"}\n"
+	"var longLived = Tree.new(0, 16)\n"
+	"var total = 0\n"
+	"var depth = 4\n"
+	"while (depth <= 14) {\n"
+	"  var iterations = 1 << (14 - depth + 4)\n"
+	"  for (i in 1..iterations) {\n"
+	"    total = total + Tree.new(i, depth).check + Tree.new(-i, depth).check\n"
+	"  }\n"
+	"  depth = depth + 2\n"
+	"}\n"
+	"System.print(total + longLived.check)\n";
+
+static const char* kCache =
+	"var cache = {}\n"
+	"var order = []\n"
+	"var hits = 0\n"
+	"for (i in 0...400000) {\n"
+	"  var key = \"k%(i * 7919 % 30000)\"\n"
+	"  var entry = cache[key]\n"
+	"  if (entry == null) {\n"
+	"    cache[key] = [i, key + \"!\", [i, i + 1]]\n"
+	"    order.add(key)\n"
+	"    if (order.count > 20000) cache.remove(order.removeAt(0))\n"
+	"  } else {\n"
+	"    hits = hits + 1\n"
+	"    entry[2] = [i]\n"
+	"  }\n"
+	"}\n"
+	"System.print(hits + cache.count)\n";
+
+
+// Fills the old generation with enough garbage to start collecting the whole
+// heap, then only allocates ranges, which nothing references by the time the
+// next one is allocated. The minor collections which start the sweeps of the
+// old generation have no survivors then.
+static const char* kGarbage =
+	"var kept = []\n"
+	"for (i in 0...200000) kept.add([i])\n"
+	"kept = kept[0...50000]\n"
+	"var total = 0\n"
+	"for (i in 0...3000000) total = total + (i..i + 1).to\n"
+	"System.print(total + kept.count)\n";
+
+
+static char sOutput[256];
+static int sLongPauses;
+
+
+static void
+write_output(WrenVM* vm, const char* text)
+{
+	if (strcmp(text, "\n") == 0)
+		return;
+	strncat(sOutput, text, sizeof(sOutput) - strlen(sOutput) - 2);
+	strcat(sOutput, " ");
+}
+
+
+static void
+report_error(WrenVM* vm, WrenErrorType type, const char* module, int line,
+	const char* message)
+{
+	fprintf(stderr, "%s:%d: %s\n", module != NULL ? module : "?", line,
+		message);
+}
+
+
+static void
+count_pause(WrenVM* vm, const WrenGCStats* stats)
+{
+	if (stats->pauseTime > 0.001)
+		sLongPauses++;
+}
+
+
+static bool
+run_script(const char* name, const char* source, const char* expected,
+	size_t nurserySize, int sliceSizePercent)
+{
+	WrenConfiguration config;
+	wrenInitConfiguration(&config);
+	config.writeFn = write_output;
+	config.errorFn = report_error;
+	config.gcFn = count_pause;
+	if (nurserySize != 0)
+		config.nurserySize = nurserySize;
+	if (sliceSizePercent != 0)
+		config.sliceSizePercent = sliceSizePercent;
+
+	WrenVM* vm = wrenNewVM(&config);
+	sOutput[0] = '\0';
+	sLongPauses = 0;
+
+	const bigtime_t start = system_time();
+	const WrenInterpretResult result = wrenInterpret(vm, "main", source);
+	const bigtime_t time = system_time() - start;
+
+	WrenGCStats stats;
+	wrenGetGCStats(vm, &stats);
+
+	// Each printed line ends with a space.
+	const size_t length = strlen(sOutput);
+	if (length > 0)
+		sOutput[length - 1] = '\0';
+	const bool correct = result == WREN_RESULT_SUCCESS
+		&& strcmp(sOutput, expected) == 0;
+
+	printf("%-28s %8lld us  %6d minor  %3d major  max %7.3f ms  "
+		"total %8.3f ms  %4d over 1 ms  %s%s\n", name, (long long)time,
+		stats.numMinorCollections, stats.numMajorCollections,
+		stats.maxPauseTime * 1000, stats.totalPauseTime * 1000, sLongPauses,
+		correct ? "" : "wrong result: ", sOutput);
+
+	wrenFreeVM(vm);
+	return correct;
+}
+
+
+int
+main(int argc, char** argv)
+{
+	static const size_t kLargeNursery = 64 * 1024 * 1024;
+	static const int kWholeSlices = 1000000;
+
+	bool correct = true;
+	correct &= run_script("binary_trees", kBinaryTrees, "-43681", 0, 0);
+	correct &= run_script("binary_trees, whole pauses", kBinaryTrees,
+		"-43681", 0, kWholeSlices);
+	correct &= run_script("binary_trees, large nursery", kBinaryTrees,
+		"-43681", kLargeNursery, 0);
+	correct &= run_script("cache", kCache, "20000", 0, 0);
+	correct &= run_script("cache, whole pauses", kCache, "20000", 0,
+		kWholeSlices);
+	correct &= run_script("cache, large nursery", kCache, "20000",
+		kLargeNursery, 0);
+	correct &= run_script("garbage", kGarbage, "4500001550000", 0, 0);
+	correct &= run_script("garbage, small nursery", kGarbage, "4500001550000",
+		4096, 0);
+
+	return correct ? 0 : 1;
+}